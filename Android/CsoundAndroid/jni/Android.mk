@@ -73,10 +73,13 @@ $(CSOUND_SRC_ROOT)/OOps/midiinterop.c \
 $(CSOUND_SRC_ROOT)/OOps/midiops.c \
 $(CSOUND_SRC_ROOT)/OOps/midiout.c \
 $(CSOUND_SRC_ROOT)/OOps/mxfft.c \
+$(CSOUND_SRC_ROOT)/OOps/mrfft.c \
 $(CSOUND_SRC_ROOT)/OOps/oscils.c \
+$(CSOUND_SRC_ROOT)/OOps/oscbank.c \
 $(CSOUND_SRC_ROOT)/OOps/pstream.c \
 $(CSOUND_SRC_ROOT)/OOps/pvfileio.c \
 $(CSOUND_SRC_ROOT)/OOps/pvsanal.c \
+$(CSOUND_SRC_ROOT)/OOps/sdft.c \
 $(CSOUND_SRC_ROOT)/OOps/random.c \
 $(CSOUND_SRC_ROOT)/OOps/remote.c \
 $(CSOUND_SRC_ROOT)/OOps/schedule.c \
@@ -110,7 +113,9 @@ $(CSOUND_SRC_ROOT)/Opcodes/minmax.c  \
 $(CSOUND_SRC_ROOT)/Opcodes/pan2.c  \
 $(CSOUND_SRC_ROOT)/Opcodes/phisem.c \
 $(CSOUND_SRC_ROOT)/Opcodes/arrays.c \
+$(CSOUND_SRC_ROOT)/Opcodes/arrayvec.c \
 $(CSOUND_SRC_ROOT)/Opcodes/hrtfopcodes.c  \
+$(CSOUND_SRC_ROOT)/Opcodes/hrtfdb.c  \
 $(CSOUND_SRC_ROOT)/Opcodes/vbap.c  \
 $(CSOUND_SRC_ROOT)/Opcodes/vbap1.c  \
 $(CSOUND_SRC_ROOT)/Opcodes/vbap_n.c  \
@@ -163,6 +168,7 @@ $(CSOUND_SRC_ROOT)/Top/threads.c \
 $(CSOUND_SRC_ROOT)/Top/utility.c \
 $(CSOUND_SRC_ROOT)/Top/server.c \
 $(CSOUND_SRC_ROOT)/Top/threadsafe.c \
+$(CSOUND_SRC_ROOT)/Top/profile.c \
 $(CSOUND_SRC_ROOT)/Opcodes/ambicode.c       \
 $(CSOUND_SRC_ROOT)/Opcodes/afilters.c       \
 $(CSOUND_SRC_ROOT)/Opcodes/bbcut.c          \
@@ -76,75 +76,92 @@
 #define INIT_SIZE (100)
 //static int task_max_size;
 
+/* DAGs with no more tasks than this are run on the main thread alone */
+#define INLINE_TASKS (2)
+
+void dag_reinit(CSOUND *csound);
+
 static void dag_print_state(CSOUND *csound)
 {
-    int i;
-    watchList *w;
-    printf("*** %d tasks\n", csound->dag_num_active);
-    for (i=0; i<csound->dag_num_active; i++) {
+    int i, e;
+    printf("*** %d tasks in %d slots\n",
+           csound->dag_num_active, csound->dag_num_slots);
+    for (i=0; i<csound->dag_num_slots; i++) {
+      if (csound->dag_nodes[i].seen < 0) continue;   /* free slot */
       printf("%d(%d): ", i, csound->dag_task_map[i]->insno);
       switch (csound->dag_task_status[i].s) {
       case DONE:
-        printf("status=DONE (watchList ");
-        w = csound->dag_task_watch[i];
-        while (w) { printf("%d ", w->id); w=w->next; }
-        printf(")\n");
+        printf("status=DONE");
         break;
       case INPROGRESS:
-        printf("status=INPROGRESS (watchList ");
-        w = csound->dag_task_watch[i];
-        while (w) { printf("%d ", w->id); w=w->next; }
-        printf(")\n");
+        printf("status=INPROGRESS");
         break;
       case AVAILABLE:
-        printf("status=AVAILABLE (watchList ");
-        w = csound->dag_task_watch[i];
-        while (w) { printf("%d ", w->id); w=w->next; }
-        printf(")\n");
+        printf("status=AVAILABLE");
         break;
       case WAITING:
-        {
-          char *tt = csound->dag_task_dep[i];
-          int j;
-          printf("status=WAITING for tasks [");
-          for (j=0; j<i; j++) if (tt[j]) printf("%d ", j);
-          printf("]\n");
-        }
+        printf("status=WAITING (%d of %d) for tasks [",
+               csound->dag_task_status[i].pending,
+               csound->dag_task_status[i].deps);
+        for (e = csound->dag_nodes[i].first_in; e >= 0;
+             e = csound->dag_edges[e].next_in)
+          printf("%d ", csound->dag_edges[e].from);
+        printf("]");
         break;
       default:
-        printf("status=???\n"); break;
+        printf("status=???"); break;
       }
+      printf(" (notifies ");
+      for (e = csound->dag_nodes[i].first_out; e >= 0;
+           e = csound->dag_edges[e].next_out)
+        printf("%d ", csound->dag_edges[e].to);
+      printf(")\n");
+    }
+}
+
+/* One deque per performance thread, each able to hold every task */
+static void create_deques(CSOUND *csound)
+{
+    int i, max = csound->dag_task_max_size;
+    int n = csound->oparms->numThreads > 1 ? csound->oparms->numThreads : 1;
+    if (csound->dag_deques == NULL) {
+      csound->dag_deques =
+        (taskDeque *)csound->Calloc(csound, sizeof(taskDeque)*n);
+      csound->dag_num_deques = n;
+      for (i=0; i<n; i++)
+        csound->dag_deques[i].tasks =
+          (taskID *)csound->Calloc(csound, sizeof(taskID)*max);
+    }
+    else {
+      for (i=0; i<csound->dag_num_deques; i++)
+        csound->dag_deques[i].tasks =
+          (taskID *)csound->ReAlloc(csound, csound->dag_deques[i].tasks,
+                                    sizeof(taskID)*max);
     }
 }
 
-/* For now allocate a fixed maximum number of tasks; FIXME */
 static void create_dag(CSOUND *csound)
 {
-    /* Allocate the main task status and watchlists */
+    /* Allocate the main task status and edge lists */
     int max = csound->dag_task_max_size;
     csound->dag_task_status = csound->Calloc(csound, sizeof(stateWithPadding)*max);
-    csound->dag_task_watch  = csound->Calloc(csound, sizeof(watchList*)*max);
     csound->dag_task_map    = csound->Calloc(csound, sizeof(INSDS*)*max);
-    csound->dag_task_dep    = (char **)csound->Calloc(csound, sizeof(char*)*max);
-    csound->dag_wlmm = (watchList *)csound->Calloc(csound, sizeof(watchList)*max);
+    csound->dag_nodes = (dagNode *)csound->Calloc(csound, sizeof(dagNode)*max);
+    create_deques(csound);
 }
 
 static void recreate_dag(CSOUND *csound)
 {
-    /* Allocate the main task status and watchlists */
+    /* Allocate the main task status and edge lists */
     int max = csound->dag_task_max_size;
     csound->dag_task_status =
       csound->ReAlloc(csound, (stateWithPadding *)csound->dag_task_status,
                sizeof(stateWithPadding)*max);
-    csound->dag_task_watch  =
-      csound->ReAlloc(csound, (struct watchList *)csound->dag_task_watch,
-               sizeof(watchList*)*max);
     csound->dag_task_map    =
       csound->ReAlloc(csound, (INSDS *)csound->dag_task_map, sizeof(INSDS*)*max);
-    csound->dag_task_dep    =
-      (char **)csound->ReAlloc(csound, csound->dag_task_dep, sizeof(char*)*max);
-    csound->dag_wlmm        =
-      (watchList *)csound->ReAlloc(csound, csound->dag_wlmm, sizeof(watchList)*max);
+    csound->dag_nodes =
+      (dagNode *)csound->ReAlloc(csound, csound->dag_nodes, sizeof(dagNode)*max);
+    create_deques(csound);
 }
 
 static INSTR_SEMANTICS *dag_get_info(CSOUND* csound, int insno)
@@ -183,321 +200,416 @@ static int dag_intersect(CSOUND *csound, struct set_t *current,
     return res;
 }
 
-void dag_build(CSOUND *csound, INSDS *chain)
+/* Do instances of two instruments have to run in chain order?  The
+   answer only depends on the instrument numbers, so it is worked out
+   once from the semantic sets and cached until the orchestra changes.
+   Rows are allocated only for instruments that are actually played. */
+static int dag_conflicts(CSOUND *csound, int current, int later)
 {
-    INSDS *save = chain;
-    INSDS **task_map;
-    int i;
+    char *row;
+    int cnt = 0, ans;
+    INSTR_SEMANTICS *current_instr, *later_instr;
+
+    if (current >= csound->dag_conflict_size ||
+        later >= csound->dag_conflict_size) {
+      int i, size = csound->engineState.maxinsno + 1;
+      if (current >= size) size = current + 1;
+      if (later >= size) size = later + 1;
+      for (i=0; i<csound->dag_conflict_size; i++)
+        if (csound->dag_conflict[i]) {
+          csound->Free(csound, csound->dag_conflict[i]);
+        }
+      csound->dag_conflict =
+        (char **)csound->ReAlloc(csound, csound->dag_conflict,
+                                 sizeof(char *)*size);
+      memset(csound->dag_conflict, '\0', sizeof(char *)*size);
+      csound->dag_conflict_size = size;
+    }
+    row = csound->dag_conflict[current];
+    if (row == NULL)
+      row = csound->dag_conflict[current] =
+        (char *)csound->Calloc(csound, csound->dag_conflict_size);
+    if (row[later]) return row[later] - 1;   /* 0 unknown, 1 no, 2 yes */
+
+    current_instr = dag_get_info(csound, current);
+    later_instr = dag_get_info(csound, later);
+    //csp_set_print(csound, current_instr->read);
+    //csp_set_print(csound, current_instr->write);
+    //csp_set_print(csound, later_instr->read_write);
+    ans = (dag_intersect(csound, current_instr->write,
+                         later_instr->read, cnt++)       ||
+           dag_intersect(csound, current_instr->read_write,
+                         later_instr->read, cnt++)       ||
+           dag_intersect(csound, current_instr->read,
+                         later_instr->write, cnt++)      ||
+           dag_intersect(csound, current_instr->write,
+                         later_instr->write, cnt++)      ||
+           dag_intersect(csound, current_instr->read_write,
+                         later_instr->write, cnt++)      ||
+           dag_intersect(csound, current_instr->read,
+                         later_instr->read_write, cnt++) ||
+           dag_intersect(csound, current_instr->write,
+                         later_instr->read_write, cnt++));
+    row[later] = ans ? 2 : 1;
+    /* the relation is symmetric */
+    if (csound->dag_conflict[later]) csound->dag_conflict[later][current] = row[later];
+    return ans;
+}
 
-    //printf("DAG BUILD***************************************\n");
-    csound->dag_num_active = 0;
-    while (chain != NULL) {
-      csound->dag_num_active++;
-      chain = chain->nxtact;
+static int dag_edge_alloc(CSOUND *csound)
+{
+    int e = csound->dag_edges_free;
+    if (e < 0) {
+      int i, old = csound->dag_edges_size;
+      csound->dag_edges_size = old ? 2*old : 4*INIT_SIZE;
+      csound->dag_edges =
+        (dagEdge *)csound->ReAlloc(csound, csound->dag_edges,
+                                   sizeof(dagEdge)*csound->dag_edges_size);
+      for (i=old; i<csound->dag_edges_size; i++)
+        csound->dag_edges[i].next_out = i+1;
+      csound->dag_edges[csound->dag_edges_size-1].next_out = -1;
+      e = old;
     }
-    if (csound->dag_num_active>csound->dag_task_max_size) {
-      //printf("**************need to extend task vector\n");
-      csound->dag_task_max_size = csound->dag_num_active+INIT_SIZE;
-      recreate_dag(csound);
+    csound->dag_edges_free = csound->dag_edges[e].next_out;
+    return e;
+}
+
+/* Task 'to' may only start once task 'from' is done */
+static void dag_add_edge(CSOUND *csound, taskID from, taskID to)
+{
+    int e = dag_edge_alloc(csound);
+    dagEdge *edges = csound->dag_edges;
+    dagNode *nodes = csound->dag_nodes;
+    edges[e].from = from;
+    edges[e].to = to;
+    edges[e].prev_out = -1;
+    edges[e].next_out = nodes[from].first_out;
+    if (nodes[from].first_out >= 0) edges[nodes[from].first_out].prev_out = e;
+    nodes[from].first_out = e;
+    edges[e].prev_in = -1;
+    edges[e].next_in = nodes[to].first_in;
+    if (nodes[to].first_in >= 0) edges[nodes[to].first_in].prev_in = e;
+    nodes[to].first_in = e;
+    csound->dag_task_status[to].deps++;
+}
+
+static void dag_unlink_edge(CSOUND *csound, int e)
+{
+    dagEdge *edges = csound->dag_edges;
+    dagNode *nodes = csound->dag_nodes;
+    dagEdge *p = &edges[e];
+    if (p->prev_out >= 0) edges[p->prev_out].next_out = p->next_out;
+    else nodes[p->from].first_out = p->next_out;
+    if (p->next_out >= 0) edges[p->next_out].prev_out = p->prev_out;
+    if (p->prev_in >= 0) edges[p->prev_in].next_in = p->next_in;
+    else nodes[p->to].first_in = p->next_in;
+    if (p->next_in >= 0) edges[p->next_in].prev_in = p->prev_in;
+    csound->dag_task_status[p->to].deps--;
+    p->next_out = csound->dag_edges_free;
+    csound->dag_edges_free = e;
+}
+
+static taskID dag_add_task(CSOUND *csound, INSDS *ip)
+{
+    taskID t = csound->dag_slots_free;
+    if (t >= 0)
+      csound->dag_slots_free = csound->dag_nodes[t].first_out;
+    else {
+      if (csound->dag_num_slots >= csound->dag_task_max_size) {
+        //printf("**************need to extend task vector\n");
+        csound->dag_task_max_size = csound->dag_num_slots + INIT_SIZE;
+        recreate_dag(csound);
+      }
+      t = csound->dag_num_slots++;
     }
+    csound->dag_nodes[t].first_out = -1;
+    csound->dag_nodes[t].first_in = -1;
+    csound->dag_nodes[t].seen = csound->dag_update_count;
+    csound->dag_task_status[t].deps = 0;
+    csound->dag_task_map[t] = ip;
+    INSDS_PRIV_OF(ip)->dag_task = t;
+    csound->dag_num_active++;
+    return t;
+}
+
+static void dag_remove_task(CSOUND *csound, taskID t)
+{
+    dagNode *node = &csound->dag_nodes[t];
+    while (node->first_out >= 0) dag_unlink_edge(csound, node->first_out);
+    while (node->first_in >= 0) dag_unlink_edge(csound, node->first_in);
+    node->seen = -1;
+    node->first_out = csound->dag_slots_free;   /* free list link */
+    csound->dag_slots_free = t;
+    csound->dag_task_map[t] = NULL;
+    csound->dag_num_active--;
+}
+
+/* Forget every task, e.g. when the instruments have been recompiled */
+static void dag_clear(CSOUND *csound)
+{
+    int i;
+    for (i=0; i<csound->dag_conflict_size; i++)
+      if (csound->dag_conflict[i]) {
+        csound->Free(csound, csound->dag_conflict[i]);
+        csound->dag_conflict[i] = NULL;
+      }
+    csound->dag_num_active = 0;
+    csound->dag_num_slots = 0;
+    csound->dag_slots_free = -1;
+    if (csound->dag_edges_size > 0) {
+      for (i=0; i<csound->dag_edges_size; i++)
+        csound->dag_edges[i].next_out = i+1;
+      csound->dag_edges[csound->dag_edges_size-1].next_out = -1;
+      csound->dag_edges_free = 0;
+    }
+}
+
+/* Bring the DAG in line with the active chain.  Instances keep their
+   task slot and edges while they stay active; those that left the
+   chain are removed and new ones are linked to the instances of the
+   instruments they conflict with, so a note costs O(deps) rather than
+   a comparison with every other active instance.  Edges always point
+   down the chain, which is therefore a topological order. */
+void dag_update(CSOUND *csound, INSDS *chain)
+{
+    INSDS *ip, *run;
+    int i, stamp, added = 0, removed = 0;
+    int *width;
+
     if (csound->dag_task_status == NULL)
       create_dag(csound); /* Should move elsewhere */
-    else {
-      memset((void*)csound->dag_task_watch, '\0',
-             sizeof(watchList*)*csound->dag_task_max_size);
-      for (i=0; i<csound->dag_task_max_size; i++) {
-        if (csound->dag_task_dep[i]) {
-          csound->dag_task_dep[i]= NULL;
-        }
-        csound->dag_wlmm[i].id = INVALID;
-      }
+    /* merge_state() may set the flag from another thread at any time;
+       clear it first so that a later compilation is not lost */
+    if (ATOMIC_GET(csound->dag_orc_changed)) {
+      ATOMIC_SET(csound->dag_orc_changed, 0);
+      dag_clear(csound);
     }
-    task_map = csound->dag_task_map;
-    for (i=0; i<csound->dag_num_active; i++) {
-      csound->dag_task_status[i].s = AVAILABLE;
-      csound->dag_wlmm[i].id=i;
+    stamp = ++csound->dag_update_count;
+
+    /* mark the instances still active; the others have left the chain */
+    for (ip = chain; ip != NULL; ip = ip->nxtact) {
+      taskID t = INSDS_PRIV_OF(ip)->dag_task;
+      if (t >= 0 && t < csound->dag_num_slots &&
+          csound->dag_task_map[t] == ip && csound->dag_nodes[t].seen >= 0)
+        csound->dag_nodes[t].seen = stamp;
+      else INSDS_PRIV_OF(ip)->dag_task = -1;
     }
-    csound->dag_changed = 0;
-    if (UNLIKELY(csound->oparms->odebug))
-      printf("dag_num_active = %d\n", csound->dag_num_active);
-    i = 0; chain = save;
-    while (chain != NULL) {     /* for each instance check against later */
-      int j = i+1;              /* count of instance */
-      if (UNLIKELY(csound->oparms->odebug))
-        printf("\nWho depends on %d (instr %d)?\n", i, chain->insno);
-      INSDS *next = chain->nxtact;
-      INSTR_SEMANTICS *current_instr = dag_get_info(csound, chain->insno);
-      //csp_set_print(csound, current_instr->read);
-      //csp_set_print(csound, current_instr->write);
-      while (next) {
-        INSTR_SEMANTICS *later_instr = dag_get_info(csound, next->insno);
-        int cnt = 0;
-        if (UNLIKELY(csound->oparms->odebug)) printf("%d ", j);
-        //csp_set_print(csound, later_instr->read);
-        //csp_set_print(csound, later_instr->write);
-        //csp_set_print(csound, later_instr->read_write);
-        if (dag_intersect(csound, current_instr->write,
-                          later_instr->read, cnt++)       ||
-            dag_intersect(csound, current_instr->read_write,
-                          later_instr->read, cnt++)       ||
-            dag_intersect(csound, current_instr->read,
-                          later_instr->write, cnt++)      ||
-            dag_intersect(csound, current_instr->write,
-                          later_instr->write, cnt++)      ||
-            dag_intersect(csound, current_instr->read_write,
-                          later_instr->write, cnt++)      ||
-            dag_intersect(csound, current_instr->read,
-                          later_instr->read_write, cnt++) ||
-            dag_intersect(csound, current_instr->write,
-                          later_instr->read_write, cnt++)) {
-          char *tt = csound->dag_task_dep[j];
-          if (tt==NULL) {
-            /* get dep vector if missing and set watch first time */
-            tt = csound->dag_task_dep[j] =
-              (char*)csound->Calloc(csound, sizeof(char)*(j+1));
-            csound->dag_task_status[j].s = WAITING;
-            csound->dag_wlmm[j].next = csound->dag_task_watch[i];
-            csound->dag_wlmm[j].id = j;
-            csound->dag_task_watch[i] = &(csound->dag_wlmm[j]);
-            //printf("set watch %d to %d\n", j, i);
+    for (i=0; i<csound->dag_num_slots; i++)
+      if (csound->dag_nodes[i].seen >= 0 && csound->dag_nodes[i].seen != stamp) {
+        dag_remove_task(csound, i);
+        removed++;
+      }
+
+    /* link in the new instances; the chain is sorted by instrument so
+       the instances of each instrument form one run */
+    for (ip = chain; ip != NULL; ip = ip->nxtact) {
+      taskID t;
+      if (INSDS_PRIV_OF(ip)->dag_task >= 0) continue;
+      t = dag_add_task(csound, ip);
+      added++;
+      run = chain;
+      while (run != NULL) {
+        INSDS *y = run;
+        int insno = run->insno;
+        if (dag_conflicts(csound, insno, ip->insno)) {
+          int before = (insno <= ip->insno);
+          for (; y != NULL && y->insno == insno; y = y->nxtact) {
+            taskID u = INSDS_PRIV_OF(y)->dag_task;
+            if (y == ip) { before = 0; continue; }
+            /* new instances not yet linked pick this one up later */
+            if (u < 0) continue;
+            if (before) dag_add_edge(csound, u, t);
+            else dag_add_edge(csound, t, u);
           }
-          tt[i] = 1;
-          //printf("-yes ");
         }
-        j++; next = next->nxtact;
+        else
+          while (y != NULL && y->insno == insno) y = y->nxtact;
+        run = y;
+      }
+    }
+    csound->dag_changed = 0;
+
+    /* the width of the DAG is the largest number of tasks at one depth */
+    width = (int *)csound->Calloc(csound, sizeof(int)*(csound->dag_num_active+1));
+    csound->dag_width = 0;
+    for (ip = chain; ip != NULL; ip = ip->nxtact) {
+      taskID t = INSDS_PRIV_OF(ip)->dag_task;
+      int e, l = 0;
+      for (e = csound->dag_nodes[t].first_in; e >= 0;
+           e = csound->dag_edges[e].next_in) {
+        int from = csound->dag_edges[e].from;
+        if (csound->dag_nodes[from].level >= l)
+          l = csound->dag_nodes[from].level + 1;
       }
-      task_map[i] = chain;
-      i++; chain = chain->nxtact;
+      csound->dag_nodes[t].level = l;
+      if (++width[l] > csound->dag_width) csound->dag_width = width[l];
     }
+    csound->Free(csound, width);
+
+    if (UNLIKELY(csound->oparms->odebug))
+      printf("dag_num_active = %d (+%d -%d)\n",
+             csound->dag_num_active, added, removed);
+    dag_reinit(csound);
     if (UNLIKELY(csound->oparms->odebug)) dag_print_state(csound);
 }
 
-void dag_reinit(CSOUND *csound)
+/* Rebuild the DAG from scratch */
+void dag_build(CSOUND *csound, INSDS *chain)
 {
-    int i;
-    int max = csound->dag_task_max_size;
-    volatile stateWithPadding *task_status = csound->dag_task_status;
-    watchList * volatile *task_watch = csound->dag_task_watch;
-    watchList *wlmm = csound->dag_wlmm;
-    if (UNLIKELY(csound->oparms->odebug))
-      printf("DAG REINIT************************\n");
-    for (i=csound->dag_num_active; i<max; i++)
-      task_status[i].s = DONE;
-    task_status[0].s = AVAILABLE;
-    task_watch[0] = NULL;
-    for (i=1; i<csound->dag_num_active; i++) {
-      int j;
-      task_status[i].s = AVAILABLE;
-      task_watch[i] = NULL;
-      if (csound->dag_task_dep[i]==NULL) continue;
-      for (j=0; j<i; j++)
-        if (csound->dag_task_dep[i][j]) {
-          task_status[i].s = WAITING;
-          wlmm[i].id = i;
-          wlmm[i].next = task_watch[j];
-          task_watch[j] = &wlmm[i];
-          break;
-        }
-    }
-    //dag_print_state(csound);
+    //printf("DAG BUILD***************************************\n");
+    ATOMIC_SET(csound->dag_orc_changed, 1);
+    dag_update(csound, chain);
 }
 
+
 //#define ATOMIC_READ(x) __atomic_load(&(x), __ATOMIC_SEQ_CST)
-//#define ATOMIC_WRITE(x,v) __atomic_(&(x), v, __ATOMIC_SEQ_CST)
-#define ATOMIC_READ(x) x
-#define ATOMIC_WRITE(x,v) x = v;
+//#define ATOMIC_WRITE(x,v) __atomic_(&(x), v, __ATOMIC_SEQ_CST);
+#define ATOMIC_READ(x) ATOMIC_GET(x)
+#define ATOMIC_WRITE(x,v) ATOMIC_SET(x,v)
 #if defined(_MSC_VER)
 #define ATOMIC_CAS(x,current,new) \
   (current == InterlockedCompareExchange(x, new, current))
 #else
 #define ATOMIC_CAS(x,current,new)  \
-  __atomic_compare_exchange_n(x,&(current),new, true, __ATOMIC_SEQ_CST, \
+  __atomic_compare_exchange_n(x,&(current),new, false, __ATOMIC_SEQ_CST, \
                               __ATOMIC_SEQ_CST)
 #endif
-
+/* decrement returning the new value */
 #if defined(_MSC_VER)
-#define ATOMIC_CAS_PTR(x,current,new) \
-  (current == InterlockedCompareExchangePointer(x, new, current))
+#define ATOMIC_DEC_FETCH(x) InterlockedDecrement(&(x))
 #else
-#define ATOMIC_CAS_PTR(x,current,new)  \
-  __atomic_compare_exchange_n(x,&(current),new, true, __ATOMIC_SEQ_CST,\
-                              __ATOMIC_SEQ_CST)
+#define ATOMIC_DEC_FETCH(x) __atomic_sub_fetch(&(x), 1, __ATOMIC_SEQ_CST)
 #endif
 
-taskID dag_get_task(CSOUND *csound, int index, int numThreads, taskID next_task)
+/* Work-stealing deque operations (Chase and Lev, SPAA 2005).
+ * Only the owner calls push and pop; any thread may steal.
+ */
+static inline void deque_push(taskDeque *d, taskID t)
 {
-    int i;
-    int count_waiting = 0;
-    int active = csound->dag_num_active;
-    int start = (index * active) / numThreads;
-    volatile stateWithPadding *task_status = csound->dag_task_status;
-    enum state current_task_status;
+    int b = d->bottom;
+    d->tasks[b] = t;
+    ATOMIC_WRITE(d->bottom, b+1);
+}
 
-    if (next_task != INVALID) {
-      // Have forwarded one task from the previous one
-      // assert(ATOMIC_READ(task_status[next_task].s) == WAITING);
-      ATOMIC_WRITE(task_status[next_task].s,INPROGRESS);
-      return next_task;
+static inline taskID deque_pop(taskDeque *d)
+{
+    int b = d->bottom - 1;
+    int t;
+    taskID task;
+    ATOMIC_WRITE(d->bottom, b);
+    t = ATOMIC_READ(d->top);
+    if (t > b) {                /* empty */
+      ATOMIC_WRITE(d->bottom, t);
+      return INVALID;
     }
-
-    //printf("**GetTask from %d\n", csound->dag_num_active);
-    i = start;
-    do {
-      current_task_status = ATOMIC_READ(task_status[i].s);
-
-      switch (current_task_status) {
-      case AVAILABLE :
-        // Need to CAS as the value may have changed
-        if (ATOMIC_CAS(&(task_status[i].s), current_task_status, INPROGRESS)) {
-          return (taskID)i;
-        }
-        break;
-
-      case WAITING :
-        //  printf("**%d waiting\n", i);
-        ++count_waiting;
-        break;
-
-      case INPROGRESS :
-        //  print(f"**%d active\n", i);
-        break;
-
-      case DONE :
-        //printf("**%d done\n", i);
-        break;
-
-      default :
-        // Enum corrupted!
-        //assert(0);
-        break;
-      }
-
-      // Increment modulo active
-      i = (i+1 == active) ? 0 : i + 1;
-
-    } while (i != start);
-    //dag_print_state(csound);
-    if (count_waiting == 0) return (taskID)INVALID;
-    //printf("taskstodo=%d)\n", morework);
-    return (taskID)WAIT;
+    task = d->tasks[b];
+    if (t == b) {               /* last one: race any thief for it */
+      if (!ATOMIC_CAS(&d->top, t, t+1)) task = INVALID;
+      ATOMIC_WRITE(d->bottom, b+1);
+    }
+    return task;
 }
 
-/* This static is OK as not written */
-static const watchList DoNotRead = { INVALID, NULL};
+static inline taskID deque_steal(taskDeque *d)
+{
+    int t = ATOMIC_READ(d->top);
+    int b = ATOMIC_READ(d->bottom);
+    taskID task;
+    if (t >= b) return INVALID;
+    task = d->tasks[t];
+    if (!ATOMIC_CAS(&d->top, t, t+1)) return WAIT; /* lost the race */
+    return task;
+}
 
-inline static int moveWatch(CSOUND *csound, watchList * volatile *w,
-                            watchList *t)
+void dag_reinit(CSOUND *csound)
 {
-     IGN(csound);
-    watchList *local=*w;
-    t->next = NULL;
-    //printf("moveWatch\n");
-    do {
-      //dag_print_state(csound);
-      local = ATOMIC_READ(*w);
-      if (local==&DoNotRead) {
-        //printf("local is DoNotRead\n");
-        return 0;//was no & earlier
+    int i, ready = 0;
+    int active = csound->dag_num_active;
+    int ndeques = csound->dag_num_deques;
+    volatile stateWithPadding *task_status = csound->dag_task_status;
+    if (UNLIKELY(csound->oparms->odebug))
+      printf("DAG REINIT************************\n");
+    for (i=0; i<ndeques; i++) {
+      csound->dag_deques[i].top = 0;
+      csound->dag_deques[i].bottom = 0;
+    }
+    /* Use no more threads than the DAG can keep busy */
+    if (active <= INLINE_TASKS || csound->dag_width <= 1)
+      ndeques = 1;
+    else if (csound->dag_width < ndeques)
+      ndeques = csound->dag_width;
+    csound->dag_num_threads = ndeques;
+    /* Deal the initially runnable tasks out to the threads; pushed in
+       reverse so that each owner pops the lower slots first */
+    for (i=csound->dag_num_slots-1; i>=0; i--) {
+      if (csound->dag_nodes[i].seen < 0) continue;   /* free slot */
+      task_status[i].pending = task_status[i].deps;
+      if (task_status[i].deps == 0) {
+        task_status[i].s = AVAILABLE;
+        deque_push(&csound->dag_deques[ready++ % ndeques], i);
       }
-      else t->next = local;
-    } while (!ATOMIC_CAS_PTR(w,local,t));
+      else task_status[i].s = WAITING;
+    }
+    ATOMIC_WRITE(csound->dag_tasks_left.n, active);
     //dag_print_state(csound);
-    //printf("moveWatch done\n");
-    return 1;
 }
 
-taskID dag_end_task(CSOUND *csound, taskID i)
+taskID dag_get_task(CSOUND *csound, int index, int numThreads, taskID next_task)
 {
-    watchList *to_notify, *next;
-    int canQueue;
-    int j, k;
-    watchList * volatile *task_watch = csound->dag_task_watch;
-    enum state current_task_status;
-    int wait_on_current_tasks;
-    taskID next_task = INVALID;
-    ATOMIC_WRITE(csound->dag_task_status[i].s, DONE); /* as DONE is zero */
-    // A write barrier /might/ be useful here to avoid the case
-    // of the list being DoNotRead but the status being something
-    // other than done.  At the time of writing this wouldn't give
-    // a correctness issue, plus the semantics of GCC's CAS apparently
-    // imply a write barrier, so it should be OK.
-    {                                      /* ATOMIC_SWAP */
-      do {
-        to_notify = ATOMIC_READ(task_watch[i]);
-      } while (!ATOMIC_CAS_PTR(&task_watch[i],to_notify,(watchList *) &DoNotRead));
-    } //to_notify = ATOMIC_SWAP(task_watch[i], &DoNotRead);
-    //printf("Ending task %d\n", i);
-    next = to_notify;
-    while (to_notify) {         /* walk the list of watchers */
-      next = to_notify->next;
-      j = to_notify->id;
-      //printf("%d notifying task %d it finished\n", i, j);
-      canQueue = 1;
-      wait_on_current_tasks = 0;
-
-      for (k=0; k<j; k++) {     /* seek next watch */
-        if (csound->dag_task_dep[j][k]==0) continue;
-        current_task_status = ATOMIC_READ(csound->dag_task_status[k].s);
-        //printf("investigating task %d (%d)\n", k, current_task_status);
-
-        if (current_task_status == WAITING) {   // Prefer watching blocked tasks
-          //printf("found task %d to watch %d status %d\n",
-          //       k, j, csound->dag_task_status[k].s);
-          if (moveWatch(csound, &task_watch[k], to_notify)) {
-            //printf("task %d now watches %d\n", j, k);
-            canQueue = 0;
-            wait_on_current_tasks = 0;
-            break;
-          }
-          else {
-            /* assert csound->dag_task_status[j].s == DONE and we are in race */
-            //printf("Racing status %d %d %d %d\n",
-            //       csound->dag_task_status[j].s, i, j, k);
-          }
+    int i, ndeques = csound->dag_num_threads;
+    taskID task;
+    int contended = 0;
+    IGN(numThreads);
 
-        }
-        else if (current_task_status == AVAILABLE ||
-                 current_task_status == INPROGRESS) {
-          wait_on_current_tasks = 1;
-        }
-        //else { printf("not %d\n", k); }
+    if (next_task != INVALID) {
+      // Have forwarded one task from the previous one
+      ATOMIC_WRITE(csound->dag_task_status[next_task].s, INPROGRESS);
+      return next_task;
+    }
+    /* Own work first, newest first for cache locality */
+    task = deque_pop(&csound->dag_deques[index]);
+    if (task == INVALID) {
+      /* then steal the oldest task of another thread */
+      for (i = 1; i < ndeques; i++) {
+        task = deque_steal(&csound->dag_deques[(index+i) % ndeques]);
+        if (task >= 0) break;
+        if (task == WAIT) contended = 1;
       }
+    }
+    if (task >= 0) {
+      ATOMIC_WRITE(csound->dag_task_status[task].s, INPROGRESS);
+      return task;
+    }
+    if (contended || ATOMIC_READ(csound->dag_tasks_left.n) > 0) {
+      CPU_RELAX();
+      return (taskID)WAIT;
+    }
+    return (taskID)INVALID;
+}
 
-      // Try the same thing again but this time waiting on active or available task
-      if (wait_on_current_tasks == 1) {
-        for (k=0; k<j; k++) {     /* seek next watch */
-          if (csound->dag_task_dep[j][k]==0) continue;
-          current_task_status = ATOMIC_READ(csound->dag_task_status[k].s);
-          //printf("investigating task %d (%d)\n", k, current_task_status);
-
-          if (current_task_status != DONE) {   // Prefer watching blocked tasks
-            //printf("found task %d to watch %d status %d\n",
-            //       k, j, csound->dag_task_status[k].s);
-            if (moveWatch(csound, &task_watch[k], to_notify)) {
-              //printf("task %d now watches %d\n", j, k);
-              canQueue = 0;
-              break;
-            }
-            else {
-              /* assert csound->dag_task_status[j].s == DONE and we are in race */
-              //printf("Racing status %d %d %d %d\n",
-              //       csound->dag_task_status[j].s, i, j, k);
-            }
-
-          }
-          //else { printf("not %d\n", k); }
-        }
-      }
+taskID dag_end_task(CSOUND *csound, int index, taskID i)
+{
+    int e;
+    taskID next_task = INVALID;
+    volatile stateWithPadding *task_status = csound->dag_task_status;
+    taskDeque *d = &csound->dag_deques[index];
 
-      if (canQueue) {           /*  could use monitor here */
+    ATOMIC_WRITE(task_status[i].s, DONE);
+    //printf("Ending task %d\n", i);
+    for (e = csound->dag_nodes[i].first_out; e >= 0;
+         e = csound->dag_edges[e].next_out) {
+      taskID j = csound->dag_edges[e].to;
+      /* the last prerequisite to finish makes the task runnable */
+      if (ATOMIC_DEC_FETCH(task_status[j].pending) == 0) {
         if (next_task == INVALID) {
           next_task = j; // Forward directly to the thread to save re-dispatch
         } else {
-          ATOMIC_WRITE(csound->dag_task_status[j].s, AVAILABLE);
+          ATOMIC_WRITE(task_status[j].s, AVAILABLE);
+          deque_push(d, j);
         }
       }
-      to_notify = next;
     }
+    ATOMIC_DEC_FETCH(csound->dag_tasks_left.n);
     //dag_print_state(csound);
     return next_task;
 }
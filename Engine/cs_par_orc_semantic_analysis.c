@@ -387,6 +387,32 @@ INSTR_SEMANTICS *csp_orc_sa_instr_get_by_num(CSOUND *csound, int16 insno)
     return current_instr;
 }
 
+/* Both instruments get the same made up global, written by the first
+   and read by the second, so the DAG links their instances as it would
+   for a global variable.  The conflict cache and the DAG are rebuilt
+   before the next k-cycle. */
+int csp_orc_sa_dependency(CSOUND *csound, int insno1, int insno2)
+{
+    INSTR_SEMANTICS *first, *second;
+    struct set_element_t *ele;
+    char name[32], *s;
+
+    first = csp_orc_sa_instr_get_by_num(csound, (int16) insno1);
+    second = csp_orc_sa_instr_get_by_num(csound, (int16) insno2);
+    if (UNLIKELY(first == NULL || second == NULL))
+      return -1;
+    snprintf(name, sizeof(name), "##dep%d.%d", insno1, insno2);
+    for (ele = first->write->head; ele != NULL; ele = ele->next)
+      if (strcmp((char *) ele->data, name) == 0)
+        return 0;                       /* already known */
+    s = cs_strdup(csound, name);
+    csp_set_add(csound, first->write, s);
+    csp_set_add(csound, second->read, s);
+    csound->dag_orc_changed = 1;
+    csound->dag_changed++;
+    return 0;
+}
+
 /* ANALYZE TREE */
 
 void csp_orc_analyze_tree(CSOUND* csound, TREE* root)
@@ -34,6 +34,7 @@
 #include "insert.h"
 #include "oload.h"
 #include "pstream.h"
+#include "fgens.h"
 //#include "typetabl.h"
 #include "csound_orc_semantics.h"
 #include "csound_standard_types.h"
@@ -58,6 +59,7 @@ int named_instr_alloc(CSOUND *csound, char *s, INSTRTXT *ip, int32 insno,
                       ENGINE_STATE *engineState, int merge);
 int check_instr_name(char *s);
 void free_instr_var_memory(CSOUND *, INSDS *);
+void free_instr_pool(CSOUND *, INSTRTXT *);
 void mergeState_enqueue(CSOUND *csound, ENGINE_STATE *e, TYPE_TABLE *t,
                         OPDS *ids);
 
@@ -963,9 +965,11 @@ void free_instrtxt(CSOUND *csound, INSTRTXT *instrtxt) {
     free_instr_var_memory(csound, active);
     if (active->opcod_iobufs != NULL)
       csound->Free(csound, active->opcod_iobufs);
-    csound->Free(csound, active);
+    if (!INSDS_PRIV_OF(active)->pooled)
+      csound->Free(csound, INSDS_BASE(active));
     active = nxt;
   }
+  free_instr_pool(csound, ip);
   OPTXT *t = ip->nxtop;
   while (t) {
     OPTXT *s = t->nxtop;
@@ -1408,6 +1412,9 @@ int engineState_merge(CSOUND *csound, ENGINE_STATE *engineState) {
      engineState->constantsPool->values[count].value);
      }*/
 
+  /* before any of the new code can write to a shared table */
+  csoundFTUnshareWriters(csound, engineState);
+
   CS_VARIABLE *gVar = engineState->varPool->head;
   while (gVar != NULL) {
     CS_VARIABLE *var;
@@ -1562,6 +1569,9 @@ void merge_state(CSOUND *csound, ENGINE_STATE *engineState,
   /* run global i-time code */
   init0(csound);
   csound->ids = ids;
+  /* instrument semantics may have changed: rebuild the DAG */
+  ATOMIC_SET(csound->dag_orc_changed, 1);
+  csound->dag_changed++;
   if (csound->init_pass_threadlock)
     csoundUnlockMutex(csound->init_pass_threadlock);
 }
@@ -1881,6 +1891,7 @@ int csoundCompileTreeInternal(CSOUND *csound, TREE *root, int async) {
       insprep(csound, ip, engineState);    /*   as combined offsets */
       recalculateVarPoolMemory(csound, ip->varPool);
     }
+    csoundFTUnshareWriters(csound, engineState);
 
     CS_VARIABLE *var;
     var = csoundFindVariableWithName(csound, engineState->varPool, "sr");
@@ -27,6 +27,7 @@
 #include "csound_orc_expressions.h"
 #include "csound_type_system.h"
 #include "csound_orc_semantics.h"
+#include "aops.h"
 #include <inttypes.h>
 
 extern char argtyp2(char *);
@@ -34,6 +35,7 @@ extern void print_tree(CSOUND *, char *, TREE *);
 extern void handle_optional_args(CSOUND *, TREE *);
 extern ORCTOKEN *make_token(CSOUND *, char *);
 extern ORCTOKEN *make_label(CSOUND *, char *);
+extern ORCTOKEN *make_string(CSOUND *, char *);
 extern OENTRIES* find_opcode2(CSOUND *, char*);
 extern char* resolve_opcode_get_outarg(CSOUND* , OENTRIES* , char*);
 extern TREE* appendToTree(CSOUND * csound, TREE *first, TREE *newlast);
@@ -495,6 +497,142 @@ static char* create_out_arg_for_expression(CSOUND* csound, char* op, TREE* left,
                           typeTable->localPool->synthArgCount++, typeTable);
 }
 
+/* Fused a-rate arithmetic: a tree of + - * / and unary minus with an
+   a-rate result becomes one ##fuse opcode (OOps/aops.c) instead of a
+   chain of mulaa/addak/... with an a-rate temporary for every node.
+   Its first argument is the tree in postfix, one character per node:
+   a, k or i for the leaves, which follow as the other arguments, and
+   + - * / n (negation) for the operators.  Other sub-expressions
+   (function calls, array reads) are lowered as usual and become leaves.
+   i-rate leaves include constants, so i-time subtrees fold at init. */
+
+static int is_fusable_op(TREE *t)
+{
+    switch (t->type) {
+    case '+':
+    case '-':
+    case '*':
+    case '/':
+      return (t->left != NULL && t->right != NULL &&
+              (t->value == NULL || t->value->optype == NULL));
+    case S_UMINUS:
+      return (t->right != NULL);
+    }
+    return 0;
+}
+
+/* the leaf's character in the program, 0 if it cannot be fused */
+static char fuse_leaf_kind(CSOUND *csound, TREE *t, TYPE_TABLE *typeTable)
+{
+    char *type, kind = 0;
+
+    if (t->type == '?' || t->type == STRING_TOKEN ||
+        is_boolean_expression_node(t))
+      return 0;
+    type = get_arg_type2(csound, t, typeTable);
+    if (type == NULL)
+      return 0;
+    if (type[0] != '\0' && type[1] == '\0') {
+      switch (type[0]) {
+      case 'a':
+      case 'k':
+        kind = type[0];
+        break;
+      case 'i':
+      case 'c':
+      case 'p':
+      case 'r':
+        /* a global i-variable can be changed by another instrument */
+        kind = (t->type == T_IDENT && t->value->lexeme[0] == 'g') ? 'k' : 'i';
+        break;
+      }
+    }
+    csound->Free(csound, type);
+    return kind;
+}
+
+static int fuse_scan(CSOUND *csound, TREE *t, TYPE_TABLE *typeTable,
+                     int *nodes, int *ops, int *audio)
+{
+    char kind;
+
+    if (++(*nodes) > FUSE_MAXNODES)
+      return 0;
+    if (is_fusable_op(t)) {
+      (*ops)++;
+      if (t->type != S_UMINUS &&
+          !fuse_scan(csound, t->left, typeTable, nodes, ops, audio))
+        return 0;
+      return fuse_scan(csound, t->right, typeTable, nodes, ops, audio);
+    }
+    if ((kind = fuse_leaf_kind(csound, t, typeTable)) == 0)
+      return 0;
+    if (kind == 'a')
+      *audio = 1;
+    return 1;
+}
+
+static void fuse_emit(CSOUND *csound, TREE *t, char *prog, TREE **args,
+                      TREE **anchor, int line, int locn,
+                      TYPE_TABLE *typeTable)
+{
+    TREE    *leaf = t;
+    size_t  len;
+
+    if (is_fusable_op(t)) {
+      if (t->type != S_UMINUS)
+        fuse_emit(csound, t->left, prog, args, anchor, line, locn, typeTable);
+      fuse_emit(csound, t->right, prog, args, anchor, line, locn, typeTable);
+      len = strlen(prog);
+      prog[len] = (t->type == S_UMINUS ? 'n' : (char) t->type);
+      prog[len + 1] = '\0';
+      return;
+    }
+    if (is_expression_node(t)) {
+      TREE *chain = create_expression(csound, t, line, locn, typeTable);
+      if (chain != NULL) {
+        *anchor = appendToTree(csound, *anchor, chain);
+        leaf = create_ans_token(csound, tree_tail(chain)->left->value->lexeme);
+      }
+    }
+    leaf->next = NULL;
+    len = strlen(prog);
+    prog[len] = fuse_leaf_kind(csound, leaf, typeTable);
+    prog[len + 1] = '\0';
+    *args = appendToTree(csound, *args, leaf);
+}
+
+/* returns NULL if root is not worth fusing; it is then left untouched */
+static TREE *create_fused_expression(CSOUND *csound, TREE *root,
+                                     int line, int locn,
+                                     TYPE_TABLE* typeTable)
+{
+    char    prog[FUSE_MAXNODES + 3], *outarg;
+    TREE    *anchor = NULL, *args = NULL, *opTree;
+    int     nodes = 0, ops = 0, audio = 0;
+
+    if (!fuse_scan(csound, root, typeTable, &nodes, &ops, &audio) ||
+        ops < 2 || !audio)
+      return NULL;
+    strcpy(prog, "\"");
+    fuse_emit(csound, root, prog, &args, &anchor, line, locn, typeTable);
+    strcat(prog, "\"");
+    if (UNLIKELY(PARSER_DEBUG))
+      csound->Message(csound, "Fused expression: %s\n", prog);
+
+    opTree = create_opcode_token(csound, "##fuse");
+    opTree->right = make_leaf(csound, line, locn, STRING_TOKEN,
+                              make_string(csound, prog));
+    opTree->right->next = args;
+    outarg = create_out_arg(csound, "a",
+                            typeTable->localPool->synthArgCount++, typeTable);
+    opTree->left = create_ans_token(csound, outarg);
+    opTree->line = line;
+    opTree->locn = locn;
+    csound->Free(csound, outarg);
+    return appendToTree(csound, anchor, opTree);
+}
+
 /**
  * Create a chain of Opcode (OPTXT) text from the AST node given. Called from
  * create_opcode when an expression node has been found as an argument
@@ -510,6 +648,10 @@ static TREE *create_expression(CSOUND *csound, TREE *root, int line, int locn,
 
     if (root->type=='?') return create_cond_expression(csound, root, line,
                                                        locn, typeTable);
+    if (is_fusable_op(root) &&
+        (anchor = create_fused_expression(csound, root, line,
+                                          locn, typeTable)) != NULL)
+      return anchor;
     memset(op, 0, 80);
     current = root->left;
     newArgList = NULL;
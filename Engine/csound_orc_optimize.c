@@ -26,6 +26,8 @@
 #include "csound_orc.h"
 extern void print_tree(CSOUND *csound, char*, TREE *l);
 extern void delete_tree(CSOUND *csound, TREE *l);
+extern int pnum(char *);
+extern OENTRIES *find_opcode2(CSOUND *, char *);
 
 static TREE * create_fun_token(CSOUND *csound, TREE *right, char *fname)
 {
@@ -420,6 +422,380 @@ TREE* constant_fold(CSOUND *csound, TREE* root)
 }
 
 
+/* Passes over the expanded statements of each instrument and UDO body,
+   selected with --orc-opt (OPARMS.orcopt):
+     cse    a pure expression with the same opcode and inputs as an
+            earlier one in the same basic block reuses its result
+     dce    pure statements whose local outputs are never read are removed
+     hoist  k = <i-time value> copies that are the only write of the
+            variable and always run become init statements
+   Only compiler temporaries (#-names) take part in CSE, so no variable
+   is ever aliased that was not before. */
+
+typedef struct {
+    int     cse, dce, hoist;
+} OPT_STATS;
+
+static const char *pure_ops[] = {
+    "##add", "##sub", "##mul", "##div", "##mod", "##pow", "##fuse",
+    "##and", "##or", "##xor", "##not", "##shl", "##shr",
+    "abs", "int", "frac", "round", "floor", "ceil", "exp", "log", "log2",
+    "log10", "sqrt", "sin", "cos", "tan", "sininv", "cosinv", "taninv",
+    "sinh", "cosh", "tanh", "ampdb", "dbamp", "ampdbfs", "dbfsamp",
+    "cpspch", "pchoct", "octpch", "cpsoct", "octcps", "powoftwo",
+    "logbtwo", "cpsmidinn", "pchmidinn", "octmidinn", "signum", "i", "k",
+    NULL
+};
+
+static int opname_is(const char *opname, const char *base)
+{
+    size_t n = strlen(base);
+    return (strncmp(opname, base, n) == 0 &&
+            (opname[n] == '\0' || opname[n] == '.'));
+}
+
+static OENTRY *stmt_oentry(TREE *t)
+{
+    switch (t->type) {
+    case '=':
+    case T_OPCODE:
+    case T_OPCODE0:
+      return (OENTRY*) t->markup;
+    }
+    return NULL;
+}
+
+/* no side effects, result only depends on the inputs */
+static int is_pure_expr(OENTRY *ep)
+{
+    int i;
+    if (ep == NULL || ep->useropinfo != NULL)
+      return 0;
+    for (i = 0; pure_ops[i] != NULL; i++)
+      if (opname_is(ep->opname, pure_ops[i]))
+        return 1;
+    return 0;
+}
+
+/* pure, and may be dropped when its outputs are unused */
+static int is_removable(OENTRY *ep)
+{
+    return (is_pure_expr(ep) ||
+            (ep != NULL && ep->useropinfo == NULL &&
+             (opname_is(ep->opname, "=") || opname_is(ep->opname, "init"))));
+}
+
+static int is_constant_arg(TREE *a)
+{
+    const char *s = a->value->lexeme;
+    switch (a->type) {
+    case INTEGER_TOKEN:
+    case NUMBER_TOKEN:
+    case STRING_TOKEN:
+    case SRATE_TOKEN:
+    case KRATE_TOKEN:
+    case KSMPS_TOKEN:
+    case A4_TOKEN:
+    case ZERODBFS_TOKEN:
+    case NCHNLS_TOKEN:
+    case NCHNLSI_TOKEN:
+      return 1;
+    }
+    return ((*s >= '1' && *s <= '9') || *s == '.' || *s == '-' ||
+            *s == '+' || *s == '"' || (*s == '0' && strcmp(s, "0dbfs") != 0));
+}
+
+/* a variable of this instrument (not global, not a p-field) */
+static int is_local_var(TREE *a)
+{
+    const char *s = a->value->lexeme;
+    if (is_constant_arg(a) || pnum((char*) s) >= 0)
+      return 0;
+    if (*s == '#')
+      s++;
+    return (*s != 'g');
+}
+
+/* fixed for the whole note: constants, p-fields and local i-variables */
+static int is_itime_arg(TREE *a)
+{
+    const char *s = a->value->lexeme;
+    if (is_constant_arg(a) || pnum((char*) s) >= 0)
+      return 1;
+    if (*s == '#')
+      s++;
+    return (*s == 'i');
+}
+
+static int same_inputs(TREE *a, TREE *b)
+{
+    for ( ; a != NULL && b != NULL; a = a->next, b = b->next)
+      if (strcmp(a->value->lexeme, b->value->lexeme) != 0)
+        return 0;
+    return (a == NULL && b == NULL);
+}
+
+static int reads_var(TREE *args, const char *name)
+{
+    for ( ; args != NULL; args = args->next) {
+      if (args->value != NULL && strcmp(args->value->lexeme, name) == 0)
+        return 1;
+      if ((args->left != NULL && reads_var(args->left, name)) ||
+          (args->right != NULL && reads_var(args->right, name)))
+        return 1;
+    }
+    return 0;
+}
+
+static void rename_reads(CSOUND *csound, TREE *args,
+                         const char *from, const char *to)
+{
+    for ( ; args != NULL; args = args->next) {
+      if (args->value != NULL && strcmp(args->value->lexeme, from) == 0) {
+        csound->Free(csound, args->value->lexeme);
+        args->value->lexeme = cs_strdup(csound, (char*) to);
+      }
+      if (args->left != NULL)
+        rename_reads(csound, args->left, from, to);
+      if (args->right != NULL)
+        rename_reads(csound, args->right, from, to);
+    }
+}
+
+static const char *body_name(TREE *body)
+{
+    TREE *n = body->left;
+    if (body->type == UDO_TOKEN || (n != NULL && n->type == T_IDENT))
+      return n->value->lexeme;
+    if (n != NULL && n->type == T_INSTLIST && n->left != NULL)
+      n = n->left;
+    return (n != NULL && n->value != NULL) ? n->value->lexeme : "?";
+}
+
+static void cse_pass(CSOUND *csound, TREE *body, OPT_STATS *st)
+{
+    TREE  *avail[64], *t, *prev = NULL, *nxt;
+    int   navail = 0, i;
+
+    for (t = body->right; t != NULL; t = nxt) {
+      OENTRY *ep = stmt_oentry(t);
+      TREE   *out;
+      nxt = t->next;
+      if (ep == NULL) {                 /* label or unknown: new block */
+        navail = 0;
+        prev = t;
+        continue;
+      }
+      if (is_pure_expr(ep) && t->left != NULL && t->left->next == NULL &&
+          t->left->value->lexeme[0] == '#') {
+        for (i = 0; i < navail; i++)
+          if (avail[i]->markup == t->markup &&
+              same_inputs(avail[i]->right, t->right))
+            break;
+        if (i < navail) {
+          const char *from = t->left->value->lexeme;
+          const char *to = avail[i]->left->value->lexeme;
+          TREE *u;
+          if (csound->oparms->odebug)
+            csound->Message(csound, Str("orc-opt: %s %s line %d: %s reuses %s "
+                                        "(%s)\n"),
+                            body->type == UDO_TOKEN ? "opcode" : "instr",
+                            body_name(body), t->line, from, to, ep->opname);
+          for (u = nxt; u != NULL; u = u->next)
+            rename_reads(csound, u->right, from, to);
+          prev->next = nxt;             /* prev exists: avail is not empty */
+          t->next = NULL;
+          delete_tree(csound, t);
+          st->cse++;
+          continue;
+        }
+      }
+      /* anything written invalidates the expressions that read it */
+      for (out = t->left; out != NULL; out = out->next)
+        for (i = 0; i < navail; )
+          if (reads_var(avail[i]->right, out->value->lexeme) ||
+              strcmp(avail[i]->left->value->lexeme, out->value->lexeme) == 0)
+            avail[i] = avail[--navail];
+          else i++;
+      /* other opcodes may change their inputs, or globals */
+      if (!is_removable(ep)) {
+        for (i = 0; i < navail; ) {
+          TREE *a;
+          int  kill = 0;
+          for (a = avail[i]->right; a != NULL && !kill; a = a->next)
+            kill = (!is_constant_arg(a) &&
+                    (!is_local_var(a) || reads_var(t->right, a->value->lexeme)));
+          if (kill) avail[i] = avail[--navail];
+          else i++;
+        }
+      }
+      if (is_pure_expr(ep) && t->left != NULL && t->left->next == NULL &&
+          t->left->value->lexeme[0] == '#' && navail < 64 &&
+          !reads_var(t->right, t->left->value->lexeme))
+        avail[navail++] = t;
+      prev = t;
+    }
+}
+
+static int count_reads(CSOUND *csound, TREE *body, CS_HASH_TABLE *reads)
+{
+    TREE *t;
+    int  n = 0;
+    for (t = body->right; t != NULL; t = t->next) {
+      TREE *a;
+      /* labels, and anything unusual on the left, count as reads */
+      for (a = t->right; a != NULL; a = a->next, n++)
+        if (a->value != NULL)
+          cs_hash_table_put(csound, reads, a->value->lexeme, (void*) 1);
+      for (a = t->left; a != NULL; a = a->next) {
+        if (a->type != T_IDENT && a->value != NULL)
+          cs_hash_table_put(csound, reads, a->value->lexeme, (void*) 1);
+        if (a->left != NULL || a->right != NULL) {
+          TREE *b;
+          for (b = a->left; b != NULL; b = b->next)
+            if (b->value != NULL)
+              cs_hash_table_put(csound, reads, b->value->lexeme, (void*) 1);
+          for (b = a->right; b != NULL; b = b->next)
+            if (b->value != NULL)
+              cs_hash_table_put(csound, reads, b->value->lexeme, (void*) 1);
+        }
+      }
+      if (stmt_oentry(t) == NULL && t->value != NULL)
+        cs_hash_table_put(csound, reads, t->value->lexeme, (void*) 1);
+    }
+    return n;
+}
+
+static void dce_pass(CSOUND *csound, TREE *body, OPT_STATS *st)
+{
+    int changed;
+    do {
+      CS_HASH_TABLE *reads = cs_hash_table_create(csound);
+      TREE *t, *prev = NULL, *nxt;
+      changed = 0;
+      count_reads(csound, body, reads);
+      for (t = body->right; t != NULL; t = nxt) {
+        OENTRY *ep = stmt_oentry(t);
+        TREE   *out;
+        int    dead = (is_removable(ep) && t->left != NULL);
+        nxt = t->next;
+        for (out = t->left; out != NULL && dead; out = out->next)
+          dead = (out->type == T_IDENT && is_local_var(out) &&
+                  cs_hash_table_get(csound, reads,
+                                    out->value->lexeme) == NULL);
+        if (!dead) {
+          prev = t;
+          continue;
+        }
+        if (csound->oparms->odebug)
+          csound->Message(csound, Str("orc-opt: %s %s line %d: removed %s, "
+                                      "%s is never read\n"),
+                          body->type == UDO_TOKEN ? "opcode" : "instr",
+                          body_name(body), t->line, ep->opname,
+                          t->left->value->lexeme);
+        if (prev == NULL) body->right = nxt;
+        else prev->next = nxt;
+        t->next = NULL;
+        delete_tree(csound, t);
+        st->dce++;
+        changed = 1;
+      }
+      cs_hash_table_free(csound, reads);
+    } while (changed);
+}
+
+static int write_count(TREE *body, const char *name)
+{
+    TREE *t, *out;
+    int  n = 0;
+    for (t = body->right; t != NULL; t = t->next)
+      for (out = t->left; out != NULL; out = out->next)
+        if (out->value != NULL && strcmp(out->value->lexeme, name) == 0)
+          n++;
+    return n;
+}
+
+static void hoist_pass(CSOUND *csound, TREE *body, OPT_STATS *st)
+{
+    OENTRY *initk = NULL;
+    TREE   *t;
+
+    for (t = body->right; t != NULL; t = t->next) {
+      OENTRY *ep = stmt_oentry(t);
+      TREE   *a, *u;
+      int    ok;
+      /* only the part of the body that always runs */
+      if (ep == NULL || strchr(ep->intypes, 'l') != NULL)
+        break;
+      if (strcmp(ep->opname, "=.k") != 0 || t->left == NULL)
+        continue;
+      ok = 1;
+      for (a = t->right; a != NULL && ok; a = a->next)
+        ok = is_itime_arg(a) && (a->value->lexeme[0] != 'g');
+      for (a = t->left; a != NULL && ok; a = a->next) {
+        ok = (a->type == T_IDENT && is_local_var(a) &&
+              write_count(body, a->value->lexeme) == 1);
+        /* an init-time read would now see the value, including the
+           init pass of opcodes that also run at k-rate */
+        for (u = body->right; u != NULL && ok; u = u->next) {
+          OENTRY *uep = stmt_oentry(u);
+          if (uep != NULL && (uep->thread & 1) &&
+              reads_var(u->right, a->value->lexeme))
+            ok = 0;
+        }
+      }
+      if (!ok)
+        continue;
+      if (initk == NULL) {
+        OENTRIES *entries = find_opcode2(csound, "init");
+        int i;
+        for (i = 0; i < entries->count; i++)
+          if (strcmp(entries->entries[i]->opname, "init.k") == 0)
+            initk = entries->entries[i];
+        csound->Free(csound, entries);
+        if (initk == NULL)
+          return;
+      }
+      if (csound->oparms->odebug)
+        csound->Message(csound, Str("orc-opt: %s %s line %d: %s only set "
+                                    "at init\n"),
+                        body->type == UDO_TOKEN ? "opcode" : "instr",
+                        body_name(body), t->line, t->left->value->lexeme);
+      if (t->value != NULL) {
+        csound->Free(csound, t->value->lexeme);
+        csound->Free(csound, t->value);
+      }
+      t->type = T_OPCODE;
+      t->value = make_token(csound, "init");
+      t->value->type = T_OPCODE;
+      t->markup = initk;
+      st->hoist++;
+    }
+}
+
+static void optimize_bodies(CSOUND *csound, TREE *root)
+{
+    OPT_STATS st = { 0, 0, 0 };
+    int       flags = csound->oparms->orcopt;
+    TREE      *current;
+
+    for (current = root; current != NULL; current = current->next) {
+      if (current->type != INSTR_TOKEN && current->type != UDO_TOKEN)
+        continue;
+      if (flags & ORC_OPT_CSE)
+        cse_pass(csound, current, &st);
+      if (flags & ORC_OPT_DCE)
+        dce_pass(csound, current, &st);
+      if (flags & ORC_OPT_HOIST)
+        hoist_pass(csound, current, &st);
+    }
+    if (st.cse || st.dce || st.hoist)
+      csound->Message(csound, Str("orchestra optimiser: %d common "
+                                  "subexpression(s), %d dead statement(s), "
+                                  "%d assignment(s) moved to init\n"),
+                      st.cse, st.dce, st.hoist);
+}
+
 /* Optimizes tree (expressions, etc.) */
 TREE * csound_orc_optimize(CSOUND *csound, TREE *root)
 {
@@ -435,8 +811,11 @@ TREE * csound_orc_optimize(CSOUND *csound, TREE *root)
       root = root->next;
     }
     //#ifdef JPFF
-    return remove_excess_assigns(csound,original);
+    original = remove_excess_assigns(csound,original);
     //#else
     //return original;
     //#endif
+    if (csound->oparms->orcopt)
+      optimize_bodies(csound, original);
+    return original;
 }
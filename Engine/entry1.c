@@ -187,6 +187,7 @@ OENTRY opcodlst_1[] = {
   { "##mul.aa",  S(AOP),0,    2,      "a",    "aa",   NULL,   mulaa   },
   { "##div.aa",  S(AOP),0,    2,      "a",    "aa",   NULL,   divaa   },
   { "##mod.aa",  S(AOP),0,    2,      "a",    "aa",   NULL,   modaa   },
+  { "##fuse",    S(FUSE),0,   3,      "a",    "S*",   fuse_init, fuse_perf },
   { "##addin.i", S(ASSIGN),0, 1,      "i",    "i",    addin,  NULL    },
   { "##addin.k", S(ASSIGN),0, 2,      "k",    "k",    NULL,   addin   },
   { "##addin.K", S(ASSIGN),0, 2,      "a",    "k",    NULL,   addinak },
@@ -846,11 +847,11 @@ OENTRY opcodlst_1[] = {
   { "init.f",   S(FASSIGN),0, 1,    "f",   "f", (SUBR)fassign_set, NULL, NULL    },
   { "pvsanal",  S(PVSANAL), 0, 3,   "f",   "aiiiioo", pvsanalset, pvsanal   },
   { "pvsynth",  S(PVSYNTH),0, 3,    "a",   "fo",     pvsynthset, pvsynth },
-  { "pvsadsyn", S(PVADS),0,   3,    "a",   "fikopo", pvadsynset, pvadsyn, NULL },
+  { "pvsadsyn", S(PVADS),0,   3,    "a",   "fikopoo", pvadsynset, pvadsyn, NULL },
   { "pvscross", S(PVSCROSS),0,3,    "f",   "ffkk",   pvscrosset, pvscross, NULL },
   { "pvsfread", S(PVSFREAD),0,3,    "f",   "kSo",    pvsfreadset_S, pvsfread, NULL},
   { "pvsfread.i", S(PVSFREAD),0,3,  "f",   "kio",    pvsfreadset, pvsfread, NULL},
-  { "pvsmaska", S(PVSMASKA),0,3,    "f",   "fik",    pvsmaskaset, pvsmaska, NULL  },
+  { "pvsmaska", S(PVSMASKA),TB,3,    "f",   "fik",    pvsmaskaset, pvsmaska, NULL  },
   { "pvsftw",   S(PVSFTW),  TW, 3,  "k",   "fio",    pvsftwset, pvsftw, NULL  },
   { "pvsftr",   S(PVSFTR),TR, 3,    "",    "fio",    pvsftrset, pvsftr, NULL  },
   { "pvsinfo",  S(PVSINFO),0, 1,    "iiii","f",      pvsinfo, NULL, NULL    },
@@ -1076,13 +1077,13 @@ OENTRY opcodlst_1[] = {
     (SUBR) chnget_opcode_init_i, NULL, NULL               },
   { "chnget.k",    S(CHNGET),_CR,           3,      "k",            "S",
     (SUBR) chnget_opcode_init_k, (SUBR) notinit_opcode_stub, NULL },
-  { "chngeti.i",    S(CHNGET),_CR,           1,      "i[]",            "S[]",
+  { "chngeti.i",    S(CHNGETARRAY),_CR,      1,      "i[]",            "S[]",
     (SUBR) chnget_array_opcode_init_i, NULL, NULL               },
-  { "chngeta.a",    S(CHNGET),_CR,           3,      "a[]",            "S[]",
+  { "chngeta.a",    S(CHNGETARRAY),_CR,      3,      "a[]",            "S[]",
     (SUBR) chnget_array_opcode_init, (SUBR) notinit_opcode_stub, NULL },
-  { "chngets.s",    S(CHNGET),_CR,           3,      "S[]",            "S[]",
+  { "chngets.s",    S(CHNGETARRAY),_CR,      3,      "S[]",            "S[]",
     (SUBR) chnget_array_opcode_init, (SUBR) notinit_opcode_stub, NULL },
-  { "chngetk.k",    S(CHNGET),_CR,           3,      "k[]",            "S[]",
+  { "chngetk.k",    S(CHNGETARRAY),_CR,      3,      "k[]",            "S[]",
     (SUBR) chnget_array_opcode_init, (SUBR) notinit_opcode_stub, NULL },
   { "chnget.a",    S(CHNGET),_CR,           3,      "a",            "S",
     (SUBR) chnget_opcode_init_a, (SUBR) notinit_opcode_stub },
@@ -1092,13 +1093,13 @@ OENTRY opcodlst_1[] = {
     NULL, (SUBR) chnget_opcode_perf_S, NULL},
   //{ "chnset",      0xFFFB,              _CW                               },
 
-  { "chnseti.i",    S(CHNGET),_CW,          1,      "",             "i[]S[]",
+  { "chnseti.i",    S(CHNGETARRAY),_CW,     1,      "",             "i[]S[]",
     (SUBR) chnset_array_opcode_init_i, NULL, NULL               },
-  { "chnsetk.k",    S(CHNGET),_CW,           3,      "",             "k[]S[]",
+  { "chnsetk.k",    S(CHNGETARRAY),_CW,      3,      "",             "k[]S[]",
     (SUBR) chnset_array_opcode_init, (SUBR) notinit_opcode_stub, NULL },
-  { "chnseta.a",    S(CHNGET),_CW,           3,      "",             "a[]S[]",
+  { "chnseta.a",    S(CHNGETARRAY),_CW,      3,      "",             "a[]S[]",
     (SUBR) chnset_array_opcode_init, (SUBR) notinit_opcode_stub, NULL },
-  { "chnsets.s",    S(CHNGET),_CW,           3,      "",             "S[]S[]",
+  { "chnsets.s",    S(CHNGETARRAY),_CW,      3,      "",             "S[]S[]",
     (SUBR) chnset_array_opcode_init, (SUBR) notinit_opcode_stub, NULL },
 
   { "chnset.i",    S(CHNGET),_CW,          1,      "",             "iS",
@@ -32,7 +32,9 @@
 #include "fgens.h"
 #include "pstream.h"
 #include "pvfileio.h"
+#include "interlocks.h"
 #include <stdlib.h>
+#include <sys/stat.h>
 /* #undef ISSTRCOD */
 
 
@@ -57,6 +59,9 @@ int isstrcod(MYFLT xx)
 
 extern double besseli(double);
 FUNC *csoundFTnp2Findint(CSOUND *csound, MYFLT *argp, int verbose);static int gen01raw(FGDATA *, FUNC *);
+static FUNC *gen01_defer_load(CSOUND *csound, int fno);
+static void generate_sine_tab(CSOUND *csound);
+static void ftdata_free(CSOUND *csound, MYFLT *data);
 static int gen01(FGDATA *, FUNC *), gen02(FGDATA *, FUNC *);
 static int gen03(FGDATA *, FUNC *), gen04(FGDATA *, FUNC *);
 static int gen05(FGDATA *, FUNC *), gen06(FGDATA *, FUNC *);
@@ -123,66 +128,449 @@ static inline unsigned int isPowerOfTwo (unsigned int x) {
   return (x > 0) && !(x & (x - 1)) ? 1 : 0;
 }
 
+/* Process-wide cache of generated tables (--ftable-cache).  An entry is
+   keyed on the f-statement from p3 on, the string argument, the file it
+   names (path, size and mtime) and the rates GEN01 depends on.  Every
+   FUNC built from it points at the same data, which is never written or
+   freed by an instance: replacing, deleting or resizing such a table
+   only drops the reference.  Entries are freed with the last reference.
+   An instance whose orchestra has an opcode flagged TW, or whose host
+   asks for a table pointer, gets private copies instead, so no write
+   reaches another instance. */
+
+#define FTCACHE_SIZE    (256)
+
+typedef struct ftcache_s {
+    struct ftcache_s *nxt;      /* chain by key  */
+    struct ftcache_s *dnxt;     /* chain by data */
+    uint32_t hash;
+    int     refs;
+    int     nargs;
+    MYFLT   *args;              /* p3 to p[pcnt] */
+    char    *strarg, *path;
+    MYFLT   sr, a4, dbfs;
+    int64_t fsize, mtime;
+    MYFLT   *data;
+    FUNC    hdr;
+} FTCACHE;
+
+extern void csoundLock(void);
+extern void csoundUnLock(void);
+
+static FTCACHE *ftcache_keys[FTCACHE_SIZE];
+static FTCACHE *ftcache_data[FTCACHE_SIZE];
+
+static inline uint32_t ftcache_hash(uint32_t h, const void *p, size_t n)
+{
+    const unsigned char *c = (const unsigned char*) p;
+    while (n--)
+      h = (h ^ *c++) * 16777619U;       /* FNV-1a */
+    return h;
+}
+
+static inline int ftcache_dslot(const MYFLT *data)
+{
+    return (int) (((uintptr_t) data >> 4) % FTCACHE_SIZE);
+}
+
+/* GENs that read nothing but their arguments and possibly a file;
+   those that use other tables or random numbers are not shared */
+static int ftcache_gen_ok(int32 genum)
+{
+    switch (genum) {
+    case 1: case 2: case 3: case 5: case 6: case 7: case 8: case 9:
+    case 10: case 11: case 12: case 13: case 14: case 16: case 17:
+    case 19: case 20: case 23: case 25: case 27: case 28: case 43: case 49:
+      return 1;
+    }
+    return 0;
+}
+
+/* fill in key from the event; returns 0 if the table cannot be shared */
+static int ftcache_key(const FGDATA *ff, int32 genum, FTCACHE *key,
+                       char *path, size_t pathlen)
+{
+    CSOUND  *csound = ff->csound;
+    char    name[512];
+    uint32_t h = 2166136261U;
+
+    memset(key, 0, sizeof(FTCACHE));
+    if (!ftcache_gen_ok(genum) || ff->e.pcnt > PMAX ||
+        (genum == 1 && csound->oparms->gen01defer))
+      return 0;
+    key->nargs = ff->e.pcnt - 2;
+    key->args = (MYFLT*) &(ff->e.p[3]);
+    key->strarg = ff->e.strarg;
+    key->sr = csound->esr;
+    key->a4 = csound->A4;
+    key->dbfs = csound->e0dbfs;
+    if (genum == 1 || genum == 23 || genum == 28 ||
+        genum == 43 || genum == 49) {
+      struct stat st;
+      int32 filno = (int32) MYFLT2LRND(ff->e.p[5]);
+      if (isstrcod(ff->e.p[5]) && ff->e.strarg != NULL) {
+        if (ff->e.strarg[0] == '"') {
+          int len = (int) strlen(ff->e.strarg) - 2;
+          strNcpy(name, ff->e.strarg + 1, 512);
+          if (len >= 0 && name[len] == '"')
+            name[len] = '\0';
+        }
+        else
+          strNcpy(name, ff->e.strarg, 512);
+      }
+      else if (genum != 1)
+        return 0;
+      else if (filno >= 0 && filno <= csound->strsmax &&
+               csound->strsets && csound->strsets[filno])
+        strNcpy(name, csound->strsets[filno], 512);
+      else
+        snprintf(name, 512, "soundin.%d", filno);
+      {
+        char *fullname = csoundFindInputFile(csound, name, "SFDIR;SSDIR;INCDIR");
+        if (fullname == NULL)
+          return 0;             /* let the GEN report it */
+        strNcpy(path, fullname, pathlen);
+        csound->Free(csound, fullname);
+      }
+      if (stat(path, &st) != 0)
+        return 0;
+      key->path = path;
+      key->fsize = (int64_t) st.st_size;
+      key->mtime = (int64_t) st.st_mtime;
+      h = ftcache_hash(h, key->path, strlen(key->path));
+      h = ftcache_hash(h, &key->fsize, sizeof(int64_t));
+      h = ftcache_hash(h, &key->mtime, sizeof(int64_t));
+    }
+    h = ftcache_hash(h, key->args, sizeof(MYFLT) * key->nargs);
+    if (key->strarg != NULL)
+      h = ftcache_hash(h, key->strarg, strlen(key->strarg));
+    h = ftcache_hash(h, &key->sr, sizeof(MYFLT));
+    h = ftcache_hash(h, &key->a4, sizeof(MYFLT));
+    h = ftcache_hash(h, &key->dbfs, sizeof(MYFLT));
+    key->hash = h;
+    return 1;
+}
+
+static inline int strsame(const char *a, const char *b)
+{
+    return (a == NULL || b == NULL) ? a == b : !strcmp(a, b);
+}
+
+/* find an entry matching key and take a reference; lock must be held */
+static FTCACHE *ftcache_find(const FTCACHE *key)
+{
+    FTCACHE *e = ftcache_keys[key->hash % FTCACHE_SIZE];
+
+    for ( ; e != NULL; e = e->nxt) {
+      if (e->hash == key->hash && e->nargs == key->nargs &&
+          e->sr == key->sr && e->a4 == key->a4 && e->dbfs == key->dbfs &&
+          e->fsize == key->fsize && e->mtime == key->mtime &&
+          !memcmp(e->args, key->args, sizeof(MYFLT) * key->nargs) &&
+          strsame(e->strarg, key->strarg) && strsame(e->path, key->path)) {
+        e->refs++;
+        return e;
+      }
+    }
+    return NULL;
+}
+
+/* lock must be held */
+static FTCACHE *ftcache_by_data(const MYFLT *data)
+{
+    FTCACHE *e;
+
+    if (data == NULL)
+      return NULL;
+    for (e = ftcache_data[ftcache_dslot(data)]; e != NULL; e = e->dnxt)
+      if (e->data == data)
+        return e;
+    return NULL;
+}
+
+static void ftcache_free(FTCACHE *e)
+{
+    FTCACHE **pp;
+
+    for (pp = &ftcache_keys[e->hash % FTCACHE_SIZE]; *pp != e; pp = &(*pp)->nxt)
+      ;
+    *pp = e->nxt;
+    for (pp = &ftcache_data[ftcache_dslot(e->data)]; *pp != e; pp = &(*pp)->dnxt)
+      ;
+    *pp = e->dnxt;
+    free(e->data);
+    free(e->args);
+    free(e->strarg);
+    free(e->path);
+    free(e);
+}
+
+/* drop the reference held through data; returns non-zero if data was
+   shared, in which case the caller must not write or free it */
+static int ftcache_release(const MYFLT *data)
+{
+    FTCACHE *e;
+
+    csoundLock();
+    if ((e = ftcache_by_data(data)) != NULL && --e->refs == 0)
+      ftcache_free(e);
+    csoundUnLock();
+    return (e != NULL);
+}
+
+static int ftcache_shared(const MYFLT *data)
+{
+    FTCACHE *e;
+
+    csoundLock();
+    e = ftcache_by_data(data);
+    csoundUnLock();
+    return (e != NULL);
+}
+
+/* give ftp a private copy of its data if it is shared */
+static void ftcache_detach(CSOUND *csound, FUNC *ftp)
+{
+    FTCACHE *e;
+    MYFLT   *tab;
+
+    csoundLock();
+    e = ftcache_by_data(ftp->ftable);
+    csoundUnLock();
+    if (e == NULL)
+      return;
+    tab = (MYFLT*) csound->Malloc(csound, sizeof(MYFLT) * (ftp->flen + 1));
+    memcpy(tab, ftp->ftable, sizeof(MYFLT) * (ftp->flen + 1));
+    ftdata_free(csound, ftp->ftable);
+    ftp->ftable = tab;
+}
+
+/* give every table of this instance private data */
+static void ftcache_detach_all(CSOUND *csound)
+{
+    int i;
+    for (i = 1; i <= csound->maxfnum; i++)
+      if (csound->flist[i] != NULL && csound->flist[i]->ftable != NULL)
+        ftcache_detach(csound, csound->flist[i]);
+}
+
+static int ftcache_reset(CSOUND *csound, void *userData)
+{
+    int i;
+    (void) userData;
+    for (i = 1; i <= csound->maxfnum; i++)
+      if (csound->flist[i] != NULL && ftcache_release(csound->flist[i]->ftable))
+        csound->flist[i]->ftable = NULL;
+    return 0;
+}
+
+/* release this instance's references when it is reset; the variable
+   is non-zero once the instance may write to its tables */
+static int *ftcache_register(CSOUND *csound)
+{
+    if (csound->CreateGlobalVariable(csound, "::ftcache", sizeof(int)) == 0)
+      csound->RegisterResetCallback(csound, NULL, ftcache_reset);
+    return (int*) csound->QueryGlobalVariableNoCheck(csound, "::ftcache");
+}
+
+static inline int ftcache_private(CSOUND *csound)
+{
+    int *w = (int*) csound->QueryGlobalVariable(csound, "::ftcache");
+    return (w != NULL && *w);
+}
+
 /**
- * Create ftable using evtblk data, and store pointer to new table in *ftpp.
- * If mode is zero, a zero table number is ignored, otherwise a new table
- * number is automatically assigned.
- * Returns zero on success.
+ * Called with each compiled orchestra before any of its code runs:
+ * if an instrument or UDO has an opcode that writes to tables, stop
+ * sharing tables with other instances and copy the shared ones.
  */
+void csoundFTUnshareWriters(CSOUND *csound, ENGINE_STATE *engineState)
+{
+    INSTRTXT *ip = &(engineState->instxtanchor);
+    OPTXT    *bp;
+    int      *w;
 
-int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
+    if (!csound->oparms->ftcache || ftcache_private(csound))
+      return;
+    while ((ip = ip->nxtinstxt) != NULL) {
+      for (bp = ip->nxtop; bp != NULL; bp = bp->nxtop)
+        if (bp->t.oentry != NULL && (bp->t.oentry->flags & TW))
+          break;
+      if (bp != NULL)
+        break;
+    }
+    if (ip == NULL)
+      return;
+    if (UNLIKELY(csound->oparms->msglevel & 7))
+      csound->Message(csound, Str("%s writes to tables: "
+                                  "ftable cache not used\n"),
+                      bp->t.oentry->opname);
+    if ((w = ftcache_register(csound)) != NULL)
+      *w = 1;
+    ftcache_detach_all(csound);
+}
+
+/**
+ * Gives ftp private data if it is shared, before the host writes to it.
+ */
+void csoundFTUnshare(CSOUND *csound, FUNC *ftp)
+{
+    if (csound->oparms->ftcache && ftp != NULL && ftp->ftable != NULL)
+      ftcache_detach(csound, ftp);
+}
+
+/* point table ff->fno at the data of entry e, whose reference it takes */
+static FUNC *ftcache_install(const FGDATA *ff, FTCACHE *e)
+{
+    CSOUND  *csound = ff->csound;
+    FUNC    *ftp = csound->flist[ff->fno];
+
+    ftcache_register(csound);
+    if (ftp == NULL)
+      csound->flist[ff->fno] = ftp = (FUNC*) csound->Calloc(csound, sizeof(FUNC));
+    else if (ftp->ftable == e->data) {
+      /* same table again, as after a recompile */
+      csoundLock();
+      e->refs--;
+      csoundUnLock();
+      return ftp;
+    }
+    else {
+      /* keep the FUNC in place, for instruments still using it */
+      csound->Warning(csound, Str("replacing previous ftable %d"), ff->fno);
+      ftdata_free(csound, ftp->ftable);
+    }
+    memcpy(ftp, &e->hdr, sizeof(FUNC));
+    ftp->ftable = e->data;
+    ftp->fno = (int32) ff->fno;
+    return ftp;
+}
+
+/* move the table just generated into the cache, or share an identical
+   one that another instance added in the meantime */
+static void ftcache_publish(CSOUND *csound, const FTCACHE *key, FUNC *ftp)
+{
+    FTCACHE *e, *old;
+    size_t  n = (size_t) ftp->flen + 1;
+
+    e = (FTCACHE*) calloc(1, sizeof(FTCACHE));
+    if (UNLIKELY(e == NULL))
+      return;                   /* just not shared */
+    e->data = (MYFLT*) malloc(sizeof(MYFLT) * n);
+    e->args = (MYFLT*) malloc(sizeof(MYFLT) * key->nargs);
+    if (UNLIKELY(e->data == NULL || e->args == NULL)) {
+      free(e->data); free(e->args); free(e);
+      return;
+    }
+    memcpy(e->data, ftp->ftable, sizeof(MYFLT) * n);
+    memcpy(e->args, key->args, sizeof(MYFLT) * key->nargs);
+    e->strarg = key->strarg != NULL ? strdup(key->strarg) : NULL;
+    e->path = key->path != NULL ? strdup(key->path) : NULL;
+    e->hash = key->hash;
+    e->nargs = key->nargs;
+    e->sr = key->sr;
+    e->a4 = key->a4;
+    e->dbfs = key->dbfs;
+    e->fsize = key->fsize;
+    e->mtime = key->mtime;
+    memcpy(&e->hdr, ftp, sizeof(FUNC));
+    e->hdr.ftable = NULL;
+    e->refs = 1;
+    csoundLock();
+    if ((old = ftcache_find(key)) == NULL) {
+      e->nxt = ftcache_keys[e->hash % FTCACHE_SIZE];
+      ftcache_keys[e->hash % FTCACHE_SIZE] = e;
+      e->dnxt = ftcache_data[ftcache_dslot(e->data)];
+      ftcache_data[ftcache_dslot(e->data)] = e;
+    }
+    csoundUnLock();
+    if (old != NULL) {
+      free(e->data); free(e->args); free(e->strarg); free(e->path); free(e);
+      e = old;
+    }
+    ftcache_register(csound);
+    csound->Free(csound, ftp->ftable);
+    ftp->ftable = e->data;
+}
+
+/* the slot a table being generated goes in: normally its flist entry,
+   but a table built on a worker thread is kept apart until published */
+
+static inline FUNC **ftslot(const FGDATA *ff)
+{
+    return ff->slot != NULL ? ff->slot : &(ff->csound->flist[ff->fno]);
+}
+
+/* extend flist to hold fno */
+
+static void flist_extend(CSOUND *csound, int fno)
+{
+    FUNC  **nn;
+    int   i, size;
+
+    for (size = csound->maxfnum; size < fno; size += MAXFNUM)
+      ;
+    nn = (FUNC**) csound->ReAlloc(csound,
+                                  csound->flist, (size + 1) * sizeof(FUNC*));
+    for (i = csound->maxfnum + 1; i <= size; i++)
+      nn[i] = NULL;                             /*  Clear new section       */
+    csound->flist = nn;
+    csound->maxfnum = size;
+}
+
+static int ftgen_pending(CSOUND *csound, int fno);
+static void ftgen_cancel(CSOUND *csound, int fno);
+
+/* decode the table number and GEN of an f event into ff; returns 0 if
+   there is a table to generate, 1 if not (fno 0 or a deletion) and -1
+   on error */
+
+static int ftgen_setup(CSOUND *csound, FGDATA *ffp, const EVTBLK *evtblkp,
+                       int mode, int32 *genump)
 {
-    int32    genum, ltest;
-    int     lobits, msg_enabled, i;
     FUNC    *ftp;
-    FGDATA  ff;
-    int nonpowof2_flag=0; /* gab: fixed for non-powoftwo function tables*/
+    int32   genum;
+    int     msg_enabled;
 
-    *ftpp = NULL;
     if (UNLIKELY(csound->gensub == NULL)) {
       csound->gensub = (GEN*) csound->Malloc(csound, sizeof(GEN) * (GENMAX + 1));
       memcpy(csound->gensub, or_sub, sizeof(GEN) * (GENMAX + 1));
       csound->genmax = GENMAX + 1;
     }
     msg_enabled = csound->oparms->msglevel & 7;
-    memset(&ff, '\0', sizeof(ff)); /* for Valgrind */
+    memset(ffp, '\0', sizeof(FGDATA)); /* for Valgrind */
+#define ff (*ffp)
     ff.csound = csound;
     memcpy((char*) &(ff.e), (char*) evtblkp,
            (size_t) ((char*) &(evtblkp->p[2]) - (char*) evtblkp));
     ff.fno = (int) MYFLT2LRND(ff.e.p[1]);
     if (!ff.fno) {
       if (!mode)
-        return 0;                               /*  fno = 0: return,        */
+        return 1;                               /*  fno = 0: return,        */
       ff.fno = FTAB_SEARCH_BASE;
       do {                                      /*      or automatic number */
         ++ff.fno;
-      } while (ff.fno <= csound->maxfnum && csound->flist[ff.fno] != NULL);
+      } while (ff.fno <= csound->maxfnum &&
+               (csound->flist[ff.fno] != NULL || ftgen_pending(csound, ff.fno)));
       ff.e.p[1] = (MYFLT) (ff.fno);
     }
     else if (ff.fno < 0) {                      /*  fno < 0: remove         */
       ff.fno = -(ff.fno);
+      ftgen_cancel(csound, ff.fno);
       if (UNLIKELY(ff.fno > csound->maxfnum ||
                    (ftp = csound->flist[ff.fno]) == NULL)) {
         return fterror(&ff, Str("ftable does not exist"));
       }
       csound->flist[ff.fno] = NULL;
+      ftdata_free(csound, ftp->ftable);
       csound->Free(csound, (void*) ftp);
       if (UNLIKELY(msg_enabled))
         csoundMessage(csound, Str("ftable %d now deleted\n"), ff.fno);
-      return 0;
-    }
-    if (UNLIKELY(ff.fno > csound->maxfnum)) {   /* extend list if necessary */
-      FUNC  **nn;
-      int   size;
-      for (size = csound->maxfnum; size < ff.fno; size += MAXFNUM)
-        ;
-      nn = (FUNC**) csound->ReAlloc(csound,
-                                    csound->flist, (size + 1) * sizeof(FUNC*));
-      csound->flist = nn;
-      for (i = csound->maxfnum + 1; i <= size; i++)
-        csound->flist[i] = NULL;                /*  Clear new section       */
-      csound->maxfnum = size;
+      return 1;
     }
+    else
+      ftgen_cancel(csound, ff.fno);             /*  a later event wins      */
+    if (UNLIKELY(ff.fno > csound->maxfnum))     /* extend list if necessary */
+      flist_extend(csound, ff.fno);
     if (UNLIKELY(ff.e.pcnt <= 4)) {             /*  chk minimum arg count   */
       return fterror(&ff, Str("insufficient gen arguments"));
     }
@@ -223,6 +611,24 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
         return fterror(&ff, Str("illegal gen number"));
       }
     }
+#undef ff
+    *genump = genum;
+    return 0;
+}
+
+/* run the GEN for an event decoded by ftgen_setup(); the table is left
+   in ftslot(ff) and in *ftpp */
+
+static int ftgen_run(FGDATA *ffp, int32 genum, FUNC **ftpp)
+{
+    CSOUND  *csound = ffp->csound;
+    int32   ltest;
+    int     lobits, msg_enabled, i;
+    FUNC    *ftp;
+    int nonpowof2_flag=0; /* gab: fixed for non-powoftwo function tables*/
+
+    msg_enabled = csound->oparms->msglevel & 7;
+#define ff (*ffp)
     ff.flen = (int32) MYFLT2LRND(ff.e.p[3]);
     if (!ff.flen) {
       /* defer alloc to gen01|gen23|gen28 */
@@ -234,9 +640,11 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
       if (UNLIKELY(msg_enabled))
         csoundMessage(csound, Str("ftable %d:\n"), ff.fno);
       i = (*csound->gensub[genum])(&ff, NULL);
-      ftp = csound->flist[ff.fno];
+      ftp = *ftslot(&ff);
       if (i != 0) {
-        csound->flist[ff.fno] = NULL;
+        if (ftp != NULL)
+          ftcache_release(ftp->ftable);
+        *ftslot(&ff) = NULL;
         csound->Free(csound, ftp);
         return -1;
       }
@@ -288,7 +696,7 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
     if (UNLIKELY(msg_enabled))
       csoundMessage(csound, Str("ftable %d:\n"), ff.fno);
     if ((*csound->gensub[genum])(&ff, ftp) != 0) {
-      csound->flist[ff.fno] = NULL;
+      *ftslot(&ff) = NULL;
       csound->Free(csound, ftp);
       return -1;
     }
@@ -306,9 +714,438 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
       /*for (k=0; k < size; k++)
         csound->Message(csound, "%f\n", ftp->args[k]);*/
     }
+#undef ff
     return 0;
 }
 
+/**
+ * Create ftable using evtblk data, and store pointer to new table in *ftpp.
+ * If mode is zero, a zero table number is ignored, otherwise a new table
+ * number is automatically assigned.
+ * Returns zero on success.
+ */
+
+int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
+{
+    int32   genum;
+    int     i;
+    FGDATA  ff;
+    FTCACHE key;
+    char    keypath[1024];
+    int     shared = 0;
+
+    *ftpp = NULL;
+    if ((i = ftgen_setup(csound, &ff, evtblkp, mode, &genum)) != 0)
+      return (i < 0 ? -1 : 0);
+    if (csound->oparms->ftcache && !ftcache_private(csound) &&
+        (shared = ftcache_key(&ff, genum, &key, keypath, sizeof(keypath)))) {
+      FTCACHE *e;
+      csoundLock();
+      e = ftcache_find(&key);
+      csoundUnLock();
+      if (e != NULL) {
+        if (UNLIKELY(csound->oparms->msglevel & 7))
+          csoundMessage(csound, Str("ftable %d: shared\n"), ff.fno);
+        *ftpp = ftcache_install(&ff, e);
+        return 0;
+      }
+    }
+    if ((i = ftgen_run(&ff, genum, ftpp)) == 0 && shared)
+      ftcache_publish(csound, &key, *ftpp);
+    return i;
+}
+
+/* Asynchronous GENs.  hfgens_async() decodes the event and reserves the
+   table number on the calling thread, then runs the GEN on a thread of
+   its own, into a FUNC that is not yet in flist.  Finished tables are
+   published by ftgen_async_poll(), which sensevents() calls on the
+   performance thread at the start of each k-cycle, so opcodes never
+   see a half-built table or one that appears during a cycle.  A later
+   f event, ftgen or deletion of the same number cancels a pending one.
+   With --defer-gen1 the worker only records the GEN01 arguments, and
+   gen01_defer_load() reads the file on first use as before.
+
+   A GEN that reads other tables looks them up with ftsource(), which
+   on a worker returns the copy of the table header taken when the job
+   started.  Table data that is replaced, resized or deleted while jobs
+   are running is not freed or overwritten but retired, and freed once
+   every job that could have seen it is done.  The job list and the
+   retired list are guarded by the lock, since ftgen_ready() may be
+   called from any thread. */
+
+typedef struct ftgen_job_s {
+    FGDATA  ff;
+    int32   genum;
+    FUNC    *ftp;
+    FUNC    **srcs;             /* flist as it was when the job started */
+    void    *thread;
+    uint64_t stamp;
+    int     status, cancelled;
+    volatile long done;
+    struct ftgen_job_s *nxt;
+} FTGEN_JOB;
+
+typedef struct ftgen_retired_s {
+    MYFLT   *data;
+    uint64_t stamp;
+    struct ftgen_retired_s *nxt;
+} FTGEN_RETIRED;
+
+typedef struct {
+    void    *lock;
+    FTGEN_JOB *jobs;
+    FTGEN_RETIRED *retired;
+    uint64_t stamp;             /* jobs started so far */
+} FTGEN_ASYNC;
+
+/* lock must be held, if there is one */
+static int ftgen_pending_(FTGEN_ASYNC *a, int fno)
+{
+    FTGEN_JOB *j;
+    for (j = a->jobs; j != NULL; j = j->nxt)
+      if (j->ff.fno == fno && !j->cancelled)
+        return 1;
+    return 0;
+}
+
+static int ftgen_pending(CSOUND *csound, int fno)
+{
+    FTGEN_ASYNC *a = (FTGEN_ASYNC*) csound->ftgen_async;
+    int       n;
+
+    if (a == NULL)
+      return 0;
+    csound->LockMutex(a->lock);
+    n = ftgen_pending_(a, fno);
+    csound->UnlockMutex(a->lock);
+    return n;
+}
+
+static void ftgen_cancel(CSOUND *csound, int fno)
+{
+    FTGEN_ASYNC *a = (FTGEN_ASYNC*) csound->ftgen_async;
+    FTGEN_JOB *j;
+
+    if (a == NULL)
+      return;
+    csound->LockMutex(a->lock);
+    for (j = a->jobs; j != NULL; j = j->nxt)
+      if (j->ff.fno == fno)
+        j->cancelled = 1;
+    csound->UnlockMutex(a->lock);
+}
+
+/* non-zero while a GEN may be reading table data on another thread */
+static int ftgen_busy(CSOUND *csound)
+{
+    FTGEN_ASYNC *a = (FTGEN_ASYNC*) csound->ftgen_async;
+    int       n;
+
+    if (a == NULL)
+      return 0;
+    csound->LockMutex(a->lock);
+    n = (a->jobs != NULL);
+    csound->UnlockMutex(a->lock);
+    return n;
+}
+
+/* free table data that may be shared or read by an asynchronous GEN */
+static void ftdata_free(CSOUND *csound, MYFLT *data)
+{
+    FTGEN_ASYNC *a = (FTGEN_ASYNC*) csound->ftgen_async;
+
+    if (data == NULL)
+      return;
+    if (a != NULL) {
+      csound->LockMutex(a->lock);
+      if (a->jobs != NULL) {
+        FTGEN_RETIRED *r =
+          (FTGEN_RETIRED*) csound->Malloc(csound, sizeof(FTGEN_RETIRED));
+        r->data = data;
+        r->stamp = a->stamp;
+        r->nxt = a->retired;
+        a->retired = r;
+        csound->UnlockMutex(a->lock);
+        return;
+      }
+      csound->UnlockMutex(a->lock);
+    }
+    if (!ftcache_release(data))
+      csound->Free(csound, data);
+}
+
+/* give ftp data of its own that no GEN is reading, before writing to it */
+static void ftdata_own(CSOUND *csound, FUNC *ftp)
+{
+    MYFLT   *tab;
+
+    if (!ftgen_busy(csound)) {
+      ftcache_detach(csound, ftp);
+      return;
+    }
+    tab = (MYFLT*) csound->Malloc(csound, sizeof(MYFLT) * (ftp->flen + 1));
+    memcpy(tab, ftp->ftable, sizeof(MYFLT) * (ftp->flen + 1));
+    ftdata_free(csound, ftp->ftable);
+    ftp->ftable = tab;
+}
+
+/* table fno as the GEN in ff is to see it: on a worker, its header as
+   it was when the job started; NULL if there is no such table */
+static FUNC *ftsource(const FGDATA *ff, int fno)
+{
+    CSOUND  *csound = ff->csound;
+    FUNC    *ftp;
+
+    if (fno == -1) {            /* generated before any job starts */
+      if (UNLIKELY(csound->sinetable == NULL && ff->srcs == NULL))
+        generate_sine_tab(csound);
+      return csound->sinetable;
+    }
+    if (ff->srcs != NULL) {
+      if (fno <= 0 || fno > ff->nsrcs || (ftp = ff->srcs[fno]) == NULL ||
+          !ftp->flen)           /* a deferred GEN01 is not loaded here */
+        return NULL;
+      return ftp;
+    }
+    if (fno <= 0 || fno > csound->maxfnum ||
+        (ftp = csound->flist[fno]) == NULL)
+      return NULL;
+    if (!ftp->flen)
+      ftp = (csound->oparms->gen01defer ? gen01_defer_load(csound, fno) : NULL);
+    return ftp;
+}
+
+/* as csoundGetTable(), for a GEN reading table fno */
+static int ftsource_get(const FGDATA *ff, MYFLT **tablePtr, int fno)
+{
+    FUNC    *ftp = ftsource(ff, fno);
+
+    if (UNLIKELY(ftp == NULL)) {
+      *tablePtr = NULL;
+      return -1;
+    }
+    *tablePtr = ftp->ftable;
+    return (int) ftp->flen;
+}
+
+/* copy the table headers for the job; the data they point at stays
+   until the job is done */
+static void ftgen_snapshot(CSOUND *csound, FTGEN_JOB *j)
+{
+    FUNC    *f;
+    int     i, n = 0;
+
+    if (csound->sinetable == NULL)
+      generate_sine_tab(csound);
+    for (i = 1; i <= csound->maxfnum; i++)
+      if (csound->flist[i] != NULL)
+        n++;
+    j->srcs = (FUNC**) csound->Calloc(csound,
+                                      (csound->maxfnum + 1) * sizeof(FUNC*) +
+                                      n * sizeof(FUNC));
+    f = (FUNC*) (j->srcs + csound->maxfnum + 1);
+    for (i = 1; i <= csound->maxfnum; i++)
+      if (csound->flist[i] != NULL) {
+        memcpy(f, csound->flist[i], sizeof(FUNC));
+        j->srcs[i] = f++;
+      }
+    j->ff.srcs = j->srcs;
+    j->ff.nsrcs = csound->maxfnum;
+}
+
+static uintptr_t ftgen_thread(void *p)
+{
+    FTGEN_JOB *j = (FTGEN_JOB*) p;
+    FUNC      *ftp;
+
+    j->status = ftgen_run(&j->ff, j->genum, &ftp);
+    ATOMIC_SET(j->done, 1);
+    return 0;
+}
+
+static void ftgen_job_free(CSOUND *csound, FTGEN_JOB *j)
+{
+    if (j->ftp != NULL) {
+      csound->Free(csound, j->ftp->ftable);
+      csound->Free(csound, j->ftp);
+    }
+    if (j->ff.e.c.extra != NULL)
+      csound->Free(csound, j->ff.e.c.extra);
+    if (j->ff.e.strarg != NULL)
+      csound->Free(csound, j->ff.e.strarg);
+    if (j->srcs != NULL)
+      csound->Free(csound, j->srcs);
+    csound->Free(csound, j);
+}
+
+/* move a finished table into flist, keeping an existing FUNC in place
+   for instruments that hold a pointer to it */
+
+static void ftgen_publish(CSOUND *csound, FTGEN_JOB *j)
+{
+    FUNC  *ftp = j->ftp, *old = csound->flist[j->ff.fno];
+
+    if (old == NULL)
+      csound->flist[j->ff.fno] = ftp;
+    else {
+      csound->Warning(csound, Str("replacing previous ftable %d"), j->ff.fno);
+      ftdata_free(csound, old->ftable);
+      memcpy(old, ftp, sizeof(FUNC));
+      csound->Free(csound, ftp);
+    }
+    j->ftp = NULL;
+}
+
+/**
+ * Joins and publishes finished asynchronous GENs, and frees the table
+ * data no running GEN can still see.  Called by sensevents() on the
+ * performance thread between k-cycles.
+ */
+
+void ftgen_async_poll(CSOUND *csound)
+{
+    FTGEN_ASYNC *a = (FTGEN_ASYNC*) csound->ftgen_async;
+    FTGEN_JOB **jp, *j, *done = NULL;
+    FTGEN_RETIRED **rp, *r, *freed = NULL;
+    uint64_t  oldest;
+
+    csound->LockMutex(a->lock);
+    for (jp = &a->jobs; (j = *jp) != NULL; ) {
+      if (!ATOMIC_GET(j->done)) {
+        jp = &j->nxt;
+        continue;
+      }
+      *jp = j->nxt;
+      j->nxt = done;
+      done = j;
+    }
+    oldest = a->stamp + 1;
+    for (j = a->jobs; j != NULL; j = j->nxt)
+      if (j->stamp < oldest)
+        oldest = j->stamp;
+    for (rp = &a->retired; (r = *rp) != NULL; ) {
+      if (r->stamp >= oldest) { /* a running job may read it */
+        rp = &r->nxt;
+        continue;
+      }
+      *rp = r->nxt;
+      r->nxt = freed;
+      freed = r;
+    }
+    csound->UnlockMutex(a->lock);
+    while ((r = freed) != NULL) {
+      freed = r->nxt;
+      if (!ftcache_release(r->data))
+        csound->Free(csound, r->data);
+      csound->Free(csound, r);
+    }
+    while ((j = done) != NULL) {
+      done = j->nxt;
+      csound->JoinThread(j->thread);
+      if (j->status == 0 && !j->cancelled)
+        ftgen_publish(csound, j);
+      else if (j->status != 0)
+        csound->Warning(csound, Str("asynchronous GEN for ftable %d failed"),
+                        j->ff.fno);
+      ftgen_job_free(csound, j);
+    }
+}
+
+static int ftgen_async_reset(CSOUND *csound, void *userData)
+{
+    FTGEN_ASYNC *a = (FTGEN_ASYNC*) userData;
+    FTGEN_JOB *j;
+    FTGEN_RETIRED *r;
+
+    while ((j = a->jobs) != NULL) {
+      csound->JoinThread(j->thread);
+      a->jobs = j->nxt;
+      ftgen_job_free(csound, j);
+    }
+    while ((r = a->retired) != NULL) {
+      a->retired = r->nxt;
+      if (!ftcache_release(r->data))
+        csound->Free(csound, r->data);
+      csound->Free(csound, r);
+    }
+    csound->DestroyMutex(a->lock);
+    csound->Free(csound, a);
+    csound->ftgen_async = NULL;
+    return 0;
+}
+
+/**
+ * As hfgens(), but the GEN runs on a separate thread and the table
+ * only appears in flist once it is complete.  Returns the table number
+ * (zero if there is nothing to generate), or -1 on error.
+ */
+
+int hfgens_async(CSOUND *csound, const EVTBLK *evtblkp, int mode)
+{
+    FTGEN_ASYNC *a;
+    FTGEN_JOB *j;
+    FUNC      *ftp;
+    int       i;
+
+    j = (FTGEN_JOB*) csound->Calloc(csound, sizeof(FTGEN_JOB));
+    if ((i = ftgen_setup(csound, &j->ff, evtblkp, mode, &j->genum)) != 0) {
+      if (j->ff.e.c.extra != NULL)
+        csound->Free(csound, j->ff.e.c.extra);
+      csound->Free(csound, j);
+      return (i < 0 ? -1 : 0);
+    }
+    if (j->genum > GENMAX) {
+      /* a named GEN may look tables up through the API, which only
+         works on this thread */
+      j->ff.slot = NULL;
+      i = ftgen_run(&j->ff, j->genum, &ftp);
+      j->ff.e.strarg = NULL;
+      ftgen_job_free(csound, j);
+      return (i != 0 ? -1 : (int) ftp->fno);
+    }
+    if (j->ff.e.strarg != NULL)        /* the caller's string may not last */
+      j->ff.e.strarg = csound->Strdup(csound, j->ff.e.strarg);
+    j->ff.slot = &j->ftp;
+    if ((a = (FTGEN_ASYNC*) csound->ftgen_async) == NULL) {
+      a = (FTGEN_ASYNC*) csound->Calloc(csound, sizeof(FTGEN_ASYNC));
+      a->lock = csound->Create_Mutex(0);
+      csound->RegisterResetCallback(csound, (void*) a, ftgen_async_reset);
+      csound->ftgen_async = (void*) a;
+    }
+    ftgen_snapshot(csound, j);
+    csound->LockMutex(a->lock);
+    j->stamp = ++a->stamp;
+    j->nxt = a->jobs;
+    a->jobs = j;
+    j->thread = csound->CreateThread(ftgen_thread, (void*) j);
+    if (UNLIKELY(j->thread == NULL))
+      a->jobs = j->nxt;
+    csound->UnlockMutex(a->lock);
+    if (UNLIKELY(j->thread == NULL)) {
+      i = j->ff.fno;
+      ftgen_job_free(csound, j);
+      csound->ErrorMsg(csound, Str("ftable %d: could not start GEN thread"), i);
+      return -1;
+    }
+    return j->ff.fno;
+}
+
+/**
+ * Returns 1 if table tableNum exists and is complete, 0 while an
+ * asynchronous GEN for it is still running or not yet published, and
+ * -1 otherwise.  Changes nothing, so it is safe from any thread.
+ */
+
+int ftgen_ready(CSOUND *csound, int tableNum)
+{
+    if (ftgen_pending(csound, tableNum))
+      return 0;
+    if (tableNum <= 0 || tableNum > csound->maxfnum ||
+        csound->flist[tableNum] == NULL)
+      return -1;
+    return 1;
+}
+
 /**
  * Allocates space for 'tableNum' with a length (not including the guard
  * point) of 'len' samples. The table data is not cleared to zero.
@@ -318,20 +1155,13 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
 int csoundFTAlloc(CSOUND *csound, int tableNum, int len)
 {
     int   i, size;
-    FUNC  **nn, *ftp;
+    FUNC  *ftp;
 
     if (UNLIKELY(tableNum <= 0 || len <= 0 || len > (int) MAXLEN))
       return -1;
-    if (UNLIKELY(tableNum > csound->maxfnum)) { /* extend list if necessary     */
-      for (size = csound->maxfnum; size < tableNum; size += MAXFNUM)
-        ;
-      nn = (FUNC**) csound->ReAlloc(csound,
-                                    csound->flist, (size + 1) * sizeof(FUNC*));
-      csound->flist = nn;
-      for (i = csound->maxfnum + 1; i <= size; i++)
-        csound->flist[i] = NULL;            /* Clear new section            */
-      csound->maxfnum = size;
-    }
+    ftgen_cancel(csound, tableNum);
+    if (UNLIKELY(tableNum > csound->maxfnum))   /* extend list if necessary */
+      flist_extend(csound, tableNum);
     /* allocate space for table */
     size = (int) (len * (int) sizeof(MYFLT));
     ftp = csound->flist[tableNum];
@@ -341,6 +1171,7 @@ int csoundFTAlloc(CSOUND *csound, int tableNum, int len)
         (MYFLT*)csound->Malloc(csound, sizeof(MYFLT)*(len+1));
     }
     else if (len != (int) ftp->flen) {
+      ftdata_free(csound, ftp->ftable);
       if (UNLIKELY(csound->actanchor.nxtact != NULL)) { /*   & chk for danger    */
         /* return */  /* VL: changed this into a Warning */
           csound->Warning(csound, Str("ftable %d relocating due to size change"
@@ -349,8 +1180,12 @@ int csoundFTAlloc(CSOUND *csound, int tableNum, int len)
       }
       csound->flist[tableNum] = NULL;
       csound->Free(csound, ftp);
-      csound->flist[tableNum] = (FUNC*) csound->Malloc(csound, (size_t) size);
+      csound->flist[tableNum] = (FUNC*) csound->Malloc(csound, sizeof(FUNC));
+      csound->flist[tableNum]->ftable = (MYFLT*) csound->Malloc(csound,
+                                                       (size_t) size + sizeof(MYFLT));
     }
+    else
+      ftdata_own(csound, ftp);          /* caller will write to it */
     /* initialise table header */
     ftp = csound->flist[tableNum];
     //memset((void*) ftp, 0, (size_t) ((char*) &(ftp->ftable) - (char*) ftp));
@@ -382,10 +1217,12 @@ int csoundFTDelete(CSOUND *csound, int tableNum)
 
     if (UNLIKELY((unsigned int) (tableNum - 1) >= (unsigned int) csound->maxfnum))
       return -1;
+    ftgen_cancel(csound, tableNum);
     ftp = csound->flist[tableNum];
     if (UNLIKELY(ftp == NULL))
       return -1;
     csound->flist[tableNum] = NULL;
+    ftdata_free(csound, ftp->ftable);
     csound->Free(csound, ftp);
 
     return 0;
@@ -456,18 +1293,16 @@ static int gen03(FGDATA *ff, FUNC *ftp)
 
 static int gen04(FGDATA *ff, FUNC *ftp)
 {
-    CSOUND  *csound = ff->csound;
     MYFLT   *valp, *rvalp, *fp = ftp->ftable;
     int     n, r;
     FUNC    *srcftp;
     MYFLT   val, max, maxinv;
-    int     srcno, srcpts, ptratio;
+    int     srcpts, ptratio;
 
     if (UNLIKELY(ff->e.pcnt < 6)) {
       return fterror(ff, Str("insufficient arguments"));
     }
-    if (UNLIKELY((srcno = (int)ff->e.p[5]) <= 0 || srcno > csound->maxfnum ||
-                 (srcftp = csound->flist[srcno]) == NULL)) {
+    if (UNLIKELY((srcftp = ftsource(ff, (int) ff->e.p[5])) == NULL)) {
       return fterror(ff, Str("unknown srctable number"));
     }
     if (!ff->e.p[6]) {
@@ -1180,7 +2015,7 @@ static int gen18(FGDATA *ff, FUNC *ftp)
         return fterror(ff, Str("a range given exceeds table length"));
       }
 
-      if (LIKELY((fnp=csoundFTFind(csound,&fn))!=NULL)) { /* make sure fn exists */
+      if (LIKELY((fnp=ftsource(ff,(int)fn))!=NULL)) { /* make sure fn exists */
         fp = fnp->ftable, fnlen = fnp->flen-1;        /* and set it up */
       }
       else {
@@ -1433,19 +2268,16 @@ static int gen23(FGDATA *ff, FUNC *ftp)
 
 static int gen24(FGDATA *ff, FUNC *ftp)
 {
-    CSOUND  *csound = ff->csound;
     MYFLT   *fp = ftp->ftable, *fp_source;
     FUNC    *srcftp;
-    int     srcno, srcpts, j;
+    int     srcpts, j;
     MYFLT   max, min, new_max, new_min, source_amp, target_amp, amp_ratio;
     int     nargs = ff->e.pcnt - 4;
 
     if (UNLIKELY(nargs < 3)) {
       return fterror(ff, Str("insufficient arguments"));
     }
-    if (UNLIKELY((srcno = (int) ff->e.p[5]) <= 0 ||
-        srcno > csound->maxfnum         ||
-                 (srcftp = csound->flist[srcno]) == NULL)) {
+    if (UNLIKELY((srcftp = ftsource(ff, (int) ff->e.p[5])) == NULL)) {
       return fterror(ff, Str("unknown srctable number"));
     }
     fp_source = srcftp->ftable;
@@ -1706,7 +2538,7 @@ static int gen30(FGDATA *ff, FUNC *ftp)
     xsr = FL(1.0);
     if ((nargs > 3) && (ff->e.p[8] > FL(0.0)))
       xsr = csound->esr / ff->e.p[8];
-    l2 = csoundGetTable(csound, &f2, (int) ff->e.p[5]);
+    l2 = ftsource_get(ff, &f2, (int) ff->e.p[5]);
     if (UNLIKELY(l2 < 0)) {
       return fterror(ff, Str("GEN30: source ftable not found"));
     }
@@ -1789,7 +2621,7 @@ static int gen31(FGDATA *ff, FUNC *ftp)
     if (UNLIKELY(nargs < 4)) {
       return fterror(ff, Str("insufficient gen arguments"));
     }
-    l2 = csoundGetTable(csound, &f2, (int) ff->e.p[5]);
+    l2 = ftsource_get(ff, &f2, (int) ff->e.p[5]);
     if (UNLIKELY(l2 < 0)) {
       return fterror(ff, Str("GEN31: source ftable not found"));
     }
@@ -1902,7 +2734,7 @@ static int gen32(FGDATA *ff, FUNC *ftp)
     while (++j < ntabl) {
       p = paccess(ff,pnum[j]);                /* table number */
       i = (int) MYFLT2LRND(p);
-      l2 = csoundGetTable(csound, &f2, abs(i));
+      l2 = ftsource_get(ff, &f2, abs(i));
       if (UNLIKELY(l2 < 0)) {
         fterror(ff, Str("GEN32: source ftable %d not found"), abs(i));
         if (x != NULL) csound->Free(csound,x);
@@ -1997,7 +2829,7 @@ static int gen33(FGDATA *ff, FUNC *ftp)
     /* table length and data */
     ft = ftp->ftable; flen = (int) ftp->flen;
     /* source table */
-    srclen = csoundGetTable(csound, &srcft, (int) ff->e.p[5]);
+    srclen = ftsource_get(ff, &srcft, (int) ff->e.p[5]);
     if (UNLIKELY(srclen < 0)) {
       return fterror(ff, Str("GEN33: source ftable not found"));
     }
@@ -2078,8 +2910,8 @@ static int gen34(FGDATA *ff, FUNC *ftp)
     /* table length and data */
     ft = ftp->ftable; flen = (int32) ftp->flen;
     /* source table */
-    if (UNLIKELY((src = csoundFTnp2Findint(csound, &(ff->e.p[5]), 1)) == NULL))
-      return NOTOK;
+    if (UNLIKELY((src = ftsource(ff, (int) MYFLT2LONG(ff->e.p[5]))) == NULL))
+      return fterror(ff, Str("Invalid ftable no. %f"), ff->e.p[5]);
     srcft = src->ftable; srclen = (int32) src->flen;
     /* number of partials */
     nh = (int32) (ff->e.p[6] + FL(0.5));
@@ -2162,12 +2994,10 @@ static int gen40(FGDATA *ff, FUNC *ftp)               /*gab d5*/
     CSOUND  *csound = ff->csound;
     MYFLT   *fp = ftp->ftable, *fp_source, *fp_temp;
     FUNC    *srcftp;
-    int     srcno, srcpts, j, k;
+    int     srcpts, j, k;
     MYFLT   last_value = FL(0.0), lenratio;
 
-    if (UNLIKELY((srcno = (int) ff->e.p[5]) <= 0 ||
-                 srcno > csound->maxfnum         ||
-                 (srcftp = csound->flist[srcno]) == NULL)) {
+    if (UNLIKELY((srcftp = ftsource(ff, (int) ff->e.p[5])) == NULL)) {
       return fterror(ff, Str("unknown source table number"));
     }
     fp_source = srcftp->ftable;
@@ -2353,14 +3183,22 @@ static void generate_sine_tab(CSOUND *csound)
 static CS_NOINLINE FUNC *ftalloc(const FGDATA *ff)
 {
     CSOUND  *csound = ff->csound;
-    FUNC    *ftp = csound->flist[ff->fno];
+    FUNC    **slot = ftslot(ff);
+    FUNC    *ftp = *slot;
 
     if (UNLIKELY(ftp != NULL)) {
       csound->Warning(csound, Str("replacing previous ftable %d"), ff->fno);
-      if (ff->flen != (int32)ftp->flen) {       /* if redraw & diff len, */
+      if (ftcache_shared(ftp->ftable) || ftgen_busy(csound)) {
+        /* shared, or a GEN may be reading it: get new space */
+        ftdata_free(csound, ftp->ftable);
+        memset((void*) ftp, 0, sizeof(FUNC));
+        ftp->ftable =
+          (MYFLT*) csound->Calloc(csound, (1+ff->flen) * sizeof(MYFLT));
+      }
+      else if (ff->flen != (int32)ftp->flen) {  /* if redraw & diff len, */
         csound->Free(csound, ftp->ftable);
         csound->Free(csound, (void*) ftp);             /*   release old space   */
-        csound->flist[ff->fno] = ftp = NULL;
+        *slot = ftp = NULL;
         if (UNLIKELY(csound->actanchor.nxtact != NULL)) { /*   & chk for danger */
           csound->Warning(csound, Str("ftable %d relocating due to size change"
                                       "\n         currently active instruments "
@@ -2376,7 +3214,7 @@ static CS_NOINLINE FUNC *ftalloc(const FGDATA *ff)
       }
     }
     if (ftp == NULL) {                      /*   alloc space as reqd */
-      csound->flist[ff->fno] = ftp = (FUNC*) csound->Calloc(csound, sizeof(FUNC));
+      *slot = ftp = (FUNC*) csound->Calloc(csound, sizeof(FUNC));
       ftp->ftable = (MYFLT*) csound->Calloc(csound, (1+ff->flen) * sizeof(MYFLT));
     }
     ftp->fno = (int32) ff->fno;
@@ -2443,7 +3281,6 @@ FUNC *csoundFTFind2(CSOUND *csound, MYFLT *argp)
     return ftp;
 }
 
-static FUNC *gen01_defer_load(CSOUND *csound, int fno);
 PUBLIC int csoundGetTable(CSOUND *csound, MYFLT **tablePtr, int tableNum)
 {
     FUNC    *ftp;
@@ -2458,6 +3295,8 @@ PUBLIC int csoundGetTable(CSOUND *csound, MYFLT **tablePtr, int tableNum)
       if (UNLIKELY(ftp == NULL))
         goto err_return;
     }
+    /* the caller may write through the pointer */
+    csoundFTUnshare(csound, ftp);
     *tablePtr = ftp->ftable;
     return (int) ftp->flen;
  err_return:
@@ -3140,9 +3979,9 @@ static int gen52(FGDATA *ff, FUNC *ftp)
       MYFLT *pp;
       if (LIKELY((n * 3) + 6<PMAX-1)) pp = &(ff->e.p[(n * 3) + 6]);
       else pp = &(ff->e.c.extra[(n * 3) + 6-PMAX]);
-      f = csoundFTFind(csound, pp);
+      f = ftsource(ff, (int) MYFLT2LONG(*pp));
       if (UNLIKELY(f == NULL))
-        return NOTOK;
+        return fterror(ff, Str("Invalid ftable no. %f"), *pp);
       len2 = (int) f->flen;
       src = f->ftable;
       i = n;
@@ -3302,7 +4141,7 @@ static int gen53(FGDATA *ff, FUNC *ftp)
     if (UNLIKELY(dstflen < 8 || (dstflen & (dstflen - 1)))) {
       return fterror(ff, Str("GEN53: invalid table length"));
     }
-    srcflen = csoundGetTable(csound, &srcftp, srcftno);
+    srcflen = ftsource_get(ff, &srcftp, srcftno);
     if (UNLIKELY(srcflen < 0)) {
       return fterror(ff, Str("GEN53: invalid source table number"));
     }
@@ -3314,7 +4153,7 @@ static int gen53(FGDATA *ff, FUNC *ftp)
       return fterror(ff, Str("GEN53: invalid source table length:"));
     }
     if (winftno) {
-      winflen = csoundGetTable(csound, &winftp, winftno);
+      winflen = ftsource_get(ff, &winftp, winftno);
       if (UNLIKELY(winflen <= 0 || (winflen & (winflen - 1)))) {
         return fterror(ff, Str("GEN53: invalid window table"));
       }
@@ -3412,9 +4251,14 @@ int resize_table(CSOUND *csound, RESIZE *p)
     }
     if (UNLIKELY((ftp = csound->FTFind(csound, p->fn)) == NULL))
       return NOTOK;
-    if (ftp->flen<fsize)
-      ftp->ftable = (MYFLT *) csound->ReAlloc(csound, ftp->ftable,
-                                              sizeof(MYFLT)*(fsize+1));
+    if (ftp->flen<fsize) {
+      MYFLT *tab = (MYFLT *) csound->Calloc(csound, sizeof(MYFLT)*(fsize+1));
+      memcpy(tab, ftp->ftable, sizeof(MYFLT)*ftp->flen);
+      ftdata_free(csound, ftp->ftable);
+      ftp->ftable = tab;
+    }
+    else
+      ftdata_own(csound, ftp);
     ftp->flen = fsize+1;
     csound->flist[fno] = ftp;
     return OK;
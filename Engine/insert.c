@@ -940,6 +940,7 @@ static void deact(CSOUND *csound, INSDS *ip)
   }
   if (ip->fdchp != NULL)
     fdchclose(csound, ip);
+  INSDS_PRIV_OF(ip)->dag_task = -1;  /* leaves the DAG at the next update */
   csound->dag_changed++;
 }
 
@@ -1046,7 +1047,7 @@ void orcompact(CSOUND *csound)          /* free all inactive instr spaces */
       prvip = NULL;
       prvnxtloc = &txtp->instance;
       do {
-        if (!ip->actflg) {
+        if (!ip->actflg && !INSDS_PRIV_OF(ip)->pooled) {
           cnt++;
           if (ip->opcod_iobufs && ip->insno > csound->engineState.maxinsno)
             csound->Free(csound, ip->opcod_iobufs);   /* IV - Nov 10 2002 */
@@ -1058,7 +1059,7 @@ void orcompact(CSOUND *csound)          /* free all inactive instr spaces */
           if ((nxtip = ip->nxtinstance) != NULL)
             nxtip->prvinstance = prvip;
           *prvnxtloc = nxtip;
-          csound->Free(csound, (char *)ip);
+          csound->Free(csound, INSDS_BASE(ip));
         }
         else {
           prvip = ip;
@@ -1078,6 +1079,12 @@ void orcompact(CSOUND *csound)          /* free all inactive instr spaces */
     }
 
     txtp->act_instance = NULL;                /* no free instances */
+    /* but preallocated voices, which are kept for reuse */
+    for (ip = txtp->lst_instance; ip != NULL; ip = ip->prvinstance)
+      if (INSDS_PRIV_OF(ip)->pooled && !ip->actflg) {
+        ip->nxtact = txtp->act_instance;
+        txtp->act_instance = ip;
+      }
   }
   /* check current items in deadpool to see if they need deleting */
   {
@@ -2338,14 +2345,47 @@ int findLabelMemOffset(CSOUND* csound, INSTRTXT* ip, char* labelName) {
 /* create instance of an instr template */
 /*   allocates and sets up all pntrs    */
 
+/* Bytes needed for an instance of tp; the p-fields and INSDS come first */
+static size_t instance_size(CSOUND *csound, INSTRTXT *tp, int *ppextent)
+{
+  OPARMS    *O = csound->oparms;
+  int       i, n, pextent, pextra, pextrab;
+
+  n = 3;
+  if (O->midiKey>n) n = O->midiKey;
+  if (O->midiKeyCps>n) n = O->midiKeyCps;
+  if (O->midiKeyOct>n) n = O->midiKeyOct;
+  if (O->midiKeyPch>n) n = O->midiKeyPch;
+  if (O->midiVelocity>n) n = O->midiVelocity;
+  if (O->midiVelocityAmp>n) n = O->midiVelocityAmp;
+  pextra = n-3;
+  pextrab = ((i = tp->pmax - 3L) > 0 ? (int) i * sizeof(CS_VAR_MEM) : 0);
+  pextent = sizeof(INSDS) + pextrab + pextra*sizeof(CS_VAR_MEM);
+  if (ppextent != NULL) *ppextent = pextent;
+  return (size_t) pextent + tp->varPool->poolSize +
+    (tp->varPool->varCount * CS_FLOAT_ALIGN(CS_VAR_TYPE_OFFSET)) +
+    (tp->varPool->varCount * sizeof(CS_VARIABLE*)) +
+    tp->opdstot;
+}
+
+static INSDS *instance_(CSOUND *csound, int insno, void *mem);
+
 static void instance(CSOUND *csound, int insno)
+{
+  (void) instance_(csound, insno, NULL);
+}
+
+/* Set up a new instance in mem, which must be zeroed and hold
+   INSDS_PRIV_SIZE + instance_size() bytes, or in new space */
+static INSDS *instance_(CSOUND *csound, int insno, void *mem)
 {
   INSTRTXT  *tp;
   INSDS     *ip;
   OPTXT     *optxt;
   OPDS      *opds, *prvids, *prvpds;
   const OENTRY  *ep;
-  int       i, n, pextent, pextra, pextrab;
+  int       n, pextent;
+  size_t    size;
   char      *nxtopds, *opdslim;
   MYFLT     **argpp, *lclbas;
   CS_VAR_MEM *lcloffbas; // start of pfields
@@ -2358,24 +2398,11 @@ static void instance(CSOUND *csound, int insno)
   CS_VARIABLE* current;
 
   tp = csound->engineState.instrtxtp[insno];
-  n = 3;
-  if (O->midiKey>n) n = O->midiKey;
-  if (O->midiKeyCps>n) n = O->midiKeyCps;
-  if (O->midiKeyOct>n) n = O->midiKeyOct;
-  if (O->midiKeyPch>n) n = O->midiKeyPch;
-  if (O->midiVelocity>n) n = O->midiVelocity;
-  if (O->midiVelocityAmp>n) n = O->midiVelocityAmp;
-  pextra = n-3;
-  pextrab = ((i = tp->pmax - 3L) > 0 ? (int) i * sizeof(CS_VAR_MEM) : 0);
+  size = instance_size(csound, tp, &pextent);
   /* alloc new space,  */
-  pextent = sizeof(INSDS) + pextrab + pextra*sizeof(CS_VAR_MEM);
-  ip =
-    (INSDS*) csound->Calloc(csound,
-                            (size_t) pextent + tp->varPool->poolSize +
-                            (tp->varPool->varCount *
-                             CS_FLOAT_ALIGN(CS_VAR_TYPE_OFFSET)) +
-                            (tp->varPool->varCount * sizeof(CS_VARIABLE*)) +
-                            tp->opdstot);
+  if (mem == NULL)
+    mem = csound->Calloc(csound, INSDS_PRIV_SIZE + size);
+  ip = (INSDS*) ((char*) mem + INSDS_PRIV_SIZE);
   ip->csound = csound;
   ip->m_chnbp = (MCHNBLK*) NULL;
   ip->instr = tp;
@@ -2390,6 +2417,7 @@ static void instance(CSOUND *csound, int insno)
   ip->nxtact = tp->act_instance;
   tp->act_instance = ip;
   ip->insno = insno;
+  INSDS_PRIV_OF(ip)->dag_task = -1;
   if (UNLIKELY(csound->oparms->odebug))
     csoundMessage(csound,"instance(): tp->act_instance = %p\n",
                   tp->act_instance);
@@ -2565,7 +2593,66 @@ static void instance(CSOUND *csound, int insno)
 
   if (UNLIKELY(nxtopds > opdslim))
     csoundDie(csound, Str("inconsistent opds total"));
+  return ip;
+}
+
+/* A slab of preallocated instances of one instrument.  The instances
+   stay in it when inactive, and orcompact() does not return them, so a
+   note-on finds a free voice without calling the allocator. */
+typedef struct instpool {
+  struct instpool *nxt;
+  int       count;
+} INSTPOOL;
 
+#define INSTPOOL_HDR  ((sizeof(INSTPOOL) + 15) & ~((size_t) 15))
+
+static void instance_pool(CSOUND *csound, int insno, int count)
+{
+  INSTRTXT  *tp = csound->engineState.instrtxtp[insno];
+  size_t    stride = (INSDS_PRIV_SIZE + instance_size(csound, tp, NULL) + 15) &
+                     ~((size_t) 15);
+  INSTPOOL  *pool;
+  char      *mem;
+  int       i;
+
+  if (count <= 0) return;
+  pool = (INSTPOOL*) csound->Calloc(csound, INSTPOOL_HDR + stride * count);
+  pool->count = count;
+  pool->nxt = (INSTPOOL*) tp->pool;
+  tp->pool = (void*) pool;
+  tp->pool_size += count;
+  tp->isNew = 0;                /* these are built from this definition */
+  mem = (char*) pool + INSTPOOL_HDR;
+  for (i = 0; i < count; i++, mem += stride)
+    INSDS_PRIV_OF(instance_(csound, insno, mem))->pooled = 1;
+}
+
+/* Release the slabs once none of their instances is linked anywhere */
+void free_instr_pool(CSOUND *csound, INSTRTXT *tp)
+{
+  INSTPOOL  *pool = (INSTPOOL*) tp->pool, *nxt;
+  while (pool != NULL) {
+    nxt = pool->nxt;
+    csound->Free(csound, pool);
+    pool = nxt;
+  }
+  tp->pool = NULL;
+  tp->pool_size = 0;
+}
+
+/* Keep at least count instances of instrument insno in a slab */
+int csoundPreallocInstrInternal(CSOUND *csound, int insno, int count)
+{
+  INSTRTXT  *tp;
+  if (UNLIKELY(insno < 1 || insno > csound->engineState.maxinsno ||
+               (tp = csound->engineState.instrtxtp[insno]) == NULL))
+    return CSOUND_ERROR;
+  if (csound->oparms->realtime)
+    csoundSpinLock(&csound->alloc_spinlock);
+  instance_pool(csound, insno, count - tp->pool_size);
+  if (csound->oparms->realtime)
+    csoundSpinUnLock(&csound->alloc_spinlock);
+  return CSOUND_SUCCESS;
 }
 
 int prealloc_(CSOUND *csound, AOP *p, int instname)
@@ -2585,9 +2672,8 @@ int prealloc_(CSOUND *csound, AOP *p, int instname)
     if (UNLIKELY(n == NOT_AN_INSTRUMENT)) return NOTOK;
     if (csound->oparms->realtime)
       csoundSpinLock(&csound->alloc_spinlock);
-    a = (int) *p->a - csound->engineState.instrtxtp[n]->active;
-    for ( ; a > 0; a--)
-      instance(csound, n);
+    a = (int) *p->a - csound->engineState.instrtxtp[n]->pool_size;
+    instance_pool(csound, n, a);
     if (csound->oparms->realtime)
       csoundSpinUnLock(&csound->alloc_spinlock);
     return OK;
@@ -2639,9 +2725,11 @@ int delete_instr(CSOUND *csound, DELETEIN *p)
     if (active->auxchp != NULL)
       auxchfree(csound, active);
     free_instr_var_memory(csound, active);
-    csound->Free(csound, active);
+    if (!INSDS_PRIV_OF(active)->pooled)
+      csound->Free(csound, INSDS_BASE(active));
     active = nxt;
   }
+  free_instr_pool(csound, ip);
   csound->engineState.instrtxtp[n] = NULL;
   /* Now patch it out */
   for (txtp = &(csound->engineState.instxtanchor);
@@ -27,15 +27,46 @@
 /* This code wraps malloc etc with maintaining a list of allocated memory
    so it can be freed on a reset.  It would not be necessary with a zoned
    allocator.
+   Small blocks come from per-thread size-class arenas instead: each thread
+   carves them from its own chunks and keeps its own free lists, so the
+   common case takes no lock.  A block freed by another thread is pushed
+   onto the owning arena's lock-free remote list and picked up by the owner
+   when it next runs short.  When a thread exits its arenas are freed if
+   all their blocks have come back, or else left for the next thread that
+   needs one.  Only blocks larger than the biggest size class go on the
+   locked chain.  memRESET frees the chunks in bulk.
 */
 #if defined(BETA) && !defined(MEMDEBUG)
 #define MEMDEBUG  1
 #endif
 
+#if !defined(CS_NO_MEM_ARENAS)
+#  if defined(_MSC_VER)
+#    define MEM_THREAD_LOCAL __declspec(thread)
+#  elif defined(__GNUC__) || defined(__clang__)
+#    define MEM_THREAD_LOCAL __thread
+#  endif
+#  ifdef MEM_THREAD_LOCAL
+#    define MEM_ARENAS 1
+#  endif
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(HAVE_PTHREAD)
+#include <pthread.h>
+#endif
+
 #define MEMALLOC_MAGIC  0x6D426C6B
-/* The memory list must be controlled by mutex */
-#define CSOUND_MEM_SPINLOCK csoundSpinLock(&csound->memlock);
-#define CSOUND_MEM_SPINUNLOCK csoundSpinUnLock(&csound->memlock);
+/* The memory list must be controlled by mutex; record when it was taken */
+#define CSOUND_MEM_SPINLOCK                                             \
+    do {                                                                \
+      if (UNLIKELY(csoundSpinTryLock(&csound->memlock) != CSOUND_SUCCESS)) { \
+        csoundSpinLock(&csound->memlock);                               \
+        csound->mem_lock_waits++;                                       \
+      }                                                                 \
+    } while (0)
+#define CSOUND_MEM_SPINUNLOCK csoundSpinUnLock(&csound->memlock)
 
 typedef struct memAllocBlock_s {
 #ifdef MEMDEBUG
@@ -43,10 +74,14 @@ typedef struct memAllocBlock_s {
     void                    *ptr;       /* pointer to allocated area    */
 #endif
     struct memAllocBlock_s  *prv;       /* previous structure in chain  */
-    struct memAllocBlock_s  *nxt;       /* next structure in chain      */
+    struct memAllocBlock_s  *nxt;       /* next structure in chain,     */
+                                        /*   or in arena free list      */
+    struct memArena_s       *arena;     /* owning arena, NULL if large  */
+    size_t                  size;       /* size class, or bytes if large */
 } memAllocBlock_t;
 
-#define HDR_SIZE    (((int) sizeof(memAllocBlock_t) + 7) & (~7))
+/* keep data 16 byte aligned for SIMD code */
+#define HDR_SIZE    (((int) sizeof(memAllocBlock_t) + 15) & (~15))
 #define ALLOC_BYTES(n)  ((size_t) HDR_SIZE + (size_t) (n))
 #define DATA_PTR(p) ((void*) ((unsigned char*) (p) + (int) HDR_SIZE))
 #define HDR_PTR(p)  ((memAllocBlock_t*) ((unsigned char*) (p) - (int) HDR_SIZE))
@@ -60,6 +95,354 @@ static void memdie(CSOUND *csound, size_t nbytes)
     csound->LongJmp(csound, CSOUND_MEMORY);
 }
 
+#ifdef MEM_ARENAS
+
+#define MEM_NCLASSES    (14)
+#define MEM_MAX_SMALL   (2048)
+#define MEM_CHUNK_SIZE  (65536)
+#define MEM_CHUNK_HDR   (16)
+
+static const size_t mem_class_size[MEM_NCLASSES] = {
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048
+};
+
+typedef struct memArena_s {
+    struct memArena_s       *nxt;       /* all arenas of this instance  */
+    void *volatile          owner;      /* thread allocating from it,   */
+                                        /*   NULL once it has exited    */
+    struct memArena_s       *thread_nxt; /* other arenas of the owner   */
+    struct memArena_s       **thread_prv;
+    CSOUND                  *csound;
+    memAllocBlock_t         *free_list[MEM_NCLASSES];
+    unsigned char           *chunk_ptr, *chunk_end;
+    void                    *chunks;    /* chunks, freed by memRESET    */
+    /* counters written by the owner only */
+    uint64_t                allocs, frees;
+    uint64_t                bytes_alloc, bytes_freed;
+    char                    pad[64];
+    /* blocks freed by other threads; written by them, so kept apart */
+    memAllocBlock_t *volatile remote;
+    uint64_t                remote_frees, remote_bytes;
+    char                    pad2[64];
+} memArena_t;
+
+/* The arena last used by this thread.  The epoch tells it apart from
+   the arena of an instance that was reset or destroyed since. */
+typedef struct {
+    CSOUND                  *csound;
+    unsigned int            epoch;
+    memArena_t              *arena;
+} memThreadCache_t;
+
+static MEM_THREAD_LOCAL memThreadCache_t mem_cache;
+/* the arenas of this thread in all instances, under MEM_THREADS_LOCK */
+static MEM_THREAD_LOCAL memArena_t *mem_owned;
+static MEM_THREAD_LOCAL int mem_watched;
+static volatile unsigned int mem_epoch_count = 0;
+
+#if defined(_MSC_VER)
+#define MEM_CAS_PTR(x,current,new) \
+  (InterlockedCompareExchangePointer((PVOID volatile *)(x), new, current) \
+   == (PVOID)(current))
+#define MEM_XCHG_PTR(x,new) InterlockedExchangePointer((PVOID volatile *)(x), new)
+#define MEM_LOAD_PTR(x) (*(x))
+#define MEM_NEXT_EPOCH() ((unsigned int) InterlockedIncrement((volatile LONG*) \
+                                                &mem_epoch_count))
+#else
+#define MEM_CAS_PTR(x,current,new)  \
+  __atomic_compare_exchange_n(x, &(current), new, 1, __ATOMIC_RELEASE, \
+                              __ATOMIC_RELAXED)
+#define MEM_XCHG_PTR(x,new) __atomic_exchange_n(x, new, __ATOMIC_ACQUIRE)
+#define MEM_LOAD_PTR(x) __atomic_load_n(x, __ATOMIC_RELAXED)
+#define MEM_NEXT_EPOCH() __atomic_add_fetch(&mem_epoch_count, 1, __ATOMIC_SEQ_CST)
+#endif
+
+/* The counters are read by csoundGetMemoryStats() on any thread */
+#if defined(_MSC_VER)
+#define MEM_STORE_PTR(x,v) InterlockedExchangePointer((PVOID volatile *)(x), v)
+#define MEM_LOAD64(x) ((uint64_t) InterlockedCompareExchange64( \
+                                     (volatile LONG64*) &(x), 0, 0))
+#define MEM_ADD64(x,v) InterlockedExchangeAdd64((volatile LONG64*) &(x), \
+                                                (LONG64) (v))
+/* for counters that only the owner writes */
+#define MEM_BUMP64(x,v) MEM_ADD64(x,v)
+#else
+#define MEM_STORE_PTR(x,v) __atomic_store_n(x, v, __ATOMIC_RELEASE)
+#define MEM_LOAD64(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define MEM_ADD64(x,v) __atomic_add_fetch(&(x), v, __ATOMIC_RELEASE)
+#define MEM_BUMP64(x,v) __atomic_store_n(&(x), (x) + (v), __ATOMIC_RELAXED)
+#endif
+
+/* Thread exit: the arenas of a thread that exits are released by
+   mem_thread_exit(), run on that thread through a thread-specific key
+   destructor (fiber-local storage callback on Windows).  Elsewhere they
+   stay until memRESET, as does the arena of a thread that never exits
+   cleanly.  MEM_THREADS_LOCK guards the per-thread lists of arenas; it
+   is always taken before any memlock. */
+#if defined(_WIN32)
+#define MEM_THREAD_EXIT 1
+static SRWLOCK mem_threads_lock = SRWLOCK_INIT;
+#define MEM_THREADS_LOCK    AcquireSRWLockExclusive(&mem_threads_lock)
+#define MEM_THREADS_UNLOCK  ReleaseSRWLockExclusive(&mem_threads_lock)
+#elif defined(HAVE_PTHREAD)
+#define MEM_THREAD_EXIT 1
+static pthread_mutex_t mem_threads_lock = PTHREAD_MUTEX_INITIALIZER;
+#define MEM_THREADS_LOCK    pthread_mutex_lock(&mem_threads_lock)
+#define MEM_THREADS_UNLOCK  pthread_mutex_unlock(&mem_threads_lock)
+#else
+#define MEM_THREADS_LOCK
+#define MEM_THREADS_UNLOCK
+#endif
+
+static void mem_thread_link(memArena_t *a)
+{
+    a->thread_nxt = mem_owned;
+    a->thread_prv = &mem_owned;
+    if (mem_owned != NULL)
+      mem_owned->thread_prv = &a->thread_nxt;
+    mem_owned = a;
+}
+
+/* may be called on any thread, under MEM_THREADS_LOCK */
+static void mem_thread_unlink(memArena_t *a)
+{
+    if (a->thread_prv == NULL) return;
+    *(a->thread_prv) = a->thread_nxt;
+    if (a->thread_nxt != NULL)
+      a->thread_nxt->thread_prv = a->thread_prv;
+    a->thread_nxt = NULL;
+    a->thread_prv = NULL;
+}
+
+static void mem_free_chunks(memArena_t *a)
+{
+    void *chunk = a->chunks;
+    while (chunk != NULL) {
+      void *nxtc = *((void**) chunk);
+      free(chunk);
+      chunk = nxtc;
+    }
+}
+
+#ifdef MEM_THREAD_EXIT
+/* Free an arena whose thread has exited if all its blocks have come
+   back; otherwise leave it to be adopted by another thread.  Blocks of
+   an arena can only be freed while they are counted as live, and
+   freeing one ends by counting it, so a count of none live means that
+   no other thread can still touch the arena.  Under memlock. */
+static void mem_release_arena(CSOUND *csound, memArena_t *a)
+{
+    uint64_t frees = a->frees + MEM_LOAD64(a->remote_frees);
+    if (frees == a->allocs) {
+      memArena_t **pa = (memArena_t**) &csound->mem_arenas;
+      while (*pa != a) pa = &(*pa)->nxt;
+      *pa = a->nxt;
+      csound->mem_retired_allocs += a->allocs;
+      csound->mem_retired_frees += frees;
+      mem_free_chunks(a);
+      free((void*) a);
+    }
+    else
+      MEM_STORE_PTR(&a->owner, NULL);
+}
+
+static void mem_thread_exit(void *arg)
+{
+    memArena_t *a;
+    IGN(arg);
+    MEM_THREADS_LOCK;
+    while ((a = mem_owned) != NULL) {
+      CSOUND *csound = a->csound;
+      mem_thread_unlink(a);
+      CSOUND_MEM_SPINLOCK;
+      mem_release_arena(csound, a);
+      CSOUND_MEM_SPINUNLOCK;
+    }
+    mem_cache.csound = NULL;
+    mem_watched = 0;            /* in case it allocates again */
+    MEM_THREADS_UNLOCK;
+}
+
+#if defined(_WIN32)
+static DWORD mem_exit_fls = FLS_OUT_OF_INDEXES;
+static INIT_ONCE mem_exit_once = INIT_ONCE_STATIC_INIT;
+
+static void WINAPI mem_exit_callback(PVOID p)
+{
+    if (p != NULL) mem_thread_exit(p);
+}
+
+static BOOL CALLBACK mem_exit_key_create(PINIT_ONCE o, PVOID p, PVOID *ctx)
+{
+    IGN(o); IGN(p); IGN(ctx);
+    mem_exit_fls = FlsAlloc(mem_exit_callback);
+    return TRUE;
+}
+
+static void mem_watch_thread(void)
+{
+    InitOnceExecuteOnce(&mem_exit_once, mem_exit_key_create, NULL, NULL);
+    if (mem_exit_fls != FLS_OUT_OF_INDEXES)
+      FlsSetValue(mem_exit_fls, (PVOID) &mem_cache);
+}
+#else
+static pthread_key_t  mem_exit_key;
+static pthread_once_t mem_exit_once = PTHREAD_ONCE_INIT;
+
+static void mem_exit_key_create(void)
+{
+    pthread_key_create(&mem_exit_key, mem_thread_exit);
+}
+
+static void mem_watch_thread(void)
+{
+    pthread_once(&mem_exit_once, mem_exit_key_create);
+    pthread_setspecific(mem_exit_key, (void*) &mem_cache);
+}
+#endif
+#endif  /* MEM_THREAD_EXIT */
+
+static inline int mem_size_class(size_t size)
+{
+    int c = (size <= 64 ? 0 : 4);
+    while (mem_class_size[c] < size) c++;
+    return c;
+}
+
+/* Find or make the arena of the calling thread; the address of the
+   thread-local cache identifies the thread.  The arena of a thread
+   that has exited with blocks still in use is adopted before a new
+   one is made. */
+static memArena_t *mem_find_arena(CSOUND *csound)
+{
+    memArena_t *a, *orphan = NULL;
+    MEM_THREADS_LOCK;
+    CSOUND_MEM_SPINLOCK;
+    if (csound->mem_epoch == 0) {
+      unsigned int e;
+      while ((e = MEM_NEXT_EPOCH()) == 0) ;
+      csound->mem_epoch = e;
+    }
+    for (a = (memArena_t*) csound->mem_arenas; a != NULL; a = a->nxt) {
+      if (a->owner == (void*) &mem_cache) break;
+      if (a->owner == NULL && orphan == NULL) orphan = a;
+    }
+    if (a == NULL && (a = orphan) != NULL) {
+      MEM_STORE_PTR(&a->owner, (void*) &mem_cache);
+      mem_thread_link(a);
+    }
+    else if (a == NULL) {
+      if (UNLIKELY((a = (memArena_t*) calloc(1, sizeof(memArena_t))) == NULL)) {
+        CSOUND_MEM_SPINUNLOCK;
+        MEM_THREADS_UNLOCK;
+        memdie(csound, sizeof(memArena_t));
+      }
+      a->owner = (void*) &mem_cache;
+      a->csound = csound;
+      a->nxt = (memArena_t*) csound->mem_arenas;
+      csound->mem_arenas = (void*) a;
+      mem_thread_link(a);
+    }
+#ifdef MEM_THREAD_EXIT
+    if (!mem_watched) {
+      mem_watched = 1;
+      mem_watch_thread();
+    }
+#endif
+    mem_cache.csound = csound;
+    mem_cache.epoch = csound->mem_epoch;
+    mem_cache.arena = a;
+    CSOUND_MEM_SPINUNLOCK;
+    MEM_THREADS_UNLOCK;
+    return a;
+}
+
+static inline memArena_t *mem_get_arena(CSOUND *csound)
+{
+    if (LIKELY(mem_cache.csound == csound &&
+               mem_cache.epoch == csound->mem_epoch))
+      return mem_cache.arena;
+    return mem_find_arena(csound);
+}
+
+/* Move blocks freed by other threads onto the owner's free lists */
+static void mem_collect_remote(memArena_t *a)
+{
+    memAllocBlock_t *p, *nxt;
+    if (MEM_LOAD_PTR(&a->remote) == NULL) return;
+    p = (memAllocBlock_t*) MEM_XCHG_PTR(&a->remote, NULL);
+    while (p != NULL) {
+      nxt = p->nxt;
+      p->nxt = a->free_list[p->size];
+      a->free_list[p->size] = p;
+      p = nxt;
+    }
+}
+
+static memAllocBlock_t *mem_arena_alloc(CSOUND *csound, size_t size)
+{
+    memArena_t      *a = mem_get_arena(csound);
+    int             c = mem_size_class(size);
+    memAllocBlock_t *p = a->free_list[c];
+
+    if (p == NULL) {
+      mem_collect_remote(a);
+      p = a->free_list[c];
+    }
+    if (p != NULL)
+      a->free_list[c] = p->nxt;
+    else {
+      /* carve a new block from the current chunk */
+      size_t n = ALLOC_BYTES(mem_class_size[c]);
+      if (a->chunk_ptr == NULL || (size_t) (a->chunk_end - a->chunk_ptr) < n) {
+        unsigned char *chunk = (unsigned char*) malloc(MEM_CHUNK_SIZE);
+        if (UNLIKELY(chunk == NULL))
+          memdie(csound, size);     /* does a long jump */
+        *((void**) chunk) = a->chunks;
+        a->chunks = (void*) chunk;
+        a->chunk_ptr = chunk + MEM_CHUNK_HDR;
+        a->chunk_end = chunk + MEM_CHUNK_SIZE;
+      }
+      p = (memAllocBlock_t*) a->chunk_ptr;
+      a->chunk_ptr += n;
+    }
+#ifdef MEMDEBUG
+    p->magic = MEMALLOC_MAGIC;
+    p->ptr = DATA_PTR(p);
+#endif
+    p->prv = NULL;
+    p->arena = a;
+    p->size = (size_t) c;
+    MEM_BUMP64(a->allocs, 1);
+    MEM_BUMP64(a->bytes_alloc, mem_class_size[c]);
+    return p;
+}
+
+/* The block is counted as freed on its own arena, last, so that the
+   arena is not released while another thread is still pushing to it */
+static void mem_arena_free(memAllocBlock_t *pp)
+{
+    memArena_t *owner = pp->arena;
+    size_t     bytes = mem_class_size[pp->size];
+    if (MEM_LOAD_PTR(&owner->owner) == (void*) &mem_cache) {
+      pp->nxt = owner->free_list[pp->size];
+      owner->free_list[pp->size] = pp;
+      MEM_BUMP64(owner->bytes_freed, bytes);
+      MEM_BUMP64(owner->frees, 1);
+    }
+    else {
+      memAllocBlock_t *head;
+      do {
+        head = MEM_LOAD_PTR(&owner->remote);
+        pp->nxt = head;
+      } while (!MEM_CAS_PTR(&owner->remote, head, pp));
+      MEM_ADD64(owner->remote_bytes, bytes);
+      MEM_ADD64(owner->remote_frees, 1);
+    }
+}
+
+#endif  /* MEM_ARENAS */
+
 void *mmalloc(CSOUND *csound, size_t size)
 {
     void  *p;
@@ -70,6 +453,10 @@ void *mmalloc(CSOUND *csound, size_t size)
               " *** internal error: mmalloc() called with zero nbytes\n");
       return NULL;
     }
+#endif
+#ifdef MEM_ARENAS
+    if (size <= MEM_MAX_SMALL)
+      return DATA_PTR(mem_arena_alloc(csound, size));
 #endif
     /* allocate memory */
     if (UNLIKELY((p = malloc(ALLOC_BYTES(size))) == NULL)) {
@@ -80,13 +467,17 @@ void *mmalloc(CSOUND *csound, size_t size)
     ((memAllocBlock_t*) p)->magic = MEMALLOC_MAGIC;
     ((memAllocBlock_t*) p)->ptr = DATA_PTR(p);
 #endif
-    CSOUND_MEM_SPINLOCK
+    ((memAllocBlock_t*) p)->arena = NULL;
+    ((memAllocBlock_t*) p)->size = size;
+    CSOUND_MEM_SPINLOCK;
     ((memAllocBlock_t*) p)->prv = (memAllocBlock_t*) NULL;
     ((memAllocBlock_t*) p)->nxt = (memAllocBlock_t*) MEMALLOC_DB;
     if (MEMALLOC_DB != NULL)
       ((memAllocBlock_t*) MEMALLOC_DB)->prv = (memAllocBlock_t*) p;
     MEMALLOC_DB = (void*) p;
-    CSOUND_MEM_SPINUNLOCK
+    csound->mem_large_allocs++;
+    csound->mem_large_bytes += size;
+    CSOUND_MEM_SPINUNLOCK;
     /* return with data pointer */
     return DATA_PTR(p);
 }
@@ -108,6 +499,13 @@ void *mcalloc(CSOUND *csound, size_t size)
               " *** internal error: csound->Calloc() called with zero nbytes\n");
       return NULL;
     }
+#endif
+#ifdef MEM_ARENAS
+    if (size <= MEM_MAX_SMALL) {
+      p = DATA_PTR(mem_arena_alloc(csound, size));
+      memset(p, 0, size);
+      return p;
+    }
 #endif
     /* allocate memory */
     if (UNLIKELY((p = calloc(ALLOC_BYTES(size), (size_t) 1)) == NULL)) {
@@ -118,13 +516,16 @@ void *mcalloc(CSOUND *csound, size_t size)
     ((memAllocBlock_t*) p)->magic = MEMALLOC_MAGIC;
     ((memAllocBlock_t*) p)->ptr = DATA_PTR(p);
 #endif
-    CSOUND_MEM_SPINLOCK
+    ((memAllocBlock_t*) p)->size = size;
+    CSOUND_MEM_SPINLOCK;
     ((memAllocBlock_t*) p)->prv = (memAllocBlock_t*) NULL;
     ((memAllocBlock_t*) p)->nxt = (memAllocBlock_t*) MEMALLOC_DB;
     if (MEMALLOC_DB != NULL)
       ((memAllocBlock_t*) MEMALLOC_DB)->prv = (memAllocBlock_t*) p;
     MEMALLOC_DB = (void*) p;
-    CSOUND_MEM_SPINUNLOCK
+    csound->mem_large_allocs++;
+    csound->mem_large_bytes += size;
+    CSOUND_MEM_SPINUNLOCK;
     /* return with data pointer */
     return DATA_PTR(p);
 }
@@ -157,7 +558,13 @@ void mfree(CSOUND *csound, void *p)
     }
     pp->magic = 0;
  #endif
-    CSOUND_MEM_SPINLOCK
+#ifdef MEM_ARENAS
+    if (pp->arena != NULL) {
+      mem_arena_free(pp);
+      return;
+    }
+#endif
+    CSOUND_MEM_SPINLOCK;
     /* unlink from chain */
     {
       memAllocBlock_t *prv = pp->prv, *nxt = pp->nxt;
@@ -168,10 +575,12 @@ void mfree(CSOUND *csound, void *p)
       else
         MEMALLOC_DB = (void*)nxt;
     }
+    csound->mem_large_frees++;
+    csound->mem_large_bytes -= pp->size;
     //csound->Message(csound, "free\n");
     /* free memory */
     free((void*) pp);
-    CSOUND_MEM_SPINUNLOCK
+    CSOUND_MEM_SPINUNLOCK;
 }
 
 void mfreeDebug(CSOUND *csound, void *ans, char *file, int line)
@@ -184,6 +593,7 @@ void *mrealloc(CSOUND *csound, void *oldp, size_t size)
 {
     memAllocBlock_t *pp;
     void            *p;
+    size_t          failed = 0;
 
     if (UNLIKELY(oldp == NULL))
       return mmalloc(csound, size);
@@ -200,6 +610,32 @@ void *mrealloc(CSOUND *csound, void *oldp, size_t size)
       /* as a result of a bug */
       exit(-1);
     }
+#endif
+#ifdef MEM_ARENAS
+    if (pp->arena != NULL) {
+      /* grow within the size class, or move to a bigger block */
+      size_t  oldsize = mem_class_size[pp->size];
+      if (size <= oldsize)
+        return oldp;
+      p = mmalloc(csound, size);
+      memcpy(p, oldp, oldsize);
+      mfree(csound, oldp);
+      return p;
+    }
+#endif
+    /* unlink from chain, as a neighbour may be freed while we realloc */
+    CSOUND_MEM_SPINLOCK;
+    {
+      memAllocBlock_t *prv = pp->prv, *nxt = pp->nxt;
+      if (nxt != NULL)
+        nxt->prv = prv;
+      if (prv != NULL)
+        prv->nxt = nxt;
+      else
+        MEMALLOC_DB = (void*) nxt;
+    }
+    CSOUND_MEM_SPINUNLOCK;
+#ifdef MEMDEBUG
     /* mark old header as invalid */
     pp->magic = 0;
     pp->ptr = NULL;
@@ -208,32 +644,31 @@ void *mrealloc(CSOUND *csound, void *oldp, size_t size)
     p = realloc((void*) pp, ALLOC_BYTES(size));
     if (UNLIKELY(p == NULL)) {
 #ifdef MEMDEBUG
-      CSOUND_MEM_SPINLOCK
       /* alloc failed, restore original header */
       pp->magic = MEMALLOC_MAGIC;
       pp->ptr = oldp;
-      CSOUND_MEM_SPINUNLOCK
 #endif
-      memdie(csound, size);
-      return NULL;
+      p = (void*) pp;   /* still valid; link back so memRESET frees it */
+      failed = size;
+      size = pp->size;
     }
-    CSOUND_MEM_SPINLOCK
-    /* create new header and update chain pointers */
+    CSOUND_MEM_SPINLOCK;
+    /* create new header and link into chain */
     pp = (memAllocBlock_t*) p;
 #ifdef MEMDEBUG
     pp->magic = MEMALLOC_MAGIC;
     pp->ptr = DATA_PTR(pp);
 #endif
-    {
-      memAllocBlock_t *prv = pp->prv, *nxt = pp->nxt;
-      if (nxt != NULL)
-        nxt->prv = pp;
-      if (prv != NULL)
-        prv->nxt = pp;
-      else
-        MEMALLOC_DB = (void*) pp;
-    }
-    CSOUND_MEM_SPINUNLOCK
+    pp->prv = (memAllocBlock_t*) NULL;
+    pp->nxt = (memAllocBlock_t*) MEMALLOC_DB;
+    if (MEMALLOC_DB != NULL)
+      ((memAllocBlock_t*) MEMALLOC_DB)->prv = pp;
+    MEMALLOC_DB = (void*) pp;
+    csound->mem_large_bytes += (int64_t) size - (int64_t) pp->size;
+    pp->size = size;
+    CSOUND_MEM_SPINUNLOCK;
+    if (UNLIKELY(failed))
+      memdie(csound, failed);
     /* return with data pointer */
     return DATA_PTR(pp);
 }
@@ -259,4 +694,59 @@ void memRESET(CSOUND *csound)
       free((void*) pp);
       pp = nxtp;
     }
+#ifdef MEM_ARENAS
+    {
+      memArena_t *a = (memArena_t*) csound->mem_arenas, *nxta;
+      MEM_THREADS_LOCK;
+      while (a != NULL) {
+        mem_thread_unlink(a);
+        mem_free_chunks(a);
+        nxta = a->nxt;
+        free((void*) a);
+        a = nxta;
+      }
+      MEM_THREADS_UNLOCK;
+    }
+#endif
+    csound->mem_arenas = NULL;
+    csound->mem_epoch = 0;      /* threads must not use cached arenas */
+    csound->mem_large_bytes = 0;
+    csound->mem_large_allocs = csound->mem_large_frees = 0;
+    csound->mem_retired_allocs = csound->mem_retired_frees = 0;
+    csound->mem_lock_waits = 0;
+}
+
+PUBLIC void csoundGetMemoryStats(CSOUND *csound, CSOUND_MEMORY_STATS *stats)
+{
+    double  now;
+    memset(stats, 0, sizeof(CSOUND_MEMORY_STATS));
+    CSOUND_MEM_SPINLOCK;
+#ifdef MEM_ARENAS
+    {
+      memArena_t *a;
+      for (a = (memArena_t*) csound->mem_arenas; a != NULL; a = a->nxt) {
+        stats->allocs += MEM_LOAD64(a->allocs);
+        stats->frees += MEM_LOAD64(a->frees) + MEM_LOAD64(a->remote_frees);
+        stats->bytes_live += (int64_t) (MEM_LOAD64(a->bytes_alloc) -
+                                        MEM_LOAD64(a->bytes_freed) -
+                                        MEM_LOAD64(a->remote_bytes));
+        stats->arenas++;
+      }
+    }
+#endif
+    stats->allocs += csound->mem_large_allocs + csound->mem_retired_allocs;
+    stats->frees += csound->mem_large_frees + csound->mem_retired_frees;
+    stats->bytes_live += csound->mem_large_bytes;
+    stats->lock_waits = csound->mem_lock_waits;
+    /* rate since the previous call, or since the reset */
+    if (csound->csRtClock != NULL) {
+      now = csoundGetRealTime(csound->csRtClock);
+      if (now > csound->mem_stats_time)
+        stats->allocs_per_second =
+          (double) (stats->allocs - csound->mem_stats_allocs) /
+          (now - csound->mem_stats_time);
+      csound->mem_stats_time = now;
+      csound->mem_stats_allocs = stats->allocs;
+    }
+    CSOUND_MEM_SPINUNLOCK;
 }
@@ -28,6 +28,7 @@
 #include "namedins.h"
 #include "oload.h"
 #include "remote.h"
+#include "fgens.h"
 #include <math.h>
 #include "corfile.h"
 
@@ -460,6 +461,9 @@ static inline void cs_beep(CSOUND *csound)
     csound->Message(csound, Str("%c\tbeep!\n"), '\a');
 }
 
+extern void dag_stop_workers(CSOUND *);
+extern void profile_report(CSOUND *);
+
 PUBLIC int csoundCleanup(CSOUND *csound)
 {
     void    *p;
@@ -487,6 +491,8 @@ PUBLIC int csoundCleanup(CSOUND *csound)
     /* will not clean up more than once */
     csound->engineStatus &= ~(CS_STATE_CLN);
 
+    dag_stop_workers(csound);
+
     deactivate_all_notes(csound);
 
     if (csound->engineState.instrtxtp &&
@@ -536,6 +542,19 @@ PUBLIC int csoundCleanup(CSOUND *csound)
       }
       csound->Message(csound, Str("\n%d errors in performance\n"),
                       csound->perferrcnt);
+      if (csound->oparms->numThreads > 1) {
+        dagStats *st = &csound->dag_stats;
+        csound->Message(csound,
+                        Str("parallel k-cycles: %lu inline, %lu with "
+                            "%.2f threads on average\n"),
+                        (unsigned long) st->inline_cycles,
+                        (unsigned long) st->parallel_cycles,
+                        st->parallel_cycles ?
+                        1.0 + (double) st->workers_woken /
+                        (double) st->parallel_cycles : 0.0);
+      }
+      if (csound->profile != NULL)
+        profile_report(csound);
       print_benchmark_info(csound, Str("end of performance"));
     }
     /* close line input (-L) */
@@ -979,6 +998,9 @@ int sensevents(CSOUND *csound)
     csound->Message(csound, Str("terminating.\n"));
     return 1;                         /* abort with perf incomplete */
   }
+  /* tables from asynchronous GENs appear between k-cycles */
+  if (UNLIKELY(csound->ftgen_async != NULL))
+    ftgen_async_poll(csound);
   /* if turnoffs pending, remove any expired instrs */
   RT_SPIN_TRYLOCK
   if (UNLIKELY(csound->frstoff != NULL)) {
@@ -88,6 +88,23 @@ typedef struct {
     MYFLT   *r, *a, *b, *def;
 } DIVZ;
 
+/* ##fuse: an a-rate tree of + - * / and negation from the orchestra
+   compiler, evaluated FUSE_CHUNK samples at a time */
+#define FUSE_MAXNODES   (32)
+#define FUSE_CHUNK      (16)
+
+typedef struct {
+    OPDS    h;
+    MYFLT   *r;
+    STRINGDAT *prog;                /* postfix: a k i leaves, + - * / n */
+    MYFLT   *args[FUSE_MAXNODES];
+    int32_t nnodes;
+    char    op[FUSE_MAXNODES];
+    char    kind[FUSE_MAXNODES];    /* 0: init time, 1: k-rate, 2: a-rate */
+    uint8_t lft[FUSE_MAXNODES], rgt[FUSE_MAXNODES], arg[FUSE_MAXNODES];
+    MYFLT   val[FUSE_MAXNODES];     /* value of the scalar nodes */
+} FUSE;
+
 typedef struct {
     OPDS    h;
     MYFLT   *r, *a;
@@ -74,7 +74,9 @@ typedef struct {
     MYFLT       *fp;
     spin_lock_t *lock;
     int32_t     pos;
-    char        chname[MAX_CHAN_NAME+1];
+    CHNENTRY    *chn;       /* channel found by the last lookup */
+    AUXCH       miss;       /* name of the last failed lookup */
+    int32_t     misserr;    /*   and its error */
 } CHNGET;
 
 typedef struct {
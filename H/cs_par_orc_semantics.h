@@ -84,6 +84,10 @@ struct instr_semantics_t
 struct instr_semantics_t
     *csp_orc_sa_instr_get_by_num(CSOUND *csound, int16 insno);
 
+/* make instances of two instruments run in chain order, for a
+   dependency found at run time rather than in the orchestra text */
+int csp_orc_sa_dependency(CSOUND *csound, int insno1, int insno2);
+
 /* interlocks */
 void csp_orc_sa_interlocks(CSOUND *, ORCTOKEN *);
 
@@ -71,6 +71,7 @@ typedef struct {
     MYFLT   *aOut_buf;
     MYFLT   aOut_bufsize;
     void    *cb;
+    void    *stream;        /* DISKIN_STREAM, when async */
     int     async;
 } DISKIN2;
 
@@ -113,6 +114,7 @@ typedef struct {
   MYFLT *aOut_buf;
   MYFLT aOut_bufsize;
   void *cb;
+  void *stream;
   int  async;
 } DISKIN2_ARRAY;
 
@@ -141,6 +141,12 @@ extern "C" {
    */
   void csoundRealFFT2(CSOUND *csound, void *setup, MYFLT *sig);
 
+  /* mixed-radix real FFT (mrfft.c), used by csoundRealFFT2Setup() for
+     sizes that are not powers of two, or for all sizes with --fftlib=3 */
+  void *mrfft_get_plan(CSOUND *csound, int N);
+  int mrfft_work_size(void *plan);
+  void mrfft_execute(void *plan, MYFLT *sig, MYFLT *work, int d);
+
 
 
 #ifdef __cplusplus
@@ -35,6 +35,27 @@
  */
 int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode);
 
+/**
+ * As hfgens(), but the GEN runs on a separate thread and the table only
+ * appears in the table list once it is complete.
+ * Returns the table number (zero if there is nothing to generate),
+ * or -1 on error.
+ */
+int hfgens_async(CSOUND *csound, const EVTBLK *evtblkp, int mode);
+
+/**
+ * Returns 1 if table tableNum exists and is complete, 0 while an
+ * asynchronous GEN for it is still running or not yet published, and
+ * -1 otherwise.  Safe to call from any thread.
+ */
+int ftgen_ready(CSOUND *csound, int tableNum);
+
+/**
+ * Publishes the tables of finished asynchronous GENs.  Only called
+ * on the performance thread, between k-cycles.
+ */
+void ftgen_async_poll(CSOUND *csound);
+
 /**
  * Allocates space for 'tableNum' with a length (not including the guard
  * point) of 'len' samples. The table data is not cleared to zero.
@@ -42,6 +63,18 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode);
  */
 int csoundFTAlloc(CSOUND *csound, int tableNum, int len);
 
+/**
+ * Stops sharing cached tables (--ftable-cache) with other instances if
+ * the orchestra in engineState has opcodes that write to tables.
+ */
+void csoundFTUnshareWriters(CSOUND *csound, ENGINE_STATE *engineState);
+
+/**
+ * Gives a table its own copy of the data if it is shared through the
+ * table cache, before it is written to.
+ */
+void csoundFTUnshare(CSOUND *csound, FUNC *ftp);
+
 /**
  * Deletes a function table.
  * Return value is zero on success.
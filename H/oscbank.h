@@ -0,0 +1,88 @@
+/*
+    oscbank.h:
+
+    Copyright (C) 2026 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CSOUND_OSCBANK_H
+#define CSOUND_OSCBANK_H
+
+/* Sinusoidal oscillator bank for the additive resynthesis opcodes
+   (pvsadsyn, tradsyn, sinsyn and resyn).
+
+   A run of the bank adds nsmps samples to an output buffer.  At sample
+   m of the run partial k contributes
+
+       (amp[k] + m * damp[k]) *
+         sin(ph[k] + m * (c1[k] + m * (c2[k] + m * c3[k])))
+
+   that is a linear amplitude ramp and a constant, linearly gliding or
+   cubic (sinsyn) phase.  The partials are held as a structure of arrays
+   and synthesised one vector of them at a time with complex rotors, so
+   the inner loop is multiplies and adds only.  The rotors are set up
+   from the exact phase at the start of a run and, for gliding
+   frequencies, again every OSCBANK_SPAN samples, so that rounding
+   cannot accumulate.  The instruction set is the one the array
+   kernels use (CSOUND_ARRAY_ISA forces it, see Opcodes/arrayvec.h). */
+
+#ifdef USE_DOUBLE
+#define OSCBANK_SPAN    256
+#else
+#define OSCBANK_SPAN    64
+#endif
+
+typedef struct {
+    int32_t     n;              /* partials added for the next run */
+    int32_t     max;            /* room, a multiple of the widest vector */
+    int32_t     order;          /* highest power of m in a phase, 1 to 3 */
+    double      *ph, *c1, *c2, *c3;
+    MYFLT       *amp, *damp;
+    MYFLT       *st;            /* rotor state, 10 arrays of max */
+} OSCBANK;
+
+/* a bank for up to max partials, in the memory of aux */
+OSCBANK *oscbank_alloc(CSOUND *, AUXCH *aux, int32_t max);
+
+static inline void oscbank_add(OSCBANK *b, MYFLT amp, MYFLT damp,
+                               double ph, double c1, double c2, double c3)
+{
+    int32_t k = b->n++;
+    b->amp[k] = amp;
+    b->damp[k] = damp;
+    b->ph[k] = ph;
+    b->c1[k] = c1;
+    b->c2[k] = c2;
+    b->c3[k] = c3;
+    if (c3 != 0.0)
+      b->order = 3;
+    else if (c2 != 0.0 && b->order < 2)
+      b->order = 2;
+}
+
+/* add the partials to out[0] .. out[nsmps - 1] and empty the bank */
+void oscbank_run(OSCBANK *b, MYFLT *out, int32_t nsmps);
+
+/* picks the kernels; called once by csoundInitialize() */
+void oscbank_vec_init(void);
+
+/* name of the instruction set the kernels use */
+const char *oscbank_isa(void);
+
+#endif  /* CSOUND_OSCBANK_H */
@@ -0,0 +1,139 @@
+/*
+    profile.h:
+
+    Copyright (C) 2026 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CSOUND_PROFILE_H
+#define CSOUND_PROFILE_H
+
+/* Opcode profiler (--profile).  Every performance thread counts calls
+   and clock ticks per (instrument, OENTRY) pair in a table of its own,
+   so the k-loop takes no lock; the tables are only merged when the
+   profile is read.  With profiling off csound->profile is NULL and the
+   k-loop pays one predictable branch per opcode. */
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif !defined(__i386__) && !defined(__x86_64__) && !defined(__aarch64__) \
+      && !defined(WIN32)
+#include <time.h>
+#endif
+
+typedef struct {
+    const OENTRY  *op;          /* NULL: empty slot */
+    int32         insno;
+    uint64_t      calls;
+    uint64_t      ticks;
+} PROFNODE;
+
+/* the slots and their mask in one block, so that a reader always gets
+   a matching pair */
+typedef struct {
+    uint32_t      mask;
+    PROFNODE      node[1];      /* open addressing, mask+1 slots */
+} PROFSET;
+
+typedef struct {
+    PROFSET       *set;         /* replaced, never changed, when it grows */
+    uint32_t      count;
+    /* one cache line per thread */
+    char          pad[64 - sizeof(PROFSET*) - sizeof(uint32_t)];
+} PROFTAB;
+
+/* the owning thread publishes new sets and slots with release stores,
+   csoundGetProfile() reads them with acquire loads */
+#if defined(HAVE_ATOMIC_BUILTIN)
+#define PROFILE_PUBLISH(var, val) __atomic_store_n(&(var), val, __ATOMIC_RELEASE)
+#define PROFILE_ACQUIRE(var)      __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#elif defined(_MSC_VER)
+#define PROFILE_PUBLISH(var, val)                                       \
+    InterlockedExchangePointer((PVOID volatile *) &(var), (PVOID) (val))
+#define PROFILE_ACQUIRE(var)      (*(PVOID volatile *) &(var))
+#else
+#define PROFILE_PUBLISH(var, val) ((var) = (val))
+#define PROFILE_ACQUIRE(var)      (var)
+#endif
+
+static inline uint64_t profile_ticks(void)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return (uint64_t) __rdtsc();
+#elif defined(__i386__) || defined(__x86_64__)
+    return (uint64_t) __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t  v;
+    __asm__ volatile ("mrs %0, cntvct_el0" : "=r" (v));
+    return v;
+#elif defined(WIN32)
+    LARGE_INTEGER tmp;
+    QueryPerformanceCounter(&tmp);
+    return (uint64_t) tmp.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000U + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+static inline uint32_t profile_hash(const OENTRY *ep, int32 insno)
+{
+    return ((uint32_t) ((uintptr_t) ep >> 4) ^ ((uint32_t) insno << 16))
+           * 0x9E3779B1U;
+}
+
+PROFNODE *profile_add(CSOUND *, PROFTAB *, const OENTRY *, int32 insno);
+PROFTAB *profile_thread_tab(CSOUND *, int index);
+void profile_init(CSOUND *);
+void profile_report(CSOUND *);
+
+static inline int profile_opcode(CSOUND *csound, PROFTAB *t, OPDS *op)
+{
+    const OENTRY  *ep = op->optext->t.oentry;
+    int32         insno = op->insdshead->insno;
+    PROFSET       *set = t->set;
+    uint32_t      h;
+    PROFNODE      *n;
+    uint64_t      t0;
+    int           err;
+
+    h = profile_hash(ep, insno) & set->mask;
+    while ((n = &set->node[h])->op != NULL &&
+           (n->op != ep || n->insno != insno))
+      h = (h + 1) & set->mask;
+    if (UNLIKELY(n->op == NULL))
+      n = profile_add(csound, t, ep, insno);
+    t0 = profile_ticks();
+    err = (*op->opadr)(csound, op);
+    n->ticks += profile_ticks() - t0;
+    n->calls++;
+    return err;
+}
+
+/* table of the calling performance thread (0: main), NULL when off */
+#define PROFILE_TAB(csound, index)                                      \
+    (UNLIKELY((csound)->profile != NULL) ?                              \
+     profile_thread_tab(csound, index) : (PROFTAB*) NULL)
+
+#define PROFILE_PERF(csound, prof, op)                                  \
+    (UNLIKELY((prof) != NULL) ? profile_opcode(csound, prof, op)        \
+                              : (*(op)->opadr)(csound, op))
+
+#endif  /* CSOUND_PROFILE_H */
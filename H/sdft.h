@@ -0,0 +1,103 @@
+/*
+    sdft.h:
+
+    Copyright (C) 2026 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CSOUND_SDFT_H
+#define CSOUND_SDFT_H
+
+/* Sliding DFT for pvsanal and pvsynth when the hop is a single sample.
+
+   Analysis runs a block of samples at a time in two passes.  The first
+   updates the running transform of every bin for each sample of the
+   block, a vector of bins at a time with the bins' state held in
+   registers for the whole block; the second windows each sample's
+   spectrum in the frequency domain and converts it to amplitude and
+   frequency.  Synthesis sums the bins of each sample of a block.  The
+   arithmetic is that of the per-sample code these replace, in double
+   precision in both builds.
+
+   With --sdft-threads=N above 1 a pool of N - 1 threads shares the bins
+   of large transforms with the performance thread; the threads meet at
+   a barrier between the passes.  The instruction set is the one the
+   array kernels use (see Opcodes/arrayvec.h). */
+
+#define SDFT_MAX_THREADS    16
+
+typedef struct sdft_engine_s SDFT_ENGINE;
+
+typedef struct {
+    int32_t     N, NB;
+    int32_t     npad;           /* NB rounded up to whole vector groups */
+    int32_t     terms;          /* of the window: 1 (rectangular) to 3 */
+    int32_t     hack;           /* bin 1 is the mean of bins 0 and 2 */
+    double      a0, b1, c2;     /* window: a0 F[j] - b1 (F[j-1] + F[j+1]) */
+    double      e1, e2;         /*   + c2 (F[j-2] + F[j+2]), e1, e2 edges */
+    double      esr;
+    double      *cr, *ci;       /* rotation of each bin per sample */
+    double      *zr, *zi;       /* running transform */
+    double      *ph;            /* phase at the previous sample */
+    double      *binph;         /* expected phase advance of each bin */
+    double      *tr, *ti;       /* windowed spectrum of a sample */
+    double      *rr, *ri;       /* unwindowed spectra of a block */
+    double      *dx;            /* change of input of each sample */
+    CMPLX       *frame;         /* first row to write */
+    int32_t     nsmps;          /* rows to write */
+    SDFT_ENGINE *engine;
+} SDFT_ANAL;
+
+typedef struct {
+    int32_t     N, NB, npad;
+    int32_t     ksmps;
+    double      scale;          /* 2 pi / sr */
+    double      *ph;            /* running phase of each bin */
+    double      *fc, *binph;    /* bin centre frequency, phase advance */
+    double      *w, *amp;       /* sign and amplitude of each bin */
+    double      *acc;           /* alternating sums, ksmps per part */
+    double      *first, *last;  /* bins 0 and NB - 1 of each sample */
+    const CMPLX *frame;
+    int32_t     nsmps;
+    SDFT_ENGINE *engine;
+} SDFT_SYNTH;
+
+/* analysis of an N point window of type wintype, for blocks of up
+   to ksmps samples, in the memory of aux */
+SDFT_ANAL *sdft_anal_alloc(CSOUND *, AUXCH *aux, int32_t N,
+                           int32_t wintype, int32_t ksmps);
+
+/* set sd->dx[0] .. sd->dx[nsmps - 1] first; writes nsmps rows of NB
+   bins from frame */
+void sdft_anal(CSOUND *, SDFT_ANAL *sd, CMPLX *frame, int32_t nsmps);
+
+SDFT_SYNTH *sdft_synth_alloc(CSOUND *, AUXCH *aux, int32_t N,
+                             int32_t ksmps);
+
+/* out[i] from row i of frame, for i < nsmps */
+void sdft_synth(CSOUND *, SDFT_SYNTH *sy, const CMPLX *frame, MYFLT *out,
+                int32_t nsmps);
+
+/* picks the transform kernel; called once by csoundInitialize() */
+void sdft_vec_init(void);
+
+/* name of the instruction set of the transform kernel */
+const char *sdft_isa(void);
+
+#endif  /* CSOUND_SDFT_H */
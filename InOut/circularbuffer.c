@@ -23,152 +23,222 @@
 
 #include <csoundCore.h>
 
+/* Single-producer single-consumer ring buffer.  The storage holds a
+   power of two of elements, so that positions wrap with a mask, and the
+   read and write positions run freely; each is only written by its own
+   side, which therefore needs no more than an acquire load of the
+   other's position and a release store of its own.  At most numelem-1
+   items are held, as before.  A flush, which may come from the writer,
+   only records how far to discard; the reader applies it, so that the
+   read position keeps a single writer. */
+
+#define CB_CACHE_LINE 64
+
 typedef struct _circular_buffer {
   char *buffer;
-  int  wp;
-  int rp;
-  int numelem;
-  int elemsize; /* in number of bytes */
+  unsigned int mask;   /* storage size - 1 */
+  int  capacity;       /* max number of items held */
+  int  elemsize;       /* in number of bytes */
+  /* keep the two positions on cache lines of their own */
+  char pad0[CB_CACHE_LINE];
+  volatile unsigned int wp;
+  char pad1[CB_CACHE_LINE - sizeof(unsigned int)];
+  volatile unsigned int rp;
+  unsigned int flushed;          /* flushes applied, reader side */
+  char pad2[CB_CACHE_LINE - 2*sizeof(unsigned int)];
+  volatile unsigned int discard; /* discard items before this position */
+  volatile unsigned int flushes; /* flushes asked for */
+  char pad3[CB_CACHE_LINE - 2*sizeof(unsigned int)];
 } circular_buffer;
 
+#if defined(MSVC)
+#define CB_LOAD(x)      ((unsigned int) InterlockedOr((volatile long *) &(x), 0))
+#define CB_STORE(x, v)  InterlockedExchange((volatile long *) &(x), (long) (v))
+#elif defined(HAVE_ATOMIC_BUILTIN)
+#define CB_LOAD(x)      __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define CB_STORE(x, v)  __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#else
+#define CB_LOAD(x)      (x)
+#define CB_STORE(x, v)  ((x) = (v))
+#endif
+
 void *csoundCreateCircularBuffer(CSOUND *csound, int numelem, int elemsize){
     circular_buffer *p;
+    unsigned int size = 1;
     if ((p = (circular_buffer *)
-         csound->Malloc(csound, sizeof(circular_buffer))) == NULL) {
+         csound->Calloc(csound, sizeof(circular_buffer))) == NULL) {
       return NULL;
     }
-    p->numelem = numelem;
+    while ((int) size < numelem) size <<= 1;
+    p->mask = size - 1;
+    p->capacity = numelem > 0 ? numelem - 1 : 0;
     p->wp = p->rp = 0;
     p->elemsize = elemsize;
 
-    if ((p->buffer = (char *) csound->Malloc(csound, numelem*elemsize)) == NULL) {
+    if ((p->buffer = (char *) csound->Calloc(csound,
+                                             (size_t) size*elemsize)) == NULL) {
+      csound->Free(csound, p);
       return NULL;
     }
-    memset(p->buffer, 0, numelem*elemsize);
     return (void *)p;
 }
 
-static int checkspace(circular_buffer *p, int writeCheck){
-    int wp = p->wp, rp = p->rp, numelem = p->numelem;
-    if(writeCheck){
-      if (wp > rp) return rp - wp + numelem - 1;
-      else if (wp < rp) return rp - wp - 1;
-      else return numelem - 1;
+/* read position for the reader, after dropping what was flushed */
+static inline unsigned int cb_read_pos(circular_buffer *p){
+    unsigned int rp = p->rp, f = CB_LOAD(p->flushes);
+    if (UNLIKELY(f != p->flushed)) {
+      unsigned int d = CB_LOAD(p->discard);
+      p->flushed = f;
+      if ((int) (d - rp) > 0) {
+        rp = d;
+        CB_STORE(p->rp, rp);
+      }
     }
+    return rp;
+}
+
+/* items ready for reading */
+static inline unsigned int cb_items(circular_buffer *p, unsigned int rp){
+    return CB_LOAD(p->wp) - rp;
+}
+
+/* room for writing */
+static inline unsigned int cb_space(circular_buffer *p, unsigned int wp){
+    return (unsigned int) p->capacity - (wp - CB_LOAD(p->rp));
+}
+
+/* copy n items out from position pos, in at most two blocks */
+static inline void cb_copy_out(circular_buffer *p, unsigned int pos,
+                               char *out, unsigned int n){
+    size_t elemsize = p->elemsize;
+    unsigned int i = pos & p->mask, first = p->mask + 1 - i;
+    if (n <= first)
+      memcpy(out, p->buffer + i*elemsize, n*elemsize);
     else {
-      if (wp > rp) return wp - rp;
-      else if (wp < rp) return wp - rp + numelem;
-      else return 0;
+      memcpy(out, p->buffer + i*elemsize, first*elemsize);
+      memcpy(out + first*elemsize, p->buffer, (n - first)*elemsize);
     }
 }
 
 int csoundReadCircularBuffer(CSOUND *csound, void *p, void *out, int items)
 {
+    circular_buffer *cb = (circular_buffer *) p;
+    unsigned int rp, remaining;
     IGN(csound);
-    if (p == NULL) return 0;
-    {
-      int remaining;
-      int itemsread, numelem = ((circular_buffer *)p)->numelem;
-      int elemsize = ((circular_buffer *)p)->elemsize;
-      int i=0, rp = ((circular_buffer *)p)->rp;
-      char *buffer = ((circular_buffer *)p)->buffer;
-      if ((remaining = checkspace(p, 0)) == 0) {
-        return 0;
-      }
-      itemsread = items > remaining ? remaining : items;
-      for (i=0; i < itemsread; i++){
-        memcpy((char *) out + (i * elemsize),
-               &(buffer[elemsize * rp++]),  elemsize);
-        if (rp == numelem) {
-          rp = 0;
-        }
-      }
-#if defined(MSVC)
-      InterlockedExchange(&((circular_buffer *)p)->rp, rp);
-#elif defined(HAVE_ATOMIC_BUILTIN)
-      __atomic_exchange_n(&((circular_buffer *)p)->rp,rp, __ATOMIC_SEQ_CST);
-#else
-      ((circular_buffer *)p)->rp = rp;
-#endif
-      return itemsread;
+    if (cb == NULL || items <= 0) return 0;
+    rp = cb_read_pos(cb);
+    if ((remaining = cb_items(cb, rp)) == 0) {
+      return 0;
     }
+    if ((unsigned int) items > remaining) items = remaining;
+    cb_copy_out(cb, rp, (char *) out, items);
+    CB_STORE(cb->rp, rp + items);
+    return items;
 }
 
 int csoundPeekCircularBuffer(CSOUND *csound, void *p, void *out, int items)
 {
+    circular_buffer *cb = (circular_buffer *) p;
+    unsigned int rp, remaining;
     IGN(csound);
-    if (p == NULL) return 0;
-    int remaining;
-    int itemsread, numelem = ((circular_buffer *)p)->numelem;
-    int elemsize = ((circular_buffer *)p)->elemsize;
-    int i=0, rp = ((circular_buffer *)p)->rp;
-    char *buffer = ((circular_buffer *)p)->buffer;
-    if ((remaining = checkspace(p, 0)) == 0) {
-        return 0;
-    }
-    itemsread = items > remaining ? remaining : items;
-    for(i=0; i < itemsread; i++){
-        memcpy((char *) out + (i * elemsize),
-               &(buffer[elemsize * rp++]),  elemsize);
-        if (rp == numelem) {
-            rp = 0;
-        }
+    if (cb == NULL || items <= 0) return 0;
+    rp = cb_read_pos(cb);
+    if ((remaining = cb_items(cb, rp)) == 0) {
+      return 0;
     }
-    return itemsread;
+    if ((unsigned int) items > remaining) items = remaining;
+    cb_copy_out(cb, rp, (char *) out, items);
+    return items;
 }
 
 void csoundFlushCircularBuffer(CSOUND *csound, void *p)
 {
+    circular_buffer *cb = (circular_buffer *) p;
     IGN(csound);
-    if (p == NULL) return;
-    int remaining;
-    int itemsread, numelem = ((circular_buffer *)p)->numelem;
-    int i=0, rp = ((circular_buffer *)p)->rp;
-    //MYFLT *buffer = ((circular_buffer *)p)->buffer;
-    if ((remaining = checkspace(p, 0)) == 0) {
-        return;
-    }
-    itemsread = numelem > remaining ? remaining: numelem;
-    for (i=0; i < itemsread; i++){
-        rp++;
-        if(rp == numelem) rp = 0;
-    }
-#if defined(MSVC)
-      InterlockedExchange(&((circular_buffer *)p)->rp, rp);
-#elif defined(HAVE_ATOMIC_BUILTIN)
-      __atomic_store_n(&((circular_buffer *)p)->rp,rp, __ATOMIC_SEQ_CST);
-#else
-      ((circular_buffer *)p)->rp = rp;
-#endif
+    if (cb == NULL) return;
+    CB_STORE(cb->discard, CB_LOAD(cb->wp));
+    CB_STORE(cb->flushes, cb->flushes + 1);
 }
 
 
 int csoundWriteCircularBuffer(CSOUND *csound, void *p, const void *in, int items)
 {
+    circular_buffer *cb = (circular_buffer *) p;
+    unsigned int wp, remaining, i, first;
+    size_t elemsize;
     IGN(csound);
-    if (p == NULL) return 0;
-    int remaining;
-    int itemswrite, numelem = ((circular_buffer *)p)->numelem;
-    int elemsize = ((circular_buffer *)p)->elemsize;
-    int i=0, wp = ((circular_buffer *)p)->wp;
-    char *buffer = ((circular_buffer *)p)->buffer;
-    if ((remaining = checkspace(p, 1)) == 0) {
-        return 0;
+    if (cb == NULL || items <= 0) return 0;
+    wp = cb->wp;
+    if ((remaining = cb_space(cb, wp)) == 0) {
+      return 0;
     }
-    itemswrite = items > remaining ? remaining : items;
-    for(i=0; i < itemswrite; i++){
-        memcpy(&(buffer[elemsize * wp++]),
-                ((char *) in) + (i * elemsize),  elemsize);
-        if(wp == numelem) wp = 0;
+    if ((unsigned int) items > remaining) items = remaining;
+    elemsize = cb->elemsize;
+    i = wp & cb->mask;
+    first = cb->mask + 1 - i;
+    if ((unsigned int) items <= first)
+      memcpy(cb->buffer + i*elemsize, in, items*elemsize);
+    else {
+      memcpy(cb->buffer + i*elemsize, in, first*elemsize);
+      memcpy(cb->buffer, (const char *) in + first*elemsize,
+             (items - first)*elemsize);
     }
-#if defined(MSVC)
-      InterlockedExchange(&((circular_buffer *)p)->wp, wp);
-#elif defined(HAVE_ATOMIC_BUILTIN)
-      __atomic_store_n(&((circular_buffer *)p)->wp,wp, __ATOMIC_SEQ_CST);
-#else
-      ((circular_buffer *)p)->wp = wp;
-#endif
-    return itemswrite;
+    CB_STORE(cb->wp, wp + items);
+    return items;
+}
+
+/* zero-copy access: the reserve calls return a pointer to up to items
+   contiguous elements inside the buffer, and the commit calls release
+   them once the caller is done */
+
+int csoundReserveReadCircularBuffer(CSOUND *csound, void *p,
+                                    void **data, int items)
+{
+    circular_buffer *cb = (circular_buffer *) p;
+    unsigned int rp, n, i;
+    IGN(csound);
+    *data = NULL;
+    if (cb == NULL || items <= 0) return 0;
+    rp = cb_read_pos(cb);
+    i = rp & cb->mask;
+    n = cb_items(cb, rp);
+    if (n > cb->mask + 1 - i) n = cb->mask + 1 - i;
+    if ((unsigned int) items > n) items = n;
+    if (items > 0) *data = cb->buffer + (size_t) i*cb->elemsize;
+    return items;
+}
+
+void csoundCommitReadCircularBuffer(CSOUND *csound, void *p, int items)
+{
+    circular_buffer *cb = (circular_buffer *) p;
+    IGN(csound);
+    if (cb == NULL || items <= 0) return;
+    CB_STORE(cb->rp, cb->rp + items);
+}
+
+int csoundReserveWriteCircularBuffer(CSOUND *csound, void *p,
+                                     void **data, int items)
+{
+    circular_buffer *cb = (circular_buffer *) p;
+    unsigned int wp, n, i;
+    IGN(csound);
+    *data = NULL;
+    if (cb == NULL || items <= 0) return 0;
+    wp = cb->wp;
+    i = wp & cb->mask;
+    n = cb_space(cb, wp);
+    if (n > cb->mask + 1 - i) n = cb->mask + 1 - i;
+    if ((unsigned int) items > n) items = n;
+    if (items > 0) *data = cb->buffer + (size_t) i*cb->elemsize;
+    return items;
+}
+
+void csoundCommitWriteCircularBuffer(CSOUND *csound, void *p, int items)
+{
+    circular_buffer *cb = (circular_buffer *) p;
+    IGN(csound);
+    if (cb == NULL || items <= 0) return;
+    CB_STORE(cb->wp, cb->wp + items);
 }
 
 void csoundDestroyCircularBuffer(CSOUND *csound, void *p){
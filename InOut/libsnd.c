@@ -158,6 +158,231 @@ static void spoutsf_noscale(CSOUND *csound)
     csound->libsndStatics.nframes = nframes;
 }
 
+/* Soundfile output can be handed to a writer thread (--write-buffers=N),
+   so that a slow disk stalls that thread rather than the performance.
+   The buffers form a single producer, single consumer ring: spoutsf
+   fills buf[wp % nbufs] in place, sfwrite_block publishes it and moves
+   on to the next one, waiting only if the writer is nbufs - 1 buffers
+   behind.  The positions are atomic; the mutex is only held to sleep on,
+   or to signal, one of the two conditions, and to update or copy the
+   stats, which both threads write.  Header rewrites (-R) are limited to
+   one per SFHDR_INTERVAL seconds on both paths. */
+
+#define SFHDR_INTERVAL  0.25
+
+typedef struct SFWRITER_ {
+    CSOUND  *csound;
+    void    *thread;
+    void    *lock;
+    void    *wake, *space;      /* buffer queued / buffer written */
+    MYFLT   **buf;
+    int     *len;               /* bytes queued in each buffer */
+    int     nbufs;
+    volatile long wp, rp;       /* buffers queued, buffers written */
+    volatile long quit, err;
+    int     errn, errput;
+    double  lasthdr;
+    CS_SFWRITE_STATS stats;
+} SFWRITER;
+
+static void sf_rewrite_header(CSOUND *csound, double *last, uint32_t *cnt)
+{
+    double  now = csound->GetRealTime(csound->csRtClock);
+    if (now - *last >= SFHDR_INTERVAL || now < *last) {
+      rewriteheader((void *) STA(outfile));
+      *last = now;
+      (*cnt)++;
+    }
+}
+
+static uintptr_t sfwriter_thread(void *p)
+{
+    SFWRITER *w = (SFWRITER *) p;
+    CSOUND   *csound = w->csound;
+    long     rp = w->rp;
+
+    while (1) {
+      int     slot, nbytes, n;
+      double  t0, t1 = 0.0;
+      uint32_t hdr = 0;
+      if (rp == ATOMIC_GET(w->wp)) {
+        int quit;
+        csoundLockMutex(w->lock);
+        while (rp == ATOMIC_GET(w->wp) && !ATOMIC_GET(w->quit))
+          csoundCondWait(w->wake, w->lock);
+        /* quit is only set after the last buffer was queued */
+        quit = (rp == ATOMIC_GET(w->wp));
+        csoundUnlockMutex(w->lock);
+        if (quit)
+          break;
+      }
+      slot = (int) (rp % w->nbufs);
+      nbytes = w->len[slot];
+      if (!w->err) {
+        t0 = csound->GetRealTime(csound->csRtClock);
+        n = (int) sf_write_MYFLT(STA(outfile), w->buf[slot],
+                                 nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
+        if (UNLIKELY(n < nbytes)) {
+          /* reported from the performance thread */
+          w->errn = n; w->errput = nbytes;
+          ATOMIC_SET(w->err, 1);
+        }
+        else if (UNLIKELY(csound->oparms->rewrt_hdr))
+          sf_rewrite_header(csound, &w->lasthdr, &hdr);
+        t1 = csound->GetRealTime(csound->csRtClock) - t0;
+      }
+      ATOMIC_SET(w->rp, ++rp);
+      csoundLockMutex(w->lock);
+      if (t1 > w->stats.max_write_time)
+        w->stats.max_write_time = t1;
+      w->stats.header_rewrites += hdr;
+      w->stats.blocks_written++;
+      csoundCondSignal(w->space);
+      csoundUnlockMutex(w->lock);
+    }
+    return 0;
+}
+
+static void sfwriter_free(CSOUND *csound, SFWRITER *w)
+{
+    int i;
+    /* STA(outbuf) is left in place for writing synchronously */
+    for (i = 0; i < w->nbufs; i++)
+      if (w->buf[i] != STA(outbuf))
+        csound->Free(csound, w->buf[i]);
+    if (w->lock != NULL) csoundDestroyMutex(w->lock);
+    if (w->wake != NULL) csoundDestroyCondVar(w->wake);
+    if (w->space != NULL) csoundDestroyCondVar(w->space);
+    csound->Free(csound, w->buf);
+    csound->Free(csound, w->len);
+    csound->Free(csound, w);
+}
+
+static void sfwriter_start(CSOUND *csound, int nbufs)
+{
+    SFWRITER *w;
+    int      i;
+
+    w = (SFWRITER *) csound->Calloc(csound, sizeof(SFWRITER));
+    w->csound = csound;
+    w->nbufs = nbufs;
+    w->buf = (MYFLT **) csound->Malloc(csound, nbufs * sizeof(MYFLT *));
+    w->len = (int *) csound->Calloc(csound, nbufs * sizeof(int));
+    /* the buffer sfopenout made is the first of the ring */
+    w->buf[0] = (MYFLT *) STA(outbuf);
+    for (i = 1; i < nbufs; i++)
+      w->buf[i] = (MYFLT *) csound->Malloc(csound, STA(outbufsiz));
+    w->stats.buffers = (uint32_t) nbufs;
+    w->lock = csoundCreateMutex(0);
+    w->wake = csoundCreateCondVar();
+    w->space = csoundCreateCondVar();
+    if (LIKELY(w->lock != NULL && w->wake != NULL && w->space != NULL))
+      w->thread = csoundCreateThread(sfwriter_thread, (void *) w);
+    if (UNLIKELY(w->thread == NULL)) {
+      csound->Warning(csound, Str("could not start soundfile writer thread, "
+                                  "writing synchronously"));
+      sfwriter_free(csound, w);
+      return;
+    }
+    STA(writer) = w;
+}
+
+/* wait for everything queued to reach the file, then end the thread */
+static void sfwriter_stop(CSOUND *csound)
+{
+    SFWRITER *w = (SFWRITER *) STA(writer);
+    if (w == NULL)
+      return;
+    csoundLockMutex(w->lock);
+    ATOMIC_SET(w->quit, 1);
+    csoundCondSignal(w->wake);
+    csoundUnlockMutex(w->lock);
+    csoundJoinThread(w->thread);
+    w->thread = NULL;
+    if (UNLIKELY(w->err))
+      csound->ErrorMsg(csound,
+                       Str("soundfile write returned bytecount of %d, not %d"),
+                       w->errn, w->errput);
+    STA(writer) = NULL;
+    STA(wstats) = w->stats;
+    STA(wstats).depth = 0;
+    sfwriter_free(csound, w);
+}
+
+/* queue the buffer spoutsf just filled, or write it if there is no
+   writer thread */
+static void sfwrite_block(CSOUND *csound, const MYFLT *outbuf, int nbytes)
+{
+    SFWRITER *w = (SFWRITER *) STA(writer);
+    long     wp, depth;
+    int      slot;
+
+    if (w == NULL) {
+      double t0 = csound->GetRealTime(csound->csRtClock);
+      int n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
+                                   nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
+      if (UNLIKELY(n < nbytes))
+        sndwrterr(csound, n, nbytes);
+      if (UNLIKELY(csound->oparms->rewrt_hdr))
+        sf_rewrite_header(csound, &STA(lasthdr),
+                          &STA(wstats).header_rewrites);
+      t0 = csound->GetRealTime(csound->csRtClock) - t0;
+      if (t0 > STA(wstats).max_write_time)
+        STA(wstats).max_write_time = t0;
+      STA(wstats).blocks_written++;
+      return;
+    }
+    if (UNLIKELY(ATOMIC_GET(w->err))) {
+      int errn = w->errn, errput = w->errput;
+      sfwriter_stop(csound);
+      sndwrterr(csound, errn, errput);
+      return;
+    }
+    wp = w->wp;
+    slot = (int) (wp % w->nbufs);
+    if (UNLIKELY(outbuf != w->buf[slot]))
+      memcpy(w->buf[slot], outbuf, nbytes);
+    w->len[slot] = nbytes;
+    ATOMIC_SET(w->wp, ++wp);
+    csoundLockMutex(w->lock);
+    csoundCondSignal(w->wake);
+    depth = wp - ATOMIC_GET(w->rp);
+    w->stats.depth = (uint32_t) depth;
+    if ((uint32_t) depth > w->stats.max_depth)
+      w->stats.max_depth = (uint32_t) depth;
+    /* the next buffer to fill must not still be queued */
+    if (UNLIKELY(depth >= w->nbufs)) {
+      double t0 = csound->GetRealTime(csound->csRtClock);
+      w->stats.stalls++;
+      while (wp - ATOMIC_GET(w->rp) >= w->nbufs)
+        csoundCondWait(w->space, w->lock);
+      w->stats.stall_time += csound->GetRealTime(csound->csRtClock) - t0;
+    }
+    csoundUnlockMutex(w->lock);
+    STA(outbuf) = w->buf[wp % w->nbufs];
+}
+
+/* the API lock keeps the performance from stopping the writer, or
+   writing synchronously, while the stats are copied */
+PUBLIC int csoundGetSoundfileWriteStats(CSOUND *csound, CS_SFWRITE_STATS *st)
+{
+    SFWRITER *w;
+    if (UNLIKELY(st == NULL))
+      return CSOUND_ERROR;
+    csoundLockMutex(csound->API_lock);
+    w = (SFWRITER *) STA(writer);
+    if (w != NULL) {
+      csoundLockMutex(w->lock);
+      *st = w->stats;
+      csoundUnlockMutex(w->lock);
+      st->depth = (uint32_t) (ATOMIC_GET(w->wp) - ATOMIC_GET(w->rp));
+    }
+    else
+      *st = STA(wstats);
+    csoundUnlockMutex(csound->API_lock);
+    return CSOUND_SUCCESS;
+}
+
 /* diskfile write option for audtran's */
 /*      assigned during sfopenout()    */
 
@@ -168,12 +393,7 @@ static void writesf(CSOUND *csound, const MYFLT *outbuf, int nbytes)
 
     if (UNLIKELY(STA(outfile) == NULL))
       return;
-    n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
-                             nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
-    if (UNLIKELY(n < nbytes))
-      sndwrterr(csound, n, nbytes);
-    if (UNLIKELY(O->rewrt_hdr))
-      rewriteheader((void *)STA(outfile));
+    sfwrite_block(csound, outbuf, nbytes);
     switch (O->heartbeat) {
       case 1:
         csound->MessageS(csound, CSOUNDMSG_REALTIME,
@@ -222,12 +442,7 @@ static void writesf_dither_16(CSOUND *csound, const MYFLT *outbuf, int nbytes)
       buf[n] += result;
     }
     STA(dither) = dith;
-    n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
-                             nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
-    if (UNLIKELY(n < nbytes))
-      sndwrterr(csound, n, nbytes);
-    if (UNLIKELY(O->rewrt_hdr))
-      rewriteheader(STA(outfile));
+    sfwrite_block(csound, outbuf, nbytes);
     switch (O->heartbeat) {
       case 1:
         csound->MessageS(csound, CSOUNDMSG_REALTIME,
@@ -276,12 +491,7 @@ static void writesf_dither_8(CSOUND *csound, const MYFLT *outbuf, int nbytes)
       buf[n] += result;
     }
     STA(dither) = dith;
-    n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
-                             nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
-    if (UNLIKELY(n < nbytes))
-      sndwrterr(csound, n, nbytes);
-    if (UNLIKELY(O->rewrt_hdr))
-      rewriteheader(STA(outfile));
+    sfwrite_block(csound, outbuf, nbytes);
     switch (O->heartbeat) {
       case 1:
         csound->MessageS(csound, CSOUNDMSG_REALTIME,
@@ -328,12 +538,7 @@ static void writesf_dither_u16(CSOUND *csound, const MYFLT *outbuf, int nbytes)
       buf[n] += result;
     }
     STA(dither) = dith;
-    n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
-                             nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
-    if (UNLIKELY(n < nbytes))
-      sndwrterr(csound, n, nbytes);
-    if (UNLIKELY(O->rewrt_hdr))
-      rewriteheader(STA(outfile));
+    sfwrite_block(csound, outbuf, nbytes);
     switch (O->heartbeat) {
       case 1:
         csound->MessageS(csound, CSOUNDMSG_REALTIME,
@@ -380,12 +585,7 @@ static void writesf_dither_u8(CSOUND *csound, const MYFLT *outbuf, int nbytes)
       buf[n] += result;
     }
     STA(dither) = dith;
-    n = (int) sf_write_MYFLT(STA(outfile), (MYFLT*) outbuf,
-                             nbytes / sizeof(MYFLT)) * (int) sizeof(MYFLT);
-    if (UNLIKELY(n < nbytes))
-      sndwrterr(csound, n, nbytes);
-    if (UNLIKELY(O->rewrt_hdr))
-      rewriteheader(STA(outfile));
+    sfwrite_block(csound, outbuf, nbytes);
     switch (O->heartbeat) {
       case 1:
         csound->MessageS(csound, CSOUNDMSG_REALTIME,
@@ -866,6 +1066,11 @@ void sfopenout(CSOUND *csound)                  /* init for sound out       */
     /* calc outbuf size & alloc bufspace */
     STA(outbufsiz) = O->outbufsamps * sizeof(MYFLT);
     STA(outbufp)   = STA(outbuf) = csound->Malloc(csound, STA(outbufsiz));
+    memset(&STA(wstats), 0, sizeof(CS_SFWRITE_STATS));
+    if (STA(outfile) != NULL && O->write_buffers > 1) {
+      sfwriter_start(csound, O->write_buffers);
+      STA(outbufp) = STA(outbuf);
+    }
     if (STA(pipdevout) == 2)
       csound->Message(csound,
                       Str("writing %d sample blks of %lu-bit floats to %s\n"),
@@ -921,6 +1126,7 @@ void sfcloseout(CSOUND *csound)
       csound->nrecs++;
       csound->audtran(csound, STA(outbuf), nb);
     }
+    sfwriter_stop(csound);
     if (STA(pipdevout) == 2 && (!STA(isfopen) || STA(pipdevin) != 2)) {
       /* close only if not open for input too */
       csound->rtclose_callback(csound);
@@ -5971,9 +5971,9 @@ extern "C" {
 const OENTRY widgetOpcodes_[] = {
   { (char*)"FLslider",    S(FLSLIDER), 0, 1,  (char*)"ki",   (char*)"Siijjjjjjj",
     (SUBR) fl_slider,     (SUBR) NULL,    (SUBR) NULL },
-  { (char*)"FLslidBnk",   S(FLSLIDERBANK), 0, 1, (char*)"", (char*)"Siooooooooo",
+  { (char*)"FLslidBnk",   S(FLSLIDERBANK), TW, 1, (char*)"", (char*)"Siooooooooo",
     (SUBR) fl_slider_bank_S, (SUBR) NULL,   (SUBR) NULL },
-  { (char*)"FLslidBnk.i",   S(FLSLIDERBANK), 0, 1, (char*)"", (char*)"iiooooooooo",
+  { (char*)"FLslidBnk.i",   S(FLSLIDERBANK), TW, 1, (char*)"", (char*)"iiooooooooo",
     (SUBR) fl_slider_bank, (SUBR) NULL,   (SUBR) NULL },
   { (char*)"FLknob",      S(FLKNOB), 0, 1,  (char*)"ki",   (char*)"Siijjjjjjo",
     (SUBR) fl_knob,       (SUBR) NULL,     (SUBR) NULL },
@@ -6067,7 +6067,7 @@ const OENTRY widgetOpcodes_[] = {
     (SUBR) EndGroup,                (SUBR) NULL,              (SUBR) NULL },
   { (char*)"FLgroup_end", S(FLGROUPEND),   0, 1,  (char*)"",     (char*)"",
     (SUBR) EndGroup,                (SUBR) NULL,              (SUBR) NULL },
-  { (char*)"FLsetsnap",   S(FLSETSNAP),    0, 1,  (char*)"ii",   (char*)"ioo",
+  { (char*)"FLsetsnap",   S(FLSETSNAP),    TW, 1,  (char*)"ii",   (char*)"ioo",
     (SUBR) set_snap,                (SUBR) NULL,              (SUBR) NULL },
   { (char*)"FLsetSnapGroup", S(FLSETSNAPGROUP), 0, 1,   (char*)"", (char*)"i",
     (SUBR)fl_setSnapGroup,  (SUBR) NULL,              (SUBR) NULL },
@@ -6089,33 +6089,33 @@ const OENTRY widgetOpcodes_[] = {
     (SUBR) fl_close_button,               (SUBR) NULL,              (SUBR) NULL },
   { (char*)"FLexecButton",    S(FLEXECBUTTON), 0, 1,  (char*)"i", (char*)"Siiii",
     (SUBR) fl_exec_button,               (SUBR) NULL,              (SUBR) NULL },
-  { (char*)"FLkeyIn",    S(FLKEYIN),       0, 3,  (char*)"k",    (char*)"o",
+  { (char*)"FLkeyIn",    S(FLKEYIN),       TW, 3,  (char*)"k",    (char*)"o",
     (SUBR)fl_keyin_set,             (SUBR)fl_keyin,           (SUBR) NULL  },
   { (char*)"FLxyin",      S(FLXYIN), 0, 3,  (char*)"kkk",(char*)"iiiiiiiioooo",
     (SUBR)FLxyin_set,               (SUBR)FLxyin,            (SUBR) NULL  },
   { (char*)"FLmouse",     S(FLMOUSE),             0, 3,  (char*)"kkkkk",(char*)"o",
     (SUBR)fl_mouse_set,             (SUBR)fl_mouse,           (SUBR) NULL  },
-  { (char*)"FLvslidBnk",  S(FLSLIDERBANK), 0, 1,  (char*)"",  (char*)"Siooooooooo",
+  { (char*)"FLvslidBnk",  S(FLSLIDERBANK), TW, 1,  (char*)"",  (char*)"Siooooooooo",
     (SUBR)fl_vertical_slider_bank_S,   (SUBR) NULL,             (SUBR) NULL  },
-   { (char*)"FLvslidBnk.i", S(FLSLIDERBANK), 0, 1, (char*)"", (char*)"iiooooooooo",
+   { (char*)"FLvslidBnk.i", S(FLSLIDERBANK), TW, 1, (char*)"", (char*)"iiooooooooo",
     (SUBR)fl_vertical_slider_bank,   (SUBR) NULL,             (SUBR) NULL  },
-  { (char*)"FLslidBnk2",  S(FLSLIDERBANK2),0, 1,  (char*)"",  (char*)"Siiiooooo",
+  { (char*)"FLslidBnk2",  S(FLSLIDERBANK2),TW, 1,  (char*)"",  (char*)"Siiiooooo",
     (SUBR)fl_slider_bank2_S ,          (SUBR) NULL,             (SUBR) NULL  },
-    { (char*)"FLslidBnk2.i", S(FLSLIDERBANK2),0, 1, (char*)"", (char*)"iiiiooooo",
+    { (char*)"FLslidBnk2.i", S(FLSLIDERBANK2),TW, 1, (char*)"", (char*)"iiiiooooo",
     (SUBR)fl_slider_bank2 ,          (SUBR) NULL,             (SUBR) NULL  },
-  { (char*)"FLvslidBnk2", S(FLSLIDERBANK2),0, 1,  (char*)"",  (char*)"Siiiooooo",
+  { (char*)"FLvslidBnk2", S(FLSLIDERBANK2),TW, 1,  (char*)"",  (char*)"Siiiooooo",
     (SUBR)fl_vertical_slider_bank2_S,  (SUBR) NULL,             (SUBR) NULL  },
-    { (char*)"FLvslidBnk2.i", S(FLSLIDERBANK2),0, 1, (char*)"", (char*)"iiiiooooo",
+    { (char*)"FLvslidBnk2.i", S(FLSLIDERBANK2),TW, 1, (char*)"", (char*)"iiiiooooo",
     (SUBR)fl_vertical_slider_bank2,  (SUBR) NULL,             (SUBR) NULL  },
   { (char*)"FLslidBnkGetHandle",S(FLSLDBNK_GETHANDLE),0, 1, (char*)"i", (char*)"",
     (SUBR)fl_slider_bank_getHandle,  (SUBR) NULL,             (SUBR) NULL  },
-  { (char*)"FLslidBnkSet",S(FLSLDBNK_SET), 0, 1,  (char*)"",  (char*)"iiooo",
+  { (char*)"FLslidBnkSet",S(FLSLDBNK_SET), TW, 1,  (char*)"",  (char*)"iiooo",
     (SUBR)fl_slider_bank_setVal,     (SUBR) NULL,             (SUBR) NULL  },
-  { (char*)"FLslidBnkSetk",  S(FLSLDBNK2_SETK), 0, 3,  (char*)"",  (char*)"kiiooo",
+  { (char*)"FLslidBnkSetk",  S(FLSLDBNK2_SETK), TW, 3,  (char*)"",  (char*)"kiiooo",
     (SUBR)fl_slider_bank_setVal_k_set,(SUBR)fl_slider_bank_setVal_k,(SUBR) NULL },
-  { (char*)"FLslidBnk2Set",  S(FLSLDBNK_SET), 0, 1,  (char*)"",  (char*)"iiooo",
+  { (char*)"FLslidBnk2Set",  S(FLSLDBNK_SET), TW, 1,  (char*)"",  (char*)"iiooo",
     (SUBR)fl_slider_bank2_setVal,    (SUBR) NULL,             (SUBR) NULL  },
-  { (char*)"FLslidBnk2Setk", S(FLSLDBNK2_SETK), 0, 3,  (char*)"",  (char*)"kiiooo",
+  { (char*)"FLslidBnk2Setk", S(FLSLDBNK2_SETK), TW, 3,  (char*)"",  (char*)"kiiooo",
     (SUBR)fl_slider_bank2_setVal_k_set, (SUBR)fl_slider_bank2_setVal_k,
     (SUBR) NULL },
   { (char*)"FLhvsBox",    S(FL_HVSBOX),    0, 1,  (char*)"i",    (char*)"iiiiiio",
@@ -541,6 +541,172 @@ int32_t divaa(CSOUND *csound, AOP *p)
     return OK;
 }
 
+/* Fused arithmetic.  fuse_init turns the postfix program into a node
+   list (children before parents) and folds the init-time nodes; each
+   k-cycle the k-rate nodes are updated, then the a-rate nodes run over
+   blocks of FUSE_CHUNK samples, so the intermediate results stay in a
+   small buffer on the stack instead of going through a-rate variables. */
+
+static inline MYFLT fuse_op(char op, MYFLT a, MYFLT b)
+{
+    switch (op) {
+    case '+': return a + b;
+    case '-': return a - b;
+    case '*': return a * b;
+    case '/': return a / b;
+    default:  return -b;            /* 'n' */
+    }
+}
+
+int32_t fuse_init(CSOUND *csound, FUSE *p)
+{
+    const char *s = p->prog->data;
+    uint8_t  stack[FUSE_MAXNODES];
+    int32_t  sp = 0, n, na = 0, nargs = (int32_t) p->INOCOUNT - 1;
+
+    for (n = 0; *s != '\0'; s++, n++) {
+      if (UNLIKELY(n >= FUSE_MAXNODES))
+        return csound->InitError(csound, Str("fused expression too long"));
+      p->op[n] = *s;
+      switch (*s) {
+      case 'a':
+      case 'k':
+      case 'i':
+        if (UNLIKELY(na >= nargs))
+          return csound->InitError(csound,
+                                   Str("fused expression: missing argument"));
+        p->arg[n] = (uint8_t) na++;
+        p->kind[n] = (*s == 'a' ? 2 : *s == 'k' ? 1 : 0);
+        if (*s == 'i')
+          p->val[n] = *p->args[p->arg[n]];
+        break;
+      case 'n':
+        if (UNLIKELY(sp < 1))
+          goto err;
+        p->lft[n] = p->rgt[n] = stack[--sp];
+        p->kind[n] = p->kind[p->rgt[n]];
+        break;
+      case '+':
+      case '-':
+      case '*':
+      case '/':
+        if (UNLIKELY(sp < 2))
+          goto err;
+        p->rgt[n] = stack[--sp];
+        p->lft[n] = stack[--sp];
+        p->kind[n] = (p->kind[p->lft[n]] > p->kind[p->rgt[n]] ?
+                      p->kind[p->lft[n]] : p->kind[p->rgt[n]]);
+        break;
+      default:
+        goto err;
+      }
+      if (p->kind[n] == 0 && *s != 'i') {
+        if (UNLIKELY(*s == '/' && p->val[p->rgt[n]] == FL(0.0)))
+          csound->Warning(csound, Str("Division by zero"));
+        p->val[n] = fuse_op(*s, p->val[p->lft[n]], p->val[p->rgt[n]]);
+      }
+      stack[sp++] = (uint8_t) n;
+    }
+    if (UNLIKELY(sp != 1 || na != nargs || p->kind[n - 1] != 2))
+      goto err;
+    p->nnodes = n;
+    return OK;
+ err:
+    return csound->InitError(csound, Str("invalid fused expression \"%s\""),
+                             p->prog->data);
+}
+
+/* operand of node i for the block starting at sample n */
+#define FUSE_VEC(i) (p->op[i] == 'a' ? p->args[p->arg[i]] + n : v[i])
+
+int32_t fuse_perf(CSOUND *csound, FUSE *p)
+{
+    MYFLT    v[FUSE_MAXNODES][FUSE_CHUNK];
+    MYFLT    *r = p->r;
+    uint32_t offset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    uint32_t n, j, len, nsmps = CS_KSMPS;
+    int32_t  i, last = p->nnodes - 1, zero = 0;
+
+    for (i = 0; i < last; i++) {
+      if (p->kind[i] != 1)
+        continue;
+      if (p->op[i] == 'k')
+        p->val[i] = *p->args[p->arg[i]];
+      else {
+        zero |= (p->op[i] == '/' && p->val[p->rgt[i]] == FL(0.0));
+        p->val[i] = fuse_op(p->op[i], p->val[p->lft[i]], p->val[p->rgt[i]]);
+      }
+    }
+    if (UNLIKELY(offset)) memset(r, '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      memset(&r[nsmps], '\0', early*sizeof(MYFLT));
+    }
+    for (n = offset; n < nsmps; n += len) {
+      len = (nsmps - n < FUSE_CHUNK ? nsmps - n : FUSE_CHUNK);
+      for (i = 0; i <= last; i++) {
+        MYFLT   *d, *a, *b, sa, sb;
+        char    op = p->op[i];
+        int32_t l = p->lft[i], rt = p->rgt[i];
+
+        if (p->kind[i] != 2 || op == 'a')
+          continue;
+        d = (i == last ? r + n : v[i]);
+        if (op == 'n') {
+          a = FUSE_VEC(rt);
+          for (j = 0; j < len; j++)
+            d[j] = -a[j];
+        }
+        else if (p->kind[l] == 2 && p->kind[rt] == 2) {
+          a = FUSE_VEC(l);
+          b = FUSE_VEC(rt);
+          switch (op) {
+          case '+': for (j = 0; j < len; j++) d[j] = a[j] + b[j]; break;
+          case '-': for (j = 0; j < len; j++) d[j] = a[j] - b[j]; break;
+          case '*': for (j = 0; j < len; j++) d[j] = a[j] * b[j]; break;
+          default:
+            for (j = 0; j < len; j++) {
+              zero |= (b[j] == FL(0.0));
+              d[j] = a[j] / b[j];
+            }
+          }
+        }
+        else if (p->kind[l] == 2) {
+          a = FUSE_VEC(l);
+          sb = p->val[rt];
+          switch (op) {
+          case '+': for (j = 0; j < len; j++) d[j] = a[j] + sb; break;
+          case '-': for (j = 0; j < len; j++) d[j] = a[j] - sb; break;
+          case '*': for (j = 0; j < len; j++) d[j] = a[j] * sb; break;
+          default:
+            zero |= (sb == FL(0.0));
+            for (j = 0; j < len; j++) d[j] = a[j] / sb;
+          }
+        }
+        else {
+          sa = p->val[l];
+          b = FUSE_VEC(rt);
+          switch (op) {
+          case '+': for (j = 0; j < len; j++) d[j] = sa + b[j]; break;
+          case '-': for (j = 0; j < len; j++) d[j] = sa - b[j]; break;
+          case '*': for (j = 0; j < len; j++) d[j] = sa * b[j]; break;
+          default:
+            for (j = 0; j < len; j++) {
+              zero |= (b[j] == FL(0.0));
+              d[j] = sa / b[j];
+            }
+          }
+        }
+      }
+    }
+    if (UNLIKELY(zero))
+      csound->Warning(csound, Str("Division by zero"));
+    return OK;
+}
+
+#undef FUSE_VEC
+
 int32_t divzkk(CSOUND *csound, DIVZ *p)
 {
     IGN(csound);
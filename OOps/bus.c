@@ -419,14 +419,16 @@ static CS_NOINLINE int32_t create_new_channel(CSOUND *csound, const char *name,
 }
 
 
-PUBLIC int32_t csoundGetChannelPtr(CSOUND *csound,
-                                   MYFLT **p, const char *name, int32_t type)
+/* find or create a channel; *err is set to CSOUND_SUCCESS, an error
+   code, or the type of an existing channel of another type */
+static CHNENTRY *get_channel(CSOUND *csound, const char *name,
+                             int32_t type, int32_t *err)
 {
     CHNENTRY  *pp;
 
-    *p = (MYFLT*) NULL;
+    *err = CSOUND_ERROR;
     if (UNLIKELY(name == NULL))
-        return CSOUND_ERROR;
+        return NULL;
     pp = find_channel(csound, name);
     if (!pp) {
         if (create_new_channel(csound, name, type) == CSOUND_SUCCESS) {
@@ -434,13 +436,116 @@ PUBLIC int32_t csoundGetChannelPtr(CSOUND *csound,
         }
     }
     if (pp != NULL) {
-        if ((pp->type ^ type) & CSOUND_CHANNEL_TYPE_MASK)
-            return pp->type;
+        if ((pp->type ^ type) & CSOUND_CHANNEL_TYPE_MASK) {
+            *err = pp->type;
+            return NULL;
+        }
         pp->type |= (type & (CSOUND_INPUT_CHANNEL | CSOUND_OUTPUT_CHANNEL));
-        *p = pp->data;
-        return CSOUND_SUCCESS;
+        *err = CSOUND_SUCCESS;
     }
-    return CSOUND_ERROR;
+    return pp;
+}
+
+PUBLIC int32_t csoundGetChannelPtr(CSOUND *csound,
+                                   MYFLT **p, const char *name, int32_t type)
+{
+    CHNENTRY  *pp;
+    int32_t   err;
+
+    pp = get_channel(csound, name, type, &err);
+    *p = (pp != NULL ? pp->data : (MYFLT*) NULL);
+    return err;
+}
+
+/* Channel handles are the channel entries themselves: they stay put
+   until the channel database is deleted on reset */
+
+PUBLIC void *csoundGetChannelHandle(CSOUND *csound,
+                                    const char *name, int32_t type)
+{
+    int32_t   err;
+    return (void *) get_channel(csound, name, type, &err);
+}
+
+static inline MYFLT chn_load(const MYFLT *fp)
+{
+#if defined(MSVC)
+    union {
+      MYFLT d;
+      MYFLT_INT_TYPE i;
+    } x;
+    x.i = InterlockedExchangeAdd64((MYFLT_INT_TYPE *) fp, 0);
+    return x.d;
+#elif defined(HAVE_ATOMIC_BUILTIN)
+    union {
+        MYFLT d;
+        MYFLT_INT_TYPE i;
+    } x;
+    x.i = __atomic_load_n((MYFLT_INT_TYPE *) fp, __ATOMIC_SEQ_CST);
+    return x.d;
+#else
+    return *fp;
+#endif
+}
+
+static inline void chn_store(MYFLT *fp, MYFLT val, spin_lock_t *lock)
+{
+#if defined(MSVC)
+    union {
+      MYFLT d;
+      MYFLT_INT_TYPE i;
+    } x;
+    x.d = val;
+    InterlockedExchange64((MYFLT_INT_TYPE *) fp, x.i);
+#elif defined(HAVE_ATOMIC_BUILTIN)
+    union {
+        MYFLT d;
+        MYFLT_INT_TYPE i;
+    } x;
+    x.d = val;
+    __atomic_store_n((MYFLT_INT_TYPE *) fp, x.i, __ATOMIC_SEQ_CST);
+#else
+    csoundSpinLock(lock);
+    *fp = val;
+    csoundSpinUnLock(lock);
+#endif
+}
+
+PUBLIC MYFLT csoundGetControlChannelByHandle(CSOUND *csound, void *handle)
+{
+    CHNENTRY  *pp = (CHNENTRY *) handle;
+    IGN(csound);
+    if (UNLIKELY(pp == NULL ||
+                 (pp->type & CSOUND_CHANNEL_TYPE_MASK) != CSOUND_CONTROL_CHANNEL))
+        return FL(0.0);
+    return chn_load(pp->data);
+}
+
+PUBLIC void csoundSetControlChannelByHandle(CSOUND *csound,
+                                            void *handle, MYFLT val)
+{
+    CHNENTRY  *pp = (CHNENTRY *) handle;
+    IGN(csound);
+    if (UNLIKELY(pp == NULL ||
+                 (pp->type & CSOUND_CHANNEL_TYPE_MASK) != CSOUND_CONTROL_CHANNEL))
+        return;
+    chn_store(pp->data, val, &pp->lock);
+}
+
+PUBLIC void csoundGetControlChannels(CSOUND *csound, void *const *handles,
+                                     MYFLT *values, int32_t n)
+{
+    int32_t   i;
+    for (i = 0; i < n; i++)
+        values[i] = csoundGetControlChannelByHandle(csound, handles[i]);
+}
+
+PUBLIC void csoundSetControlChannels(CSOUND *csound, void *const *handles,
+                                     const MYFLT *values, int32_t n)
+{
+    int32_t   i;
+    for (i = 0; i < n; i++)
+        csoundSetControlChannelByHandle(csound, handles[i], values[i]);
 }
 
 PUBLIC int32_t csoundGetChannelDatasize(CSOUND *csound, const char *name){
@@ -646,40 +751,53 @@ static CS_NOINLINE int32_t print_chn_err(void *p, int32_t err)
 }
 
 
+/* a name that failed keeps failing in the same way until reset, as
+   channels are never removed or retyped */
+static CS_NOINLINE int32_t chn_miss(CSOUND *csound, CHNGET *p,
+                                    const char *name, int32_t err)
+{
+    size_t  n;
+    if (name == NULL || err == CSOUND_MEMORY)
+        return err;
+    n = strlen(name) + 1;
+    if (p->miss.auxp == NULL || p->miss.size < n)
+        csound->AuxAlloc(csound, n, &p->miss);
+    memcpy(p->miss.auxp, name, n);
+    p->misserr = err;
+    return err;
+}
+
+/* resolve the channel named by p->iname, keeping the entry found last
+   time for as long as the name does not change, so that k-rate names
+   are not hashed on every cycle; the last name that failed is kept
+   too, so it is not looked up again either */
+static inline int32_t chn_lookup(CSOUND *csound, CHNGET *p, int32_t type)
+{
+    int32_t err = CSOUND_SUCCESS;
+    if (UNLIKELY(p->chn == NULL || strcmp(p->chn->name, p->iname->data))) {
+        const char *name = (const char*) p->iname->data;
+        if (p->miss.auxp != NULL && name != NULL &&
+            !strcmp((char*) p->miss.auxp, name))
+            return p->misserr;
+        p->chn = get_channel(csound, name, type, &err);
+        if (UNLIKELY(p->chn == NULL))
+            return chn_miss(csound, p, name, err);
+        p->lock = &(p->chn->lock);
+    }
+    p->fp = p->chn->data;
+    return err;
+}
+
 /* receive control value from bus at performance time */
 static int32_t chnget_opcode_perf_k(CSOUND* csound, CHNGET* p)
 {
-    if (strncmp(p->chname, p->iname->data, MAX_CHAN_NAME) || !strcmp(p->iname->data, ""))
-    {
-        int32_t err = csoundGetChannelPtr(csound, &(p->fp), (char*) p->iname->data,
-                                          CSOUND_CONTROL_CHANNEL | CSOUND_INPUT_CHANNEL);
-        if (err==0){
-            p->lock = (spin_lock_t*) csoundGetChannelLock(csound, (char*) p->iname->data);
-            strNcpy(p->chname, p->iname->data, MAX_CHAN_NAME);
-        }
-        else {
-            print_chn_err_perf(p, err);
-            return OK;
-        }
+    int32_t err = chn_lookup(csound, p,
+                             CSOUND_CONTROL_CHANNEL | CSOUND_INPUT_CHANNEL);
+    if (UNLIKELY(err)) {
+        print_chn_err_perf(p, err);
+        return OK;
     }
-
-#if defined(MSVC)
-    volatile union {
-    MYFLT d;
-    MYFLT_INT_TYPE i;
-    } x;
-    x.i = InterlockedExchangeAdd64((MYFLT_INT_TYPE *) p->fp, 0);
-    *(p->arg) = x.d;
-#elif defined(HAVE_ATOMIC_BUILTIN)
-    volatile union {
-        MYFLT d;
-        MYFLT_INT_TYPE i;
-    } x;
-    x.i = __atomic_load_n((MYFLT_INT_TYPE*) p->fp, __ATOMIC_SEQ_CST);
-    *(p->arg) = x.d;
-#else
-    *(p->arg) = *(p->fp);
-#endif
+    *(p->arg) = chn_load(p->fp);
     return OK;
 }
 
@@ -689,18 +807,11 @@ static int32_t chnget_opcode_perf_a(CSOUND* csound, CHNGET* p)
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early = p->h.insdshead->ksmps_no_end;
 
-    if (strncmp(p->chname, p->iname->data, MAX_CHAN_NAME)  || !strcmp(p->iname->data, ""))
-    {
-        int32_t err = csoundGetChannelPtr(csound, &(p->fp), (char*) p->iname->data,
-                                          CSOUND_AUDIO_CHANNEL | CSOUND_INPUT_CHANNEL);
-        if (err==0){
-            p->lock = (spin_lock_t*) csoundGetChannelLock(csound, (char*) p->iname->data);
-            strNcpy(p->chname, p->iname->data, MAX_CHAN_NAME);
-        }
-        else {
-            print_chn_err_perf(p, err);
-            return OK;
-        }
+    int32_t err = chn_lookup(csound, p,
+                             CSOUND_AUDIO_CHANNEL | CSOUND_INPUT_CHANNEL);
+    if (UNLIKELY(err)) {
+        print_chn_err_perf(p, err);
+        return OK;
     }
 
     if (CS_KSMPS==(uint32_t) csound->ksmps){
@@ -1149,15 +1260,8 @@ int32_t chnset_array_opcode_perf_S(CSOUND* csound, CHNGETARRAY* p)
 
 int32_t chnget_opcode_init_k(CSOUND *csound, CHNGET *p)
 {
-    int32_t   err;
-    err = csoundGetChannelPtr(csound, &(p->fp), (char*) p->iname->data,
-                              CSOUND_CONTROL_CHANNEL | CSOUND_INPUT_CHANNEL);
-
-    if (LIKELY(!err)) {
-        p->lock =   (spin_lock_t *)csoundGetChannelLock(csound, (char*) p->iname->data);
-        strNcpy(p->chname, p->iname->data, MAX_CHAN_NAME);
-    }
-
+    p->chn = NULL;
+    chn_lookup(csound, p, CSOUND_CONTROL_CHANNEL | CSOUND_INPUT_CHANNEL);
     p->h.opadr = (SUBR) chnget_opcode_perf_k;
     return OK;
 }
@@ -1166,17 +1270,9 @@ int32_t chnget_opcode_init_k(CSOUND *csound, CHNGET *p)
 
 int32_t chnget_opcode_init_a(CSOUND* csound, CHNGET* p)
 {
-    int32_t err;
     p->pos = 0;
-    err = csoundGetChannelPtr(csound, &(p->fp), (char*) p->iname->data,
-                              CSOUND_AUDIO_CHANNEL | CSOUND_INPUT_CHANNEL);
-
-    if (LIKELY(!err))
-    {
-        p->lock = (spin_lock_t*) csoundGetChannelLock(csound, (char*) p->iname->data);
-        strNcpy(p->chname, p->iname->data, MAX_CHAN_NAME);
-    }
-
+    p->chn = NULL;
+    chn_lookup(csound, p, CSOUND_AUDIO_CHANNEL | CSOUND_INPUT_CHANNEL);
     p->h.opadr = (SUBR) chnget_opcode_perf_a;
     return OK;
 }
@@ -1187,9 +1283,8 @@ int32_t chnget_opcode_init_S(CSOUND* csound, CHNGET* p)
 {
     int32_t err;
     char* s = ((STRINGDAT*) p->arg)->data;
-    err = csoundGetChannelPtr(csound, &(p->fp), (char*) p->iname->data,
-                              CSOUND_STRING_CHANNEL | CSOUND_INPUT_CHANNEL);
-    p->lock = (spin_lock_t*) csoundGetChannelLock(csound, (char*) p->iname->data);
+    p->chn = NULL;
+    err = chn_lookup(csound, p, CSOUND_STRING_CHANNEL | CSOUND_INPUT_CHANNEL);
 
     if (LIKELY(!err))
     {
@@ -1215,9 +1310,7 @@ int32_t chnget_opcode_perf_S(CSOUND* csound, CHNGET* p)
 {
     int32_t err;
     char* s = ((STRINGDAT*) p->arg)->data;
-    err = csoundGetChannelPtr(csound, &(p->fp), (char*) p->iname->data,
-                              CSOUND_STRING_CHANNEL | CSOUND_INPUT_CHANNEL);
-    p->lock = (spin_lock_t*) csoundGetChannelLock(csound, (char*) p->iname->data);
+    err = chn_lookup(csound, p, CSOUND_STRING_CHANNEL | CSOUND_INPUT_CHANNEL);
 
     if (UNLIKELY(err))
         return print_chn_err(p, err);
@@ -1248,36 +1341,13 @@ int32_t chnget_opcode_perf_S(CSOUND* csound, CHNGET* p)
 
 static int32_t chnset_opcode_perf_k(CSOUND *csound, CHNGET *p)
 {
-    if(strncmp(p->chname, p->iname->data, MAX_CHAN_NAME)){
-        int32_t err = csoundGetChannelPtr(csound, &(p->fp), (char*) p->iname->data,
-                                          CSOUND_CONTROL_CHANNEL | CSOUND_INPUT_CHANNEL);
-        if(err == 0) {
-            p->lock = (spin_lock_t *) csoundGetChannelLock(csound, (char*) p->iname->data);
-            strNcpy(p->chname, p->iname->data, MAX_CHAN_NAME);
-        }
-        else
-            print_chn_err_perf(p, err);
+    int32_t err = chn_lookup(csound, p,
+                             CSOUND_CONTROL_CHANNEL | CSOUND_OUTPUT_CHANNEL);
+    if (UNLIKELY(err)) {
+        print_chn_err_perf(p, err);
+        return OK;
     }
-
-#if defined(MSVC)
-    volatile union {
-      MYFLT d;
-      MYFLT_INT_TYPE i;
-    } x;
-    x.d = *(p->arg);
-    InterlockedExchange64((MYFLT_INT_TYPE *) p->fp, x.i);
-#elif defined(HAVE_ATOMIC_BUILTIN)
-    union {
-        MYFLT d;
-        MYFLT_INT_TYPE i;
-    } x;
-    x.d = *(p->arg);
-    __atomic_store_n((MYFLT_INT_TYPE *)(p->fp),x.i, __ATOMIC_SEQ_CST);
-#else
-    csoundSpinLock(p->lock);
-    *(p->fp) = *(p->arg);
-    csoundSpinUnLock(p->lock);
-#endif
+    chn_store(p->fp, *(p->arg), p->lock);
     return OK;
 }
 
@@ -1388,14 +1458,8 @@ int32_t chnset_opcode_init_i(CSOUND *csound, CHNGET *p)
 
 int32_t chnset_opcode_init_k(CSOUND* csound, CHNGET* p)
 {
-    int32_t err;
-
-    err = csoundGetChannelPtr(csound, &(p->fp), (char*) p->iname->data,
-                              CSOUND_CONTROL_CHANNEL | CSOUND_OUTPUT_CHANNEL);
-    if (LIKELY(!err)) {
-        p->lock = (spin_lock_t*) csoundGetChannelLock(csound, (char*) p->iname->data);
-    }
-
+    p->chn = NULL;
+    chn_lookup(csound, p, CSOUND_CONTROL_CHANNEL | CSOUND_OUTPUT_CHANNEL);
     p->h.opadr = (SUBR) chnset_opcode_perf_k;
     return OK;
 }
@@ -1460,6 +1524,7 @@ int32_t chnset_opcode_init_S(CSOUND* csound, CHNGET* p)
     spin_lock_t* lock;
     char* s = ((STRINGDAT*) p->arg)->data;
 
+    p->chn = NULL;
     err = csoundGetChannelPtr(csound, &(p->fp), (char*) p->iname->data,
                               CSOUND_STRING_CHANNEL | CSOUND_OUTPUT_CHANNEL);
     // size = csoundGetChannelDatasize(csound, p->iname->data);
@@ -1493,8 +1558,8 @@ int32_t chnset_opcode_perf_S(CSOUND* csound, CHNGET* p)
     spin_lock_t* lock;
     char* s = ((STRINGDAT*) p->arg)->data;
 
-    if ((err = csoundGetChannelPtr(csound, &(p->fp), (char*) p->iname->data,
-                                   CSOUND_STRING_CHANNEL | CSOUND_OUTPUT_CHANNEL)))
+    if ((err = chn_lookup(csound, p,
+                          CSOUND_STRING_CHANNEL | CSOUND_OUTPUT_CHANNEL)))
         return err;
     // size = csoundGetChannelDatasize(csound, p->iname->data);
 
@@ -1503,8 +1568,7 @@ int32_t chnset_opcode_perf_S(CSOUND* csound, CHNGET* p)
         && strcmp(s, ((STRINGDAT*) p->fp)->data)==0)
         return OK;
 
-    p->lock = lock = (spin_lock_t*)
-            csoundGetChannelLock(csound, (char*) p->iname->data);
+    lock = p->lock;
     csoundSpinLock(lock);
     if (strlen(s)>=(uint32_t) ((STRINGDAT*) p->fp)->size)
     {
@@ -27,11 +27,288 @@
 #include <math.h>
 #include <inttypes.h>
 
-typedef struct DISKIN_INST_ {
-  CSOUND *csound;
-  DISKIN2 *diskin;
-  struct DISKIN_INST_ *nxt;
-} DISKIN_INST;
+/* Streaming engine for the asynchronous (-+rtaudio realtime) mode.
+
+   Every stream renders its output, a block of aOut_bufsize frames at a
+   time, into a ring buffer two blocks long that the opcode empties at
+   performance time.  When a whole block fits again the opcode posts a
+   request (never waiting for the lock); a small pool of I/O threads
+   serves the requests, the stream closest to running dry first, and
+   fills the ring up.  The ring is filled once at init time, so a note
+   starts without waiting for the disk.  A note that ends while its
+   stream is being filled stops the worker after the block in progress
+   and waits for that block only, as the worker renders through the
+   opcode. */
+
+#define DISKIN_MAX_THREADS  16
+
+struct DISKIN_ENGINE_;
+
+typedef struct DISKIN_STREAM_ {
+  struct DISKIN_ENGINE_ *eng;
+  void    *diskin;              /* DISKIN2 or DISKIN2_ARRAY */
+  int32_t (*fill)(CSOUND *, void *);  /* renders one block into cb */
+  void    *cb;
+  int32_t block;                /* items rendered by one fill */
+  int32_t capacity;             /* items the ring holds */
+  int32_t chans;
+  long    written, consumed;    /* running item counts */
+  long    queued;               /* requested, until a worker is done */
+  int32_t busy;                 /* a worker is filling it */
+  int32_t failed;
+  long    detached;             /* removed while busy: stop after the block */
+  double  posted;               /* time of the request */
+  struct DISKIN_STREAM_ *nxtreq;
+} DISKIN_STREAM;
+
+typedef struct DISKIN_ENGINE_ {
+  CSOUND  *csound;
+  void    *lock, *cond;
+  void    *drained;             /* a worker left a detached stream */
+  void    *threads[DISKIN_MAX_THREADS];
+  int32_t nthreads;
+  long    running;
+  int32_t nstreams;
+  DISKIN_STREAM *requests;      /* under lock */
+  RTCLOCK clk;
+  uint64_t nrequests;           /* under lock, as are the latencies */
+  long    underruns;
+  double  latency_sum, latency_max;
+} DISKIN_ENGINE;
+
+static inline int32_t diskin_stream_items(DISKIN_STREAM *s)
+{
+    return (int32_t) ((unsigned long) ATOMIC_GET(s->written) -
+                      (unsigned long) ATOMIC_GET(s->consumed));
+}
+
+/* fill the ring while there is room for a block */
+
+static void diskin_stream_fill(CSOUND *csound, DISKIN_STREAM *s)
+{
+    while (s->capacity - diskin_stream_items(s) >= s->block &&
+           !ATOMIC_GET(s->detached) &&
+           (s->eng->nthreads == 0 || ATOMIC_GET(s->eng->running))) {
+      if (UNLIKELY(s->fill(csound, s->diskin) != OK)) {
+        s->failed = 1;
+        break;
+      }
+      ATOMIC_ADD(s->written, s->block);
+    }
+}
+
+static uintptr_t diskin_io_thread(void *arg)
+{
+    DISKIN_ENGINE *e = (DISKIN_ENGINE *) arg;
+    CSOUND  *csound = e->csound;
+    DISKIN_STREAM *s, **pp, **best;
+    double  t;
+
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    csound->LockMutex(e->lock);
+    while (e->running) {
+      /* least buffered time first */
+      best = NULL;
+      for (pp = &e->requests; *pp != NULL; pp = &(*pp)->nxtreq)
+        if (best == NULL ||
+            diskin_stream_items(*pp) * (*best)->chans <
+            diskin_stream_items(*best) * (*pp)->chans)
+          best = pp;
+      if (best == NULL) {
+        csoundCondWait(e->cond, e->lock);
+        continue;
+      }
+      s = *best;
+      *best = s->nxtreq;
+      s->busy = 1;
+      t = csound->GetRealTime(&e->clk) - s->posted;
+      e->nrequests++;
+      e->latency_sum += t;
+      if (t > e->latency_max)
+        e->latency_max = t;
+      csound->UnlockMutex(e->lock);
+      diskin_stream_fill(csound, s);
+      csound->LockMutex(e->lock);
+      s->busy = 0;
+      if (s->detached) {
+        /* the note is waiting to free it */
+        csoundCondSignal(e->drained);
+        continue;
+      }
+      ATOMIC_SET(s->queued, 0);
+    }
+    /* pass the wake up on to the next worker */
+    csoundCondSignal(e->cond);
+    csound->UnlockMutex(e->lock);
+    return 0;
+}
+
+/* called by the opcode after reading got of wanted items */
+
+static void diskin_stream_consumed(CSOUND *csound, DISKIN_STREAM *s,
+                                   int32_t got, int32_t wanted)
+{
+    DISKIN_ENGINE *e = s->eng;
+
+    ATOMIC_ADD(s->consumed, got);
+    if (UNLIKELY(got < wanted))
+      ATOMIC_INCR(e->underruns);
+    if (ATOMIC_GET(s->queued) || s->failed ||
+        s->capacity - diskin_stream_items(s) < s->block)
+      return;
+    if (e->nthreads == 0) {             /* no I/O threads: fill here */
+      diskin_stream_fill(csound, s);
+      return;
+    }
+    /* do not wait for a worker: try again on the next cycle */
+    if (csound->LockMutexNoWait(e->lock) != 0)
+      return;
+    ATOMIC_SET(s->queued, 1);
+    s->posted = csound->GetRealTime(&e->clk);
+    s->nxtreq = e->requests;
+    e->requests = s;
+    csoundCondSignal(e->cond);
+    csound->UnlockMutex(e->lock);
+}
+
+static int32_t diskin_engine_reset(CSOUND *csound, void *p)
+{
+    DISKIN_ENGINE *e = (DISKIN_ENGINE *) p;
+    int32_t i;
+
+    csound->LockMutex(e->lock);
+    ATOMIC_SET(e->running, 0);
+    csoundCondSignal(e->cond);
+    csound->UnlockMutex(e->lock);
+    for (i = 0; i < e->nthreads; i++)
+      csound->JoinThread(e->threads[i]);
+    if (e->underruns > 0)
+      csound->Warning(csound, Str("diskin2: %ld buffer underruns in %"
+                                  PRIu64 " disk requests"),
+                      (long) e->underruns, e->nrequests);
+    csoundDestroyCondVar(e->cond);
+    csoundDestroyCondVar(e->drained);
+    csound->DestroyMutex(e->lock);
+    return OK;
+}
+
+static DISKIN_ENGINE *diskin_engine(CSOUND *csound)
+{
+    DISKIN_ENGINE *e;
+    int32_t i, n;
+
+    e = (DISKIN_ENGINE *) csound->QueryGlobalVariable(csound, "DISKIN_ENGINE");
+    if (e != NULL)
+      return e;
+    if (UNLIKELY(csound->CreateGlobalVariable(csound, "DISKIN_ENGINE",
+                                              sizeof(DISKIN_ENGINE)) != 0))
+      return NULL;
+    e = (DISKIN_ENGINE *) csound->QueryGlobalVariable(csound, "DISKIN_ENGINE");
+    e->csound = csound;
+    e->lock = csound->Create_Mutex(0);
+    e->cond = csoundCreateCondVar();
+    e->drained = csoundCreateCondVar();
+    csoundInitTimerStruct(&e->clk);
+    e->running = 1;
+#ifdef __EMSCRIPTEN__
+    n = 0;
+#else
+    n = csound->oparms->diskin_threads;
+    if (n < 1)
+      n = 1;
+    else if (n > DISKIN_MAX_THREADS)
+      n = DISKIN_MAX_THREADS;
+#endif
+    for (i = 0; i < n; i++) {
+      if ((e->threads[i] = csound->CreateThread(diskin_io_thread, e)) == NULL)
+        break;
+      e->nthreads++;
+    }
+    csound->RegisterResetCallback(csound, (void *) e, diskin_engine_reset);
+    return e;
+}
+
+/* register an opened file; the ring is full when this returns */
+
+static DISKIN_STREAM *diskin_stream_add(CSOUND *csound, void *diskin,
+                                        int32_t (*fill)(CSOUND *, void *),
+                                        void *cb, int32_t block,
+                                        int32_t chans)
+{
+    DISKIN_ENGINE *e = diskin_engine(csound);
+    DISKIN_STREAM *s;
+
+    if (UNLIKELY(e == NULL))
+      return NULL;
+    s = (DISKIN_STREAM *) csound->Calloc(csound, sizeof(DISKIN_STREAM));
+    s->eng = e;
+    s->diskin = diskin;
+    s->fill = fill;
+    s->cb = cb;
+    s->block = block;
+    s->capacity = 2 * block;
+    s->chans = chans;
+    csound->LockMutex(e->lock);
+    e->nstreams++;
+    csound->UnlockMutex(e->lock);
+    diskin_stream_fill(csound, s);
+    return s;
+}
+
+/* unregister the stream of a note, and destroy its ring.  If a worker
+   is filling the stream, it is told to stop after the block in progress,
+   which is waited for: the worker renders through the opcode, whose
+   memory may be freed as soon as this returns. */
+
+static void diskin_stream_remove(CSOUND *csound, void **stream, void **cb)
+{
+    DISKIN_STREAM *s = (DISKIN_STREAM *) *stream;
+    DISKIN_ENGINE *e;
+    DISKIN_STREAM **pp;
+
+    if (s == NULL)
+      return;
+    *stream = NULL;
+    *cb = NULL;
+    e = s->eng;
+    csound->LockMutex(e->lock);
+    for (pp = &e->requests; *pp != NULL; pp = &(*pp)->nxtreq)
+      if (*pp == s) {
+        *pp = s->nxtreq;
+        break;
+      }
+    e->nstreams--;
+    ATOMIC_SET(s->detached, 1);
+    while (s->busy) {
+      csoundCondWait(e->drained, e->lock);
+      /* pass the wake up on, it may have been for another note */
+      if (s->busy)
+        csoundCondSignal(e->drained);
+    }
+    csound->UnlockMutex(e->lock);
+    csound->DestroyCircularBuffer(csound, s->cb);
+    csound->Free(csound, s);
+}
+
+PUBLIC int csoundGetDiskinStats(CSOUND *csound, CSOUND_DISKIN_STATS *stats)
+{
+    DISKIN_ENGINE *e;
+
+    memset(stats, 0, sizeof(CSOUND_DISKIN_STATS));
+    e = (DISKIN_ENGINE *) csound->QueryGlobalVariable(csound, "DISKIN_ENGINE");
+    if (e == NULL)
+      return -1;
+    csound->LockMutex(e->lock);
+    stats->streams = e->nstreams;
+    stats->threads = e->nthreads;
+    stats->requests = e->nrequests;
+    stats->underruns = (uint64_t) ATOMIC_GET(e->underruns);
+    stats->latency_max = e->latency_max;
+    stats->latency_mean =
+      (e->nrequests ? e->latency_sum / (double) e->nrequests : 0.0);
+    csound->UnlockMutex(e->lock);
+    return 0;
+}
 
 
 static CS_NOINLINE void diskin2_read_buffer(CSOUND *csound,
@@ -295,6 +572,12 @@ int32_t soundin(CSOUND *csound, DISKIN2 *p){
 }
 
 int32_t diskin2_async_deinit(CSOUND *csound, void *p);
+int32_t diskin_file_read(CSOUND *csound, DISKIN2 *p);
+
+static int32_t diskin_fill(CSOUND *csound, void *p)
+{
+    return diskin_file_read(csound, (DISKIN2 *) p);
+}
 
 static int32_t diskin2_init_(CSOUND *csound, DISKIN2 *p, int32_t stringname)
 {
@@ -315,6 +598,8 @@ static int32_t diskin2_init_(CSOUND *csound, DISKIN2 *p, int32_t stringname)
       /* skip initialisation if requested */
       if (p->SkipInit != FL(0.0))
         return OK;
+      /* reinit of a streaming note: stop the worker before closing */
+      diskin_stream_remove(csound, &p->stream, &p->cb);
       csound_fd_close(csound, &(p->fdch));
     }
     /* set default format parameters */
@@ -417,58 +702,25 @@ static int32_t diskin2_init_(CSOUND *csound, DISKIN2 *p, int32_t stringname)
 
     memset(p->buf, 0, n*sizeof(MYFLT));
 
-    // create circular buffer, on fail set mode to synchronous
+    /* stream through the I/O threads in realtime mode, unless the
+       opcode asks not to */
+    p->aOut_bufsize =  ((unsigned int)p->bufSize) < CS_KSMPS ?
+      ((MYFLT)CS_KSMPS) : ((MYFLT)p->bufSize);
+    n = p->aOut_bufsize * p->nChannels;
     if (csound->oparms->realtime==1 && p->fforceSync==0 &&
-        (p->cb = csound->CreateCircularBuffer(csound,
-                                              p->bufSize*p->nChannels*2,
-                                              sizeof(MYFLT))) != NULL){
-      DISKIN_INST **top, *current;
-#ifndef __EMSCRIPTEN__
-      int32_t *start;
-#endif
-      // allocate buffer
-      p->aOut_bufsize =  ((unsigned int)p->bufSize) < CS_KSMPS ?
-        ((MYFLT)CS_KSMPS) : ((MYFLT)p->bufSize);
-      n = p->aOut_bufsize*sizeof(MYFLT)*p->nChannels;
+        (p->cb = csound->CreateCircularBuffer(csound, 2 * n + 1,
+                                              sizeof(MYFLT))) != NULL) {
+      n *= sizeof(MYFLT);
       if (n != (int32_t)p->auxData2.size)
         csound->AuxAlloc(csound, (int32_t) n, &(p->auxData2));
       p->aOut_buf = (MYFLT *) (p->auxData2.auxp);
       memset(p->aOut_buf, 0, n);
-      top = (DISKIN_INST **)csound->QueryGlobalVariable(csound, "DISKIN_INST");
-#ifndef __EMSCRIPTEN__
-      if (top == NULL){
-        csound->CreateGlobalVariable(csound, "DISKIN_INST", sizeof(DISKIN_INST *));
-        top = (DISKIN_INST **) csound->QueryGlobalVariable(csound, "DISKIN_INST");
-        *top = (DISKIN_INST *) csound->Calloc(csound, sizeof(DISKIN_INST));
-        csound->CreateGlobalVariable(csound, "DISKIN_PTHREAD", sizeof(void**));
-        csound->CreateGlobalVariable(csound,
-                                     "DISKIN_THREAD_START", sizeof(int32_t));
-        current = *top;
-      }
-      else
-#endif
-        {
-          current = *top;
-          while(current->nxt != NULL) { /* find next empty slot in chain */
-            current = current->nxt;
-          }
-          current->nxt = (DISKIN_INST *) csound->Calloc(csound,
-                                                        sizeof(DISKIN_INST));
-          current = current->nxt;
-        }
-      current->csound = csound;
-      current->diskin = p;
-      current->nxt = NULL;
-
-#ifndef __EMSCRIPTEN__
-      if ( *(start = csound->QueryGlobalVariable(csound,
-                                                 "DISKIN_THREAD_START")) == 0) {
-        uintptr_t diskin_io_thread(void *p);
-        void **thread = csound->QueryGlobalVariable(csound, "DISKIN_PTHREAD");
-        *thread = csound->CreateThread(diskin_io_thread, *top);
-        *start = 1;
-      }
-#endif
+      p->stream = diskin_stream_add(csound, p, diskin_fill, p->cb,
+                                    p->aOut_bufsize * p->nChannels,
+                                    p->nChannels);
+      if (UNLIKELY(p->stream == NULL))
+        return csound->InitError(csound,
+                                 Str("diskin2: cannot start streaming"));
       csound->RegisterDeinitCallback(csound, p, diskin2_async_deinit);
       p->async = 1;
 
@@ -507,37 +759,9 @@ static int32_t diskin2_init_(CSOUND *csound, DISKIN2 *p, int32_t stringname)
 }
 
 int32_t diskin2_async_deinit(CSOUND *csound,  void *p){
+    DISKIN2 *pp = (DISKIN2 *) p;
 
-    DISKIN_INST **top, *current, *prv;
-
-    if ((top = (DISKIN_INST **)
-         csound->QueryGlobalVariable(csound, "DISKIN_INST")) == NULL) return NOTOK;
-    current = *top;
-    prv = NULL;
-    while(current->diskin != (DISKIN2 *)p) {
-      prv = current;
-      current = current->nxt;
-    }
-    if (prv == NULL) *top = current->nxt;
-    else prv->nxt = current->nxt;
-
-#ifndef __EMSCRIPTEN__
-    if (*top == NULL) {
-      int32_t *start; void **pt;
-
-      start = (int32_t *) csound->QueryGlobalVariable(csound,"DISKIN_THREAD_START");
-      *start = 0;
-      pt = csound->QueryGlobalVariable(csound,"DISKIN_PTHREAD");
-      //csound->Message(csound, "dealloc %p %d\n", start, *start);
-      csound->JoinThread(*pt);
-      csound->DestroyGlobalVariable(csound, "DISKIN_PTHREAD");
-      csound->DestroyGlobalVariable(csound, "DISKIN_THREAD_START");
-      csound->DestroyGlobalVariable(csound, "DISKIN_INST");
-    }
-#endif
-    csound->Free(csound, current);
-    csound->DestroyCircularBuffer(csound, ((DISKIN2 *)p)->cb);
-
+    diskin_stream_remove(csound, &pp->stream, &pp->cb);
     return OK;
 }
 
@@ -919,14 +1143,14 @@ int32_t diskin_file_read(CSOUND *csound, DISKIN2 *p)
       }
     }
     {
-      /* write to circular buffer */
+      /* write to circular buffer: the engine only calls this when
+         there is room for the whole block */
       int32_t lc, mc=0, nc=nsmps*p->nChannels;
-      int32_t *start = csound->QueryGlobalVariable(csound,"DISKIN_THREAD_START");
       do{
         lc =  csound->WriteCircularBuffer(csound, p->cb, &aOut[mc], nc);
         nc -= lc;
         mc += lc;
-      } while(nc && *start);
+      } while(nc && lc);
     }
     return OK;
  file_error:
@@ -940,10 +1164,10 @@ int32_t diskin2_perf_asynchronous(CSOUND *csound, DISKIN2 *p)
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t nn, nsmps = CS_KSMPS;
-    MYFLT samp;
-    int32_t chn;
+    int32_t chn, i, k, got = 0, wanted;
     void *cb = p->cb;
     int32_t chans = p->nChannels;
+    MYFLT *data;
 
     if (offset || early) {
       for (chn = 0; chn < chans; chn++)
@@ -957,39 +1181,32 @@ int32_t diskin2_perf_asynchronous(CSOUND *csound, DISKIN2 *p)
       return csound->PerfError(csound, &(p->h),
                                Str("diskin2: not initialised"));
     }
-    for (nn = offset; nn < nsmps; nn++){
-
-      for (chn = 0; chn < chans; chn++) {
-        //int32_t i =0;
-        //do {
-        // i =
-        csound->ReadCircularBuffer(csound, cb, &samp, 1);
-        //} while(i==0);
-        p->aOut[chn][nn] = csound->e0dbfs*samp;
+    /* interleaved frames, read in place from the ring */
+    wanted = (int32_t) (nsmps - offset) * chans;
+    nn = offset;
+    chn = 0;
+    while (got < wanted &&
+           (k = csoundReserveReadCircularBuffer(csound, cb, (void **) &data,
+                                                wanted - got)) > 0) {
+      for (i = 0; i < k; i++) {
+        p->aOut[chn][nn] = csound->e0dbfs * data[i];
+        if (++chn == chans) {
+          chn = 0;
+          nn++;
+        }
       }
+      csoundCommitReadCircularBuffer(csound, cb, k);
+      got += k;
     }
+    /* underrun: silence until the disk catches up */
+    for ( ; nn < nsmps; nn++, chn = 0)
+      for ( ; chn < chans; chn++)
+        p->aOut[chn][nn] = FL(0.0);
+    diskin_stream_consumed(csound, (DISKIN_STREAM *) p->stream, got, wanted);
     return OK;
 }
 
 
-uintptr_t diskin_io_thread(void *p){
-    DISKIN_INST *current = (DISKIN_INST *) p;
-    int32_t wakeup = 1000*current->csound->ksmps/current->csound->esr;
-    int32_t *start =
-      current->csound->QueryGlobalVariable(current->csound,"DISKIN_THREAD_START");
-    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
-    while(*start){
-      current = (DISKIN_INST *) p;
-      csoundSleep(wakeup > 0 ? wakeup : 1);
-      while(current != NULL){
-        diskin_file_read(current->csound, current->diskin);
-        current = current->nxt;
-      }
-    }
-    return 0;
-}
-
-
 int32_t diskin2_perf(CSOUND *csound, DISKIN2 *p) {
     if (!p->async) return diskin2_perf_synchronous(csound, p);
     else return diskin2_perf_asynchronous(csound, p);
@@ -1309,39 +1526,9 @@ static inline void diskin2_get_sample_array(CSOUND *csound,
 }
 
 int32_t diskin2_async_deinit_array(CSOUND *csound,  void *p){
+    DISKIN2_ARRAY *pp = (DISKIN2_ARRAY *) p;
 
-    DISKIN_INST **top, *current, *prv;
-
-    if ((top = (DISKIN_INST **)
-         csound->QueryGlobalVariable(csound, "DISKIN_INST_ARRAY")) == NULL)
-      return NOTOK;
-    current = *top;
-    prv = NULL;
-    while(current->diskin != (DISKIN2 *)p) {
-      prv = current;
-      current = current->nxt;
-    }
-    if (prv == NULL) *top = current->nxt;
-    else prv->nxt = current->nxt;
-
-#ifndef __EMSCRIPTEN__
-    if (*top == NULL) {
-      int32_t *start; void **pt;
-      start = (int32_t *) csound->QueryGlobalVariable(csound,
-                                                  "DISKIN_THREAD_START_ARRAY");
-      *start = 0;
-      pt = csound->QueryGlobalVariable(csound,"DISKIN_PTHREAD_ARRAY");
-      //csound->Message(csound, "dealloc %p %d\n", start, *start);
-      csound->JoinThread(*pt);
-      csound->DestroyGlobalVariable(csound, "DISKIN_PTHREAD_ARRAY");
-      csound->DestroyGlobalVariable(csound, "DISKIN_THREAD_START_ARRAY");
-      csound->DestroyGlobalVariable(csound, "DISKIN_INST_ARRAY");
-    }
-#endif
-
-    csound->Free(csound, current);
-    csound->DestroyCircularBuffer(csound, ((DISKIN2_ARRAY *)p)->cb);
-
+    diskin_stream_remove(csound, &pp->stream, &pp->cb);
     return OK;
 }
 
@@ -1523,12 +1710,11 @@ int32_t diskin_file_read_array(CSOUND *csound, DISKIN2_ARRAY *p)
     {
       /* write to circular buffer */
       int32_t lc, mc=0, nc=nsmps*p->nChannels;
-      int32_t *start = csound->QueryGlobalVariable(csound,"DISKIN_THREAD_START");
       do{
         lc = csound->WriteCircularBuffer(csound, p->cb, &aOut[mc], nc);
         nc -= lc;
         mc += lc;
-      } while(nc && *start);
+      } while(nc && lc);
     }
     return OK;
  file_error:
@@ -1536,25 +1722,11 @@ int32_t diskin_file_read_array(CSOUND *csound, DISKIN2_ARRAY *p)
     return NOTOK;
 }
 
-uintptr_t diskin_io_thread_array(void *p){
-    DISKIN_INST *current = (DISKIN_INST *) p;
-    int32_t wakeup = 1000*current->csound->ksmps/current->csound->esr;
-    int32_t *start =
-      current->csound->QueryGlobalVariable(current->csound,
-                                           "DISKIN_THREAD_START_ARRAY");
-    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
-    while(*start){
-      current = (DISKIN_INST *) p;
-      csoundSleep(wakeup > 0 ? wakeup : 1);
-      while(current != NULL){
-        diskin_file_read_array(current->csound, (DISKIN2_ARRAY *)current->diskin);
-        current = current->nxt;
-      }
-    }
-    return 0;
+static int32_t diskin_fill_array(CSOUND *csound, void *p)
+{
+    return diskin_file_read_array(csound, (DISKIN2_ARRAY *) p);
 }
 
-
 static int32_t diskin2_init_array(CSOUND *csound, DISKIN2_ARRAY *p,
                                   int32_t stringname)
 {
@@ -1570,6 +1742,8 @@ static int32_t diskin2_init_array(CSOUND *csound, DISKIN2_ARRAY *p,
       /* skip initialisation if requested */
       if (p->SkipInit != FL(0.0))
         return OK;
+      /* reinit of a streaming note: stop the worker before closing */
+      diskin_stream_remove(csound, &p->stream, &p->cb);
       csound_fd_close(csound, &(p->fdch));
     }
     // to handle raw files number of channels
@@ -1693,70 +1867,26 @@ static int32_t diskin2_init_array(CSOUND *csound, DISKIN2_ARRAY *p,
 
     memset(p->buf, 0, n*sizeof(MYFLT));
 
-    // create circular buffer, on fail set mode to synchronous
+    /* stream through the I/O threads in realtime mode, unless the
+       opcode asks not to */
+    p->aOut_bufsize =  ((unsigned int)p->bufSize) < CS_KSMPS ?
+      ((MYFLT)CS_KSMPS) : ((MYFLT)p->bufSize);
+    n = p->aOut_bufsize * p->nChannels;
     if (csound->oparms->realtime==1 && p->fforceSync==0 &&
-        (p->cb = csound->CreateCircularBuffer(csound,
-                                              p->bufSize*p->nChannels*2,
-                                              sizeof(MYFLT))) != NULL){
-      DISKIN_INST **top, *current;
-#ifndef __EMSCRIPTEN__
-      int32_t *start;
-#endif
-      // allocate buffer
-      p->aOut_bufsize =
-        ((unsigned int)p->bufSize) < CS_KSMPS ?
-        ((MYFLT)CS_KSMPS) : ((MYFLT)p->bufSize);
-      n = p->aOut_bufsize*sizeof(MYFLT)*p->nChannels;
+        (p->cb = csound->CreateCircularBuffer(csound, 2 * n + 1,
+                                              sizeof(MYFLT))) != NULL) {
+      n *= sizeof(MYFLT);
       if (n != (int32_t)p->auxData2.size)
         csound->AuxAlloc(csound, (int32_t) n, &(p->auxData2));
       p->aOut_buf = (MYFLT *) (p->auxData2.auxp);
       memset(p->aOut_buf, 0, n);
-      top =
-        (DISKIN_INST **)csound->QueryGlobalVariable(csound, "DISKIN_INST_ARRAY");
-#ifndef __EMSCRIPTEN__
-      if (top == NULL){
-        csound->CreateGlobalVariable(csound,
-                                     "DISKIN_INST_ARRAY", sizeof(DISKIN_INST *));
-        top = (DISKIN_INST **) csound->QueryGlobalVariable(csound,
-                                                           "DISKIN_INST_ARRAY");
-        *top = (DISKIN_INST *) csound->Calloc(csound, sizeof(DISKIN_INST));
-        csound->CreateGlobalVariable(csound,
-                                     "DISKIN_PTHREAD_ARRAY", sizeof(void**));
-        csound->CreateGlobalVariable(csound,
-                                     "DISKIN_THREAD_START_ARRAY", sizeof(int32_t));
-        current = *top;
-      }
-      else
-#endif
-        {
-          current = *top;
-          while(current->nxt != NULL) { /* find next empty slot in chain */
-            current = current->nxt;
-          }
-          current->nxt =
-            (DISKIN_INST *) csound->Calloc(csound, sizeof(DISKIN_INST));
-          current = current->nxt;
-        }
-      current->csound = csound;
-      current->diskin =  (DISKIN2 *) p;
-      current->nxt = NULL;
-
-#ifndef __EMSCRIPTEN__
-      if (*(start =
-            csound->QueryGlobalVariable(csound,
-                                        "DISKIN_THREAD_START_ARRAY")) == 0) {
-        uintptr_t diskin_io_thread_array(void *p);
-        // TOFIX: this variable (thread) is not referenced
-        #if 0
-        void **thread = csound->QueryGlobalVariable(csound,
-                                                       "DISKIN_PTHREAD_ARRAY");
-        #endif
-        *start = 1;
-        csound->CreateThread(diskin_io_thread_array, *top);
-      }
-#endif
-      csound->RegisterDeinitCallback(csound, (DISKIN2 *) p,
-                                     diskin2_async_deinit_array);
+      p->stream = diskin_stream_add(csound, p, diskin_fill_array, p->cb,
+                                    p->aOut_bufsize * p->nChannels,
+                                    p->nChannels);
+      if (UNLIKELY(p->stream == NULL))
+        return csound->InitError(csound,
+                                 Str("diskin2: cannot start streaming"));
+      csound->RegisterDeinitCallback(csound, p, diskin2_async_deinit_array);
       p->async = 1;
 
       /* print file information */
@@ -1988,11 +2118,11 @@ int32_t diskin2_perf_asynchronous_array(CSOUND *csound, DISKIN2_ARRAY *p)
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t nn, nsmps = CS_KSMPS, ksmps = CS_KSMPS;
-    MYFLT samp;
-    int32_t chn;
+    int32_t chn, i, k, got = 0, wanted;
     void *cb = p->cb;
     int32_t chans = p->nChannels;
     MYFLT *aOut = (MYFLT *) p->aOut->data;
+    MYFLT *data;
 
     if (offset || early) {
       for (chn = 0; chn < chans; chn++)
@@ -2006,17 +2136,26 @@ int32_t diskin2_perf_asynchronous_array(CSOUND *csound, DISKIN2_ARRAY *p)
       return csound->PerfError(csound, &(p->h),
                                Str("diskin2: not initialised"));
     }
-    for (nn = offset; nn < nsmps; nn++){
-
-      for (chn = 0; chn < chans; chn++) {
-        //int32_t i =0;
-        //do {
-        // i =
-        csound->ReadCircularBuffer(csound, cb, &samp, 1);
-        //} while(i==0);
-        aOut[chn*ksmps+nn] = csound->e0dbfs*samp;
+    wanted = (int32_t) (nsmps - offset) * chans;
+    nn = offset;
+    chn = 0;
+    while (got < wanted &&
+           (k = csoundReserveReadCircularBuffer(csound, cb, (void **) &data,
+                                                wanted - got)) > 0) {
+      for (i = 0; i < k; i++) {
+        aOut[chn*ksmps+nn] = csound->e0dbfs * data[i];
+        if (++chn == chans) {
+          chn = 0;
+          nn++;
+        }
       }
+      csoundCommitReadCircularBuffer(csound, cb, k);
+      got += k;
     }
+    for ( ; nn < nsmps; nn++, chn = 0)
+      for ( ; chn < chans; chn++)
+        aOut[chn*ksmps+nn] = FL(0.0);
+    diskin_stream_consumed(csound, (DISKIN_STREAM *) p->stream, got, wanted);
     return OK;
 }
 
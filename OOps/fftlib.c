@@ -3450,6 +3450,9 @@ void *csoundRealFFT2Setup(CSOUND *csound,
                          int32_t d){
   CSOUND_FFT_SETUP *setup;
   int32_t lib = csound->oparms->fft_lib;
+  /* the mixed-radix code takes any even size */
+  if(lib == MRFFT_LIB || !isPowTwo(FFTsize))
+    lib = (FFTsize & 1) ? FFT_LIB : MRFFT_LIB;
   if(lib == PFFT_LIB && FFTsize <= 16){
     csound->Warning(csound,
       "FFTsize %d \n"
@@ -3486,6 +3489,14 @@ void *csoundRealFFT2Setup(CSOUND *csound,
                 PFFFT_BACKWARD);
     setup->lib = lib;
     break;
+  case MRFFT_LIB:
+    setup->setup = mrfft_get_plan(csound, FFTsize);
+    setup->buffer = (MYFLT *)
+      csound->Malloc(csound,
+                     sizeof(MYFLT)*mrfft_work_size(setup->setup));
+    setup->d = d;
+    setup->lib = lib;
+    return (void *) setup;
   default:
     setup->lib = 0;
     setup->d = d;
@@ -3511,6 +3522,9 @@ void csoundRealFFT2(CSOUND *csound,
   case PFFT_LIB:
     pffft_execute(setup,sig);
     break;
+  case MRFFT_LIB:
+    mrfft_execute(setup->setup,sig,setup->buffer,setup->d);
+    break;
   default:
     (setup->d == FFT_FWD ?
       csoundRealFFT(csound,
@@ -3532,6 +3546,13 @@ void *csoundDCTSetup(CSOUND *csound,
   setup->buffer = (MYFLT *)
     csound->Calloc(csound, sizeof(MYFLT)*setup->N);
  }
+ else if(setup->lib == MRFFT_LIB){
+  /* the DCT data, then the FFT scratch space */
+  csound->Free(csound, setup->buffer);
+  setup->buffer = (MYFLT *)
+    csound->Calloc(csound, sizeof(MYFLT)*
+                   (setup->N + mrfft_work_size(setup->setup)));
+ }
  return setup;
 }
 
@@ -3656,7 +3677,10 @@ void DCT_execute(CSOUND *csound,
     buffer[i] = FL(0.0);
     buffer[i+1] = sig[j];
   }
-  csoundRealFFT(csound,buffer,N);
+  if(setup->lib == MRFFT_LIB)
+    mrfft_execute(setup->setup,buffer,buffer+N,FFT_FWD);
+  else
+    csoundRealFFT(csound,buffer,N);
   for(i=j=0; i < N/2; i+=2, j++){
     sig[j] = buffer[i];
   }
@@ -3672,7 +3696,10 @@ void DCT_execute(CSOUND *csound,
     buffer[i] = -sig[j];
     buffer[i+1] = FL(0.0);
   }
-  csoundInverseRealFFT(csound,buffer,N);
+  if(setup->lib == MRFFT_LIB)
+    mrfft_execute(setup->setup,buffer,buffer+N,FFT_INV);
+  else
+    csoundInverseRealFFT(csound,buffer,N);
   for(i=j=0; i < N/2; i+=2, j++){
     sig[j] = buffer[i+1];
   }
@@ -3692,6 +3719,9 @@ CSOUND_FFT_SETUP *setup =
   case PFFT_LIB:
     pffft_DCT_execute(csound,setup,sig);
     break;
+  case MRFFT_LIB:
+    DCT_execute(csound,setup,sig);
+    break;
   default:
     DCT_execute(csound,setup,sig);
     setup->lib = 0;
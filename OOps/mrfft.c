@@ -0,0 +1,373 @@
+/*
+  mrfft.c:
+
+  Mixed-radix real FFT for sizes that are not powers of two
+
+  This file is part of Csound.
+
+  The Csound Library is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Csound is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+  02110-1301 USA
+*/
+
+/*
+  A real FFT of even size N is done as a complex FFT of size N/2 on the
+  even/odd sample pairs, followed by a split step. The complex FFT is a
+  recursive decimation in time over the factors of N/2, with dedicated
+  butterflies for radix 2, 3, 4 and 5 and a generic one for any other
+  prime, so that any even size works and sizes made of 2, 3 and 5 run
+  close to power-of-two speed.
+
+  Plans hold only twiddle factors, so one plan serves both directions
+  and every setup of the same size; they are kept in a list on the
+  CSOUND instance and released with the rest of its memory on reset.
+  The scratch space is per setup.
+*/
+
+#include <math.h>
+#include "csoundCore.h"
+#include "fftlib.h"
+
+#define MRFFT_MAXFACT 32
+
+typedef struct {
+  MYFLT re, im;
+} MRCPX;
+
+typedef struct mrfft_plan_ {
+  struct mrfft_plan_ *nxt;
+  int32_t N;                      /* real FFT size */
+  int32_t nc;                     /* complex FFT size, N/2 */
+  int32_t pmax;                   /* largest factor */
+  int32_t nfact;
+  int32_t fact[2*MRFFT_MAXFACT];  /* (radix, remaining length) pairs */
+  MRCPX   *stw[MRFFT_MAXFACT];    /* per stage twiddles, in the order
+                                     the butterflies use them */
+  MRCPX   *tw;                    /* exp(-2 pi i k / nc), k < nc */
+  MRCPX   *rtw;                   /* exp(-2 pi i k / N), k <= nc/2 */
+} MRFFT_PLAN;
+
+static inline MRCPX cmul(MRCPX a, MRCPX b)
+{
+  MRCPX c;
+  c.re = a.re * b.re - a.im * b.im;
+  c.im = a.re * b.im + a.im * b.re;
+  return c;
+}
+
+static void bfly2(MRCPX *F, const MRCPX *tw, int32_t m)
+{
+  MRCPX *F2 = F + m, t;
+  int32_t u;
+  for (u = 0; u < m; u++) {
+    t = cmul(F2[u], tw[u]);
+    F2[u].re = F[u].re - t.re;
+    F2[u].im = F[u].im - t.im;
+    F[u].re += t.re;
+    F[u].im += t.im;
+  }
+}
+
+static void bfly3(MRCPX *F, const MRCPX *tw, int32_t m)
+{
+  MRCPX s0, s1, s2, s3;
+  const MYFLT epi3 = FL(-0.86602540378443864676);   /* sin(-2 pi / 3) */
+  int32_t u;
+  for (u = 0; u < m; u++, tw += 2) {
+    s1 = cmul(F[u+m], tw[0]);
+    s2 = cmul(F[u+2*m], tw[1]);
+    s3.re = s1.re + s2.re; s3.im = s1.im + s2.im;
+    s0.re = s1.re - s2.re; s0.im = s1.im - s2.im;
+    F[u+m].re = F[u].re - FL(0.5) * s3.re;
+    F[u+m].im = F[u].im - FL(0.5) * s3.im;
+    F[u].re += s3.re;
+    F[u].im += s3.im;
+    s0.re *= epi3;
+    s0.im *= epi3;
+    F[u+2*m].re = F[u+m].re + s0.im;
+    F[u+2*m].im = F[u+m].im - s0.re;
+    F[u+m].re -= s0.im;
+    F[u+m].im += s0.re;
+  }
+}
+
+static void bfly4(MRCPX *F, const MRCPX *tw, int32_t m)
+{
+  MRCPX s0, s1, s2, s3, s4, s5;
+  int32_t u;
+  for (u = 0; u < m; u++, tw += 3) {
+    s0 = cmul(F[u+m], tw[0]);
+    s1 = cmul(F[u+2*m], tw[1]);
+    s2 = cmul(F[u+3*m], tw[2]);
+    s5.re = F[u].re - s1.re; s5.im = F[u].im - s1.im;
+    F[u].re += s1.re; F[u].im += s1.im;
+    s3.re = s0.re + s2.re; s3.im = s0.im + s2.im;
+    s4.re = s0.re - s2.re; s4.im = s0.im - s2.im;
+    F[u+2*m].re = F[u].re - s3.re;
+    F[u+2*m].im = F[u].im - s3.im;
+    F[u].re += s3.re;
+    F[u].im += s3.im;
+    F[u+m].re = s5.re + s4.im;
+    F[u+m].im = s5.im - s4.re;
+    F[u+3*m].re = s5.re - s4.im;
+    F[u+3*m].im = s5.im + s4.re;
+  }
+}
+
+static void bfly5(MRCPX *F, const MRCPX *tw, int32_t m, MRCPX ya, MRCPX yb)
+{
+  MRCPX s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12;
+  MRCPX *F0 = F, *F1 = F + m, *F2 = F + 2*m, *F3 = F + 3*m, *F4 = F + 4*m;
+  int32_t u;
+  for (u = 0; u < m; u++, tw += 4) {
+    s0 = F0[u];
+    s1 = cmul(F1[u], tw[0]);
+    s2 = cmul(F2[u], tw[1]);
+    s3 = cmul(F3[u], tw[2]);
+    s4 = cmul(F4[u], tw[3]);
+    s7.re = s1.re + s4.re; s7.im = s1.im + s4.im;
+    s10.re = s1.re - s4.re; s10.im = s1.im - s4.im;
+    s8.re = s2.re + s3.re; s8.im = s2.im + s3.im;
+    s9.re = s2.re - s3.re; s9.im = s2.im - s3.im;
+    F0[u].re = s0.re + s7.re + s8.re;
+    F0[u].im = s0.im + s7.im + s8.im;
+    s5.re = s0.re + s7.re * ya.re + s8.re * yb.re;
+    s5.im = s0.im + s7.im * ya.re + s8.im * yb.re;
+    s6.re = s10.im * ya.im + s9.im * yb.im;
+    s6.im = -s10.re * ya.im - s9.re * yb.im;
+    F1[u].re = s5.re - s6.re; F1[u].im = s5.im - s6.im;
+    F4[u].re = s5.re + s6.re; F4[u].im = s5.im + s6.im;
+    s11.re = s0.re + s7.re * yb.re + s8.re * ya.re;
+    s11.im = s0.im + s7.im * yb.re + s8.im * ya.re;
+    s12.re = -s10.im * yb.im + s9.im * ya.im;
+    s12.im = s10.re * yb.im - s9.re * ya.im;
+    F2[u].re = s11.re + s12.re; F2[u].im = s11.im + s12.im;
+    F3[u].re = s11.re - s12.re; F3[u].im = s11.im - s12.im;
+  }
+}
+
+/* any other (odd prime) radix p: pairing inputs q and p-q halves the
+   work of the O(p^2) DFT */
+static void bfly_generic(MRCPX *F, const MRCPX *tw, int32_t m, int32_t p,
+                         const MRFFT_PLAN *plan, MRCPX *scratch)
+{
+  const MRCPX *ptw = plan->tw;
+  int32_t u, q, j, h = (p - 1) / 2, step = plan->nc / p;
+  MRCPX *sum = scratch, *dif = scratch + h;   /* dif[1..h] */
+  for (u = 0; u < m; u++, tw += p - 1) {
+    MRCPX b0 = F[u], b1, b2;
+    sum[0] = b0;
+    for (q = 1; q <= h; q++) {
+      b1 = cmul(F[u + q*m], tw[q-1]);
+      b2 = cmul(F[u + (p-q)*m], tw[p-q-1]);
+      sum[q].re = b1.re + b2.re; sum[q].im = b1.im + b2.im;
+      dif[q].re = b1.re - b2.re; dif[q].im = b1.im - b2.im;
+      sum[0].re += sum[q].re; sum[0].im += sum[q].im;
+    }
+    for (j = 1; j <= h; j++) {
+      MRCPX A = b0, B = { FL(0.0), FL(0.0) };
+      int32_t jq = 0;
+      for (q = 1; q <= h; q++) {
+        MYFLT c, sn;
+        jq += j;
+        if (jq >= p) jq -= p;
+        c = ptw[jq*step].re;
+        sn = -ptw[jq*step].im;     /* sin(2 pi jq / p) */
+        A.re += sum[q].re * c; A.im += sum[q].im * c;
+        B.re += dif[q].re * sn; B.im += dif[q].im * sn;
+      }
+      /* out_j = A - iB, out_(p-j) = A + iB */
+      F[u + j*m].re = A.re + B.im;
+      F[u + j*m].im = A.im - B.re;
+      F[u + (p-j)*m].re = A.re - B.im;
+      F[u + (p-j)*m].im = A.im + B.re;
+    }
+    F[u] = sum[0];
+  }
+}
+
+/* forward complex FFT of plan->nc points, out of place */
+static void mr_work(const MRFFT_PLAN *plan, MRCPX *out, const MRCPX *in,
+                    int32_t fstride, int32_t stage, MRCPX *scratch)
+{
+  int32_t p = plan->fact[2*stage], m = plan->fact[2*stage+1], q;
+  MRCPX *o = out;
+  if (m == 1) {
+    for (q = 0; q < p; q++, in += fstride)
+      *o++ = *in;
+  }
+  else {
+    for (q = 0; q < p; q++, in += fstride, o += m)
+      mr_work(plan, o, in, fstride * p, stage + 1, scratch);
+  }
+  switch (p) {
+  case 2: bfly2(out, plan->stw[stage], m); break;
+  case 3: bfly3(out, plan->stw[stage], m); break;
+  case 4: bfly4(out, plan->stw[stage], m); break;
+  case 5:
+    bfly5(out, plan->stw[stage], m,
+          plan->tw[fstride*m], plan->tw[2*fstride*m]);
+    break;
+  default: bfly_generic(out, plan->stw[stage], m, p, plan, scratch); break;
+  }
+}
+
+static void mr_factor(MRFFT_PLAN *plan)
+{
+  int32_t n = plan->nc, p = 4, i = 0;
+  double floor_sqrt = floor(sqrt((double) n));
+  plan->pmax = 1;
+  /* radix 4 first, then 2, 3, 5, 7, ... */
+  do {
+    while (n % p) {
+      switch (p) {
+      case 4: p = 2; break;
+      case 2: p = 3; break;
+      default: p += 2; break;
+      }
+      if (p > floor_sqrt)
+        p = n;
+    }
+    n /= p;
+    plan->fact[i++] = p;
+    plan->fact[i++] = n;
+    if (p > plan->pmax) plan->pmax = p;
+  } while (n > 1 && i < 2*MRFFT_MAXFACT);
+  plan->nfact = i/2;
+}
+
+static MRFFT_PLAN *mr_new_plan(CSOUND *csound, int32_t N)
+{
+  MRFFT_PLAN *plan;
+  int32_t i, k, fstride, nc = N >> 1;
+  plan = (MRFFT_PLAN *) csound->Calloc(csound, sizeof(MRFFT_PLAN));
+  plan->N = N;
+  plan->nc = nc;
+  plan->tw = (MRCPX *) csound->Malloc(csound, sizeof(MRCPX) * nc);
+  plan->rtw = (MRCPX *) csound->Malloc(csound, sizeof(MRCPX) * (nc/2 + 1));
+  for (k = 0; k < nc; k++) {
+    double a = -2.0 * PI * k / nc;
+    plan->tw[k].re = (MYFLT) cos(a);
+    plan->tw[k].im = (MYFLT) sin(a);
+  }
+  for (k = 0; k <= nc/2; k++) {
+    double a = -2.0 * PI * k / N;
+    plan->rtw[k].re = (MYFLT) cos(a);
+    plan->rtw[k].im = (MYFLT) sin(a);
+  }
+  mr_factor(plan);
+  /* copy the twiddles each stage needs next to each other, so the
+     butterflies read them in sequence */
+  for (i = 0, fstride = 1; i < plan->nfact; i++) {
+    int32_t p = plan->fact[2*i], m = plan->fact[2*i+1], u, j;
+    MRCPX *t = plan->stw[i] =
+      (MRCPX *) csound->Malloc(csound, sizeof(MRCPX) * m * (p > 1 ? p - 1 : 1));
+    for (u = 0; u < m; u++)
+      for (j = 1; j < p; j++)
+        *t++ = plan->tw[j * u * fstride];
+    fstride *= p;
+  }
+  return plan;
+}
+
+/**
+ * Returns the (shared) plan for a real FFT of even size N
+ */
+void *mrfft_get_plan(CSOUND *csound, int32_t N)
+{
+  MRFFT_PLAN *plan;
+  if (UNLIKELY(N < 2 || (N & 1)))
+    return NULL;
+  for (plan = (MRFFT_PLAN *) csound->FFT_plans; plan != NULL;
+       plan = plan->nxt)
+    if (plan->N == N)
+      return (void *) plan;
+  plan = mr_new_plan(csound, N);
+  plan->nxt = (MRFFT_PLAN *) csound->FFT_plans;
+  csound->FFT_plans = (void *) plan;
+  return (void *) plan;
+}
+
+/**
+ * Size in MYFLTs of the scratch space mrfft_execute() needs
+ */
+int32_t mrfft_work_size(void *p)
+{
+  MRFFT_PLAN *plan = (MRFFT_PLAN *) p;
+  return plan->N + 2 * plan->pmax;
+}
+
+/**
+ * In-place real FFT with a plan from mrfft_get_plan(). The spectrum is
+ * packed as with csoundRealFFT(): DC in sig[0], Nyquist in sig[1] and
+ * the other bins as real/imaginary pairs. The inverse is scaled by 1/N.
+ */
+void mrfft_execute(void *p, MYFLT *sig, MYFLT *work, int32_t d)
+{
+  MRFFT_PLAN *plan = (MRFFT_PLAN *) p;
+  int32_t k, nc = plan->nc;
+  MRCPX *X = (MRCPX *) sig, *Z = (MRCPX *) work;
+  MRCPX *scratch = Z + nc;
+  const MRCPX *rtw = plan->rtw;
+
+  if (d == FFT_FWD) {
+    MYFLT dc, ny;
+    mr_work(plan, Z, X, 1, 0, scratch);
+    dc = Z[0].re + Z[0].im;
+    ny = Z[0].re - Z[0].im;
+    /* split: X[k] = (Z[k] + Z*[nc-k])/2 - i W^k (Z[k] - Z*[nc-k])/2 */
+    for (k = 1; k <= nc/2; k++) {
+      MRCPX a = Z[k], b = Z[nc-k], fe, fo, w = rtw[k];
+      fe.re = FL(0.5) * (a.re + b.re);
+      fe.im = FL(0.5) * (a.im - b.im);
+      fo.re = FL(0.5) * (a.im + b.im);
+      fo.im = -FL(0.5) * (a.re - b.re);
+      fo = cmul(fo, w);
+      X[k].re = fe.re + fo.re;
+      X[k].im = fe.im + fo.im;
+      if (k != nc - k) {
+        X[nc-k].re = fe.re - fo.re;
+        X[nc-k].im = fo.im - fe.im;
+      }
+    }
+    sig[0] = dc;
+    sig[1] = ny;
+  }
+  else {
+    MYFLT scal = FL(1.0) / plan->N;
+    /* undo the split, building conj(Z) so that the forward
+       transform does the inverse */
+    Z[0].re = (sig[0] + sig[1]) * scal;
+    Z[0].im = -(sig[0] - sig[1]) * scal;
+    for (k = 1; k <= nc/2; k++) {
+      MRCPX a = X[k], b = X[nc-k], fe, fo, w = rtw[k];
+      fe.re = a.re + b.re;
+      fe.im = a.im - b.im;
+      fo.re = a.re - b.re;
+      fo.im = a.im + b.im;
+      w.im = -w.im;
+      fo = cmul(fo, w);
+      /* Z[k] = fe + i fo, Z[nc-k] = conj(fe) + i conj(fo) */
+      Z[k].re = (fe.re - fo.im) * scal;
+      Z[k].im = -(fe.im + fo.re) * scal;
+      if (k != nc - k) {
+        Z[nc-k].re = (fe.re + fo.im) * scal;
+        Z[nc-k].im = -(fo.re - fe.im) * scal;
+      }
+    }
+    mr_work(plan, X, Z, 1, 0, scratch);
+    for (k = 0; k < nc; k++)
+      X[k].im = -X[k].im;
+  }
+}
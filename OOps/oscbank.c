@@ -0,0 +1,289 @@
+/*
+    oscbank.c:
+
+    Copyright (C) 2026 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#include "csoundCore.h"
+#include "oscbank.h"
+#include "Opcodes/arrayvec.h"
+#include <math.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || \
+    (defined(__i386__) && defined(__SSE2__))
+#  define OSCBANK_SSE2
+#  if defined(__GNUC__) || defined(_MSC_VER)
+#    define OSCBANK_AVX2
+#  endif
+#  include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define OSCBANK_NEON
+#  include <arm_neon.h>
+#endif
+
+#if defined(OSCBANK_AVX2) && defined(__GNUC__)
+#  define AVX2_ATTR __attribute__((target("avx2")))
+#else
+#  define AVX2_ATTR
+#endif
+
+/* the rotor state arrays, each b->max long: amplitude and its
+   increment, the phasor z, the rotation r1 applied to z every sample,
+   and r2 and r3 that rotate r1 and r2 for gliding and cubic phases */
+enum { OB_A, OB_DA, OB_ZR, OB_ZI, OB_R1R, OB_R1I, OB_R2R, OB_R2I,
+       OB_R3R, OB_R3I, OB_NARRAYS };
+
+/* samples per pass over the partials: the lanes of the accumulator
+   for a pass stay in L1 */
+#define OB_CHUNK        64
+
+typedef void (*OSCBANK_SYNTH)(MYFLT *out, MYFLT *st, int32_t stride,
+                              int32_t n, int32_t nsmps);
+
+typedef struct {
+    const char    *name;
+    int32_t       width;
+    OSCBANK_SYNTH synth[3];     /* by phase order */
+} OSCBANK_VEC;
+
+/* One kernel per phase order, written once in terms of a vector type V
+   of W partials.  n is a multiple of W.  Each lane of the accumulator
+   sums the partials k % W == lane; the lanes are added at the end of a
+   chunk. */
+
+#define OSCBANK_SYNTH_ORDER(ISA, ATTR, V, W, LD, ST, SET1, ADD, SUB, MUL, \
+                            ORDER)                                      \
+  static ATTR void synth##ORDER##_##ISA(MYFLT *out, MYFLT *st,          \
+                                        int32_t stride, int32_t n,      \
+                                        int32_t nsmps) {                \
+    MYFLT   lane[OB_CHUNK * W];                                         \
+    int32_t s, k, m, j, len;                                            \
+    for (s = 0; s < nsmps; s += OB_CHUNK) {                             \
+      len = (nsmps - s < OB_CHUNK ? nsmps - s : OB_CHUNK);              \
+      for (m = 0; m < len * W; m++) lane[m] = FL(0.0);                  \
+      for (k = 0; k < n; k += W) {                                      \
+        MYFLT *p = st + k;                                              \
+        V amp = LD(p + OB_A * stride), damp = LD(p + OB_DA * stride);   \
+        V zr = LD(p + OB_ZR * stride), zi = LD(p + OB_ZI * stride);     \
+        V r1r = LD(p + OB_R1R * stride), r1i = LD(p + OB_R1I * stride); \
+        V r2r = LD(p + OB_R2R * stride), r2i = LD(p + OB_R2I * stride); \
+        V r3r = LD(p + OB_R3R * stride), r3i = LD(p + OB_R3I * stride); \
+        for (m = 0; m < len; m++) {                                     \
+          V t;                                                          \
+          ST(lane + m * W, ADD(LD(lane + m * W), MUL(amp, zi)));        \
+          t = SUB(MUL(zr, r1r), MUL(zi, r1i));                          \
+          zi = ADD(MUL(zr, r1i), MUL(zi, r1r));                         \
+          zr = t;                                                       \
+          if (ORDER > 1) {                                              \
+            t = SUB(MUL(r1r, r2r), MUL(r1i, r2i));                      \
+            r1i = ADD(MUL(r1r, r2i), MUL(r1i, r2r));                    \
+            r1r = t;                                                    \
+          }                                                             \
+          if (ORDER > 2) {                                              \
+            t = SUB(MUL(r2r, r3r), MUL(r2i, r3i));                      \
+            r2i = ADD(MUL(r2r, r3i), MUL(r2i, r3r));                    \
+            r2r = t;                                                    \
+          }                                                             \
+          amp = ADD(amp, damp);                                         \
+        }                                                               \
+        ST(p + OB_A * stride, amp);                                     \
+        ST(p + OB_ZR * stride, zr);                                     \
+        ST(p + OB_ZI * stride, zi);                                     \
+        ST(p + OB_R1R * stride, r1r);                                   \
+        ST(p + OB_R1I * stride, r1i);                                   \
+        ST(p + OB_R2R * stride, r2r);                                   \
+        ST(p + OB_R2I * stride, r2i);                                   \
+        (void) r3r; (void) r3i;                                         \
+      }                                                                 \
+      for (m = 0; m < len; m++) {                                       \
+        MYFLT sum = FL(0.0);                                            \
+        for (j = 0; j < W; j++) sum += lane[m * W + j];                 \
+        out[s + m] += sum;                                              \
+      }                                                                 \
+    }                                                                   \
+  }
+
+#define OSCBANK_KERNELS(ISA, ATTR, V, W, LD, ST, SET1, ADD, SUB, MUL)   \
+  OSCBANK_SYNTH_ORDER(ISA, ATTR, V, W, LD, ST, SET1, ADD, SUB, MUL, 1)  \
+  OSCBANK_SYNTH_ORDER(ISA, ATTR, V, W, LD, ST, SET1, ADD, SUB, MUL, 2)  \
+  OSCBANK_SYNTH_ORDER(ISA, ATTR, V, W, LD, ST, SET1, ADD, SUB, MUL, 3)  \
+  static const OSCBANK_VEC oscbank_##ISA = {                            \
+    #ISA, W, { synth1_##ISA, synth2_##ISA, synth3_##ISA }               \
+  };
+
+#define S_LD(p)         (*(p))
+#define S_ST(p, v)      (*(p) = (v))
+#define S_SET1(s)       (s)
+#define S_ADD(a, b)     ((a) + (b))
+#define S_SUB(a, b)     ((a) - (b))
+#define S_MUL(a, b)     ((a) * (b))
+
+OSCBANK_KERNELS(scalar, , MYFLT, 1, S_LD, S_ST, S_SET1, S_ADD, S_SUB, S_MUL)
+
+#ifdef OSCBANK_SSE2
+#ifdef USE_DOUBLE
+OSCBANK_KERNELS(sse2, , __m128d, 2, _mm_loadu_pd, _mm_storeu_pd,
+                _mm_set1_pd, _mm_add_pd, _mm_sub_pd, _mm_mul_pd)
+#else
+OSCBANK_KERNELS(sse2, , __m128, 4, _mm_loadu_ps, _mm_storeu_ps,
+                _mm_set1_ps, _mm_add_ps, _mm_sub_ps, _mm_mul_ps)
+#endif
+#endif
+
+#ifdef OSCBANK_AVX2
+#ifdef USE_DOUBLE
+OSCBANK_KERNELS(avx2, AVX2_ATTR, __m256d, 4, _mm256_loadu_pd,
+                _mm256_storeu_pd, _mm256_set1_pd, _mm256_add_pd,
+                _mm256_sub_pd, _mm256_mul_pd)
+#else
+OSCBANK_KERNELS(avx2, AVX2_ATTR, __m256, 8, _mm256_loadu_ps,
+                _mm256_storeu_ps, _mm256_set1_ps, _mm256_add_ps,
+                _mm256_sub_ps, _mm256_mul_ps)
+#endif
+#endif
+
+#ifdef OSCBANK_NEON
+#ifdef USE_DOUBLE
+OSCBANK_KERNELS(neon, , float64x2_t, 2, vld1q_f64, vst1q_f64, vdupq_n_f64,
+                vaddq_f64, vsubq_f64, vmulq_f64)
+#else
+OSCBANK_KERNELS(neon, , float32x4_t, 4, vld1q_f32, vst1q_f32, vdupq_n_f32,
+                vaddq_f32, vsubq_f32, vmulq_f32)
+#endif
+#endif
+
+/* the kernels of the instruction set the array opcodes chose; that
+   choice already checked the CPU.  oscbank_vec_init() is called once,
+   from csoundInitialize(), after array_vec_init(). */
+
+static const OSCBANK_VEC *oscbank_selected = &oscbank_scalar;
+
+void oscbank_vec_init(void)
+{
+    const OSCBANK_VEC *tab[] = {
+#ifdef OSCBANK_SSE2
+      &oscbank_sse2,
+#endif
+#ifdef OSCBANK_AVX2
+      &oscbank_avx2,
+#endif
+#ifdef OSCBANK_NEON
+      &oscbank_neon,
+#endif
+      &oscbank_scalar
+    };
+    const char *isa = array_vec()->name;
+    size_t  i;
+    for (i = 0; i < sizeof(tab) / sizeof(tab[0]) - 1; i++)
+      if (strcmp(tab[i]->name, isa) == 0)
+        break;
+    oscbank_selected = tab[i];
+}
+
+static inline const OSCBANK_VEC *oscbank_vec(void)
+{
+    return oscbank_selected;
+}
+
+const char *oscbank_isa(void)
+{
+    return oscbank_vec()->name;
+}
+
+OSCBANK *oscbank_alloc(CSOUND *csound, AUXCH *aux, int32_t max)
+{
+    OSCBANK *b;
+    char    *p;
+    size_t  size;
+
+    max = (max + 15) & ~15;
+    size = sizeof(OSCBANK) + 64 +
+      (size_t) max * (4 * sizeof(double) + (2 + OB_NARRAYS) * sizeof(MYFLT));
+    if (aux->auxp == NULL || aux->size < size)
+      csound->AuxAlloc(csound, size, aux);
+    b = (OSCBANK*) aux->auxp;
+    p = (char*) (b + 1);
+    p += (64 - ((uintptr_t) p & 63)) & 63;
+    b->ph = (double*) p;
+    b->c1 = b->ph + max;
+    b->c2 = b->c1 + max;
+    b->c3 = b->c2 + max;
+    b->amp = (MYFLT*) (b->c3 + max);
+    b->damp = b->amp + max;
+    b->st = b->damp + max;
+    b->max = max;
+    b->n = 0;
+    b->order = 1;
+    return b;
+}
+
+/* rotors for sample u of the run, from the exact phase polynomial;
+   partials n to npad are silent padding */
+
+static void oscbank_setup(OSCBANK *b, int32_t npad, double u)
+{
+    MYFLT   *st = b->st;
+    int32_t k, j, max = b->max;
+
+    for (k = 0; k < b->n; k++) {
+      double c1 = b->c1[k], c2 = b->c2[k], c3 = b->c3[k];
+      double ph = b->ph[k] + u * (c1 + u * (c2 + u * c3));
+      double d1 = c1 + c2 * (2.0 * u + 1.0) + c3 * (3.0 * u * (u + 1.0) + 1.0);
+      st[OB_A * max + k] = b->amp[k] + (MYFLT) u * b->damp[k];
+      st[OB_DA * max + k] = b->damp[k];
+      st[OB_ZR * max + k] = (MYFLT) cos(ph);
+      st[OB_ZI * max + k] = (MYFLT) sin(ph);
+      st[OB_R1R * max + k] = (MYFLT) cos(d1);
+      st[OB_R1I * max + k] = (MYFLT) sin(d1);
+      if (b->order > 1) {
+        double d2 = 2.0 * c2 + c3 * (6.0 * u + 6.0);
+        st[OB_R2R * max + k] = (MYFLT) cos(d2);
+        st[OB_R2I * max + k] = (MYFLT) sin(d2);
+      }
+      if (b->order > 2) {
+        double d3 = 6.0 * c3;
+        st[OB_R3R * max + k] = (MYFLT) cos(d3);
+        st[OB_R3I * max + k] = (MYFLT) sin(d3);
+      }
+    }
+    for ( ; k < npad; k++)
+      for (j = 0; j < OB_NARRAYS; j++)
+        st[j * max + k] = FL(0.0);
+}
+
+void oscbank_run(OSCBANK *b, MYFLT *out, int32_t nsmps)
+{
+    const OSCBANK_VEC *v = oscbank_vec();
+    int32_t npad = (b->n + v->width - 1) / v->width * v->width;
+    int32_t s, len;
+
+    if (b->n > 0) {
+      for (s = 0; s < nsmps; s += len) {
+        len = nsmps - s;
+        /* a constant frequency rotor only drifts linearly */
+        if (b->order > 1 && len > OSCBANK_SPAN)
+          len = OSCBANK_SPAN;
+        oscbank_setup(b, npad, (double) s);
+        v->synth[b->order - 1](out + s, b->st, b->max, npad, len);
+      }
+    }
+    b->n = 0;
+    b->order = 1;
+}
@@ -29,6 +29,7 @@
 #include "csoundCore.h"
 #include "pstream.h"
 #include "pvfileio.h"
+#include "oscbank.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -112,16 +113,73 @@ int32_t fassign(CSOUND *csound, FASSIGN *p)
 
 /************* OSCBANK SYNTH ***********/
 
+/* inverse FFT mode: each frame is a spectrum of stationary partials
+   shaped by the transform of a 4 term Blackman-Harris window (main
+   lobe ADSYN_KHALF bins either side), four hops long and centred on
+   the end of the hop.  Only the central two hops are used: there the
+   window is at least 0.217, so dividing it out again does not blow up
+   the error of the truncated kernel, as it would near the window's
+   ends.  The frames are cross faded with triangles over those two
+   hops, so that amplitudes move from one frame to the next as in the
+   oscillator mode. */
+
+#define ADSYN_KHALF     4
+#define ADSYN_KOS       64      /* kernel table points per bin */
+#define ADSYN_KLEN      (ADSYN_KHALF * ADSYN_KOS + 2)
+
+static const double adsyn_bh[4] = { 0.35875, 0.48829, 0.14128, 0.01168 };
+
+/* sum of cos(2 PI x n / N) over n = -N/2 .. N/2 - 1 */
+static double adsyn_dirichlet(double x, int32_t N)
+{
+    double s = sin(PI * x / N);
+    if (fabs(s) < 1.0e-12)
+      return (double) N;
+    return sin(PI * x * (1.0 + 1.0 / N)) / s - cos(PI * x);
+}
+
+/* the window's transform, d bins from its centre */
+static double adsyn_kernel(double d, int32_t N)
+{
+    double  w = adsyn_bh[0] * adsyn_dirichlet(d, N);
+    int32_t j;
+    for (j = 1; j < 4; j++)
+      w += 0.5 * adsyn_bh[j] * (adsyn_dirichlet(d - j, N) +
+                                adsyn_dirichlet(d + j, N));
+    return w;
+}
+
+/* add re + i im to bin b of a real spectrum of size N, folding the
+   bins outside 0 .. N/2 back as their conjugate images */
+static inline void adsyn_bin(MYFLT *buf, int32_t N, int32_t b,
+                             MYFLT re, MYFLT im)
+{
+    if (b < 0) {
+      b = -b;
+      im = -im;
+    }
+    else if (b > N / 2) {
+      b = N - b;
+      im = -im;
+    }
+    if (b == 0)
+      buf[0] += FL(2.0) * re;
+    else if (b == N / 2)
+      buf[1] += FL(2.0) * re;
+    else {
+      buf[2 * b] += re;
+      buf[2 * b + 1] += im;
+    }
+}
+
 int32_t pvadsynset(CSOUND *csound, PVADS *p)
 {
     /* get params from input fsig */
     /* we trust they are legit! */
-    int32_t i;
     PVSDAT  *fs = p->fsig;
     int32_t N = fs->N;
     int32_t noscs,n_oscs;
     int32_t startbin,binoffset;
-    MYFLT *p_x;
 
     if (UNLIKELY(fs->sliding))
       return csound->InitError(csound, Str("Sliding version not yet available"));
@@ -158,6 +216,13 @@ int32_t pvadsynset(CSOUND *csound, PVADS *p)
     if (UNLIKELY(p->maxosc > noscs))
       return csound->InitError(csound, Str("pvsadsyn: "
                               "ibin + (inoscs * ibinoffset) too large."));
+    p->mode = (int32_t) *p->imode;
+    if (UNLIKELY(p->mode < 0 || p->mode > 1))
+      return csound->InitError(csound, Str("pvsadsyn: imode must be 0 or 1"));
+    if (UNLIKELY(p->mode == 1 && p->overlap < 8))
+      return csound->InitError(csound,
+                               Str("pvsadsyn: inverse FFT mode needs an "
+                                   "overlap of at least 8"));
 
     p->outptr = 0;
     p->lastframe = 0;
@@ -166,49 +231,113 @@ int32_t pvadsynset(CSOUND *csound, PVADS *p)
     p->one_over_overlap = (float)(FL(1.0) / p->overlap);
     /* alloc for all oscs;
        in case we can do something with them dynamically, one day */
-    csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->a);
-    csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->x);
-    csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->y);
+    csound->AuxAlloc(csound, noscs * sizeof(double),&p->phase);
     csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->amps);
     csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->lastamps);
     csound->AuxAlloc(csound, noscs * sizeof(MYFLT),&p->freqs);
     csound->AuxAlloc(csound, p->overlap * sizeof(MYFLT),&p->outbuf);
-    /* initialize oscbank */
-    p_x = (MYFLT *) p->x.auxp;
-    for (i=0;i < noscs;i++)
-      p_x[i] = FL(1.0);
+    if (p->mode == 0)
+      oscbank_alloc(csound, &p->bank, noscs);
+    else {
+      int32_t hop = p->overlap, NI = 4 * hop, n;
+      MYFLT   *ker, *comp;
+      csound->AuxAlloc(csound,
+                       (NI + 2 + ADSYN_KLEN + 3 * hop) * sizeof(MYFLT),
+                       &p->ifft);
+      ker = (MYFLT *) p->ifft.auxp + NI + 2;
+      comp = ker + ADSYN_KLEN;
+      for (n = 0; n < ADSYN_KLEN; n++)
+        ker[n] = (MYFLT) adsyn_kernel((double) n / ADSYN_KOS, NI);
+      /* triangle over the central two hops, over the window there:
+         the frames then overlap-add to the partials with their
+         amplitudes interpolated */
+      for (n = 0; n < 2 * hop; n++) {
+        double x = (double) (n - hop) / NI, w = 0.0;
+        int32_t j;
+        for (j = 0; j < 4; j++)
+          w += adsyn_bh[j] * cos(TWOPI * j * x);
+        comp[n] = (MYFLT) ((1.0 - fabs((double) (n - hop) / hop)) / w);
+      }
+      p->setup = csound->RealFFT2Setup(csound, NI, FFT_INV);
+    }
 
     return OK;
 }
-/* c/o John Lazzaro, for SAOL, and many other sources */
-static inline MYFLT fastoscil(MYFLT *a, MYFLT *x, MYFLT *y)
+
+static void adsyn_ifft(CSOUND *csound, PVADS *p, float *frame)
 {
-    *x = *x - *a * *y;
-    *y = *y + *a * *x;
-    /* expensive, but worth it for evenness ? */
-    if (*y < FL(-1.0)) *y = FL(-1.0);
-    if (*y > FL(1.0))  *y = FL(1.0);
-    return *y;
+    int32_t i, b, b0, b1;
+    int32_t startbin  = (int32_t) *p->ibin;
+    int32_t binoffset = (int32_t) *p->ibinoffset;
+    int32_t hop = p->overlap, NI = 4 * hop;
+    MYFLT   *buf = (MYFLT *) p->ifft.auxp, *ker = buf + NI + 2;
+    MYFLT   *comp = ker + ADSYN_KLEN, *ola = comp + 2 * hop;
+    MYFLT   *outbuf = (MYFLT *) p->outbuf.auxp;
+    MYFLT   *amps = (MYFLT *) p->amps.auxp, *freqs = (MYFLT *) p->freqs.auxp;
+    double  *phase = (double *) p->phase.auxp;
+    MYFLT   ffac = *p->kfmod, nyquist = csound->esr * FL(0.5);
+
+    memset(buf, 0, (NI + 2) * sizeof(MYFLT));
+    for (i = startbin; i < p->maxosc; i += binoffset) {
+      MYFLT amp = frame[i*2], freq = ffac * FABS(frame[(i*2)+1]);
+      double k0, ph;
+      MYFLT  re, im;
+      if (freq > nyquist)
+        amp = FL(0.0);
+      /* phase at the end of the hop, kept as in the oscillator mode */
+      phase[i] = fmod(phase[i] + freq * hop * csound->tpidsr, TWOPI);
+      amps[i] = amp;
+      freqs[i] = freq;
+      if (amp == FL(0.0))
+        continue;
+      k0 = freq * NI * csound->onedsr;
+      /* a sine, whose phase at the centre of the frame, the first
+         sample of the next hop, is one sample on */
+      ph = phase[i] + freq * csound->tpidsr;
+      re = (MYFLT) (0.5 * amp * sin(ph));
+      im = (MYFLT) (-0.5 * amp * cos(ph));
+      b0 = (int32_t) ceil(k0 - ADSYN_KHALF);
+      b1 = (int32_t) floor(k0 + ADSYN_KHALF);
+      for (b = b0; b <= b1; b++) {
+        double  d = fabs(b - k0) * ADSYN_KOS;
+        int32_t j = (int32_t) d;
+        MYFLT   g = ker[j] + (ker[j + 1] - ker[j]) * (MYFLT) (d - j);
+        /* odd bins negated: the frame is centred on sample 2 * hop */
+        if (b & 1)
+          g = -g;
+        adsyn_bin(buf, NI, b, g * re, g * im);
+      }
+    }
+    csound->RealFFT2(csound, p->setup, buf);
+    for (i = 0; i < hop; i++) {
+      outbuf[i] = ola[i] + buf[hop + i] * comp[i];
+      ola[i] = buf[2 * hop + i] * comp[hop + i];
+    }
 }
 
 static void adsyn_frame(CSOUND *csound, PVADS *p)
 {
-    int32_t i,j;
+    int32_t i;
     int32_t startbin,lastbin,binoffset;
     MYFLT *outbuf = (MYFLT *) (p->outbuf.auxp);
 
     float *frame;        /* RWD MUST be 32bit */
-    MYFLT *a,*x,*y;
     MYFLT *amps,*freqs,*lastamps;
+    double *phase;
+    OSCBANK *bank;
     MYFLT ffac    = *p->kfmod;
     MYFLT nyquist = csound->esr * FL(0.5);
+
+    frame     = (float *) p->fsig->frame.auxp;
+    if (p->mode) {
+      adsyn_ifft(csound, p, frame);
+      return;
+    }
     /* we add to outbuf, so clear it first*/
     memset(p->outbuf.auxp,0,p->overlap * sizeof(MYFLT));
 
-    frame     = (float *) p->fsig->frame.auxp;
-    a         = (MYFLT *) p->a.auxp;
-    x         = (MYFLT *) p->x.auxp;
-    y         = (MYFLT *) p->y.auxp;
+    bank      = (OSCBANK *) p->bank.auxp;
+    phase     = (double *) p->phase.auxp;
     amps      = (MYFLT *) p->amps.auxp;
     freqs     = (MYFLT *) p->freqs.auxp;
     lastamps  = (MYFLT *) p->lastamps.auxp;
@@ -216,33 +345,29 @@ static void adsyn_frame(CSOUND *csound, PVADS *p)
     binoffset = (int32_t) *p->ibinoffset;
     lastbin   = p->maxosc;
 
-    /*update amps, freqs*/
+    /* we need to interp amplitude, but seems we can avoid doing freqs too,
+       for pvoc so can use direct calc for speed.
+       But large overlap size is not a good idea.
+       Each oscillator carries on from where its phase was at the end
+       of the last hop; silent ones only keep their phase going.
+     */
     for (i=startbin;i < lastbin;i+= binoffset) {
+      double w;
       amps[i] = frame[i*2];
       /* lazy: force all freqs positive! */
       freqs[i] = ffac * FABS(frame[(i*2)+1]);
       /* kill stuff over Nyquist. Need to worry about vlf values? */
       if (freqs[i] > nyquist)
         amps[i] = FL(0.0);
-      a[i] = FL(2.0) * SIN(freqs[i] * csound->pidsr);
-    }
-
-    /* we need to interp amplitude, but seems we can avoid doing freqs too,
-       for pvoc so can use direct calc for speed.
-       But large overlap size is not a good idea.
-       If compiler cannot inline fastoscil,
-       would be worth doing so by hand here ?
-     */
-    for (i=startbin;i < lastbin;i+=binoffset) {
-      MYFLT thisamp = lastamps[i];
-      MYFLT delta_amp = (amps[i] - thisamp) * p->one_over_overlap;
-
-      for (j=0;j < p->overlap;j++) {
-        outbuf[j] += thisamp *  fastoscil(a+i,x+i,y+i);
-        thisamp += delta_amp;
-      }
+      w = freqs[i] * csound->tpidsr;
+      if (amps[i] != FL(0.0) || lastamps[i] != FL(0.0))
+        oscbank_add(bank, lastamps[i],
+                    (amps[i] - lastamps[i]) * p->one_over_overlap,
+                    phase[i] + w, w, 0.0, 0.0);
+      phase[i] = fmod(phase[i] + w * p->overlap, TWOPI);
       lastamps[i] = amps[i];
     }
+    oscbank_run(bank, outbuf, p->overlap);
 }
 
 static MYFLT adsyn_tick(CSOUND *csound, PVADS *p)
@@ -29,6 +29,7 @@
 #include <math.h>
 #include "csoundCore.h"
 #include "pstream.h"
+#include "sdft.h"
 
         double  besseli(double x);
 static  void    hamming(MYFLT *win, int32_t winLen, int32_t even);
@@ -99,7 +100,6 @@ int32_t pvssanalset(CSOUND *csound, PVSANAL *p)
     /* opcode params */
     int32_t N = MYFLT2LRND(*p->winsize);
     int32_t NB;
-    int32_t i;
     int32_t wintype = MYFLT2LRND(*p->wintype);
 
     if (N<=0) return csound->InitError(csound, Str("Invalid window size"));
@@ -118,43 +118,18 @@ int32_t pvssanalset(CSOUND *csound, PVSANAL *p)
         N*sizeof(MYFLT) > (uint32_t)p->input.size)
       csound->AuxAlloc(csound, N*sizeof(MYFLT),&p->input);
     else memset(p->input.auxp, 0, N*sizeof(MYFLT));
-    csound->AuxAlloc(csound, NB * sizeof(double), &p->oldInPhase);
-   if (p->analwinbuf.auxp==NULL ||
-        NB*sizeof(CMPLX) > (uint32_t)p->analwinbuf.size)
-      csound->AuxAlloc(csound, NB*sizeof(CMPLX),&p->analwinbuf);
-    else memset(p->analwinbuf.auxp, 0, NB*sizeof(CMPLX));
     p->inptr = 0;                 /* Pointer in circular buffer */
     p->fsig->NB = p->Ii = NB;
     p->fsig->wintype = wintype;
     p->fsig->format = PVS_AMP_FREQ;      /* only this, for now */
     p->fsig->N = p->nI  = N;
     p->fsig->sliding = 1;
-    /* Need space for NB sines, cosines and a scatch phase area */
-    if (p->trig.auxp==NULL ||
-        (2*NB)*sizeof(double) > (uint32_t)p->trig.size)
-      csound->AuxAlloc(csound,(2*NB)*sizeof(double),&p->trig);
+    /* transform state, sines and cosines and the window, see H/sdft.h */
     {
-      double dc = cos(TWOPI/(double)N);
-      double ds = sin(TWOPI/(double)N);
-      double *c = (double *)(p->trig.auxp);
-      double *s = c+NB;
-      p->cosine = c;
-      p->sine = s;
-      c[0] = 1.0; s[0] = 0.0; // assignment to s unnecessary as auxalloc zeros
-        /*
-          direct computation of c and s may be better for large n
-          c[i] = cos(2*PI*i/n);
-          s[i] = sin(2*PI*i/n);
-          if (i % 16 == 15) {
-          c[i] = cos(2*PI*(i+1)/n);
-          s[i] = sin(2*PI*(i+1)/n);
-        */
-      for (i=1; i<NB; i++) {
-          c[i] = dc*c[i-1] - ds*s[i-1];
-          s[i] = ds*c[i-1] + dc*s[i-1];
-      }
-/*       for (i=0; i<NB; i++)  */
-/*         printf("c[%d] = %f   \ts[%d] = %f\n", i, c[i], i, s[i]); */
+      SDFT_ANAL *sd = sdft_anal_alloc(csound, &p->analwinbuf, N, wintype,
+                                      CS_KSMPS);
+      p->cosine = sd->cr;
+      p->sine = sd->ci;
     }
     return OK;
 }
@@ -263,7 +238,7 @@ int32_t pvsanalset(CSOUND *csound, PVSANAL *p)
     p->fsig->format = PVS_AMP_FREQ;      /* only this, for now */
     p->fsig->sliding = 0;
 
-    if (!(N & (N - 1))) /* if pow of two use this */
+    if (!(N & 1)) /* any even size, mixed radix if not pow of two */
      p->setup = csound->RealFFT2Setup(csound,N,FFT_FWD);
     return OK;
 }
@@ -330,7 +305,7 @@ static void generate_frame(CSOUND *csound, PVSANAL *p)
       /* *(anal + k) += *(analWindow + i) * *(input + j); */
       anal[k] += analWindow[i] * input[j];
     }
-    if (!(N & (N - 1))) {
+    if (!(N & 1)) {
       /* csound->RealFFT(csound, anal, N);*/
       csound->RealFFT2(csound,p->setup,anal);
       anal[N] = anal[1];
@@ -439,234 +414,31 @@ static void anal_tick(CSOUND *csound, PVSANAL *p,MYFLT samp)
 
 }
 
-static inline double mod2Pi(double x)
-{
-    x = fmod(x,TWOPI);
-    if (x <= -PI) {
-        return x + TWOPI;
-    }
-    else if (x > PI) {
-        return x - TWOPI;
-    }
-    else
-      return x;
-}
-
 int32_t pvssanal(CSOUND *csound, PVSANAL *p)
 {
-    MYFLT *ain;
-    int32_t NB = p->Ii, loc;
-    int32_t N = p->fsig->N;
+    MYFLT *ain = p->ain;
+    int32_t loc, N = p->nI;
     MYFLT *data = (MYFLT*)(p->input.auxp);
-    CMPLX *fw = (CMPLX*)(p->analwinbuf.auxp);
-    double *c = p->cosine;
-    double *s = p->sine;
-    double *h = (double*)p->oldInPhase.auxp;
+    SDFT_ANAL *sd = (SDFT_ANAL*)(p->analwinbuf.auxp);
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t i, nsmps = CS_KSMPS;
-    int32_t wintype = p->fsig->wintype;
-    if (UNLIKELY(data==NULL)) {
+
+    if (UNLIKELY(data==NULL || sd==NULL)) {
       return csound->PerfError(csound,&(p->h),
                                Str("pvsanal: Not Initialised.\n"));
     }
-    ain = p->ain;               /* The input samples */
     loc = p->inptr;             /* Circular buffer */
     nsmps -= early;
+    if (UNLIKELY(offset >= nsmps)) return OK;
     for (i=offset; i < nsmps; i++) {
-      MYFLT re, im, dx;
-      CMPLX* ff;
-      int32_t j;
-
-/*       printf("%d: in = %f\n", i, *ain); */
-      dx = *ain - data[loc];    /* Change in sample */
-      data[loc] = *ain++;       /* Remember input sample */
-      /* get the frame for this sample */
-      ff = (CMPLX*)(p->fsig->frame.auxp) + i*NB;
-      /* fw is the current frame at this sample */
-      for (j = 0; j < NB; j++) {
-        double ci = c[j], si = s[j];
-        re = fw[j].re + dx;
-        im = fw[j].im;
-        fw[j].re = ci*re - si*im;
-        fw[j].im = ci*im + si*re;
-      }
-      loc++; if (UNLIKELY(loc==p->nI)) loc = 0; /* Circular buffer */
-      /* apply window and transfer to ff buffer*/
-      /* Rectang :Fw_t =     F_t                          */
-      /* Hamming :Fw_t = 0.54F_t - 0.23[ F_{t-1}+F_{t+1}] */
-      /* Hamming :Fw_t = 0.5 F_t - 0.25[ F_{t-1}+F_{t+1}] */
-      /* Blackman:Fw_t = 0.42F_t - 0.25[ F_{t-1}+F_{t+1}]+0.04[F_{t-2}+F_{t+2}] */
-      /* Blackman_exact:Fw_t = 0.42659071367153912296F_t
-         - 0.24828030954428202923 [F_{t-1}+F_{t+1}]
-         + 0.038424333619948409286 [F_{t-2}+F_{t+2}]      */
-      /* Nuttall_C3:Fw_t = 0.375  F_t - 0.25[ F_{t-1}+F_{t+1}] +
-                                      0.0625 [F_{t-2}+F_{t+2}] */
-      /* BHarris_3:Fw_t = 0.44959 F_t - 0.24682[ F_{t-1}+F_{t+1}] +
-                                      0.02838 [F_{t-2}+F_{t+2}] */
-      /* BHarris_min:Fw_t = 0.42323 F_t - 0.2486703 [ F_{t-1}+F_{t+1}] +
-                                      0.0391396 [F_{t-2}+F_{t+2}] */
-      switch (wintype) {
-      case PVS_WIN_HAMMING:
-        for (j=0; j<NB; j++) {
-          ff[j].re = FL(0.54)*fw[j].re;
-          ff[j].im = FL(0.54)*fw[j].im;
-        }
-        for (j=1; j<NB-1; j++) {
-          ff[j].re -= FL(0.23)*(fw[j+1].re + fw[j-1].re);
-          ff[j].im -= FL(0.23)*(fw[j+1].im + fw[j-1].im);
-        }
-        ff[0].re -= FL(0.46)*fw[1].re;
-        ff[NB-1].re -= FL(0.46)*fw[NB-2].re;
-        break;
-      case PVS_WIN_HANN:
-        for (j=0; j<NB; j++) {
-          ff[j].re = FL(0.5)*fw[j].re;
-          ff[j].im = FL(0.5)*fw[j].im;
-        }
-        for (j=1; j<NB-1; j++) {
-          ff[j].re -= FL(0.25)*(fw[j+1].re + fw[j-1].re);
-          ff[j].im -= FL(0.25)*(fw[j+1].im + fw[j-1].im);
-        }
-        ff[0].re -= FL(0.5)*fw[1].re;
-        ff[NB-1].re -= FL(0.5)*fw[NB-2].re;
-        break;
-      default:
-        csound->Warning(csound,
-                        Str("Unknown window type; replaced by rectangular\n"));
-        /* FALLTHRU */
-      case PVS_WIN_RECT:
-        memcpy(ff, fw, NB*sizeof(CMPLX));
-        /* for (j=0; j<NB; j++) { */
-        /*   ff[j].re = fw[j].re; */
-        /*   ff[j].im = fw[j].im; */
-        /* } */
-        break;
-      case PVS_WIN_BLACKMAN:
-        for (j=0; j<NB; j++) {
-          ff[j].re = FL(0.42)*fw[j].re;
-          ff[j].im = FL(0.42)*fw[j].im;
-        }
-        for (j=1; j<NB-1; j++) {
-          ff[j].re -= FL(0.25)*(fw[j+1].re + fw[j-1].re);
-          ff[j].im -= FL(0.25)*(fw[j+1].im + fw[j-1].im);
-        }
-        for (j=2; j<NB-2; j++) {
-          ff[j].re += FL(0.04)*(fw[j+2].re + fw[j-2].re);
-          ff[j].im += FL(0.04)*(fw[j+2].im + fw[j-2].im);
-        }
-        ff[0].re    += -FL(0.5)*fw[1].re + FL(0.08)*fw[2].re;
-        ff[NB-1].re += -FL(0.5)*fw[NB-2].re + FL(0.08)*fw[NB-3].re;
-        ff[1].re    += -FL(0.5)*fw[2].re + FL(0.08)*fw[3].re;
-        ff[NB-2].re += -FL(0.5)*fw[NB-3].re + FL(0.08)*fw[NB-4].re;
-        break;
-    case PVS_WIN_BLACKMAN_EXACT:
-        for (j=0; j<NB; j++) {
-          ff[j].re = FL(0.42659071367153912296)*fw[j].re;
-          ff[j].im = FL(0.42659071367153912296)*fw[j].im;
-        }
-        for (j=1; j<NB-1; j++) {
-          ff[j].re -= FL(0.49656061908856405847)*FL(0.5)*(fw[j+1].re + fw[j-1].re);
-          ff[j].im -= FL(0.49656061908856405847)*FL(0.5)*(fw[j+1].im + fw[j-1].im);
-        }
-        for (j=2; j<NB-2; j++) {
-          ff[j].re += FL(0.076848667239896818573)*FL(0.5)*(fw[j+2].re + fw[j-2].re);
-          ff[j].im += FL(0.076848667239896818573)*FL(0.5)*(fw[j+2].im + fw[j-2].im);
-        }
-        ff[0].re    += -FL(0.49656061908856405847) * fw[1].re
-                      + FL(0.076848667239896818573) * fw[2].re;
-        ff[NB-1].re += -FL(0.49656061908856405847) * fw[NB-2].re
-                      + FL(0.076848667239896818573) * fw[NB-3].re;
-        ff[1].re    += -FL(0.49656061908856405847) * fw[2].re
-                      + FL(0.076848667239896818573) * fw[3].re;
-        ff[NB-2].re += -FL(0.49656061908856405847) * fw[NB-3].re
-                      + FL(0.076848667239896818573) * fw[NB-4].re;
-        break;
-      case PVS_WIN_NUTTALLC3:
-        for (j=0; j<NB; j++) {
-          ff[j].re = FL(0.375)*fw[j].re;
-          ff[j].im = FL(0.375)*fw[j].im;
-        }
-        for (j=1; j<NB-1; j++) {
-          ff[j].re -= FL(0.5)*FL(0.5)*(fw[j+1].re + fw[j-1].re);
-          ff[j].im -= FL(0.5)*FL(0.5)*(fw[j+1].im + fw[j-1].im);
-        }
-        for (j=2; j<NB-2; j++) {
-          ff[j].re += FL(0.125)*FL(0.5)*(fw[j+2].re + fw[j-2].re);
-          ff[j].im += FL(0.125)*FL(0.5)*(fw[j+2].im + fw[j-2].im);
-        }
-        ff[0].re    += -FL(0.5) * fw[1].re    + FL(0.125) * fw[2].re;
-        ff[NB-1].re += -FL(0.5) * fw[NB-2].re + FL(0.125) * fw[NB-3].re;
-        ff[1].re    += -FL(0.5) * fw[2].re    + FL(0.125) * fw[3].re;
-        ff[NB-2].re += -FL(0.5) * fw[NB-3].re + FL(0.125) * fw[NB-4].re;
-        ff[1].re = 0.5 * (fw[2].re + fw[0].re); /* HACK???? */
-        ff[1].im = 0.5 * (fw[2].im + fw[0].im);
-        break;
-      case PVS_WIN_BHARRIS_3:
-        for (j=0; j<NB; j++) {
-          ff[j].re = FL(0.44959)*fw[j].re;
-          ff[j].im = FL(0.44959)*fw[j].im;
-        }
-        for (j=1; j<NB-1; j++) {
-          ff[j].re -= FL(0.49364)*FL(0.5)*(fw[j+1].re + fw[j-1].re);
-          ff[j].im -= FL(0.49364)*FL(0.5)*(fw[j+1].im + fw[j-1].im);
-        }
-        for (j=2; j<NB-2; j++) {
-          ff[j].re += FL(0.05677)*FL(0.5)*(fw[j+2].re + fw[j-2].re);
-          ff[j].im += FL(0.05677)*FL(0.5)*(fw[j+2].im + fw[j-2].im);
-        }
-        ff[0].re    += -FL(0.49364) * fw[1].re    + FL(0.05677) * fw[2].re;
-        ff[NB-1].re += -FL(0.49364) * fw[NB-2].re + FL(0.05677) * fw[NB-3].re;
-        ff[1].re    += -FL(0.49364) * fw[2].re    + FL(0.05677) * fw[3].re;
-        ff[NB-2].re += -FL(0.49364) * fw[NB-3].re + FL(0.05677) * fw[NB-4].re;
-        ff[1].re = 0.5 * (fw[2].re + fw[0].re); /* HACK???? */
-        ff[1].im = 0.5 * (fw[2].im + fw[0].im);
-        break;
-      case PVS_WIN_BHARRIS_MIN:
-        for (j=0; j<NB; j++) {
-          ff[j].re = FL(0.42323)*fw[j].re;
-          ff[j].im = FL(0.42323)*fw[j].im;
-        }
-        for (j=1; j<NB-1; j++) {
-          ff[j].re -= FL(0.4973406)*FL(0.5)*(fw[j+1].re + fw[j-1].re);
-          ff[j].im -= FL(0.4973406)*FL(0.5)*(fw[j+1].im + fw[j-1].im);
-        }
-        for (j=2; j<NB-2; j++) {
-          ff[j].re += FL(0.0782793)*FL(0.5)*(fw[j+2].re + fw[j-2].re);
-          ff[j].im += FL(0.0782793)*FL(0.5)*(fw[j+2].im + fw[j-2].im);
-        }
-        ff[0].re    += -FL(0.4973406) * fw[1].re    + FL(0.0782793) * fw[2].re;
-        ff[NB-1].re += -FL(0.4973406) * fw[NB-2].re + FL(0.0782793) * fw[NB-3].re;
-        ff[1].re    += -FL(0.4973406) * fw[2].re    + FL(0.0782793) * fw[3].re;
-        ff[NB-2].re += -FL(0.4973406) * fw[NB-3].re + FL(0.0782793) * fw[NB-4].re;
-        ff[1].re = 0.5 * (fw[2].re + fw[0].re); /* HACK???? */
-        ff[1].im = 0.5 * (fw[2].im + fw[0].im);
-        break;
-      }
-/*       if (i==9) { */
-/*         printf("Frame as Amp/Freq %d\n", i); */
-/*         for (j = 0; j < NB; j++) */
-/*           printf("%d: %f\t%f\n", j, ff[j].re, ff[j].im); */
-/*       } */
-      for (j = 0; j < NB; j++) { /* Convert to AMP_FREQ */
-        double thismag = hypot(ff[j].re, ff[j].im);
-        double phase = atan2(ff[j].im, ff[j].re);
-        double angleDif  = phase -  h[j];
-        h[j] = phase;
-            /*subtract expected phase difference */
-        angleDif -= (double)j * TWOPI/N;
-        angleDif =  mod2Pi(angleDif);
-        angleDif =  angleDif * N /TWOPI;
-        ff[j].re = thismag;
-        ff[j].im = csound->esr * (j + angleDif)/N;
-      }
-/*       if (i==9) { */
-/*         printf("Frame as Amp/Freq %d\n", i); */
-/*         for (j = 0; j < NB; j++) */
-/*           printf("%d: %f\t%f\n", j, ff[j].re, ff[j].im); */
-/*       } */
+      sd->dx[i-offset] = ain[i] - data[loc];    /* Change in sample */
+      data[loc] = ain[i];       /* Remember input sample */
+      loc++; if (UNLIKELY(loc==N)) loc = 0; /* Circular buffer */
     }
-
+    /* a frame for each sample */
+    sdft_anal(csound, sd, (CMPLX*)(p->fsig->frame.auxp) + offset*sd->NB,
+              nsmps-offset);
     p->inptr = loc;
     return OK;
 }
@@ -723,8 +495,7 @@ int32_t pvsynthset(CSOUND *csound, PVSYNTH *p)
       /* and put into locals */
       p->wintype = wintype;
       p->format = p->fsig->format;
-      csound->AuxAlloc(csound, p->fsig->NB * sizeof(double), &p->oldOutPhase);
-      csound->AuxAlloc(csound, p->fsig->NB * sizeof(double), &p->output);
+      sdft_synth_alloc(csound, &p->output, N, CS_KSMPS);
       return OK;
     }
     /* and put into locals */
@@ -837,7 +608,7 @@ int32_t pvsynthset(CSOUND *csound, PVSYNTH *p)
     p->nextOut = (MYFLT *) (p->output.auxp);
     p->buflen = buflen;
 
-    if (!(N & (N - 1))) /* if pow of two use this */
+    if (!(N & 1)) /* any even size, mixed radix if not pow of two */
       p->setup = csound->RealFFT2Setup(csound,N,FFT_INV);
     return OK;
 }
@@ -939,7 +710,7 @@ static void process_frame(CSOUND *csound, PVSYNTH *p)
        program must take care to zero each location which it "shifts"
        out (to standard output). The subroutines reals and fft
        together perform an efficient inverse FFT.  */
-    if (!(NO & (NO - 1))) {
+    if (!(NO & 1)) {
       /*printf("N %d %d \n", NO, NO & (NO-1));*/
       syn[1] = syn[NO];
       /* csound->InverseRealFFT(csound, syn, NO);*/
@@ -1009,39 +780,9 @@ static void process_frame(CSOUND *csound, PVSYNTH *p)
 
 int32_t pvssynth(CSOUND *csound, PVSYNTH *p)
 {
-    int32_t i, k;
-    int32_t ksmps = CS_KSMPS;
-    int32_t N = p->fsig->N;
-    int32_t NB = p->fsig->NB;
-    MYFLT *aout = p->aout;
-    CMPLX *ff;
-    double *h = (double*)p->oldOutPhase.auxp;
-    double *output = (double*)p->output.auxp;
-
     /* Get real part from AMP/FREQ */
-    for (i=0; i<ksmps; i++) {
-      MYFLT a;
-      ff = (CMPLX*)(p->fsig->frame.auxp) + i*NB;
-      for (k=0; k<NB; k++) {
-        double tmp, phase;
-
-        tmp = ff[k].im; /* Actually frequency */
-        /* subtract bin mid frequency */
-        tmp -= (double)k * csound->esr/N;
-        /* get bin deviation from freq deviation */
-        tmp *= TWOPI /csound->esr;
-        /* add the overlap phase advance back in */
-        tmp += (double)k*TWOPI/N;
-        h[k] = phase = mod2Pi(h[k] + tmp);
-        output[k] = ff[k].re*cos(phase);
-      }
-      a = FL(0.0);
-      for (k=1; k<NB-1; k++) {
-        a -= output[k];
-        if (k+1<NB-1) a+=output[++k];
-      }
-      aout[i] = (a+a+output[0]-output[NB-1])/N;
-    }
+    sdft_synth(csound, (SDFT_SYNTH*)p->output.auxp,
+               (CMPLX*)(p->fsig->frame.auxp), p->aout, CS_KSMPS);
     return OK;
 }
 
@@ -0,0 +1,887 @@
+/*
+    sdft.c:
+
+    Copyright (C) 2026 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#include "csoundCore.h"
+#include "pstream.h"
+#include "sdft.h"
+#include "Opcodes/arrayvec.h"
+#include <float.h>
+#include <math.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || \
+    (defined(__i386__) && defined(__SSE2__))
+#  define SDFT_SSE2
+#  if defined(__GNUC__) || defined(_MSC_VER)
+#    define SDFT_AVX2
+#  endif
+#  include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define SDFT_NEON
+#  include <arm_neon.h>
+#endif
+
+#if defined(SDFT_AVX2) && defined(__GNUC__)
+#  define AVX2_ATTR __attribute__((target("avx2")))
+#else
+#  define AVX2_ATTR
+#endif
+
+/* samples per pass: the unwindowed spectra of a block stay in cache */
+#define SDFT_BLOCK      32
+/* bins per step of the widest kernel; threads split the bins in these */
+#define SDFT_GROUP      16
+/* fewer bins than this are not worth waking the threads for */
+#define SDFT_THREAD_BINS 512
+
+typedef struct {
+    const char  *name;
+    /* for every sample t < len and bin k0 <= k < k1
+       z[k] = (z[k] + dx[t]) * (cr[k] + i ci[k]),  r[t][k] = z[k] */
+    void    (*rotate)(double *zr, double *zi, const double *cr,
+                      const double *ci, const double *dx, double *rr,
+                      double *ri, int32_t stride, int32_t k0, int32_t k1,
+                      int32_t len);
+    /* re[k], im[k] = magnitude, phase of re[k] + i im[k], k < n */
+    void    (*polar)(double *re, double *im, int32_t n);
+    /* sum of w[k] amp[k] cos(ph[k]), k < n, -pi < ph[k] <= pi */
+    double  (*cosdot)(const double *w, const double *amp, const double *ph,
+                      int32_t n);
+} SDFT_VEC;
+
+/* The kernels are written once in terms of a vector type V of W
+   doubles and the operations V_ADD etc. defined for each instruction
+   set below; n, k0 and k1 are multiples of SDFT_GROUP.  Masks are all
+   ones or all zeros in a lane, as the compares of SSE make them. */
+
+#define V_SEL(m, a, b)  V_OR(V_AND(m, a), V_ANDNOT(m, b))
+
+/* four vectors of W bins at a time, so that the state of 4 W bins is
+   in registers for the whole block and the four rotations overlap */
+#define SDFT_STEP(u, W)                                                 \
+  re = V_ADD(xr##u, d);                                                 \
+  xr##u = V_SUB(V_MUL(wr##u, re), V_MUL(wi##u, xi##u));                 \
+  xi##u = V_ADD(V_MUL(wr##u, xi##u), V_MUL(wi##u, re));                 \
+  V_ST(orr + u * W, xr##u);                                             \
+  V_ST(ori + u * W, xi##u);
+
+#define SDFT_ROTATE(ISA, ATTR, V, W)                                    \
+  static ATTR void rotate_##ISA(double *zr, double *zi,                 \
+                                const double *cr, const double *ci,     \
+                                const double *dx, double *rr,           \
+                                double *ri, int32_t stride,             \
+                                int32_t k0, int32_t k1, int32_t len) {  \
+    int32_t k, t;                                                       \
+    for (k = k0; k < k1; k += 4 * W) {                                  \
+      V xr0 = V_LD(zr + k), xr1 = V_LD(zr + k + W);                     \
+      V xr2 = V_LD(zr + k + 2 * W), xr3 = V_LD(zr + k + 3 * W);         \
+      V xi0 = V_LD(zi + k), xi1 = V_LD(zi + k + W);                     \
+      V xi2 = V_LD(zi + k + 2 * W), xi3 = V_LD(zi + k + 3 * W);         \
+      V wr0 = V_LD(cr + k), wr1 = V_LD(cr + k + W);                     \
+      V wr2 = V_LD(cr + k + 2 * W), wr3 = V_LD(cr + k + 3 * W);         \
+      V wi0 = V_LD(ci + k), wi1 = V_LD(ci + k + W);                     \
+      V wi2 = V_LD(ci + k + 2 * W), wi3 = V_LD(ci + k + 3 * W);         \
+      for (t = 0; t < len; t++) {                                       \
+        double *orr = rr + t * stride + k, *ori = ri + t * stride + k;  \
+        V d = V_SET1(dx[t]), re;                                        \
+        SDFT_STEP(0, W) SDFT_STEP(1, W) SDFT_STEP(2, W) SDFT_STEP(3, W) \
+      }                                                                 \
+      V_ST(zr + k, xr0); V_ST(zr + k + W, xr1);                         \
+      V_ST(zr + k + 2 * W, xr2); V_ST(zr + k + 3 * W, xr3);             \
+      V_ST(zi + k, xi0); V_ST(zi + k + W, xi1);                         \
+      V_ST(zi + k + 2 * W, xi2); V_ST(zi + k + 3 * W, xi3);             \
+    }                                                                   \
+  }
+
+/* atan2 as in the Cephes library: the ratio of the smaller to the
+   larger of |x| and |y| is reduced to |u| < tan(pi/8) and atan(u) is
+   a rational function of u^2, good to about 1e-16; then the octant is
+   restored.  Like atan2(), -0 counts as negative. */
+
+#define SDFT_POLAR(ISA, ATTR, V, W)                                     \
+  static ATTR void polar_##ISA(double *re, double *im, int32_t n) {     \
+    const V sign = V_SET1(-0.0), one = V_SET1(1.0), zero = V_SET1(0.0); \
+    int32_t k;                                                          \
+    for (k = 0; k < n; k += W) {                                        \
+      V x = V_LD(re + k), y = V_LD(im + k), ax, ay, t, u, z, p, q, a;   \
+      V swap, big;                                                      \
+      ax = V_ANDNOT(sign, x);                                           \
+      ay = V_ANDNOT(sign, y);                                           \
+      swap = V_CMPGT(ay, ax);                                           \
+      t = V_DIV(V_MIN(ax, ay), V_MAX(V_MAX(ax, ay), V_SET1(DBL_MIN)));  \
+      big = V_CMPGT(t, V_SET1(0.41421356237309504880));                 \
+      u = V_SEL(big, V_DIV(V_SUB(t, one), V_ADD(t, one)), t);           \
+      z = V_MUL(u, u);                                                  \
+      p = V_ADD(V_MUL(V_SET1(-8.750608600031904122785e-1), z),          \
+                V_SET1(-1.615753718733365076637e1));                    \
+      p = V_ADD(V_MUL(p, z), V_SET1(-7.500855792314704667340e1));       \
+      p = V_ADD(V_MUL(p, z), V_SET1(-1.228866684490136173410e2));       \
+      p = V_ADD(V_MUL(p, z), V_SET1(-6.485021904942025371773e1));       \
+      q = V_ADD(z, V_SET1(2.485846490142306297962e1));                  \
+      q = V_ADD(V_MUL(q, z), V_SET1(1.650270098316988542046e2));        \
+      q = V_ADD(V_MUL(q, z), V_SET1(4.328810604912902668951e2));        \
+      q = V_ADD(V_MUL(q, z), V_SET1(4.853903996359136964868e2));        \
+      q = V_ADD(V_MUL(q, z), V_SET1(1.945506571482613964425e2));        \
+      a = V_ADD(u, V_DIV(V_MUL(V_MUL(u, z), p), q));                    \
+      a = V_SEL(big, V_ADD(V_SET1(SDFT_PIO4),                           \
+                           V_ADD(a, V_SET1(0.5 * SDFT_PIO2_LO))), a);   \
+      a = V_SEL(swap, V_ADD(V_SET1(SDFT_PIO2),                          \
+                            V_SUB(V_SET1(SDFT_PIO2_LO), a)), a);        \
+      a = V_SEL(V_CMPLT(V_OR(V_AND(sign, x), one), zero),               \
+                V_SUB(V_SET1(SDFT_PI), V_SUB(a, V_SET1(SDFT_PI_LO))), a); \
+      V_ST(re + k, V_SQRT(V_ADD(V_MUL(x, x), V_MUL(y, y))));            \
+      V_ST(im + k, V_OR(a, V_AND(sign, y)));                            \
+    }                                                                   \
+  }
+
+/* cosine of -pi < x <= pi: x = n pi/2 + r, |r| <= pi/4, n rounded to
+   nearest by adding and subtracting 1.5 2^52, pi/2 in three parts as
+   in fdlibm, and the Cephes polynomials for sin r and cos r */
+
+#define SDFT_COSDOT(ISA, ATTR, V, W)                                    \
+  static ATTR double cosdot_##ISA(const double *w, const double *amp,   \
+                                  const double *ph, int32_t n) {        \
+    const V sign = V_SET1(-0.0), one = V_SET1(1.0);                     \
+    const V magic = V_SET1(6755399441055744.0);                         \
+    V acc = V_SET1(0.0);                                                \
+    double lane[W], sum = 0.0;                                          \
+    int32_t k;                                                          \
+    for (k = 0; k < n; k += W) {                                        \
+      V x = V_LD(ph + k), m, r, z, s, c;                                \
+      m = V_SUB(V_ADD(V_MUL(x, V_SET1(0.63661977236758134308)), magic), \
+                magic);                                                 \
+      r = V_SUB(x, V_MUL(m, V_SET1(1.57079632673412561417e+00)));       \
+      r = V_SUB(r, V_MUL(m, V_SET1(6.07710050630396597660e-11)));       \
+      r = V_SUB(r, V_MUL(m, V_SET1(2.02226624879595063154e-21)));       \
+      z = V_MUL(r, r);                                                  \
+      s = V_ADD(V_MUL(V_SET1(1.58962301576546568060e-10), z),           \
+                V_SET1(-2.50507477628578072866e-8));                    \
+      s = V_ADD(V_MUL(s, z), V_SET1(2.75573136213857245213e-6));        \
+      s = V_ADD(V_MUL(s, z), V_SET1(-1.98412698295895385996e-4));       \
+      s = V_ADD(V_MUL(s, z), V_SET1(8.33333333332211858878e-3));        \
+      s = V_ADD(V_MUL(s, z), V_SET1(-1.66666666666666307295e-1));       \
+      s = V_ADD(r, V_MUL(V_MUL(r, z), s));                              \
+      c = V_ADD(V_MUL(V_SET1(-1.13585365213876817300e-11), z),          \
+                V_SET1(2.08757008419747316778e-9));                     \
+      c = V_ADD(V_MUL(c, z), V_SET1(-2.75573141792967388112e-7));       \
+      c = V_ADD(V_MUL(c, z), V_SET1(2.48015872888517045348e-5));        \
+      c = V_ADD(V_MUL(c, z), V_SET1(-1.38888888888730564116e-3));       \
+      c = V_ADD(V_MUL(c, z), V_SET1(4.16666666666665929218e-2));        \
+      c = V_ADD(V_SUB(one, V_MUL(V_SET1(0.5), z)),                      \
+                V_MUL(V_MUL(z, z), c));                                 \
+      /* n = +-1: -+sin r; n = 2, -2: -cos r */                         \
+      c = V_SEL(V_CMPEQ(V_ANDNOT(sign, m), one), s, c);                 \
+      c = V_XOR(c, V_AND(sign, V_OR(V_CMPGT(m, V_SET1(0.5)),            \
+                                    V_CMPLT(m, V_SET1(-1.5)))));        \
+      acc = V_ADD(acc, V_MUL(V_MUL(V_LD(w + k), V_LD(amp + k)), c));    \
+    }                                                                   \
+    V_ST(lane, acc);                                                    \
+    for (k = 0; k < W; k++)                                             \
+      sum += lane[k];                                                   \
+    return sum;                                                         \
+  }
+
+#define SDFT_KERNELS(ISA, ATTR, V, W)                                   \
+  SDFT_ROTATE(ISA, ATTR, V, W)                                          \
+  SDFT_POLAR(ISA, ATTR, V, W)                                           \
+  SDFT_COSDOT(ISA, ATTR, V, W)                                          \
+  static const SDFT_VEC sdft_##ISA = {                                  \
+    #ISA, rotate_##ISA, polar_##ISA, cosdot_##ISA                       \
+  };
+
+#define SDFT_PI         3.14159265358979311600e+00
+#define SDFT_PI_LO      1.22464679914735317723e-16
+#define SDFT_PIO2       1.57079632679489655800e+00
+#define SDFT_PIO2_LO    6.12323399573676588613e-17
+#define SDFT_PIO4       7.85398163397448278999e-01
+
+/* scalar: masks through the bits */
+
+static inline uint64_t s_bits(double a)
+{
+    uint64_t u;
+    memcpy(&u, &a, sizeof(u));
+    return u;
+}
+
+static inline double s_dbl(uint64_t u)
+{
+    double  a;
+    memcpy(&a, &u, sizeof(a));
+    return a;
+}
+
+#define V_LD(p)         (*(p))
+#define V_ST(p, v)      (*(p) = (v))
+#define V_SET1(s)       (s)
+#define V_ADD(a, b)     ((a) + (b))
+#define V_SUB(a, b)     ((a) - (b))
+#define V_MUL(a, b)     ((a) * (b))
+#define V_DIV(a, b)     ((a) / (b))
+#define V_SQRT(a)       sqrt(a)
+#define V_MIN(a, b)     ((a) < (b) ? (a) : (b))
+#define V_MAX(a, b)     ((a) > (b) ? (a) : (b))
+#define V_AND(a, b)     s_dbl(s_bits(a) & s_bits(b))
+#define V_ANDNOT(a, b)  s_dbl(~s_bits(a) & s_bits(b))
+#define V_OR(a, b)      s_dbl(s_bits(a) | s_bits(b))
+#define V_XOR(a, b)     s_dbl(s_bits(a) ^ s_bits(b))
+#define V_CMPLT(a, b)   s_dbl((a) < (b) ? ~(uint64_t) 0 : 0)
+#define V_CMPGT(a, b)   s_dbl((a) > (b) ? ~(uint64_t) 0 : 0)
+#define V_CMPEQ(a, b)   s_dbl((a) == (b) ? ~(uint64_t) 0 : 0)
+
+SDFT_KERNELS(scalar, , double, 1)
+
+#undef V_LD
+#undef V_ST
+#undef V_SET1
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_SQRT
+#undef V_MIN
+#undef V_MAX
+#undef V_AND
+#undef V_ANDNOT
+#undef V_OR
+#undef V_XOR
+#undef V_CMPLT
+#undef V_CMPGT
+#undef V_CMPEQ
+
+#ifdef SDFT_SSE2
+#define V_LD            _mm_loadu_pd
+#define V_ST            _mm_storeu_pd
+#define V_SET1          _mm_set1_pd
+#define V_ADD           _mm_add_pd
+#define V_SUB           _mm_sub_pd
+#define V_MUL           _mm_mul_pd
+#define V_DIV           _mm_div_pd
+#define V_SQRT          _mm_sqrt_pd
+#define V_MIN           _mm_min_pd
+#define V_MAX           _mm_max_pd
+#define V_AND           _mm_and_pd
+#define V_ANDNOT        _mm_andnot_pd
+#define V_OR            _mm_or_pd
+#define V_XOR           _mm_xor_pd
+#define V_CMPLT         _mm_cmplt_pd
+#define V_CMPGT         _mm_cmpgt_pd
+#define V_CMPEQ         _mm_cmpeq_pd
+
+SDFT_KERNELS(sse2, , __m128d, 2)
+
+#ifdef SDFT_AVX2
+#undef V_LD
+#undef V_ST
+#undef V_SET1
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_SQRT
+#undef V_MIN
+#undef V_MAX
+#undef V_AND
+#undef V_ANDNOT
+#undef V_OR
+#undef V_XOR
+#undef V_CMPLT
+#undef V_CMPGT
+#undef V_CMPEQ
+#define V_LD            _mm256_loadu_pd
+#define V_ST            _mm256_storeu_pd
+#define V_SET1          _mm256_set1_pd
+#define V_ADD           _mm256_add_pd
+#define V_SUB           _mm256_sub_pd
+#define V_MUL           _mm256_mul_pd
+#define V_DIV           _mm256_div_pd
+#define V_SQRT          _mm256_sqrt_pd
+#define V_MIN           _mm256_min_pd
+#define V_MAX           _mm256_max_pd
+#define V_AND           _mm256_and_pd
+#define V_ANDNOT        _mm256_andnot_pd
+#define V_OR            _mm256_or_pd
+#define V_XOR           _mm256_xor_pd
+#define V_CMPLT(a, b)   _mm256_cmp_pd(a, b, _CMP_LT_OQ)
+#define V_CMPGT(a, b)   _mm256_cmp_pd(a, b, _CMP_GT_OQ)
+#define V_CMPEQ(a, b)   _mm256_cmp_pd(a, b, _CMP_EQ_OQ)
+
+SDFT_KERNELS(avx2, AVX2_ATTR, __m256d, 4)
+#endif
+#endif  /* SDFT_SSE2 */
+
+#ifdef SDFT_NEON
+#define N_U(a)          vreinterpretq_u64_f64(a)
+#define N_F(a)          vreinterpretq_f64_u64(a)
+#define V_LD            vld1q_f64
+#define V_ST            vst1q_f64
+#define V_SET1          vdupq_n_f64
+#define V_ADD           vaddq_f64
+#define V_SUB           vsubq_f64
+#define V_MUL           vmulq_f64
+#define V_DIV           vdivq_f64
+#define V_SQRT          vsqrtq_f64
+#define V_MIN           vminq_f64
+#define V_MAX           vmaxq_f64
+#define V_AND(a, b)     N_F(vandq_u64(N_U(a), N_U(b)))
+#define V_ANDNOT(a, b)  N_F(vbicq_u64(N_U(b), N_U(a)))
+#define V_OR(a, b)      N_F(vorrq_u64(N_U(a), N_U(b)))
+#define V_XOR(a, b)     N_F(veorq_u64(N_U(a), N_U(b)))
+#define V_CMPLT(a, b)   N_F(vcltq_f64(a, b))
+#define V_CMPGT(a, b)   N_F(vcgtq_f64(a, b))
+#define V_CMPEQ(a, b)   N_F(vceqq_f64(a, b))
+
+SDFT_KERNELS(neon, , float64x2_t, 2)
+#endif
+
+static const SDFT_VEC *sdft_selected = &sdft_scalar;
+
+/* called once, from csoundInitialize(), after array_vec_init() */
+
+void sdft_vec_init(void)
+{
+    const SDFT_VEC *tab[] = {
+#ifdef SDFT_SSE2
+      &sdft_sse2,
+#endif
+#ifdef SDFT_AVX2
+      &sdft_avx2,
+#endif
+#ifdef SDFT_NEON
+      &sdft_neon,
+#endif
+      &sdft_scalar
+    };
+    const char *isa = array_vec()->name;
+    size_t  i;
+    for (i = 0; i < sizeof(tab) / sizeof(tab[0]) - 1; i++)
+      if (strcmp(tab[i]->name, isa) == 0)
+        break;
+    sdft_selected = tab[i];
+}
+
+static inline const SDFT_VEC *sdft_vec(void)
+{
+    return sdft_selected;
+}
+
+const char *sdft_isa(void)
+{
+    return sdft_vec()->name;
+}
+
+/* the thread pool */
+
+typedef void (*SDFT_JOB)(SDFT_ENGINE *, void *, int32_t part,
+                         int32_t nparts);
+
+typedef struct {
+    SDFT_ENGINE *e;
+    int32_t     part;
+} SDFT_WORKER;
+
+struct sdft_engine_s {
+    CSOUND      *csound;
+    void        *gate, *cond;   /* start up */
+    void        *busy;          /* one job at a time */
+    void        *start, *sync, *done;   /* barriers of nthreads */
+    int32_t     nthreads;       /* with the performance thread */
+    int32_t     ready;          /* 1 when the barriers exist, -1 to exit */
+    long        running;
+    SDFT_JOB    job;
+    void        *arg;
+    void        *threads[SDFT_MAX_THREADS];
+    SDFT_WORKER workers[SDFT_MAX_THREADS];
+};
+
+static uintptr_t sdft_thread(void *arg)
+{
+    SDFT_WORKER *w = (SDFT_WORKER *) arg;
+    SDFT_ENGINE *e = w->e;
+    CSOUND  *csound = e->csound;
+
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    csound->LockMutex(e->gate);
+    while (e->ready == 0)
+      csoundCondWait(e->cond, e->gate);
+    /* pass the wake up on to the next worker */
+    csoundCondSignal(e->cond);
+    csound->UnlockMutex(e->gate);
+    if (e->ready < 0)
+      return 0;
+    for (;;) {
+      csound->WaitBarrier(e->start);
+      if (!ATOMIC_GET(e->running))
+        break;
+      e->job(e, e->arg, w->part, e->nthreads);
+      csound->WaitBarrier(e->done);
+    }
+    return 0;
+}
+
+static int32_t sdft_engine_reset(CSOUND *csound, void *p)
+{
+    SDFT_ENGINE *e = (SDFT_ENGINE *) p;
+    int32_t i;
+
+    if (e->nthreads > 1) {
+      ATOMIC_SET(e->running, 0);
+      csound->WaitBarrier(e->start);
+      for (i = 0; i < e->nthreads - 1; i++)
+        csound->JoinThread(e->threads[i]);
+      csound->DestroyBarrier(e->start);
+      csound->DestroyBarrier(e->sync);
+      csound->DestroyBarrier(e->done);
+    }
+    csoundDestroyCondVar(e->cond);
+    csound->DestroyMutex(e->gate);
+    csound->DestroyMutex(e->busy);
+    return OK;
+}
+
+/* the pool of this instance, or NULL if --sdft-threads is not above 1 */
+
+static SDFT_ENGINE *sdft_engine(CSOUND *csound)
+{
+    SDFT_ENGINE *e;
+    int32_t i, n, m = 0;
+
+#ifdef __EMSCRIPTEN__
+    n = 1;
+#else
+    n = csound->oparms->sdft_threads;
+#endif
+    if (n < 2)
+      return NULL;
+    if (n > SDFT_MAX_THREADS)
+      n = SDFT_MAX_THREADS;
+    e = (SDFT_ENGINE *) csound->QueryGlobalVariable(csound, "SDFT_ENGINE");
+    if (e != NULL)
+      return e;
+    if (UNLIKELY(csound->CreateGlobalVariable(csound, "SDFT_ENGINE",
+                                              sizeof(SDFT_ENGINE)) != 0))
+      return NULL;
+    e = (SDFT_ENGINE *) csound->QueryGlobalVariable(csound, "SDFT_ENGINE");
+    e->csound = csound;
+    e->gate = csound->Create_Mutex(0);
+    e->busy = csound->Create_Mutex(0);
+    e->cond = csoundCreateCondVar();
+    e->running = 1;
+    for (i = 1; i < n; i++) {
+      e->workers[m].e = e;
+      e->workers[m].part = m + 1;
+      if ((e->threads[m] = csound->CreateThread(sdft_thread,
+                                                &e->workers[m])) == NULL)
+        break;
+      m++;
+    }
+    if (m > 0) {
+      e->start = csound->CreateBarrier(m + 1);
+      e->sync = csound->CreateBarrier(m + 1);
+      e->done = csound->CreateBarrier(m + 1);
+    }
+    csound->LockMutex(e->gate);
+    e->ready = (m > 0 && e->start && e->sync && e->done) ? 1 : -1;
+    csoundCondSignal(e->cond);
+    csound->UnlockMutex(e->gate);
+    if (e->ready < 0) {
+      for (i = 0; i < m; i++)
+        csound->JoinThread(e->threads[i]);
+      if (e->start) csound->DestroyBarrier(e->start);
+      if (e->sync) csound->DestroyBarrier(e->sync);
+      if (e->done) csound->DestroyBarrier(e->done);
+      csound->Warning(csound, "%s", Str("sliding DFT: could not start "
+                                        "threads, running on one"));
+      m = 0;
+    }
+    e->nthreads = m + 1;
+    csound->RegisterResetCallback(csound, (void *) e, sdft_engine_reset);
+    return e;
+}
+
+/* run job on every thread of the pool, or on this one alone; returns
+   the number of parts the work was split into */
+
+static int32_t sdft_run(CSOUND *csound, SDFT_ENGINE *e, SDFT_JOB job,
+                        void *arg, int32_t nbins)
+{
+    int32_t n;
+
+    if (e == NULL || e->nthreads < 2 || nbins < SDFT_THREAD_BINS ||
+        csound->LockMutexNoWait(e->busy) != 0) {
+      job(NULL, arg, 0, 1);
+      return 1;
+    }
+    n = e->nthreads;
+    e->job = job;
+    e->arg = arg;
+    csound->WaitBarrier(e->start);
+    job(e, arg, 0, n);
+    csound->WaitBarrier(e->done);
+    csound->UnlockMutex(e->busy);
+    return n;
+}
+
+/* part of n items, in whole groups */
+
+static void sdft_range(int32_t n, int32_t group, int32_t part,
+                       int32_t nparts, int32_t *k0, int32_t *k1)
+{
+    int32_t g = (n + group - 1) / group;
+
+    *k0 = g * part / nparts * group;
+    *k1 = g * (part + 1) / nparts * group;
+    if (*k0 > n) *k0 = n;
+    if (*k1 > n) *k1 = n;
+}
+
+static inline double mod2pi(double x)
+{
+    x = fmod(x, TWOPI);
+    if (x <= -PI)
+      return x + TWOPI;
+    else if (x > PI)
+      return x - TWOPI;
+    return x;
+}
+
+/* analysis */
+
+SDFT_ANAL *sdft_anal_alloc(CSOUND *csound, AUXCH *aux, int32_t N,
+                           int32_t wintype, int32_t ksmps)
+{
+    SDFT_ANAL *sd;
+    char    *p;
+    int32_t NB = N / 2 + 1, npad, i;
+    double  dc, ds;
+
+    npad = (NB + SDFT_GROUP - 1) / SDFT_GROUP * SDFT_GROUP;
+    csound->AuxAlloc(csound, sizeof(SDFT_ANAL) + 64 + sizeof(double) *
+                     ((size_t) npad * (8 + 2 * SDFT_BLOCK) + ksmps), aux);
+    sd = (SDFT_ANAL *) aux->auxp;
+    p = (char *) (sd + 1);
+    p += (64 - ((uintptr_t) p & 63)) & 63;
+    sd->cr = (double *) p;
+    sd->ci = sd->cr + npad;
+    sd->zr = sd->ci + npad;
+    sd->zi = sd->zr + npad;
+    sd->ph = sd->zi + npad;
+    sd->binph = sd->ph + npad;
+    sd->tr = sd->binph + npad;
+    sd->ti = sd->tr + npad;
+    sd->rr = sd->ti + npad;
+    sd->ri = sd->rr + (size_t) SDFT_BLOCK * npad;
+    sd->dx = sd->ri + (size_t) SDFT_BLOCK * npad;
+    sd->N = N;
+    sd->NB = NB;
+    sd->npad = npad;
+    sd->esr = csound->esr;
+    /* the rotations by recurrence, as they always were; the padding
+       bins stay at zero */
+    dc = cos(TWOPI / (double) N);
+    ds = sin(TWOPI / (double) N);
+    sd->cr[0] = 1.0;
+    for (i = 1; i < NB; i++) {
+      sd->cr[i] = dc * sd->cr[i - 1] - ds * sd->ci[i - 1];
+      sd->ci[i] = ds * sd->cr[i - 1] + dc * sd->ci[i - 1];
+    }
+    for (i = 0; i < NB; i++)
+      sd->binph[i] = (double) i * TWOPI / N;
+
+    /* the window, applied to the spectrum:
+       Rectang :Fw_t =     F_t
+       Hamming :Fw_t = 0.54F_t - 0.23[ F_{t-1}+F_{t+1}]
+       Hann    :Fw_t = 0.5 F_t - 0.25[ F_{t-1}+F_{t+1}]
+       Blackman:Fw_t = 0.42F_t - 0.25[ F_{t-1}+F_{t+1}]+0.04[F_{t-2}+F_{t+2}]
+       Blackman_exact:Fw_t = 0.42659071367153912296F_t
+         - 0.24828030954428202923 [F_{t-1}+F_{t+1}]
+         + 0.038424333619948409286 [F_{t-2}+F_{t+2}]
+       Nuttall_C3:Fw_t = 0.375  F_t - 0.25[ F_{t-1}+F_{t+1}] +
+                                      0.0625 [F_{t-2}+F_{t+2}]
+       BHarris_3:Fw_t = 0.44959 F_t - 0.24682[ F_{t-1}+F_{t+1}] +
+                                      0.02838 [F_{t-2}+F_{t+2}]
+       BHarris_min:Fw_t = 0.42323 F_t - 0.2486703 [ F_{t-1}+F_{t+1}] +
+                                      0.0391396 [F_{t-2}+F_{t+2}]
+       e1 and e2, twice b1 and c2, are what the bins at the edges take
+       from their neighbours */
+    sd->hack = 0;
+    switch (wintype) {
+    case PVS_WIN_HAMMING:
+      sd->terms = 2; sd->a0 = 0.54; sd->b1 = 0.23; sd->c2 = 0.0;
+      sd->e1 = 0.46; sd->e2 = 0.0;
+      break;
+    case PVS_WIN_HANN:
+      sd->terms = 2; sd->a0 = 0.5; sd->b1 = 0.25; sd->c2 = 0.0;
+      sd->e1 = 0.5; sd->e2 = 0.0;
+      break;
+    case PVS_WIN_BLACKMAN:
+      sd->terms = 3; sd->a0 = 0.42; sd->b1 = 0.25; sd->c2 = 0.04;
+      sd->e1 = 0.5; sd->e2 = 0.08;
+      break;
+    case PVS_WIN_BLACKMAN_EXACT:
+      sd->terms = 3; sd->a0 = 0.42659071367153912296;
+      sd->e1 = 0.49656061908856405847; sd->e2 = 0.076848667239896818573;
+      sd->b1 = sd->e1 * 0.5; sd->c2 = sd->e2 * 0.5;
+      break;
+    case PVS_WIN_NUTTALLC3:
+      sd->terms = 3; sd->a0 = 0.375; sd->b1 = 0.25; sd->c2 = 0.0625;
+      sd->e1 = 0.5; sd->e2 = 0.125; sd->hack = 1;
+      break;
+    case PVS_WIN_BHARRIS_3:
+      sd->terms = 3; sd->a0 = 0.44959; sd->e1 = 0.49364; sd->e2 = 0.05677;
+      sd->b1 = sd->e1 * 0.5; sd->c2 = sd->e2 * 0.5; sd->hack = 1;
+      break;
+    case PVS_WIN_BHARRIS_MIN:
+      sd->terms = 3; sd->a0 = 0.42323; sd->e1 = 0.4973406;
+      sd->e2 = 0.0782793; sd->b1 = sd->e1 * 0.5; sd->c2 = sd->e2 * 0.5;
+      sd->hack = 1;
+      break;
+    default:
+      csound->Warning(csound,
+                      Str("Unknown window type; replaced by rectangular\n"));
+      /* FALLTHRU */
+    case PVS_WIN_RECT:
+      sd->terms = 1; sd->a0 = 1.0; sd->b1 = sd->c2 = 0.0;
+      sd->e1 = sd->e2 = 0.0;
+      break;
+    }
+    sd->engine = sdft_engine(csound);
+    return sd;
+}
+
+/* windowed bin j of a spectrum for the bins near 0 and Nyquist, where
+   the neighbours beyond the edge are the mirror image */
+
+static void sdft_window_edge(const SDFT_ANAL *sd, const double *fr,
+                             const double *fi, int32_t j,
+                             double *pr, double *pi)
+{
+    int32_t NB = sd->NB;
+    double  wr = fr[j], wi = fi[j];
+
+    if (sd->terms > 1) {
+      wr *= sd->a0;
+      wi *= sd->a0;
+      if (j >= 1 && j < NB - 1) {
+        wr -= sd->b1 * (fr[j + 1] + fr[j - 1]);
+        wi -= sd->b1 * (fi[j + 1] + fi[j - 1]);
+      }
+      if (sd->terms > 2 && j >= 2 && j < NB - 2) {
+        wr += sd->c2 * (fr[j + 2] + fr[j - 2]);
+        wi += sd->c2 * (fi[j + 2] + fi[j - 2]);
+      }
+      if (sd->terms == 2) {
+        if (j == 0)
+          wr -= sd->e1 * fr[1];
+        if (j == NB - 1)
+          wr -= sd->e1 * fr[NB - 2];
+      }
+      else if (NB >= 4) {
+        if (j == 0)
+          wr += -sd->e1 * fr[1] + sd->e2 * fr[2];
+        if (j == NB - 1)
+          wr += -sd->e1 * fr[NB - 2] + sd->e2 * fr[NB - 3];
+        if (j == 1)
+          wr += -sd->e1 * fr[2] + sd->e2 * fr[3];
+        if (j == NB - 2)
+          wr += -sd->e1 * fr[NB - 3] + sd->e2 * fr[NB - 4];
+        if (sd->hack && j == 1) {
+          wr = 0.5 * (fr[2] + fr[0]);
+          wi = 0.5 * (fi[2] + fi[0]);
+        }
+      }
+    }
+    *pr = wr;
+    *pi = wi;
+}
+
+/* window a row into tr, ti; to amplitude and frequency from the phase
+   change since the last sample, which is nearly always in range
+   already */
+
+static void sdft_convert(const SDFT_ANAL *sd, const SDFT_VEC *v,
+                         const double *fr, const double *fi, CMPLX *ff,
+                         int32_t k0, int32_t k1)
+{
+    int32_t j, j1 = (k1 < sd->NB ? k1 : sd->NB);
+    int32_t lo = (k0 > 2 ? k0 : 2), hi = (j1 < sd->NB - 2 ? j1 : sd->NB - 2);
+    double  a0 = sd->a0, b1 = sd->b1, c2 = sd->c2;
+    double  *tr = sd->tr, *ti = sd->ti;
+
+    for (j = k0; j < j1 && j < lo; j++)
+      sdft_window_edge(sd, fr, fi, j, &tr[j], &ti[j]);
+    switch (sd->terms) {
+    case 1:
+      for ( ; j < hi; j++) {
+        tr[j] = fr[j];
+        ti[j] = fi[j];
+      }
+      break;
+    case 2:
+      for ( ; j < hi; j++) {
+        tr[j] = a0 * fr[j] - b1 * (fr[j + 1] + fr[j - 1]);
+        ti[j] = a0 * fi[j] - b1 * (fi[j + 1] + fi[j - 1]);
+      }
+      break;
+    default:
+      for ( ; j < hi; j++) {
+        tr[j] = a0 * fr[j] - b1 * (fr[j + 1] + fr[j - 1]) +
+          c2 * (fr[j + 2] + fr[j - 2]);
+        ti[j] = a0 * fi[j] - b1 * (fi[j + 1] + fi[j - 1]) +
+          c2 * (fi[j + 2] + fi[j - 2]);
+      }
+      break;
+    }
+    for ( ; j < j1; j++)
+      sdft_window_edge(sd, fr, fi, j, &tr[j], &ti[j]);
+    v->polar(tr + k0, ti + k0, k1 - k0);
+    for (j = k0; j < j1; j++) {
+      double d = ti[j] - sd->ph[j];
+      sd->ph[j] = ti[j];
+      d -= sd->binph[j];
+      if (UNLIKELY(d <= -PI || d > PI))
+        d = mod2pi(d);
+      d = d * sd->N / TWOPI;
+      ff[j].re = (MYFLT) tr[j];
+      ff[j].im = (MYFLT) (sd->esr * (j + d) / sd->N);
+    }
+}
+
+static void sdft_anal_job(SDFT_ENGINE *e, void *arg, int32_t part,
+                          int32_t nparts)
+{
+    SDFT_ANAL *sd = (SDFT_ANAL *) arg;
+    const SDFT_VEC *v = sdft_vec();
+    int32_t k0, k1, s, t, len, npad = sd->npad;
+
+    sdft_range(npad, SDFT_GROUP, part, nparts, &k0, &k1);
+    for (s = 0; s < sd->nsmps; s += len) {
+      len = (sd->nsmps - s < SDFT_BLOCK ? sd->nsmps - s : SDFT_BLOCK);
+      /* the spectra of the last block are read by every thread */
+      if (s > 0 && e != NULL)
+        e->csound->WaitBarrier(e->sync);
+      v->rotate(sd->zr, sd->zi, sd->cr, sd->ci, sd->dx + s,
+                sd->rr, sd->ri, npad, k0, k1, len);
+      if (e != NULL)
+        e->csound->WaitBarrier(e->sync);
+      for (t = 0; t < len; t++)
+        sdft_convert(sd, v, sd->rr + (size_t) t * npad,
+                     sd->ri + (size_t) t * npad,
+                     sd->frame + (size_t) (s + t) * sd->NB, k0, k1);
+    }
+}
+
+void sdft_anal(CSOUND *csound, SDFT_ANAL *sd, CMPLX *frame, int32_t nsmps)
+{
+    if (nsmps <= 0)
+      return;
+    sd->frame = frame;
+    sd->nsmps = nsmps;
+    sdft_run(csound, sd->engine, sdft_anal_job, sd, sd->NB);
+}
+
+/* synthesis */
+
+SDFT_SYNTH *sdft_synth_alloc(CSOUND *csound, AUXCH *aux, int32_t N,
+                             int32_t ksmps)
+{
+    SDFT_SYNTH *sy;
+    int32_t NB = N / 2 + 1, npad, i;
+
+    npad = (NB + SDFT_GROUP - 1) / SDFT_GROUP * SDFT_GROUP;
+    csound->AuxAlloc(csound, sizeof(SDFT_SYNTH) + sizeof(double) *
+                     ((size_t) 5 * npad + (SDFT_MAX_THREADS + 2) * ksmps),
+                     aux);
+    sy = (SDFT_SYNTH *) aux->auxp;
+    sy->ph = (double *) (sy + 1);
+    sy->fc = sy->ph + npad;
+    sy->binph = sy->fc + npad;
+    sy->w = sy->binph + npad;
+    sy->amp = sy->w + npad;
+    sy->acc = sy->amp + npad;
+    sy->first = sy->acc + SDFT_MAX_THREADS * ksmps;
+    sy->last = sy->first + ksmps;
+    sy->N = N;
+    sy->NB = NB;
+    sy->npad = npad;
+    sy->ksmps = ksmps;
+    sy->scale = TWOPI / csound->esr;
+    for (i = 0; i < NB; i++) {
+      sy->fc[i] = (double) i * csound->esr / N;
+      sy->binph[i] = (double) i * TWOPI / N;
+    }
+    /* bins 1 to NB - 2 alternate in sign, 0 and NB - 1 are added apart */
+    for (i = 1; i < NB - 1; i++)
+      sy->w[i] = (i & 1) ? -1.0 : 1.0;
+    sy->engine = sdft_engine(csound);
+    return sy;
+}
+
+static void sdft_synth_job(SDFT_ENGINE *e, void *arg, int32_t part,
+                           int32_t nparts)
+{
+    SDFT_SYNTH *sy = (SDFT_SYNTH *) arg;
+    const SDFT_VEC *v = sdft_vec();
+    int32_t NB = sy->NB, k0, k1, j1, k, t;
+    double  *ph = sy->ph, *amp = sy->amp;
+    double  *acc = sy->acc + part * sy->ksmps;
+
+    (void) e;
+    sdft_range(sy->npad, SDFT_GROUP, part, nparts, &k0, &k1);
+    j1 = (k1 < NB ? k1 : NB);
+    for (t = 0; t < sy->nsmps; t++) {
+      const CMPLX *ff = sy->frame + (size_t) t * NB;
+      /* advance the phases by the frequencies */
+      for (k = k0; k < j1; k++) {
+        double tmp = ff[k].im, x;
+        tmp -= sy->fc[k];       /* bin deviation from frequency */
+        tmp *= sy->scale;
+        tmp += sy->binph[k];    /* add the overlap phase advance back in */
+        x = ph[k] + tmp;
+        if (UNLIKELY(x <= -PI || x > PI))
+          x = mod2pi(x);
+        ph[k] = x;
+        amp[k] = ff[k].re;
+      }
+      acc[t] = v->cosdot(sy->w + k0, amp + k0, ph + k0, k1 - k0);
+      if (k0 == 0)
+        sy->first[t] = amp[0] * cos(ph[0]);
+      if (j1 == NB)
+        sy->last[t] = amp[NB - 1] * cos(ph[NB - 1]);
+    }
+}
+
+void sdft_synth(CSOUND *csound, SDFT_SYNTH *sy, const CMPLX *frame,
+                MYFLT *out, int32_t nsmps)
+{
+    int32_t n, t, i;
+
+    sy->frame = frame;
+    sy->nsmps = nsmps;
+    n = sdft_run(csound, sy->engine, sdft_synth_job, sy, sy->NB);
+    for (t = 0; t < nsmps; t++) {
+      double a = sy->acc[t];
+      for (i = 1; i < n; i++)
+        a += sy->acc[i * sy->ksmps + t];
+      out[t] = (MYFLT) ((a + a + sy->first[t] - sy->last[t]) / sy->N);
+    }
+}
@@ -67,20 +67,45 @@ typedef struct {
 } OSCSEND;
 
 
-typedef struct osc_pat {
-    struct osc_pat *next;
-    union {
-      MYFLT number;
-      STRINGDAT string;
-      void     *blob;
-    } args[ARG_CNT-1];
-} OSC_PAT;
+#define OSC_QUEUE_SIZE  (64)    /* messages held per listener, power of 2 */
+#define OSC_HASH_SIZE   (256)   /* listener buckets per port, power of 2 */
+#define OSC_STRSIZE     (256)   /* string space preallocated per message */
+#define OSC_BLOBSIZE    (4096)  /* blob space per message, when the size
+                                   cannot be told at init */
+/* bytes taken by a blob of n data bytes, as counted by lo_blobsize() */
+#define OSC_BLOB_BYTES(n) ((int32_t) sizeof(int32_t) + (((int32_t) (n) + 3) & ~3))
+
+#if defined(_MSC_VER)
+#define OSC_LOAD_PTR(x)     InterlockedCompareExchangePointer( \
+                              (PVOID volatile *) &(x), NULL, NULL)
+#define OSC_STORE_PTR(x, v) InterlockedExchangePointer( \
+                              (PVOID volatile *) &(x), (PVOID) (v))
+#else
+#define OSC_LOAD_PTR(x)     __atomic_load_n(&(x), __ATOMIC_SEQ_CST)
+#define OSC_STORE_PTR(x, v) __atomic_store_n(&(x), (v), __ATOMIC_SEQ_CST)
+#endif
+
+/* one argument of a queued message; blobs are kept in the string
+   buffer too, with size the space allocated.  All of it is allocated
+   when OSClisten starts, and a message with a longer string or blob
+   than its slot holds is dropped, so that the liblo thread never calls
+   the allocator. */
+typedef union {
+    MYFLT     number;
+    STRINGDAT string;
+} OSC_ARG;
 
 typedef struct {
     lo_server_thread thread;
     CSOUND  *csound;
-    void    *mutex_;
-    void    *oplst;             /* list of opcodes listening on this port */
+    void    *mutex_;            /* orders OSClisten init/deinit */
+    /* listeners hashed on path and types; the liblo thread walks the
+       chains without a lock, so links are published atomically */
+    struct osclcommon *volatile *table;
+    volatile long handling;     /* odd while OSC_handler runs */
+    volatile long queued;       /* messages waiting on this port */
+    volatile long dropped;      /* messages lost to a full listener queue */
+    long    maxdepth;           /* deepest any listener queue has been */
 } OSC_PORT;
 
 /* structure for global variables */
@@ -89,9 +114,8 @@ typedef struct {
     CSOUND  *csound;
     /* for OSCinit/OSClisten */
     int32_t   nPorts;
-    OSC_PORT  *ports;
-    int32_t   osccounter;
-    void      *mutex_;
+    OSC_PORT  **ports;
+    volatile int32_t osccounter;
 } OSC_GLOBALS;
 
 /* opcode for starting the OSC listener (called once from orchestra header) */
@@ -108,13 +132,17 @@ typedef struct {
     MYFLT   *port;              /* Port number on which to listen */
 } OSCINITM;
 
+/* The liblo thread is the only writer of a listener's queue and the
+   OSClisten opcode its only reader, so neither side takes a lock. */
 typedef struct osclcommon {
     lo_method method;
     char    *saved_path;
     char    saved_types[ARG_CNT];    /* copy of type list */
-    OSC_PAT *patterns;          /* FIFO list of pending messages */
-    OSC_PAT *freePatterns;      /* free message stack */
-    struct osclcomon *nxt;       /* pointer to next opcode on the same port */
+    uint32_t hash;              /* of saved_path and saved_types */
+    int32_t nargs;
+    OSC_ARG *slots;             /* OSC_QUEUE_SIZE messages of nargs each */
+    volatile long wp, rp;       /* messages written / read */
+    struct osclcommon *volatile nxt; /* next listener in the same bucket */
 } OSCLCOMMON;
 
 typedef struct {
@@ -139,6 +167,13 @@ typedef struct {
     OSCLCOMMON c;
 } OSCLISTENA;
 
+typedef struct {
+    OPDS    h;
+    MYFLT   *kdropped, *kqueued, *kmaxdepth;
+    MYFLT   *ihandle;
+    OSC_PORT *port;
+} OSCSTATS;
+
 static int32_t oscsend_deinit(CSOUND *csound, OSCSEND *p)
 {
     lo_address a = (lo_address)p->addr;
@@ -398,10 +433,10 @@ static int32_t OSC_reset(CSOUND *csound, OSC_GLOBALS *p)
 {
     int32_t i;
     for (i = 0; i < p->nPorts; i++)
-      if (p->ports[i].thread) {
-        lo_server_thread_stop(p->ports[i].thread);
-        lo_server_thread_free(p->ports[i].thread);
-        csound->DestroyMutex(p->ports[i].mutex_);
+      if (p->ports[i]->thread) {
+        lo_server_thread_stop(p->ports[i]->thread);
+        lo_server_thread_free(p->ports[i]->thread);
+        csound->DestroyMutex(p->ports[i]->mutex_);
       }
     csound->DestroyGlobalVariable(csound, "_OSC_globals");
     return OK;
@@ -429,7 +464,6 @@ static CS_NOINLINE OSC_GLOBALS *alloc_globals(CSOUND *csound)
     }
     pp = (OSC_GLOBALS*) csound->QueryGlobalVariable(csound, "_OSC_globals");
     pp->csound = csound;
-    pp->mutex_ = csound->Create_Mutex(0);
     csound->RegisterResetCallback(csound, (void*) pp,
                                   (int32_t (*)(CSOUND *, void *)) OSC_reset);
     return pp;
@@ -439,30 +473,18 @@ static CS_NOINLINE OSC_GLOBALS *alloc_globals(CSOUND *csound)
 
  /* ------------------------------------------------------------------------ */
 
-static CS_NOINLINE OSC_PAT *alloc_pattern(CSOUND *csound)
+/* FNV-1a over path, a separator and types */
+static uint32_t osc_hash(const char *path, const char *types)
 {
-    OSC_PAT *p;
-    size_t  nbytes;
-
-    /* number of bytes to allocate */
-    nbytes = sizeof(OSC_PAT);
-    /* allocate and initialise structure */
-    p = (OSC_PAT*) csound->Calloc(csound, nbytes);
-
-    return p;
+    uint32_t h = 2166136261U;
+    while (*path != '\0')
+      h = (h ^ (unsigned char) *path++) * 16777619U;
+    h *= 16777619U;
+    while (*types != '\0')
+      h = (h ^ (unsigned char) *types++) * 16777619U;
+    return h;
 }
 
-static inline OSC_PAT *get_pattern(CSOUND *csound,OSCLCOMMON *pp)
-{
-    OSC_PAT *p;
-
-    if (pp->freePatterns != NULL) {
-      p = pp->freePatterns;
-      pp->freePatterns = p->next;
-      return p;
-    }
-    return alloc_pattern(csound);
-}
 
 typedef struct {
       OPDS h;             /* default header */
@@ -472,8 +494,74 @@ typedef struct {
 static int32_t OSCcounter(CSOUND *csound, OSCcount *p)
 {
     OSC_GLOBALS *g = alloc_globals(csound);
-    *p->ans = (MYFLT)g->osccounter;
+    *p->ans = (MYFLT)ATOMIC_GET(g->osccounter);
+    return OK;
+}
+
+/* copy a message into the next free slot of o's queue, or count it as
+   dropped if OSClisten has fallen OSC_QUEUE_SIZE messages behind or a
+   string or blob does not fit its slot */
+static int32_t osc_enqueue(CSOUND *csound, OSC_PORT *pp, OSCLCOMMON *o,
+                           const char *types, lo_arg **argv)
+{
+    long    wp = o->wp, depth = wp - ATOMIC_GET(o->rp);
+    OSC_ARG *m;
+    int32_t i;
+
+    if (UNLIKELY(depth >= OSC_QUEUE_SIZE)) {
+      ATOMIC_INCR(pp->dropped);
+      return NOTOK;
+    }
+    m = &o->slots[(wp & (OSC_QUEUE_SIZE-1)) * o->nargs];
+    for (i = 0; i < o->nargs; i++) {
+      switch (types[i]) {
+      default:              /* Should not happen */
+      case 'i':
+        m[i].number = (MYFLT) argv[i]->i; break;
+      case 'h':
+        m[i].number = (MYFLT) argv[i]->i64; break;
+      case 'c':
+        m[i].number = (MYFLT) argv[i]->c; break;
+      case 'f':
+        m[i].number = (MYFLT) argv[i]->f; break;
+      case 'd':
+        m[i].number = (MYFLT) argv[i]->d; break;
+      case 's':
+        {
+          const char *src = (const char*) &(argv[i]->s);
+          int32_t len = (int32_t) strlen(src) + 1;
+          if (UNLIKELY(m[i].string.size < len))
+            goto oversize;
+          memcpy(m[i].string.data, src, len);
+          break;
+        }
+      case 'b':
+        {
+          int32_t len = lo_blobsize((lo_blob*)argv[i]);
+          if (UNLIKELY(m[i].string.size < len))
+            goto oversize;
+          memcpy(m[i].string.data, argv[i], len);
+#ifdef OSC_DEBUG
+          {
+            lo_blob *bb = (lo_blob*)m[i].string.data;
+            int32_t size = lo_blob_datasize(bb);
+            MYFLT *data = lo_blob_dataptr(bb);
+            int32_t   *idata = (int32_t*)data;
+            printf("size=%d data=%.8x %.8x ...\n",size, idata[0], idata[1]);
+          }
+#endif
+        }
+      }
+    }
+    if (depth + 1 > pp->maxdepth)
+      pp->maxdepth = depth + 1;
+    ATOMIC_SET(o->wp, wp + 1);
+    ATOMIC_INCR(pp->queued);
     return OK;
+ oversize:
+    /* nothing was published, so the slot is simply reused */
+    ATOMIC_INCR(pp->dropped);
+    return NOTOK;
 }
 
 static int32_t OSC_handler(const char *path, const char *types,
@@ -483,92 +571,41 @@ static int32_t OSC_handler(const char *path, const char *types,
     OSC_PORT  *pp = (OSC_PORT*) p;
     OSCLCOMMON *o;
     CSOUND    *csound = (CSOUND *) pp->csound;
-    int32_t       retval = 1;
-
-    pp->csound->LockMutex(pp->mutex_);
-    o = (OSCLCOMMON*) pp->oplst;
-    //printf("opst=%p\n", o);
-    while (o != NULL) {
-      //printf("Looking at %s/%s against %s/%s\n",
-      //       o->saved_path, path,o->saved_types, types);
-      if (strcmp(o->saved_path, path) == 0 &&
-          strcmp(o->saved_types, types) == 0) {
-        /* Message is for this guy */
-        int32_t     i;
-        OSC_PAT *m;
-        OSC_GLOBALS *g = alloc_globals(csound);
-        pp->csound->LockMutex(g->mutex_);
-        g->osccounter++;
-        pp->csound->UnlockMutex(g->mutex_);
-        m = get_pattern(csound, o);
-        if (m != NULL) {
-          /* queue message for being read by OSClisten opcode */
-          m->next = NULL;
-          if (o->patterns == NULL)
-            o->patterns = m;
-          else {
-            OSC_PAT *mm;
-            for (mm = o->patterns; mm->next != NULL; mm = mm->next)
-              ;
-            mm->next = m;
-          }
-          /* copy argument list */
-          for (i = 0; o->saved_types[i] != '\0'; i++) {
-            switch (types[i]) {
-            default:              /* Should not happen */
-            case 'i':
-              m->args[i].number = (MYFLT) argv[i]->i; break;
-            case 'h':
-              m->args[i].number = (MYFLT) argv[i]->i64; break;
-            case 'c':
-               m->args[i].number= (MYFLT) argv[i]->c; break;
-            case 'f':
-               m->args[i].number = (MYFLT) argv[i]->f; break;
-            case 'd':
-               m->args[i].number= (MYFLT) argv[i]->d; break;
-            case 's':
-              { // ***NO CHECK THAT m->args[i] IS A STRING
-                char  *src = (char*) &(argv[i]->s), *dst = m->args[i].string.data;
-                if (m->args[i].string.size <= (int32_t) strlen(src)) {
-                  if (dst != NULL) csound->Free(csound, dst);
-                  dst = csound->Strdup(csound, src);
-                  // who sets m->args[i].string.size ??
-                  m->args[i].string.data = dst;
-                  m->args[i].string.size = strlen(dst)+1;
-                }
-                else strcpy(dst, src);
-                break;
-              }
-            case 'b':
-              {
-                int32_t len =
-                  lo_blobsize((lo_blob*)argv[i]);
-                m->args[i].blob =
-                  csound->Malloc(csound,len);
-                memcpy(m->args[i].blob, argv[i], len);
-#ifdef OSC_DEBUG
-                {
-                  lo_blob *bb = (lo_blob*)m->args[i].blob;
-                  int32_t size = lo_blob_datasize(bb);
-                  MYFLT *data = lo_blob_dataptr(bb);
-                  int32_t   *idata = (int32_t*)data;
-                  printf("size=%d data=%.8x %.8x ...\n",size, idata[0], idata[1]);
-                }
-#endif
-              }
-            }
-          }
-          retval = 0;
-        }
+    uint32_t  h = osc_hash(path, types);
+    int32_t   retval = 1;
+
+    /* a listener unlinked from the table is not released while this
+       runs; see osc_port_quiesce() */
+    ATOMIC_INCR(pp->handling);
+    for (o = OSC_LOAD_PTR(pp->table[h & (OSC_HASH_SIZE-1)]); o != NULL;
+         o = OSC_LOAD_PTR(o->nxt))
+      if (o->hash == h && strcmp(o->saved_path, path) == 0 &&
+          strcmp(o->saved_types, types) == 0)
         break;
+    if (o != NULL) {
+      /* Message is for this guy */
+      if (osc_enqueue(csound, pp, o, types, argv) == OK) {
+        OSC_GLOBALS *g = alloc_globals(csound);
+        ATOMIC_INCR(g->osccounter);
       }
-      o = (OSCLCOMMON*) o->nxt;
+      retval = 0;
     }
-
-    pp->csound->UnlockMutex(pp->mutex_);
+    ATOMIC_INCR(pp->handling);
     return retval;
 }
 
+/* Wait until the liblo thread cannot be looking at a listener just
+   unlinked from the table.  It runs one handler at a time, so only a
+   handler that was already running needs to end; later ones cannot
+   find the listener.  That takes no longer than one message copy. */
+static void osc_port_quiesce(OSC_PORT *port)
+{
+    long h = ATOMIC_GET(port->handling);
+    if (h & 1)
+      while (ATOMIC_GET(port->handling) == h)
+        CPU_RELAX();
+}
+
 static void OSC_error(int32_t num, const char *msg, const char *path)
 {
     fprintf(stderr, "OSC server error %d in path %s: %s\n", num, path, msg);
@@ -578,46 +615,58 @@ static int32_t OSC_deinit(CSOUND *csound, OSCINIT *p)
 {
     int32_t n = (int32_t)*p->ihandle;
     OSC_GLOBALS *pp = alloc_globals(csound);
-    OSC_PORT    *ports;
+    OSC_PORT    *port;
     if (UNLIKELY(pp==NULL)) return NOTOK;
-    ports = pp->ports;
+    port = pp->ports[n];
     csound->Message(csound, "handle=%d\n", n);
-    csound->DestroyMutex(ports[n].mutex_);
-    ports[n].mutex_ = NULL;
-    lo_server_thread_stop(ports[n].thread);
-    lo_server_thread_free(ports[n].thread);
-    ports[n].thread =  NULL;
+    lo_server_thread_stop(port->thread);
+    lo_server_thread_free(port->thread);
+    port->thread =  NULL;
+    csound->DestroyMutex(port->mutex_);
+    port->mutex_ = NULL;
     csound->Message(csound, "%s", Str("OSC deinitialised\n"));
     return OK;
 }
 
+/* add a port to the globals; ports are allocated one by one, as the
+   listeners and liblo hold pointers to them */
+static OSC_PORT *osc_new_port(CSOUND *csound, OSC_GLOBALS *pp)
+{
+    OSC_PORT *port = (OSC_PORT*) csound->Calloc(csound, sizeof(OSC_PORT));
+    port->csound = csound;
+    port->mutex_ = csound->Create_Mutex(0);
+    port->table = (OSCLCOMMON *volatile *) csound->Calloc(csound,
+                                                OSC_HASH_SIZE *
+                                                sizeof(OSCLCOMMON*));
+    pp->ports = (OSC_PORT**) csound->ReAlloc(csound, pp->ports,
+                                             sizeof(OSC_PORT*) *
+                                             (pp->nPorts + 1));
+    pp->ports[pp->nPorts] = port;
+    return port;
+}
+
 static int32_t osc_listener_init(CSOUND *csound, OSCINIT *p)
 {
     OSC_GLOBALS *pp;
-    OSC_PORT    *ports;
+    OSC_PORT    *port;
     char        buff[32];
     int32_t         n;
 
     /* allocate and initialise the globals structure */
     pp = alloc_globals(csound);
     n = pp->nPorts;
-    ports = (OSC_PORT*) csound->ReAlloc(csound, pp->ports,
-                                        sizeof(OSC_PORT) * (n + 1));
-    ports[n].csound = csound;
-    ports[n].mutex_ = csound->Create_Mutex(0);
-    ports[n].oplst = NULL;
+    port = osc_new_port(csound, pp);
     snprintf(buff, 32, "%d", (int32_t) *(p->port));
-    ports[n].thread = lo_server_thread_new(buff, OSC_error);
-    if (UNLIKELY(ports[n].thread==NULL))
+    port->thread = lo_server_thread_new(buff, OSC_error);
+    if (UNLIKELY(port->thread==NULL))
       return csound->InitError(csound,
                                Str("cannot start OSC listener on port %s\n"),
                                buff);
-    ///if (lo_server_thread_start(ports[n].thread)<0)
+    ///if (lo_server_thread_start(port->thread)<0)
     ///  return csound->InitError(csound,
     ///                           Str("cannot start OSC listener on port %s\n"),
     ///                           buff);
-    lo_server_thread_start(ports[n].thread);
-    pp->ports = ports;
+    lo_server_thread_start(port->thread);
     pp->nPorts = n + 1;
     csound->Warning(csound, Str("OSC listener #%d started on port %s\n"), n, buff);
     *(p->ihandle) = (MYFLT) n;
@@ -629,31 +678,26 @@ static int32_t osc_listener_init(CSOUND *csound, OSCINIT *p)
 static int32_t osc_listener_initMulti(CSOUND *csound, OSCINITM *p)
 {
     OSC_GLOBALS *pp;
-    OSC_PORT    *ports;
+    OSC_PORT    *port;
     char        buff[32];
     int32_t     n;
 
     /* allocate and initialise the globals structure */
     pp = alloc_globals(csound);
     n = pp->nPorts;
-    ports = (OSC_PORT*) csound->ReAlloc(csound, pp->ports,
-                                        sizeof(OSC_PORT) * (n + 1));
-    ports[n].csound = csound;
-    ports[n].mutex_ = csound->Create_Mutex(0);
-    ports[n].oplst = NULL;
+    port = osc_new_port(csound, pp);
     snprintf(buff, 32, "%d", (int32_t) *(p->port));
-    ports[n].thread = lo_server_thread_new_multicast(p->group->data,
-                                                     buff, OSC_error);
-    if (UNLIKELY(ports[n].thread==NULL))
+    port->thread = lo_server_thread_new_multicast(p->group->data,
+                                                  buff, OSC_error);
+    if (UNLIKELY(port->thread==NULL))
       return csound->InitError(csound,
                                Str("cannot start OSC listener on port %s\n"),
                                buff);
-    ///if (lo_server_thread_start(ports[n].thread)<0)
+    ///if (lo_server_thread_start(port->thread)<0)
     ///  return csound->InitError(csound,
     ///                           Str("cannot start OSC listener on port %s\n"),
     ///                           buff);
-    lo_server_thread_start(ports[n].thread);
-    pp->ports = ports;
+    lo_server_thread_start(port->thread);
     pp->nPorts = n + 1;
     csound->Warning(csound,
                     Str("OSC multicast listener #%d started on port %s\n"),
@@ -664,21 +708,72 @@ static int32_t osc_listener_initMulti(CSOUND *csound, OSCINITM *p)
     return OK;
 }
 
+static OSC_PORT *osc_find_port(CSOUND *csound, MYFLT *ihandle)
+{
+    int32_t n;
+    OSC_GLOBALS *pp =
+      (OSC_GLOBALS*) csound->QueryGlobalVariable(csound, "_OSC_globals");
+    if (UNLIKELY(pp == NULL)) {
+      csound->InitError(csound, "%s", Str("OSC not running"));
+      return NULL;
+    }
+    n = (int32_t) *ihandle;
+    if (UNLIKELY(n < 0 || n >= pp->nPorts)) {
+      csound->InitError(csound, "%s", Str("invalid handle"));
+      return NULL;
+    }
+    return pp->ports[n];
+}
+
+/* set up the message queue of a listener whose saved_path and
+   saved_types are filled in, and enter it in the port's table; argsize
+   gives the bytes to hold for each string or blob argument */
+static void osc_listen_start(CSOUND *csound, OSC_PORT *port, OSCLCOMMON *c,
+                             const int32_t *argsize)
+{
+    int32_t i, j;
+    uint32_t bucket;
+
+    c->nargs = (int32_t) strlen(c->saved_types);
+    c->hash = osc_hash(c->saved_path, c->saved_types);
+    c->wp = c->rp = 0;
+    c->slots = (OSC_ARG*) csound->Calloc(csound, OSC_QUEUE_SIZE *
+                                         (c->nargs > 0 ? c->nargs : 1) *
+                                         sizeof(OSC_ARG));
+    for (j = 0; j < OSC_QUEUE_SIZE; j++) {
+      OSC_ARG *m = &c->slots[j * c->nargs];
+      for (i = 0; i < c->nargs; i++)
+        if (c->saved_types[i] == 's' || c->saved_types[i] == 'b') {
+          m[i].string.data = (char*) csound->Malloc(csound, argsize[i]);
+          m[i].string.size = argsize[i];
+        }
+    }
+    bucket = c->hash & (OSC_HASH_SIZE-1);
+    csound->LockMutex(port->mutex_);
+    c->nxt = port->table[bucket];
+    OSC_STORE_PTR(port->table[bucket], c);
+    csound->UnlockMutex(port->mutex_);
+    c->method = lo_server_thread_add_method(port->thread,
+                                            c->saved_path, c->saved_types,
+                                            OSC_handler, port);
+}
+
 static int32_t OSC_listendeinit(CSOUND *csound, OSC_PORT *port, OSCLCOMMON *p)
 {
-    OSC_PAT *m;
+    OSCLCOMMON *volatile *o;
+    int32_t i, j;
+    long    pending;
 
     if (port->mutex_==NULL) return NOTOK;
     csound->LockMutex(port->mutex_);
-    if (port->oplst == (void*)p)
-      port->oplst = p->nxt;
-    else {
-      OSCLCOMMON *o = (OSCLCOMMON*) port->oplst;
-      for ( ; o->nxt != (void*) p; o = (OSCLCOMMON*) o->nxt)
-        ;
-      o->nxt = p->nxt;
-    }
+    for (o = &port->table[p->hash & (OSC_HASH_SIZE-1)]; *o != NULL;
+         o = &(*o)->nxt)
+      if (*o == p) {
+        OSC_STORE_PTR(*o, p->nxt);
+        break;
+      }
     csound->UnlockMutex(port->mutex_);
+    osc_port_quiesce(port);
 #ifdef LIBLO29
     //Would like to use this call but requires liblo2.29
     lo_server_thread_del_lo_method (port->thread, p->method);
@@ -688,19 +783,23 @@ static int32_t OSC_listendeinit(CSOUND *csound, OSC_PORT *port, OSCLCOMMON *p)
     csound->Free(csound, p->saved_path);
     p->saved_path = NULL;
     p->nxt = NULL;
-    m = p->patterns;
-    p->patterns = NULL;
-    while (m != NULL) {
-      OSC_PAT *mm = m->next;
-      csound->Free(csound, m);
-      m = mm;
+    /* messages never read no longer count as waiting */
+    pending = p->wp - p->rp;
+    if (pending > 0) {
+      OSC_GLOBALS *g = alloc_globals(csound);
+      ATOMIC_SUB(g->osccounter, (int32_t) pending);
+      ATOMIC_SUB(port->queued, pending);
     }
-    m = p->freePatterns;
-    p->freePatterns = NULL;
-    while (m != NULL) {
-      OSC_PAT *mm = m->next;
-      csound->Free(csound, m);
-      m = mm;
+    if (p->slots != NULL) {
+      for (j = 0; j < OSC_QUEUE_SIZE; j++) {
+        OSC_ARG *m = &p->slots[j * p->nargs];
+        for (i = 0; i < p->nargs; i++)
+          if ((p->saved_types[i] == 's' || p->saved_types[i] == 'b') &&
+              m[i].string.data != NULL)
+            csound->Free(csound, m[i].string.data);
+      }
+      csound->Free(csound, p->slots);
+      p->slots = NULL;
     }
     return OK;
 }
@@ -718,20 +817,26 @@ static int32_t OSC_listadeinit(CSOUND *csound, OSCLISTENA *p)
 }
 
 
+/* blob space for an array output: what it holds now, or OSC_BLOBSIZE
+   if that is more, as arrays are often sized by the first message */
+static int32_t osc_array_bytes(ARRAYDAT *arr, int32_t header)
+{
+    int32_t j, n = (arr->data != NULL && arr->dimensions > 0) ? 1 : 0;
+    for (j = 0; j < arr->dimensions && arr->sizes != NULL; j++)
+      n *= arr->sizes[j];
+    n = header + n * (int32_t) sizeof(MYFLT);
+    return OSC_BLOB_BYTES(n > OSC_BLOBSIZE ? n : OSC_BLOBSIZE);
+}
+
 static int32_t OSC_list_init(CSOUND *csound, OSCLISTEN *p)
 {
     //void  *x;
     int32_t   i, n;
+    int32_t   argsize[ARG_CNT];
 
-    OSC_GLOBALS *pp =
-      (OSC_GLOBALS*) csound->QueryGlobalVariable(csound, "_OSC_globals");
-    if (UNLIKELY(pp == NULL))
-      return csound->InitError(csound, "%s", Str("OSC not running"));
     /* find port */
-    n = (int32_t) *(p->ihandle);
-    if (UNLIKELY(n < 0 || n >= pp->nPorts))
-      return csound->InitError(csound, "%s", Str("invalid handle"));
-    p->port = &(pp->ports[n]);
+    if (UNLIKELY((p->port = osc_find_port(csound, p->ihandle)) == NULL))
+      return NOTOK;
     p->c.saved_path = (char*) csound->Malloc(csound,
                                            strlen((char*) p->dest->data) + 1);
     strcpy(p->c.saved_path, (char*) p->dest->data);
@@ -749,12 +854,36 @@ static int32_t OSC_list_init(CSOUND *csound, OSCLISTEN *p)
       s = csound->GetInputArgName(p, i + 3);
       if (s[0] == 'g')
         s++;
+      argsize[i] = 0;
       switch (p->c.saved_types[i]) {
       case 'G':
+        {
+          /* the table the k-variable names at init, if any */
+          FUNC *ftp = MYFLT2LRND(*p->args[i]) > 0 ?
+                        csound->FTnp2Find(csound, p->args[i]) : NULL;
+          int32_t len = ftp != NULL ? (int32_t) (ftp->flen * sizeof(MYFLT)) : 0;
+          argsize[i] = OSC_BLOB_BYTES(len > OSC_BLOBSIZE ? len : OSC_BLOBSIZE);
+          p->c.saved_types[i] = 'b';
+          break;
+        }
       case 'A':
+        /* dimension count and sizes come before the data */
+        argsize[i] = osc_array_bytes((ARRAYDAT*) p->args[i],
+                                     (int32_t) sizeof(int32_t) *
+                                     (1 + ((ARRAYDAT*) p->args[i])->dimensions));
+        p->c.saved_types[i] = 'b';
+        break;
       case 'D':
+        argsize[i] = osc_array_bytes((ARRAYDAT*) p->args[i], 0);
+        p->c.saved_types[i] = 'b';
+        break;
       case 'a':
+        /* a count and ksmps samples */
+        argsize[i] = OSC_BLOB_BYTES(sizeof(MYFLT) * (CS_KSMPS + 1));
+        p->c.saved_types[i] = 'b';
+        break;
       case 'S':
+        argsize[i] = OSC_BLOB_BYTES(OSC_BLOBSIZE);
         p->c.saved_types[i] = 'b';
         break;
       case 'c':
@@ -770,257 +899,151 @@ static int32_t OSC_list_init(CSOUND *csound, OSCLISTEN *p)
         if (UNLIKELY(*s != 'S'))
           return csound->InitError(csound, "%s", Str("argument list inconsistent "
                                                "with format string"));
+        argsize[i] = OSC_STRSIZE;
         break;
       default:
         return csound->InitError(csound, "%s", Str("invalid type"));
       }
     }
-    csound->LockMutex(p->port->mutex_);
-    p->c.nxt = p->port->oplst;
-    p->port->oplst = (void*) &p->c;
-    csound->UnlockMutex(p->port->mutex_);
-    p->c.method = lo_server_thread_add_method(p->port->thread,
-                                              p->c.saved_path, p->c.saved_types,
-                                              OSC_handler, p->port);
+    osc_listen_start(csound, p->port, &p->c, argsize);
     csound->RegisterDeinitCallback(csound, p,
                                    (int32_t (*)(CSOUND *, void *)) OSC_listdeinit);
     return OK;
 }
 
-static int32_t OSC_list(CSOUND *csound, OSCLISTEN *p)
+/* copy one queued message to the outputs of OSClisten */
+static int32_t osc_list_copy(CSOUND *csound, OSCLISTEN *p, OSC_ARG *m)
 {
-    OSC_PAT *m;
-
-    /* quick check for empty queue */
-    if (p->c.patterns == NULL) {
-      *p->kans = 0;
-      return OK;
-    }
-    csound->LockMutex(p->port->mutex_);
-    m = p->c.patterns;
-    /* check again for thread safety */
-    if (m != NULL) {
-      int32_t i;
-      /* unlink from queue */
-      p->c.patterns = m->next;
-      /* copy arguments */
-      //printf("copying args\n");
-      for (i = 0; p->c.saved_types[i] != '\0'; i++) {
-        //printf("%d: type %c\n", i, p->c.saved_types[i]);
-        if (p->c.saved_types[i] == 's') {
-          char *src = m->args[i].string.data;
-          char *dst = ((STRINGDAT*) p->args[i])->data;
-          if (src != NULL) {
-            if (((STRINGDAT*) p->args[i])->size <= (int32_t) strlen(src)){
-              if (dst != NULL) csound->Free(csound, dst);
-              dst = csound->Strdup(csound, src);
-              ((STRINGDAT*) p->args[i])->size = strlen(dst) + 1;
-              ((STRINGDAT*) p->args[i])->data = dst;
-           }
-          else
-            strcpy(dst, src);
-          }
+    int32_t i;
+    for (i = 0; p->c.saved_types[i] != '\0'; i++) {
+      //printf("%d: type %c\n", i, p->c.saved_types[i]);
+      if (p->c.saved_types[i] == 's') {
+        char *src = m[i].string.data;
+        char *dst = ((STRINGDAT*) p->args[i])->data;
+        if (src != NULL) {
+          if (((STRINGDAT*) p->args[i])->size <= (int32_t) strlen(src)){
+            if (dst != NULL) csound->Free(csound, dst);
+            dst = csound->Strdup(csound, src);
+            ((STRINGDAT*) p->args[i])->size = strlen(dst) + 1;
+            ((STRINGDAT*) p->args[i])->data = dst;
+         }
+        else
+          strcpy(dst, src);
         }
-        else if (p->c.saved_types[i]=='b') {
-          char c = p->type->data[i];
-          int32_t len =  lo_blob_datasize(m->args[i].blob);
-          //printf("blob found %p type %c\n", m->args[i].blob, c);
-          //printf("length = %d\n", lo_blob_datasize(m->args[i].blob));
-          int32_t *idata = lo_blob_dataptr(m->args[i].blob);
-          if (c == 'D') {
-            int32_t j;
-            MYFLT *data = (MYFLT *) idata;
-            ARRAYDAT* arr = (ARRAYDAT*)p->args[i];
-            int32_t asize = 1;
-            for (j=0; j < arr->dimensions; j++) {
-              asize *= arr->sizes[j];
-            }
-            len /= sizeof(MYFLT);
-            if (asize < len) {
-              arr->data = (MYFLT *)
-                csound->ReAlloc(csound, arr->data, len*sizeof(MYFLT));
-              asize = len;
-             for (j = 0; j < arr->dimensions-1; j++)
-              asize /= arr->sizes[j];
-             arr->sizes[arr->dimensions-1] = asize;
-            }
-            memcpy(arr->data,data,len*sizeof(MYFLT));
-           }
-          else if (c == 'A') {       /* Decode an numeric array */
-            int32_t j;
-            MYFLT* data = (MYFLT*)(&idata[1+idata[0]]);
-            int32_t size = 1;
-            ARRAYDAT* foo = (ARRAYDAT*)p->args[i];
-            foo->dimensions = idata[0];
-            csound->Free(csound, foo->sizes);
-            foo->sizes = (int32_t*)csound->Malloc(csound, sizeof(int32_t)*idata[0]);
-#ifdef OSC_DEBUG
-            printf("dimension=%d\n", idata[0]);
-#endif
-            for (j=0; j<idata[0]; j++) {
-              foo->sizes[j] = idata[j+1];
-#ifdef OSC_DEBUG
-              printf("sizes[%d] = %d\n", j, idata[j+1]);
-#endif
-              size*=idata[j+1];
-            }
-#ifdef OSC_DEBUG
-            printf("idata = %i %i %i %i %i %i %i ...\n",
-                   idata[0], idata[1], idata[2], idata[3],
-                   idata[4], idata[5], idata[6]);
-            printf("data = %f, %f, %f...\n", data[0], data[1], data[2]);
-#endif
-            foo->data = (MYFLT*)csound->Malloc(csound, sizeof(MYFLT)*size);
-            memcpy(foo->data, data, sizeof(MYFLT)*size);
-            //printf("data = %f %f ...\n", foo->data[0], foo->data[1]);
+      }
+      else if (p->c.saved_types[i]=='b') {
+        char c = p->type->data[i];
+        lo_blob blob = (lo_blob) m[i].string.data;
+        int32_t len =  lo_blob_datasize(blob);
+        //printf("blob found %p type %c\n", blob, c);
+        //printf("length = %d\n", lo_blob_datasize(blob));
+        int32_t *idata = lo_blob_dataptr(blob);
+        if (c == 'D') {
+          int32_t j;
+          MYFLT *data = (MYFLT *) idata;
+          ARRAYDAT* arr = (ARRAYDAT*)p->args[i];
+          int32_t asize = 1;
+          for (j=0; j < arr->dimensions; j++) {
+            asize *= arr->sizes[j];
           }
-          else if (c == 'a') {
-
-            MYFLT *data= (MYFLT*)idata;
-            uint32_t len = (uint32_t)data[0];
-            if (len>CS_KSMPS) len = CS_KSMPS;
-            memcpy(p->args[i], &data[1], len*sizeof(MYFLT));
+          len /= sizeof(MYFLT);
+          if (asize < len) {
+            arr->data = (MYFLT *)
+              csound->ReAlloc(csound, arr->data, len*sizeof(MYFLT));
+            asize = len;
+           for (j = 0; j < arr->dimensions-1; j++)
+            asize /= arr->sizes[j];
+           arr->sizes[arr->dimensions-1] = asize;
           }
-          else if (c == 'G') {  /* ftable received */
-            //FUNC* data = (FUNC*)idata;
-            MYFLT *data = (MYFLT *) idata;
-            int32_t fno = MYFLT2LRND(*p->args[i]);
-            FUNC *ftp;
-            if (UNLIKELY(fno <= 0))
-              return csound->PerfError(csound, &(p->h),
-                                       Str("Invalid ftable no. %d"), fno);
-
-            ftp = csound->FTnp2Find(csound, p->args[i]);
-            if (UNLIKELY(ftp==NULL)) {
-              return csound->PerfError(csound, &(p->h),
-                                       "%s", Str("OSC internal error"));
-            }
-            if (len > (int32_t)  (ftp->flen*sizeof(MYFLT)))
-              ftp->ftable = (MYFLT*)csound->ReAlloc(csound, ftp->ftable,
-                                                    len*sizeof(MYFLT));
-            memcpy(ftp->ftable,data,len);
-
-#if 0
-            ftp = csound->FTFindP(csound, p->args[i]);
-            if (UNLIKELY(ftp==NULL)) { // need to allocate ***FIXME***
-              return csound->PerfError(csound, &(p->h),
-                                       "%s", Str("OSC internal error"));
-            }
-            memcpy(ftp, data, sizeof(FUNC)-sizeof(MYFLT*));
-            ftp->fno = fno;
+          memcpy(arr->data,data,len*sizeof(MYFLT));
+         }
+        else if (c == 'A') {       /* Decode an numeric array */
+          int32_t j;
+          MYFLT* data = (MYFLT*)(&idata[1+idata[0]]);
+          int32_t size = 1;
+          ARRAYDAT* foo = (ARRAYDAT*)p->args[i];
+          foo->dimensions = idata[0];
+          csound->Free(csound, foo->sizes);
+          foo->sizes = (int32_t*)csound->Malloc(csound, sizeof(int32_t)*idata[0]);
 #ifdef OSC_DEBUG
-            printf("%d\n", len);
-#endif
-            if (len > ftp->flen*sizeof(MYFLT))
-              ftp->ftable =
-                (MYFLT*)csound->ReAlloc(csound, ftp->ftable,
-                                        len-sizeof(FUNC)+sizeof(MYFLT*));
+          printf("dimension=%d\n", idata[0]);
 #endif
-            {
+          for (j=0; j<idata[0]; j++) {
+            foo->sizes[j] = idata[j+1];
 #ifdef OSC_DEBUG
-              MYFLT* dst = ftp->ftable;
-              MYFLT* src = (MYFLT*)(&(data->ftable));
-
-              //int32_t j;
-              printf("copy data: from %p to %p length %d %d\n",
-                     src, dst, len-sizeof(FUNC)+sizeof(MYFLT*), data->flen);
-              printf("was %f %f %f ...\n", dst[0], dst[1], dst[2]);
-              printf("will be %f %f %f ...\n", src[0],src[1], src[2]);
-              memcpy(dst, src, len-sizeof(FUNC)+sizeof(MYFLT*));
+            printf("sizes[%d] = %d\n", j, idata[j+1]);
 #endif
-              //for (j=0; j<data->flen;j++) dst[j]=src[j];
-              //printf("now %f %f %f ...\n", dst[0], dst[1], dst[2]);
-            }
+            size*=idata[j+1];
           }
-          else if (c == 'S') {
+#ifdef OSC_DEBUG
+          printf("idata = %i %i %i %i %i %i %i ...\n",
+                 idata[0], idata[1], idata[2], idata[3],
+                 idata[4], idata[5], idata[6]);
+          printf("data = %f, %f, %f...\n", data[0], data[1], data[2]);
+#endif
+          foo->data = (MYFLT*)csound->Malloc(csound, sizeof(MYFLT)*size);
+          memcpy(foo->data, data, sizeof(MYFLT)*size);
+          //printf("data = %f %f ...\n", foo->data[0], foo->data[1]);
+        }
+        else if (c == 'a') {
+
+          MYFLT *data= (MYFLT*)idata;
+          uint32_t len = (uint32_t)data[0];
+          if (len>CS_KSMPS) len = CS_KSMPS;
+          memcpy(p->args[i], &data[1], len*sizeof(MYFLT));
+        }
+        else if (c == 'G') {  /* ftable received */
+          //FUNC* data = (FUNC*)idata;
+          MYFLT *data = (MYFLT *) idata;
+          int32_t fno = MYFLT2LRND(*p->args[i]);
+          FUNC *ftp;
+          if (UNLIKELY(fno <= 0))
+            return csound->PerfError(csound, &(p->h),
+                                     Str("Invalid ftable no. %d"), fno);
+
+          ftp = csound->FTnp2Find(csound, p->args[i]);
+          if (UNLIKELY(ftp==NULL)) {
+            return csound->PerfError(csound, &(p->h),
+                                     "%s", Str("OSC internal error"));
           }
-          else return csound->PerfError(csound,  &(p->h), "Oh dear");
-          csound->Free(csound, m->args[i].blob);
+          if (len > (int32_t)  (ftp->flen*sizeof(MYFLT)))
+            ftp->ftable = (MYFLT*)csound->ReAlloc(csound, ftp->ftable,
+                                                  len*sizeof(MYFLT));
+          memcpy(ftp->ftable,data,len);
         }
-        else
-          *(p->args[i]) = m->args[i].number;
+        else if (c == 'S') {
+        }
+        else return csound->PerfError(csound,  &(p->h), "Oh dear");
       }
-      /* push to stack of free message structures */
-      m->next = p->c.freePatterns;
-      p->c.freePatterns = m;
-      *p->kans = 1;
-      OSC_GLOBALS *g = alloc_globals(csound);
-      csound->LockMutex(g->mutex_);
-      g->osccounter--;
-      csound->UnlockMutex(g->mutex_);
+      else
+        *(p->args[i]) = m[i].number;
     }
-    else
-      *p->kans = 0;
-    csound->UnlockMutex(p->port->mutex_);
     return OK;
 }
 
-/* ******** ARRAY VERSION **** EXPERIMENTAL *** */
-
-static int32_t OSC_ahandler(const char *path, const char *types,
-                       lo_arg **argv, int32_t argc, void *data, void *p)
+static int32_t OSC_list(CSOUND *csound, OSCLISTEN *p)
 {
-    IGN(argc);  IGN(data);
-    OSC_PORT  *pp = (OSC_PORT*) p;
-    OSCLCOMMON *o;
-    CSOUND    *csound = (CSOUND *) pp->csound;
-    int32_t   retval = 1;
-    //printf("***in ahandler\n");
-    csound->LockMutex(pp->mutex_);
-    o = (OSCLCOMMON*) pp->oplst;
-    //printf("opst=%p\n", o);
-    while (o != NULL) {
-      //printf("Looking at %s/%s against %s/%s\n",
-      //       o->saved_path, path,o->saved_types, types);
-      if (strcmp(o->saved_path, path) == 0 &&
-          strcmp(o->saved_types, types) == 0) {
-        /* Message is for this guy */
-        int32_t     i;
-        OSC_PAT *m;
-        OSC_GLOBALS *g = alloc_globals(csound);
-        csound->LockMutex(g->mutex_);
-        g->osccounter++;
-        csound->UnlockMutex(g->mutex_);
-        //printf("handler found message\n");
-        m = get_pattern(csound, o);
-        if (m != NULL) {
-          /* queue message for being read by OSClisten opcode */
-          m->next = NULL;
-          if (o->patterns == NULL)
-            o->patterns = m;
-          else {
-            OSC_PAT *mm;
-            for (mm = o->patterns; mm->next != NULL; mm = mm->next)
-              ;
-            mm->next = m;
-          }
-          /* copy argument list */
-          for (i = 0; o->saved_types[i] != '\0'; i++) {
-            switch (types[i]) {
-            default:              /* Should not happen */
-            case 'i':
-              m->args[i].number = (MYFLT) argv[i]->i; break;
-            case 'h':
-              m->args[i].number = (MYFLT) argv[i]->i64; break;
-            case 'c':
-              m->args[i].number= (MYFLT) argv[i]->c; break;
-            case 'f':
-              m->args[i].number = (MYFLT) argv[i]->f; break;
-            case 'd':
-              m->args[i].number= (MYFLT) argv[i]->d; break;
-            }
-          }
-          retval = 0;
-        }
-        break;
-      }
-      o = (OSCLCOMMON*) o->nxt;
-    }
+    long    rp = p->c.rp;
+    int32_t ret;
+    OSC_GLOBALS *g;
 
-    pp->csound->UnlockMutex(pp->mutex_);
-    return retval;
+    if (rp == ATOMIC_GET(p->c.wp)) {
+      *p->kans = 0;
+      return OK;
+    }
+    ret = osc_list_copy(csound, p,
+                        &p->c.slots[(rp & (OSC_QUEUE_SIZE-1)) * p->c.nargs]);
+    /* hand the slot back to the liblo thread */
+    ATOMIC_SET(p->c.rp, rp + 1);
+    ATOMIC_DECR(p->port->queued);
+    g = alloc_globals(csound);
+    ATOMIC_DECR(g->osccounter);
+    *p->kans = 1;
+    return ret;
 }
 
+/* ******** ARRAY VERSION **** EXPERIMENTAL *** */
+
 #include "arrays.h"
 
 static int32_t OSC_alist_init(CSOUND *csound, OSCLISTENA *p)
@@ -1028,15 +1051,9 @@ static int32_t OSC_alist_init(CSOUND *csound, OSCLISTENA *p)
     //void  *x;
     int32_t   i, n;
 
-    OSC_GLOBALS *pp =
-      (OSC_GLOBALS*) csound->QueryGlobalVariable(csound, "_OSC_globals");
-    if (UNLIKELY(pp == NULL))
-      return csound->InitError(csound, "%s", Str("OSC not running"));
     /* find port */
-    n = (int32_t) *(p->ihandle);
-    if (UNLIKELY(n < 0 || n >= pp->nPorts))
-      return csound->InitError(csound, "%s", Str("invalid handle"));
-    p->port = &(pp->ports[n]);
+    if (UNLIKELY((p->port = osc_find_port(csound, p->ihandle)) == NULL))
+      return NOTOK;
     p->c.saved_path = (char*) csound->Malloc(csound,
                                            strlen((char*) p->dest->data) + 1);
     strcpy(p->c.saved_path, (char*) p->dest->data);
@@ -1055,13 +1072,7 @@ static int32_t OSC_alist_init(CSOUND *csound, OSCLISTENA *p)
         return csound->InitError(csound, "%s", Str("invalid type"));
       }
     }
-    csound->LockMutex(p->port->mutex_);
-    p->c.nxt = p->port->oplst;
-    p->port->oplst = (void*) &p->c;
-    csound->UnlockMutex(p->port->mutex_);
-    p->c.method = lo_server_thread_add_method(p->port->thread,
-                                              p->c.saved_path, p->c.saved_types,
-                                              OSC_ahandler, p->port);
+    osc_listen_start(csound, p->port, &p->c, NULL);
     csound->RegisterDeinitCallback(csound, p,
                                    (int32_t (*)(CSOUND *, void *)) OSC_listadeinit);
     return OK;
@@ -1069,37 +1080,40 @@ static int32_t OSC_alist_init(CSOUND *csound, OSCLISTENA *p)
 
 static int32_t OSC_alist(CSOUND *csound, OSCLISTENA *p)
 {
-    OSC_PAT *m;
-    /* quick check for empty queue */
-    if (p->c.patterns == NULL) {
+    long    rp = p->c.rp;
+    OSC_ARG *m;
+    OSC_GLOBALS *g;
+    int32_t i;
+
+    if (rp == ATOMIC_GET(p->c.wp)) {
       *p->kans = 0;
       return OK;
     }
-    csound->LockMutex(p->port->mutex_);
-    m = p->c.patterns;
-    /* check again for thread safety */
-    if (m != NULL) {
-      int32_t i;
-      /* unlink from queue */
-      p->c.patterns = m->next;
-      /* copy arguments */
-      //printf("copying args\n");
-      for (i = 0; p->c.saved_types[i] != '\0'; i++) {
-        //printf("%d: type %c\n", i, p->c.saved_types[i]);
-        ((MYFLT*)p->args->data)[i] = m->args[i].number;
-      }
-      /* push to stack of free message structures */
-      m->next = p->c.freePatterns;
-      p->c.freePatterns = m;
-      *p->kans = 1;
-      OSC_GLOBALS *g = alloc_globals(csound);
-      csound->LockMutex(g->mutex_);
-      g->osccounter--;
-      csound->UnlockMutex(g->mutex_);
-    }
-    else
-      *p->kans = 0;
-    csound->UnlockMutex(p->port->mutex_);
+    m = &p->c.slots[(rp & (OSC_QUEUE_SIZE-1)) * p->c.nargs];
+    for (i = 0; i < p->c.nargs; i++)
+      ((MYFLT*)p->args->data)[i] = m[i].number;
+    ATOMIC_SET(p->c.rp, rp + 1);
+    ATOMIC_DECR(p->port->queued);
+    g = alloc_globals(csound);
+    ATOMIC_DECR(g->osccounter);
+    *p->kans = 1;
+    return OK;
+}
+
+/* kdropped, kqueued, kmaxdepth OSCstats ihandle */
+static int32_t OSC_stats_init(CSOUND *csound, OSCSTATS *p)
+{
+    if (UNLIKELY((p->port = osc_find_port(csound, p->ihandle)) == NULL))
+      return NOTOK;
+    return OK;
+}
+
+static int32_t OSC_stats(CSOUND *csound, OSCSTATS *p)
+{
+    IGN(csound);
+    *p->kdropped = (MYFLT) ATOMIC_GET(p->port->dropped);
+    *p->kqueued = (MYFLT) ATOMIC_GET(p->port->queued);
+    *p->kmaxdepth = (MYFLT) p->port->maxdepth;
     return OK;
 }
 
@@ -1114,14 +1128,16 @@ static OENTRY localops[] = {
     (SUBR)osc_listener_init, NULL, NULL, NULL },
   { "OSCinitM", S(OSCINITM), 0, 1, "i", "Si",
     (SUBR)osc_listener_initMulti, NULL, NULL, NULL },
-  { "OSClisten", S(OSCLISTEN),0, 3, "k", "iSS*",
+  { "OSClisten", S(OSCLISTEN),TW, 3, "k", "iSS*",
     (SUBR)OSC_list_init, (SUBR)OSC_list, NULL, NULL },
   { "OSClisten", S(OSCLISTEN),0, 3, "k", "iSS",
     (SUBR)OSC_list_init, (SUBR)OSC_list, NULL, NULL },
   { "OSClisten", S(OSCLISTENA),0, 3, "kk[]", "iSS",
     (SUBR)OSC_alist_init, (SUBR)OSC_alist, NULL, NULL },
   { "OSCcount", S(OSCcount), 0, 3, "k", "",
-    (SUBR)OSCcounter, (SUBR)OSCcounter, NULL }
+    (SUBR)OSCcounter, (SUBR)OSCcounter, NULL },
+  { "OSCstats", S(OSCSTATS), 0, 3, "kkk", "i",
+    (SUBR)OSC_stats_init, (SUBR)OSC_stats, NULL }
 };
 
 PUBLIC int64_t csound_opcode_init(CSOUND *csound, OENTRY **ep)
@@ -25,6 +25,7 @@
 #include "interlocks.h"
 #include "aops.h"
 #include "find_opcode.h"
+#include "arrayvec.h"
 
 extern MYFLT MOD(MYFLT a, MYFLT bb);
 
@@ -486,8 +487,7 @@ static int32_t tabadd(CSOUND *csound, TABARITH *p)
       sizer*=r->sizes[i];
     }
     if (sizer<sizel) sizel= sizer;
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] + r->data[i];
+    array_vec()->add(ans->data, l->data, r->data, sizel);
     return OK;
 }
 
@@ -509,8 +509,7 @@ static int32_t tabsub(CSOUND *csound, TABARITH *p)
       sizer*=r->sizes[i];
     }
     if (sizer<sizel) sizel= sizer;
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] - r->data[i];
+    array_vec()->sub(ans->data, l->data, r->data, sizel);
     return OK;
 }
 
@@ -532,8 +531,7 @@ static int32_t tabmult(CSOUND *csound, TABARITH *p)
       sizer*=r->sizes[i];
     }
     if (sizer<sizel) sizel= sizer;
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] * r->data[i];
+    array_vec()->mul(ans->data, l->data, r->data, sizel);
     return OK;
 }
 
@@ -556,12 +554,11 @@ static int32_t tabdiv(CSOUND *csound, TABARITH *p)
     }
     if (sizer<sizel) sizel = sizer;
     for (i=0; i<sizel; i++)
-      if (LIKELY(r->data[i]!=0))
-        ans->data[i] = l->data[i] / r->data[i];
-      else
+      if (UNLIKELY(r->data[i]==0))
         return
           csound->PerfError(csound, &(p->h),
                             Str("division by zero in array-var at index %d"), i);
+    array_vec()->div(ans->data, l->data, r->data, sizel);
     return OK;
 }
 
@@ -651,8 +648,7 @@ static int32_t tabiadd(CSOUND *csound, ARRAYDAT *ans, ARRAYDAT *l, MYFLT r, void
    for (i=1; i<l->dimensions; i++) {
       sizel*=l->sizes[i];
     }
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] + r;
+    array_vec()->adds(ans->data, l->data, r, sizel);
     return OK;
 }
 
@@ -691,8 +687,7 @@ static int32_t tabaisub(CSOUND *csound, TABARITH1 *p)
    for (i=1; i<l->dimensions; i++) {
       sizel*=l->sizes[i];
     }
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] - r;
+    array_vec()->subs(ans->data, l->data, r, sizel);
     return OK;
 }
 
@@ -712,8 +707,7 @@ static int32_t tabiasub(CSOUND *csound, TABARITH2 *p)
    for (i=1; i<l->dimensions; i++) {
       sizel*=l->sizes[i];
     }
-    for (i=0; i<sizel; i++)
-      ans->data[i] = r - l->data[i];
+    array_vec()->rsubs(ans->data, l->data, r, sizel);
     return OK;
 }
 
@@ -731,8 +725,7 @@ static int32_t tabimult(CSOUND *csound, ARRAYDAT *ans, ARRAYDAT *l,
     for (i=1; i<l->dimensions; i++) {
       sizel*=l->sizes[i];
     }
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] * r;
+    array_vec()->muls(ans->data, l->data, r, sizel);
     return OK;
 }
 
@@ -773,8 +766,7 @@ static int32_t tabaidiv(CSOUND *csound, TABARITH1 *p)
     for (i=1; i<l->dimensions; i++) {
       sizel*=l->sizes[i];
     }
-    for (i=0; i<sizel; i++)
-      ans->data[i] = l->data[i] / r;
+    array_vec()->divs(ans->data, l->data, r, sizel);
     return OK;
 }
 
@@ -794,12 +786,11 @@ static int32_t tabiadiv(CSOUND *csound, TABARITH2 *p)
     for (i=1; i<l->dimensions; i++) {
       sizel*=l->sizes[i];
     }
-    for (i=0; i<sizel; i++) {
+    for (i=0; i<sizel; i++)
       if (UNLIKELY(l->data[i]==FL(0.0)))
         return csound->PerfError(csound, &(p->h),
                                  Str("division by zero in array-var"));
-      ans->data[i] = r / l->data[i];
-    }
+    array_vec()->rdivs(ans->data, l->data, r, sizel);
     return OK;
 }
 
@@ -950,7 +941,7 @@ static int32_t tabaadd(CSOUND *csound, TABARITH *p)
     int32_t sizer    = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS;
+    int32_t i, nsmps = CS_KSMPS;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
@@ -974,8 +965,8 @@ static int32_t tabaadd(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] + b[n];
+      array_vec()->add(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -990,7 +981,7 @@ static int32_t tabasub(CSOUND *csound, TABARITH *p)
     int32_t sizer    = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
@@ -1014,8 +1005,8 @@ static int32_t tabasub(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] - b[n];
+      array_vec()->sub(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1030,7 +1021,7 @@ static int32_t tabamul(CSOUND *csound, TABARITH *p)
     int32_t sizer    = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
@@ -1054,8 +1045,8 @@ static int32_t tabamul(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] * b[n];
+      array_vec()->mul(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1094,13 +1085,13 @@ static int32_t tabadiv(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++) {
+      for (n=offset; n<nsmps; n++)
         if (UNLIKELY(b[n]==FL(0.0)))
           return csound->PerfError(csound, &(p->h),
                                   Str("division by zero in array-var "
                                       "at index %d/%d"), i,n);
-        aa[n] = a[n] / b[n];
-      }
+      array_vec()->div(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1114,7 +1105,7 @@ static int32_t tabkamult(CSOUND *csound, TABARITH2 *p)
     int32_t sizel        = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
@@ -1132,8 +1123,8 @@ static int32_t tabkamult(CSOUND *csound, TABARITH2 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = l * b[n];
+      array_vec()->muls(&aa[offset], &b[offset], l,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1147,7 +1138,7 @@ static int32_t tabakmult(CSOUND *csound, TABARITH1 *p)
     int32_t sizel        = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
@@ -1165,8 +1156,8 @@ static int32_t tabakmult(CSOUND *csound, TABARITH1 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = l * b[n];
+      array_vec()->muls(&aa[offset], &b[offset], l,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1180,7 +1171,7 @@ static int32_t tabkaadd(CSOUND *csound, TABARITH2 *p)
     int32_t sizel   = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
@@ -1198,8 +1189,8 @@ static int32_t tabkaadd(CSOUND *csound, TABARITH2 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = l + b[n];
+      array_vec()->adds(&aa[offset], &b[offset], l,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1213,7 +1204,7 @@ static int32_t tabakadd(CSOUND *csound, TABARITH1 *p)
     int32_t sizel   = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
@@ -1231,8 +1222,8 @@ static int32_t tabakadd(CSOUND *csound, TABARITH1 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = l + b[n];
+      array_vec()->adds(&aa[offset], &b[offset], l,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1246,7 +1237,7 @@ static int32_t tabkasub(CSOUND *csound, TABARITH2 *p)
     int32_t sizel   = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
@@ -1264,8 +1255,8 @@ static int32_t tabkasub(CSOUND *csound, TABARITH2 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = l - b[n];
+      array_vec()->rsubs(&aa[offset], &b[offset], l,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1279,7 +1270,7 @@ static int32_t tabaksub(CSOUND *csound, TABARITH1 *p)
     int32_t sizel   = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
@@ -1297,8 +1288,8 @@ static int32_t tabaksub(CSOUND *csound, TABARITH1 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = b[n] - l;
+      array_vec()->subs(&aa[offset], &b[offset], l,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1330,13 +1321,13 @@ static int32_t tabkadiv(CSOUND *csound, TABARITH2 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++) {
+      for (n=offset; n<nsmps; n++)
         if (UNLIKELY(b[n]==FL(0.0)))
           return csound->PerfError(csound, &(p->h),
                             Str("division by zero in array-var "
                                 "at index %d/%d"), i,n);
-        aa[n] = l / b[n];
-      }
+      array_vec()->rdivs(&aa[offset], &b[offset], l,
+                         nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1350,7 +1341,7 @@ static int32_t tabakdiv(CSOUND *csound, TABARITH1 *p)
     int32_t sizel    = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
@@ -1371,8 +1362,8 @@ static int32_t tabakdiv(CSOUND *csound, TABARITH1 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = b[n] / l;
+      array_vec()->divs(&aa[offset], &b[offset], l,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1455,7 +1446,7 @@ static int32_t tabaardd(CSOUND *csound, TABARITH2 *p)
     int32_t sizel = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
@@ -1473,8 +1464,8 @@ static int32_t tabaardd(CSOUND *csound, TABARITH2 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] + b[n];
+      array_vec()->add(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1488,7 +1479,7 @@ static int32_t tabaarsb(CSOUND *csound, TABARITH2 *p)
     int32_t sizel   = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
@@ -1506,8 +1497,8 @@ static int32_t tabaarsb(CSOUND *csound, TABARITH2 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] - b[n];
+      array_vec()->sub(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1521,7 +1512,7 @@ static int32_t tabaarml(CSOUND *csound, TABARITH2 *p)
     int32_t sizel = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
@@ -1539,8 +1530,8 @@ static int32_t tabaarml(CSOUND *csound, TABARITH2 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] * b[n];
+      array_vec()->mul(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1554,7 +1545,7 @@ static int32_t tabaardv(CSOUND *csound, TABARITH2 *p)
     int32_t sizel = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || r->data==NULL))
@@ -1572,8 +1563,8 @@ static int32_t tabaardv(CSOUND *csound, TABARITH2 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] / b[n];
+      array_vec()->div(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1587,7 +1578,7 @@ static int32_t tabaradd(CSOUND *csound, TABARITH1 *p)
     int32_t sizel = l->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL))
@@ -1605,8 +1596,8 @@ static int32_t tabaradd(CSOUND *csound, TABARITH1 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] + b[n];
+      array_vec()->add(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1620,7 +1611,7 @@ static int32_t tabarasb(CSOUND *csound, TABARITH1 *p)
     int32_t sizel = l->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL))
@@ -1638,8 +1629,8 @@ static int32_t tabarasb(CSOUND *csound, TABARITH1 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] - b[n];
+      array_vec()->sub(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1653,7 +1644,7 @@ static int32_t tabaraml(CSOUND *csound, TABARITH1 *p)
     int32_t sizel = l->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL))
@@ -1671,8 +1662,8 @@ static int32_t tabaraml(CSOUND *csound, TABARITH1 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] * b[n];
+      array_vec()->mul(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1686,7 +1677,7 @@ static int32_t tabaradv(CSOUND *csound, TABARITH1 *p)
     int32_t sizel = l->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL))
@@ -1704,8 +1695,8 @@ static int32_t tabaradv(CSOUND *csound, TABARITH1 *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] / b[n];
+      array_vec()->div(&aa[offset], &a[offset], &b[offset],
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1721,7 +1712,7 @@ static int32_t tabkrardd(CSOUND *csound, TABARITH *p)
     int32_t sizer = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
@@ -1742,8 +1733,8 @@ static int32_t tabkrardd(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a + b[n];
+      array_vec()->adds(&aa[offset], &b[offset], a,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1758,7 +1749,7 @@ static int32_t tabkrarsb(CSOUND *csound, TABARITH *p)
     int32_t sizer = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
@@ -1779,8 +1770,8 @@ static int32_t tabkrarsb(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a - b[n];
+      array_vec()->rsubs(&aa[offset], &b[offset], a,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1795,7 +1786,7 @@ static int32_t tabkrarml(CSOUND *csound, TABARITH *p)
     int32_t sizer    = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
@@ -1816,8 +1807,8 @@ static int32_t tabkrarml(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a * b[n];
+      array_vec()->muls(&aa[offset], &b[offset], a,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1832,7 +1823,7 @@ static int32_t tabkrardv(CSOUND *csound, TABARITH *p)
     int32_t sizer       = r->sizes[0];
     uint32_t offset     = p->h.insdshead->ksmps_offset;
     uint32_t early      = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span        = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
@@ -1853,8 +1844,8 @@ static int32_t tabkrardv(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a / b[n];
+      array_vec()->rdivs(&aa[offset], &b[offset], a,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1906,7 +1897,7 @@ static int32_t tabarkrdd(CSOUND *csound, TABARITH *p)
     int32_t sizer  = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
@@ -1927,8 +1918,8 @@ static int32_t tabarkrdd(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] + b;
+      array_vec()->adds(&aa[offset], &a[offset], b,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1943,7 +1934,7 @@ static int32_t tabarkrsb(CSOUND *csound, TABARITH *p)
     int32_t sizer    = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
@@ -1964,8 +1955,8 @@ static int32_t tabarkrsb(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] - b;
+      array_vec()->subs(&aa[offset], &a[offset], b,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -1980,7 +1971,7 @@ static int32_t tabarkrml(CSOUND *csound, TABARITH *p)
     int32_t sizer    = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
@@ -2001,8 +1992,8 @@ static int32_t tabarkrml(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] * b;
+      array_vec()->muls(&aa[offset], &a[offset], b,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -2017,7 +2008,7 @@ static int32_t tabarkrdv(CSOUND *csound, TABARITH *p)
     int32_t sizer    = r->sizes[0];
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    int32_t i, n, nsmps = CS_KSMPS-early;
+    int32_t i, nsmps = CS_KSMPS-early;
     int32_t span = (ans->arrayMemberSize)/sizeof(MYFLT);
 
     if (UNLIKELY(ans->data == NULL || l->data==NULL || r->data==NULL))
@@ -2038,8 +2029,8 @@ static int32_t tabarkrdv(CSOUND *csound, TABARITH *p)
       if (UNLIKELY(early)) {
         memset(&aa[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        aa[n] = a[n] / b;
+      array_vec()->divs(&aa[offset], &a[offset], b,
+                        nsmps - (int32_t) offset);
     }
     return OK;
 }
@@ -2152,14 +2143,14 @@ static int32_t tabmax(CSOUND *csound, TABQUERY *p)
     /*      Str("array-variable not vector")); */
 
     for (i=0; i<t->dimensions; i++) size += t->sizes[i];
-    ans = t->data[0];
-    for (i=1; i<size; i++)
-      if (t->data[i]>ans) {
-        ans = t->data[i];
-        pos = i;
-      }
+    ans = array_vec()->max(&t->data[1], size-1, t->data[0]);
     *p->ans = ans;
-    if (p->OUTOCOUNT>1) *p->pos = (MYFLT)pos;
+    if (p->OUTOCOUNT>1) {
+      /* first element equal to the maximum, as before */
+      for (pos=0; pos<size && t->data[pos]!=ans; pos++) ;
+      if (UNLIKELY(pos==size)) pos = 0;
+      *p->pos = (MYFLT)pos;
+    }
     return OK;
 }
 
@@ -2183,14 +2174,14 @@ static int32_t tabmin(CSOUND *csound, TABQUERY *p)
          &(p->h), Str("array-variable not a vector")); */
 
     for (i=0; i<t->dimensions; i++) size += t->sizes[i];
-    ans = t->data[0];
-    for (i=1; i<size; i++)
-      if (t->data[i]<ans) {
-        ans = t->data[i];
-        pos = i;
-      }
+    ans = array_vec()->min(&t->data[1], size-1, t->data[0]);
     *p->ans = ans;
-    if (p->OUTOCOUNT>1) *p->pos = (MYFLT)pos;
+    if (p->OUTOCOUNT>1) {
+      /* first element equal to the minimum, as before */
+      for (pos=0; pos<size && t->data[pos]!=ans; pos++) ;
+      if (UNLIKELY(pos==size)) pos = 0;
+      *p->pos = (MYFLT)pos;
+    }
     return OK;
 }
 
@@ -2226,10 +2217,10 @@ static int32_t tabsuma(CSOUND *csound, TABQUERY1 *p)
            sizeof(MYFLT)*nsmps);
     for (i=0; i<t->dimensions; i++) size += t->sizes[i];
     for (i=1; i<size; i++) {
-      int j, k = i*span;
+      int k = i*span;
       in = &(t->data[k]);
-      for(j=offset; j < nsmps; j++)
-        ans[j] += in[j];
+      array_vec()->add(&ans[offset], &ans[offset], &in[offset],
+                       nsmps - (int32_t) offset);
         }
     return OK;
 }
@@ -2246,10 +2237,8 @@ static int32_t tabsum(CSOUND *csound, TABQUERY1 *p)
     if (UNLIKELY(t->dimensions!=1))
       return csound->PerfError(csound, &(p->h),
                                Str("array-variable not a vector"));
-    ans = t->data[0];
     for (i=0; i<t->dimensions; i++) size += t->sizes[i];
-    for (i=1; i<size; i++)
-      ans += t->data[i];
+    ans = array_vec()->sum(&t->data[1], size-1, t->data[0]);
     *p->ans = ans;
     return OK;
 }
@@ -2281,7 +2270,6 @@ static int32_t tabscale(CSOUND *csound, TABSCALE *p)
     ARRAYDAT *t = p->tab;
     MYFLT tmin;
     MYFLT tmax;
-    int32_t i;
     MYFLT range;
 
     tmin = t->data[strt];
@@ -2296,16 +2284,13 @@ static int32_t tabscale(CSOUND *csound, TABSCALE *p)
       int32_t x = end; end = strt; strt = x;
     }
     // get data range
-    for (i=strt+1; i<end; i++) {
-      if (t->data[i]<tmin) tmin = t->data[i];
-      if (t->data[i]>tmax) tmax = t->data[i];
-    }
+    tmin = array_vec()->min(&t->data[strt+1], end-strt-1, tmin);
+    tmax = array_vec()->max(&t->data[strt+1], end-strt-1, tmax);
     /* printf("start/end %d/%d max/min = %g/%g tmax/tmin = %g/%g range=%g\n",  */
     /*        strt, end, max, min, tmax, tmin, range); */
     range = (max-min)/(tmax-tmin);
-    for (i=strt; i<end; i++) {
-      t->data[i] = (t->data[i]-tmin)*range + min;
-    }
+    array_vec()->scale(&t->data[strt], &t->data[strt], tmin, range, min,
+                       end-strt);
     return OK;
 }
 
@@ -2998,21 +2983,28 @@ int32_t init_rfft(CSOUND *csound, FFT *p) {
   if (UNLIKELY(p->in->dimensions > 1))
     return csound->InitError(csound, "%s",
                              Str("rfft: only one-dimensional arrays allowed"));
-  if (isPowerOfTwo(N)) {
+  if (isPowerOfTwo(N))
     tabinit(csound, p->out,N);
-    p->setup = csound->RealFFT2Setup(csound, N, FFT_FWD);
-  }
   else
     tabinit(csound, p->out, N+2);
+  /* non-power-of-two even sizes get the mixed radix backend */
+  p->setup = (N & 1) ? NULL : csound->RealFFT2Setup(csound, N, FFT_FWD);
+  p->n = N;
   return OK;
 }
 
 int32_t perf_rfft(CSOUND *csound, FFT *p) {
-    int32_t N = p->out->sizes[0];
+    int32_t N = p->n;
     memcpy(p->out->data,p->in->data,N*sizeof(MYFLT));
     if (isPowerOfTwo(N)) {
       csound->RealFFT2(csound,p->setup,p->out->data);
     }
+    else if (p->setup != NULL) {
+      /* keep the N+2 layout, Nyquist after the last bin */
+      csound->RealFFT2(csound,p->setup,p->out->data);
+      p->out->data[N] = p->out->data[1];
+      p->out->data[1] = p->out->data[N+1] = FL(0.0);
+    }
     else{
       p->out->data[N] = FL(0.0);
       csound->RealFFTnp2(csound,p->out->data,N);
@@ -3031,20 +3023,26 @@ int32_t init_rifft(CSOUND *csound, FFT *p) {
   if (UNLIKELY(p->in->dimensions > 1))
     return csound->InitError(csound, "%s",
                              Str("rifft: only one-dimensional arrays allowed"));
-  if (isPowerOfTwo(N)) {
-    p->setup = csound->RealFFT2Setup(csound, N, FFT_INV);
+  if (isPowerOfTwo(N))
     tabinit(csound, p->out, N);
-  }
   else
     tabinit(csound, p->out, N+2);
+  p->setup = (N & 1) ? NULL : csound->RealFFT2Setup(csound, N, FFT_INV);
+  p->n = N;
   return OK;
 }
 
 int32_t perf_rifft(CSOUND *csound, FFT *p) {
-    int32_t N = p->out->sizes[0];
+    int32_t N = p->n;
     memcpy(p->out->data,p->in->data,N*sizeof(MYFLT));
     if (isPowerOfTwo(N))
       csound->RealFFT2(csound,p->setup,p->out->data);
+    else if (p->setup != NULL) {
+      /* as the np2 transform: no Nyquist bin in an N point input */
+      p->out->data[1] = FL(0.0);
+      csound->RealFFT2(csound,p->setup,p->out->data);
+      p->out->data[N] = p->out->data[N+1] = FL(0.0);
+    }
     else{
       p->out->data[N] = FL(0.0);
       csound->InverseRealFFTnp2(csound,p->out->data,N);
@@ -0,0 +1,306 @@
+/*
+    arrayvec.c:
+
+    Copyright (C) 2026 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#include "csoundCore.h"
+#include "arrayvec.h"
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || \
+    (defined(__i386__) && defined(__SSE2__))
+#  define ARRAY_VEC_SSE2
+#  if defined(__GNUC__) || defined(_MSC_VER)
+#    define ARRAY_VEC_AVX2
+#  endif
+#  include <immintrin.h>
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define ARRAY_VEC_NEON
+#  include <arm_neon.h>
+#endif
+
+#if defined(ARRAY_VEC_AVX2) && defined(__GNUC__)
+#  define AVX2_ATTR __attribute__((target("avx2")))
+#else
+#  define AVX2_ATTR
+#endif
+
+/* Every instruction set provides the same kernels, written once here in
+   terms of a vector type V of W elements and its operations.  The tail
+   (n % W elements) always uses the scalar expression. */
+
+#define ARRAY_VEC_KERNELS(ISA, ATTR, V, W, LD, ST, SET1,                \
+                          ADD, SUB, MUL, DIV, MAX, MIN)          \
+                                                                        \
+  static ATTR void add_##ISA(MYFLT *r, const MYFLT *a, const MYFLT *b,  \
+                             int32_t n) {                               \
+    int32_t i = 0;                                                      \
+    for ( ; i <= n - W; i += W) ST(r + i, ADD(LD(a + i), LD(b + i)));   \
+    for ( ; i < n; i++) r[i] = a[i] + b[i];                             \
+  }                                                                     \
+  static ATTR void sub_##ISA(MYFLT *r, const MYFLT *a, const MYFLT *b,  \
+                             int32_t n) {                               \
+    int32_t i = 0;                                                      \
+    for ( ; i <= n - W; i += W) ST(r + i, SUB(LD(a + i), LD(b + i)));   \
+    for ( ; i < n; i++) r[i] = a[i] - b[i];                             \
+  }                                                                     \
+  static ATTR void mul_##ISA(MYFLT *r, const MYFLT *a, const MYFLT *b,  \
+                             int32_t n) {                               \
+    int32_t i = 0;                                                      \
+    for ( ; i <= n - W; i += W) ST(r + i, MUL(LD(a + i), LD(b + i)));   \
+    for ( ; i < n; i++) r[i] = a[i] * b[i];                             \
+  }                                                                     \
+  static ATTR void div_##ISA(MYFLT *r, const MYFLT *a, const MYFLT *b,  \
+                             int32_t n) {                               \
+    int32_t i = 0;                                                      \
+    for ( ; i <= n - W; i += W) ST(r + i, DIV(LD(a + i), LD(b + i)));   \
+    for ( ; i < n; i++) r[i] = a[i] / b[i];                             \
+  }                                                                     \
+  static ATTR void adds_##ISA(MYFLT *r, const MYFLT *a, MYFLT s,        \
+                              int32_t n) {                              \
+    int32_t i = 0;                                                      \
+    V vs = SET1(s);                                                     \
+    for ( ; i <= n - W; i += W) ST(r + i, ADD(LD(a + i), vs));          \
+    for ( ; i < n; i++) r[i] = a[i] + s;                                \
+  }                                                                     \
+  static ATTR void subs_##ISA(MYFLT *r, const MYFLT *a, MYFLT s,        \
+                              int32_t n) {                              \
+    int32_t i = 0;                                                      \
+    V vs = SET1(s);                                                     \
+    for ( ; i <= n - W; i += W) ST(r + i, SUB(LD(a + i), vs));          \
+    for ( ; i < n; i++) r[i] = a[i] - s;                                \
+  }                                                                     \
+  static ATTR void rsubs_##ISA(MYFLT *r, const MYFLT *a, MYFLT s,       \
+                               int32_t n) {                             \
+    int32_t i = 0;                                                      \
+    V vs = SET1(s);                                                     \
+    for ( ; i <= n - W; i += W) ST(r + i, SUB(vs, LD(a + i)));          \
+    for ( ; i < n; i++) r[i] = s - a[i];                                \
+  }                                                                     \
+  static ATTR void muls_##ISA(MYFLT *r, const MYFLT *a, MYFLT s,        \
+                              int32_t n) {                              \
+    int32_t i = 0;                                                      \
+    V vs = SET1(s);                                                     \
+    for ( ; i <= n - W; i += W) ST(r + i, MUL(LD(a + i), vs));          \
+    for ( ; i < n; i++) r[i] = a[i] * s;                                \
+  }                                                                     \
+  static ATTR void divs_##ISA(MYFLT *r, const MYFLT *a, MYFLT s,        \
+                              int32_t n) {                              \
+    int32_t i = 0;                                                      \
+    V vs = SET1(s);                                                     \
+    for ( ; i <= n - W; i += W) ST(r + i, DIV(LD(a + i), vs));          \
+    for ( ; i < n; i++) r[i] = a[i] / s;                                \
+  }                                                                     \
+  static ATTR void rdivs_##ISA(MYFLT *r, const MYFLT *a, MYFLT s,       \
+                               int32_t n) {                             \
+    int32_t i = 0;                                                      \
+    V vs = SET1(s);                                                     \
+    for ( ; i <= n - W; i += W) ST(r + i, DIV(vs, LD(a + i)));          \
+    for ( ; i < n; i++) r[i] = s / a[i];                                \
+  }                                                                     \
+  static ATTR void scale_##ISA(MYFLT *r, const MYFLT *a, MYFLT c,       \
+                               MYFLT m, MYFLT d, int32_t n) {           \
+    int32_t i = 0;                                                      \
+    V vc = SET1(c), vm = SET1(m), vd = SET1(d);                         \
+    for ( ; i <= n - W; i += W)                                         \
+      ST(r + i, ADD(MUL(SUB(LD(a + i), vc), vm), vd));                  \
+    for ( ; i < n; i++) r[i] = (a[i] - c) * m + d;                      \
+  }                                                                     \
+  static ATTR MYFLT sum_##ISA(const MYFLT *a, int32_t n, MYFLT init) {  \
+    MYFLT   lane[W];                                                    \
+    int32_t i = 0, j;                                                   \
+    V acc = SET1(FL(0.0));                                              \
+    for ( ; i <= n - W; i += W) acc = ADD(acc, LD(a + i));              \
+    ST(lane, acc);                                                      \
+    for (j = 0; j < W; j++) init += lane[j];                            \
+    for ( ; i < n; i++) init += a[i];                                   \
+    return init;                                                        \
+  }                                                                     \
+  /* MAX(x, m) keeps m when x is a NaN, as the scalar loops did */      \
+  static ATTR MYFLT max_##ISA(const MYFLT *a, int32_t n, MYFLT init) {  \
+    MYFLT   lane[W];                                                    \
+    int32_t i = 0, j;                                                   \
+    V m = SET1(init);                                                   \
+    for ( ; i <= n - W; i += W) m = MAX(LD(a + i), m);                  \
+    ST(lane, m);                                                        \
+    for (j = 0; j < W; j++) if (lane[j] > init) init = lane[j];         \
+    for ( ; i < n; i++) if (a[i] > init) init = a[i];                   \
+    return init;                                                        \
+  }                                                                     \
+  static ATTR MYFLT min_##ISA(const MYFLT *a, int32_t n, MYFLT init) {  \
+    MYFLT   lane[W];                                                    \
+    int32_t i = 0, j;                                                   \
+    V m = SET1(init);                                                   \
+    for ( ; i <= n - W; i += W) m = MIN(LD(a + i), m);                  \
+    ST(lane, m);                                                        \
+    for (j = 0; j < W; j++) if (lane[j] < init) init = lane[j];         \
+    for ( ; i < n; i++) if (a[i] < init) init = a[i];                   \
+    return init;                                                        \
+  }                                                                     \
+  static const ARRAY_VEC array_vec_##ISA = {                            \
+    #ISA, add_##ISA, sub_##ISA, mul_##ISA, div_##ISA,                   \
+    adds_##ISA, subs_##ISA, rsubs_##ISA, muls_##ISA, divs_##ISA,        \
+    rdivs_##ISA, scale_##ISA, sum_##ISA, max_##ISA, min_##ISA           \
+  };
+
+/* scalar: the "vector" is one MYFLT */
+#define S_LD(p)         (*(p))
+#define S_ST(p, v)      (*(p) = (v))
+#define S_SET1(s)       (s)
+#define S_ADD(a, b)     ((a) + (b))
+#define S_SUB(a, b)     ((a) - (b))
+#define S_MUL(a, b)     ((a) * (b))
+#define S_DIV(a, b)     ((a) / (b))
+#define S_MAX(x, m)     ((x) > (m) ? (x) : (m))
+#define S_MIN(x, m)     ((x) < (m) ? (x) : (m))
+
+ARRAY_VEC_KERNELS(scalar, , MYFLT, 1, S_LD, S_ST, S_SET1, S_ADD, S_SUB,
+                  S_MUL, S_DIV, S_MAX, S_MIN)
+
+#ifdef ARRAY_VEC_SSE2
+#ifdef USE_DOUBLE
+#define X_LD            _mm_loadu_pd
+#define X_ST            _mm_storeu_pd
+#define X_SET1          _mm_set1_pd
+#define X_ADD           _mm_add_pd
+#define X_SUB           _mm_sub_pd
+#define X_MUL           _mm_mul_pd
+#define X_DIV           _mm_div_pd
+#define X_MAX           _mm_max_pd
+#define X_MIN           _mm_min_pd
+ARRAY_VEC_KERNELS(sse2, , __m128d, 2, X_LD, X_ST, X_SET1, X_ADD, X_SUB,
+                  X_MUL, X_DIV, X_MAX, X_MIN)
+#else
+#define X_LD            _mm_loadu_ps
+#define X_ST            _mm_storeu_ps
+#define X_SET1          _mm_set1_ps
+#define X_ADD           _mm_add_ps
+#define X_SUB           _mm_sub_ps
+#define X_MUL           _mm_mul_ps
+#define X_DIV           _mm_div_ps
+#define X_MAX           _mm_max_ps
+#define X_MIN           _mm_min_ps
+ARRAY_VEC_KERNELS(sse2, , __m128, 4, X_LD, X_ST, X_SET1, X_ADD, X_SUB,
+                  X_MUL, X_DIV, X_MAX, X_MIN)
+#endif
+#endif
+
+#ifdef ARRAY_VEC_AVX2
+#ifdef USE_DOUBLE
+#define Y_LD            _mm256_loadu_pd
+#define Y_ST            _mm256_storeu_pd
+#define Y_SET1          _mm256_set1_pd
+#define Y_ADD           _mm256_add_pd
+#define Y_SUB           _mm256_sub_pd
+#define Y_MUL           _mm256_mul_pd
+#define Y_DIV           _mm256_div_pd
+#define Y_MAX           _mm256_max_pd
+#define Y_MIN           _mm256_min_pd
+ARRAY_VEC_KERNELS(avx2, AVX2_ATTR, __m256d, 4, Y_LD, Y_ST, Y_SET1, Y_ADD,
+                  Y_SUB, Y_MUL, Y_DIV, Y_MAX, Y_MIN)
+#else
+#define Y_LD            _mm256_loadu_ps
+#define Y_ST            _mm256_storeu_ps
+#define Y_SET1          _mm256_set1_ps
+#define Y_ADD           _mm256_add_ps
+#define Y_SUB           _mm256_sub_ps
+#define Y_MUL           _mm256_mul_ps
+#define Y_DIV           _mm256_div_ps
+#define Y_MAX           _mm256_max_ps
+#define Y_MIN           _mm256_min_ps
+ARRAY_VEC_KERNELS(avx2, AVX2_ATTR, __m256, 8, Y_LD, Y_ST, Y_SET1, Y_ADD,
+                  Y_SUB, Y_MUL, Y_DIV, Y_MAX, Y_MIN)
+#endif
+
+static int have_avx2(void)
+{
+#if defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+      return 0;
+    __cpuid(info, 1);
+    /* OSXSAVE, and the OS saves the YMM registers */
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6)
+      return 0;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#endif
+}
+#endif
+
+#ifdef ARRAY_VEC_NEON
+/* vmaxnm/vminnm return the number when one operand is a NaN */
+#ifdef USE_DOUBLE
+ARRAY_VEC_KERNELS(neon, , float64x2_t, 2, vld1q_f64, vst1q_f64,
+                  vdupq_n_f64, vaddq_f64, vsubq_f64, vmulq_f64, vdivq_f64,
+                  vmaxnmq_f64, vminnmq_f64)
+#else
+ARRAY_VEC_KERNELS(neon, , float32x4_t, 4, vld1q_f32, vst1q_f32,
+                  vdupq_n_f32, vaddq_f32, vsubq_f32, vmulq_f32, vdivq_f32,
+                  vmaxnmq_f32, vminnmq_f32)
+#endif
+#endif
+
+static const ARRAY_VEC *array_vec_tables[5] = { &array_vec_scalar, NULL };
+static const ARRAY_VEC *array_vec_selected = &array_vec_scalar;
+
+/* Called once, from csoundInitialize(), before any instance exists;
+   afterwards the tables and the choice are only read. */
+
+void array_vec_init(void)
+{
+    const ARRAY_VEC **t;
+    const char *isa = getenv("CSOUND_ARRAY_ISA");
+    int n = 1;
+#ifdef ARRAY_VEC_SSE2
+    array_vec_tables[n++] = &array_vec_sse2;
+#endif
+#ifdef ARRAY_VEC_AVX2
+    if (have_avx2())
+      array_vec_tables[n++] = &array_vec_avx2;
+#endif
+#ifdef ARRAY_VEC_NEON
+    array_vec_tables[n++] = &array_vec_neon;
+#endif
+    array_vec_tables[n] = NULL;
+    for (t = array_vec_tables; *t != NULL; t++) {
+      array_vec_selected = *t;
+      if (isa != NULL && strcmp(isa, (*t)->name) == 0)
+        break;
+    }
+}
+
+const ARRAY_VEC **array_vec_list(void)
+{
+    return array_vec_tables;
+}
+
+const ARRAY_VEC *array_vec(void)
+{
+    return array_vec_selected;
+}
@@ -0,0 +1,65 @@
+/*
+    arrayvec.h:
+
+    Copyright (C) 2026 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CSOUND_ARRAYVEC_H
+#define CSOUND_ARRAYVEC_H
+
+/* Vector kernels for the array opcodes.  One table per instruction set
+   (scalar, SSE2, AVX2, NEON); array_vec_init(), called once by
+   csoundInitialize(), picks the best one the CPU has, and array_vec()
+   returns it.  The environment variable
+   CSOUND_ARRAY_ISA=scalar|sse2|avx2|neon forces a table, for
+   benchmarking; the oscillator bank (H/oscbank.h) follows the same
+   choice.  All lengths are element counts; a count <= 0 does
+   nothing.  Sums and extrema may combine elements in a different
+   order from a plain loop. */
+
+typedef struct {
+    const char *name;
+    /* r[i] = a[i] op b[i] */
+    void  (*add)(MYFLT *r, const MYFLT *a, const MYFLT *b, int32_t n);
+    void  (*sub)(MYFLT *r, const MYFLT *a, const MYFLT *b, int32_t n);
+    void  (*mul)(MYFLT *r, const MYFLT *a, const MYFLT *b, int32_t n);
+    void  (*div)(MYFLT *r, const MYFLT *a, const MYFLT *b, int32_t n);
+    /* r[i] = a[i] op s, and s op a[i] for the r- forms */
+    void  (*adds)(MYFLT *r, const MYFLT *a, MYFLT s, int32_t n);
+    void  (*subs)(MYFLT *r, const MYFLT *a, MYFLT s, int32_t n);
+    void  (*rsubs)(MYFLT *r, const MYFLT *a, MYFLT s, int32_t n);
+    void  (*muls)(MYFLT *r, const MYFLT *a, MYFLT s, int32_t n);
+    void  (*divs)(MYFLT *r, const MYFLT *a, MYFLT s, int32_t n);
+    void  (*rdivs)(MYFLT *r, const MYFLT *a, MYFLT s, int32_t n);
+    /* r[i] = (a[i] - c) * m + d */
+    void  (*scale)(MYFLT *r, const MYFLT *a, MYFLT c, MYFLT m, MYFLT d,
+                   int32_t n);
+    /* reductions, starting from init */
+    MYFLT (*sum)(const MYFLT *a, int32_t n, MYFLT init);
+    MYFLT (*max)(const MYFLT *a, int32_t n, MYFLT init);
+    MYFLT (*min)(const MYFLT *a, int32_t n, MYFLT init);
+} ARRAY_VEC;
+
+void array_vec_init(void);
+const ARRAY_VEC *array_vec(void);
+/* NULL-terminated list of the tables usable on this CPU, best last */
+const ARRAY_VEC **array_vec_list(void);
+
+#endif  /* CSOUND_ARRAYVEC_H */
@@ -1366,7 +1366,7 @@ static OENTRY localops[] = {
 
     // tabrowlin krow, ifnsrc, ifndest, inumcols,
     //                 ioffset=0, istart=0, iend=0, istep=1
-    {"tabrowlin", S(TABROWCOPY), 0, 3, "", "kiiiooop",
+    {"tabrowlin", S(TABROWCOPY), TB, 3, "", "kiiiooop",
      (SUBR)tabrowcopy_init, (SUBR)tabrowcopyk },
 
     // kOut[]  tabrowlin krow, ifnsrc, inumcols,
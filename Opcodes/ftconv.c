@@ -23,10 +23,42 @@
 
 #include "stdopcod.h"
 #include <math.h>
+#include "specmac.h"
 
 #define FTCONV_MAXCHN   8
+#define FTCONV_MAXSEG   12      /* tail segments in non-uniform mode        */
+#define FTCONV_MAXBLOCK 16384   /* largest tail partition                   */
 
+/* iFlags bits */
+#define FTCONV_NONUNIFORM   1
+
+#define FTCONV_MAX_THREADS  4     /* tail workers shared by all instances */
+
+/* One tail segment of a non-uniformly partitioned impulse response: a
+   uniformly partitioned convolution of the IR from sample 'offset' on,
+   in 'nPartitions' blocks of 'partSize'.  The tail is computed by the
+   worker pool; block j of a segment covers input samples
+   j * partSize to (j + 1) * partSize - 1 and has to be done before the
+   output reaches sample j * partSize + offset + the head partition
+   size, which leaves it at least partSize samples of slack since
+   offset >= 2 * partSize. */
 typedef struct {
+    int32_t     partSize;
+    int32_t     nPartitions;
+    int32_t     offset;         /* IR position of the first partition       */
+    int32_t     delay;          /* offset + head partition size             */
+    int32_t     rbCnt;
+    MYFLT       *tmpBuf;
+    MYFLT       *ringBuf;
+    MYFLT       *IR_Data[FTCONV_MAXCHN];
+    void        *fwdsetup, *invsetup;
+    long        posted;         /* blocks of input available, under lock    */
+    long        done;           /* blocks convolved, under lock             */
+} FTCONV_SEG;
+
+struct FTCONV_POOL_;
+
+typedef struct FTCONV_ {
     OPDS    h;
     MYFLT   *aOut[FTCONV_MAXCHN];
     MYFLT   *aIn;
@@ -35,6 +67,7 @@ typedef struct {
     MYFLT   *iSkipSamples;
     MYFLT   *iTotLen;
     MYFLT   *iSkipInit;
+    MYFLT   *iFlags;
  /* ------------------------- */
     int32_t     initDone;
     int32_t     nChannels;
@@ -48,71 +81,22 @@ typedef struct {
     MYFLT   *outBuffers[FTCONV_MAXCHN]; /* output buffer (size=partSize*2)  */
     void  *fwdsetup, *invsetup;
     AUXCH   auxData;
+ /* non-uniform mode */
+    int32_t     nSegs;          /* tail segments, 0 in uniform mode         */
+    int32_t     irLen;          /* IR length the segments were planned for  */
+    FTCONV_SEG  seg[FTCONV_MAXSEG];
+    int64_t     nIn;            /* samples processed since init             */
+    int32_t     mask;           /* size - 1 of inHist and tailOut           */
+    MYFLT   *inHist;            /* input history read by the tail workers   */
+    MYFLT   *tailOut[FTCONV_MAXCHN];    /* tail output, indexed by time     */
+    struct FTCONV_POOL_ *pool;  /* non-NULL while the tail is registered */
+    struct FTCONV_ *nxt;        /* in the pool's list, under its lock       */
+    void    *doneCond;          /* signalled when a tail block is done      */
+    int32_t busy;               /* a worker is on this instance             */
+    int64_t clock;              /* nIn at the last sync, under lock         */
+    AUXCH   tailData;
 } FTCONV;
 
-static void multiply_fft_buffers(MYFLT *outBuf, MYFLT *ringBuf,
-                                 MYFLT *IR_Data, int32_t partSize,
-                                 int32_t nPartitions,
-                                 int32_t ringBuf_startPos)
-{
-    MYFLT   re, im, re1, re2, im1, im2;
-    MYFLT   *rbPtr, *irPtr, *outBufPtr, *outBufEndPm2, *rbEndP;
-
-    /* note: partSize must be at least 2 samples */
-    partSize <<= 1;
-    outBufEndPm2 = (MYFLT*) outBuf + (int32_t) (partSize - 2);
-    rbEndP = (MYFLT*) ringBuf + (int32_t) (partSize * nPartitions);
-    rbPtr = &(ringBuf[ringBuf_startPos]);
-    irPtr = IR_Data;
-    outBufPtr = outBuf;
-    /* clear output buffer to zero */
-    memset(outBuf, 0, sizeof(MYFLT)*(partSize));
-    /* do { */
-    /*   *(outBufPtr++) = FL(0.0); */
-    /*   *(outBufPtr++) = FL(0.0); */
-    /* } while (outBufPtr <= outBufEndPm2); */
-    /* multiply FFTs for each partition, and mix to output buffer */
-    /* note: IRs are stored in reverse partition order */
-    do {
-      /* wrap ring buffer position */
-      if (rbPtr >= rbEndP)
-        rbPtr = ringBuf;
-      outBufPtr = outBuf;
-      *(outBufPtr++) += *(rbPtr++) * *(irPtr++);    /* convolve DC */
-      *(outBufPtr++) += *(rbPtr++) * *(irPtr++);    /* convolve Nyquist */
-      re1 = *(rbPtr++);
-      im1 = *(rbPtr++);
-      re2 = *(irPtr++);
-      im2 = *(irPtr++);
-      re = re1 * re2 - im1 * im2;
-      im = re1 * im2 + re2 * im1;
-      while (outBufPtr < outBufEndPm2) {
-        /* complex multiply */
-        re1 = rbPtr[0];
-        im1 = rbPtr[1];
-        re2 = irPtr[0];
-        im2 = irPtr[1];
-        outBufPtr[0] += re;
-        outBufPtr[1] += im;
-        re = re1 * re2 - im1 * im2;
-        im = re1 * im2 + re2 * im1;
-        re1 = rbPtr[2];
-        im1 = rbPtr[3];
-        re2 = irPtr[2];
-        im2 = irPtr[3];
-        outBufPtr[2] += re;
-        outBufPtr[3] += im;
-        re = re1 * re2 - im1 * im2;
-        im = re1 * im2 + re2 * im1;
-        outBufPtr += 4;
-        rbPtr += 4;
-        irPtr += 4;
-      }
-      outBufPtr[0] += re;
-      outBufPtr[1] += im;
-    } while (--nPartitions);
-}
-
 static inline int32_t buf_bytes_alloc(int32_t nChannels,
                                       int32_t partSize, int32_t nPartitions)
 {
@@ -148,10 +132,349 @@ static void set_buf_pointers(FTCONV *p,
     }
 }
 
+/* FFT one channel of an impulse response into nPartitions blocks of
+   partSize samples zero padded to twice that, last partition first as
+   the spectral multiply expects them.  'pos' is the table index of the
+   first sample, and table data from index 'end' on is read as zero. */
+static void load_ir_partitions(CSOUND *csound, FUNC *ftp, MYFLT *IR_Data,
+                               void *fwdsetup, int32_t partSize,
+                               int32_t nPartitions, int32_t nChannels,
+                               int32_t pos, int32_t end)
+{
+    int32_t i = pos, k, n;
+
+    if (end > (int32_t) ftp->flen)
+      end = (int32_t) ftp->flen;
+    n = (partSize << 1) * (nPartitions - 1);        /* IR write position */
+    do {
+      for (k = 0; k < partSize; k++) {
+        if (i >= 0 && i < end)
+          IR_Data[n + k] = ftp->ftable[i];
+        else
+          IR_Data[n + k] = FL(0.0);
+        i += nChannels;
+      }
+      /* pad second half of IR to zero */
+      for (k = partSize; k < (partSize << 1); k++)
+        IR_Data[n + k] = FL(0.0);
+      /* calculate FFT */
+      csound->RealFFT2(csound, fwdsetup, &(IR_Data[n]));
+      n -= (partSize << 1);
+    } while (n >= 0);
+}
+
+/* Non-uniform partitioning: the first 8 * partSize samples of the IR
+   stay in the performance thread, and the rest is split into segments
+   whose partitions grow four times at each step (6 partitions each)
+   up to FTCONV_MAXBLOCK, the last segment taking whatever is left.
+   Returns the number of head partitions. */
+static int32_t ftconv_plan(FTCONV *p, int32_t irLen)
+{
+    int32_t N = p->partSize << 2, offset = N << 1;
+
+    p->nSegs = 0;
+    if (irLen <= offset)
+      return (irLen + (p->partSize - 1)) / p->partSize;
+    while (offset < irLen) {
+      FTCONV_SEG *sg = &(p->seg[p->nSegs++]);
+      int32_t grow = (N << 2) <= FTCONV_MAXBLOCK && p->nSegs < FTCONV_MAXSEG;
+      int32_t n = (irLen - offset + (N - 1)) / N;
+      if (grow && n > 6)
+        n = 6;
+      sg->partSize = N;
+      sg->nPartitions = n;
+      sg->offset = offset;
+      sg->delay = offset + p->partSize;
+      offset += n * N;
+      if (grow)
+        N <<= 2;
+    }
+    return p->seg[0].offset / p->partSize;
+}
+
+/* convolve the next input block of one tail segment, and add the
+   result to the tail output at the time it is due */
+static void ftconv_seg_block(CSOUND *csound, FTCONV *p, FTCONV_SEG *sg)
+{
+    int32_t N = sg->partSize, i, n, rBufPos;
+    int64_t start = (int64_t) sg->done * N, t;
+    MYFLT   *rBuf = &(sg->ringBuf[sg->rbCnt * (N << 1)]);
+
+    for (i = 0; i < N; i++)
+      rBuf[i] = p->inHist[(start + i) & p->mask];
+    memset(&rBuf[N], 0, N * sizeof(MYFLT));
+    csound->RealFFT2(csound, sg->fwdsetup, rBuf);
+    if (++sg->rbCnt >= sg->nPartitions)
+      sg->rbCnt = 0;
+    rBufPos = sg->rbCnt * (N << 1);
+    t = start + sg->delay;              /* output time of tmpBuf[0] */
+    for (n = 0; n < p->nChannels; n++) {
+      MYFLT *y = p->tailOut[n];
+      spectral_mac(sg->tmpBuf, sg->ringBuf, sg->IR_Data[n],
+                   N, sg->nPartitions, rBufPos);
+      csound->RealFFT2(csound, sg->invsetup, sg->tmpBuf);
+      for (i = 0; i < (N << 1); i++)
+        y[(t + i) & p->mask] += sg->tmpBuf[i];
+    }
+}
+
+/* The tail workers are shared by every ftconv instance of a Csound
+   instance.  A worker takes the instance whose next pending block is
+   closest to its deadline, and works on one instance at a time so that
+   the segments of an instance never add into tailOut concurrently.
+   Threads are started as instances register, up to FTCONV_MAX_THREADS. */
+typedef struct FTCONV_POOL_ {
+    CSOUND  *csound;
+    void    *lock, *cond;       /* cond: work posted, or shutting down      */
+    void    *threads[FTCONV_MAX_THREADS];
+    int32_t nthreads;
+    int32_t ninstances;
+    int32_t running;
+    FTCONV  *list;
+} FTCONV_POOL;
+
+/* the segment of p with the earliest pending block, or NULL; the
+   deadline is returned in samples from p's last sync */
+static FTCONV_SEG *ftconv_next_seg(FTCONV *p, int64_t *slack)
+{
+    FTCONV_SEG *next = NULL;
+    int32_t k;
+
+    for (k = 0; k < p->nSegs; k++) {
+      FTCONV_SEG *sg = &(p->seg[k]);
+      if (sg->posted > sg->done) {
+        int64_t d = (int64_t) sg->done * sg->partSize + sg->offset - p->clock;
+        if (next == NULL || d < *slack) {
+          next = sg;
+          *slack = d;
+        }
+      }
+    }
+    return next;
+}
+
+static uintptr_t ftconv_thread(void *data)
+{
+    FTCONV_POOL *e = (FTCONV_POOL *) data;
+    CSOUND  *csound = e->csound;
+
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    csound->LockMutex(e->lock);
+    while (e->running) {
+      FTCONV      *p, *best = NULL;
+      FTCONV_SEG  *sg, *next = NULL;
+      int64_t     slack = 0, d = 0;
+      for (p = e->list; p != NULL; p = p->nxt) {
+        if (p->busy || (sg = ftconv_next_seg(p, &d)) == NULL)
+          continue;
+        if (best == NULL || d < slack) {
+          best = p;
+          next = sg;
+          slack = d;
+        }
+      }
+      if (best == NULL) {
+        csoundCondWait(e->cond, e->lock);
+        continue;
+      }
+      best->busy = 1;
+      /* other instances may have work for an idle worker */
+      csoundCondSignal(e->cond);
+      csound->UnlockMutex(e->lock);
+      ftconv_seg_block(csound, best, next);
+      csound->LockMutex(e->lock);
+      next->done++;
+      best->busy = 0;
+      csoundCondSignal(best->doneCond);
+    }
+    /* pass the wake up on to the next worker */
+    csoundCondSignal(e->cond);
+    csound->UnlockMutex(e->lock);
+    return 0;
+}
+
+static int32_t ftconv_pool_reset(CSOUND *csound, void *data)
+{
+    FTCONV_POOL *e = (FTCONV_POOL *) data;
+    int32_t i;
+
+    csound->LockMutex(e->lock);
+    e->running = 0;
+    csoundCondSignal(e->cond);
+    csound->UnlockMutex(e->lock);
+    for (i = 0; i < e->nthreads; i++)
+      csound->JoinThread(e->threads[i]);
+    csoundDestroyCondVar(e->cond);
+    csound->DestroyMutex(e->lock);
+    return OK;
+}
+
+static FTCONV_POOL *ftconv_pool(CSOUND *csound)
+{
+    FTCONV_POOL *e;
+
+    e = (FTCONV_POOL *) csound->QueryGlobalVariable(csound, "FTCONV_POOL");
+    if (e != NULL)
+      return e;
+    if (UNLIKELY(csound->CreateGlobalVariable(csound, "FTCONV_POOL",
+                                              sizeof(FTCONV_POOL)) != 0))
+      return NULL;
+    e = (FTCONV_POOL *) csound->QueryGlobalVariable(csound, "FTCONV_POOL");
+    e->csound = csound;
+    e->lock = csound->Create_Mutex(0);
+    e->cond = csoundCreateCondVar();
+    e->running = 1;
+    csound->RegisterResetCallback(csound, (void *) e, ftconv_pool_reset);
+    return e;
+}
+
+/* called at each head partition boundary: hand the completed input
+   blocks to the workers, then wait for the blocks that the next
+   partSize output samples depend on */
+static void ftconv_tail_sync(CSOUND *csound, FTCONV *p)
+{
+    FTCONV_POOL *e = p->pool;
+    int64_t nIn = p->nIn;
+    int32_t k, posted = 0;
+
+    csound->LockMutex(e->lock);
+    p->clock = nIn;
+    for (k = 0; k < p->nSegs; k++) {
+      FTCONV_SEG *sg = &(p->seg[k]);
+      if (nIn % sg->partSize == 0) {
+        sg->posted = (long) (nIn / sg->partSize);
+        posted = 1;
+      }
+    }
+    if (posted)
+      csoundCondSignal(e->cond);
+    for (k = 0; k < p->nSegs; k++) {
+      FTCONV_SEG *sg = &(p->seg[k]);
+      long need;
+      if (nIn <= sg->offset)
+        continue;
+      need = (long) ((nIn - 1 - sg->offset) / sg->partSize + 1);
+      while (sg->done < need) {
+        if (e->nthreads == 0 && !p->busy) {
+          /* no workers: convolve the overdue block here */
+          csound->UnlockMutex(e->lock);
+          ftconv_seg_block(csound, p, sg);
+          csound->LockMutex(e->lock);
+          sg->done++;
+        }
+        else
+          csoundCondWait(p->doneCond, e->lock);
+      }
+    }
+    csound->UnlockMutex(e->lock);
+}
+
+/* take the instance out of the pool, waiting for a block in progress */
+static int32_t ftconv_tail_stop(CSOUND *csound, FTCONV *p)
+{
+    FTCONV_POOL *e = p->pool;
+    FTCONV      **pp;
+
+    if (e == NULL)
+      return OK;
+    csound->LockMutex(e->lock);
+    while (p->busy)
+      csoundCondWait(p->doneCond, e->lock);
+    for (pp = &e->list; *pp != NULL; pp = &(*pp)->nxt)
+      if (*pp == p) {
+        *pp = p->nxt;
+        break;
+      }
+    e->ninstances--;
+    csound->UnlockMutex(e->lock);
+    csoundDestroyCondVar(p->doneCond);
+    p->doneCond = NULL;
+    p->pool = NULL;
+    return OK;
+}
+
+/* allocate and fill the tail segments, and register the instance with
+   the worker pool */
+static int32_t ftconv_tail_init(CSOUND *csound, FTCONV *p, FUNC *ftp,
+                                int32_t skipSamples, int32_t irLen)
+{
+    FTCONV_SEG  *last = &(p->seg[p->nSegs - 1]);
+    FTCONV_POOL *e;
+    MYFLT   *ptr;
+    int32_t i, j, k, size, nSmps;
+
+    size = 1;
+    while (size < last->offset + (last->partSize << 1) + (p->partSize << 1))
+      size <<= 1;
+    p->mask = size - 1;
+    nSmps = size * (p->nChannels + 1);
+    for (k = 0; k < p->nSegs; k++)
+      nSmps += (p->seg[k].partSize << 1) *
+               (1 + p->seg[k].nPartitions * (p->nChannels + 1));
+    if ((size_t) nSmps * sizeof(MYFLT) != p->tailData.size)
+      csound->AuxAlloc(csound, (size_t) nSmps * sizeof(MYFLT), &(p->tailData));
+    else
+      memset(p->tailData.auxp, 0, p->tailData.size);
+    ptr = (MYFLT *) p->tailData.auxp;
+    p->inHist = ptr;
+    ptr += size;
+    for (j = 0; j < p->nChannels; j++) {
+      p->tailOut[j] = ptr;
+      ptr += size;
+    }
+    for (k = 0; k < p->nSegs; k++) {
+      FTCONV_SEG *sg = &(p->seg[k]);
+      int32_t fftSize = sg->partSize << 1;
+      sg->tmpBuf = ptr;
+      ptr += fftSize;
+      sg->ringBuf = ptr;
+      ptr += fftSize * sg->nPartitions;
+      sg->rbCnt = 0;
+      sg->posted = sg->done = 0;
+      sg->fwdsetup = csound->RealFFT2Setup(csound, fftSize, FFT_FWD);
+      sg->invsetup = csound->RealFFT2Setup(csound, fftSize, FFT_INV);
+      for (j = 0; j < p->nChannels; j++) {
+        sg->IR_Data[j] = ptr;
+        ptr += fftSize * sg->nPartitions;
+        i = ((skipSamples + sg->offset) * p->nChannels) + j;
+        load_ir_partitions(csound, ftp, sg->IR_Data[j], sg->fwdsetup,
+                           sg->partSize, sg->nPartitions, p->nChannels,
+                           i, (skipSamples + irLen) * p->nChannels);
+      }
+    }
+    p->nIn = 0;
+    p->irLen = irLen;
+    p->clock = 0;
+    p->busy = 0;
+    e = ftconv_pool(csound);
+    if (UNLIKELY(e == NULL))
+      return csound->InitError(csound, Str("ftconv: could not create "
+                                           "the tail worker pool"));
+    p->doneCond = csoundCreateCondVar();
+    csound->LockMutex(e->lock);
+    p->nxt = e->list;
+    e->list = p;
+    p->pool = e;
+#ifndef __EMSCRIPTEN__
+    if (++e->ninstances > e->nthreads && e->nthreads < FTCONV_MAX_THREADS) {
+      void *t = csound->CreateThread(ftconv_thread, (void *) e);
+      if (t != NULL)
+        e->threads[e->nthreads++] = t;
+    }
+#else
+    e->ninstances++;
+#endif
+    csound->UnlockMutex(e->lock);
+    csound->RegisterDeinitCallback(csound, p,
+                                   (int32_t (*)(CSOUND *, void *))
+                                   ftconv_tail_stop);
+    return OK;
+}
+
 static int32_t ftconv_init(CSOUND *csound, FTCONV *p)
 {
     FUNC    *ftp;
-    int32_t     i, j, k, n, nBytes, skipSamples;
+    int32_t     i, j, n, nBytes, skipSamples, irLen;
     //MYFLT   FFTscale;
 
     /* check parameters */
@@ -179,12 +502,22 @@ static int32_t ftconv_init(CSOUND *csound, FTCONV *p)
                                Str("ftconv: invalid length, or insufficient"
                                    " IR data for convolution"));
     }
-    p->nPartitions = (n + (p->partSize - 1)) / p->partSize;
+    irLen = n;
+    if (p->initDone > 0 && p->pool != NULL && *(p->iSkipInit) != FL(0.0) &&
+        p->irLen == irLen && p->seg[0].offset == (p->partSize << 3))
+      return OK;    /* tail still running: skip initialisation */
+    ftconv_tail_stop(csound, p);
+    if (MYFLT2LRND(*(p->iFlags)) & FTCONV_NONUNIFORM)
+      p->nPartitions = ftconv_plan(p, n);
+    else {
+      p->nSegs = 0;
+      p->nPartitions = (n + (p->partSize - 1)) / p->partSize;
+    }
     /* calculate the amount of aux space to allocate (in bytes) */
     nBytes = buf_bytes_alloc(p->nChannels, p->partSize, p->nPartitions);
     if (nBytes != (int32_t) p->auxData.size)
       csound->AuxAlloc(csound, (int32) nBytes, &(p->auxData));
-    else if (p->initDone > 0 && *(p->iSkipInit) != FL(0.0))
+    else if (p->initDone > 0 && p->nSegs == 0 && *(p->iSkipInit) != FL(0.0))
       return OK;    /* skip initialisation if requested */
     /* if skipping samples: check for possible truncation of IR */
     /*
@@ -218,22 +551,9 @@ static int32_t ftconv_init(CSOUND *csound, FTCONV *p)
     p->invsetup = csound->RealFFT2Setup(csound,(p->partSize << 1), FFT_INV);
     for (j = 0; j < p->nChannels; j++) {
       i = (skipSamples * p->nChannels) + j;           /* table read position */
-      n = (p->partSize << 1) * (p->nPartitions - 1);  /* IR write position */
-      do {
-        for (k = 0; k < p->partSize; k++) {
-          if (i >= 0 && i < (int32_t) ftp->flen)
-            p->IR_Data[j][n + k] = ftp->ftable[i];// * FFTscale;
-          else
-            p->IR_Data[j][n + k] = FL(0.0);
-          i += p->nChannels;
-        }
-        /* pad second half of IR to zero */
-        for (k = p->partSize; k < (p->partSize << 1); k++)
-          p->IR_Data[j][n + k] = FL(0.0);
-        /* calculate FFT */
-        csound->RealFFT2(csound, p->fwdsetup, &(p->IR_Data[j][n]));
-        n -= (p->partSize << 1);
-      } while (n >= 0);
+      load_ir_partitions(csound, ftp, p->IR_Data[j], p->fwdsetup,
+                         p->partSize, p->nPartitions, p->nChannels,
+                         i, (int32_t) ftp->flen);
     }
     /* clear output buffers to zero */
     /*memset(p->outBuffers, 0, p->nChannels*(p->partSize << 1)*sizeof(MYFLT));*/
@@ -241,6 +561,9 @@ static int32_t ftconv_init(CSOUND *csound, FTCONV *p)
       for (i = 0; i < (p->partSize << 1); i++)
         p->outBuffers[j][i] = FL(0.0);
     }
+    if (p->nSegs > 0 &&
+        UNLIKELY(ftconv_tail_init(csound, p, ftp, skipSamples, irLen) != OK))
+      return NOTOK;
     p->initDone = 1;
 
     return OK;
@@ -271,6 +594,16 @@ static int32_t ftconv_perf(CSOUND *csound, FTCONV *p)
       /* copy output signals from buffer */
       for (n = 0; n < p->nChannels; n++)
         p->aOut[n][nn] = p->outBuffers[n][p->cnt];
+      if (p->nSegs > 0) {
+        /* non-uniform: keep the input for the tail workers, and mix in
+           (and clear) the tail output */
+        int32_t t = (int32_t) (p->nIn++ & p->mask);
+        p->inHist[t] = p->aIn[nn];
+        for (n = 0; n < p->nChannels; n++) {
+          p->aOut[n][nn] += p->tailOut[n][t];
+          p->tailOut[n][t] = FL(0.0);
+        }
+      }
       /* is input buffer full ? */
       if (++p->cnt < nSamples)
         continue;                   /* no, continue with next sample */
@@ -289,8 +622,8 @@ static int32_t ftconv_perf(CSOUND *csound, FTCONV *p)
       /* for each channel: */
       for (n = 0; n < p->nChannels; n++) {
         /* multiply complex arrays */
-        multiply_fft_buffers(p->tmpBuf, p->ringBuf, p->IR_Data[n],
-                             nSamples, p->nPartitions, rBufPos);
+        spectral_mac(p->tmpBuf, p->ringBuf, p->IR_Data[n],
+                     nSamples, p->nPartitions, rBufPos);
         /* inverse FFT */
         csound->RealFFT2(csound, p->invsetup, p->tmpBuf);
         /* copy to output buffer, overlap with "tail" of previous block */
@@ -300,6 +633,8 @@ static int32_t ftconv_perf(CSOUND *csound, FTCONV *p)
           x[i + nSamples] = p->tmpBuf[i + nSamples];
         }
       }
+      if (p->nSegs > 0)
+        ftconv_tail_sync(csound, p);
     }
     return OK;
  err1:
@@ -313,9 +648,8 @@ int32_t ftconv_init_(CSOUND *csound)
 {
     return csound->AppendOpcode(csound, "ftconv",
                                 (int32_t) sizeof(FTCONV), TR, 3,
-                                "mmmmmmmm", "aiiooo",
+                                "mmmmmmmm", "aiioooo",
                                 (int32_t (*)(CSOUND *, void *)) ftconv_init,
                                 (int32_t (*)(CSOUND *, void *)) ftconv_perf,
                                 NULL);
 }
-
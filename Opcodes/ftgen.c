@@ -21,6 +21,12 @@ typedef struct {
     MYFLT   *ifno, *p1, *p2, *p3, *p4, *p5, *argums[VARGMAX-5];
 } FTGEN;
 
+typedef struct {
+    OPDS    h;
+    MYFLT   *ifno, *kready, *p1, *p2, *p3, *p4, *p5, *argums[VARGMAX-5];
+    int32_t fno;
+} FTGENASYNC;
+
 typedef struct {
     OPDS    h;
     MYFLT   *ifilno, *iflag, *argums[VARGMAX-2];
@@ -68,30 +74,30 @@ static int32_t register_ftable_delete(CSOUND *csound, void *p, int32_t tableNum)
     return csound->RegisterDeinitCallback(csound, op, ftable_delete);
 }
 
-/* set up and call any GEN routine */
-static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istring2)
+/* build the f event for ftgen and ftgenasync; pp points at the p1 to
+   p5 arguments, followed by the rest */
+static int32_t ftgen_event(CSOUND *csound, OPDS *p, MYFLT **pp,
+                           int32_t istring1, int32_t istring2, EVTBLK **evt)
 {
     MYFLT   *fp;
-    FUNC    *ftp;
     EVTBLK  *ftevt;
     int32_t     n;
 
-    *p->ifno = FL(0.0);
     ftevt =(EVTBLK*) csound->Malloc(csound, sizeof(EVTBLK));
     ftevt->opcod = 'f';
     ftevt->strarg = NULL;
     fp = &ftevt->p[0];
     fp[0] = FL(0.0);
-    fp[1] = *p->p1;                                     /* copy p1 - p5 */
+    fp[1] = *pp[0];                                     /* copy p1 - p5 */
     fp[2] = ftevt->p2orig = FL(0.0);                    /* force time 0 */
-    fp[3] = ftevt->p3orig = *p->p3;
-    fp[4] = *p->p4;
+    fp[3] = ftevt->p3orig = *pp[2];
+    fp[4] = *pp[3];
 
 
     if (istring1) {              /* Named gen */
       NAMEDGEN *named = (NAMEDGEN*) csound->GetNamedGens(csound);
       while (named) {
-        if (strcmp(named->name, ((STRINGDAT *) p->p4)->data) == 0) {
+        if (strcmp(named->name, ((STRINGDAT *) pp[3])->data) == 0) {
           /* Look up by name */
           fp[4] = named->genum;
           break;
@@ -102,7 +108,7 @@ static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istrin
         csound->Free(csound,ftevt);
         return csound->InitError(csound,
                                  Str("Named gen \"%s\" not defined"),
-                                 (char *)p->p4);
+                                 ((STRINGDAT *) pp[3])->data);
       }
       // else fp[4] = named->genum;
     }
@@ -118,7 +124,7 @@ static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istrin
       case 28:
       case 43:
       case 49:
-        ftevt->strarg = ((STRINGDAT *) p->p5)->data;
+        ftevt->strarg = ((STRINGDAT *) pp[4])->data;
         break;
       default:
         csound->Free(csound, ftevt);
@@ -126,18 +132,33 @@ static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istrin
       }
     }
     else {
-      fp[5] = *p->p5;                                   /* else no string */
+      fp[5] = *pp[4];                                   /* else no string */
     }
     n = csound->GetInputArgCnt(p);
     ftevt->pcnt = (int16) n;
     n -= 5;
     if (n > 0) {
-      MYFLT **argp = p->argums;
+      MYFLT **argp = pp + 5;
       fp += 6;
       do {
         *fp++ = **argp++;                               /* copy rem arglist */
       } while (--n);
     }
+    *evt = ftevt;
+    return OK;
+}
+
+/* set up and call any GEN routine */
+static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istring2)
+{
+    FUNC    *ftp;
+    EVTBLK  *ftevt;
+    int32_t     n;
+
+    *p->ifno = FL(0.0);
+    if (UNLIKELY((n = ftgen_event(csound, &p->h, &p->p1,
+                                  istring1, istring2, &ftevt)) != OK))
+      return n;
     n = csound->hfgens(csound, &ftp, ftevt, 1);         /* call the fgen */
     csound->Free(csound, ftevt);
     if (UNLIKELY(n != 0))
@@ -147,6 +168,51 @@ static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istrin
     return OK;
 }
 
+/* as ftgen, but the GEN runs on another thread; the table number is
+   known at once, and kready turns 1 once the table can be used */
+static int32_t ftgenasync_(CSOUND *csound, FTGENASYNC *p,
+                           int32_t istring1, int32_t istring2)
+{
+    EVTBLK  *ftevt;
+    int32_t     n;
+
+    *p->ifno = FL(0.0);
+    *p->kready = FL(0.0);
+    if (UNLIKELY((n = ftgen_event(csound, &p->h, &p->p1,
+                                  istring1, istring2, &ftevt)) != OK))
+      return n;
+    n = csound->hfgensAsync(csound, ftevt, 1);
+    csound->Free(csound, ftevt);
+    if (UNLIKELY(n < 0))
+      return csound->InitError(csound, Str("ftgenasync error"));
+    p->fno = n;
+    *p->ifno = (MYFLT) n;
+    return OK;
+}
+
+static int32_t ftgenasync(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,0,0);
+}
+
+static int32_t ftgenasync_S(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,1,0);
+}
+
+static int32_t ftgenasync_iS(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,0,1);
+}
+
+static int32_t ftgenasync_SS(CSOUND *csound, FTGENASYNC *p) {
+    return ftgenasync_(csound,p,1,1);
+}
+
+/* 1 when the table is ready, 0 while it is generated, -1 if it failed */
+static int32_t ftgenasync_ready(CSOUND *csound, FTGENASYNC *p)
+{
+    *p->kready = (MYFLT) csound->FTReady(csound, p->fno);
+    return OK;
+}
+
 static int32_t ftgen(CSOUND *csound, FTGEN *p) {
     return ftgen_(csound,p,0,0);
 }
@@ -693,6 +759,14 @@ static OENTRY localops[] = {
   { "ftgen.SS",    S(FTGEN),  TW, 1,  "i",  "iiiSSm", (SUBR) ftgen_SS, NULL, NULL },
   { "ftgen",    S(FTGEN),     TW, 1,  "i",  "iiiii[]", (SUBR) ftgen_list_i, NULL  },
   { "ftgen",    S(FTGEN),     TW, 1,  "i",  "iiiSi[]", (SUBR) ftgen_list_S, NULL  },
+  { "ftgenasync", S(FTGENASYNC), TW, 3, "ik", "iiiiim", (SUBR) ftgenasync,
+                                          (SUBR) ftgenasync_ready, NULL },
+  { "ftgenasync.S", S(FTGENASYNC), TW, 3, "ik", "iiiSim", (SUBR) ftgenasync_S,
+                                          (SUBR) ftgenasync_ready, NULL },
+  { "ftgenasync.iS", S(FTGENASYNC), TW, 3, "ik", "iiiiSm", (SUBR) ftgenasync_iS,
+                                          (SUBR) ftgenasync_ready, NULL },
+  { "ftgenasync.SS", S(FTGENASYNC), TW, 3, "ik", "iiiSSm", (SUBR) ftgenasync_SS,
+                                          (SUBR) ftgenasync_ready, NULL },
   { "ftgentmp.i", S(FTGEN),   TW, 1,  "i",  "iiiiim", (SUBR) ftgentmp, NULL, NULL },
   { "ftgentmp.iS", S(FTGEN),  TW, 1,  "i",  "iiiiSm", (SUBR) ftgentmp_S, NULL,NULL},
   { "ftgentmp.Si", S(FTGEN),  TW, 1,  "i",  "iiiSim", (SUBR) ftgentmp_Si,NULL,NULL},
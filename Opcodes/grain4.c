@@ -447,7 +447,7 @@ static MYFLT grand( GRAINV4 *p)
 
 
 static OENTRY grain4_localops[] = {
-  { "granule", S(GRAINV4), TR, 3, "a", "xiiiiiiiiikikiiivppppo",
+  { "granule", S(GRAINV4), TB, 3, "a", "xiiiiiiiiikikiiivppppo",
              (SUBR)grainsetv4, (SUBR)graingenv4},
 };
 
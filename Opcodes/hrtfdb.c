@@ -0,0 +1,229 @@
+/*
+    hrtfdb.c:
+
+    Copyright (C) 2026 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#include "csoundCore.h"
+#include "hrtfdb.h"
+#include <math.h>
+
+const int32_t hrtfdb_elevations[HRTFDB_NELEV] =
+  {56, 60, 72, 72, 72, 72, 72, 60, 56, 45, 36, 24, 12, 1 };
+
+extern void csoundLock(void);
+extern void csoundUnLock(void);
+
+/* all stores in the process, under csoundLock() */
+static HRTFDB *hrtfdb_list = NULL;
+
+/* what one Csound instance holds: the memfiles it loaded map to a
+   store, so that the files are hashed once per instance */
+typedef struct hrtfdb_ref_s {
+    struct hrtfdb_ref_s *nxt;
+    MEMFIL      *l, *r;
+    int32_t     irlength;
+    HRTFDB      *db;
+} HRTFDB_REF;
+
+typedef struct {
+    HRTFDB_REF  *refs;
+} HRTFDB_GLOBALS;
+
+static uint32_t hrtfdb_hash(uint32_t h, const MEMFIL *mfp)
+{
+    const unsigned char *c = (const unsigned char*) mfp->beginp;
+    int32 n = mfp->length;
+    while (n--)
+      h = (h ^ *c++) * 16777619U;       /* FNV-1a */
+    return h;
+}
+
+static void hrtfdb_free(HRTFDB *db)
+{
+    free(db->data);
+    free(db);
+}
+
+static int32_t hrtfdb_reset(CSOUND *csound, void *p)
+{
+    HRTFDB_GLOBALS *g = (HRTFDB_GLOBALS*) p;
+    HRTFDB_REF *ref = g->refs, *nxt;
+
+    csoundLock();
+    for ( ; ref != NULL; ref = nxt) {
+      nxt = ref->nxt;
+      if (--ref->db->refs == 0) {
+        HRTFDB **pp = &hrtfdb_list;
+        while (*pp != ref->db)
+          pp = &(*pp)->nxt;
+        *pp = ref->db->nxt;
+        hrtfdb_free(ref->db);
+      }
+      csound->Free(csound, ref);
+    }
+    g->refs = NULL;
+    csoundUnLock();
+    return OK;
+}
+
+/* fill one store from the file data: the left half of each elevation is
+   stored as measured, the right half from the mirror image position with
+   the ears exchanged (as the opcodes always did on every lookup) */
+
+static HRTFDB *hrtfdb_build(const float *fl, const float *fr,
+                            int32_t irlength)
+{
+    HRTFDB  *db = (HRTFDB*) calloc(1, sizeof(HRTFDB));
+    int32_t e, a, i, pos = 0, skip = 0;
+
+    if (db == NULL)
+      return NULL;
+    db->irlength = irlength;
+    for (e = 0; e < HRTFDB_NELEV; e++) {
+      db->first[e] = pos;
+      pos += hrtfdb_elevations[e];
+    }
+    db->npos = pos;
+    db->data = (MYFLT*) malloc((size_t) pos * 4 * irlength * sizeof(MYFLT));
+    if (db->data == NULL) {
+      free(db);
+      return NULL;
+    }
+    for (e = 0; e < HRTFDB_NELEV; e++) {
+      int32_t n = hrtfdb_elevations[e];
+      for (a = 0; a < n; a++) {
+        const float *src[2];
+        int     ear;
+        if (a > n / 2) {
+          int32_t off = skip + (n - a) * irlength;
+          src[0] = fr + off;
+          src[1] = fl + off;
+        }
+        else {
+          int32_t off = skip + a * irlength;
+          src[0] = fl + off;
+          src[1] = fr + off;
+        }
+        for (ear = 0; ear < 2; ear++) {
+          MYFLT *spec = (MYFLT*) hrtfdb_spec(db, e, a, ear);
+          MYFLT *trig = (MYFLT*) hrtfdb_trig(db, e, a, ear);
+          for (i = 0; i < irlength; i++)
+            spec[i] = src[ear][i];
+          trig[0] = (spec[0] < FL(0.0) ? -FL(1.0) : FL(1.0));
+          trig[1] = (spec[1] < FL(0.0) ? -FL(1.0) : FL(1.0));
+          for (i = 2; i < irlength; i += 2) {
+            trig[i] = COS(spec[i + 1]);
+            trig[i + 1] = SIN(spec[i + 1]);
+          }
+        }
+      }
+      skip += ((int32_t) (n / 2) + 1) * irlength;
+    }
+    return db;
+}
+
+/* non-zero if db was built from exactly these files: the hash only
+   picks the candidate.  Every value the store was built from is in
+   the measured half of its spectra, and MYFLT holds a float exactly. */
+
+static int hrtfdb_same(const HRTFDB *db, const float *fl, const float *fr)
+{
+    int32_t e, a, i, skip = 0;
+
+    for (e = 0; e < HRTFDB_NELEV; e++) {
+      int32_t n = hrtfdb_elevations[e];
+      for (a = 0; a <= n / 2; a++) {
+        const MYFLT *sl = hrtfdb_spec(db, e, a, 0);
+        const MYFLT *sr = hrtfdb_spec(db, e, a, 1);
+        const float *l = fl + skip + a * db->irlength;
+        const float *r = fr + skip + a * db->irlength;
+        for (i = 0; i < db->irlength; i++)
+          if (sl[i] != (MYFLT) l[i] || sr[i] != (MYFLT) r[i])
+            return 0;
+      }
+      skip += ((int32_t) (n / 2) + 1) * db->irlength;
+    }
+    return 1;
+}
+
+const HRTFDB *hrtfdb_get(CSOUND *csound, MEMFIL *left, MEMFIL *right,
+                         int32_t irlength)
+{
+    HRTFDB_GLOBALS *g;
+    HRTFDB_REF  *ref;
+    HRTFDB      *db;
+    int32_t     e, need = 0;
+    uint32_t    h;
+
+    for (e = 0; e < HRTFDB_NELEV; e++)
+      need += ((int32_t) (hrtfdb_elevations[e] / 2) + 1) * irlength;
+    if (UNLIKELY(left->length < need * (int32) sizeof(float) ||
+                 right->length < need * (int32) sizeof(float))) {
+      csound->ErrorMsg(csound, Str("HRTF data files too short for %d point "
+                                   "spectra"), (int) irlength);
+      return NULL;
+    }
+
+    g = (HRTFDB_GLOBALS*) csound->QueryGlobalVariable(csound, "::hrtfdb");
+    if (g == NULL) {
+      if (UNLIKELY(csound->CreateGlobalVariable(csound, "::hrtfdb",
+                                                sizeof(HRTFDB_GLOBALS)) != 0))
+        return NULL;
+      g = (HRTFDB_GLOBALS*) csound->QueryGlobalVariable(csound, "::hrtfdb");
+      csound->RegisterResetCallback(csound, (void*) g, hrtfdb_reset);
+    }
+    for (ref = g->refs; ref != NULL; ref = ref->nxt)
+      if (ref->l == left && ref->r == right && ref->irlength == irlength)
+        return ref->db;
+
+    h = hrtfdb_hash(hrtfdb_hash(2166136261U, left), right);
+    csoundLock();
+    for (db = hrtfdb_list; db != NULL; db = db->nxt)
+      if (db->hash == h && db->irlength == irlength &&
+          db->lenl == left->length && db->lenr == right->length &&
+          hrtfdb_same(db, (const float*) left->beginp,
+                      (const float*) right->beginp))
+        break;
+    if (db == NULL) {
+      db = hrtfdb_build((const float*) left->beginp,
+                        (const float*) right->beginp, irlength);
+      if (UNLIKELY(db == NULL)) {
+        csoundUnLock();
+        csound->ErrorMsg(csound, "%s", Str("HRTF: not enough memory"));
+        return NULL;
+      }
+      db->hash = h;
+      db->lenl = left->length;
+      db->lenr = right->length;
+      db->nxt = hrtfdb_list;
+      hrtfdb_list = db;
+    }
+    db->refs++;
+    ref = (HRTFDB_REF*) csound->Calloc(csound, sizeof(HRTFDB_REF));
+    ref->l = left;
+    ref->r = right;
+    ref->irlength = irlength;
+    ref->db = db;
+    ref->nxt = g->refs;
+    g->refs = ref;
+    csoundUnLock();
+    return db;
+}
@@ -0,0 +1,81 @@
+/*
+    hrtfdb.h:
+
+    Copyright (C) 2026 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CSOUND_HRTFDB_H
+#define CSOUND_HRTFDB_H
+
+/* Shared HRTF store for hrtfmove, hrtfstat and hrtfearly.
+
+   The MIT data files hold one spectrum (DC, Nyquist, then magnitude and
+   phase pairs) per measured position of the left half of each elevation;
+   the right half is the same data with the ears swapped.  The store holds
+   every position, both halves, already converted to MYFLT with the ears
+   resolved, so a lookup is one multiply.  For each spectrum it also holds
+   the cosines and sines of its phases, which is what phase truncation
+   multiplies the interpolated magnitudes by.
+
+   One store exists per file pair contents and IR length in the whole
+   process; every Csound instance using the same files shares it.  It is
+   read-only once built and freed with the last instance. */
+
+#define HRTFDB_NELEV    14
+
+typedef struct hrtfdb_s {
+    struct hrtfdb_s *nxt;
+    int         refs;
+    uint32_t    hash;           /* of both files */
+    int32       lenl, lenr;
+    int32_t     irlength;
+    int32_t     first[HRTFDB_NELEV];    /* first position of an elevation */
+    int32_t     npos;
+    /* per position: left spectrum, right spectrum, left cos/sin pairs,
+       right cos/sin pairs, irlength values each */
+    MYFLT       *data;
+} HRTFDB;
+
+/* measurements per elevation, from -40 to 90 degrees in steps of 10 */
+extern const int32_t hrtfdb_elevations[HRTFDB_NELEV];
+
+/* spectrum of measured position (elev, angle) for ear 0 (left) or 1 */
+static inline const MYFLT *hrtfdb_spec(const HRTFDB *db, int32_t elev,
+                                       int32_t angle, int ear)
+{
+    return db->data +
+      ((size_t) (db->first[elev] + angle) * 4 + ear) * db->irlength;
+}
+
+/* [i], [i+1] = cos, sin of the phase at [i+1] of the spectrum, i >= 2;
+   [0], [1] = -1 or 1, the signs of the DC and Nyquist values */
+static inline const MYFLT *hrtfdb_trig(const HRTFDB *db, int32_t elev,
+                                       int32_t angle, int ear)
+{
+    return db->data +
+      ((size_t) (db->first[elev] + angle) * 4 + 2 + ear) * db->irlength;
+}
+
+/* store for the two loaded files; NULL (after an error message) if
+   they are too short for irlength */
+const HRTFDB *hrtfdb_get(CSOUND *, MEMFIL *left, MEMFIL *right,
+                         int32_t irlength);
+
+#endif  /* CSOUND_HRTFDB_H */
@@ -24,6 +24,7 @@
 /* #include "csdl.h" */
 #include "csoundCore.h"
 #include "interlocks.h"
+#include "hrtfdb.h"
 
 #ifdef __FAST_MATH__
 #undef __FAST_MATH__
@@ -176,8 +177,6 @@ typedef struct
   int32_t initialfade;
 
   /* interpolation buffer declaration */
-  AUXCH lowl1, lowr1, lowl2, lowr2;
-  AUXCH highl1, highr1, highl2, highr2;
   AUXCH hrtflinterp, hrtfrinterp, hrtflpad, hrtfrpad;
   AUXCH hrtflpadold, hrtfrpadold;
 
@@ -204,7 +203,8 @@ typedef struct
   /* for each reflection*/
   AUXCH hrtflpadspec, hrtfrpadspec, hrtflpadspecold, hrtfrpadspecold;
   AUXCH outl, outr, outlold, outrold;
-  AUXCH currentphasel, currentphaser;
+  /* cos/sin of the current phase in the store, left and right */
+  AUXCH curtrig;
   AUXCH dell, delr;
   AUXCH tempsrcx, tempsrcy, tempsrcz;
   AUXCH dist;
@@ -227,8 +227,8 @@ typedef struct
   /* wall filter q*/
   MYFLT q;
 
-  /* file pointers*/
-  float *fpbeginl, *fpbeginr;
+  /* shared HRTF store */
+  const HRTFDB *db;
 
 } early;
 
@@ -336,9 +336,9 @@ static int32_t early_init(CSOUND *csound, early *p)
         csound->InitError(csound,
                           Str("\n\n\nCannot load right data file, exiting\n\n"));
 
-    /* file handles */
-    p->fpbeginl = (float *) fpl->beginp;
-    p->fpbeginr = (float *) fpr->beginp;
+    p->db = hrtfdb_get(csound, fpl, fpr, irlength);
+    if (UNLIKELY(p->db == NULL))
+      return csound->InitError(csound, "%s", Str("hrtfearly: unusable HRTF data"));
 
     /* setup structure values */
     p->irlength = irlength;
@@ -469,46 +469,6 @@ static int32_t early_init(CSOUND *csound, early *p)
     p->impulses =  impulses;
 
     /* allocate memory, reuse if possible: interpolation buffers */
-    if (!p->lowl1.auxp || p->lowl1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowl1);
-    else
-      memset(p->lowl1.auxp, 0, irlength * sizeof(MYFLT));
-
-    if (!p->lowr1.auxp || p->lowr1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowr1);
-    else
-      memset(p->lowr1.auxp, 0, irlength * sizeof(MYFLT));
-
-    if (!p->lowl2.auxp || p->lowl2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowl2);
-    else
-      memset(p->lowl2.auxp, 0, irlength * sizeof(MYFLT));
-
-    if (!p->lowr2.auxp || p->lowr2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowr2);
-    else
-      memset(p->lowr2.auxp, 0, irlength * sizeof(MYFLT));
-
-    if (!p->highl1.auxp || p->highl1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highl1);
-    else
-      memset(p->highl1.auxp, 0, irlength * sizeof(MYFLT));
-
-    if (!p->highr1.auxp || p->highr1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highr1);
-    else
-      memset(p->highr1.auxp, 0, irlength * sizeof(MYFLT));
-
-    if (!p->highl2.auxp || p->highl2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highl2);
-    else
-      memset(p->highl2.auxp, 0, irlength * sizeof(MYFLT));
-
-    if (!p->highr2.auxp || p->highr2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highr2);
-    else
-      memset(p->highr2.auxp, 0, irlength * sizeof(MYFLT));
-
     if (!p->hrtflinterp.auxp || p->hrtflinterp.size < irlength * sizeof(MYFLT))
       csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->hrtflinterp);
     else
@@ -682,18 +642,18 @@ static int32_t early_init(CSOUND *csound, early *p)
     memset(p->outlold.auxp, 0, irlengthpad * impulses * sizeof(MYFLT));
     memset(p->outrold.auxp, 0, irlengthpad * impulses * sizeof(MYFLT));
 
-    if (!p->currentphasel.auxp ||
-        p->currentphasel.size < irlength * impulses * sizeof(MYFLT))
+    /* set on the first block, as oldelevindex starts at -1 */
+    if (!p->curtrig.auxp ||
+        p->curtrig.size < 2 * impulses * sizeof(const MYFLT *))
       csound->AuxAlloc(csound,
-                       irlength * impulses * sizeof(MYFLT), &p->currentphasel);
-    if (!p->currentphaser.auxp ||
-        p->currentphaser.size < irlength * impulses * sizeof(MYFLT))
-      csound->AuxAlloc(csound,
-                       irlength * impulses * sizeof(MYFLT), &p->currentphaser);
-
-
-    memset(p->currentphasel.auxp, 0, irlength * impulses * sizeof(MYFLT));
-    memset(p->currentphaser.auxp, 0, irlength * impulses * sizeof(MYFLT));
+                       2 * impulses * sizeof(const MYFLT *), &p->curtrig);
+    {
+      const MYFLT **curtrig = (const MYFLT **) p->curtrig.auxp;
+      for (i = 0; i < impulses; i++) {
+        curtrig[2 * i] = hrtfdb_trig(p->db, 0, 0, 0);
+        curtrig[2 * i + 1] = hrtfdb_trig(p->db, 0, 0, 1);
+      }
+    }
 
     /* setup rt60 calcs...*/
     /* rectangular room: surface area of opposite walls, and floor/ceiling */
@@ -798,15 +758,10 @@ static int32_t early_process(CSOUND *csound, early *p)
 
     int32_t counter = p->counter;
 
-    /* convolution buffers */
-    MYFLT *lowl1 = (MYFLT *)p->lowl1.auxp;
-    MYFLT *lowr1 = (MYFLT *)p->lowr1.auxp;
-    MYFLT *lowl2 = (MYFLT *)p->lowl2.auxp;
-    MYFLT *lowr2 = (MYFLT *)p->lowr2.auxp;
-    MYFLT *highl1 = (MYFLT *)p->highl1.auxp;
-    MYFLT *highr1 = (MYFLT *)p->highr1.auxp;
-    MYFLT *highl2 = (MYFLT *)p->highl2.auxp;
-    MYFLT *highr2 = (MYFLT *)p->highr2.auxp;
+    /* convolution buffers: spectra in the shared store */
+    const HRTFDB *db = p->db;
+    const MYFLT *lowl1, *lowr1, *lowl2, *lowr2;
+    const MYFLT *highl1, *highr1, *highl2, *highr2;
     MYFLT *hrtflinterp = (MYFLT *)p->hrtflinterp.auxp;
     MYFLT *hrtfrinterp = (MYFLT *)p->hrtfrinterp.auxp;
 
@@ -816,10 +771,6 @@ static int32_t early_process(CSOUND *csound, early *p)
     MYFLT *hrtflpadold = (MYFLT *)p->hrtflpadold.auxp;
     MYFLT *hrtfrpadold = (MYFLT *)p->hrtfrpadold.auxp;
 
-    /* pointers into HRTF files: floating point data(even in 64 bit csound) */
-    float *fpindexl = (float *)p->fpbeginl;
-    float *fpindexr = (float *)p->fpbeginr;
-
     /* local copies */
     MYFLT srcx = *p->srcx;
     MYFLT srcy = *p->srcy;
@@ -840,7 +791,6 @@ static int32_t early_process(CSOUND *csound, early *p)
     MYFLT angle, elev;
     int32_t elevindex;
     int32_t angleindex;
-    int32_t skip = 0;
 
     /* crossfade preparation and checks */
     int32_t fade = p->fade;
@@ -853,7 +803,7 @@ static int32_t early_process(CSOUND *csound, early *p)
     int32_t elevindexlow, elevindexhigh, angleindex1, angleindex2,
       angleindex3, angleindex4;
     MYFLT elevindexhighper, angleindex2per, angleindex4per;
-    MYFLT magllow, magrlow, maglhigh, magrhigh, magl, magr, phasel, phaser;
+    MYFLT magllow, magrlow, maglhigh, magrhigh, magl, magr;
 
     /* convolution and in/output buffers */
     MYFLT *inbuf = (MYFLT *)p->inbuf.auxp;
@@ -880,8 +830,8 @@ static int32_t early_process(CSOUND *csound, early *p)
     MYFLT *outr = (MYFLT *)p->outr.auxp;
     MYFLT *outlold = (MYFLT *)p->outlold.auxp;
     MYFLT *outrold = (MYFLT *)p->outrold.auxp;
-    MYFLT *currentphasel = (MYFLT *)p->currentphasel.auxp;
-    MYFLT *currentphaser = (MYFLT *)p->currentphaser.auxp;
+    const MYFLT **curtrig = (const MYFLT **)p->curtrig.auxp;
+    const MYFLT *curtrigl, *curtrigr;
     MYFLT *dell = (MYFLT *)p->dell.auxp;
     MYFLT *delr = (MYFLT *)p->delr.auxp;
 
@@ -1265,152 +1215,27 @@ static int32_t early_process(CSOUND *csound, early *p)
                       }
                     }
 
-                    skip = 0;
                     /* store current phase */
-                    if (angleindex > elevationarray[elevindex] / 2) {
-                      for (i = 0; i < elevindex; i ++)
-                        skip +=((int32_t)(elevationarray[i] / 2)
-                                + 1) * irlength;
-                      for (i = 0;
-                           i < (elevationarray[elevindex] -
-                                angleindex);
-                           i++)
-                        skip += irlength;
-                      for (i = 0; i < irlength; i++) {
-                        currentphasel[irlength * M + i] =
-                          fpindexr[skip + i];
-                        currentphaser[irlength * M + i] =
-                          fpindexl[skip + i];
-                      }
-                    }
-                    else {
-                      for (i = 0; i < elevindex; i ++)
-                        skip +=((int32_t)(elevationarray[i] / 2)
-                                + 1) * irlength;
-                      for (i = 0; i < angleindex; i++)
-                        skip += irlength;
-                      for (i = 0; i < irlength; i++) {
-                        currentphasel[irlength * M + i] =
-                          fpindexl[skip+i];
-                        currentphaser[irlength * M + i] =
-                          fpindexr[skip+i];
-                      }
-                    }
+                    curtrig[2 * M] = hrtfdb_trig(db, elevindex, angleindex, 0);
+                    curtrig[2 * M + 1] =
+                      hrtfdb_trig(db, elevindex, angleindex, 1);
                   }
+                  curtrigl = curtrig[2 * M];
+                  curtrigr = curtrig[2 * M + 1];
 
                   /* for next check */
                   oldelevindex[M] = elevindex;
                   oldangleindex[M] = angleindex;
 
-                  /* read 4 nearest HRTFs */
-                  /* switch l and r */
-                  skip = 0;
-                  if (angleindex1 > elevationarray[elevindexlow] / 2) {
-                    for (i = 0; i < elevindexlow; i ++)
-                      skip +=((int32_t)(elevationarray[i] / 2)
-                              + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexlow] -
-                              angleindex1);
-                         i++)
-                      skip += irlength;
-                    for (i = 0; i < irlength; i++) {
-                      lowl1[i] = fpindexr[skip+i];
-                      lowr1[i] = fpindexl[skip+i];
-                    }
-                  }
-                  else {
-                    for (i = 0; i < elevindexlow; i ++)
-                      skip +=((int32_t)(elevationarray[i] / 2)
-                              + 1) * irlength;
-                    for (i = 0; i < angleindex1; i++)
-                      skip += irlength;
-                    for (i = 0; i < irlength; i++) {
-                      lowl1[i] = fpindexl[skip+i];
-                      lowr1[i] = fpindexr[skip+i];
-                    }
-                  }
-
-                  skip = 0;
-                  if (angleindex2 > elevationarray[elevindexlow] / 2) {
-                    for (i = 0; i < elevindexlow; i ++)
-                      skip +=((int32_t)(elevationarray[i] / 2)
-                              + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexlow] -
-                              angleindex2);
-                         i++)
-                      skip += irlength;
-                    for (i = 0; i < irlength; i++) {
-                      lowl2[i] = fpindexr[skip+i];
-                      lowr2[i] = fpindexl[skip+i];
-                    }
-                  }
-                  else {
-                    for (i = 0; i < elevindexlow; i ++)
-                      skip +=((int32_t)(elevationarray[i] / 2)
-                              + 1) * irlength;
-                    for (i = 0; i < angleindex2; i++)
-                      skip += irlength;
-                    for (i = 0; i < irlength; i++) {
-                      lowl2[i] = fpindexl[skip+i];
-                      lowr2[i] = fpindexr[skip+i];
-                    }
-                  }
-
-                  skip = 0;
-                  if (angleindex3 > elevationarray[elevindexhigh] / 2) {
-                    for (i = 0; i < elevindexhigh; i ++)
-                      skip +=((int32_t)(elevationarray[i] / 2)
-                              + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexhigh] -
-                              angleindex3);
-                         i++)
-                      skip += irlength;
-                    for (i = 0; i < irlength; i++) {
-                      highl1[i] = fpindexr[skip+i];
-                      highr1[i] = fpindexl[skip+i];
-                    }
-                  }
-                  else {
-                    for (i = 0; i < elevindexhigh; i ++)
-                      skip +=((int32_t)(elevationarray[i] / 2)
-                              + 1) * irlength;
-                    for (i = 0; i < angleindex3; i++)
-                      skip += irlength;
-                    for (i = 0; i < irlength; i++) {
-                      highl1[i] = fpindexl[skip+i];
-                      highr1[i] = fpindexr[skip+i];
-                    }
-                  }
-
-                  skip = 0;
-                  if (angleindex4 > elevationarray[elevindexhigh] / 2) {
-                    for (i = 0; i < elevindexhigh; i ++)
-                      skip +=((int32_t)(elevationarray[i] / 2)
-                              + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexhigh] -
-                              angleindex4);
-                         i++)
-                      skip += irlength;
-                    for (i = 0; i < irlength; i++) {
-                      highl2[i] = fpindexr[skip+i];
-                      highr2[i] = fpindexl[skip+i];
-                    }
-                  }
-                  else {
-                    for (i = 0; i < elevindexhigh; i ++)
-                      skip +=((int32_t)(elevationarray[i] / 2)
-                              + 1) * irlength;
-                    for (i = 0; i < angleindex4; i++)
-                      skip += irlength;
-                    for (i = 0; i < irlength; i++) {
-                      highl2[i] = fpindexl[skip+i];
-                      highr2[i] = fpindexr[skip+i];
-                    }
-                  }
+                  /* 4 nearest HRTFs */
+                  lowl1 = hrtfdb_spec(db, elevindexlow, angleindex1, 0);
+                  lowr1 = hrtfdb_spec(db, elevindexlow, angleindex1, 1);
+                  lowl2 = hrtfdb_spec(db, elevindexlow, angleindex2, 0);
+                  lowr2 = hrtfdb_spec(db, elevindexlow, angleindex2, 1);
+                  highl1 = hrtfdb_spec(db, elevindexhigh, angleindex3, 0);
+                  highr1 = hrtfdb_spec(db, elevindexhigh, angleindex3, 1);
+                  highl2 = hrtfdb_spec(db, elevindexhigh, angleindex4, 0);
+                  highr2 = hrtfdb_spec(db, elevindexhigh, angleindex4, 1);
 
                   /* magnitude interpolation */
                   /* 0hz and Nyq */
@@ -1430,11 +1255,11 @@ static int32_t early_process(CSOUND *csound, early *p)
                     elevindexhighper;
                   magr = magrlow + (magrhigh - magrlow) *
                     elevindexhighper;
-                  if (currentphasel[M * irlength] < FL(0.0))
+                  if (curtrigl[0] < FL(0.0))
                     hrtflinterp[0] = - magl;
                   else
                     hrtflinterp[0] = magl;
-                  if (currentphaser[M * irlength] < FL(0.0))
+                  if (curtrigr[0] < FL(0.0))
                     hrtfrinterp[0] = - magr;
                   else
                     hrtfrinterp[0] = magr;
@@ -1455,11 +1280,11 @@ static int32_t early_process(CSOUND *csound, early *p)
                     elevindexhighper;
                   magr = magrlow + (magrhigh - magrlow) *
                     elevindexhighper;
-                  if (currentphasel[M * irlength + 1] < FL(0.0))
+                  if (curtrigl[1] < FL(0.0))
                     hrtflinterp[1] = - magl;
                   else
                     hrtflinterp[1] = magl;
-                  if (currentphaser[M * irlength + 1] < FL(0.0))
+                  if (curtrigr[1] < FL(0.0))
                     hrtfrinterp[1] = - magr;
                   else
                     hrtfrinterp[1] = magr;
@@ -1481,18 +1306,16 @@ static int32_t early_process(CSOUND *csound, early *p)
                        use current phase */
                     magl = magllow +  (maglhigh - magllow) *
                       elevindexhighper;
-                    phasel = currentphasel[M * irlength + i + 1];
 
                     /* polar to rectangular */
-                    hrtflinterp[i] = magl * COS(phasel);
-                    hrtflinterp[i + 1] = magl * SIN(phasel);
+                    hrtflinterp[i] = magl * curtrigl[i];
+                    hrtflinterp[i + 1] = magl * curtrigl[i + 1];
 
                     magr = magrlow + (magrhigh - magrlow) *
                       elevindexhighper;
-                    phaser = currentphaser[M * irlength + i + 1];
 
-                    hrtfrinterp[i] = magr * COS(phaser);
-                    hrtfrinterp[i + 1] = magr * SIN(phaser);
+                    hrtfrinterp[i] = magr * curtrigr[i];
+                    hrtfrinterp[i + 1] = magr * curtrigr[i + 1];
                   }
 
                   csound->InverseRealFFT(csound, hrtflinterp,
@@ -23,6 +23,7 @@
 
 #include "csoundCore.h"
 #include "interlocks.h"
+#include "hrtfdb.h"
 
 #include <math.h>
 /* definitions */
@@ -160,7 +161,8 @@ typedef struct
         /* check if relative source has changed! */
         MYFLT anglev, elevv;
 
-        float *fpbeginl,*fpbeginr;
+        /* shared HRTF store */
+        const HRTFDB *db;
 
         /* see definitions in INIT */
         int32_t irlength, irlengthpad, overlapsize;
@@ -202,10 +204,8 @@ typedef struct
         /* old overlap data for longer crossfades */
         AUXCH overlapoldl, overlapoldr;
 
-        /* interpolation buffers */
-        AUXCH lowl1, lowr1, lowl2, lowr2, highl1, highr1, highl2, highr2;
-        /* current phase buffers */
-        AUXCH currentphasel, currentphaser;
+        /* cos/sin of the current phase, in the store */
+        const MYFLT *curtrigl, *curtrigr;
 
         /* min phase buffers */
         AUXCH logmagl,logmagr,xhatwinl,xhatwinr,expxhatwinl,expxhatwinr;
@@ -302,9 +302,9 @@ static int32_t hrtfmove_init(CSOUND *csound, hrtfmove *p)
     /* the amount of buffers to fade over. */
     p->fadebuffer = (int32_t)fade*irlength;
 
-    /* file handles */
-    p->fpbeginl = (float *) fpl->beginp;
-    p->fpbeginr = (float *) fpr->beginp;
+    p->db = hrtfdb_get(csound, fpl, fpr, irlength);
+    if (UNLIKELY(p->db == NULL))
+      return csound->InitError(csound, "%s", Str("hrtfmove: unusable HRTF data"));
 
     /* common buffers (used by both min phase and phasetrunc) */
     if (!p->insig.auxp || p->insig.size < irlength * sizeof(MYFLT))
@@ -345,38 +345,9 @@ static int32_t hrtfmove_init(CSOUND *csound, hrtfmove *p)
     memset(p->overlapl.auxp, 0, overlapsize * sizeof(MYFLT));
     memset(p->overlapr.auxp, 0, overlapsize * sizeof(MYFLT));
 
-    /* interpolation values */
-    if (!p->lowl1.auxp || p->lowl1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowl1);
-    if (!p->lowr1.auxp || p->lowr1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowr1);
-    if (!p->lowl2.auxp || p->lowl2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowl2);
-    if (!p->lowr2.auxp || p->lowr2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowr2);
-    if (!p->highl1.auxp || p->highl1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highl1);
-    if (!p->highr1.auxp || p->highr1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highr1);
-    if (!p->highl2.auxp || p->highl2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highl2);
-    if (!p->highr2.auxp || p->highr2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highr2);
-    if (!p->currentphasel.auxp || p->currentphasel.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength*sizeof(MYFLT), &p->currentphasel);
-    if (!p->currentphaser.auxp || p->currentphaser.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength*sizeof(MYFLT), &p->currentphaser);
-
-    memset(p->lowl1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->lowr1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->lowl2.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->lowr2.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highl1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highl2.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highr1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highr2.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->currentphasel.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->currentphaser.auxp, 0, irlength * sizeof(MYFLT));
+    /* current phase: set on the first block */
+    p->curtrigl = hrtfdb_trig(p->db, 0, 0, 0);
+    p->curtrigr = hrtfdb_trig(p->db, 0, 0, 1);
 
     /* phase truncation buffers and variables */
     if (!p->oldhrtflpad.auxp || p->oldhrtflpad.size < irlengthpad * sizeof(MYFLT))
@@ -508,10 +479,6 @@ static int32_t hrtfmove_process(CSOUND *csound, hrtfmove *p)
 
     int32_t counter = p->counter;
 
-    /* pointers into HRTF files: floating point data (even in 64 bit csound) */
-    float *fpindexl;
-    float *fpindexr;
-
     int32_t i,elevindex, angleindex, skip = 0;
 
     int32_t minphase = p->minphase;
@@ -528,23 +495,19 @@ static int32_t hrtfmove_process(CSOUND *csound, hrtfmove *p)
     MYFLT angleindexlowstore;
     MYFLT angleindexhighstore;
 
-    /* interpolation values */
-    MYFLT *lowl1 = (MYFLT *)p->lowl1.auxp;
-    MYFLT *lowr1 = (MYFLT *)p->lowr1.auxp;
-    MYFLT *lowl2 = (MYFLT *)p->lowl2.auxp;
-    MYFLT *lowr2 = (MYFLT *)p->lowr2.auxp;
-    MYFLT *highl1 = (MYFLT *)p->highl1.auxp;
-    MYFLT *highr1 = (MYFLT *)p->highr1.auxp;
-    MYFLT *highl2 = (MYFLT *)p->highl2.auxp;
-    MYFLT *highr2 = (MYFLT *)p->highr2.auxp;
-    MYFLT *currentphasel = (MYFLT *)p->currentphasel.auxp;
-    MYFLT *currentphaser = (MYFLT *)p->currentphaser.auxp;
+    /* interpolation values: spectra in the shared store */
+    const HRTFDB *db = p->db;
+    const MYFLT *lowl1, *lowr1, *lowl2, *lowr2;
+    const MYFLT *highl1, *highr1, *highl2, *highr2;
+    /* cos/sin of the current phase */
+    const MYFLT *curtrigl = p->curtrigl;
+    const MYFLT *curtrigr = p->curtrigr;
 
     /* local interpolation values */
     MYFLT elevindexhighper, angleindex2per, angleindex4per;
     int32_t elevindexlow, elevindexhigh, angleindex1, angleindex2,
       angleindex3, angleindex4;
-    MYFLT magl,magr,phasel,phaser, magllow, magrlow, maglhigh, magrhigh;
+    MYFLT magl,magr, magllow, magrlow, maglhigh, magrhigh;
 
     /* phase truncation buffers and variables */
     MYFLT *oldhrtflpad = (MYFLT *)p->oldhrtflpad.auxp;
@@ -595,10 +558,6 @@ static int32_t hrtfmove_process(CSOUND *csound, hrtfmove *p)
     uint32_t j, nsmps = CS_KSMPS;
     MYFLT outvdl, outvdr, vdtl, vdtr, fracl, fracr, rpl, rpr;
 
-    /* start indices at correct value (start of file)/ zero indices. */
-    fpindexl = (float *) p->fpbeginl;
-    fpindexr = (float *) p->fpbeginr;
-
     if (UNLIKELY(offset)) {
       memset(outsigl, '\0', offset*sizeof(MYFLT));
       memset(outsigr, '\0', offset*sizeof(MYFLT));
@@ -719,153 +678,25 @@ static int32_t hrtfmove_process(CSOUND *csound, hrtfmove *p)
 
                         /* store point for current phase as trajectory comes
                            closer to a new index */
-                        skip = 0;
-                        /* store current phase */
-                        if(angleindex > elevationarray[elevindex] / 2)
-                          {
-                            for(i = 0; i < elevindex; i++)
-                              skip +=((int32_t)(elevationarray[i] / 2)+1)*irlength;
-                            for (i = 0;
-                                 i < (elevationarray[elevindex] - angleindex);
-                                 i++)
-                              skip += irlength;
-                            for(i = 0; i < irlength; i++)
-                              {
-                                currentphasel[i] = fpindexr[skip + i];
-                                currentphaser[i] = fpindexl[skip + i];
-                              }
-                          }
-                        else
-                          {
-                            for(i = 0; i < elevindex; i++)
-                              skip +=((int32_t)(elevationarray[i] / 2)+1)*irlength;
-                            for (i = 0; i < angleindex; i++)
-                              skip += irlength;
-                            for(i = 0; i < irlength; i++)
-                              {
-                                currentphasel[i] = fpindexl[skip+i];
-                                currentphaser[i] = fpindexr[skip+i];
-                              }
-                          }
+                        curtrigl = hrtfdb_trig(db, elevindex, angleindex, 0);
+                        curtrigr = hrtfdb_trig(db, elevindex, angleindex, 1);
+                        p->curtrigl = curtrigl;
+                        p->curtrigr = curtrigr;
                       }
                   }
                 /* for next check */
                 p->oldelevindex = elevindex;
                 p->oldangleindex = angleindex;
 
-                /* read 4 nearest HRTFs */
-                skip = 0;
-                /* switch l and r */
-                if(angleindex1 > elevationarray[elevindexlow] / 2)
-                  {
-                    for(i = 0; i < elevindexlow; i++)
-                      skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexlow] - angleindex1);
-                         i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        lowl1[i] = fpindexr[skip+i];
-                        lowr1[i] = fpindexl[skip+i];
-                      }
-                  }
-                else
-                  {
-                    for(i = 0; i < elevindexlow; i++)
-                      skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0; i < angleindex1; i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        lowl1[i] = fpindexl[skip+i];
-                        lowr1[i] = fpindexr[skip+i];
-                      }
-                  }
-
-                skip = 0;
-                if(angleindex2 > elevationarray[elevindexlow] / 2)
-                  {
-                    for(i = 0; i < elevindexlow; i++)
-                      skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexlow] - angleindex2);
-                         i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        lowl2[i] = fpindexr[skip+i];
-                        lowr2[i] = fpindexl[skip+i];
-                      }
-                  }
-                else
-                  {
-                    for(i = 0; i < elevindexlow; i++)
-                      skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0; i < angleindex2; i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        lowl2[i] = fpindexl[skip+i];
-                        lowr2[i] = fpindexr[skip+i];
-                      }
-                  }
-
-                skip = 0;
-                if(angleindex3 > elevationarray[elevindexhigh] / 2)
-                  {
-                    for(i = 0; i < elevindexhigh; i++)
-                      skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexhigh] - angleindex3);
-                         i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        highl1[i] = fpindexr[skip+i];
-                        highr1[i] = fpindexl[skip+i];
-                      }
-                  }
-                else
-                  {
-                    for(i = 0; i < elevindexhigh; i++)
-                      skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0; i < angleindex3; i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        highl1[i] = fpindexl[skip+i];
-                        highr1[i] = fpindexr[skip+i];
-                      }
-                  }
-
-                skip = 0;
-                if(angleindex4 > elevationarray[elevindexhigh] / 2)
-                  {
-                    for(i = 0; i < elevindexhigh; i++)
-                      skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexhigh] - angleindex4);
-                         i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        highl2[i] = fpindexr[skip+i];
-                        highr2[i] = fpindexl[skip+i];
-                      }
-                  }
-                else
-                  {
-                    for(i = 0; i < elevindexhigh; i++)
-                      skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0; i < angleindex4; i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        highl2[i] = fpindexl[skip+i];
-                        highr2[i] = fpindexr[skip+i];
-                      }
-                  }
+                /* 4 nearest HRTFs */
+                lowl1 = hrtfdb_spec(db, elevindexlow, angleindex1, 0);
+                lowr1 = hrtfdb_spec(db, elevindexlow, angleindex1, 1);
+                lowl2 = hrtfdb_spec(db, elevindexlow, angleindex2, 0);
+                lowr2 = hrtfdb_spec(db, elevindexlow, angleindex2, 1);
+                highl1 = hrtfdb_spec(db, elevindexhigh, angleindex3, 0);
+                highr1 = hrtfdb_spec(db, elevindexhigh, angleindex3, 1);
+                highl2 = hrtfdb_spec(db, elevindexhigh, angleindex4, 0);
+                highr2 = hrtfdb_spec(db, elevindexhigh, angleindex4, 1);
 
                 /* interpolation */
                 /* 0 Hz and Nyq...absoulute values for mag */
@@ -885,7 +716,7 @@ static int32_t hrtfmove_process(CSOUND *csound, hrtfmove *p)
                 /* if pi, real is negative! */
                 else
                   {
-                    if(currentphasel[0] < FL(0.0))
+                    if(curtrigl[0] < FL(0.0))
                       hrtflfloat[0] = -magl;
                     else
                       hrtflfloat[0] = magl;
@@ -903,7 +734,7 @@ static int32_t hrtfmove_process(CSOUND *csound, hrtfmove *p)
                 else
 
                   {
-                    if(currentphasel[1] < FL(0.0))
+                    if(curtrigl[1] < FL(0.0))
                       hrtflfloat[1] = -magl;
                     else
                       hrtflfloat[1] = magl;
@@ -920,7 +751,7 @@ static int32_t hrtfmove_process(CSOUND *csound, hrtfmove *p)
                   }
                 else
                   {
-                    if(currentphaser[0] < FL(0.0))
+                    if(curtrigr[0] < FL(0.0))
                       hrtfrfloat[0] = -magr;
                     else
                       hrtfrfloat[0] = magr;
@@ -937,7 +768,7 @@ static int32_t hrtfmove_process(CSOUND *csound, hrtfmove *p)
                   }
                 else
                   {
-                    if(currentphaser[1] < FL(0.0))
+                    if(curtrigr[1] < FL(0.0))
                       hrtfrfloat[1] = -magr;
                     else
                       hrtfrfloat[1] = magr;
@@ -960,15 +791,11 @@ static int32_t hrtfmove_process(CSOUND *csound, hrtfmove *p)
                     if(phasetrunc)
                       {
                         /* use current phase, back to rectangular */
-                        phasel = currentphasel[i + 1];
-                        phaser = currentphaser[i + 1];
+                        hrtflfloat[i] = magl * curtrigl[i];
+                        hrtflfloat[i+1] = magl * curtrigl[i + 1];
 
-                        /* polar to rectangular */
-                        hrtflfloat[i] = magl * COS(phasel);
-                        hrtflfloat[i+1] = magl * SIN(phasel);
-
-                        hrtfrfloat[i] = magr * COS(phaser);
-                        hrtfrfloat[i+1] = magr * SIN(phaser);
+                        hrtfrfloat[i] = magr * curtrigr[i];
+                        hrtfrfloat[i+1] = magr * curtrigr[i + 1];
                       }
 
                     if(minphase)
@@ -1376,9 +1203,6 @@ typedef struct
         /* overlap data */
         AUXCH overlapl, overlapr;
 
-        /* interpolation buffers */
-        AUXCH lowl1, lowr1, lowl2, lowr2, highl1, highr1, highl2, highr2;
-
         /* buffers for impulse shift */
         AUXCH leftshiftbuffer, rightshiftbuffer;
 }
@@ -1390,15 +1214,10 @@ static int32_t hrtfstat_init(CSOUND *csound, hrtfstat *p)
     MEMFIL *fpl = NULL, *fpr = NULL;
     char filel[MAXNAME], filer[MAXNAME];
 
-    /* interpolation values */
-    MYFLT *lowl1;
-    MYFLT *lowr1;
-    MYFLT *lowl2;
-    MYFLT *lowr2;
-    MYFLT *highl1;
-    MYFLT *highr1;
-    MYFLT *highl2;
-    MYFLT *highr2;
+    /* interpolation values: spectra in the shared store */
+    const HRTFDB *db;
+    const MYFLT *lowl1, *lowr1, *lowl2, *lowr2;
+    const MYFLT *highl1, *highr1, *highl2, *highr2;
 
     MYFLT *hrtflfloat;
     MYFLT *hrtfrfloat;
@@ -1411,14 +1230,10 @@ static int32_t hrtfstat_init(CSOUND *csound, hrtfstat *p)
     MYFLT r = *p->oradius;
     MYFLT sr = *p->osr;
 
-        /* pointers into HRTF files */
-    float *fpindexl=NULL;
-    float *fpindexr=NULL;
-
     /* time domain impulse length, padded, overlap add */
     int32_t irlength=0, irlengthpad=0, overlapsize=0;
 
-    int32_t i, skip = 0;
+    int32_t i;
 
     /* local interpolation values */
     MYFLT elevindexhighper, angleindex2per, angleindex4per;
@@ -1488,10 +1303,9 @@ static int32_t hrtfstat_init(CSOUND *csound, hrtfstat *p)
 
     p->sroverN = sr/irlength;
 
-    /* start indices at correct value (start of file)/ zero indices.
-       (do not need to store here, as only accessing in INIT) */
-    fpindexl = (float *) fpl->beginp;
-    fpindexr = (float *) fpr->beginp;
+    db = hrtfdb_get(csound, fpl, fpr, irlength);
+    if (UNLIKELY(db == NULL))
+      return csound->InitError(csound, "%s", Str("hrtfstat: unusable HRTF data"));
 
     /* buffers */
     if (!p->insig.auxp || p->insig.size < irlength * sizeof(MYFLT))
@@ -1532,34 +1346,6 @@ static int32_t hrtfstat_init(CSOUND *csound, hrtfstat *p)
     memset(p->overlapl.auxp, 0, overlapsize * sizeof(MYFLT));
     memset(p->overlapr.auxp, 0, overlapsize * sizeof(MYFLT));
 
-    /* interpolation values */
-    if (!p->lowl1.auxp || p->lowl1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowl1);
-    if (!p->lowr1.auxp || p->lowr1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowr1);
-    if (!p->lowl2.auxp || p->lowl2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowl2);
-    if (!p->lowr2.auxp || p->lowr2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowr2);
-    if (!p->highl1.auxp || p->highl1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highl1);
-    if (!p->highr1.auxp || p->highr1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highr1);
-    if (!p->highl2.auxp || p->highl2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highl2);
-    if (!p->highr2.auxp || p->highr2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highr2);
-
-    /* best to zero, for future changes (filled in init) */
-    memset(p->lowl1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->lowr1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->lowl2.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->lowr2.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highl1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highl2.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highr1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highr2.auxp, 0, irlength * sizeof(MYFLT));
-
     /* shift buffers */
     if (!p->leftshiftbuffer.auxp ||
         p->leftshiftbuffer.size < irlength * sizeof(MYFLT))
@@ -1571,15 +1357,6 @@ static int32_t hrtfstat_init(CSOUND *csound, hrtfstat *p)
     memset(p->leftshiftbuffer.auxp, 0, irlength * sizeof(MYFLT));
     memset(p->rightshiftbuffer.auxp, 0, irlength * sizeof(MYFLT));
 
-    lowl1 = (MYFLT *)p->lowl1.auxp;
-    lowr1 = (MYFLT *)p->lowr1.auxp;
-    lowl2 = (MYFLT *)p->lowl2.auxp;
-    lowr2 = (MYFLT *)p->lowr2.auxp;
-    highl1 = (MYFLT *)p->highl1.auxp;
-    highr1 = (MYFLT *)p->highr1.auxp;
-    highl2 = (MYFLT *)p->highl2.auxp;
-    highr2 = (MYFLT *)p->highr2.auxp;
-
     leftshiftbuffer = (MYFLT *)p->leftshiftbuffer.auxp;
     rightshiftbuffer = (MYFLT *)p->rightshiftbuffer.auxp;
 
@@ -1634,111 +1411,15 @@ static int32_t hrtfstat_init(CSOUND *csound, hrtfstat *p)
     angleindex2per = angleindexlowstore - angleindex1;
     angleindex4per = angleindexhighstore - angleindex3;
 
-    /* read 4 nearest HRTFs */
-    skip = 0;
-    /* switch l and r */
-    if(angleindex1 > elevationarray[elevindexlow] / 2)
-      {
-        for(i = 0; i < elevindexlow; i++)
-          skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-        for (i = 0; i < (elevationarray[elevindexlow] - angleindex1); i++)
-          skip += irlength;
-        for(i = 0; i < irlength; i++)
-          {
-            lowl1[i] = fpindexr[skip + i];
-            lowr1[i] = fpindexl[skip + i];
-          }
-      }
-    else
-      {
-        for(i = 0; i < elevindexlow; i++)
-          skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-        for (i = 0; i < angleindex1; i++)
-          skip += irlength;
-        for(i = 0; i < irlength; i++)
-          {
-            lowl1[i] = fpindexl[skip + i];
-            lowr1[i] = fpindexr[skip + i];
-          }
-      }
-
-    skip = 0;
-    if(angleindex2 > elevationarray[elevindexlow] / 2)
-      {
-        for(i = 0; i < elevindexlow; i++)
-          skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-        for (i = 0; i < (elevationarray[elevindexlow] - angleindex2); i++)
-          skip += irlength;
-        for(i = 0; i < irlength; i++)
-          {
-            lowl2[i] = fpindexr[skip + i];
-            lowr2[i] = fpindexl[skip + i];
-          }
-      }
-    else
-      {
-        for(i = 0; i < elevindexlow; i++)
-          skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-        for (i = 0; i < angleindex2; i++)
-          skip += irlength;
-        for(i = 0; i < irlength; i++)
-          {
-            lowl2[i] = fpindexl[skip + i];
-            lowr2[i] = fpindexr[skip + i];
-          }
-      }
-
-    skip = 0;
-    if(angleindex3 > elevationarray[elevindexhigh] / 2)
-      {
-        for(i = 0; i < elevindexhigh; i++)
-          skip += ((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-        for (i = 0; i < (elevationarray[elevindexhigh] - angleindex3); i++)
-          skip += irlength;
-        for(i = 0; i < irlength; i++)
-          {
-            highl1[i] = fpindexr[skip + i];
-            highr1[i] = fpindexl[skip + i];
-          }
-      }
-    else
-      {
-        for(i = 0; i < elevindexhigh; i++)
-          skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-        for (i = 0; i < angleindex3; i++)
-          skip += irlength;
-        for(i = 0; i < irlength; i++)
-          {
-            highl1[i] = fpindexl[skip + i];
-            highr1[i] = fpindexr[skip + i];
-          }
-      }
-
-    skip = 0;
-    if(angleindex4 > elevationarray[elevindexhigh] / 2)
-      {
-        for(i = 0; i < elevindexhigh; i++)
-          skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-        for (i = 0; i < (elevationarray[elevindexhigh] - angleindex4); i++)
-          skip += irlength;
-        for(i = 0; i < irlength; i++)
-          {
-            highl2[i] = fpindexr[skip + i];
-            highr2[i] = fpindexl[skip + i];
-          }
-      }
-    else
-      {
-        for(i = 0; i < elevindexhigh; i++)
-          skip +=((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-        for (i = 0; i < angleindex4; i++)
-          skip += irlength;
-        for(i = 0; i < irlength; i++)
-          {
-            highl2[i] = fpindexl[skip + i];
-            highr2[i] = fpindexr[skip + i];
-          }
-      }
+    /* 4 nearest HRTFs */
+    lowl1 = hrtfdb_spec(db, elevindexlow, angleindex1, 0);
+    lowr1 = hrtfdb_spec(db, elevindexlow, angleindex1, 1);
+    lowl2 = hrtfdb_spec(db, elevindexlow, angleindex2, 0);
+    lowr2 = hrtfdb_spec(db, elevindexlow, angleindex2, 1);
+    highl1 = hrtfdb_spec(db, elevindexhigh, angleindex3, 0);
+    highr1 = hrtfdb_spec(db, elevindexhigh, angleindex3, 1);
+    highl2 = hrtfdb_spec(db, elevindexhigh, angleindex4, 0);
+    highr2 = hrtfdb_spec(db, elevindexhigh, angleindex4, 1);
 
     /* woodworth process */
     /* ITD formula, check which ear is relevant to calculate angle from */
@@ -2019,7 +1700,8 @@ MYFLT *ooverlap, *oradius, *osr;
 
         int32_t hopsize;
 
-        float *fpbeginl,*fpbeginr;
+        /* shared HRTF store */
+        const HRTFDB *db;
 
         /* to keep track of process */
         int32_t counter, t;
@@ -2036,9 +1718,6 @@ MYFLT *ooverlap, *oradius, *osr;
         /* spectral data */
         AUXCH outspecl, outspecr;
 
-        /* interpolation buffers */
-        AUXCH lowl1,lowr1,lowl2,lowr2,highl1,highr1,highl2,highr2;
-
         /* stft window */
         AUXCH win;
         /* used for skipping into next stft array on way in and out */
@@ -2107,9 +1786,10 @@ static int32_t hrtfmove2_init(CSOUND *csound, hrtfmove2 *p)
     p->irlength = irlength;
     p->sroverN = sr / irlength;
 
-    /* file handles */
-    p->fpbeginl = (float *) fpl->beginp;
-    p->fpbeginr = (float *) fpr->beginp;
+    p->db = hrtfdb_get(csound, fpl, fpr, irlength);
+    if (UNLIKELY(p->db == NULL))
+      return csound->InitError(csound, "%s",
+                               Str("hrtfmove2: unusable HRTF data"));
 
     if(overlap != 2 && overlap != 4 && overlap != 8 && overlap != 16)
       overlap = 4;
@@ -2149,33 +1829,6 @@ static int32_t hrtfmove2_init(CSOUND *csound, hrtfmove2 *p)
     memset(p->outspecl.auxp, 0, irlength * sizeof(MYFLT));
     memset(p->outspecr.auxp, 0, irlength * sizeof(MYFLT));
 
-    /* interpolation values */
-    if (!p->lowl1.auxp || p->lowl1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowl1);
-    if (!p->lowr1.auxp || p->lowr1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowr1);
-    if (!p->lowl2.auxp || p->lowl2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowl2);
-    if (!p->lowr2.auxp || p->lowr2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->lowr2);
-    if (!p->highl1.auxp || p->highl1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highl1);
-    if (!p->highr1.auxp || p->highr1.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highr1);
-    if (!p->highl2.auxp || p->highl2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highl2);
-    if (!p->highr2.auxp || p->highr2.size < irlength * sizeof(MYFLT))
-      csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->highr2);
-
-    memset(p->lowl1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->lowr1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->lowl2.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->lowr2.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highl1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highl2.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highr1.auxp, 0, irlength * sizeof(MYFLT));
-    memset(p->highr2.auxp, 0, irlength * sizeof(MYFLT));
-
     if (!p->win.auxp || p->win.size < irlength * sizeof(MYFLT))
       csound->AuxAlloc(csound, irlength * sizeof(MYFLT), &p->win);
     if (!p->overlapskipin.auxp || p->overlapskipin.size < overlap * sizeof(int32_t))
@@ -2254,24 +1907,15 @@ static int32_t hrtfmove2_process(CSOUND *csound, hrtfmove2 *p)
     int32_t counter = p ->counter;
     int32_t t = p ->t;
 
-        /* pointers into HRTF files */
-    float *fpindexl;
-    float *fpindexr;
-
-    int32_t i, skip = 0;
+    int32_t i;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
     uint32_t j, nsmps = CS_KSMPS;
 
-    /* interpolation values */
-    MYFLT *lowl1 = (MYFLT *)p->lowl1.auxp;
-    MYFLT *lowr1 = (MYFLT *)p->lowr1.auxp;
-    MYFLT *lowl2 = (MYFLT *)p->lowl2.auxp;
-    MYFLT *lowr2 = (MYFLT *)p->lowr2.auxp;
-    MYFLT *highl1 = (MYFLT *)p->highl1.auxp;
-    MYFLT *highr1 = (MYFLT *)p->highr1.auxp;
-    MYFLT *highl2 = (MYFLT *)p->highl2.auxp;
-    MYFLT *highr2 = (MYFLT *)p->highr2.auxp;
+    /* interpolation values: spectra in the shared store */
+    const HRTFDB *db = p->db;
+    const MYFLT *lowl1, *lowr1, *lowl2, *lowr2;
+    const MYFLT *highl1, *highr1, *highl2, *highr2;
 
     /* local interpolation values */
     MYFLT elevindexhighper, angleindex2per, angleindex4per;
@@ -2289,11 +1933,6 @@ static int32_t hrtfmove2_process(CSOUND *csound, hrtfmove2 *p)
     MYFLT angleindexlowstore;
     MYFLT angleindexhighstore;
 
-
-    /* start indices at correct value (start of file)/ zero indices. */
-    fpindexl = (float *) p->fpbeginl;
-    fpindexr = (float *) p->fpbeginr;
-
     if (UNLIKELY(offset)) {
       memset(outsigl, '\0', offset*sizeof(MYFLT));
       memset(outsigr, '\0', offset*sizeof(MYFLT));
@@ -2366,119 +2005,15 @@ static int32_t hrtfmove2_process(CSOUND *csound, hrtfmove2 *p)
                 angleindex2per = angleindexlowstore - angleindex1;
                 angleindex4per = angleindexhighstore - angleindex3;
 
-                /* read 4 nearest HRTFs */
-                skip = 0;
-                /* switch l and r */
-                if(angleindex1 > elevationarray[elevindexlow] / 2)
-                  {
-                    for(i = 0; i < elevindexlow; i++)
-                      skip += ((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexlow] - angleindex1);
-                         i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        lowl1[i] = fpindexr[skip + i];
-                        lowr1[i] = fpindexl[skip + i];
-                      }
-                  }
-                else
-                  {
-                    for(i = 0; i < elevindexlow; i++)
-                      skip += ((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0; i < angleindex1; i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        lowl1[i] = fpindexl[skip + i];
-                        lowr1[i] = fpindexr[skip + i];
-                      }
-                  }
-
-                skip = 0;
-                if(angleindex2 > elevationarray[elevindexlow] / 2)
-                  {
-                    for(i = 0; i < elevindexlow; i++)
-                      skip += ((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexlow] - angleindex2);
-                         i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        lowl2[i] = fpindexr[skip + i];
-                        lowr2[i] = fpindexl[skip + i];
-                      }
-                  }
-                else
-                  {
-                    for(i = 0; i < elevindexlow; i++)
-                      skip += ((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0; i < angleindex2; i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        lowl2[i] = fpindexl[skip + i];
-                        lowr2[i] = fpindexr[skip + i];
-                      }
-                  }
-
-                skip = 0;
-                if(angleindex3 > elevationarray[elevindexhigh] / 2)
-                  {
-                    for(i = 0; i < elevindexhigh; i++)
-                      skip += ((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexhigh] - angleindex3);
-                         i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        highl1[i] = fpindexr[skip + i];
-                        highr1[i] = fpindexl[skip + i];
-                      }
-                  }
-                else
-                  {
-                    for(i = 0; i < elevindexhigh; i++)
-                      skip += ((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0; i < angleindex3; i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        highl1[i] = fpindexl[skip + i];
-                        highr1[i] = fpindexr[skip + i];
-                      }
-                  }
-
-                skip = 0;
-                if(angleindex4 > elevationarray[elevindexhigh] / 2)
-                  {
-                    for(i = 0; i < elevindexhigh; i++)
-                      skip += ((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0;
-                         i < (elevationarray[elevindexhigh] - angleindex4);
-                         i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        highl2[i] = fpindexr[skip + i];
-                        highr2[i] = fpindexl[skip + i];
-                      }
-                  }
-                else
-                  {
-                    for(i = 0; i < elevindexhigh; i++)
-                      skip += ((int32_t)(elevationarray[i] / 2) + 1) * irlength;
-                    for (i = 0; i < angleindex4; i++)
-                      skip += irlength;
-                    for(i = 0; i < irlength; i++)
-                      {
-                        highl2[i] = fpindexl[skip + i];
-                        highr2[i] = fpindexr[skip + i];
-                      }
-                  }
+                /* 4 nearest HRTFs */
+                lowl1 = hrtfdb_spec(db, elevindexlow, angleindex1, 0);
+                lowr1 = hrtfdb_spec(db, elevindexlow, angleindex1, 1);
+                lowl2 = hrtfdb_spec(db, elevindexlow, angleindex2, 0);
+                lowr2 = hrtfdb_spec(db, elevindexlow, angleindex2, 1);
+                highl1 = hrtfdb_spec(db, elevindexhigh, angleindex3, 0);
+                highr1 = hrtfdb_spec(db, elevindexhigh, angleindex3, 1);
+                highl2 = hrtfdb_spec(db, elevindexhigh, angleindex4, 0);
+                highr2 = hrtfdb_spec(db, elevindexhigh, angleindex4, 1);
 
                 /* woodworth process */
                 /* ITD formula, check which ear is relevant to calculate
@@ -25,6 +25,7 @@
 
 #include "csdl.h"
 #include <math.h>
+#include "specmac.h"
 
 /*
 ** Data structures holding the load/unload information
@@ -128,84 +129,17 @@ typedef struct {
 **                       (corresponds to the start of the partition after the
 **                        last filled partition)
 */
-static void multiply_fft_buffers(MYFLT *outBuf, MYFLT *ringBuf, MYFLT *IR_Data,
-                                 int32_t partSize, int nPartitions,
-                                 int32_t ringBuf_startPos)
+static inline void multiply_fft_buffers(MYFLT *outBuf, MYFLT *ringBuf,
+                                        MYFLT *IR_Data, int32_t partSize,
+                                        int nPartitions,
+                                        int32_t ringBuf_startPos)
 {
-    MYFLT   re, im, re1, re2, im1, im2;
-    MYFLT   *rbPtr, *irPtr, *outBufPtr, *outBufEndPm2, *rbEndP;
-
-    /* note: partSize must be at least 2 samples */
-    partSize <<= 1; /* locale partsize is twice the size of the partition size */
-             /* Finding the index of the last sample pair in the output buffer */
-    outBufEndPm2 = (MYFLT*) outBuf + (int32_t) (partSize - 2);
-                                                 /* The end of the ring buffer */
-    rbEndP = (MYFLT*) ringBuf + (int32_t) (partSize * nPartitions);
-    rbPtr = &(ringBuf[ringBuf_startPos]);    /* Initialize ring buffer pointer */
-    irPtr = IR_Data;                        /* Initialize impulse data pointer */
-    outBufPtr = outBuf;                    /* Initialize output buffer pointer */
-
-    /* clear output buffer to zero */
-    memset(outBuf, 0, sizeof(MYFLT)*partSize);
-
-    /*
-    ** Multiply FFTs for each partition and mix to output buffer
-    ** Note: IRs are stored in reverse partition order
-    */
-    do {
-      /* wrap ring buffer position */
-      if (rbPtr >= rbEndP)
-        rbPtr = ringBuf;
-      outBufPtr = outBuf;
-      *(outBufPtr++) +=
-        *(rbPtr++) * *(irPtr++); /* convolve DC - real part only */
-      *(outBufPtr++) +=
-        *(rbPtr++) * *(irPtr++); /* convolve Nyquist - real part only */
-      re1 = *(rbPtr++);
-      im1 = *(rbPtr++);
-      re2 = *(irPtr++);
-      im2 = *(irPtr++);
-
-      /*
-      ** Status:
-      ** outBuf + 2, ringBuf + 4, irBuf + 4
-      ** re = buf + 2, im = buf + 3
-      */
-
-      re = re1 * re2 - im1 * im2;
-      im = re1 * im2 + re2 * im1;
-      while (outBufPtr < outBufEndPm2) {
-        /* complex multiply */
-        re1 = rbPtr[0];
-        im1 = rbPtr[1];
-        re2 = irPtr[0];
-        im2 = irPtr[1];
-        outBufPtr[0] += re;
-        outBufPtr[1] += im;
-        re = re1 * re2 - im1 * im2;
-        im = re1 * im2 + re2 * im1;
-        re1 = rbPtr[2];
-        im1 = rbPtr[3];
-        re2 = irPtr[2];
-        im2 = irPtr[3];
-        outBufPtr[2] += re;
-        outBufPtr[3] += im;
-        re = re1 * re2 - im1 * im2;
-        im = re1 * im2 + re2 * im1;
-        outBufPtr += 4;
-        rbPtr += 4;
-        irPtr += 4;
-        /*
-        ** Status:
-        ** outBuf + 2 + 4n, ringBuf + 4 + 4n, irBuf + 4 + 4n
-        ** re = buf + 2 + 4n, im = buf + 3 + 4n
-        */
-      }
-      outBufPtr[0] += re;
-      outBufPtr[1] += im;
-
-    } while (--nPartitions);
+    /* DC and Nyquist are real, the rest is a complex multiply-accumulate,
+       vectorised where the compiler has SSE */
+    spectral_mac(outBuf, ringBuf, IR_Data, partSize, nPartitions,
+                 ringBuf_startPos);
 }
+
 static inline int32_t buf_bytes_alloc(int32_t partSize, int32_t nPartitions)
 {
     int32_t nSmps;
@@ -21,6 +21,8 @@
     02110-1301 USA
 */
 #include "OpcodeBase.hpp"
+#include <cstring>
+#include <deque>
 #include <map>
 #include <vector>
 
@@ -33,42 +35,86 @@ using namespace csound;
 //#define ENABLE_MIXER_KDEBUG
 
 /**
- * The mixer busses are laid out:
- * busses[csound][bus][channel][frame].
- * std::map<CSOUND *, std::map<size_t, std::vector< std::vector<MYFLT> > > >
- * *busses = 0;
+ * The busses and the send matrix of one Csound instance.
  *
- * The mixer send matrix is laid out:
- * matrix[csound][send][bus].
- * std::map<CSOUND *, std::map<size_t, std::map<size_t, MYFLT> > > *matrix = 0;
+ * Busses are carved out of slabs of SLAB_BUSSES busses, buss by
+ * channel by frame, each channel starting on a cache line; gains are
+ * nodes of a map keyed by send and buss. Neither ever moves once
+ * made, so an opcode resolves its pointers once at init and keeps
+ * them, even while a reinit on another thread makes new busses or
+ * sends. The lookups and MixerClear take the lock, as inits may run
+ * on -j worker threads.
  */
-
-/**
- * Creates the buss if it does not already exist.
- */
-static void createBuss(CSOUND *csound, size_t buss) {
-#ifdef ENABLE_MIXER_IDEBUG
-  csound->Message(csound, "createBuss: csound %p buss %d...\n", csound, buss);
-#endif
-  std::map<CSOUND *, std::map<size_t, std::vector<std::vector<MYFLT>>>>
-      *busses = 0;
-  csound::QueryGlobalPointer(csound, "busses", busses);
-  if ((*busses)[csound].find(buss) == (*busses)[csound].end()) {
-    size_t channels = csound->GetNchnls(csound);
-    size_t frames = csound->GetKsmps(csound);
-    (*busses)[csound][buss].resize(channels);
-    for (size_t channel = 0; channel < channels; channel++) {
-      (*busses)[csound][buss][channel].resize(frames);
+struct MixerBusses {
+  enum { SLAB_BUSSES = 16 };
+  std::map<size_t, MYFLT *> busses;
+  std::map<std::pair<size_t, size_t>, MYFLT> gains;
+  std::deque<std::vector<MYFLT> > slabs; // over-allocated for alignment
+  size_t slabUsed;            // busses taken from the last slab
+  size_t channels;
+  size_t stride;              // MYFLTs per channel, a whole cache line
+  void *mutex;
+  MixerBusses(void *mutex_)
+      : slabUsed(SLAB_BUSSES), channels(0), stride(0), mutex(mutex_) {}
+  /**
+   * Takes the shape of the busses from the orchestra, once it is
+   * known, that is when the first opcode is initialised.
+   */
+  void setup(CSOUND *csound) {
+    csound->LockMutex(mutex);
+    if (channels == 0) {
+      channels = csound->GetNchnls(csound);
+      stride = csound->GetKsmps(csound);
+      stride = (stride * sizeof(MYFLT) + 63) / 64 * (64 / sizeof(MYFLT));
     }
-#ifdef ENABLE_MIXER_IDEBUG
-    csound->Message(csound, "createBuss: created buss.\n");
-#endif
-  } else {
-#ifdef ENABLE_MIXER_IDEBUG
-    csound->Message(csound, "createBuss: buss already exists.\n");
-#endif
+    csound->UnlockMutex(mutex);
   }
-}
+  static MYFLT *aligned(std::vector<MYFLT> &slab) {
+    MYFLT *data = &slab.front();
+    return data + ((64 - ((uintptr_t)data & 63)) & 63) / sizeof(MYFLT);
+  }
+  /**
+   * First frame of a channel of a buss, making the buss if need be
+   * (init time only).
+   */
+  MYFLT *channel(CSOUND *csound, size_t number, size_t channel) {
+    size_t size = channels * stride;
+    csound->LockMutex(mutex);
+    std::map<size_t, MYFLT *>::iterator it = busses.find(number);
+    if (it == busses.end()) {
+      if (slabUsed == SLAB_BUSSES) {
+        slabs.push_back(std::vector<MYFLT>());
+        slabs.back().resize(SLAB_BUSSES * size + 64 / sizeof(MYFLT),
+                            FL(0.0));
+        slabUsed = 0;
+      }
+      MYFLT *data = aligned(slabs.back()) + slabUsed * size;
+      slabUsed++;
+      it = busses.insert(std::make_pair(number, data)).first;
+    }
+    MYFLT *data = it->second + channel * stride;
+    csound->UnlockMutex(mutex);
+    return data;
+  }
+  /**
+   * Gain of a send to a buss, making it if need be (init time only).
+   */
+  MYFLT *gain(CSOUND *csound, size_t send, size_t buss) {
+    csound->LockMutex(mutex);
+    MYFLT *data = &gains[std::make_pair(send, buss)];
+    csound->UnlockMutex(mutex);
+    return data;
+  }
+  void clear(CSOUND *csound) {
+    csound->LockMutex(mutex);
+    for (std::deque<std::vector<MYFLT> >::iterator it = slabs.begin();
+         it != slabs.end(); ++it) {
+      std::memset(aligned(*it), 0,
+                  SLAB_BUSSES * channels * stride * sizeof(MYFLT));
+    }
+    csound->UnlockMutex(mutex);
+  }
+};
 
 /**
  * MixerSetLevel isend, ibuss, kgain
@@ -84,28 +130,31 @@ struct MixerSetLevel : public OpcodeBase<MixerSetLevel> {
   // State.
   size_t send;
   size_t buss;
-  std::map<CSOUND *, std::map<size_t, std::map<size_t, MYFLT>>> *matrix;
+  MixerBusses *busses;
+  MYFLT *gainpointer;
   int init(CSOUND *csound) {
 #ifdef ENABLE_MIXER_IDEBUG
     warn(csound, "MixerSetLevel::init...\n");
 #endif
-    csound::QueryGlobalPointer(csound, "matrix", matrix);
-    send = static_cast<size_t>(*isend);
+    csound::QueryGlobalPointer(csound, "busses", busses);
+    busses->setup(csound);
     buss = static_cast<size_t>(*ibuss);
-    createBuss(csound, buss);
-    (*matrix)[csound][send][buss] = *kgain;
+    send = static_cast<size_t>(*isend);
+    gainpointer = busses->gain(csound, send, buss);
+    *gainpointer = *kgain;
 #ifdef ENABLE_MIXER_IDEBUG
     warn(csound, "MixerSetLevel::init: csound %p send %d buss %d gain %f\n",
-         csound, send, buss, (*matrix)[csound][send][buss]);
+         csound, send, buss, *gainpointer);
 #endif
     return OK;
   }
   int kontrol(CSOUND *csound) {
-    (*matrix)[csound][send][buss] = *kgain;
+    IGN(csound);
+    *gainpointer = *kgain;
 #ifdef ENABLE_MIXER_KDEBUG
     warn(csound, "MixerSetLevel::kontrol: csound %p send %d buss "
                  "%d gain %f\n",
-         csound, send, buss, (*matrix)[csound][send][buss]);
+         csound, send, buss, *gainpointer);
 #endif
     return OK;
   }
@@ -125,26 +174,31 @@ struct MixerGetLevel : public OpcodeBase<MixerGetLevel> {
   // State.
   size_t send;
   size_t buss;
-  std::map<CSOUND *, std::map<size_t, std::map<size_t, MYFLT>>> *matrix;
+  MixerBusses *busses;
+  MYFLT *gainpointer;
   int init(CSOUND *csound) {
 #ifdef ENABLE_MIXER_IDEBUG
     warn(csound, "MixerGetLevel::init...\n");
 #endif
-    csound::QueryGlobalPointer(csound, "matrix", matrix);
-    send = static_cast<size_t>(*isend);
+    csound::QueryGlobalPointer(csound, "busses", busses);
+    busses->setup(csound);
     buss = static_cast<size_t>(*ibuss);
-    createBuss(csound, buss);
+    send = static_cast<size_t>(*isend);
+    gainpointer = busses->gain(csound, send, buss);
     return OK;
   }
   int noteoff(CSOUND *) { return OK; }
   int kontrol(CSOUND *csound) {
 #ifdef ENABLE_MIXER_KDEBUG
     warn(csound, "MixerGetLevel::kontrol...\n");
+#else
+    IGN(csound);
 #endif
-    *kgain = (*matrix)[csound][send][buss];
+    *kgain = *gainpointer;
     return OK;
   }
 };
+
 /**
  * MixerSend asignal, isend, ibus, ichannel
  *
@@ -164,20 +218,24 @@ struct MixerSend : public OpcodeBase<MixerSend> {
   size_t channel;
   size_t frames;
   MYFLT *busspointer;
-  std::map<CSOUND *, std::map<size_t, std::vector<std::vector<MYFLT>>>> *busses;
-  std::map<CSOUND *, std::map<size_t, std::map<size_t, MYFLT>>> *matrix;
+  MYFLT *gainpointer;
+  MixerBusses *busses;
   int init(CSOUND *csound) {
 #ifdef ENABLE_MIXER_IDEBUG
     warn(csound, "MixerSend::init...\n");
 #endif
     csound::QueryGlobalPointer(csound, "busses", busses);
-    csound::QueryGlobalPointer(csound, "matrix", matrix);
-    send = static_cast<size_t>(*isend);
-    buss = static_cast<size_t>(*ibuss);
-    createBuss(csound, buss);
+    busses->setup(csound);
     channel = static_cast<size_t>(*ichannel);
+    if (UNLIKELY(channel >= busses->channels)) {
+      return csound->InitError(csound, Str("MixerSend: no channel %d"),
+                               (int)channel);
+    }
+    buss = static_cast<size_t>(*ibuss);
+    send = static_cast<size_t>(*isend);
     frames = opds.insdshead->ksmps;
-    busspointer = &(*busses)[csound][buss][channel].front();
+    busspointer = busses->channel(csound, buss, channel);
+    gainpointer = busses->gain(csound, send, buss);
 #ifdef ENABLE_MIXER_IDEBUG
     warn(csound, "MixerSend::init: instance %p send %d buss "
                  "%d channel %d frames %d busspointer %p\n",
@@ -189,10 +247,14 @@ struct MixerSend : public OpcodeBase<MixerSend> {
   int audio(CSOUND *csound) {
 #ifdef ENABLE_MIXER_KDEBUG
     warn(csound, "MixerSend::audio...\n");
+#else
+    IGN(csound);
 #endif
-    MYFLT gain = (*matrix)[csound][send][buss];
+    MYFLT gain = *gainpointer;
+    MYFLT *__restrict out = busspointer;
+    const MYFLT *__restrict in = ainput;
     for (size_t i = 0; i < frames; i++) {
-      busspointer[i] += (ainput[i] * gain);
+      out[i] += in[i] * gain;
     }
 #ifdef ENABLE_MIXER_KDEBUG
     warn(csound, "MixerSend::audio: instance %d send %d buss "
@@ -221,17 +283,21 @@ struct MixerReceive : public OpcodeBase<MixerReceive> {
   size_t channel;
   size_t frames;
   MYFLT *busspointer;
-  std::map<CSOUND *, std::map<size_t, std::vector<std::vector<MYFLT>>>> *busses;
+  MixerBusses *busses;
   int init(CSOUND *csound) {
     csound::QueryGlobalPointer(csound, "busses", busses);
-    buss = static_cast<size_t>(*ibuss);
+    busses->setup(csound);
     channel = static_cast<size_t>(*ichannel);
+    if (UNLIKELY(channel >= busses->channels)) {
+      return csound->InitError(csound, Str("MixerReceive: no channel %d"),
+                               (int)channel);
+    }
+    buss = static_cast<size_t>(*ibuss);
     frames = opds.insdshead->ksmps;
-    createBuss(csound, buss);
 #ifdef ENABLE_MIXER_IDEBUG
     warn(csound, "MixerReceive::init...\n");
 #endif
-    busspointer = &(*busses)[csound][buss][channel].front();
+    busspointer = busses->channel(csound, buss, channel);
 #ifdef ENABLE_MIXER_IDEBUG
     warn(csound, "MixerReceive::init csound %p buss %d channel "
                  "%d frames %d busspointer %p\n",
@@ -246,9 +312,7 @@ struct MixerReceive : public OpcodeBase<MixerReceive> {
 #else
     IGN(csound);
 #endif
-    for (size_t i = 0; i < frames; i++) {
-      aoutput[i] = busspointer[i];
-    }
+    std::memcpy(aoutput, busspointer, frames * sizeof(MYFLT));
 #ifdef ENABLE_MIXER_KDEBUG
     warn(csound, "MixerReceive::audio aoutput %p busspointer %p\n", aoutput,
          buss);
@@ -268,31 +332,18 @@ struct MixerClear : public OpcodeBase<MixerClear> {
   // No output.
   // No input.
   // State.
-  std::map<CSOUND *, std::map<size_t, std::vector<std::vector<MYFLT>>>> *busses;
+  MixerBusses *busses;
   int init(CSOUND *csound) {
     csound::QueryGlobalPointer(csound, "busses", busses);
+    busses->setup(csound);
     return OK;
   }
   int audio(CSOUND *csound) {
 #ifdef ENABLE_MIXER_KDEBUG
-    warn(csound, "MixerClear::audio...\n")
-#endif
-        for (std::map<size_t, std::vector<std::vector<MYFLT>>>::iterator busi =
-                 (*busses)[csound].begin();
-             busi != (*busses)[csound].end(); ++busi) {
-      for (std::vector<std::vector<MYFLT>>::iterator channeli =
-               busi->second.begin();
-           channeli != busi->second.end(); ++channeli) {
-        for (std::vector<MYFLT>::iterator framei = (*channeli).begin();
-             framei != (*channeli).end(); ++framei) {
-          *framei = 0;
-        }
-      }
-    }
-#ifdef ENABLE_MIXER_KDEBUG
-    warn(csound, "MixerClear::audio\n")
+    warn(csound, "MixerClear::audio...\n");
 #endif
-        return OK;
+    busses->clear(csound);
+    return OK;
   }
 };
 
@@ -316,14 +367,8 @@ static OENTRY localops[] = {
     {NULL, 0, 0, 0, NULL, NULL, (SUBR)NULL, (SUBR)NULL, (SUBR)NULL}};
 
 PUBLIC int csoundModuleCreate_mixer(CSOUND *csound) {
-  std::map<CSOUND *, std::map<size_t, std::vector<std::vector<MYFLT>>>>
-      *busses = 0;
-  busses =
-      new std::map<CSOUND *, std::map<size_t, std::vector<std::vector<MYFLT>>>>;
+  MixerBusses *busses = new MixerBusses(csound->Create_Mutex(0));
   csound::CreateGlobalPointer(csound, "busses", busses);
-  std::map<CSOUND *, std::map<size_t, std::map<size_t, MYFLT>>> *matrix = 0;
-  matrix = new std::map<CSOUND *, std::map<size_t, std::map<size_t, MYFLT>>>;
-  csound::CreateGlobalPointer(csound, "matrix", matrix);
   return OK;
 }
 
@@ -343,48 +388,20 @@ PUBLIC int csoundModuleInit_mixer(CSOUND *csound) {
 }
 
 /*
- * The mixer busses are laid out:
- * busses[csound][bus][channel][frame].
- * std::map<CSOUND *, std::map<size_t,
- *          std::vector< std::vector<MYFLT> > > > *busses = 0;
- * The mixer send matrix is laid out:
- * matrix[csound][send][bus].
- * std::map<CSOUND *, std::map<size_t, std::map<size_t, MYFLT> > > *matrix = 0;
+ * The mixer busses are laid out in slabs of MixerBusses::SLAB_BUSSES:
+ * slab[(buss * channels + channel) * stride + frame],
+ * and the mixer send matrix is a map from send and buss to gain,
+ * both held by the MixerBusses of each Csound instance.
  */
 PUBLIC int csoundModuleDestroy_mixer(CSOUND *csound) {
-  std::map<CSOUND *, std::map<size_t, std::vector<std::vector<MYFLT>>>>
-      *busses = 0;
+  MixerBusses *busses = 0;
   csound::QueryGlobalPointer(csound, "busses", busses);
   if (busses) {
-    for (std::map<size_t, std::vector<std::vector<MYFLT>>>::iterator busi =
-             (*busses)[csound].begin();
-         busi != (*busses)[csound].end(); ++busi) {
-      for (std::vector<std::vector<MYFLT>>::iterator channeli =
-               busi->second.begin();
-           channeli != busi->second.end(); ++channeli) {
-        channeli->resize(0);
-      }
-      busi->second.clear();
-    }
-    busses->clear();
     csound->DestroyGlobalVariable(csound, "busses");
+    csound->DestroyMutex(busses->mutex);
     delete busses;
     busses = nullptr;
   }
-  std::map<CSOUND *, std::map<size_t, std::map<size_t, MYFLT>>> *matrix = 0;
-  csound::QueryGlobalPointer(csound, "matrix", matrix);
-  if (matrix) {
-    // std::map<CSOUND *, std::map<size_t, std::map<size_t, MYFLT> > >
-    for (std::map<size_t, std::map<size_t, MYFLT>>::iterator matrixi =
-             (*matrix)[csound].begin();
-         matrixi != (*matrix)[csound].end(); ++matrixi) {
-      matrixi->second.clear();
-    }
-    matrix->clear();
-    csound->DestroyGlobalVariable(csound, "matrix");
-    delete matrix;
-    matrix = nullptr;
-  }
   return OK;
 }
 
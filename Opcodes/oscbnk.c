@@ -2586,7 +2586,7 @@ static int32_t rbjeq(CSOUND *csound, RBJEQ *p)
 
 static const OENTRY localops[] =
   {
-   { "oscbnk",     sizeof(OSCBNK),     TR, 3,  "a",  "kkkkiikkkkikkkkkkikooooooo",
+   { "oscbnk",     sizeof(OSCBNK),     TB, 3,  "a",  "kkkkiikkkkikkkkkkikooooooo",
      (SUBR) oscbnkset, (SUBR) oscbnk                },
    { "grain2",     sizeof(GRAIN2),     TR, 3,      "a",    "kkkikiooo",
             (SUBR) grain2set, (SUBR) grain2                },
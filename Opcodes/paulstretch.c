@@ -59,6 +59,7 @@ typedef struct {
     AUXCH m_hinv_buf;
     AUXCH m_output;
     AUXCH m_tmp;
+    void *fwdsetup, *invsetup;
 } PAULSTRETCH;
 
 static void compute_block(CSOUND *csound, PAULSTRETCH *p)
@@ -82,10 +83,10 @@ static void compute_block(CSOUND *csound, PAULSTRETCH *p)
         tmp[i] = FL(0.0);
       }
     }
-    /* re-order bins and take FFT */
+    /* take FFT and move the Nyquist bin to the end */
+    csound->RealFFT2(csound, p->fwdsetup, tmp);
     tmp[p->windowsize] = tmp[1];
-    tmp[p->windowsize + 1] = FL(0.0);
-    csoundRealFFTnp2(csound, tmp, p->windowsize);
+    tmp[1] = tmp[p->windowsize + 1] = FL(0.0);
 
     /* randomize phase */
     for (i = 0; i < windowsize + 2; i += 2) {
@@ -106,7 +107,7 @@ static void compute_block(CSOUND *csound, PAULSTRETCH *p)
 
     /* re-order bins and take inverse FFT */
     tmp[1] = tmp[p->windowsize];
-    csoundInverseRealFFTnp2(csound, tmp, p->windowsize);
+    csound->RealFFT2(csound, p->invsetup, tmp);
 
     /* apply window and overlap */
     for (i = 0; i < windowsize; i++) {
@@ -134,6 +135,8 @@ static int32_t ps_init(CSOUND* csound, PAULSTRETCH *p)
     if (p->windowsize < 16) {
       p->windowsize = 16;
     }
+    /* the real FFT needs an even size */
+    p->windowsize &= ~1U;
     p->half_windowsize = p->windowsize / 2;
     p->displace_pos = (p->windowsize * FL(0.5)) / *p->stretch;
 
@@ -155,6 +158,9 @@ static int32_t ps_init(CSOUND* csound, PAULSTRETCH *p)
     csound->AuxAlloc(csound, size + 2 * sizeof(MYFLT), &p->m_tmp);
     p->tmp = p->m_tmp.auxp;
 
+    p->fwdsetup = csound->RealFFT2Setup(csound, p->windowsize, FFT_FWD);
+    p->invsetup = csound->RealFFT2Setup(csound, p->windowsize, FFT_INV);
+
     /* Create Hann window */
     for (i = 0; i < p->windowsize; i++) {
       p->window[i] = FL(0.5) - COS(i * TWOPI_F / (p->windowsize - 1)) * FL(0.5);
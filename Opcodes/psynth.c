@@ -65,6 +65,7 @@ PLUS a number of track processing opcodes.
 
 #include "pvs_ops.h"
 #include "pstream.h"
+#include "oscbank.h"
 
 typedef struct _psyn {
     OPDS    h;
@@ -75,6 +76,9 @@ typedef struct _psyn {
     FUNC    *func;
     AUXCH   sum, amps, freqs, phases, trackID;
     double   factor, facsqr, min;
+    OSCBANK *bank;          /* NULL: table lookup oscillators */
+    AUXCH   bankmem;
+    double  tabph;          /* phase of the table against a sine */
 } _PSYN;
 
 typedef struct _psyn2 {
@@ -86,8 +90,34 @@ typedef struct _psyn2 {
     FUNC    *func;
     AUXCH   sum, amps, freqs, phases, trackID;
     double   factor, facsqr, min;
+    OSCBANK *bank;          /* NULL: table lookup oscillators */
+    AUXCH   bankmem;
+    double  tabph;          /* phase of the table against a sine */
 } _PSYN2;
 
+/* The oscillator bank replaces the table lookup oscillators when the
+   table holds one cycle of a sine or a cosine, which is what these
+   opcodes ask for; any other table is still read point by point. */
+
+static OSCBANK *psynth_bank(CSOUND *csound, FUNC *ftp, AUXCH *mem,
+                            int32_t numbins, double *tabph)
+{
+    int32_t i, size = ftp->flen;
+    int32_t sine = 1, cosine = 1;
+
+    for (i = 0; i < size && (sine || cosine); i++) {
+      double x = TWOPI * i / size;
+      if (fabs(ftp->ftable[i] - sin(x)) > 1.0e-5)
+        sine = 0;
+      if (fabs(ftp->ftable[i] - cos(x)) > 1.0e-5)
+        cosine = 0;
+    }
+    if (!sine && !cosine)
+      return NULL;
+    *tabph = (sine ? 0.0 : PI * 0.5);
+    return oscbank_alloc(csound, mem, numbins);
+}
+
 static int32_t psynth_init(CSOUND *csound, _PSYN *p)
 {
     int32_t     numbins = p->fin->N / 2 + 1;
@@ -100,6 +130,7 @@ static int32_t psynth_init(CSOUND *csound, _PSYN *p)
     if (UNLIKELY(p->func == NULL)) {
       return csound->InitError(csound, Str("psynth: function table not found\n"));
     }
+    p->bank = psynth_bank(csound, p->func, &p->bankmem, numbins, &p->tabph);
 
     p->tracks = 0;
     p->hopsize = p->fin->overlap;
@@ -161,6 +192,7 @@ static int32_t psynth_process(CSOUND *csound, _PSYN *p)
     int32_t     *trackID = (int32_t *) p->trackID.auxp;
     int32_t     hopsize = p->hopsize;
     double  min = p->min;
+    OSCBANK *bank = p->bank;
     ratio = size * csound->onedsr;
     factor = p->factor;
 
@@ -217,18 +249,33 @@ static int32_t psynth_process(CSOUND *csound, _PSYN *p)
               f = freq;
               incra = (ampnext - amp) / hopsize;
               incrph = (freqnext - freq) / hopsize;
-              for (m = 0; m < hopsize; m++) {
-                /* table lookup oscillator */
-                phase += f * ratio;
-                while (phase < 0)
-                  phase += size;
-                while (phase >= size)
-                  phase -= size;
-                ndx = (int32_t) phase;
-                frac = phase - ndx;
-                outsum[m] += a * (tab[ndx] + (tab[ndx + 1] - tab[ndx]) * frac);
-                a += incra;
-                f += incrph;
+              if (bank != NULL) {
+                /* at sample m the phase, in table points, is
+                   phase + ratio * ((m + 1) * f + m * (m + 1) / 2 * incrph) */
+                double g = TWOPI / size;
+                oscbank_add(bank, (MYFLT) a, (MYFLT) incra,
+                            g * (phase + ratio * f) + p->tabph,
+                            g * ratio * (f + 0.5 * incrph),
+                            g * ratio * 0.5 * incrph, 0.0);
+                phase += ratio * (hopsize * f +
+                                  0.5 * hopsize * (hopsize - 1) * incrph);
+                phase -= size * floor(phase / size);
+              }
+              else {
+                for (m = 0; m < hopsize; m++) {
+                  /* table lookup oscillator */
+                  phase += f * ratio;
+                  while (phase < 0)
+                    phase += size;
+                  while (phase >= size)
+                    phase -= size;
+                  ndx = (int32_t) phase;
+                  frac = phase - ndx;
+                  outsum[m] +=
+                    a * (tab[ndx] + (tab[ndx + 1] - tab[ndx]) * frac);
+                  a += incra;
+                  f += incrph;
+                }
               }
             }
             /* keep amp, freq, and phase values for next time */
@@ -247,6 +294,8 @@ static int32_t psynth_process(CSOUND *csound, _PSYN *p)
           else
             break;
         }
+        if (bank != NULL)
+          oscbank_run(bank, outsum, hopsize);
         pos = 0;
         p->tracks = k;
       }
@@ -267,6 +316,7 @@ static int32_t psynth2_init(CSOUND *csound, _PSYN2 *p)
     if (UNLIKELY(p->func == NULL)) {
       return csound->InitError(csound, Str("psynth: function table not found\n"));
     }
+    p->bank = psynth_bank(csound, p->func, &p->bankmem, numbins, &p->tabph);
 
     p->tracks = 0;
     p->hopsize = p->fin->overlap;
@@ -330,6 +380,7 @@ static int32_t psynth2_process(CSOUND *csound, _PSYN2 *p)
     int32_t     *trackID = (int32_t *) p->trackID.auxp;
     int32_t     hopsize = p->hopsize;
     double  min = p->min;
+    OSCBANK *bank = p->bank;
 
     incrph = csound->onedsr;
     lotwopi = (double)(size) / TWOPI_F;
@@ -405,19 +456,27 @@ static int32_t psynth2_process(CSOUND *csound, _PSYN2 *p)
               ph = phase;
               cnt = 0;
               incra = (ampnext - amp) / hopsize;
-              for (m = 0; m < hopsize; m++) {
-                /* table lookup oscillator */
-                ph *= lotwopi;
-                while (ph < 0)
-                  ph += size;
-                while (ph >= size)
-                  ph -= size;
-                ndx = (int32_t) ph;
-                frac = ph - ndx;
-                outsum[m] += a * (tab[ndx] + (tab[ndx + 1] - tab[ndx]) * frac);
-                a += incra;
-                cnt += incrph;
-                ph = phase + cnt * (freq + cnt * (a2 + a3 * cnt));
+              if (bank != NULL)
+                /* cnt is m * incrph at sample m */
+                oscbank_add(bank, (MYFLT) a, (MYFLT) incra, phase + p->tabph,
+                            freq * incrph, a2 * incrph * incrph,
+                            a3 * incrph * incrph * incrph);
+              else {
+                for (m = 0; m < hopsize; m++) {
+                  /* table lookup oscillator */
+                  ph *= lotwopi;
+                  while (ph < 0)
+                    ph += size;
+                  while (ph >= size)
+                    ph -= size;
+                  ndx = (int32_t) ph;
+                  frac = ph - ndx;
+                  outsum[m] +=
+                    a * (tab[ndx] + (tab[ndx + 1] - tab[ndx]) * frac);
+                  a += incra;
+                  cnt += incrph;
+                  ph = phase + cnt * (freq + cnt * (a2 + a3 * cnt));
+                }
               }
             }
             /* keep amp, freq, and phase values for next time */
@@ -437,6 +496,8 @@ static int32_t psynth2_process(CSOUND *csound, _PSYN2 *p)
             break;
 
         }
+        if (bank != NULL)
+          oscbank_run(bank, outsum, hopsize);
         pos = 0;
         p->tracks = k;
       }
@@ -471,6 +532,7 @@ static int32_t psynth3_process(CSOUND *csound, _PSYN *p)
     int32_t     *trackID = (int32_t *) p->trackID.auxp;
     int32_t     hopsize = p->hopsize;
     double  min = p->min;
+    OSCBANK *bank = p->bank;
 
     incrph = csound->onedsr;
     lotwopi = (double) (size) / TWOPI_F;
@@ -542,19 +604,27 @@ static int32_t psynth3_process(CSOUND *csound, _PSYN *p)
               ph = phase;
               cnt = 0;
               incra = (ampnext - amp) / hopsize;
-              for (m = 0; m < hopsize; m++) {
-                /* table lookup oscillator */
-                ph *= lotwopi;
-                while (ph < 0)
-                  ph += size;
-                while (ph >= size)
-                  ph -= size;
-                ndx = (int32_t) ph;
-                frac = ph - ndx;
-                outsum[m] += a * (tab[ndx] + (tab[ndx + 1] - tab[ndx]) * frac);
-                a += incra;
-                cnt += incrph;
-                ph = phase + cnt * (freq + cnt * (a2 + a3 * cnt));
+              if (bank != NULL)
+                /* cnt is m * incrph at sample m */
+                oscbank_add(bank, (MYFLT) a, (MYFLT) incra, phase + p->tabph,
+                            freq * incrph, a2 * incrph * incrph,
+                            a3 * incrph * incrph * incrph);
+              else {
+                for (m = 0; m < hopsize; m++) {
+                  /* table lookup oscillator */
+                  ph *= lotwopi;
+                  while (ph < 0)
+                    ph += size;
+                  while (ph >= size)
+                    ph -= size;
+                  ndx = (int32_t) ph;
+                  frac = ph - ndx;
+                  outsum[m] +=
+                    a * (tab[ndx] + (tab[ndx + 1] - tab[ndx]) * frac);
+                  a += incra;
+                  cnt += incrph;
+                  ph = phase + cnt * (freq + cnt * (a2 + a3 * cnt));
+                }
               }
             }
             /* keep amp, freq, and phase values for next time */
@@ -577,6 +647,8 @@ static int32_t psynth3_process(CSOUND *csound, _PSYN *p)
           else
             break;
         }
+        if (bank != NULL)
+          oscbank_run(bank, outsum, hopsize);
         pos = 0;
         p->tracks = k;
 
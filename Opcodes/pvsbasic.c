@@ -1405,8 +1405,11 @@ static int32_t pvsscaleset(CSOUND *csound, PVSSCALE *p)
       p->fenv.size < sizeof(MYFLT) * (N+2))
     csound->AuxAlloc(csound, sizeof(MYFLT) * (N + 2), &p->fenv);
   memset(p->fenv.auxp, 0, sizeof(MYFLT)*(N+2));
-  p->fwdsetup = csound->RealFFT2Setup(csound, N/2, FFT_FWD);
-  p->invsetup = csound->RealFFT2Setup(csound, N/2, FFT_INV);
+  /* the cepstrum is N/2 points, rounded up to the even size the
+     real FFT needs */
+  tmp = N/2 + (N/2)%2;
+  p->fwdsetup = csound->RealFFT2Setup(csound, tmp, FFT_FWD);
+  p->invsetup = csound->RealFFT2Setup(csound, tmp, FFT_INV);
   return OK;
 }
 
@@ -1521,15 +1524,10 @@ static int32_t pvsscale(CSOUND *csound, PVSSCALE *p)
           for (i=0; i < N/2; i++) {
             ceps[i] = fenv[i];
           }
-          if (!(N & (N - 1)))
-            csound->RealFFT2(csound, p->fwdsetup, ceps);
-          else
-            csound->RealFFTnp2(csound, ceps, tmp);
+          for (; i < tmp; i++) ceps[i] = 0.0;
+          csound->RealFFT2(csound, p->fwdsetup, ceps);
           for (i=coefs; i < N/2; i++) ceps[i] = 0.0;
-          if (!(N & (N - 1)))
-            csound->RealFFT2(csound, p->invsetup, ceps);
-          else
-            csound->InverseRealFFTnp2(csound, ceps, tmp);
+          csound->RealFFT2(csound, p->invsetup, ceps);
           for (i=j=0; i < N/2; i++, j+=2) {
             if (keepform > 1) {
               if (fenv[i] < ceps[i])
@@ -2625,7 +2623,7 @@ static OENTRY localops[] = {
    (SUBR) pvsfilter},
   {"pvsblur", sizeof(PVSBLUR),0, 3, "f", "fki", (SUBR) pvsblurset, (SUBR) pvsblur,
    NULL},
-  {"pvstencil", sizeof(PVSTENCIL), TR, 3, "f", "fkki", (SUBR) pvstencilset,
+  {"pvstencil", sizeof(PVSTENCIL), TB, 3, "f", "fkki", (SUBR) pvstencilset,
    (SUBR) pvstencil},
   {"pvsinit", sizeof(PVSINI),0, 1, "f", "ioopo", (SUBR) pvsinit, NULL, NULL},
   {"pvsbin", sizeof(PVSBIN),0, 3, "ss", "fk", (SUBR) pvsbinset,
@@ -2644,7 +2642,7 @@ static OENTRY localops[] = {
    (SUBR) pvstanalset, (SUBR) pvstanal, NULL},
   {"pvswarp", sizeof(PVSWARP),0, 3, "f", "fkkOPPO",
    (SUBR) pvswarpset, (SUBR) pvswarp},
-  {"pvsenvftw", sizeof(PVSENVW),0, 3, "k", "fkPPO",
+  {"pvsenvftw", sizeof(PVSENVW),TW, 3, "k", "fkPPO",
    (SUBR) pvsenvwset, (SUBR) pvsenvw},
   {"pvsgain", sizeof(PVSGAIN), 0,3, "f", "fk",
    (SUBR) pvsgainset, (SUBR) pvsgain, NULL},
@@ -64,6 +64,8 @@ struct _instrType {
         char *name;
         BYTE splits_num;
         splitType *split;
+        int32_t sfnum;          /* index of the owning bank */
+        BYTE loaded;            /* splits have been built */
 } PACKED;
 typedef struct _instrType instrType;
 
@@ -91,6 +93,8 @@ struct _presetType {
         WORD bank;
         int32_t layers_num;
         layerType *layer;
+        int32_t sfnum;          /* index of the owning bank */
+        BYTE loaded;            /* layers have been built */
 } PACKED;
 typedef struct _presetType presetType;
 
@@ -125,6 +129,8 @@ struct _SFBANK {
         instrType *instr;
         SHORT *sampleData;
         CHUNKS chunk;
+        void *map;              /* file mapping holding main_chunk, or NULL */
+        size_t maplen;
 } PACKED;
 typedef struct _SFBANK SFBANK;
 
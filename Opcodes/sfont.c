@@ -39,20 +39,29 @@
 #include <errno.h>
 #include "sfenum.h"
 #include "sfont.h"
+#if !defined(WIN32) && !defined(__wasi__)
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  define SF_USE_MMAP
+#endif
 
 #define s2d(x)  *((DWORD *) (x))
 
 
 
 static int32_t chunk_read(CSOUND *, FILE *f, CHUNK *chunk);
+static int32_t chunk_map(CSOUND *, FILE *f, SFBANK *sf);
+static void chunk_unmap(CSOUND *, SFBANK *sf);
 static void fill_SfPointers(CSOUND *);
 static int32_t  fill_SfStruct(CSOUND *);
+static void free_preset_layers(CSOUND *, presetType *preset);
 static void layerDefaults(layerType *layer);
 static void splitDefaults(splitType *split);
 
 #define MAX_SFONT               (10)
 #define MAX_SFPRESET            (16384)
 #define GLOBAL_ATTENUATION      (FL(0.3))
+#define UNUSE                   0x7fffffff
 
 #define ONETWELTH               (0.08333333333333333333333333333)
 #define TWOTOTWELTH             (1.05946309435929526456182529495)
@@ -67,6 +76,9 @@ typedef struct _sfontg {
   MYFLT pitches[128];
 } sfontg;
 
+static int32_t sf_preset_load(CSOUND *, sfontg *, presetType *);
+static int32_t sf_instr_load(CSOUND *, sfontg *, instrType *);
+
 int32_t sfont_ModuleDestroy(CSOUND *csound)
 {
     int32_t j,k,l;
@@ -78,17 +90,17 @@ int32_t sfont_ModuleDestroy(CSOUND *csound)
 
     for (j=0; j<globals->currSFndx; j++) {
       for (k=0; k< sfArray[j].presets_num; k++) {
-        for (l=0; l<sfArray[j].preset[k].layers_num; l++) {
-          csound->Free(csound, sfArray[j].preset[k].layer[l].split);
-        }
-        csound->Free(csound, sfArray[j].preset[k].layer);
+        free_preset_layers(csound, &sfArray[j].preset[k]);
       }
       csound->Free(csound, sfArray[j].preset);
       for (l=0; l< sfArray[j].instrs_num; l++) {
         csound->Free(csound, sfArray[j].instr[l].split);
       }
       csound->Free(csound, sfArray[j].instr);
-      csound->Free(csound, sfArray[j].chunk.main_chunk.ckDATA);
+      if (sfArray[j].map != NULL)
+        chunk_unmap(csound, &sfArray[j]);
+      else
+        csound->Free(csound, sfArray[j].chunk.main_chunk.ckDATA);
     }
     csound->Free(csound, sfArray);
     globals->currSFndx = 0;
@@ -128,7 +140,10 @@ static int SoundFontLoad(CSOUND *csound, char *fname)
     /* } */
     strNcpy(soundFont->name, csound->GetFileName(fd), 256);
     //soundFont->name[255]='\0';
-    if (UNLIKELY(chunk_read(csound, fil, &soundFont->chunk.main_chunk)<0))
+    soundFont->map = NULL;
+    soundFont->maplen = 0;
+    if (chunk_map(csound, fil, soundFont) != OK &&
+        UNLIKELY(chunk_read(csound, fil, &soundFont->chunk.main_chunk)<0))
       csound->Message(csound, Str("sfont: failed to read file\n"));
     csound->FileClose(csound, fd);
     globals->soundFont = soundFont;
@@ -149,8 +164,6 @@ static int32_t compare(presetType * elem1, presetType *elem2)
         ihandle SfLoad "filename"
 */
 
-static char *Gfname;            /* NOT THREAD SAFE */
-
 static int32_t SfLoad_(CSOUND *csound, SFLOAD *p, int32_t istring)
                                        /* open a file and return its handle */
 {                                      /* the handle is simply a stack index */
@@ -171,7 +184,6 @@ static int32_t SfLoad_(CSOUND *csound, SFLOAD *p, int32_t istring)
                                 0);
     }
     /*    strcpy(fname, (char*) p->fname); */
-    Gfname = fname;
     hand = SoundFontLoad(csound, fname);
     if (hand<0) {
       *p->ihandle = (MYFLT) globals->currSFndx;
@@ -354,6 +366,9 @@ static int32_t SfPlay_set(CSOUND *csound, SFPLAY *p)
       return csound->InitError(csound, Str("sfplay: invalid or "
                                            "out-of-range preset number"));
     }
+    if (UNLIKELY(sf_preset_load(csound, globals, preset) != OK))
+      return csound->InitError(csound, Str("sfplay: cannot load preset %d"),
+                               (int32_t) index);
     layersNum = preset->layers_num;
     for (j =0; j < layersNum; j++) {
       layerType *layer = &preset->layer[j];
@@ -692,6 +707,9 @@ static int32_t SfPlayMono_set(CSOUND *csound, SFPLAYMONO *p)
       return csound->InitError(csound, Str("sfplaym: invalid or "
                                            "out-of-range preset number"));
     }
+    if (UNLIKELY(sf_preset_load(csound, globals, preset) != OK))
+      return csound->InitError(csound, Str("sfplaym: cannot load preset %d"),
+                               (int32_t) index);
     layersNum= preset->layers_num;
     for (j =0; j < layersNum; j++) {
       layerType *layer = &preset->layer[j];
@@ -956,6 +974,11 @@ static int32_t SfInstrPlay_set(CSOUND *csound, SFIPLAY *p)
     if (UNLIKELY(*p->instrNum >  sf->instrs_num)) {
       return csound->InitError(csound, Str("sfinstr: instrument out of range"));
     }
+    else if (UNLIKELY(sf_instr_load(csound, globals,
+                                    &sf->instr[(int32_t) *p->instrNum]) != OK)) {
+      return csound->InitError(csound, Str("sfinstr: cannot load instrument %d"),
+                               (int32_t) *p->instrNum);
+    }
     else {
       instrType *layer = &sf->instr[(int32_t) *p->instrNum];
       SHORT *sBase = sf->sampleData;
@@ -1229,6 +1252,11 @@ static int32_t SfInstrPlayMono_set(CSOUND *csound, SFIPLAYMONO *p)
     if (UNLIKELY( *p->instrNum >  sf->instrs_num)) {
       return csound->InitError(csound, Str("sfinstr: instrument out of range"));
     }
+    else if (UNLIKELY(sf_instr_load(csound, globals,
+                                    &sf->instr[(int32_t) *p->instrNum]) != OK)) {
+      return csound->InitError(csound, Str("sfinstr: cannot load instrument %d"),
+                               (int32_t) *p->instrNum);
+    }
     else {
       instrType *layer = &sf->instr[(int32_t) *p->instrNum];
       SHORT *sBase = sf->sampleData;
@@ -1519,37 +1547,25 @@ static void ChangeByteOrder(char *fmt, char *p, int32 size)
 #define ChangeByteOrder(fmt, p, size) /* nothing */
 #endif
 
+/* sfload only indexes the presets and instruments of a bank; the layers
+   and splits of each one are built from the pdta chunk by
+   fill_SfPreset() and fill_SfInstr() the first time it is played. */
 static int32_t fill_SfStruct(CSOUND *csound)
 {
-    int32_t j, k, i, l, m, size, iStart, iEnd, kk, ll, mStart, mEnd;
-    int32_t pbag_num,first_pbag,layer_num;
-    int32_t ibag_num,first_ibag,split_num;
+    int32_t j, size;
     CHUNK *phdrChunk;
     presetType *preset;
+    instrType *instru;
     sfPresetHeader *phdr;
-    sfPresetBag *pbag;
-    sfGenList *pgen;
     sfInst *inst;
-    sfInstBag *ibag;
-/*  sfInstModList *imod; */
-    sfInstGenList *igen;
-    sfSample *shdr;
     SFBANK *soundFont;
     sfontg *globals;
     globals = (sfontg *) (csound->QueryGlobalVariable(csound, "::sfontg"));
     soundFont = globals->soundFont;
 
-
-/*  imod = soundFont->chunk.imod; */
-    igen = soundFont->chunk.igen;
-    shdr = soundFont->chunk.shdr;
-
     phdrChunk= soundFont->chunk.phdrChunk;
     phdr = soundFont->chunk.phdr;
-    pbag = soundFont->chunk.pbag;
-    pgen = soundFont->chunk.pgen;
     inst = soundFont->chunk.inst;
-    ibag = soundFont->chunk.ibag;
 
     size = phdrChunk->ckSize / sizeof(sfPresetHeader);
     soundFont->presets_num = size;
@@ -1558,461 +1574,520 @@ static int32_t fill_SfStruct(CSOUND *csound)
       preset[j].name = phdr[j].achPresetName;
       if (strcmp(preset[j].name,"EOP")==0) {
         soundFont->presets_num = j;
-        goto end_fill_presets;
+        break;
       }
       preset[j].num = j;
       preset[j].prog = phdr[j].wPreset;
       preset[j].bank = phdr[j].wBank;
-      first_pbag = phdr[j].wPresetBagNdx;
-      pbag_num = phdr[j+1].wPresetBagNdx - first_pbag;
-      layer_num = 0;
-      for  (k = 0 ; k < pbag_num ; k++) {
-        iStart = pbag[k+first_pbag].wGenNdx;
-        iEnd = pbag[k+first_pbag+1].wGenNdx;
-        for (i = iStart; i < iEnd; i++) {
-          if (pgen[i].sfGenOper == instrument ) {
-            layer_num++;
-          }
-        }
+      preset[j].sfnum = globals->currSFndx;
+      preset[j].loaded = 0;
+      preset[j].layers_num = 0;
+      preset[j].layer = NULL;
+    }
+    soundFont->preset = preset;
+
+    size = soundFont->chunk.instChunk->ckSize / sizeof(sfInst);
+    soundFont->instrs_num = size;
+    instru = (instrType *) csound->Malloc(csound, size * sizeof(instrType));
+    for (j=0; j < size; j++) {
+      instru[j].name = inst[j].achInstName;
+      if (strcmp(instru[j].name,"EOI")==0) {
+        soundFont->instrs_num = j;
+        break;
       }
-      preset[j].layers_num = layer_num;
-      preset[j].layer =
-        (layerType *) csound->Malloc(csound, layer_num * sizeof(layerType));
-      for (k=0; k <layer_num; k++) {
-        layerDefaults(&preset[j].layer[k]);
+      instru[j].num = j;
+      instru[j].sfnum = globals->currSFndx;
+      instru[j].loaded = 0;
+      instru[j].splits_num = 0;
+      instru[j].split = NULL;
+    }
+    soundFont->instr = instru;
+    return OK;
+}
+
+static void free_preset_layers(CSOUND *csound, presetType *preset)
+{
+    int32_t l;
+    for (l=0; l<preset->layers_num; l++)
+      csound->Free(csound, preset->layer[l].split);
+    csound->Free(csound, preset->layer);
+    preset->layer = NULL;
+    preset->layers_num = 0;
+}
+
+static int32_t fill_SfPreset(CSOUND *csound, SFBANK *sf, presetType *preset)
+{
+    int32_t j = preset->num, k, i, l, m, iStart, iEnd, kk, ll, mStart, mEnd;
+    int32_t pbag_num,first_pbag,layer_num;
+    int32_t ibag_num,first_ibag,split_num;
+    sfPresetHeader *phdr = sf->chunk.phdr;
+    sfPresetBag *pbag = sf->chunk.pbag;
+    sfGenList *pgen = sf->chunk.pgen;
+    sfInst *inst = sf->chunk.inst;
+    sfInstBag *ibag = sf->chunk.ibag;
+    sfInstGenList *igen = sf->chunk.igen;
+    sfSample *shdr = sf->chunk.shdr;
+
+    first_pbag = phdr[j].wPresetBagNdx;
+    pbag_num = phdr[j + 1].wPresetBagNdx - first_pbag;
+    layer_num = 0;
+    for  (k = 0 ; k < pbag_num ; k++) {
+      iStart = pbag[k+first_pbag].wGenNdx;
+      iEnd = pbag[k+first_pbag+1].wGenNdx;
+      for (i = iStart; i < iEnd; i++) {
+        if (pgen[i].sfGenOper == instrument ) {
+          layer_num++;
+        }
       }
-      for  (k = 0, kk=0; k < pbag_num ; k++) {
-        iStart = pbag[k+first_pbag].wGenNdx;
-        iEnd = pbag[k+first_pbag+1].wGenNdx;
-        for (i = iStart; i < iEnd; i++) {
-          layerType *layer;
-          layer = &preset[j].layer[kk];
-          switch (pgen[i].sfGenOper) {
-          case instrument:
-            {
-#define UNUSE 0x7fffffff
-              int32_t GsampleModes=UNUSE, GcoarseTune=UNUSE, GfineTune=UNUSE;
-              int32_t Gpan=UNUSE, GinitialAttenuation=UNUSE,GscaleTuning=UNUSE;
-              int32_t GoverridingRootKey = UNUSE;
-
-              layer->num  = pgen[i].genAmount.wAmount;
-              layer->name = inst[layer->num].achInstName;
-              first_ibag = inst[layer->num].wInstBagNdx;
-              ibag_num = inst[layer->num +1].wInstBagNdx - first_ibag;
-              split_num = 0;
-              for (l=0; l < ibag_num; l++) {
-                mStart = ibag[l+first_ibag].wInstGenNdx;
-                mEnd = ibag[l+first_ibag+1].wInstGenNdx;
-                for (m=mStart; m < mEnd; m++) {
-                  if (igen[m].sfGenOper == sampleID) {
-                    split_num++;
-                  }
+    }
+    preset->layers_num = layer_num;
+    preset->layer =
+      (layerType *) csound->Malloc(csound, layer_num * sizeof(layerType));
+    for (k=0; k <layer_num; k++) {
+      layerDefaults(&preset->layer[k]);
+    }
+    for  (k = 0, kk=0; k < pbag_num ; k++) {
+      iStart = pbag[k+first_pbag].wGenNdx;
+      iEnd = pbag[k+first_pbag+1].wGenNdx;
+      for (i = iStart; i < iEnd; i++) {
+        layerType *layer;
+        layer = &preset->layer[kk];
+        switch (pgen[i].sfGenOper) {
+        case instrument:
+          {
+            int32_t GsampleModes=UNUSE, GcoarseTune=UNUSE, GfineTune=UNUSE;
+            int32_t Gpan=UNUSE, GinitialAttenuation=UNUSE,GscaleTuning=UNUSE;
+            int32_t GoverridingRootKey = UNUSE;
+
+            layer->num  = pgen[i].genAmount.wAmount;
+            layer->name = inst[layer->num].achInstName;
+            first_ibag = inst[layer->num].wInstBagNdx;
+            ibag_num = inst[layer->num +1].wInstBagNdx - first_ibag;
+            split_num = 0;
+            for (l=0; l < ibag_num; l++) {
+              mStart = ibag[l+first_ibag].wInstGenNdx;
+              mEnd = ibag[l+first_ibag+1].wInstGenNdx;
+              for (m=mStart; m < mEnd; m++) {
+                if (igen[m].sfGenOper == sampleID) {
+                  split_num++;
                 }
               }
-              layer->splits_num = split_num;
-              layer->split =
-                (splitType *) csound->Malloc(csound, split_num * sizeof(splitType));
-              for (l=0; l<split_num; l++) {
-                splitDefaults(&layer->split[l]);
-              }
-              for (l=0, ll=0; l < ibag_num; l++) {
-                int32_t sglobal_zone = 1;
-                mStart = ibag[l+first_ibag].wInstGenNdx;
-                mEnd = ibag[l+first_ibag+1].wInstGenNdx;
+            }
+            layer->splits_num = split_num;
+            layer->split =
+              (splitType *) csound->Malloc(csound, split_num * sizeof(splitType));
+            for (l=0; l<split_num; l++) {
+              splitDefaults(&layer->split[l]);
+            }
+            for (l=0, ll=0; l < ibag_num; l++) {
+              int32_t sglobal_zone = 1;
+              mStart = ibag[l+first_ibag].wInstGenNdx;
+              mEnd = ibag[l+first_ibag+1].wInstGenNdx;
 
+              for (m=mStart; m < mEnd; m++) {
+                if (igen[m].sfGenOper == sampleID) sglobal_zone=0;
+              }
+              if (sglobal_zone) {
                 for (m=mStart; m < mEnd; m++) {
-                  if (igen[m].sfGenOper == sampleID) sglobal_zone=0;
-                }
-                if (sglobal_zone) {
-                  for (m=mStart; m < mEnd; m++) {
-                    switch (igen[m].sfGenOper) {
-                    case sampleID:
-                      break;
-                    case overridingRootKey:
-                      GoverridingRootKey = igen[m].genAmount.wAmount;
-                      break;
-                    case coarseTune:
-                      GcoarseTune =  igen[m].genAmount.shAmount;
-                      break;
-                    case fineTune:
-                      GfineTune = igen[m].genAmount.shAmount;
-                      break;
-                    case scaleTuning:
-                      GscaleTuning = igen[m].genAmount.shAmount;
-                      break;
-                    case pan:
-                      Gpan = igen[m].genAmount.shAmount;
-                      break;
-                    case sampleModes:
-                      GsampleModes =  igen[m].genAmount.wAmount;
-                      break;
-                    case initialAttenuation:
-                      GinitialAttenuation = igen[m].genAmount.shAmount;
-                      break;
-                    case keyRange:
-                      break;
-                    case velRange:
-                      break;
-                    }
+                  switch (igen[m].sfGenOper) {
+                  case sampleID:
+                    break;
+                  case overridingRootKey:
+                    GoverridingRootKey = igen[m].genAmount.wAmount;
+                    break;
+                  case coarseTune:
+                    GcoarseTune =  igen[m].genAmount.shAmount;
+                    break;
+                  case fineTune:
+                    GfineTune = igen[m].genAmount.shAmount;
+                    break;
+                  case scaleTuning:
+                    GscaleTuning = igen[m].genAmount.shAmount;
+                    break;
+                  case pan:
+                    Gpan = igen[m].genAmount.shAmount;
+                    break;
+                  case sampleModes:
+                    GsampleModes =  igen[m].genAmount.wAmount;
+                    break;
+                  case initialAttenuation:
+                    GinitialAttenuation = igen[m].genAmount.shAmount;
+                    break;
+                  case keyRange:
+                    break;
+                  case velRange:
+                    break;
                   }
                 }
-                else {
-                  splitType *split;
-                  split = &layer->split[ll];
-                  split->attack = split->decay = split->sustain =
-                    split->release = FL(0.0);
-                  if (GoverridingRootKey != UNUSE)
-                    split->overridingRootKey = (BYTE) GoverridingRootKey;
-                  if (GcoarseTune != UNUSE)
-                    split->coarseTune = (BYTE) GcoarseTune;
-                  if (GfineTune != UNUSE)
-                    split->fineTune = (BYTE) GfineTune;
-                  if (GscaleTuning != UNUSE)
-                    split->scaleTuning = (BYTE) GscaleTuning;
-                  if (Gpan != UNUSE)
-                    split->pan = (BYTE) Gpan;
-                  if (GsampleModes != UNUSE)
-                    split->sampleModes = (BYTE) GsampleModes;
-                  if (GinitialAttenuation != UNUSE)
-                    split->initialAttenuation = (BYTE) GinitialAttenuation;
-
-                  for (m=mStart; m < mEnd; m++) {
-                    switch (igen[m].sfGenOper) {
-                    case sampleID:
-                      {
-                        int32_t num = igen[m].genAmount.wAmount;
-                        split->num= num;
-                        split->sample = &shdr[num];
-                        if (UNLIKELY(split->sample->sfSampleType & 0x8000)) {
-                          csound->Free(csound, preset);
-                          csound->ErrorMsg(csound, Str("SoundFont file \"%s\" "
-                                                       "contains ROM samples !\n"
-                                                       "At present time only RAM "
-                                                       "samples are allowed "
-                                                       "by sfload.\n"
-                                                       "Session aborted !"),
-                                           Gfname);
-                            return NOTOK;
-                        }
-                        sglobal_zone = 0;
-                        ll++;
+              }
+              else {
+                splitType *split;
+                split = &layer->split[ll];
+                split->attack = split->decay = split->sustain =
+                  split->release = FL(0.0);
+                if (GoverridingRootKey != UNUSE)
+                  split->overridingRootKey = (BYTE) GoverridingRootKey;
+                if (GcoarseTune != UNUSE)
+                  split->coarseTune = (BYTE) GcoarseTune;
+                if (GfineTune != UNUSE)
+                  split->fineTune = (BYTE) GfineTune;
+                if (GscaleTuning != UNUSE)
+                  split->scaleTuning = (BYTE) GscaleTuning;
+                if (Gpan != UNUSE)
+                  split->pan = (BYTE) Gpan;
+                if (GsampleModes != UNUSE)
+                  split->sampleModes = (BYTE) GsampleModes;
+                if (GinitialAttenuation != UNUSE)
+                  split->initialAttenuation = (BYTE) GinitialAttenuation;
+
+                for (m=mStart; m < mEnd; m++) {
+                  switch (igen[m].sfGenOper) {
+                  case sampleID:
+                    {
+                      int32_t num = igen[m].genAmount.wAmount;
+                      split->num= num;
+                      split->sample = &shdr[num];
+                      if (UNLIKELY(split->sample->sfSampleType & 0x8000)) {
+                        csound->ErrorMsg(csound, Str("SoundFont file \"%s\" "
+                                                     "contains ROM samples !\n"
+                                                     "At present time only RAM "
+                                                     "samples are allowed "
+                                                     "by sfload.\n"
+                                                     "Session aborted !"),
+                                         sf->name);
+                        free_preset_layers(csound, preset);
+                        return NOTOK;
                       }
-                      break;
-                    case overridingRootKey:
-                      split->overridingRootKey = (BYTE) igen[m].genAmount.wAmount;
-                      break;
-                    case coarseTune:
-                      split->coarseTune = (char) igen[m].genAmount.shAmount;
-                      break;
-                    case fineTune:
-                      split->fineTune = (char) igen[m].genAmount.shAmount;
-                      break;
-                    case scaleTuning:
-                      split->scaleTuning = igen[m].genAmount.shAmount;
-                      break;
-                    case pan:
-                      split->pan = igen[m].genAmount.shAmount;
-                      break;
-                    case sampleModes:
-                      split->sampleModes = (BYTE) igen[m].genAmount.wAmount;
-                      break;
-                    case initialAttenuation:
-                      split->initialAttenuation = igen[m].genAmount.shAmount;
-                      break;
-                    case keyRange:
-                      split->minNoteRange = igen[m].genAmount.ranges.byLo;
-                      split->maxNoteRange = igen[m].genAmount.ranges.byHi;
-                      break;
-                    case velRange:
-                      split->minVelRange = igen[m].genAmount.ranges.byLo;
-                      split->maxVelRange = igen[m].genAmount.ranges.byHi;
-                      break;
-                    case startAddrsOffset:
-                      split->startOffset += igen[m].genAmount.shAmount;
-                      break;
-                    case endAddrsOffset:
-                      split->endOffset += igen[m].genAmount.shAmount;
-                      break;
-                    case startloopAddrsOffset:
-                      split->startLoopOffset += igen[m].genAmount.shAmount;
-                      break;
-                    case endloopAddrsOffset:
-                      split->endLoopOffset += igen[m].genAmount.shAmount;
-                      break;
-                    case startAddrsCoarseOffset:
-                      split->startOffset += igen[m].genAmount.shAmount * 32768;
-                      break;
-                    case endAddrsCoarseOffset:
-                      split->endOffset += igen[m].genAmount.shAmount * 32768;
-                      break;
-                    case startloopAddrCoarseOffset:
-                      split->startLoopOffset += igen[m].genAmount.shAmount * 32768;
-                      break;
-                    case endloopAddrsCoarseOffset:
-                      split->endLoopOffset += igen[m].genAmount.shAmount * 32768;
-                      break;
-                    case delayVolEnv:
-                      csound->Message(csound, "del: %f\n",
-                                      (double) igen[m].genAmount.shAmount);
-                      break;
-                    case attackVolEnv:           /*attack */
-                      split->attack = POWER(FL(2.0),
-                                            igen[m].genAmount.shAmount/FL(1200.0));
-                      /* csound->Message(csound, "att: %f\n", split->attack ); */
-                      break;
-                      /* case holdVolEnv: */             /*hold   35 */
-                    case decayVolEnv:            /*decay */
-                      split->decay = POWER(FL(2.0),
+                      sglobal_zone = 0;
+                      ll++;
+                    }
+                    break;
+                  case overridingRootKey:
+                    split->overridingRootKey = (BYTE) igen[m].genAmount.wAmount;
+                    break;
+                  case coarseTune:
+                    split->coarseTune = (char) igen[m].genAmount.shAmount;
+                    break;
+                  case fineTune:
+                    split->fineTune = (char) igen[m].genAmount.shAmount;
+                    break;
+                  case scaleTuning:
+                    split->scaleTuning = igen[m].genAmount.shAmount;
+                    break;
+                  case pan:
+                    split->pan = igen[m].genAmount.shAmount;
+                    break;
+                  case sampleModes:
+                    split->sampleModes = (BYTE) igen[m].genAmount.wAmount;
+                    break;
+                  case initialAttenuation:
+                    split->initialAttenuation = igen[m].genAmount.shAmount;
+                    break;
+                  case keyRange:
+                    split->minNoteRange = igen[m].genAmount.ranges.byLo;
+                    split->maxNoteRange = igen[m].genAmount.ranges.byHi;
+                    break;
+                  case velRange:
+                    split->minVelRange = igen[m].genAmount.ranges.byLo;
+                    split->maxVelRange = igen[m].genAmount.ranges.byHi;
+                    break;
+                  case startAddrsOffset:
+                    split->startOffset += igen[m].genAmount.shAmount;
+                    break;
+                  case endAddrsOffset:
+                    split->endOffset += igen[m].genAmount.shAmount;
+                    break;
+                  case startloopAddrsOffset:
+                    split->startLoopOffset += igen[m].genAmount.shAmount;
+                    break;
+                  case endloopAddrsOffset:
+                    split->endLoopOffset += igen[m].genAmount.shAmount;
+                    break;
+                  case startAddrsCoarseOffset:
+                    split->startOffset += igen[m].genAmount.shAmount * 32768;
+                    break;
+                  case endAddrsCoarseOffset:
+                    split->endOffset += igen[m].genAmount.shAmount * 32768;
+                    break;
+                  case startloopAddrCoarseOffset:
+                    split->startLoopOffset += igen[m].genAmount.shAmount * 32768;
+                    break;
+                  case endloopAddrsCoarseOffset:
+                    split->endLoopOffset += igen[m].genAmount.shAmount * 32768;
+                    break;
+                  case delayVolEnv:
+                    csound->Message(csound, "del: %f\n",
+                                    (double) igen[m].genAmount.shAmount);
+                    break;
+                  case attackVolEnv:           /*attack */
+                    split->attack = POWER(FL(2.0),
+                                          igen[m].genAmount.shAmount/FL(1200.0));
+                    /* csound->Message(csound, "att: %f\n", split->attack ); */
+                    break;
+                    /* case holdVolEnv: */             /*hold   35 */
+                  case decayVolEnv:            /*decay */
+                    split->decay = POWER(FL(2.0),
+                                         igen[m].genAmount.shAmount/FL(1200.0));
+                    /* csound->Message(csound, "dec: %f\n", split->decay); */
+                    break;
+                  case sustainVolEnv:          /*sustain */
+                    split->sustain = POWER(FL(10.0),
+                                           -igen[m].genAmount.shAmount/FL(20.0));
+                    /* csound->Message(csound, "sus: %f\n", split->sustain); */
+                    break;
+                  case releaseVolEnv:          /*release */
+                    split->release = POWER(FL(2.0),
                                            igen[m].genAmount.shAmount/FL(1200.0));
-                      /* csound->Message(csound, "dec: %f\n", split->decay); */
-                      break;
-                    case sustainVolEnv:          /*sustain */
-                      split->sustain = POWER(FL(10.0),
-                                             -igen[m].genAmount.shAmount/FL(20.0));
-                      /* csound->Message(csound, "sus: %f\n", split->sustain); */
-                      break;
-                    case releaseVolEnv:          /*release */
-                      split->release = POWER(FL(2.0),
-                                             igen[m].genAmount.shAmount/FL(1200.0));
-                      /* csound->Message(csound, "rel: %f\n", split->release); */
-                      break;
-                    case keynum:
-                      /*csound->Message(csound, "");*/
-                      break;
-                    case velocity:
-                      /*csound->Message(csound, "");*/
-                      break;
-                    case exclusiveClass:
-                      /*csound->Message(csound, "");*/
-                      break;
+                    /* csound->Message(csound, "rel: %f\n", split->release); */
+                    break;
+                  case keynum:
+                    /*csound->Message(csound, "");*/
+                    break;
+                  case velocity:
+                    /*csound->Message(csound, "");*/
+                    break;
+                  case exclusiveClass:
+                    /*csound->Message(csound, "");*/
+                    break;
 
-                    }
                   }
                 }
               }
-              kk++;
             }
+            kk++;
+          }
+          break;
+        case coarseTune:
+          layer->coarseTune = (char) pgen[i].genAmount.shAmount;
+          break;
+        case fineTune:
+          layer->fineTune = (char) pgen[i].genAmount.shAmount;
+          break;
+        case scaleTuning:
+          layer->scaleTuning = pgen[i].genAmount.shAmount;
+          break;
+        case initialAttenuation:
+          layer->initialAttenuation = pgen[i].genAmount.shAmount;
+          break;
+        case pan:
+          layer->pan = pgen[i].genAmount.shAmount;
+          break;
+        case keyRange:
+          layer->minNoteRange = pgen[i].genAmount.ranges.byLo;
+          layer->maxNoteRange = pgen[i].genAmount.ranges.byHi;
+          break;
+        case velRange:
+          layer->minVelRange = pgen[i].genAmount.ranges.byLo;
+          layer->maxVelRange = pgen[i].genAmount.ranges.byHi;
+          break;
+        }
+      }
+    }
+    preset->loaded = 1;
+    return OK;
+}
+
+static int32_t fill_SfInstr(CSOUND *csound, SFBANK *sf, instrType *instru)
+{
+    int32_t j = instru->num, l, m, ll, mStart, mEnd;
+    int32_t ibag_num,first_ibag,split_num;
+    int32_t GsampleModes=UNUSE, GcoarseTune=UNUSE, GfineTune=UNUSE;
+    int32_t Gpan=UNUSE, GinitialAttenuation=UNUSE,GscaleTuning=UNUSE;
+    int32_t GoverridingRootKey = UNUSE;
+    sfInst *inst = sf->chunk.inst;
+    sfInstBag *ibag = sf->chunk.ibag;
+    sfInstGenList *igen = sf->chunk.igen;
+    sfSample *shdr = sf->chunk.shdr;
+
+    first_ibag = inst[j].wInstBagNdx;
+    ibag_num = inst[j + 1].wInstBagNdx - first_ibag;
+    split_num=0;
+    for (l=0; l < ibag_num; l++) {
+      mStart =      ibag[l+first_ibag].wInstGenNdx;
+      mEnd = ibag[l+first_ibag+1].wInstGenNdx;
+      for (m=mStart; m < mEnd; m++) {
+        if (igen[m].sfGenOper == sampleID) {
+          split_num++;
+        }
+      }
+    }
+    instru->splits_num = split_num;
+    instru->split =
+      (splitType *) csound->Malloc(csound, split_num * sizeof(splitType));
+    for (l=0; l<split_num; l++) {
+      splitDefaults(&instru->split[l]);
+    }
+    for (l=0, ll=0; l < ibag_num; l++) {
+      int32_t sglobal_zone = 1;
+      mStart = ibag[l+first_ibag].wInstGenNdx;
+      mEnd = ibag[l+first_ibag+1].wInstGenNdx;
+
+      for (m=mStart; m < mEnd; m++) {
+        if (igen[m].sfGenOper == sampleID) sglobal_zone=0;
+      }
+      if (sglobal_zone) {
+        for (m=mStart; m < mEnd; m++) {
+          switch (igen[m].sfGenOper) {
+          case sampleID:
+            break;
+          case overridingRootKey:
+            GoverridingRootKey = igen[m].genAmount.wAmount;
             break;
           case coarseTune:
-            layer->coarseTune = (char) pgen[i].genAmount.shAmount;
+            GcoarseTune =  igen[m].genAmount.shAmount;
             break;
           case fineTune:
-            layer->fineTune = (char) pgen[i].genAmount.shAmount;
+            GfineTune = igen[m].genAmount.shAmount;
             break;
           case scaleTuning:
-            layer->scaleTuning = pgen[i].genAmount.shAmount;
-            break;
-          case initialAttenuation:
-            layer->initialAttenuation = pgen[i].genAmount.shAmount;
+            GscaleTuning = igen[m].genAmount.shAmount;
             break;
           case pan:
-            layer->pan = pgen[i].genAmount.shAmount;
+            Gpan = igen[m].genAmount.shAmount;
+            break;
+          case sampleModes:
+            GsampleModes =  igen[m].genAmount.wAmount;
+            break;
+          case initialAttenuation:
+            GinitialAttenuation = igen[m].genAmount.shAmount;
             break;
           case keyRange:
-            layer->minNoteRange = pgen[i].genAmount.ranges.byLo;
-            layer->maxNoteRange = pgen[i].genAmount.ranges.byHi;
             break;
           case velRange:
-            layer->minVelRange = pgen[i].genAmount.ranges.byLo;
-            layer->maxVelRange = pgen[i].genAmount.ranges.byHi;
             break;
           }
         }
       }
-    }
- end_fill_presets:
-    soundFont->preset = preset;
-/* fill layer list */
-    {
-      instrType *instru;
-      size = soundFont->chunk.instChunk->ckSize / sizeof(sfInst);
-      soundFont->instrs_num = size;
-      instru = (instrType *) csound->Malloc(csound, size * sizeof(layerType));
-      for (j=0; j < size; j++) {
-#define UNUSE 0x7fffffff
-        int32_t GsampleModes=UNUSE, GcoarseTune=UNUSE, GfineTune=UNUSE;
-        int32_t Gpan=UNUSE, GinitialAttenuation=UNUSE,GscaleTuning=UNUSE;
-        int32_t GoverridingRootKey = UNUSE;
-
-        instru[j].name = inst[j].achInstName;
-        if (strcmp(instru[j].name,"EOI")==0) {
-          soundFont->instrs_num = j;
-          goto end_fill_layers;
-        }
-        instru[j].num = j;
-        first_ibag = inst[j].wInstBagNdx;
-        ibag_num = inst[j+1].wInstBagNdx - first_ibag;
-        split_num=0;
-        for (l=0; l < ibag_num; l++) {
-          mStart =      ibag[l+first_ibag].wInstGenNdx;
-          mEnd = ibag[l+first_ibag+1].wInstGenNdx;
-          for (m=mStart; m < mEnd; m++) {
-            if (igen[m].sfGenOper == sampleID) {
-              split_num++;
-            }
-          }
-        }
-        instru[j].splits_num = split_num;
-        instru[j].split =
-          (splitType *) csound->Malloc(csound, split_num * sizeof(splitType));
-        for (l=0; l<split_num; l++) {
-          splitDefaults(&instru[j].split[l]);
-        }
-        for (l=0, ll=0; l < ibag_num; l++) {
-          int32_t sglobal_zone = 1;
-          mStart = ibag[l+first_ibag].wInstGenNdx;
-          mEnd = ibag[l+first_ibag+1].wInstGenNdx;
-
-          for (m=mStart; m < mEnd; m++) {
-            if (igen[m].sfGenOper == sampleID) sglobal_zone=0;
-          }
-          if (sglobal_zone) {
-            for (m=mStart; m < mEnd; m++) {
-              switch (igen[m].sfGenOper) {
-              case sampleID:
-                break;
-              case overridingRootKey:
-                GoverridingRootKey = igen[m].genAmount.wAmount;
-                break;
-              case coarseTune:
-                GcoarseTune =  igen[m].genAmount.shAmount;
-                break;
-              case fineTune:
-                GfineTune = igen[m].genAmount.shAmount;
-                break;
-              case scaleTuning:
-                GscaleTuning = igen[m].genAmount.shAmount;
-                break;
-              case pan:
-                Gpan = igen[m].genAmount.shAmount;
-                break;
-              case sampleModes:
-                GsampleModes =  igen[m].genAmount.wAmount;
-                break;
-              case initialAttenuation:
-                GinitialAttenuation = igen[m].genAmount.shAmount;
-                break;
-              case keyRange:
-                break;
-              case velRange:
-                break;
-              }
-            }
-          }
-          else {
-            splitType *split;
-            split = &instru[j].split[ll];
-            if (GoverridingRootKey != UNUSE)
-              split->overridingRootKey = (BYTE) GoverridingRootKey;
-            if (GcoarseTune != UNUSE)
-              split->coarseTune = (BYTE) GcoarseTune;
-            if (GfineTune != UNUSE)
-              split->fineTune = (BYTE) GfineTune;
-            if (GscaleTuning != UNUSE)
-              split->scaleTuning = (BYTE) GscaleTuning;
-            if (Gpan != UNUSE)
-              split->pan = (BYTE) Gpan;
-            if (GsampleModes != UNUSE)
-              split->sampleModes = (BYTE) GsampleModes;
-            if (GinitialAttenuation != UNUSE)
-              split->initialAttenuation = (BYTE) GinitialAttenuation;
-
-            for (m=mStart; m < mEnd; m++) {
-              switch (igen[m].sfGenOper) {
-              case sampleID:
-                {
-                  int32_t num = igen[m].genAmount.wAmount;
-                  split->num= num;
-                  split->sample = &shdr[num];
-                  if (UNLIKELY(split->sample->sfSampleType & 0x8000)) {
-                    csound->Free(csound, instru);
-                    csound->ErrorMsg(csound, Str("SoundFont file \"%s\" contains "
-                                            "ROM samples !\n"
-                                            "At present time only RAM samples "
-                                            "are allowed by sfload.\n"
-                                            "Session aborted !"), Gfname);
-                    return NOTOK;
-                  }
-                  sglobal_zone = 0;
-                  ll++;
-                }
-                break;
-              case overridingRootKey:
-                split->overridingRootKey = (BYTE) igen[m].genAmount.wAmount;
-                break;
-              case coarseTune:
-                split->coarseTune = (char) igen[m].genAmount.shAmount;
-                break;
-              case fineTune:
-                split->fineTune = (char) igen[m].genAmount.shAmount;
-                break;
-              case scaleTuning:
-                split->scaleTuning = igen[m].genAmount.shAmount;
-                break;
-              case pan:
-                split->pan = igen[m].genAmount.shAmount;
-                break;
-              case sampleModes:
-                split->sampleModes = (BYTE) igen[m].genAmount.wAmount;
-                break;
-              case initialAttenuation:
-                split->initialAttenuation = igen[m].genAmount.shAmount;
-                break;
-              case keyRange:
-                split->minNoteRange = igen[m].genAmount.ranges.byLo;
-                split->maxNoteRange = igen[m].genAmount.ranges.byHi;
-                break;
-              case velRange:
-                split->minVelRange = igen[m].genAmount.ranges.byLo;
-                split->maxVelRange = igen[m].genAmount.ranges.byHi;
-                break;
-              case startAddrsOffset:
-                split->startOffset += igen[m].genAmount.shAmount;
-                break;
-              case endAddrsOffset:
-                split->endOffset += igen[m].genAmount.shAmount;
-                break;
-              case startloopAddrsOffset:
-                split->startLoopOffset += igen[m].genAmount.shAmount;
-                break;
-              case endloopAddrsOffset:
-                split->endLoopOffset += igen[m].genAmount.shAmount;
-                break;
-              case startAddrsCoarseOffset:
-                split->startOffset += igen[m].genAmount.shAmount * 32768;
-                break;
-              case endAddrsCoarseOffset:
-                split->endOffset += igen[m].genAmount.shAmount * 32768;
-                break;
-              case startloopAddrCoarseOffset:
-                split->startLoopOffset += igen[m].genAmount.shAmount * 32768;
-                break;
-              case endloopAddrsCoarseOffset:
-                split->endLoopOffset += igen[m].genAmount.shAmount * 32768;
-                break;
-              case keynum:
-                /*csound->Message(csound, "");*/
-                break;
-              case velocity:
-                /*csound->Message(csound, "");*/
-                break;
-              case exclusiveClass:
-                /*csound->Message(csound, "");*/
-                break;
+      else {
+        splitType *split;
+        split = &instru->split[ll];
+        if (GoverridingRootKey != UNUSE)
+          split->overridingRootKey = (BYTE) GoverridingRootKey;
+        if (GcoarseTune != UNUSE)
+          split->coarseTune = (BYTE) GcoarseTune;
+        if (GfineTune != UNUSE)
+          split->fineTune = (BYTE) GfineTune;
+        if (GscaleTuning != UNUSE)
+          split->scaleTuning = (BYTE) GscaleTuning;
+        if (Gpan != UNUSE)
+          split->pan = (BYTE) Gpan;
+        if (GsampleModes != UNUSE)
+          split->sampleModes = (BYTE) GsampleModes;
+        if (GinitialAttenuation != UNUSE)
+          split->initialAttenuation = (BYTE) GinitialAttenuation;
+
+        for (m=mStart; m < mEnd; m++) {
+          switch (igen[m].sfGenOper) {
+          case sampleID:
+            {
+              int32_t num = igen[m].genAmount.wAmount;
+              split->num= num;
+              split->sample = &shdr[num];
+              if (UNLIKELY(split->sample->sfSampleType & 0x8000)) {
+                csound->ErrorMsg(csound, Str("SoundFont file \"%s\" contains "
+                                        "ROM samples !\n"
+                                        "At present time only RAM samples "
+                                        "are allowed by sfload.\n"
+                                        "Session aborted !"), sf->name);
+                csound->Free(csound, instru->split);
+                instru->split = NULL;
+                instru->splits_num = 0;
+                return NOTOK;
               }
+              sglobal_zone = 0;
+              ll++;
             }
+            break;
+          case overridingRootKey:
+            split->overridingRootKey = (BYTE) igen[m].genAmount.wAmount;
+            break;
+          case coarseTune:
+            split->coarseTune = (char) igen[m].genAmount.shAmount;
+            break;
+          case fineTune:
+            split->fineTune = (char) igen[m].genAmount.shAmount;
+            break;
+          case scaleTuning:
+            split->scaleTuning = igen[m].genAmount.shAmount;
+            break;
+          case pan:
+            split->pan = igen[m].genAmount.shAmount;
+            break;
+          case sampleModes:
+            split->sampleModes = (BYTE) igen[m].genAmount.wAmount;
+            break;
+          case initialAttenuation:
+            split->initialAttenuation = igen[m].genAmount.shAmount;
+            break;
+          case keyRange:
+            split->minNoteRange = igen[m].genAmount.ranges.byLo;
+            split->maxNoteRange = igen[m].genAmount.ranges.byHi;
+            break;
+          case velRange:
+            split->minVelRange = igen[m].genAmount.ranges.byLo;
+            split->maxVelRange = igen[m].genAmount.ranges.byHi;
+            break;
+          case startAddrsOffset:
+            split->startOffset += igen[m].genAmount.shAmount;
+            break;
+          case endAddrsOffset:
+            split->endOffset += igen[m].genAmount.shAmount;
+            break;
+          case startloopAddrsOffset:
+            split->startLoopOffset += igen[m].genAmount.shAmount;
+            break;
+          case endloopAddrsOffset:
+            split->endLoopOffset += igen[m].genAmount.shAmount;
+            break;
+          case startAddrsCoarseOffset:
+            split->startOffset += igen[m].genAmount.shAmount * 32768;
+            break;
+          case endAddrsCoarseOffset:
+            split->endOffset += igen[m].genAmount.shAmount * 32768;
+            break;
+          case startloopAddrCoarseOffset:
+            split->startLoopOffset += igen[m].genAmount.shAmount * 32768;
+            break;
+          case endloopAddrsCoarseOffset:
+            split->endLoopOffset += igen[m].genAmount.shAmount * 32768;
+            break;
+          case keynum:
+            /*csound->Message(csound, "");*/
+            break;
+          case velocity:
+            /*csound->Message(csound, "");*/
+            break;
+          case exclusiveClass:
+            /*csound->Message(csound, "");*/
+            break;
           }
         }
       }
-    end_fill_layers:
-      soundFont->instr = instru;
     }
+    instru->loaded = 1;
     return OK;
 }
 
+/* Build the layers of a preset, or the splits of an instrument, on
+   first use */
+static int32_t sf_preset_load(CSOUND *csound, sfontg *globals,
+                              presetType *preset)
+{
+    if (LIKELY(preset->loaded)) return OK;
+    return fill_SfPreset(csound, &globals->sfArray[preset->sfnum], preset);
+}
+
+static int32_t sf_instr_load(CSOUND *csound, sfontg *globals,
+                             instrType *instru)
+{
+    if (LIKELY(instru->loaded)) return OK;
+    return fill_SfInstr(csound, &globals->sfArray[instru->sfnum], instru);
+}
+
 static void layerDefaults(layerType *layer)
 {
     layer->splits_num         = 0;
+    layer->split              = NULL;
     layer->minNoteRange       = 0;
     layer->maxNoteRange       = 127;
     layer->minVelRange        = 0;
@@ -2060,6 +2135,60 @@ static int32_t chunk_read(CSOUND *csound, FILE *fil, CHUNK *chunk)
     return fread(chunk->ckDATA,1,chunk->ckSize,fil);
 }
 
+/* Map the whole file instead of reading the RIFF main chunk onto the
+   heap.  Nothing is read until a page is touched, and every instance
+   loading the same bank shares the pages through the page cache.
+   Returns NOTOK when the file cannot be mapped, and the caller falls
+   back on chunk_read(). */
+static int32_t chunk_map(CSOUND *csound, FILE *fil, SFBANK *sf)
+{
+#ifdef SF_USE_MMAP
+    CHUNK *chunk = &sf->chunk.main_chunk;
+    struct stat st;
+    BYTE *map;
+    DWORD size;
+    IGN(csound);
+    if (fstat(fileno(fil), &st) != 0 || st.st_size < 8 ||
+        (uint64_t) st.st_size > (uint64_t) ((size_t) -1))
+      return NOTOK;
+#ifdef WORDS_BIGENDIAN
+    /* ChangeByteOrder() swaps the chunks in place */
+    map = mmap(NULL, (size_t) st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE,
+               fileno(fil), 0);
+#else
+    map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED,
+               fileno(fil), 0);
+#endif
+    if (map == (BYTE *) MAP_FAILED)
+      return NOTOK;
+    memcpy(chunk->ckID, map, 4);
+    memcpy(&size, map + 4, 4);
+    ChangeByteOrder("d", (char *) &size, 4);
+    /* do not let a truncated file take fill_SfPointers past the end */
+    if ((uint64_t) size > (uint64_t) st.st_size - 8)
+      size = (DWORD) (st.st_size - 8);
+    chunk->ckSize = size;
+    chunk->ckDATA = map + 8;
+    sf->map = map;
+    sf->maplen = (size_t) st.st_size;
+    return OK;
+#else
+    IGN(csound); IGN(fil); IGN(sf);
+    return NOTOK;
+#endif
+}
+
+static void chunk_unmap(CSOUND *csound, SFBANK *sf)
+{
+    IGN(csound);
+#ifdef SF_USE_MMAP
+    munmap(sf->map, sf->maplen);
+#endif
+    sf->map = NULL;
+    sf->maplen = 0;
+    sf->chunk.main_chunk.ckDATA = NULL;
+}
+
 static DWORD dword(char *p)
 {
     union cheat {
@@ -2299,6 +2428,9 @@ static int32_t sflooper_init(CSOUND *csound, sflooper *p)
       return csound->InitError(csound, Str("sfplay: invalid or "
                                            "out-of-range preset number"));
     }
+    if (UNLIKELY(sf_preset_load(csound, globals, preset) != OK))
+      return csound->InitError(csound, Str("sfplay: cannot load preset %d"),
+                               (int32_t) index);
     layersNum = preset->layers_num;
     for (j =0; j < layersNum; j++) {
       layerType *layer = &preset->layer[j];
@@ -126,6 +126,7 @@
 #include "sysdep.h"
 #include "text.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
@@ -133,6 +134,7 @@
 #include <iostream>
 #include <map>
 #include <pstream.h>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -235,6 +237,32 @@ bool operator<(const EventBlock &a, const EventBlock &b) {
 // Identifiers are always "sourcename:outletname" and "sinkname:inletname",
 // or "sourcename:idname:outletname" and "sinkname:inletname."
 
+// The outlet instances feeding one inlet instance, flattened from the
+// connections whenever those or the instances change.  A route is never
+// modified once published: inlets read it at performance time without
+// taking a lock, and a replaced route is deleted only after the k-cycle
+// in which it was replaced, when no inlet can still be reading it.
+
+struct RouteBase {
+  uint64_t retired;
+  virtual ~RouteBase() {}
+};
+
+template <typename T> struct Route : public RouteBase {
+  std::vector<T *> sources;
+};
+
+// Instrument number of the "instrument:port" part of a port id, or 0.
+static int portInstrument(CSOUND *csound, const std::string &portId) {
+  std::string name = portId.substr(0, portId.find(':'));
+  char *end = 0;
+  long insno = std::strtol(name.c_str(), &end, 10);
+  if (!name.empty() && *end == 0)
+    return (int)insno;
+  insno = csound->strarg2insno(csound, (void *)name.c_str(), 1);
+  return insno > 0 ? (int)insno : 0;
+}
+
 struct SignalFlowGraphState {
   CSOUND *csound;
   void *signal_flow_ports_lock;
@@ -251,50 +279,152 @@ struct SignalFlowGraphState {
   std::map<std::string, std::vector<Inletkid *>> kidinletsForSinkInletIds;
   std::map<std::string, std::vector<std::string>> connections;
   std::map<EventBlock, int> functionTablesForEvtblks;
-  std::vector<std::vector<std::vector<Outleta *> *> *> aoutletVectors;
-  std::vector<std::vector<std::vector<Outletk *> *> *> koutletVectors;
-  std::vector<std::vector<std::vector<Outletf *> *> *> foutletVectors;
-  std::vector<std::vector<std::vector<Outletv *> *> *> voutletVectors;
-  std::vector<std::vector<std::vector<Outletkid *> *> *> kidoutletVectors;
+  std::set<RouteBase *> routes;
+  std::vector<RouteBase *> retiredRoutes;
   SignalFlowGraphState(CSOUND *csound_) {
     csound = csound_;
     signal_flow_ports_lock = csound->Create_Mutex(0);
     signal_flow_ftables_lock = csound->Create_Mutex(0);
   }
   ~SignalFlowGraphState() {}
+  /**
+   * Replaces the route of an inlet. The caller holds the ports lock.
+   */
+  template <typename T>
+  void publish(std::atomic<Route<T> *> &slot, Route<T> *route) {
+    uint64_t now = csound->GetKcounter(csound);
+    Route<T> *old = slot.exchange(route, std::memory_order_acq_rel);
+    routes.insert(route);
+    // An instance reused for a new note still holds its last route;
+    // anything else in the slot is not ours.
+    if (old != 0 && routes.erase(old) != 0) {
+      old->retired = now;
+      retiredRoutes.push_back(old);
+    }
+    for (size_t i = 0; i < retiredRoutes.size();) {
+      if (retiredRoutes[i]->retired < now) {
+        delete retiredRoutes[i];
+        retiredRoutes[i] = retiredRoutes.back();
+        retiredRoutes.pop_back();
+      } else {
+        i++;
+      }
+    }
+  }
+  /**
+   * Flattens the instances of every outlet connected to an inlet.
+   */
+  template <typename O, typename I>
+  void compile(I *inlet,
+               std::map<std::string, std::vector<O *>> &outletsForIds) {
+    Route<O> *route = new Route<O>;
+    std::vector<std::string> &sourceOutletIds =
+        connections[inlet->sinkInletId];
+    for (size_t i = 0, n = sourceOutletIds.size(); i < n; i++) {
+      // The same connection may have been made more than once.
+      if (std::find(sourceOutletIds.begin(), sourceOutletIds.begin() + i,
+                    sourceOutletIds[i]) != sourceOutletIds.begin() + i) {
+        continue;
+      }
+      std::vector<O *> &outlets = outletsForIds[sourceOutletIds[i]];
+      for (size_t j = 0, m = outlets.size(); j < m; j++) {
+        if (inlet->accepts(outlets[j])) {
+          route->sources.push_back(outlets[j]);
+        }
+      }
+    }
+    publish(inlet->route, route);
+  }
+  /**
+   * Recompiles the instances of one inlet.
+   */
+  template <typename O, typename I>
+  void recompileInlet(const std::string &sinkInletId,
+                      std::map<std::string, std::vector<I *>> &inletsForIds,
+                      std::map<std::string, std::vector<O *>> &outletsForIds) {
+    typename std::map<std::string, std::vector<I *>>::iterator inlets =
+        inletsForIds.find(sinkInletId);
+    if (inlets == inletsForIds.end()) {
+      return;
+    }
+    for (size_t i = 0, n = inlets->second.size(); i < n; i++) {
+      compile(inlets->second[i], outletsForIds);
+    }
+  }
+  /**
+   * Recompiles the inlets connected to an outlet whose instances changed.
+   */
+  template <typename O, typename I>
+  void recompileOutlet(const std::string &sourceOutletId,
+                       std::map<std::string, std::vector<I *>> &inletsForIds,
+                       std::map<std::string, std::vector<O *>> &outletsForIds) {
+    for (std::map<std::string, std::vector<std::string>>::iterator
+             it = connections.begin(),
+             end = connections.end();
+         it != end; ++it) {
+      if (std::find(it->second.begin(), it->second.end(), sourceOutletId) !=
+          it->second.end()) {
+        recompileInlet(it->first, inletsForIds, outletsForIds);
+      }
+    }
+  }
+  /**
+   * Connects an outlet to an inlet. The caller holds the ports lock.
+   */
+  void connect(const std::string &sourceOutletId,
+               const std::string &sinkInletId) {
+    connections[sinkInletId].push_back(sourceOutletId);
+    recompileInlet(sinkInletId, ainletsForSinkInletIds,
+                   aoutletsForSourceOutletIds);
+    recompileInlet(sinkInletId, kinletsForSinkInletIds,
+                   koutletsForSourceOutletIds);
+    recompileInlet(sinkInletId, finletsForSinkInletIds,
+                   foutletsForSourceOutletIds);
+    recompileInlet(sinkInletId, vinletsForSinkInletIds,
+                   voutletsForSourceOutletIds);
+    recompileInlet(sinkInletId, kidinletsForSinkInletIds,
+                   kidoutletsForSourceOutletIds);
+    // The parallel scheduler cannot see connections in the orchestra
+    // text: tell it that the two instruments must run in chain order.
+    int source = portInstrument(csound, sourceOutletId);
+    int sink = portInstrument(csound, sinkInletId);
+    if (source > 0 && sink > 0) {
+      csound->DagDependency(csound, source, sink);
+    }
+  }
   void clear() {
     LockGuard guard(csound, signal_flow_ports_lock);
 
-    for (std::vector<std::vector<std::vector<Outleta *> *> *>::iterator it = aoutletVectors.begin(), end = aoutletVectors.end(); it != end; it++)
-      delete *it;
-    for (std::vector<std::vector<std::vector<Outletk *> *> *>::iterator it = koutletVectors.begin(), end = koutletVectors.end(); it != end; it++)
+    for (std::set<RouteBase *>::iterator it = routes.begin(), end = routes.end(); it != end; it++)
       delete *it;
-    for (std::vector<std::vector<std::vector<Outletf *> *> *>::iterator it = foutletVectors.begin(), end = foutletVectors.end(); it != end; it++)
-      delete *it;
-    for (std::vector<std::vector<std::vector<Outletv *> *> *>::iterator it = voutletVectors.begin(), end = voutletVectors.end(); it != end; it++)
-      delete *it;
-    for (std::vector<std::vector<std::vector<Outletkid *> *> *>::iterator it = kidoutletVectors.begin(), end = kidoutletVectors.end(); it != end; it++)
+    for (std::vector<RouteBase *>::iterator it = retiredRoutes.begin(), end = retiredRoutes.end(); it != end; it++)
       delete *it;
 
     aoutletsForSourceOutletIds.clear();
     ainletsForSinkInletIds.clear();
-    aoutletVectors.clear();
     koutletsForSourceOutletIds.clear();
     kinletsForSinkInletIds.clear();
-    koutletVectors.clear();
     foutletsForSourceOutletIds.clear();
     voutletsForSourceOutletIds.clear();
     kidoutletsForSourceOutletIds.clear();
     vinletsForSinkInletIds.clear();
     kidinletsForSinkInletIds.clear();
     finletsForSinkInletIds.clear();
-    foutletVectors.clear();
-    voutletVectors.clear();
-    kidoutletVectors.clear();
+    routes.clear();
+    retiredRoutes.clear();
     connections.clear();
   }
 };
 
+// Adds one block into another; simple enough for the compiler to
+// vectorise.
+static inline void mixBlock(MYFLT *__restrict out, const MYFLT *__restrict in,
+                            size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] += in[i];
+  }
+}
+
 // For true thread-safety, access to shared data must be protected.
 // We will use one critical section for each logically independent
 // potential data race here: ports and ftables.
@@ -329,6 +459,9 @@ struct Outleta : public OpcodeNoteoffBase<Outleta> {
       aoutlets.push_back(this);
       warn(csound, Str("Created instance 0x%x of %d instances of outlet %s\n"),
            this, aoutlets.size(), sourceOutletId);
+      sfg_globals->recompileOutlet(sourceOutletId,
+                                   sfg_globals->ainletsForSinkInletIds,
+                                   sfg_globals->aoutletsForSourceOutletIds);
     }
     // warn(csound, "ENDED Outleta::init()...\n");
     return OK;
@@ -342,6 +475,9 @@ struct Outleta : public OpcodeNoteoffBase<Outleta> {
     aoutlets.erase(thisoutlet);
     warn(csound, Str("Removed instance 0x%x of %d instances of outleta %s\n"),
          this, aoutlets.size(), sourceOutletId);
+    sfg_globals->recompileOutlet(sourceOutletId,
+                                 sfg_globals->ainletsForSinkInletIds,
+                                 sfg_globals->aoutletsForSourceOutletIds);
     return OK;
   }
 };
@@ -359,26 +495,15 @@ struct Inleta : public OpcodeBase<Inleta> {
    * State.
    */
   char sinkInletId[0x100];
-  std::vector<std::vector<Outleta *> *> *sourceOutlets;
+  std::atomic<Route<Outleta> *> route;
   int sampleN;
   SignalFlowGraphState *sfg_globals;
+  bool accepts(const Outleta *) const { return true; }
   int init(CSOUND *csound) {
     csound::QueryGlobalPointer(csound, "sfg_globals", sfg_globals);
     LockGuard guard(csound, sfg_globals->signal_flow_ports_lock);
     warn(csound, "BEGAN Inleta::init()...\n");
     sampleN = opds.insdshead->ksmps;
-    warn(csound, "sourceOutlets: 0x%x\n", sourceOutlets);
-    // think problem is here
-    // should always create
-    if (std::find(sfg_globals->aoutletVectors.begin(),
-                  sfg_globals->aoutletVectors.end(),
-                  sourceOutlets) == sfg_globals->aoutletVectors.end()) {
-      sourceOutlets = new std::vector<std::vector<Outleta *> *>;
-      sfg_globals->aoutletVectors.push_back(sourceOutlets);
-    } else {
-      sourceOutlets->clear();
-    }
-    warn(csound, "sourceOutlets: 0x%x\n", sourceOutlets);
     sinkInletId[0] = 0;
     const char *insname =
         csound->GetInstrumentList(csound)[opds.insdshead->insno]->insname;
@@ -395,53 +520,29 @@ struct Inleta : public OpcodeBase<Inleta> {
       warn(csound, Str("Created instance 0x%x of inlet %s\n"), this,
            sinkInletId);
     }
-    // Find source outlets connecting to this.
+    // Flatten the instances of the source outlets connecting to this.
     // Any number of sources may connect to any number of sinks.
-    std::vector<std::string> &sourceOutletIds =
-        sfg_globals->connections[sinkInletId];
-    for (size_t i = 0, n = sourceOutletIds.size(); i < n; i++) {
-      const std::string &sourceOutletId = sourceOutletIds[i];
-      std::vector<Outleta *> &aoutlets =
-          sfg_globals->aoutletsForSourceOutletIds[sourceOutletId];
-      if (std::find(sourceOutlets->begin(), sourceOutlets->end(), &aoutlets) ==
-          sourceOutlets->end()) {
-        sourceOutlets->push_back(&aoutlets);
-        warn(csound, Str("Connected instances of outlet %s to instance 0x%x of "
-                         "inlet %s.\n"),
-             sourceOutletId.c_str(), this, sinkInletId);
-      }
-    }
+    sfg_globals->compile(this, sfg_globals->aoutletsForSourceOutletIds);
     warn(csound, "ENDED Inleta::init().\n");
     return OK;
   }
   /**
    * Sum arate values from active outlets feeding this inlet.
    */
-  int audio(CSOUND *csound) {
-    LockGuard guard(csound, sfg_globals->signal_flow_ports_lock);
-    // warn(csound, "BEGAN Inleta::audio()...\n");
+  int audio(CSOUND *) {
+    const Route<Outleta> *sources = route.load(std::memory_order_acquire);
     // Zero the inlet buffer.
     for (int sampleI = 0; sampleI < sampleN; sampleI++) {
       asignal[sampleI] = FL(0.0);
     }
-    // Loop over the source connections...
-    for (size_t sourceI = 0, sourceN = sourceOutlets->size(); sourceI < sourceN;
-         sourceI++) {
-      // Loop over the source connection instances...
-      std::vector<Outleta *> *instances = sourceOutlets->at(sourceI);
-      for (size_t instanceI = 0, instanceN = instances->size();
-           instanceI < instanceN; instanceI++) {
-        Outleta *sourceOutlet = instances->at(instanceI);
-        // Skip inactive instances.
-        if (sourceOutlet->opds.insdshead->actflg) {
-          for (int sampleI = 0, sampleN = ksmps(); sampleI < sampleN;
-               ++sampleI) {
-            asignal[sampleI] += sourceOutlet->asignal[sampleI];
-          }
-        }
+    // Loop over the source instances, skipping inactive ones.
+    for (size_t sourceI = 0, sourceN = sources->sources.size();
+         sourceI < sourceN; sourceI++) {
+      const Outleta *sourceOutlet = sources->sources[sourceI];
+      if (sourceOutlet->opds.insdshead->actflg) {
+        mixBlock(asignal, sourceOutlet->asignal, ksmps());
       }
     }
-    // warn(csound, "ENDED Inleta::audio().\n");
     return OK;
   }
 };
@@ -474,6 +575,9 @@ struct Outletk : public OpcodeNoteoffBase<Outletk> {
       koutlets.push_back(this);
       warn(csound, Str("Created instance 0x%x of %d instances of outlet %s\n"),
            this, koutlets.size(), sourceOutletId);
+      sfg_globals->recompileOutlet(sourceOutletId,
+                                   sfg_globals->kinletsForSinkInletIds,
+                                   sfg_globals->koutletsForSourceOutletIds);
     }
     return OK;
   }
@@ -486,6 +590,9 @@ struct Outletk : public OpcodeNoteoffBase<Outletk> {
     koutlets.erase(thisoutlet);
     warn(csound, Str("Removed 0x%x of %d instances of outletk %s\n"), this,
          koutlets.size(), sourceOutletId);
+    sfg_globals->recompileOutlet(sourceOutletId,
+                                 sfg_globals->kinletsForSinkInletIds,
+                                 sfg_globals->koutletsForSourceOutletIds);
     return OK;
   }
 };
@@ -503,21 +610,14 @@ struct Inletk : public OpcodeBase<Inletk> {
    * State.
    */
   char sinkInletId[0x100];
-  std::vector<std::vector<Outletk *> *> *sourceOutlets;
+  std::atomic<Route<Outletk> *> route;
   int ksmps;
   SignalFlowGraphState *sfg_globals;
+  bool accepts(const Outletk *) const { return true; }
   int init(CSOUND *csound) {
     csound::QueryGlobalPointer(csound, "sfg_globals", sfg_globals);
     LockGuard guard(csound, sfg_globals->signal_flow_ports_lock);
     ksmps = opds.insdshead->ksmps;
-    if (std::find(sfg_globals->koutletVectors.begin(),
-                  sfg_globals->koutletVectors.end(),
-                  sourceOutlets) == sfg_globals->koutletVectors.end()) {
-      sourceOutlets = new std::vector<std::vector<Outletk *> *>;
-      sfg_globals->koutletVectors.push_back(sourceOutlets);
-    } else {
-      sourceOutlets->clear();
-    }
     sinkInletId[0] = 0;
     const char *insname =
         csound->GetInstrumentList(csound)[opds.insdshead->insno]->insname;
@@ -534,45 +634,26 @@ struct Inletk : public OpcodeBase<Inletk> {
       warn(csound, Str("Created instance 0x%x of inlet %s\n"), this,
            sinkInletId);
     }
-    // Find source outlets connecting to this.
+    // Flatten the instances of the source outlets connecting to this.
     // Any number of sources may connect to any number of sinks.
-    std::vector<std::string> &sourceOutletIds =
-        sfg_globals->connections[sinkInletId];
-    for (size_t i = 0, n = sourceOutletIds.size(); i < n; i++) {
-      const std::string &sourceOutletId = sourceOutletIds[i];
-      std::vector<Outletk *> &koutlets =
-          sfg_globals->koutletsForSourceOutletIds[sourceOutletId];
-      if (std::find(sourceOutlets->begin(), sourceOutlets->end(), &koutlets) ==
-          sourceOutlets->end()) {
-        sourceOutlets->push_back(&koutlets);
-        warn(csound, Str("Connected instances of outlet %s to instance 0x%x"
-                         "of inlet %s.\n"),
-             sourceOutletId.c_str(), this, sinkInletId);
-      }
-    }
+    sfg_globals->compile(this, sfg_globals->koutletsForSourceOutletIds);
     return OK;
   }
   /**
    * Sum krate values from active outlets feeding this inlet.
    */
-  int kontrol(CSOUND *csound) {
-    LockGuard guard(csound, sfg_globals->signal_flow_ports_lock);
-    // Zero the inlet buffer.
-    *ksignal = FL(0.0);
-    // Loop over the source connections...
-    for (size_t sourceI = 0, sourceN = sourceOutlets->size(); sourceI < sourceN;
-         sourceI++) {
-      // Loop over the source connection instances...
-      const std::vector<Outletk *> *instances = sourceOutlets->at(sourceI);
-      for (size_t instanceI = 0, instanceN = instances->size();
-           instanceI < instanceN; instanceI++) {
-        const Outletk *sourceOutlet = instances->at(instanceI);
-        // Skip inactive instances.
-        if (sourceOutlet->opds.insdshead->actflg) {
-          *ksignal += *sourceOutlet->ksignal;
-        }
+  int kontrol(CSOUND *) {
+    const Route<Outletk> *sources = route.load(std::memory_order_acquire);
+    MYFLT sum = FL(0.0);
+    // Loop over the source instances, skipping inactive ones.
+    for (size_t sourceI = 0, sourceN = sources->sources.size();
+         sourceI < sourceN; sourceI++) {
+      const Outletk *sourceOutlet = sources->sources[sourceI];
+      if (sourceOutlet->opds.insdshead->actflg) {
+        sum += *sourceOutlet->ksignal;
       }
     }
+    *ksignal = sum;
     return OK;
   }
 };
@@ -605,10 +686,14 @@ struct Outletf : public OpcodeNoteoffBase<Outletf> {
       foutlets.push_back(this);
       warn(csound, Str("Created instance 0x%x of outlet %s\n"), this,
            sourceOutletId);
+      sfg_globals->recompileOutlet(sourceOutletId,
+                                   sfg_globals->finletsForSinkInletIds,
+                                   sfg_globals->foutletsForSourceOutletIds);
     }
     return OK;
   }
   int noteoff(CSOUND *csound) {
+    LockGuard guard(csound, sfg_globals->signal_flow_ports_lock);
     std::vector<Outletf *> &foutlets =
         sfg_globals->foutletsForSourceOutletIds[sourceOutletId];
     std::vector<Outletf *>::iterator thisoutlet =
@@ -616,6 +701,9 @@ struct Outletf : public OpcodeNoteoffBase<Outletf> {
     foutlets.erase(thisoutlet);
     warn(csound, Str("Removed 0x%x of %d instances of outletf %s\n"), this,
          foutlets.size(), sourceOutletId);
+    sfg_globals->recompileOutlet(sourceOutletId,
+                                 sfg_globals->finletsForSinkInletIds,
+                                 sfg_globals->foutletsForSourceOutletIds);
     return OK;
   }
 };
@@ -633,25 +721,18 @@ struct Inletf : public OpcodeBase<Inletf> {
    * State.
    */
   char sinkInletId[0x100];
-  std::vector<std::vector<Outletf *> *> *sourceOutlets;
+  std::atomic<Route<Outletf> *> route;
   int ksmps;
   int lastframe;
   bool fsignalInitialized;
   SignalFlowGraphState *sfg_globals;
+  bool accepts(const Outletf *) const { return true; }
   int init(CSOUND *csound) {
     csound::QueryGlobalPointer(csound, "sfg_globals", sfg_globals);
     LockGuard guard(csound, sfg_globals->signal_flow_ports_lock);
     ksmps = opds.insdshead->ksmps;
     lastframe = 0;
     fsignalInitialized = false;
-    if (std::find(sfg_globals->foutletVectors.begin(),
-                  sfg_globals->foutletVectors.end(),
-                  sourceOutlets) == sfg_globals->foutletVectors.end()) {
-      sourceOutlets = new std::vector<std::vector<Outletf *> *>;
-      sfg_globals->foutletVectors.push_back(sourceOutlets);
-    } else {
-      sourceOutlets->clear();
-    }
     sinkInletId[0] = 0;
     const char *insname =
         csound->GetInstrumentList(csound)[opds.insdshead->insno]->insname;
@@ -668,104 +749,86 @@ struct Inletf : public OpcodeBase<Inletf> {
       warn(csound, Str("Created instance 0x%x of inlet %s\n"), this,
            sinkInletId);
     }
-    // Find source outlets connecting to this.
+    // Flatten the instances of the source outlets connecting to this.
     // Any number of sources may connect to any number of sinks.
-    std::vector<std::string> &sourceOutletIds =
-        sfg_globals->connections[sinkInletId];
-    for (size_t i = 0, n = sourceOutletIds.size(); i < n; i++) {
-      const std::string &sourceOutletId = sourceOutletIds[i];
-      std::vector<Outletf *> &foutlets =
-          sfg_globals->foutletsForSourceOutletIds[sourceOutletId];
-      if (std::find(sourceOutlets->begin(), sourceOutlets->end(), &foutlets) ==
-          sourceOutlets->end()) {
-        sourceOutlets->push_back(&foutlets);
-        warn(csound, Str("Connected instances of outlet %s to instance 0x%x of "
-                         "inlet %s.\n"),
-             sourceOutletId.c_str(), this, sinkInletId);
-      }
-    }
+    sfg_globals->compile(this, sfg_globals->foutletsForSourceOutletIds);
     return OK;
   }
   /**
    * Mix fsig values from active outlets feeding this inlet.
    */
   int audio(CSOUND *csound) {
-    LockGuard guard(csound, sfg_globals->signal_flow_ports_lock);
+    const Route<Outletf> *sources = route.load(std::memory_order_acquire);
     int result = OK;
     float *sink = 0;
     float *source = 0;
     CMPLX *sinkFrame = 0;
     CMPLX *sourceFrame = 0;
-    // Loop over the source connections...
-    for (size_t sourceI = 0, sourceN = sourceOutlets->size(); sourceI < sourceN;
-         sourceI++) {
-      // Loop over the source connection instances...
-      const std::vector<Outletf *> *instances = sourceOutlets->at(sourceI);
-      for (size_t instanceI = 0, instanceN = instances->size();
-           instanceI < instanceN; instanceI++) {
-        const Outletf *sourceOutlet = instances->at(instanceI);
-        // Skip inactive instances.
-        if (sourceOutlet->opds.insdshead->actflg) {
-          if (!fsignalInitialized) {
-            int32 N = sourceOutlet->fsignal->N;
-            if (UNLIKELY(sourceOutlet->fsignal == fsignal)) {
-              csound->Warning(csound,
-                              "%s", Str("Unsafe to have same fsig as in and out"));
-            }
-            fsignal->sliding = 0;
-            if (sourceOutlet->fsignal->sliding) {
-              if (fsignal->frame.auxp == 0 ||
-                  fsignal->frame.size <
-                      sizeof(MYFLT) * opds.insdshead->ksmps * (N + 2))
-                csound->AuxAlloc(
-                    csound, (N + 2) * sizeof(MYFLT) * opds.insdshead->ksmps,
-                    &fsignal->frame);
-              fsignal->NB = sourceOutlet->fsignal->NB;
-              fsignal->sliding = 1;
-            } else if (fsignal->frame.auxp == 0 ||
-                       fsignal->frame.size < sizeof(float) * (N + 2)) {
-              csound->AuxAlloc(csound, (N + 2) * sizeof(float),
-                               &fsignal->frame);
-            }
-            fsignal->N = N;
-            fsignal->overlap = sourceOutlet->fsignal->overlap;
-            fsignal->winsize = sourceOutlet->fsignal->winsize;
-            fsignal->wintype = sourceOutlet->fsignal->wintype;
-            fsignal->format = sourceOutlet->fsignal->format;
-            fsignal->framecount = 1;
-            lastframe = 0;
-            if (UNLIKELY(!((fsignal->format == PVS_AMP_FREQ) ||
-                           (fsignal->format == PVS_AMP_PHASE))))
-              result = csound->InitError(csound,
-                                         "%s", Str("inletf: signal format "
-                                             "must be amp-phase or amp-freq."));
-            fsignalInitialized = true;
+    // Loop over the source instances...
+    for (size_t sourceI = 0, sourceN = sources->sources.size();
+         sourceI < sourceN; sourceI++) {
+      const Outletf *sourceOutlet = sources->sources[sourceI];
+      // Skip inactive instances.
+      if (sourceOutlet->opds.insdshead->actflg) {
+        if (!fsignalInitialized) {
+          int32 N = sourceOutlet->fsignal->N;
+          if (UNLIKELY(sourceOutlet->fsignal == fsignal)) {
+            csound->Warning(csound,
+                            "%s", Str("Unsafe to have same fsig as in and out"));
           }
-          if (fsignal->sliding) {
-            for (int frameI = 0; frameI < ksmps; frameI++) {
-              sinkFrame = (CMPLX *)fsignal->frame.auxp + (fsignal->NB * frameI);
-              sourceFrame = (CMPLX *)sourceOutlet->fsignal->frame.auxp +
-                            (fsignal->NB * frameI);
-              for (size_t binI = 0, binN = fsignal->NB; binI < binN; binI++) {
-                if (sourceFrame[binI].re > sinkFrame[binI].re) {
-                  sinkFrame[binI] = sourceFrame[binI];
-                }
+          fsignal->sliding = 0;
+          if (sourceOutlet->fsignal->sliding) {
+            if (fsignal->frame.auxp == 0 ||
+                fsignal->frame.size <
+                    sizeof(MYFLT) * opds.insdshead->ksmps * (N + 2))
+              csound->AuxAlloc(
+                  csound, (N + 2) * sizeof(MYFLT) * opds.insdshead->ksmps,
+                  &fsignal->frame);
+            fsignal->NB = sourceOutlet->fsignal->NB;
+            fsignal->sliding = 1;
+          } else if (fsignal->frame.auxp == 0 ||
+                     fsignal->frame.size < sizeof(float) * (N + 2)) {
+            csound->AuxAlloc(csound, (N + 2) * sizeof(float),
+                             &fsignal->frame);
+          }
+          fsignal->N = N;
+          fsignal->overlap = sourceOutlet->fsignal->overlap;
+          fsignal->winsize = sourceOutlet->fsignal->winsize;
+          fsignal->wintype = sourceOutlet->fsignal->wintype;
+          fsignal->format = sourceOutlet->fsignal->format;
+          fsignal->framecount = 1;
+          lastframe = 0;
+          if (UNLIKELY(!((fsignal->format == PVS_AMP_FREQ) ||
+                         (fsignal->format == PVS_AMP_PHASE))))
+            result = csound->InitError(csound,
+                                       "%s", Str("inletf: signal format "
+                                           "must be amp-phase or amp-freq."));
+          fsignalInitialized = true;
+        }
+        if (fsignal->sliding) {
+          for (int frameI = 0; frameI < ksmps; frameI++) {
+            sinkFrame = (CMPLX *)fsignal->frame.auxp + (fsignal->NB * frameI);
+            sourceFrame = (CMPLX *)sourceOutlet->fsignal->frame.auxp +
+                          (fsignal->NB * frameI);
+            for (size_t binI = 0, binN = fsignal->NB; binI < binN; binI++) {
+              if (sourceFrame[binI].re > sinkFrame[binI].re) {
+                sinkFrame[binI] = sourceFrame[binI];
               }
             }
           }
-        } else {
-          sink = (float *)fsignal->frame.auxp;
-          source = (float *)sourceOutlet->fsignal->frame.auxp;
-          if (lastframe < int(fsignal->framecount)) {
-            for (size_t binI = 0, binN = fsignal->N + 2; binI < binN;
-                 binI += 2) {
-              if (source[binI] > sink[binI]) {
-                source[binI] = sink[binI];
-                source[binI + 1] = sink[binI + 1];
-              }
+        }
+      } else {
+        sink = (float *)fsignal->frame.auxp;
+        source = (float *)sourceOutlet->fsignal->frame.auxp;
+        if (lastframe < int(fsignal->framecount)) {
+          for (size_t binI = 0, binN = fsignal->N + 2; binI < binN;
+               binI += 2) {
+            if (source[binI] > sink[binI]) {
+              source[binI] = sink[binI];
+              source[binI + 1] = sink[binI + 1];
             }
-            fsignal->framecount = lastframe = sourceOutlet->fsignal->framecount;
           }
+          fsignal->framecount = lastframe = sourceOutlet->fsignal->framecount;
         }
       }
     }
@@ -807,6 +870,9 @@ struct Outletv : public OpcodeNoteoffBase<Outletv> {
            this, voutlets.size(), sourceOutletId, vsignal, vsignal->dimensions,
            vsignal->sizes[0], vsignal->arrayMemberSize, vsignal->data,
            &vsignal->data);
+      sfg_globals->recompileOutlet(sourceOutletId,
+                                   sfg_globals->vinletsForSinkInletIds,
+                                   sfg_globals->voutletsForSourceOutletIds);
     }
     warn(csound, "ENDED Outletv::init()...\n");
     return OK;
@@ -820,6 +886,9 @@ struct Outletv : public OpcodeNoteoffBase<Outletv> {
     voutlets.erase(thisoutlet);
     warn(csound, Str("Removed 0x%x of %d instances of outletv %s\n"), this,
          voutlets.size(), sourceOutletId);
+    sfg_globals->recompileOutlet(sourceOutletId,
+                                 sfg_globals->vinletsForSinkInletIds,
+                                 sfg_globals->voutletsForSourceOutletIds);
     return OK;
   }
 };
@@ -837,11 +906,12 @@ struct Inletv : public OpcodeBase<Inletv> {
    * State.
    */
   char sinkInletId[0x100];
-  std::vector<std::vector<Outletv *> *> *sourceOutlets;
+  std::atomic<Route<Outletv> *> route;
   size_t arraySize;
   size_t myFltsPerArrayElement;
   int sampleN;
   SignalFlowGraphState *sfg_globals;
+  bool accepts(const Outletv *) const { return true; }
   int init(CSOUND *csound) {
     warn(csound, "BEGAN Inletv::init()...\n");
     csound::QueryGlobalPointer(csound, "sfg_globals", sfg_globals);
@@ -856,16 +926,6 @@ struct Inletv : public OpcodeBase<Inletv> {
       arraySize *= vsignal->sizes[dimension];
     }
     warn(csound, "arraySize: %d\n", arraySize);
-    warn(csound, "sourceOutlets: 0x%x\n", sourceOutlets);
-    if (std::find(sfg_globals->voutletVectors.begin(),
-                  sfg_globals->voutletVectors.end(),
-                  sourceOutlets) == sfg_globals->voutletVectors.end()) {
-      sourceOutlets = new std::vector<std::vector<Outletv *> *>;
-      sfg_globals->voutletVectors.push_back(sourceOutlets);
-    } else {
-      sourceOutlets->clear();
-    }
-    warn(csound, "sourceOutlets: 0x%x\n", sourceOutlets);
     sinkInletId[0] = 0;
     const char *insname =
         csound->GetInstrumentList(csound)[opds.insdshead->insno]->insname;
@@ -884,56 +944,28 @@ struct Inletv : public OpcodeBase<Inletv> {
            this, sinkInletId, vsignal, vsignal->dimensions, vsignal->sizes[0],
            vsignal->arrayMemberSize, vsignal->data, &vsignal->data);
     }
-    // Find source outlets connecting to this.
+    // Flatten the instances of the source outlets connecting to this.
     // Any number of sources may connect to any number of sinks.
-    std::vector<std::string> &sourceOutletIds =
-        sfg_globals->connections[sinkInletId];
-    for (size_t i = 0, n = sourceOutletIds.size(); i < n; i++) {
-      const std::string &sourceOutletId = sourceOutletIds[i];
-      std::vector<Outletv *> &voutlets =
-          sfg_globals->voutletsForSourceOutletIds[sourceOutletId];
-      if (std::find(sourceOutlets->begin(), sourceOutlets->end(), &voutlets) ==
-          sourceOutlets->end()) {
-        sourceOutlets->push_back(&voutlets);
-        warn(csound, Str("Connected instances of outlet %s to instance 0x%x of "
-                         "inlet %s\n"),
-             sourceOutletId.c_str(), this, sinkInletId);
-      }
-    }
+    sfg_globals->compile(this, sfg_globals->voutletsForSourceOutletIds);
     warn(csound, "ENDED Inletv::init().\n");
     return OK;
   }
   /**
    * Sum values from active outlets feeding this inlet.
    */
-  int audio(CSOUND *csound) {
-    // warn(csound, "BEGAN Inletv::audio()...\n");
-    LockGuard guard(csound, sfg_globals->signal_flow_ports_lock);
+  int audio(CSOUND *) {
+    const Route<Outletv> *sources = route.load(std::memory_order_acquire);
     for (uint32_t signalI = 0; signalI < arraySize; ++signalI) {
       vsignal->data[signalI] = FL(0.0);
     }
-    // Loop over the source connections...
-    for (size_t sourceI = 0, sourceN = sourceOutlets->size(); sourceI < sourceN;
-         sourceI++) {
-      // Loop over the source connection instances...
-      std::vector<Outletv *> *instances = sourceOutlets->at(sourceI);
-      for (size_t instanceI = 0, instanceN = instances->size();
-           instanceI < instanceN; instanceI++) {
-        Outletv *sourceOutlet = instances->at(instanceI);
-        // Skip inactive instances.
-        if (sourceOutlet->opds.insdshead->actflg) {
-          for (uint32_t signalI = 0; signalI < arraySize; ++signalI) {
-            ARRAYDAT *insignal = sourceOutlet->vsignal;
-            MYFLT *indata = insignal->data;
-            // warn(csound, "Inletv::audio: sourceOutlet: 0%x in arraydat: 0x%x
-            // data: 0x%x (0x%x)\n", sourceOutlet, insignal, indata,
-            // &insignal->data);
-            vsignal->data[signalI] += indata[signalI];
-          }
-        }
+    // Loop over the source instances, skipping inactive ones.
+    for (size_t sourceI = 0, sourceN = sources->sources.size();
+         sourceI < sourceN; sourceI++) {
+      const Outletv *sourceOutlet = sources->sources[sourceI];
+      if (sourceOutlet->opds.insdshead->actflg) {
+        mixBlock(vsignal->data, sourceOutlet->vsignal->data, arraySize);
       }
     }
-    // warn(csound, "ENDED Inletv::audio().\n");
     return OK;
   }
 };
@@ -976,6 +1008,9 @@ struct Outletkid : public OpcodeNoteoffBase<Outletkid> {
       koutlets.push_back(this);
       warn(csound, Str("Created instance 0x%x of %d instances of outlet %s\n"),
            this, koutlets.size(), sourceOutletId);
+      sfg_globals->recompileOutlet(sourceOutletId,
+                                   sfg_globals->kidinletsForSinkInletIds,
+                                   sfg_globals->kidoutletsForSourceOutletIds);
     }
     return OK;
   }
@@ -988,6 +1023,9 @@ struct Outletkid : public OpcodeNoteoffBase<Outletkid> {
     koutlets.erase(thisoutlet);
     warn(csound, Str("Removed 0x%x of %d instances of outletkid %s\n"), this,
          koutlets.size(), sourceOutletId);
+    sfg_globals->recompileOutlet(sourceOutletId,
+                                 sfg_globals->kidinletsForSinkInletIds,
+                                 sfg_globals->kidoutletsForSourceOutletIds);
     return OK;
   }
 };
@@ -1007,21 +1045,16 @@ struct Inletkid : public OpcodeBase<Inletkid> {
    */
   char sinkInletId[0x100];
   char *instanceId;
-  std::vector<std::vector<Outletkid *> *> *sourceOutlets;
+  std::atomic<Route<Outletkid> *> route;
   int ksmps;
   SignalFlowGraphState *sfg_globals;
+  bool accepts(const Outletkid *sourceOutlet) const {
+    return std::strcmp(sourceOutlet->instanceId, instanceId) == 0;
+  }
   int init(CSOUND *csound) {
     csound::QueryGlobalPointer(csound, "sfg_globals", sfg_globals);
     LockGuard guard(csound, sfg_globals->signal_flow_ports_lock);
     ksmps = opds.insdshead->ksmps;
-    if (std::find(sfg_globals->kidoutletVectors.begin(),
-                  sfg_globals->kidoutletVectors.end(),
-                  sourceOutlets) == sfg_globals->kidoutletVectors.end()) {
-      sourceOutlets = new std::vector<std::vector<Outletkid *> *>;
-      sfg_globals->kidoutletVectors.push_back(sourceOutlets);
-    } else {
-      sourceOutlets->clear();
-    }
     sinkInletId[0] = 0;
     instanceId = csound->strarg2name(csound, (char *)0, SinstanceId->data,
                                      (char *)"", 1);
@@ -1040,47 +1073,27 @@ struct Inletkid : public OpcodeBase<Inletkid> {
       warn(csound, Str("Created instance 0x%x of inlet %s\n"), this,
            sinkInletId);
     }
-    // Find source outlets connecting to this.
+    // Flatten the instances of the source outlets connecting to this.
     // Any number of sources may connect to any number of sinks.
-    std::vector<std::string> &sourceOutletIds =
-        sfg_globals->connections[sinkInletId];
-    for (size_t i = 0, n = sourceOutletIds.size(); i < n; i++) {
-      const std::string &sourceOutletId = sourceOutletIds[i];
-      std::vector<Outletkid *> &koutlets =
-          sfg_globals->kidoutletsForSourceOutletIds[sourceOutletId];
-      if (std::find(sourceOutlets->begin(), sourceOutlets->end(), &koutlets) ==
-          sourceOutlets->end()) {
-        sourceOutlets->push_back(&koutlets);
-        warn(csound, Str("Connected instances of outlet %s to instance 0x%x of "
-                         "inlet %s.\n"),
-             sourceOutletId.c_str(), this, sinkInletId);
-      }
-    }
+    sfg_globals->compile(this, sfg_globals->kidoutletsForSourceOutletIds);
     return OK;
   }
   /**
    * Replay instance signal.
    */
-  int kontrol(CSOUND *csound) {
-    LockGuard guard(csound, sfg_globals->signal_flow_ports_lock);
-    // Zero the / buffer.
-    *ksignal = FL(0.0);
-    // Loop over the source connections...
-    for (size_t sourceI = 0, sourceN = sourceOutlets->size(); sourceI < sourceN;
-         sourceI++) {
-      // Loop over the source connection instances...
-      const std::vector<Outletkid *> *instances = sourceOutlets->at(sourceI);
-      for (size_t instanceI = 0, instanceN = instances->size();
-           instanceI < instanceN; instanceI++) {
-        const Outletkid *sourceOutlet = instances->at(instanceI);
-        // Skip inactive instances and also all non-matching instances.
-        if (sourceOutlet->opds.insdshead->actflg) {
-          if (std::strcmp(sourceOutlet->instanceId, instanceId) == 0) {
-            *ksignal += *sourceOutlet->ksignal;
-          }
-        }
+  int kontrol(CSOUND *) {
+    const Route<Outletkid> *sources = route.load(std::memory_order_acquire);
+    MYFLT sum = FL(0.0);
+    // The route holds only the instances with our instance id; skip
+    // inactive ones.
+    for (size_t sourceI = 0, sourceN = sources->sources.size();
+         sourceI < sourceN; sourceI++) {
+      const Outletkid *sourceOutlet = sources->sources[sourceI];
+      if (sourceOutlet->opds.insdshead->actflg) {
+        sum += *sourceOutlet->ksignal;
       }
     }
+    *ksignal = sum;
     return OK;
   }
 };
@@ -1116,7 +1129,7 @@ struct Connect : public OpcodeBase<Connect> {
         csound->strarg2name(csound, (char *)0, Sinlet->data, (char *)"", 1);
     warn(csound, Str("Connected outlet %s to inlet %s.\n"),
          sourceOutletId.c_str(), sinkInletId.c_str());
-    sfg_globals->connections[sinkInletId].push_back(sourceOutletId);
+    sfg_globals->connect(sourceOutletId, sinkInletId);
     return OK;
   }
 };
@@ -1149,7 +1162,7 @@ struct Connecti : public OpcodeBase<Connecti> {
         csound->strarg2name(csound, (char *)0, Sinlet->data, (char *)"", 1);
     warn(csound, Str("Connected outlet %s to inlet %s.\n"),
          sourceOutletId.c_str(), sinkInletId.c_str());
-    sfg_globals->connections[sinkInletId].push_back(sourceOutletId);
+    sfg_globals->connect(sourceOutletId, sinkInletId);
     return OK;
   }
 };
@@ -1182,7 +1195,7 @@ struct Connectii : public OpcodeBase<Connectii> {
         csound->strarg2name(csound, (char *)0, Sinlet->data, (char *)"", 1);
     warn(csound, Str("Connected outlet %s to inlet %s.\n"),
          sourceOutletId.c_str(), sinkInletId.c_str());
-    sfg_globals->connections[sinkInletId].push_back(sourceOutletId);
+    sfg_globals->connect(sourceOutletId, sinkInletId);
     return OK;
   }
 };
@@ -1212,7 +1225,7 @@ struct ConnectS : public OpcodeBase<ConnectS> {
         csound->strarg2name(csound, (char *)0, Sinlet->data, (char *)"", 1);
     warn(csound, Str("Connected outlet %s to inlet %s.\n"),
          sourceOutletId.c_str(), sinkInletId.c_str());
-    sfg_globals->connections[sinkInletId].push_back(sourceOutletId);
+    sfg_globals->connect(sourceOutletId, sinkInletId);
     return OK;
   }
 };
@@ -1464,9 +1477,9 @@ static OENTRY oentries[] = {
     {(char *)"inletk", sizeof(Inletk), _CR, 3, (char *)"k", (char *)"S",
      (SUBR)&Inletk::init_, (SUBR)&Inletk::kontrol_, 0},
     {(char *)"outletkid", sizeof(Outletkid), _CW, 3, (char *)"", (char *)"SSk",
-     (SUBR)&Outletk::init_, (SUBR)&Outletk::kontrol_, 0},
+     (SUBR)&Outletkid::init_, (SUBR)&Outletkid::kontrol_, 0},
     {(char *)"inletkid", sizeof(Inletkid), _CR, 3, (char *)"k", (char *)"SS",
-     (SUBR)&Inletk::init_, (SUBR)&Inletk::kontrol_, 0},
+     (SUBR)&Inletkid::init_, (SUBR)&Inletkid::kontrol_, 0},
     {(char *)"outletf", sizeof(Outletf), _CW, 3, (char *)"", (char *)"Sf",
      (SUBR)&Outletf::init_, (SUBR)&Outletf::audio_},
     {(char *)"inletf", sizeof(Inletf), _CR, 3, (char *)"f", (char *)"S",
@@ -0,0 +1,106 @@
+/*
+    specmac.h:
+
+    Copyright (C) 2005 Istvan Varga
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Spectral multiply-accumulate shared by the partitioned convolution
+   opcodes (ftconv, liveconv).  The spectra are in the RealFFT2 packed
+   format: DC and Nyquist in the first two slots, then interleaved
+   real/imaginary pairs. */
+
+#ifndef CSOUND_SPECMAC_H
+#define CSOUND_SPECMAC_H
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+/* out[k] += a[k] * b[k] for n interleaved complex values */
+static inline void cmplx_mac(MYFLT *out, const MYFLT *a, const MYFLT *b,
+                             int32_t n)
+{
+    int32_t k = 0;
+#if defined(__SSE__) && !defined(USE_DOUBLE)
+    {
+      const __m128 sgn = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+      for (; k < (n & ~1); k += 2) {
+        __m128 va = _mm_loadu_ps(&a[2*k]);
+        __m128 vb = _mm_loadu_ps(&b[2*k]);
+        __m128 br = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 bi = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 sw = _mm_shuffle_ps(va, va, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 re = _mm_mul_ps(va, br);
+        __m128 im = _mm_xor_ps(_mm_mul_ps(sw, bi), sgn);
+        _mm_storeu_ps(&out[2*k],
+                      _mm_add_ps(_mm_loadu_ps(&out[2*k]), _mm_add_ps(re, im)));
+      }
+    }
+#elif defined(__SSE2__) && defined(USE_DOUBLE)
+    {
+      const __m128d sgn = _mm_set_pd(0.0, -0.0);
+      for (; k < n; k++) {
+        __m128d va = _mm_loadu_pd(&a[2*k]);
+        __m128d br = _mm_load1_pd(&b[2*k]);
+        __m128d bi = _mm_load1_pd(&b[2*k+1]);
+        __m128d sw = _mm_shuffle_pd(va, va, 1);
+        __m128d re = _mm_mul_pd(va, br);
+        __m128d im = _mm_xor_pd(_mm_mul_pd(sw, bi), sgn);
+        _mm_storeu_pd(&out[2*k],
+                      _mm_add_pd(_mm_loadu_pd(&out[2*k]), _mm_add_pd(re, im)));
+      }
+    }
+#endif
+    /* whatever the vector loop above did not cover */
+    for (; k < n; k++) {
+      MYFLT re1 = a[2*k], im1 = a[2*k+1], re2 = b[2*k], im2 = b[2*k+1];
+      out[2*k]   += re1 * re2 - im1 * im2;
+      out[2*k+1] += re1 * im2 + re2 * im1;
+    }
+}
+
+/* outBuf = sum of the nPartitions products of input spectra (a ring
+   buffer, starting at ringBuf_startPos) and IR spectra; partSize is
+   half the FFT size and must be at least 2 */
+static inline void spectral_mac(MYFLT *outBuf, MYFLT *ringBuf,
+                                MYFLT *IR_Data, int32_t partSize,
+                                int32_t nPartitions, int32_t ringBuf_startPos)
+{
+    int32_t fftSize = partSize << 1;
+    MYFLT   *rbPtr = &(ringBuf[ringBuf_startPos]);
+    MYFLT   *rbEndP = ringBuf + fftSize * nPartitions;
+    MYFLT   *irPtr = IR_Data;
+
+    memset(outBuf, 0, sizeof(MYFLT) * fftSize);
+    do {
+      /* wrap ring buffer position */
+      if (rbPtr >= rbEndP)
+        rbPtr = ringBuf;
+      outBuf[0] += rbPtr[0] * irPtr[0];     /* DC */
+      outBuf[1] += rbPtr[1] * irPtr[1];     /* Nyquist */
+      cmplx_mac(outBuf + 2, rbPtr + 2, irPtr + 2, partSize - 1);
+      rbPtr += fftSize;
+      irPtr += fftSize;
+    } while (--nPartitions);
+}
+
+#endif  /* CSOUND_SPECMAC_H */
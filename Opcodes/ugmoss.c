@@ -730,7 +730,7 @@ static OENTRY localops[] =
    { "dconv",  S(DCONV), TR, 3, "a", "aii",   (SUBR)dconvset, (SUBR)dconv },
    { "vcomb", S(VCOMB),  0,3, "a", "akxioo", (SUBR)vcombset, (SUBR)vcomb   },
    { "valpass", S(VCOMB),0,3, "a", "akxioo", (SUBR)vcombset, (SUBR)valpass },
-   { "ftmorf", S(FTMORF),TR, 3, "",  "kii",  (SUBR)ftmorfset,  (SUBR)ftmorf,    },
+   { "ftmorf", S(FTMORF),TB, 3, "",  "kii",  (SUBR)ftmorfset,  (SUBR)ftmorf,    },
    { "##and.ii",  S(AOP),  0,1, "i", "ii",   (SUBR)and_kk                  },
    { "##and.kk",  S(AOP),  0,2, "k", "kk",   NULL,   (SUBR)and_kk          },
    { "##and.ka",  S(AOP),  0,2, "a", "ka",   NULL,   (SUBR)and_ka  },
@@ -293,7 +293,7 @@ static int32_t scantPerf(CSOUND *csound, SCANTABLE *p)
 static OENTRY localops[] = {
   { "wterrain", S(WAVETER), TR, 3,  "a", "kkkkkkii",
     (SUBR)wtinit, (SUBR)wtPerf },
-  { "scantable", S(SCANTABLE),TR, 3,"a", "kkiiiii",
+  { "scantable", S(SCANTABLE),TB, 3,"a", "kkiiiii",
     (SUBR)scantinit,(SUBR)scantPerf},
   { "scanhammer",S(SCANHAMMER),TB, 1,"", "iiii", (SUBR)scanhinit, NULL, NULL    }
 };
@@ -204,6 +204,16 @@ static const char *longUsageList[] = {
   " ",
   Str_noop("--defer-gen1            defer GEN01 soundfile loads until "
                                    "performance time"),
+  Str_noop("--ftable-cache          share identical GEN tables with other\n"
+           "                        instances in the process (read-only)"),
+  Str_noop("--profile[=FNAM]        count CPU time per opcode; write\n"
+           "                        flamegraph folded stacks to FNAM"),
+  Str_noop("--orc-opt=LIST          orchestra optimisations, comma separated:\n"
+           "                        cse,dce,hoist, all or none"),
+  Str_noop("--diskin-threads=N      disk reading threads for diskin2 in\n"
+           "                        realtime mode (default 2)"),
+  Str_noop("--sdft-threads=N        threads sharing the sliding DFT of\n"
+           "                        pvsanal and pvsynth (default 0: none)"),
   Str_noop("--iobufsamps=N          sample frames (or -kprds) per software "
                                     "sound I/O buffer"),
   Str_noop("--hardwarebufsamps=N    samples per hardware sound I/O buffer"),
@@ -307,7 +317,9 @@ static const char *longUsageList[] = {
            "                        output (e.g. -odac) to be defined first"),
   Str_noop("--ksmps=N               override ksmps"),
   Str_noop("--fftlib=N              actual FFT lib to use (FFTLIB=0, "
-                                   "PFFFT = 1, vDSP =2)"),
+                                   "PFFFT = 1, vDSP =2, MRFFT = 3)"),
+  Str_noop("--write-buffers=N       write output soundfiles from a separate\n"
+           "                        thread through N buffers (0: off)"),
   Str_noop("--udp-echo              echo UDP commands on terminal"),
   Str_noop("--aft-zero              set aftertouch to zero, not 127 (default)"),
   " ",
@@ -591,6 +603,52 @@ static int decode_long(CSOUND *csound, char *s, int argc, char **argv)
       O->gen01defer = 1;                /* defer GEN01 sample loads */
       return 1;                         /*   until performance time */
     }
+    else if (!(strcmp (s, "ftable-cache"))) {
+      O->ftcache = 1;                   /* share identical GEN tables */
+      return 1;
+    }
+    else if (!(strcmp (s, "profile"))) {
+      O->profile = 1;                   /* per opcode CPU time */
+      return 1;
+    }
+    else if (!(strncmp (s, "profile=", 8))) {
+      s += 8;
+      if (UNLIKELY(*s=='\0')) dieu(csound, Str("no profile file name"));
+      O->profile = 1;
+      O->profilename = cs_strdup(csound, s);
+      return 1;
+    }
+    else if (!(strncmp (s, "orc-opt=", 8))) {
+      char *tok, *end;
+      s += 8;
+      O->orcopt = 0;
+      for (tok = s; *tok != '\0'; tok = (*end ? end + 1 : end)) {
+        size_t n;
+        end = strchr(tok, ',');
+        if (end == NULL) end = tok + strlen(tok);
+        n = end - tok;
+        if (n == 3 && !strncmp(tok, "cse", 3)) O->orcopt |= ORC_OPT_CSE;
+        else if (n == 3 && !strncmp(tok, "dce", 3)) O->orcopt |= ORC_OPT_DCE;
+        else if (n == 5 && !strncmp(tok, "hoist", 5))
+          O->orcopt |= ORC_OPT_HOIST;
+        else if (n == 3 && !strncmp(tok, "all", 3)) O->orcopt = ORC_OPT_ALL;
+        else if (n == 4 && !strncmp(tok, "none", 4)) O->orcopt = 0;
+        else dieu(csound, Str("unknown --orc-opt pass"));
+      }
+      return 1;
+    }
+    else if (!(strncmp (s, "diskin-threads=", 15))) {
+      s += 15;
+      if (UNLIKELY(*s=='\0')) dieu(csound, Str("no diskin thread count"));
+      O->diskin_threads = atoi(s);
+      return 1;
+    }
+    else if (!(strncmp (s, "sdft-threads=", 13))) {
+      s += 13;
+      if (UNLIKELY(*s=='\0')) dieu(csound, Str("no sliding DFT thread count"));
+      O->sdft_threads = atoi(s);
+      return 1;
+    }
     else if (!(strncmp (s, "midifile=", 9))) {
       s += 9;
       if (*s==3) s++;           /* skip ETX */
@@ -1123,6 +1181,12 @@ static int decode_long(CSOUND *csound, char *s, int argc, char **argv)
         csound->Warning(csound, "UDP console: needs address and port\n");
       return 1;
     }
+    else if (!(strncmp(s, "write-buffers=", 14))) {
+      s += 14;
+      O->write_buffers = atoi(s);
+      if (O->write_buffers < 0) O->write_buffers = 0;
+      return 1;
+    }
     else if (!(strncmp(s, "fftlib=",7))) {
       s += 7;
       O->fft_lib = atoi(s);
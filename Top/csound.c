@@ -68,6 +68,11 @@
 #include "csound_standard_types.h"
 
 #include "csdebug.h"
+#include "profile.h"
+#include "pstream.h"
+#include "sdft.h"
+#include "oscbank.h"
+#include "Opcodes/arrayvec.h"
 #include <time.h>
 
 extern void allocate_message_queue(CSOUND *csound);
@@ -509,10 +514,13 @@ static const CSOUND cenviron_ = {
     csoundErrCnt,
     csoundFTnp2Finde,
     csoundGetInstrument,
+    hfgens_async,
+    ftgen_ready,
+    csp_orc_sa_dependency,
     {
       NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
       NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+      NULL, NULL, NULL, NULL, NULL, NULL
     },
     /* ------- private data (not to be used by hosts or externals) ------- */
     /* callback function pointers */
@@ -731,6 +739,8 @@ static const CSOUND cenviron_ = {
     0,              /*  maxfnum             */
     NULL,           /*  gensub              */
     GENMAX+1,       /*  genmax              */
+    NULL,           /*  ftgen_async         */
+    NULL,           /*  profile             */
     NULL,           /*  namedGlobals        */
     NULL,           /*  cfgVariableDB       */
     FL(0.0), FL(0.0), FL(0.0),  /*  prvbt, curbt, nxtbt */
@@ -739,6 +749,14 @@ static const CSOUND cenviron_ = {
     { 0, NULL, NULL, '\0', 0, FL(0.0),
       FL(0.0), { FL(0.0) }, {NULL}},   /*  evt */
     NULL,           /*  memalloc_db         */
+    NULL,           /*  mem_arenas          */
+    0,              /*  mem_epoch           */
+    0,              /*  mem_lock_waits      */
+    0, 0,           /*  mem_large_allocs, mem_large_frees */
+    0, 0,           /*  mem_retired_allocs, mem_retired_frees */
+    0,              /*  mem_large_bytes     */
+    0,              /*  mem_stats_allocs    */
+    0.0,            /*  mem_stats_time      */
     (MGLOBAL*) NULL, /* midiGlobals         */
     NULL,           /*  envVarDB            */
     (MEMFIL*) NULL, /*  memfiles            */
@@ -746,6 +764,7 @@ static const CSOUND cenviron_ = {
     0,              /*  FFT_max_size        */
     NULL,           /*  FFT_table_1         */
     NULL,           /*  FFT_table_2         */
+    NULL,           /*  FFT_plans           */
     NULL, NULL, NULL, /* tseg, tpsave, unused */
     (MYFLT*) NULL,  /*  gbloffbas           */
     NULL,           /* file_io_thread    */
@@ -821,6 +840,9 @@ static const CSOUND cenviron_ = {
       1U,           /*  nframes             */
       NULL, NULL,   /*  pin, pout           */
       0,            /*dither                */
+      NULL,         /*  writer              */
+      {0, 0, 0, 0, 0, 0, 0.0, 0.0}, /* wstats */
+      0.0           /*  lasthdr             */
     },
     0,              /*  warped              */
     0,              /*  sstrlen             */
@@ -915,7 +937,14 @@ static const CSOUND cenviron_ = {
       0.4,          /*    vbr quality  */
       0,            /*    ksmps_override */
       0,             /*    fft_lib */
-      0
+      0,             /*    echo */
+      0,             /*    write_buffers */
+      0,             /*    ftcache */
+      0,             /*    profile */
+      NULL,          /*    profilename */
+      0,             /*    orcopt */
+      2,             /*    diskin_threads */
+      0              /*    sdft_threads */
     },
 
     {0, 0, {0}}, /* REMOT_BUF */
@@ -939,10 +968,26 @@ static const CSOUND cenviron_ = {
     0,              /* dag_num_active */
     NULL,           /* dag_task_map */
     NULL,           /* dag_task_status */
-    NULL,           /* dag_task_watch */
-    NULL,           /* dag_wlmm */
-    NULL,           /* dag_task_dep */
+    NULL,           /* dag_nodes */
+    NULL,           /* dag_edges */
+    0,              /* dag_edges_size */
+    -1,             /* dag_edges_free */
     100,            /* dag_task_max_size */
+    0,              /* dag_num_slots */
+    -1,             /* dag_slots_free */
+    0,              /* dag_update_count */
+    0,              /* dag_orc_changed */
+    NULL,           /* dag_conflict */
+    0,              /* dag_conflict_size */
+    NULL,           /* dag_deques */
+    0,              /* dag_num_deques */
+    {0},            /* dag_tasks_left */
+    0,              /* dag_width */
+    1,              /* dag_num_threads */
+    {0},            /* dag_workers_busy */
+    NULL,           /* dag_gate */
+    NULL,           /* dag_done */
+    {0, 0, 0},      /* dag_stats */
     0,              /* tempStatus */
     1,              /* orcLineOffset */
     0,              /* scoLineOffset */
@@ -971,10 +1016,10 @@ static const CSOUND cenviron_ = {
     0,              /* unusedint */
     1,              /* inZero */
     NULL,           /* msg_queue */
-    0,              /* msg_queue_wget */
     0,              /* msg_queue_wput */
-    0,              /* msg_queue_rstart */
-    0,              /* msg_queue_items */
+    0,              /* msg_queue_rget */
+    NULL,           /* msg_queue_space */
+    0,              /* msg_queue_waiters */
     127,            /* aftouch */
     NULL,           /* directory for corfiles */
     NULL,           /* alloc_queue */
@@ -1284,6 +1329,10 @@ PUBLIC int csoundInitialize(int flags)
     if (!(flags & CSOUNDINIT_NO_SIGNAL_HANDLER)) {
       install_signal_handler();
     }
+    /* pick the vector kernels before any instance can use them */
+    array_vec_init();
+    sdft_vec_init();
+    oscbank_vec_init();
 #if !defined(WIN32)
     if (!(flags & CSOUNDINIT_NO_ATEXIT))
       atexit(destroy_all_instances);
@@ -1321,6 +1370,7 @@ PUBLIC CSOUND *csoundCreate(void *hostdata)
     csoundUnLock();
     csoundReset(csound);
     csound->API_lock = csoundCreateMutex(1);
+    csound->msg_queue_space = csoundCreateThreadLock();
     allocate_message_queue(csound);
     /* NB: as suggested by F Pinot, keep the
        address of the pointer to CSOUND inside
@@ -1398,6 +1448,8 @@ PUBLIC void csoundDestroy(CSOUND *csound)
       //csoundLockMutex(csound->API_lock);
       csoundDestroyMutex(csound->API_lock);
     }
+    if (csound->msg_queue_space != NULL)
+      csoundDestroyThreadLock(csound->msg_queue_space);
     /* clear the pointer */
     // *(csound->self) = NULL;
     free((void*) csound);
@@ -1492,8 +1544,8 @@ inline void advanceINSDSPointer(INSDS ***start, int num)
 }
 
 int dag_get_task(CSOUND *csound, int index, int numThreads, int next_task);
-int dag_end_task(CSOUND *csound, int task);
-void dag_build(CSOUND *csound, INSDS *chain);
+int dag_end_task(CSOUND *csound, int index, int task);
+void dag_update(CSOUND *csound, INSDS *chain);
 void dag_reinit(CSOUND *csound);
 
 inline static int nodePerf(CSOUND *csound, int index, int numThreads)
@@ -1503,11 +1555,11 @@ inline static int nodePerf(CSOUND *csound, int index, int numThreads)
     int played_count = 0;
     int which_task;
     INSDS **task_map = (INSDS**)csound->dag_task_map;
+    PROFTAB *prof = PROFILE_TAB(csound, index);
     double time_end;
 #define INVALID (-1)
 #define WAIT    (-2)
     int next_task = INVALID;
-    IGN(index);
 
     while (1) {
       int done;
@@ -1540,7 +1592,7 @@ inline static int nodePerf(CSOUND *csound, int index, int numThreads)
               /* In case of jumping need this repeat of opstart */
               opstart->insdshead->pds = opstart;
               csound->op = csound->ids->optext->t.oentry->opname;
-              (*opstart->opadr)(csound, opstart); /* run each opcode */
+              PROFILE_PERF(csound, prof, opstart); /* run each opcode */
               opstart = opstart->insdshead->pds;
             }
             csound->mode = 0;
@@ -1575,7 +1627,7 @@ inline static int nodePerf(CSOUND *csound, int index, int numThreads)
               while ((opstart = opstart->nxtp) != NULL) {
                 opstart->insdshead->pds = opstart;
                 csound->op = csound->ids->optext->t.oentry->opname;
-                (*opstart->opadr)(csound, opstart); /* run each opcode */
+                PROFILE_PERF(csound, prof, opstart); /* run each opcode */
                 opstart = opstart->insdshead->pds;
               }
               csound->mode = 0;
@@ -1587,7 +1639,7 @@ inline static int nodePerf(CSOUND *csound, int index, int numThreads)
           played_count++;
         }
         //printf("******** finished task %d\n", which_task);
-        next_task = dag_end_task(csound, which_task);
+        next_task = dag_end_task(csound, index, which_task);
     }
     return played_count;
 }
@@ -1630,7 +1682,8 @@ unsigned long kperfThread(void * cs)
     //INSDS *start;
     CSOUND *csound = (CSOUND *)cs;
     void *threadId;
-    int index;
+    THREADINFO *self;
+    int index, i;
     int numThreads;
     _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
 
@@ -1650,29 +1703,101 @@ unsigned long kperfThread(void * cs)
       csound->Die(csound, Str("Bad ThreadId"));
       return ULONG_MAX;
     }
+    for (self = csound->multiThreadedThreadInfo, i = 0; i < index; i++)
+      self = self->next;
     index++;
 
     while (1) {
-
-      csound->WaitBarrier(csound->barrier1);
-
-      // FIXME:PTHREAD_WORK - need to check if this is necessary and, if so,
-      // use some other kind of locking mechanism as it isn't clear why a
-      //global mutex would be necessary versus a per-CSOUND instance mutex
-      /*csound_global_mutex_lock();*/
-      if (csound->multiThreadedComplete == 1) {
-        /*csound_global_mutex_unlock();*/
+      int stop;
+      /* parked until the main thread has work for this worker */
+      csoundLockMutex(csound->dag_gate);
+      while (!self->go && !csound->multiThreadedComplete)
+        csoundCondWait(self->wakeup, csound->dag_gate);
+      self->go = 0;
+      stop = csound->multiThreadedComplete;
+      csoundUnlockMutex(csound->dag_gate);
+
+      if (stop) {
         free(threadId);
         return 0UL;
       }
-      /*csound_global_mutex_unlock();*/
 
       nodePerf(csound, index, numThreads);
 
-      csound->WaitBarrier(csound->barrier2);
+      csoundLockMutex(csound->dag_gate);
+      if (--csound->dag_workers_busy.n == 0)
+        csoundCondSignal(csound->dag_done);
+      csoundUnlockMutex(csound->dag_gate);
     }
 }
 
+/* Run one k-cycle of the active chain through the DAG.  Small or
+   serial DAGs are run by the calling thread alone; otherwise only as
+   many workers are woken as the DAG is wide, the rest stay parked. */
+static void dag_perf(CSOUND *csound, INSDS *ip)
+{
+    int i, nthreads;
+    THREADINFO *t;
+
+    if (csound->dag_changed || ATOMIC_GET(csound->dag_orc_changed))
+      dag_update(csound, ip);
+    else dag_reinit(csound);     /* set to initial state */
+    nthreads = csound->dag_num_threads;
+    if (UNLIKELY(csound->oparms->odebug))
+      csound->Message(csound, "k-cycle %ld: %d tasks, width %d, %d thread(s)\n",
+                      (long) csound->kcounter, csound->dag_num_active,
+                      csound->dag_width, nthreads);
+
+    if (nthreads <= 1) {
+      csound->dag_stats.inline_cycles++;
+      (void) nodePerf(csound, 0, 1);
+      return;
+    }
+    csoundLockMutex(csound->dag_gate);
+    for (i = 1, t = csound->multiThreadedThreadInfo;
+         i < nthreads && t != NULL; i++, t = t->next) {
+      t->go = 1;
+      csoundCondSignal(t->wakeup);
+    }
+    csound->dag_workers_busy.n = i - 1;
+    csoundUnlockMutex(csound->dag_gate);
+    csound->dag_stats.parallel_cycles++;
+    csound->dag_stats.workers_woken += i - 1;
+
+    (void) nodePerf(csound, 0, 1);
+
+    /* all tasks are done; wait for the workers to leave nodePerf
+       before the DAG can be reinitialised */
+    csoundLockMutex(csound->dag_gate);
+    while (csound->dag_workers_busy.n > 0)
+      csoundCondWait(csound->dag_done, csound->dag_gate);
+    csoundUnlockMutex(csound->dag_gate);
+}
+
+/* Release the parked workers, wait for them to exit and free the
+   pool; later k-cycles run on the calling thread */
+void dag_stop_workers(CSOUND *csound)
+{
+    THREADINFO *t, *nxt;
+    if (csound->multiThreadedThreadInfo == NULL)
+      return;
+    csoundLockMutex(csound->dag_gate);
+    csound->multiThreadedComplete = 1;
+    for (t = csound->multiThreadedThreadInfo; t != NULL; t = t->next)
+      csoundCondSignal(t->wakeup);
+    csoundUnlockMutex(csound->dag_gate);
+    for (t = csound->multiThreadedThreadInfo; t != NULL; t = nxt) {
+      nxt = t->next;
+      csound->JoinThread(t->threadId);
+      csoundDestroyCondVar(t->wakeup);
+      csound->Free(csound, t);
+    }
+    csound->multiThreadedThreadInfo = NULL;
+    csoundDestroyCondVar(csound->dag_done);
+    csoundDestroyMutex(csound->dag_gate);
+    csound->dag_done = csound->dag_gate = NULL;
+}
+
 int kperf_nodebug(CSOUND *csound)
 {
     INSDS *ip;
@@ -1714,21 +1839,12 @@ int kperf_nodebug(CSOUND *csound)
       /* There are 2 partitions of work: 1st by inso,
          2nd by inso count / thread count. */
       if (csound->multiThreadedThreadInfo != NULL) {
-        if (csound->dag_changed) dag_build(csound, ip);
-        else dag_reinit(csound);     /* set to initial state */
-
-        /* process this partition */
-        csound->WaitBarrier(csound->barrier1);
-
-        (void) nodePerf(csound, 0, 1);
-
-        /* wait until partition is complete */
-        csound->WaitBarrier(csound->barrier2);
-        csound->multiThreadedDag = NULL;
+        dag_perf(csound, ip);
       }
       else {
         int done;
         double time_end = (csound->ksmps+csound->icurTime)/csound->esr;
+        PROFTAB *prof = PROFILE_TAB(csound, 0);
 
         while (ip != NULL) {                /* for each instr active:  */
           INSDS *nxt = ip->nxtact;
@@ -1755,7 +1871,7 @@ int kperf_nodebug(CSOUND *csound)
                      ip->actflg) {
                 opstart->insdshead->pds = opstart;
                 csound->op = opstart->optext->t.opcod;
-                error = (*opstart->opadr)(csound, opstart); /* run each opcode */
+                error = PROFILE_PERF(csound, prof, opstart); /* run each opcode */
                 opstart = opstart->insdshead->pds;
               }
               csound->mode = 0;
@@ -1793,7 +1909,7 @@ int kperf_nodebug(CSOUND *csound)
                     opstart->insdshead->pds = opstart;
                     csound->op = opstart->optext->t.opcod;
                     //csound->ids->optext->t.oentry->opname;
-                    error = (*opstart->opadr)(csound, opstart); /* run each opcode */
+                    error = PROFILE_PERF(csound, prof, opstart);
                     opstart = opstart->insdshead->pds;
                   }
                   csound->mode = 0;
@@ -1980,17 +2096,7 @@ int kperf_debug(CSOUND *csound)
       /* There are 2 partitions of work: 1st by inso,
          2nd by inso count / thread count. */
       if (csound->multiThreadedThreadInfo != NULL) {
-        if (csound->dag_changed) dag_build(csound, ip);
-        else dag_reinit(csound);     /* set to initial state */
-
-        /* process this partition */
-        csound->WaitBarrier(csound->barrier1);
-
-        (void) nodePerf(csound, 0, 1);
-
-        /* wait until partition is complete */
-        csound->WaitBarrier(csound->barrier2);
-        csound->multiThreadedDag = NULL;
+        dag_perf(csound, ip);
       }
       else {
         int done;
@@ -2276,10 +2382,8 @@ PUBLIC int csoundPerform(CSOUND *csound)
           csoundMessage(csound, Str("Score finished in csoundPerform().\n"));
           if(!csound->oparms->realtime)
             csoundUnlockMutex(csound->API_lock);
-          if (csound->oparms->numThreads > 1) {
-            csound->multiThreadedComplete = 1;
-            csound->WaitBarrier(csound->barrier1);
-          }
+          if (csound->oparms->numThreads > 1)
+            dag_stop_workers(csound);
           return done;
         }
       } while (csound->kperf(csound));
@@ -3311,6 +3415,7 @@ static void reset(CSOUND *csound)
     memcpy(p1, (void*) &(saved_env->first_callback_), (size_t) length);
     csound->csoundCallbacks_ = saved_env->csoundCallbacks_;
     csound->API_lock = saved_env->API_lock;
+    csound->msg_queue_space = saved_env->msg_queue_space;
 #ifdef HAVE_PTHREAD_SPIN_LOCK
     csound->memlock = saved_env->memlock;
     csound->spinlock = saved_env->spinlock;
@@ -3629,6 +3734,7 @@ void csoundTableSetInternal(CSOUND *csound,
                                    int table, int index, MYFLT value)
 {
     if (csound->oparms->realtime) csoundLockMutex(csound->init_pass_threadlock);
+    csoundFTUnshare(csound, csound->flist[table]);
     csound->flist[table]->ftable[index] = value;
     if (csound->oparms->realtime) csoundUnlockMutex(csound->init_pass_threadlock);
 }
@@ -43,6 +43,7 @@ CS_NORETURN void    dieu(CSOUND *, char *, ...);
   int     read_unified_file2(CSOUND *csound, char *csd);
   int     read_unified_file4(CSOUND *csound, CORFIL *csd);
   uintptr_t  kperfThread(void * cs);
+  void    profile_init(CSOUND *);
 //void cs_init_math_constants_macros(CSOUND *csound, PRE_PARM *yyscanner);
 //void cs_init_omacros(CSOUND *csound, PRE_PARM*, NAMES *nn);
  void csoundInputMessageInternal(CSOUND *csound, const char *message);
@@ -527,14 +528,19 @@ PUBLIC int csoundStart(CSOUND *csound) // DEBUG
       int i;
       THREADINFO *current = NULL;
 
-      csp_barrier_alloc(csound, &(csound->barrier1), O->numThreads);
+      /* only used to start the workers; each k-cycle they are woken
+         through their own condition variable */
       csp_barrier_alloc(csound, &(csound->barrier2), O->numThreads);
 
       csound->multiThreadedComplete = 0;
+      csound->dag_gate = csoundCreateMutex(0);
+      csound->dag_done = csoundCreateCondVar();
 
       for (i = 1; i < O->numThreads; i++) {
         THREADINFO *t = csound->Malloc(csound, sizeof(THREADINFO));
 
+        t->wakeup = csoundCreateCondVar();
+        t->go = 0;
         t->threadId = csound->CreateThread(&kperfThread, (void *)csound);
         t->next = NULL;
 
@@ -549,6 +555,8 @@ PUBLIC int csoundStart(CSOUND *csound) // DEBUG
 
       csound->WaitBarrier(csound->barrier2);
     }
+    if (O->profile)
+      profile_init(csound);
     csound->engineStatus |= CS_STATE_COMP;
     if (csound->oparms->daemon > 1)
       csoundUDPServerStart(csound,csound->oparms->daemon);
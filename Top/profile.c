@@ -0,0 +1,273 @@
+/*
+    profile.c:
+
+    Copyright (C) 2026 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#include "csoundCore.h"
+#include "profile.h"
+#include <stdlib.h>
+
+#define PROFILE_SLOTS   256
+
+typedef struct {
+    PROFTAB       *tab;         /* one per performance thread */
+    int           ntabs;
+    uint64_t      tick0;        /* to convert ticks to seconds */
+    RTCLOCK       clk;
+    CS_PROFILE_ENTRY *out;      /* last csoundGetProfile() result */
+    PROFNODE      *merged;
+} PROFILE;
+
+static PROFSET *profile_set(CSOUND *csound, uint32_t mask)
+{
+    PROFSET *set = (PROFSET*) csound->Calloc(csound, sizeof(PROFSET) +
+                                             mask * sizeof(PROFNODE));
+    set->mask = mask;
+    return set;
+}
+
+void profile_init(CSOUND *csound)
+{
+    PROFILE *p;
+    char    *mem;
+    int     i;
+
+    if (csound->profile != NULL)
+      return;
+    p = (PROFILE*) csound->Calloc(csound, sizeof(PROFILE));
+    p->ntabs = (csound->oparms->numThreads > 1 ?
+                csound->oparms->numThreads : 1);
+    /* cache line aligned, so that workers never write to the same line */
+    mem = (char*) csound->Calloc(csound, (p->ntabs + 1) * sizeof(PROFTAB));
+    p->tab = (PROFTAB*) (mem + ((64 - ((uintptr_t) mem & 63)) & 63));
+    for (i = 0; i < p->ntabs; i++)
+      p->tab[i].set = profile_set(csound, PROFILE_SLOTS - 1);
+    csoundInitTimerStruct(&p->clk);
+    p->tick0 = profile_ticks();
+    csound->profile = (void*) p;
+}
+
+PROFTAB *profile_thread_tab(CSOUND *csound, int index)
+{
+    PROFILE *p = (PROFILE*) csound->profile;
+    return (index >= 0 && index < p->ntabs ? &p->tab[index] : NULL);
+}
+
+/* called by the owning thread only, for a pair not yet in the table */
+
+PROFNODE *profile_add(CSOUND *csound, PROFTAB *t,
+                      const OENTRY *ep, int32 insno)
+{
+    PROFSET   *set = t->set;
+    PROFNODE  *n;
+    uint32_t  h;
+
+    if ((t->count + 1) * 2 > set->mask + 1) {
+      PROFSET   *old = set;
+      uint32_t  i;
+      set = profile_set(csound, old->mask * 2 + 1);
+      for (i = 0; i <= old->mask; i++) {
+        if (old->node[i].op == NULL)
+          continue;
+        h = profile_hash(old->node[i].op, old->node[i].insno) & set->mask;
+        while (set->node[h].op != NULL)
+          h = (h + 1) & set->mask;
+        set->node[h] = old->node[i];
+      }
+      /* the old set is left to the reset: a reader may still hold it */
+      PROFILE_PUBLISH(t->set, set);
+    }
+    h = profile_hash(ep, insno) & set->mask;
+    while (set->node[h].op != NULL)
+      h = (h + 1) & set->mask;
+    n = &set->node[h];
+    n->insno = insno;
+    PROFILE_PUBLISH(n->op, ep);
+    t->count++;
+    return n;
+}
+
+static int profile_cmp(const void *a, const void *b)
+{
+    const PROFNODE *x = (const PROFNODE*) a, *y = (const PROFNODE*) b;
+    if (x->insno != y->insno)
+      return (x->insno < y->insno ? -1 : 1);
+    if (x->ticks != y->ticks)
+      return (x->ticks > y->ticks ? -1 : 1);
+    return strcmp(x->op->opname, y->op->opname);
+}
+
+static const char *profile_instr_name(CSOUND *csound, int32 insno)
+{
+    INSTRTXT **tp = csound->engineState.instrtxtp;
+    if (tp != NULL && insno >= 0 && insno <= csound->engineState.maxinsno &&
+        tp[insno] != NULL)
+      return tp[insno]->insname;
+    return NULL;
+}
+
+/* merge the thread tables into p->out: for each instrument its total,
+   followed by its opcodes, most expensive first.  This may run while
+   the threads add to their tables; each set is at most half full, so
+   sizing the merge by the sets, not the counts, always leaves room. */
+
+static int profile_collect(CSOUND *csound, PROFILE *p)
+{
+    uint32_t  i, size, mask, h, total = 0, nmerged = 0;
+    int       t, nout = 0;
+    double    secs, rate = 0.0;
+    PROFNODE  *m;
+    PROFSET   **sets;
+    CS_PROFILE_ENTRY *e = NULL;
+
+    sets = (PROFSET**) csound->Malloc(csound, p->ntabs * sizeof(PROFSET*));
+    for (t = 0; t < p->ntabs; t++) {
+      sets[t] = (PROFSET*) PROFILE_ACQUIRE(p->tab[t].set);
+      total += (sets[t]->mask + 1) / 2;
+    }
+    for (size = 16; size < total * 2; size <<= 1)
+      ;
+    mask = size - 1;
+    if (p->merged != NULL)
+      csound->Free(csound, p->merged);
+    m = p->merged = (PROFNODE*) csound->Calloc(csound, size * sizeof(PROFNODE));
+    for (t = 0; t < p->ntabs; t++) {
+      PROFSET *set = sets[t];
+      for (i = 0; i <= set->mask; i++) {
+        PROFNODE *n = &set->node[i];
+        const OENTRY *op = (const OENTRY*) PROFILE_ACQUIRE(n->op);
+        if (op == NULL)
+          continue;
+        h = profile_hash(op, n->insno) & mask;
+        while (m[h].op != NULL && (m[h].op != op || m[h].insno != n->insno))
+          h = (h + 1) & mask;
+        if (m[h].op == NULL) {
+          m[h].op = op;
+          m[h].insno = n->insno;
+          nmerged++;
+        }
+        m[h].calls += n->calls;
+        m[h].ticks += n->ticks;
+      }
+    }
+    csound->Free(csound, sets);
+    /* compact and sort by instrument */
+    for (i = h = 0; i < size; i++)
+      if (m[i].op != NULL)
+        m[h++] = m[i];
+    qsort(m, nmerged, sizeof(PROFNODE), profile_cmp);
+
+    secs = csoundGetRealTime(&p->clk);
+    if (secs > 0.0)
+      rate = (double) (profile_ticks() - p->tick0) / secs;
+    if (p->out != NULL)
+      csound->Free(csound, p->out);
+    /* at most one total per opcode entry, plus the terminator */
+    p->out = (CS_PROFILE_ENTRY*)
+      csound->Calloc(csound, (2 * nmerged + 1) * sizeof(CS_PROFILE_ENTRY));
+    for (i = 0; i < nmerged; i++) {
+      if (e == NULL || e->insno != m[i].insno) {
+        e = &p->out[nout++];
+        e->insno = m[i].insno;
+        e->instrName = profile_instr_name(csound, m[i].insno);
+        e->opname = NULL;
+      }
+      e->calls += m[i].calls;
+      e->ticks += m[i].ticks;
+      e->seconds = (rate > 0.0 ? (double) e->ticks / rate : 0.0);
+      p->out[nout].insno = m[i].insno;
+      p->out[nout].instrName = e->instrName;
+      p->out[nout].opname = m[i].op->opname;
+      p->out[nout].calls = m[i].calls;
+      p->out[nout].ticks = m[i].ticks;
+      p->out[nout].seconds = (rate > 0.0 ? (double) m[i].ticks / rate : 0.0);
+      nout++;
+    }
+    return nout;
+}
+
+PUBLIC int csoundGetProfile(CSOUND *csound, const CS_PROFILE_ENTRY **entries)
+{
+    int n;
+    if (csound->profile == NULL) {
+      if (entries != NULL)
+        *entries = NULL;
+      return -1;
+    }
+    csoundLockMutex(csound->API_lock);
+    n = profile_collect(csound, (PROFILE*) csound->profile);
+    if (entries != NULL)
+      *entries = ((PROFILE*) csound->profile)->out;
+    csoundUnlockMutex(csound->API_lock);
+    return n;
+}
+
+/* end of performance: instrument totals to the console, and the folded
+   stacks ("instr 1;oscili.kk 12345") for flamegraph.pl to --profile=FILE */
+
+void profile_report(CSOUND *csound)
+{
+    PROFILE *p = (PROFILE*) csound->profile;
+    const CS_PROFILE_ENTRY *e;
+    uint64_t total = 0;
+    int     i, n;
+    char    *fname = csound->oparms->profilename;
+
+    if (p == NULL)
+      return;
+    n = profile_collect(csound, p);
+    for (i = 0, e = p->out; i < n; i++, e++)
+      if (e->opname == NULL)
+        total += e->ticks;
+    csound->Message(csound, Str("opcode profile:\n"));
+    for (i = 0, e = p->out; i < n; i++, e++) {
+      if (e->opname != NULL)
+        continue;
+      if (e->instrName != NULL)
+        csound->Message(csound, "  instr %-16s", e->instrName);
+      else
+        csound->Message(csound, "  instr %-16d", (int) e->insno);
+      csound->Message(csound, Str(" %10.6f s  %5.1f%%\n"), e->seconds,
+                      total ? 100.0 * (double) e->ticks / (double) total : 0.0);
+    }
+    if (fname != NULL && *fname != '\0') {
+      FILE *f;
+      void *fd = csound->FileOpen2(csound, &f, CSFILE_STD, fname, "w", NULL,
+                                   CSFTYPE_OTHER_TEXT, 0);
+      if (UNLIKELY(fd == NULL)) {
+        csound->Warning(csound, Str("cannot open profile output file %s"),
+                        fname);
+        return;
+      }
+      for (i = 0, e = p->out; i < n; i++, e++) {
+        if (e->opname == NULL || e->ticks == 0)
+          continue;
+        if (e->instrName != NULL)
+          fprintf(f, "instr %s;%s %llu\n", e->instrName, e->opname,
+                  (unsigned long long) e->ticks);
+        else
+          fprintf(f, "instr %d;%s %llu\n", (int) e->insno, e->opname,
+                  (unsigned long long) e->ticks);
+      }
+      csound->FileClose(csound, fd);
+      csound->Message(csound, Str("profile written to %s\n"), fname);
+    }
+}
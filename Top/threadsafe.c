@@ -31,6 +31,7 @@
 
 int csoundKillInstanceInternal(CSOUND *csound, MYFLT instr, char *instrName,
                                int mode, int allow_release, int async);
+int csoundPreallocInstrInternal(CSOUND *csound, int insno, int count);
 int csoundCompileTreeInternal(CSOUND *csound, TREE *root, int async);
 int csoundCompileOrcInternal(CSOUND *csound, const char *str, int async);
 void merge_state(CSOUND *csound, ENGINE_STATE *engineState,
@@ -49,32 +50,44 @@ int csoundScoreEventAbsoluteInternal(CSOUND *csound, char type,
                                      double time_ofs);
 void set_channel_data_ptr(CSOUND *csound, const char *name,
                           void *ptr, int newSize);
+int hfgens_async(CSOUND *csound, const EVTBLK *evtblkp, int mode);
+int ftgen_ready(CSOUND *csound, int tableNum);
 
 enum {INPUT_MESSAGE=1, READ_SCORE, SCORE_EVENT, SCORE_EVENT_ABS,
       TABLE_COPY_OUT, TABLE_COPY_IN, TABLE_SET, MERGE_STATE, KILL_INSTANCE};
 
-/* MAX QUEUE SIZE */
+/* MAX QUEUE SIZE, a power of two */
 #define API_MAX_QUEUE 1024
+#define API_QUEUE_MASK (API_MAX_QUEUE-1)
 /* ARG LIST ALIGNMENT */
 #define ARG_ALIGN 8
-
-/* Message queue structure */
+/* bytes of args carried by each queue cell */
+#define API_MSG_ARGS 112
+/* larger args span consecutive cells, up to the whole queue */
+#define API_MSG_MAX (API_MSG_ARGS*API_MAX_QUEUE)
+
+/* Message queue structure: a bounded multi-producer ring (after
+   D. Vyukov).  The cell for position pos may be filled by the producer
+   that claimed pos when seq == pos, and is ready for the consumer when
+   seq == pos+1; the consumer hands it back to the next round by setting
+   seq to pos+API_MAX_QUEUE.  A message of ncells cells is published by
+   its first cell, after the others.  Producers never wait on each other
+   and the audio thread never blocks or allocates. */
 typedef struct _message_queue {
-  int64_t message;  /* message id */
-  char *args;   /* args, arg pointers */
-  int64_t rtn;  /* return value */
+  volatile long seq;  /* turn of this cell, see above */
+  int32_t message;    /* message id, 0 in continuation cells */
+  int32_t ncells;     /* cells taken by this message */
+  union {
+    char args[API_MSG_ARGS];
+    int64_t align;
+  } u;
 } message_queue_t;
 
+/* the consumer reassembles spanning messages after the ring */
+#define MSG_SCRATCH(csound) ((char *) ((csound)->msg_queue + API_MAX_QUEUE))
 
-/* atomicGetAndIncrementWithModulus */
-static long atomicGet_Incr_Mod(volatile long* val, long mod) {
-  volatile long oldVal, newVal;
-  do {
-    oldVal = *val;
-    newVal = (oldVal + 1) % mod;
-  } while (ATOMIC_CMP_XCH(val, newVal, oldVal));
-  return oldVal;
-}
+#define SEQ_DIFF(a, b) ((long) ((unsigned long) (a) - (unsigned long) (b)))
+#define SEQ_ADD(a, n) ((long) ((unsigned long) (a) + (unsigned long) (n)))
 
 /* called by csoundCreate() at the start
    and also by csoundStart() to cover de-allocation
@@ -83,44 +96,123 @@ static long atomicGet_Incr_Mod(volatile long* val, long mod) {
 void allocate_message_queue(CSOUND *csound) {
   if (csound->msg_queue == NULL) {
     int i;
-    csound->msg_queue = (message_queue_t **)
-      csound->Calloc(csound, sizeof(message_queue_t*)*API_MAX_QUEUE);
-    for (i = 0; i < API_MAX_QUEUE; i++) {
-      csound->msg_queue[i] =
-        (message_queue_t*)
-        csound->Calloc(csound, sizeof(message_queue_t));
-    }
+    csound->msg_queue = (message_queue_t *)
+      csound->Calloc(csound, sizeof(message_queue_t)*API_MAX_QUEUE
+                     + API_MSG_MAX);
+    for (i = 0; i < API_MAX_QUEUE; i++)
+      csound->msg_queue[i].seq = i;
+    csound->msg_queue_wput = 0;
+    csound->msg_queue_rget = 0;
   }
 }
 
+/* cells needed for a message of size bytes */
+static inline int message_cells(int size) {
+  return size <= API_MSG_ARGS ? 1 : (size + API_MSG_ARGS - 1) / API_MSG_ARGS;
+}
+
+/* Claim up to n consecutive cells, or all n or none if whole;
+   returns how many were claimed, starting at *ppos, or 0 if the
+   queue is full */
+static int message_claim(CSOUND *csound, int n, int whole, long *ppos) {
+  message_queue_t *q = csound->msg_queue;
+  long pos, seq;
+  if (n > API_MAX_QUEUE) n = API_MAX_QUEUE;
+  while (1) {
+    int k = n;
+    pos = ATOMIC_GET(csound->msg_queue_wput);
+    /* the consumer frees cells in order, so if the last one is free
+       so are those before it */
+    while (k > 0) {
+      seq = ATOMIC_GET(q[SEQ_ADD(pos, k-1) & API_QUEUE_MASK].seq);
+      if (SEQ_DIFF(seq, SEQ_ADD(pos, k-1)) == 0) break;
+      if (SEQ_DIFF(seq, SEQ_ADD(pos, k-1)) > 0) {
+        k = -1;               /* another producer got there first */
+        break;
+      }
+      k--;
+    }
+    if (k == 0 || (k > 0 && k < n && whole))
+      return 0;               /* full */
+    if (k > 0) {
+      long nxt = SEQ_ADD(pos, k);
+      if (!ATOMIC_CMP_XCH(&csound->msg_queue_wput, nxt, pos)) {
+        *ppos = pos;
+        return k;
+      }
+    }
+  }
+}
 
-/* enqueue should be called by the relevant API function */
-void *message_enqueue(CSOUND *csound, int32_t message, char *args,
-                      int argsiz) {
-  if(csound->msg_queue != NULL) {
-    int64_t *rtn;
-    volatile long items;
-
-    /* block if queue is full */
-    do {
-      items = ATOMIC_GET(csound->msg_queue_items);
-    } while(items >= API_MAX_QUEUE);
-
-    message_queue_t* msg =
-      csound->msg_queue[atomicGet_Incr_Mod(&csound->msg_queue_wget,
-                                           API_MAX_QUEUE)];
-    msg->message = message;
-    if(msg->args != NULL)
-      csound->Free(csound, msg->args);
-    msg->args = (char *)csound->Calloc(csound, argsiz);
-    memcpy(msg->args, args, argsiz);
-    rtn = &msg->rtn;
-    csound->msg_queue[atomicGet_Incr_Mod(&csound->msg_queue_wput,
-                                         API_MAX_QUEUE)] = msg;
-    ATOMIC_INCR(csound->msg_queue_items);
-    return (void *) rtn;
+/* Fill the message_cells(argsiz+extrasiz) cells claimed at pos with
+   args followed by extra, and pass them to the consumer */
+static void message_fill(CSOUND *csound, long pos, int32_t message,
+                         const char *args, int argsiz,
+                         const void *extra, int extrasiz) {
+  int i, ncells = message_cells(argsiz + extrasiz);
+  for (i = 0; i < ncells; i++) {
+    message_queue_t *msg = &csound->msg_queue[SEQ_ADD(pos, i) & API_QUEUE_MASK];
+    int off = i*API_MSG_ARGS, end = off + API_MSG_ARGS, n;
+    msg->message = i == 0 ? message : 0;
+    msg->ncells = ncells;
+    if (off < argsiz) {
+      n = (end < argsiz ? end : argsiz) - off;
+      memcpy(msg->u.args, args + off, n);
+    }
+    if (end > argsiz && extrasiz > 0) {
+      int xoff = off > argsiz ? off - argsiz : 0;
+      n = (end < argsiz + extrasiz ? end : argsiz + extrasiz) - argsiz - xoff;
+      if (n > 0)
+        memcpy(msg->u.args + (off < argsiz ? argsiz - off : 0),
+               (const char *) extra + xoff, n);
+    }
+    if (i > 0)
+      ATOMIC_SET(msg->seq, SEQ_ADD(pos, i+1));
+  }
+  ATOMIC_SET(csound->msg_queue[pos & API_QUEUE_MASK].seq, SEQ_ADD(pos, 1));
+}
+
+/* enqueue should be called by the relevant API function; the message
+   is args followed by extrasiz bytes of extra.  If the queue is full
+   this waits for the performance thread to make room, unless trying
+   only, in which case CSOUND_ERROR is returned and nothing is queued.
+   Messages larger than the whole queue are refused.  Otherwise
+   returns the number of cells still free. */
+static int message_enqueue_(CSOUND *csound, int32_t message,
+                            const char *args, int argsiz,
+                            const void *extra, int extrasiz, int try_only) {
+  long pos;
+  int ncells;
+  if (UNLIKELY(csound->msg_queue == NULL))
+    return CSOUND_ERROR;
+  if (UNLIKELY(extrasiz < 0 || argsiz + extrasiz > API_MSG_MAX)) {
+    csound->Warning(csound, Str("API message of %d bytes is too large, "
+                                "not queued\n"), argsiz + extrasiz);
+    return CSOUND_ERROR;
   }
-  else return NULL;
+  ncells = message_cells(argsiz + extrasiz);
+  if (message_claim(csound, ncells, 1, &pos) == 0) {
+    if (try_only)
+      return CSOUND_ERROR;
+    /* register first, so that the consumer's notification cannot be
+       missed between the failed claim and the wait */
+    ATOMIC_INCR(csound->msg_queue_waiters);
+    while (message_claim(csound, ncells, 1, &pos) == 0)
+      csoundWaitThreadLockNoTimeout(csound->msg_queue_space);
+    /* the monitor wakes one waiter: pass it on to the next */
+    ATOMIC_DECR(csound->msg_queue_waiters);
+    if (ATOMIC_GET(csound->msg_queue_waiters) > 0)
+      csoundNotifyThreadLock(csound->msg_queue_space);
+  }
+  message_fill(csound, pos, message, args, argsiz, extra, extrasiz);
+  return (int) (API_MAX_QUEUE -
+                SEQ_DIFF(ATOMIC_GET(csound->msg_queue_wput),
+                         ATOMIC_GET(csound->msg_queue_rget)));
+}
+
+static inline int message_enqueue(CSOUND *csound, int32_t message,
+                                  const char *args, int argsiz) {
+  return message_enqueue_(csound, message, args, argsiz, NULL, 0, 0);
 }
 
 /* dequeue should be called by kperf_*()
@@ -128,64 +220,74 @@ void *message_enqueue(CSOUND *csound, int32_t message, char *args,
 */
 void message_dequeue(CSOUND *csound) {
   if(csound->msg_queue != NULL) {
-    long rp = csound->msg_queue_rstart;
-    long items = csound->msg_queue_items;
-    long rend = rp + items;
-
-    while(rp < rend) {
-      message_queue_t* msg = csound->msg_queue[rp % API_MAX_QUEUE];
+    long rp = csound->msg_queue_rget;
+    int i, n, ncells;
+
+    /* at most one round, so that busy producers cannot hold us here */
+    for (n = 0; n < API_MAX_QUEUE; n += ncells) {
+      message_queue_t* msg = &csound->msg_queue[rp & API_QUEUE_MASK];
+      char *args;
+      if (SEQ_DIFF(ATOMIC_GET(msg->seq), SEQ_ADD(rp, 1)) != 0)
+        break;                  /* empty, or not yet filled */
+      ncells = msg->ncells;
+      args = msg->u.args;
+      if (ncells > 1) {
+        /* the first cell is published last, so the rest are ready */
+        args = MSG_SCRATCH(csound);
+        for (i = 0; i < ncells; i++)
+          memcpy(args + i*API_MSG_ARGS,
+                 csound->msg_queue[SEQ_ADD(rp, i) & API_QUEUE_MASK].u.args,
+                 API_MSG_ARGS);
+      }
       switch(msg->message) {
       case INPUT_MESSAGE:
         {
-          const char *str = msg->args;
+          const char *str = args;
           csoundInputMessageInternal(csound, str);
         }
 
         break;
       case READ_SCORE:
         {
-          const char *str = msg->args;
+          const char *str = args;
           csoundReadScoreInternal(csound, str);
         }
         break;
       case SCORE_EVENT:
         {
           char type;
-          const MYFLT *pfields;
           long numFields;
-          type = msg->args[0];
-          memcpy(&pfields, msg->args + ARG_ALIGN,
-                 sizeof(MYFLT *));
-          memcpy(&numFields, msg->args + ARG_ALIGN*2,
+          type = args[0];
+          memcpy(&numFields, args + ARG_ALIGN,
                  sizeof(long));
 
-          csoundScoreEventInternal(csound, type, pfields, numFields);
+          csoundScoreEventInternal(csound, type,
+                                   (const MYFLT *) (args + ARG_ALIGN*2),
+                                   numFields);
         }
         break;
       case SCORE_EVENT_ABS:
         {
           char type;
-          const MYFLT *pfields;
           long numFields;
           double ofs;
-          type = msg->args[0];
-          memcpy(&pfields, msg->args + ARG_ALIGN,
-                 sizeof(MYFLT *));
-          memcpy(&numFields, msg->args + ARG_ALIGN*2,
+          type = args[0];
+          memcpy(&numFields, args + ARG_ALIGN,
                  sizeof(long));
-          memcpy(&ofs, msg->args + ARG_ALIGN*3,
+          memcpy(&ofs, args + ARG_ALIGN*2,
                  sizeof(double));
 
-          csoundScoreEventAbsoluteInternal(csound, type, pfields, numFields,
-                                             ofs);
+          csoundScoreEventAbsoluteInternal(csound, type,
+                                           (const MYFLT *) (args + ARG_ALIGN*3),
+                                           numFields, ofs);
         }
         break;
       case TABLE_COPY_OUT:
         {
           int table;
           MYFLT *ptable;
-          memcpy(&table, msg->args, sizeof(int));
-          memcpy(&ptable, msg->args + ARG_ALIGN,
+          memcpy(&table, args, sizeof(int));
+          memcpy(&ptable, args + ARG_ALIGN,
                  sizeof(MYFLT *));
           csoundTableCopyOutInternal(csound, table, ptable);
         }
@@ -194,8 +296,8 @@ void message_dequeue(CSOUND *csound) {
         {
           int table;
           MYFLT *ptable;
-          memcpy(&table, msg->args, sizeof(int));
-          memcpy(&ptable, msg->args + ARG_ALIGN,
+          memcpy(&table, args, sizeof(int));
+          memcpy(&ptable, args + ARG_ALIGN,
                  sizeof(MYFLT *));
           csoundTableCopyInInternal(csound, table, ptable);
         }
@@ -204,10 +306,10 @@ void message_dequeue(CSOUND *csound) {
         {
           int table, index;
           MYFLT value;
-          memcpy(&table, msg->args, sizeof(int));
-          memcpy(&index, msg->args + ARG_ALIGN,
+          memcpy(&table, args, sizeof(int));
+          memcpy(&index, args + ARG_ALIGN,
                  sizeof(int));
-          memcpy(&value, msg->args + 2*ARG_ALIGN,
+          memcpy(&value, args + 2*ARG_ALIGN,
                  sizeof(MYFLT));
           csoundTableSetInternal(csound, table, index, value);
         }
@@ -217,10 +319,10 @@ void message_dequeue(CSOUND *csound) {
           ENGINE_STATE *e;
           TYPE_TABLE *t;
           OPDS *ids;
-          memcpy(&e, msg->args, sizeof(ENGINE_STATE *));
-          memcpy(&t, msg->args + ARG_ALIGN,
+          memcpy(&e, args, sizeof(ENGINE_STATE *));
+          memcpy(&t, args + ARG_ALIGN,
                  sizeof(TYPE_TABLE *));
-          memcpy(&ids, msg->args + 2*ARG_ALIGN,
+          memcpy(&ids, args + 2*ARG_ALIGN,
                  sizeof(OPDS *));
           merge_state(csound, e, t, ids);
         }
@@ -230,34 +332,43 @@ void message_dequeue(CSOUND *csound) {
           MYFLT instr;
           int mode, insno, rls;
           INSDS *ip;
-          memcpy(&instr, msg->args, sizeof(MYFLT));
-          memcpy(&insno, msg->args + ARG_ALIGN,
+          memcpy(&instr, args, sizeof(MYFLT));
+          memcpy(&insno, args + ARG_ALIGN,
                  sizeof(int));
-          memcpy(&ip, msg->args + ARG_ALIGN*2,
+          memcpy(&ip, args + ARG_ALIGN*2,
                  sizeof(INSDS *));
-          memcpy(&mode, msg->args + ARG_ALIGN*3,
+          memcpy(&mode, args + ARG_ALIGN*3,
                  sizeof(int));
-          memcpy(&rls, msg->args  + ARG_ALIGN*4,
+          memcpy(&rls, args  + ARG_ALIGN*4,
                  sizeof(int));
           killInstance(csound, instr, insno, ip, mode, rls);
         }
         break;
       }
       msg->message = 0;
-      rp += 1;
+      /* hand the cells on to the next round of producers */
+      for (i = 0; i < ncells; i++) {
+        ATOMIC_SET(csound->msg_queue[rp & API_QUEUE_MASK].seq,
+                   SEQ_ADD(rp, API_MAX_QUEUE));
+        rp = SEQ_ADD(rp, 1);
+      }
+    }
+    if (rp != csound->msg_queue_rget) {
+      ATOMIC_SET(csound->msg_queue_rget, rp);
+      if (ATOMIC_GET(csound->msg_queue_waiters) > 0)
+        csoundNotifyThreadLock(csound->msg_queue_space);
     }
-    ATOMIC_SUB(csound->msg_queue_items, items);
-    csound->msg_queue_rstart = rp % API_MAX_QUEUE;
   }
 }
 
 /* these are the message enqueueing functions for each relevant API function */
-static inline void csoundInputMessage_enqueue(CSOUND *csound,
-                                              const char *str){
-  message_enqueue(csound,INPUT_MESSAGE, (char *) str, strlen(str)+1);
+static inline int csoundInputMessage_enqueue(CSOUND *csound,
+                                             const char *str, int try_only){
+  return message_enqueue_(csound, INPUT_MESSAGE, str, strlen(str)+1,
+                          NULL, 0, try_only);
 }
 
-static inline int64_t *csoundReadScore_enqueue(CSOUND *csound, const char *str){
+static inline int csoundReadScore_enqueue(CSOUND *csound, const char *str){
   return message_enqueue(csound, READ_SCORE, (char *) str, strlen(str)+1);
 }
 
@@ -290,32 +401,33 @@ static inline void csoundTableSet_enqueue(CSOUND *csound, int table, int index,
   message_enqueue(csound,TABLE_SET, args, argsize);
 }
 
-
-static inline int64_t *csoundScoreEvent_enqueue(CSOUND *csound, char type,
-                                                const MYFLT *pfields,
-                                                long numFields)
+/* the p-fields are copied into the message, so the caller's array
+   need not outlive the call */
+static inline int csoundScoreEvent_enqueue(CSOUND *csound, char type,
+                                           const MYFLT *pfields,
+                                           long numFields, int try_only)
 {
-  const int argsize = ARG_ALIGN*3;
-  char args[ARG_ALIGN*3];
+  const int argsize = ARG_ALIGN*2;
+  char args[ARG_ALIGN*2];
   args[0] = type;
-  memcpy(args+ARG_ALIGN, &pfields, sizeof(MYFLT *));
-  memcpy(args+2*ARG_ALIGN, &numFields, sizeof(long));
-  return message_enqueue(csound,SCORE_EVENT, args, argsize);
+  memcpy(args+ARG_ALIGN, &numFields, sizeof(long));
+  return message_enqueue_(csound, SCORE_EVENT, args, argsize,
+                          pfields, (int) (numFields*sizeof(MYFLT)), try_only);
 }
 
 
-static inline int64_t *csoundScoreEventAbsolute_enqueue(CSOUND *csound, char type,
-                                                        const MYFLT *pfields,
-                                                        long numFields,
-                                                        double time_ofs)
+static inline int csoundScoreEventAbsolute_enqueue(CSOUND *csound, char type,
+                                                   const MYFLT *pfields,
+                                                   long numFields,
+                                                   double time_ofs)
 {
-  const int argsize = ARG_ALIGN*4;
-  char args[ARG_ALIGN*4];
+  const int argsize = ARG_ALIGN*3;
+  char args[ARG_ALIGN*3];
   args[0] = type;
-  memcpy(args+ARG_ALIGN, &pfields, sizeof(MYFLT *));
-  memcpy(args+2*ARG_ALIGN, &numFields, sizeof(long));
-  memcpy(args+3*ARG_ALIGN, &time_ofs, sizeof(double));
-  return message_enqueue(csound,SCORE_EVENT_ABS, args, argsize);
+  memcpy(args+ARG_ALIGN, &numFields, sizeof(long));
+  memcpy(args+2*ARG_ALIGN, &time_ofs, sizeof(double));
+  return message_enqueue_(csound, SCORE_EVENT_ABS, args, argsize,
+                          pfields, (int) (numFields*sizeof(MYFLT)), 0);
 }
 
 /* this is to be called from
@@ -326,7 +438,7 @@ void killInstance_enqueue(CSOUND *csound, MYFLT instr, int insno,
                           int allow_release) {
   const int argsize = ARG_ALIGN*5;
   char args[ARG_ALIGN*5];
-  memcpy(args, &instr, sizeof(int));
+  memcpy(args, &instr, sizeof(MYFLT));
   memcpy(args+ARG_ALIGN, &insno, sizeof(int));
   memcpy(args+ARG_ALIGN*2, &ip, sizeof(INSDS *));
   memcpy(args+ARG_ALIGN*3, &mode, sizeof(int));
@@ -405,6 +517,39 @@ int csoundScoreEventAbsolute(CSOUND *csound, char type,
   return OK;
 }
 
+int csoundTableGenAsync(CSOUND *csound, const MYFLT *pfields, long numFields,
+                        const char *strarg)
+{
+  EVTBLK  evt;
+  int     i, ret;
+
+  if (UNLIKELY(numFields < 5 || numFields >= PMAX))
+    return CSOUND_ERROR;
+  memset(&evt, 0, sizeof(EVTBLK));
+  evt.opcod = 'f';
+  evt.pcnt = (int16) numFields;
+  for (i = 0; i < (int) numFields; i++)
+    evt.p[i + 1] = pfields[i];
+  evt.p[2] = FL(0.0);
+  if (strarg != NULL) {
+    evt.strarg = (char*) strarg;
+    evt.p[5] = SSTRCOD;
+  }
+  csoundLockMutex(csound->API_lock);
+  ret = hfgens_async(csound, &evt, 1);
+  csoundUnlockMutex(csound->API_lock);
+  return (ret < 0 ? CSOUND_ERROR : ret);
+}
+
+int csoundTableReady(CSOUND *csound, int tableNum)
+{
+  int ret;
+  csoundLockMutex(csound->API_lock);
+  ret = ftgen_ready(csound, tableNum);
+  csoundUnlockMutex(csound->API_lock);
+  return ret;
+}
+
 int csoundKillInstance(CSOUND *csound, MYFLT instr, char *instrName,
                        int mode, int allow_release){
   int async = 0;
@@ -412,6 +557,14 @@ int csoundKillInstance(CSOUND *csound, MYFLT instr, char *instrName,
                                     allow_release, async);
 }
 
+int csoundPreallocInstr(CSOUND *csound, int insno, int count){
+  int res;
+  csoundLockMutex(csound->API_lock);
+  res = csoundPreallocInstrInternal(csound, insno, count);
+  csoundUnlockMutex(csound->API_lock);
+  return res;
+}
+
 int csoundCompileTree(CSOUND *csound, TREE *root) {
   int async = 0;
   return csoundCompileTreeInternal(csound, root, async);
@@ -445,7 +598,11 @@ MYFLT csoundEvalCode(CSOUND *csound, const char *str)
     To be removed once everything is made async
 */
 void csoundInputMessageAsync(CSOUND *csound, const char *message){
-  csoundInputMessage_enqueue(csound, message);
+  csoundInputMessage_enqueue(csound, message, 0);
+}
+
+int csoundTryInputMessageAsync(CSOUND *csound, const char *message){
+  return csoundInputMessage_enqueue(csound, message, 1);
 }
 
 void csoundReadScoreAsync(CSOUND *csound, const char *message){
@@ -468,7 +625,45 @@ void csoundTableSetAsync(CSOUND *csound, int table, int index, MYFLT value)
 void csoundScoreEventAsync(CSOUND *csound, char type,
                            const MYFLT *pfields, long numFields)
 {
-  csoundScoreEvent_enqueue(csound, type, pfields, numFields);
+  csoundScoreEvent_enqueue(csound, type, pfields, numFields, 0);
+}
+
+int csoundTryScoreEventAsync(CSOUND *csound, char type,
+                             const MYFLT *pfields, long numFields)
+{
+  return csoundScoreEvent_enqueue(csound, type, pfields, numFields, 1);
+}
+
+int csoundScoreEventBatchAsync(CSOUND *csound, char type,
+                               const MYFLT *pfields, long numFields,
+                               int numEvents)
+{
+  const int argsize = ARG_ALIGN*2;
+  const int extrasiz = (int) (numFields*sizeof(MYFLT));
+  char args[ARG_ALIGN*2];
+  long pos;
+  int i, n, ncells;
+  if (UNLIKELY(csound->msg_queue == NULL || numEvents <= 0 ||
+               numFields < 0 || argsize + extrasiz > API_MSG_MAX))
+    return 0;
+  args[0] = type;
+  memcpy(args+ARG_ALIGN, &numFields, sizeof(long));
+  ncells = message_cells(argsize + extrasiz);
+  if (ncells == 1) {
+    /* all of the events that fit go in with a single claim */
+    n = message_claim(csound, numEvents, 0, &pos);
+    for (i = 0; i < n; i++)
+      message_fill(csound, SEQ_ADD(pos, i), SCORE_EVENT, args, argsize,
+                   pfields + i*numFields, extrasiz);
+    return n;
+  }
+  for (n = 0; n < numEvents; n++) {
+    if (message_claim(csound, ncells, 1, &pos) == 0)
+      break;
+    message_fill(csound, pos, SCORE_EVENT, args, argsize,
+                 pfields + n*numFields, extrasiz);
+  }
+  return n;
 }
 
 void csoundScoreEventAbsoluteAsync(CSOUND *csound, char type,
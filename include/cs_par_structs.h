@@ -55,16 +55,58 @@ enum state { WAITING = 3,          /* Dependencies have not been finished */
 
 typedef struct _stateWithPadding {
   enum state s;
-  uint8_t padding [(CONCURRENTPADDING - sizeof(enum state)) / sizeof(uint8_t)];
+  int deps;                        /* Number of prerequisite tasks */
+  int pending;                     /* Prerequisites not yet completed */
+  uint8_t padding [(CONCURRENTPADDING -
+                    (sizeof(enum state) + 2*sizeof(int))) / sizeof(uint8_t)];
 } stateWithPadding;
 
-/* Sets of prerequiste tasks for each task */
-typedef struct _watchList {
-  taskID id;
-  struct _watchList *next;
-  uint8_t padding [(CONCURRENTPADDING -
-                    (sizeof(taskID) +
-                     sizeof(struct _watchList *))) / sizeof(uint8_t)];
-} watchList;
+/* A dependency between two tasks, kept on two doubly linked lists:
+ * the dependants of 'from' and the prerequisites of 'to'.  Edges are
+ * indices into a pool so that the pool can grow.
+ */
+typedef struct _dagEdge {
+  taskID from, to;
+  int next_out, prev_out;
+  int next_in, prev_in;
+} dagEdge;
+
+/* Bookkeeping for one task slot; slots stay with an instance for as
+ * long as it is active, so notes can be added and removed without
+ * renumbering the others.
+ */
+typedef struct _dagNode {
+  int first_out;                  /* edges to tasks depending on this */
+  int first_in;                   /* edges from tasks this depends on */
+  int seen;                       /* last update that found it active */
+  int level;                      /* depth in the DAG */
+} dagNode;
+
+/* Per-thread double-ended queue of runnable tasks.  The owning thread
+ * pushes and pops at the bottom, idle threads steal from the top.
+ * Every task is pushed at most once per k-cycle so the array never
+ * wraps; top and bottom are reset when the DAG is reinitialised.
+ */
+typedef struct _taskDeque {
+  volatile int top;
+  uint8_t padding1 [(CONCURRENTPADDING - sizeof(int)) / sizeof(uint8_t)];
+  volatile int bottom;
+  uint8_t padding2 [(CONCURRENTPADDING - sizeof(int)) / sizeof(uint8_t)];
+  taskID *tasks;
+  uint8_t padding3 [(CONCURRENTPADDING - sizeof(taskID *)) / sizeof(uint8_t)];
+} taskDeque;
+
+/* Counter shared by all threads, kept on its own cache line */
+typedef struct _counterWithPadding {
+  volatile int n;
+  uint8_t padding [(CONCURRENTPADDING - sizeof(int)) / sizeof(uint8_t)];
+} counterWithPadding;
+
+/* How the parallel k-cycles were run; only written by the main thread */
+typedef struct _dagStats {
+  uint64_t inline_cycles;     /* DAG too small or too narrow: no workers */
+  uint64_t parallel_cycles;   /* some workers were woken */
+  uint64_t workers_woken;     /* total over all parallel cycles */
+} dagStats;
 
 #endif
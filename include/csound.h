@@ -523,6 +523,20 @@ extern "C" {
     int isOutput;
   } CS_AUDIODEVICE;
 
+  /**
+   * Soundfile output statistics, see csoundGetSoundfileWriteStats()
+   */
+  typedef struct {
+    uint32_t buffers;         /* writer thread buffers, 0 if synchronous */
+    uint32_t depth;           /* buffers queued now */
+    uint32_t max_depth;       /* most buffers ever queued */
+    uint32_t stalls;          /* times the performance waited for a buffer */
+    uint32_t header_rewrites; /* -R header updates done */
+    uint64_t blocks_written;
+    double   stall_time;      /* total seconds spent in those waits */
+    double   max_write_time;  /* longest single write, in seconds */
+  } CS_SFWRITE_STATS;
+
   typedef struct {
     char device_name[64];
     char interface_name[64];
@@ -564,6 +578,48 @@ extern "C" {
     int         flags;
   } opcodeListEntry;
 
+  /** Memory allocator counters, see csoundGetMemoryStats() */
+  typedef struct {
+    /** bytes currently allocated with csound->Malloc() and friends */
+    int64_t     bytes_live;
+    uint64_t    allocs;
+    uint64_t    frees;
+    /** allocations per second since the previous call */
+    double      allocs_per_second;
+    /** times a thread found the memory lock already taken */
+    uint64_t    lock_waits;
+    /** small block arenas, one per running thread that allocates, plus
+        those of exited threads whose blocks are not all freed yet */
+    int         arenas;
+  } CSOUND_MEMORY_STATS;
+
+  /** Streaming diskin2 counters, see csoundGetDiskinStats() */
+  typedef struct {
+    /** files being streamed, and the threads reading them */
+    int         streams;
+    int         threads;
+    /** blocks read by the threads */
+    uint64_t    requests;
+    /** k-cycles on which a stream had fewer frames than it needed */
+    uint64_t    underruns;
+    /** seconds from a block being requested to its read starting */
+    double      latency_mean;
+    double      latency_max;
+  } CSOUND_DISKIN_STATS;
+
+  /** One row of csoundGetProfile() */
+  typedef struct {
+    /** instrument number, and its name or NULL */
+    int         insno;
+    const char  *instrName;
+    /** opcode (with its type suffix); NULL for the instrument total */
+    const char  *opname;
+    uint64_t    calls;
+    /** time stamp counter ticks spent in the opcode */
+    uint64_t    ticks;
+    double      seconds;
+  } CS_PROFILE_ENTRY;
+
   typedef struct CsoundRandMTState_ {
     int         mti;
     uint32_t    mt[624];
@@ -1112,6 +1168,19 @@ extern "C" {
   PUBLIC void csoundGetOutputFormat(CSOUND *csound,char *type,
                                     char *format);
 
+  /**
+   *  Fills 'stats' with the soundfile output statistics of the current
+   *  or last performance. With --write-buffers=N (N > 1), output files
+   *  are written by a separate thread through N buffers, and the
+   *  performance only waits when all of them are queued; depth, stalls
+   *  and stall_time show how close the disk came to holding it up.
+   *  The figures are updated while the performance runs and may be
+   *  slightly behind. Returns CSOUND_SUCCESS, or CSOUND_ERROR if
+   *  'stats' is NULL.
+   */
+  PUBLIC int csoundGetSoundfileWriteStats(CSOUND *csound,
+                                          CS_SFWRITE_STATS *stats);
+
   /**
    *  Set input source
    */
@@ -1756,6 +1825,40 @@ extern "C" {
   PUBLIC void csoundSetControlChannel(CSOUND *csound,
                                       const char *name, MYFLT val);
 
+  /**
+   * Returns a handle for the channel called 'name', creating it first
+   * if it does not exist yet ('type' as for csoundGetChannelPtr()), or
+   * NULL if the name is invalid or a channel of another type exists.
+   * The handle stays valid until Csound is reset or destroyed, and lets
+   * the calls below skip the name lookup.
+   */
+  PUBLIC void *csoundGetChannelHandle(CSOUND *, const char *name, int type);
+
+  /**
+   * retrieves the value of the control channel with the given handle
+   */
+  PUBLIC MYFLT csoundGetControlChannelByHandle(CSOUND *csound, void *handle);
+
+  /**
+   * sets the value of the control channel with the given handle
+   */
+  PUBLIC void csoundSetControlChannelByHandle(CSOUND *csound,
+                                              void *handle, MYFLT val);
+
+  /**
+   * retrieves the values of n control channels, values[i] being read
+   * from the channel with handle handles[i]
+   */
+  PUBLIC void csoundGetControlChannels(CSOUND *csound, void *const *handles,
+                                       MYFLT *values, int n);
+
+  /**
+   * sets the values of n control channels, the channel with handle
+   * handles[i] receiving values[i]
+   */
+  PUBLIC void csoundSetControlChannels(CSOUND *csound, void *const *handles,
+                                       const MYFLT *values, int n);
+
   /**
    * copies the audio channel identified by *name into array
    * *samples which should contain enough memory for ksmps MYFLTs
@@ -1839,6 +1942,25 @@ extern "C" {
   PUBLIC void csoundScoreEventAsync(CSOUND *,
                               char type, const MYFLT *pFields, long numFields);
 
+  /**
+   *  Like csoundScoreEventAsync(), but never waits: if the message queue
+   *  is full the event is dropped and CSOUND_ERROR is returned, otherwise
+   *  the number of queue slots still free. The p-fields are copied, so
+   *  pFields may be reused as soon as the call returns.
+   */
+  PUBLIC int csoundTryScoreEventAsync(CSOUND *,
+                              char type, const MYFLT *pFields, long numFields);
+
+  /**
+   *  Queues numEvents score events of the same type and length in one go;
+   *  pFields holds numEvents*numFields values, one event after another.
+   *  Does not wait: returns the number of events queued, which is less
+   *  than numEvents if the message queue fills up.
+   */
+  PUBLIC int csoundScoreEventBatchAsync(CSOUND *, char type,
+                                        const MYFLT *pFields, long numFields,
+                                        int numEvents);
+
   /**
    * Like csoundScoreEvent(), this function inserts a score event, but
    * at absolute time with respect to the start of performance, or from an
@@ -1860,9 +1982,18 @@ extern "C" {
 
   /**
    * Asynchronous version of csoundInputMessage().
+   * Messages that would not fit in the whole message queue (112 kB)
+   * are refused with a warning.
    */
   PUBLIC void csoundInputMessageAsync(CSOUND *, const char *message);
 
+  /**
+   * Like csoundInputMessageAsync(), but returns CSOUND_ERROR instead of
+   * waiting if the message queue is full, otherwise the number of
+   * queue slots still free.
+   */
+  PUBLIC int csoundTryInputMessageAsync(CSOUND *, const char *message);
+
   /**
    * Kills off one or more running instances of an instrument identified
    * by instr (number) or instrName (name). If instrName is NULL, the
@@ -1876,6 +2007,15 @@ extern "C" {
   PUBLIC int csoundKillInstance(CSOUND *csound, MYFLT instr,
                                 char *instrName, int mode, int allow_release);
 
+  /**
+   * Keeps at least count instances (voices) of instrument insno allocated
+   * in one contiguous block, like the prealloc opcode. These are set up
+   * now and reused by later notes without further memory allocation, and
+   * are only freed when the instrument is replaced or deleted.
+   * Returns CSOUND_SUCCESS, or CSOUND_ERROR if the instrument does not exist.
+   */
+  PUBLIC int csoundPreallocInstr(CSOUND *csound, int insno, int count);
+
 
   /**
    * Register a function to be called once in every control period
@@ -2015,6 +2155,27 @@ extern "C" {
    */
   PUBLIC int csoundGetTableArgs(CSOUND *csound, MYFLT **argsPtr, int tableNum);
 
+  /**
+   * Generates a function table on a separate thread, so that a large
+   * GEN does not hold up the performance.  pfields holds the fields of
+   * an f statement from p1 on (at least five); a zero table number
+   * selects a free one.  If strarg is not NULL, it is the string
+   * argument (p5), for instance the file name for GEN01.
+   * The table is only added to the list once it is complete, at the
+   * start of the next k-cycle; use csoundTableReady() to find out when.
+   * Returns the table number, or CSOUND_ERROR.
+   */
+  PUBLIC int csoundTableGenAsync(CSOUND *, const MYFLT *pfields,
+                                 long numFields, const char *strarg);
+
+  /**
+   * Returns 1 if function table 'tableNum' exists and is complete,
+   * 0 while csoundTableGenAsync() is still generating it or it has not
+   * yet been added, and -1 if it does not exist (or its GEN failed).
+   * It may be called from any thread.
+   */
+  PUBLIC int csoundTableReady(CSOUND *, int tableNum);
+
   /**
    * Checks if a given GEN number num is a named GEN
    * if so, it returns the string length (excluding terminating NULL char)
@@ -2336,6 +2497,30 @@ extern "C" {
    */
   PUBLIC double csoundGetCPUTime(RTCLOCK *);
 
+  /**
+   * Fill 'stats' with the counters of the memory allocator of this
+   * instance.  The counters restart when the instance is reset.
+   */
+  PUBLIC void csoundGetMemoryStats(CSOUND *, CSOUND_MEMORY_STATS *stats);
+
+  /**
+   * Read the opcode profile collected with the --profile option.
+   * Sets *entries to an array of rows, sorted by instrument number:
+   * the total of each instrument (opname NULL) followed by its opcodes,
+   * most expensive first.  The array is valid until the next call or
+   * csoundReset().  Returns the number of rows, or -1 if profiling is
+   * not enabled.  Opcodes inside a UDO count towards the UDO itself.
+   */
+  PUBLIC int csoundGetProfile(CSOUND *, const CS_PROFILE_ENTRY **entries);
+
+  /**
+   * Fill 'stats' with the counters of the threads that stream
+   * diskin2 files in realtime mode (see --diskin-threads).  Returns -1,
+   * with 'stats' zeroed, if no file has been streamed since the last
+   * reset.
+   */
+  PUBLIC int csoundGetDiskinStats(CSOUND *, CSOUND_DISKIN_STATS *stats);
+
   /**
    * Return a 32-bit unsigned integer to be used as seed from current time.
    */
@@ -2470,7 +2655,9 @@ extern "C" {
 
   /**
    * Create circular buffer with numelem number of elements. The
-   * element's size is set from elemsize. It should be used like:
+   * element's size is set from elemsize. The buffer holds at most
+   * numelem-1 items and is safe for one reader and one writer thread
+   * working at the same time. It should be used like:
    *@code
    * void *rb = csoundCreateCircularBuffer(csound, 1024, sizeof(MYFLT));
    *@endcode
@@ -2513,13 +2700,49 @@ extern "C" {
   PUBLIC int csoundWriteCircularBuffer(CSOUND *csound, void *p,
                                        const void *inp, int items);
   /**
-   * Empty circular buffer of any remaining data. This function should only be
-   * used if there is no reader actively getting data from the buffer.
+   * Empty circular buffer of any remaining data. It may be called from
+   * the writing side: the items written so far are dropped the next time
+   * the reader reads, peeks or reserves, and the read position is only
+   * ever moved by the reader. Only one thread should flush at a time.
    * @param csound This value is currently ignored.
    * @param p pointer to an existing circular buffer
    */
   PUBLIC void csoundFlushCircularBuffer(CSOUND *csound, void *p);
 
+  /**
+   * Zero-copy read from circular buffer: stores in *data a pointer to
+   * the oldest unread items inside the buffer and returns how many of
+   * them, at most items, can be read there contiguously (0 if empty).
+   * The items stay in the buffer until released with
+   * csoundCommitReadCircularBuffer(); call again after committing to
+   * get the rest of a block that wraps around the end of the buffer.
+   */
+  PUBLIC int csoundReserveReadCircularBuffer(CSOUND *csound, void *p,
+                                             void **data, int items);
+
+  /**
+   * Removes items read through csoundReserveReadCircularBuffer()
+   * from the circular buffer.
+   */
+  PUBLIC void csoundCommitReadCircularBuffer(CSOUND *csound, void *p,
+                                             int items);
+
+  /**
+   * Zero-copy write to circular buffer: stores in *data a pointer to
+   * free space inside the buffer and returns how many items, at most
+   * items, can be written there contiguously (0 if full). Nothing is
+   * visible to the reader until csoundCommitWriteCircularBuffer().
+   */
+  PUBLIC int csoundReserveWriteCircularBuffer(CSOUND *csound, void *p,
+                                              void **data, int items);
+
+  /**
+   * Makes items written through csoundReserveWriteCircularBuffer()
+   * available to the reader.
+   */
+  PUBLIC void csoundCommitWriteCircularBuffer(CSOUND *csound, void *p,
+                                              int items);
+
   /**
    * Free circular buffer
    */
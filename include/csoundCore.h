@@ -214,7 +214,7 @@ extern int ISSTRCOD(MYFLT);
 #define ASYNC_GLOBAL 1
 #define ASYNC_LOCAL  2
 
-enum {FFT_LIB=0, PFFT_LIB, VDSP_LIB};
+enum {FFT_LIB=0, PFFT_LIB, VDSP_LIB, MRFFT_LIB};
 enum {FFT_FWD=0, FFT_INV};
 
 /* advance declaration for
@@ -263,8 +263,21 @@ typedef struct CORFIL {
     int     ksmps_override;
     int     fft_lib;
     int     echo;
+    int     write_buffers;  /* soundfile writer thread buffers, 0: none */
+    int     ftcache;        /* share GEN tables across instances */
+    int     profile;        /* count opcode CPU time (--profile) */
+    char    *profilename;   /* folded stacks for flamegraph.pl, or NULL */
+    int     orcopt;         /* ORC_OPT_* passes run on each instrument */
+    int     diskin_threads; /* I/O threads for streaming diskin2 */
+    int     sdft_threads;   /* threads for the sliding DFT, 0 or 1: none */
   } OPARMS;
 
+/* OPARMS.orcopt, set with --orc-opt */
+#define ORC_OPT_CSE     1       /* common subexpression elimination */
+#define ORC_OPT_DCE     2       /* remove statements never read */
+#define ORC_OPT_HOIST   4       /* i-time k assignments to init */
+#define ORC_OPT_ALL     (ORC_OPT_CSE | ORC_OPT_DCE | ORC_OPT_HOIST)
+
   typedef struct arglst {
     int     count;
     char    *arg[1];
@@ -346,6 +359,8 @@ typedef struct CORFIL {
     int     instcnt;                /* Count number of instances ever */
     int     isNew;                  /* is this a new definition */
     int     nocheckpcnt;            /* Control checks on pcnt */
+    void    *pool;                  /* slabs of preallocated instances */
+    int     pool_size;              /* instances kept in the slabs */
   } INSTRTXT;
 
   typedef struct namedInstr {
@@ -690,6 +705,11 @@ typedef struct CORFIL {
     int32   flen;
     int     fno, guardreq;
     EVTBLK  e;
+    /** where the table goes, if not flist[fno] (asynchronous GENs) */
+    FUNC    **slot;
+    /** tables a GEN on a worker thread may read, indexed 1..nsrcs */
+    FUNC    **srcs;
+    int     nsrcs;
   } FGDATA;
 
   typedef struct {
@@ -769,6 +789,20 @@ typedef struct CORFIL {
 
 #ifdef __BUILDING_LIBCSOUND
 
+  /* Engine bookkeeping of an instrument instance.  It is kept in the
+     memory just before the INSDS rather than in it, so that the layout
+     of INSDS, on which compiled plugins depend for the p-fields, does
+     not change. */
+  typedef struct {
+    int      dag_task;     /* task slot in the parallel DAG, or -1 */
+    int      pooled;       /* in a prealloc slab, never freed alone */
+  } INSDS_PRIV;
+
+#define INSDS_PRIV_SIZE   ((sizeof(INSDS_PRIV) + 15) & ~((size_t) 15))
+#define INSDS_PRIV_OF(ip) ((INSDS_PRIV*) ((char*) (ip) - INSDS_PRIV_SIZE))
+/* the start of the memory of an instance, for Free */
+#define INSDS_BASE(ip)    ((void*) INSDS_PRIV_OF(ip))
+
 #define INSTR   1
 #define ENDIN   2
 #define OPCODE  3
@@ -848,6 +882,8 @@ typedef struct CORFIL {
   typedef struct threadInfo {
     struct threadInfo *next;
     void * threadId;
+    void * wakeup;              /* condition the worker parks on */
+    int    go;                  /* set under dag_gate to run a k-cycle */
   } THREADINFO;
 
 #include "sort.h"
@@ -1395,11 +1431,20 @@ typedef struct _message_queue_t_ {
     int (*GetErrorCnt)(CSOUND *);
     FUNC* (*FTnp2Finde)(CSOUND*, MYFLT *);
     INSTRTXT *(*GetInstrument)(CSOUND*, int, const char *);
+    /** As hfgens, but the GEN runs on a thread of its own; returns the
+        table number, or -1 on error */
+    int (*hfgensAsync)(CSOUND *, const EVTBLK *, int);
+    /** 1 if a table is complete, 0 while it is being generated, else -1 */
+    int (*FTReady)(CSOUND *, int tableNum);
+    /** Make the parallel scheduler run the instances of two instruments
+        in chain order, for a dependency the orchestra text does not
+        show; -1 if either instrument is unknown */
+    int (*DagDependency)(CSOUND *, int insno1, int insno2);
     /**@}*/
     /** @name Placeholders
         To allow the API to grow while maintining backward binary compatibility. */
     /**@{ */
-    SUBR dummyfn_2[29];
+    SUBR dummyfn_2[26];
     /**@}*/
 #ifdef __BUILDING_LIBCSOUND
     /* ------- private data (not to be used by hosts or externals) ------- */
@@ -1560,6 +1605,8 @@ typedef struct _message_queue_t_ {
     int           maxfnum;
     GEN           *gensub;
     int           genmax;
+    void          *ftgen_async;         /* asynchronous GEN state       */
+    void          *profile;             /* opcode profiler, NULL: off   */
     CS_HASH_TABLE *namedGlobals;
     CS_HASH_TABLE *cfgVariableDB;
     double        prvbt, curbt, nxtbt;
@@ -1567,6 +1614,14 @@ typedef struct _message_queue_t_ {
     int64_t       cyclesRemaining;
     EVTBLK        evt;
     void          *memalloc_db;
+    void          *mem_arenas;          /* per-thread size-class arenas */
+    unsigned int  mem_epoch;            /* changes when arenas are freed */
+    uint64_t      mem_lock_waits;       /* times memlock was found taken */
+    uint64_t      mem_large_allocs, mem_large_frees;
+    uint64_t      mem_retired_allocs, mem_retired_frees; /* freed arenas */
+    int64_t       mem_large_bytes;      /* live bytes outside the arenas */
+    uint64_t      mem_stats_allocs;     /* at the last csoundGetMemoryStats */
+    double        mem_stats_time;
     MGLOBAL       *midiGlobals;
     CS_HASH_TABLE *envVarDB;
     MEMFIL        *memfiles;
@@ -1574,6 +1629,7 @@ typedef struct _message_queue_t_ {
     int           FFT_max_size;
     void          *FFT_table_1;
     void          *FFT_table_2;
+    void          *FFT_plans;   /* mixed-radix FFT plans, see mrfft.c */
     /* statics from twarp.c should be TSEG* */
     void          *tseg, *tpsave;
     /* persistent macros */
@@ -1672,6 +1728,9 @@ typedef struct _message_queue_t_ {
       uint32        nframes               /* = 1UL */;
       FILE          *pin, *pout;
       int           dither;
+      void          *writer;              /* soundfile writer thread      */
+      CS_SFWRITE_STATS wstats;            /* stats when writer not active */
+      double        lasthdr;              /* time of last -R rewrite      */
     } libsndStatics;
 
     int           warped;               /* rdscor.c */
@@ -1766,10 +1825,26 @@ typedef struct _message_queue_t_ {
     int           dag_num_active;
     INSDS         **dag_task_map;
     volatile stateWithPadding    *dag_task_status;
-    watchList     * volatile *dag_task_watch;
-    watchList     *dag_wlmm;
-    char          **dag_task_dep;
+    dagNode       *dag_nodes;           /* edge lists of each task slot */
+    dagEdge       *dag_edges;           /* pool of dependency edges */
+    int           dag_edges_size;
+    int           dag_edges_free;       /* first unused edge */
     int           dag_task_max_size;
+    int           dag_num_slots;        /* task slots ever used */
+    int           dag_slots_free;       /* first released task slot */
+    int           dag_update_count;
+    int           dag_orc_changed;      /* instruments were (re)compiled */
+    char          **dag_conflict;       /* conflicts between instr numbers */
+    int           dag_conflict_size;
+    taskDeque     *dag_deques;          /* one work-stealing deque per thread */
+    int           dag_num_deques;
+    counterWithPadding dag_tasks_left;  /* tasks not yet completed */
+    int           dag_width;            /* most tasks on one level of the DAG */
+    int           dag_num_threads;      /* threads used in this k-cycle */
+    counterWithPadding dag_workers_busy; /* woken workers not yet finished */
+    void          *dag_gate;            /* guards go and dag_workers_busy */
+    void          *dag_done;            /* the last busy worker finished */
+    dagStats      dag_stats;
     uint32_t      tempStatus;    /* keeps track of which files are temps */
     int           orcLineOffset; /* 1 less than 1st orch line in the CSD */
     int           scoLineOffset; /* 1 less than 1st score line in the CSD */
@@ -1799,11 +1874,11 @@ typedef struct _message_queue_t_ {
     CS_HASH_TABLE* symbtab;
     int           unused_int1;
     int           inZero;       /* flag compilation of instr0 */
-    struct _message_queue **msg_queue;
-    volatile long msg_queue_wget; /* Writer - Get index */
-    volatile long msg_queue_wput; /* Writer - Put Index */
-    volatile long msg_queue_rstart; /* Reader - start index */
-    volatile long msg_queue_items;
+    struct _message_queue *msg_queue;
+    volatile long msg_queue_wput; /* Writer - next cell to claim */
+    volatile long msg_queue_rget; /* Reader - next cell to run */
+    void          *msg_queue_space;   /* notified when cells are freed */
+    volatile long msg_queue_waiters;  /* producers waiting for room */
     int      aftouch;
     void     *directory;
     ALLOC_DATA *alloc_queue;
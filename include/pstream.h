@@ -184,21 +184,24 @@ typedef struct {
         MYFLT   *ibin;          /* default  0 */
         MYFLT   *ibinoffset;    /* default 1  */
         MYFLT   *init;          /* not yet implemented  */
+        MYFLT   *imode;         /* 0 oscillators, 1 inverse FFT */
         /* internal */
         int32    outptr;
         uint32   lastframe;
         /* check these against fsig vals */
         int32    overlap,winsize,fftsize,wintype,format,noscs;
         int32    maxosc;
+        int32    mode;
         float   one_over_overlap,pi_over_sr, one_over_sr;
         float   fmod;
-        AUXCH   a;
-        AUXCH   x;
-        AUXCH   y;
+        AUXCH   bank;           /* OSCBANK */
+        AUXCH   phase;          /* double, per bin */
         AUXCH   amps;
         AUXCH   lastamps;
         AUXCH   freqs;
         AUXCH   outbuf;
+        AUXCH   ifft;           /* spectrum, kernel, window, overlap */
+        void    *setup;
 } PVADS;
 
 /* for pvscross */
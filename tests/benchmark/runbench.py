@@ -0,0 +1,76 @@
+#!/usr/bin/python
+
+# Csound benchmark runner
+#
+# Runs a benchmark orchestra with a range of thread counts and
+# reports the wall clock time and the mean time per k-cycle.
+#
+#   ./runbench.py [--csound-executable=../../csound] \
+#                 [--threads=1,2,4,8,16] [--kcycles=N] \
+#                 [--isa=scalar,sse2,avx2,neon] file.csd
+#
+# The number of k-cycles is needed to compute the per-cycle time;
+# for dag_scaling.csd it is 10 s * 48000 / 16 = 30000.
+# --isa repeats each run with the array kernels (and the oscillator
+# bank and the sliding DFT) forced to each instruction set in turn
+# (CSOUND_ARRAY_ISA), for array_ops.csd, additive_resynth.csd and
+# sliding_dft.csd.
+
+import os
+import sys
+import time
+import subprocess
+
+csound = "../../csound"
+threads = [1, 2, 4, 8, 16]
+kcycles = 0
+isas = [None]
+flags = ["-n", "-d", "-m0"]
+
+def run(csd, n, isa):
+    args = [csound] + flags + ["-j", str(n), csd]
+    env = dict(os.environ)
+    if isa is not None:
+        env["CSOUND_ARRAY_ISA"] = isa
+    start = time.time()
+    ret = subprocess.call(args, stdout=open(os.devnull, "w"),
+                          stderr=subprocess.STDOUT, env=env)
+    return ret, time.time() - start
+
+def main():
+    global csound, threads, kcycles, isas
+    files = []
+    for arg in sys.argv[1:]:
+        if arg.startswith("--csound-executable="):
+            csound = arg[len("--csound-executable="):]
+        elif arg.startswith("--threads="):
+            threads = [int(x) for x in arg[len("--threads="):].split(",")]
+        elif arg.startswith("--kcycles="):
+            kcycles = int(arg[len("--kcycles="):])
+        elif arg.startswith("--isa="):
+            isas = arg[len("--isa="):].split(",")
+        else:
+            files.append(arg)
+    if not files:
+        files = ["dag_scaling.csd"]
+        if kcycles == 0:
+            kcycles = 30000
+    for csd in files:
+        print("%s" % csd)
+        print("%8s %8s %10s %14s %8s" % ("isa", "threads", "time (s)",
+                                         "us/k-cycle", "speedup"))
+        base = None
+        for isa in isas:
+            for n in threads:
+                ret, t = run(csd, n, isa)
+                if ret != 0:
+                    print("%8s %8d failed (%d)" % (isa or "-", n, ret))
+                    continue
+                if base is None:
+                    base = t
+                percycle = (t * 1e6 / kcycles) if kcycles else 0.0
+                print("%8s %8d %10.3f %14.2f %8.2f" % (isa or "-", n, t,
+                                                       percycle, base / t))
+
+if __name__ == "__main__":
+    main()
@@ -61,6 +61,58 @@ void test_control_channel(void)
     csoundDestroy(csound);
 }
 
+const char orc_handles[] = "chn_k \"in\", 1\n"
+        "chn_k \"out\", 2\n"
+        "instr 1\n"
+        "Sname sprintfk \"%s\", \"in\"\n"
+        "kval chnget Sname\n"
+        "chnset kval*2, \"out\"\n"
+        "endin\n";
+
+void test_channel_handles(void)
+{
+    void *handles[2];
+    MYFLT vals[2] = { 3.0, 4.0 };
+    csoundSetGlobalEnv("OPCODE6DIR64", "../../");
+    CSOUND *csound = csoundCreate(0);
+    csoundCreateMessageBuffer(csound, 0);
+    csoundSetOption(csound, "--logfile=null");
+    csoundCompileOrc(csound, orc_handles);
+    CU_ASSERT(csoundStart(csound) == CSOUND_SUCCESS);
+    handles[0] = csoundGetChannelHandle(csound, "in",
+                                        CSOUND_CONTROL_CHANNEL |
+                                        CSOUND_INPUT_CHANNEL);
+    handles[1] = csoundGetChannelHandle(csound, "other",
+                                        CSOUND_CONTROL_CHANNEL |
+                                        CSOUND_INPUT_CHANNEL);
+    CU_ASSERT_PTR_NOT_NULL(handles[0]);
+    CU_ASSERT_PTR_NOT_NULL(handles[1]);
+    CU_ASSERT_PTR_EQUAL(handles[0],
+                        csoundGetChannelHandle(csound, "in",
+                                               CSOUND_CONTROL_CHANNEL));
+    CU_ASSERT_PTR_NULL(csoundGetChannelHandle(csound, "in",
+                                              CSOUND_AUDIO_CHANNEL));
+    csoundSetControlChannels(csound, handles, vals, 2);
+    CU_ASSERT_EQUAL(3.0, csoundGetControlChannel(csound, "in", NULL));
+    CU_ASSERT_EQUAL(4.0, csoundGetControlChannelByHandle(csound, handles[1]));
+    MYFLT pFields[] = {1.0, 0.0, 1.0};
+    csoundScoreEvent(csound, 'i', pFields, 3);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(6.0, csoundGetControlChannel(csound, "out", NULL));
+    csoundSetControlChannelByHandle(csound, handles[0], 5.0);
+    csoundPerformKsmps(csound);
+    vals[0] = vals[1] = 0.0;
+    handles[1] = csoundGetChannelHandle(csound, "out",
+                                        CSOUND_CONTROL_CHANNEL);
+    csoundGetControlChannels(csound, handles, vals, 2);
+    CU_ASSERT_EQUAL(5.0, vals[0]);
+    CU_ASSERT_EQUAL(10.0, vals[1]);
+
+    csoundCleanup(csound);
+    csoundDestroyMessageBuffer(csound);
+    csoundDestroy(csound);
+}
+
 const char orc2[] = "chn_k \"testing\", 3, 1, 1, 0, 10\n  chn_a \"testing2\", 3\n  instr 1\n  endin\n";
 
 void test_channel_list(void)
@@ -376,6 +428,7 @@ int main(void)
    /* add the tests to the suite */
    if ((NULL == CU_add_test(pSuite, "Channel Lists", test_channel_list))
            || (NULL == CU_add_test(pSuite, "Control channel", test_control_channel))
+           || (NULL == CU_add_test(pSuite, "Channel handles", test_channel_handles))
            || (NULL == CU_add_test(pSuite, "Control channel parameters", test_control_channel_params))
            || (NULL == CU_add_test(pSuite, "Callbacks", test_channel_callbacks))
            || (NULL == CU_add_test(pSuite, "Opcodes", test_channel_opcodes))
@@ -0,0 +1,122 @@
+/*
+ * Throughput of the circular buffer between two threads, moving blocks
+ * of samples through it with the copying calls and with the zero-copy
+ * reserve/commit calls.
+ *
+ * usage: benchCircularBuffer [million items]
+ */
+
+#include "csound.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    CSOUND *csound;
+    void   *rb;
+    long    total;
+    int     block;
+    int     zero_copy;
+    long    errors;
+} BENCH;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void *writer(void *arg)
+{
+    BENCH *b = (BENCH *) arg;
+    float *in = (float *) malloc(b->block*sizeof(float));
+    long next = 0;
+    int i, n;
+    while (next < b->total) {
+      int want = b->total - next < b->block ? (int) (b->total - next) : b->block;
+      if (b->zero_copy) {
+        float *data;
+        n = csoundReserveWriteCircularBuffer(b->csound, b->rb,
+                                             (void **) &data, want);
+        for (i = 0; i < n; i++) data[i] = (float) (next + i);
+        csoundCommitWriteCircularBuffer(b->csound, b->rb, n);
+      }
+      else {
+        for (i = 0; i < want; i++) in[i] = (float) (next + i);
+        n = csoundWriteCircularBuffer(b->csound, b->rb, in, want);
+      }
+      if (n == 0) sched_yield();   /* let the other side run */
+      next += n;
+    }
+    free(in);
+    return NULL;
+}
+
+static void reader(BENCH *b)
+{
+    float *out = (float *) malloc(b->block*sizeof(float));
+    long next = 0;
+    int i, n;
+    while (next < b->total) {
+      if (b->zero_copy) {
+        float *data;
+        n = csoundReserveReadCircularBuffer(b->csound, b->rb,
+                                            (void **) &data, b->block);
+        for (i = 0; i < n; i++)
+          if (data[i] != (float) (next + i)) b->errors++;
+        csoundCommitReadCircularBuffer(b->csound, b->rb, n);
+      }
+      else {
+        n = csoundReadCircularBuffer(b->csound, b->rb, out, b->block);
+        for (i = 0; i < n; i++)
+          if (out[i] != (float) (next + i)) b->errors++;
+      }
+      if (n == 0) sched_yield();   /* let the other side run */
+      next += n;
+    }
+    free(out);
+}
+
+int main(int argc, char **argv)
+{
+    static const int blocks[] = { 1, 16, 64, 256, 1024 };
+    CSOUND *csound;
+    long total = (argc > 1 ? atol(argv[1]) : 4) * 1000000L;
+    int i, mode, failed = 0;
+
+    csoundInitialize(CSOUNDINIT_NO_SIGNAL_HANDLER | CSOUNDINIT_NO_ATEXIT);
+    csound = csoundCreate(NULL);
+    printf("%10s %12s %12s\n", "block", "copy Mi/s", "view Mi/s");
+    for (i = 0; i < (int) (sizeof(blocks)/sizeof(blocks[0])); i++) {
+      double rate[2];
+      for (mode = 0; mode < 2; mode++) {
+        BENCH b;
+        pthread_t thread;
+        double t;
+        memset(&b, 0, sizeof(b));
+        b.csound = csound;
+        b.rb = csoundCreateCircularBuffer(csound, 4096, sizeof(float));
+        b.total = blocks[i] == 1 ? total/8 : total;
+        b.block = blocks[i];
+        b.zero_copy = mode;
+        t = now();
+        pthread_create(&thread, NULL, writer, &b);
+        reader(&b);
+        pthread_join(thread, NULL);
+        t = now() - t;
+        rate[mode] = b.total/t/(1024.0*1024.0);
+        if (b.errors) {
+          printf("block %d: %ld items out of order\n", blocks[i], b.errors);
+          failed = 1;
+        }
+        csoundDestroyCircularBuffer(csound, b.rb);
+      }
+      printf("%10d %12.1f %12.1f\n", blocks[i], rate[0], rate[1]);
+    }
+    csoundDestroy(csound);
+    return failed;
+}
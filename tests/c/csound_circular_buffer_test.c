@@ -132,6 +132,74 @@ void test_wrap(void) {
     csoundDestroy(csound);
 }
 
+void test_reserve_commit(void) {
+    int i, n, next = 0, expected = 0;
+    float *data;
+    CSOUND* csound = csoundCreate(NULL);
+    void *rb = csoundCreateCircularBuffer(csound, 32, sizeof(float));
+    CU_ASSERT_PTR_NOT_NULL(rb);
+    /* 31 items fit, and a read view never goes past the end */
+    n = csoundReserveWriteCircularBuffer(csound, rb, (void **) &data, 40);
+    CU_ASSERT_EQUAL(n, 31);
+    for (i = 0; i < 24; i++) data[i] = next++;
+    csoundCommitWriteCircularBuffer(csound, rb, 24);
+    n = csoundReserveReadCircularBuffer(csound, rb, (void **) &data, 20);
+    CU_ASSERT_EQUAL(n, 20);
+    for (i = 0; i < n; i++) CU_ASSERT_EQUAL(data[i], expected++);
+    csoundCommitReadCircularBuffer(csound, rb, n);
+    /* the free space now wraps, so it comes in two views */
+    n = csoundReserveWriteCircularBuffer(csound, rb, (void **) &data, 27);
+    CU_ASSERT_EQUAL(n, 8);
+    for (i = 0; i < n; i++) data[i] = next++;
+    csoundCommitWriteCircularBuffer(csound, rb, n);
+    n = csoundReserveWriteCircularBuffer(csound, rb, (void **) &data, 19);
+    CU_ASSERT_EQUAL(n, 19);
+    for (i = 0; i < n; i++) data[i] = next++;
+    csoundCommitWriteCircularBuffer(csound, rb, n);
+    CU_ASSERT_EQUAL(csoundReserveWriteCircularBuffer(csound, rb,
+                                                     (void **) &data, 1), 0);
+    /* copying reads see the same data across the wrap */
+    {
+      float out[31];
+      n = csoundReadCircularBuffer(csound, rb, out, 31);
+      CU_ASSERT_EQUAL(n, 31);
+      for (i = 0; i < n; i++) CU_ASSERT_EQUAL(out[i], expected++);
+    }
+    CU_ASSERT_EQUAL(csoundReserveReadCircularBuffer(csound, rb,
+                                                    (void **) &data, 1), 0);
+    csoundDestroyCircularBuffer(csound, rb);
+    csoundDestroy(csound);
+}
+
+void test_flush(void) {
+    int i, n;
+    float out[32];
+    CSOUND* csound = csoundCreate(NULL);
+    void *rb = csoundCreateCircularBuffer(csound, 32, sizeof(float));
+    CU_ASSERT_PTR_NOT_NULL(rb);
+    for (i = 0; i < 10; i++) {
+        float val = i;
+        csoundWriteCircularBuffer(csound, rb, &val, 1);
+    }
+    n = csoundReadCircularBuffer(csound, rb, out, 2);
+    CU_ASSERT_EQUAL(n, 2);
+    /* a flush from the writer drops what was written before it, */
+    csoundFlushCircularBuffer(csound, rb);
+    for (i = 10; i < 13; i++) {
+        float val = i;
+        csoundWriteCircularBuffer(csound, rb, &val, 1);
+    }
+    /* but not what comes after */
+    n = csoundPeekCircularBuffer(csound, rb, out, 32);
+    CU_ASSERT_EQUAL(n, 3);
+    n = csoundReadCircularBuffer(csound, rb, out, 32);
+    CU_ASSERT_EQUAL(n, 3);
+    for (i = 0; i < n; i++) CU_ASSERT_EQUAL(out[i], 10 + i);
+    csoundFlushCircularBuffer(csound, rb);
+    CU_ASSERT_EQUAL(csoundReadCircularBuffer(csound, rb, out, 32), 0);
+    csoundDestroyCircularBuffer(csound, rb);
+    csoundDestroy(csound);
+}
 
 int main()
 {
@@ -152,6 +220,8 @@ int main()
             || (NULL == CU_add_test(pSuite, "Test read and write diff sizes", test_read_write_diff_size))
             || (NULL == CU_add_test(pSuite, "Test peek", test_peek))
             || (NULL == CU_add_test(pSuite, "Test wrap", test_wrap))
+            || (NULL == CU_add_test(pSuite, "Test reserve and commit", test_reserve_commit))
+            || (NULL == CU_add_test(pSuite, "Test flush", test_flush))
         )
     {
         CU_cleanup_registry();
@@ -147,6 +147,89 @@ void test_cs_hash_table_get_put_key(void) {
     csoundDestroy(csound);
 }
 
+static uintptr_t free_blocks(void *data) {
+    void **blocks = (void **) data;
+    CSOUND* csound = (CSOUND*) blocks[0];
+    int i;
+    for (i = 1; i < 64; i++)
+      csound->Free(csound, blocks[i]);
+    return 0;
+}
+
+static uintptr_t alloc_blocks(void *data) {
+    void **blocks = (void **) data;
+    CSOUND* csound = (CSOUND*) blocks[0];
+    int i;
+    for (i = 1; i < 64; i++)
+      blocks[i] = csound->Malloc(csound, i * 8);
+    return 0;
+}
+
+static uintptr_t alloc_free_blocks(void *data) {
+    alloc_blocks(data);
+    return free_blocks(data);
+}
+
+void test_memalloc(void) {
+    CSOUND* csound = csoundCreate(NULL);
+    CSOUND_MEMORY_STATS before, after;
+    void *blocks[64], *more[64];
+    void *thread;
+    char *p;
+    int i;
+
+    csoundGetMemoryStats(csound, &before);
+    p = csound->Calloc(csound, 40);
+    for (i = 0; i < 40; i++)
+      CU_ASSERT_EQUAL(p[i], 0);
+    strcpy(p, "memalloc");
+    /* grow across the small block sizes into a large block */
+    p = csound->ReAlloc(csound, p, 1000);
+    CU_ASSERT_STRING_EQUAL(p, "memalloc");
+    p = csound->ReAlloc(csound, p, 100000);
+    CU_ASSERT_STRING_EQUAL(p, "memalloc");
+    csound->Free(csound, p);
+
+    /* blocks may be freed by a thread other than the one that made them */
+    blocks[0] = csound;
+    for (i = 1; i < 64; i++) {
+      blocks[i] = csound->Malloc(csound, i * 48);
+      CU_ASSERT_EQUAL((uintptr_t) blocks[i] & 15, 0);
+      memset(blocks[i], i, i * 48);
+    }
+    thread = csoundCreateThread(free_blocks, blocks);
+    csoundJoinThread(thread);
+    for (i = 1; i < 64; i++) {
+      p = csound->Malloc(csound, i * 48);
+      memset(p, 0, i * 48);
+      csound->Free(csound, p);
+    }
+
+    csoundGetMemoryStats(csound, &after);
+    CU_ASSERT_EQUAL(after.bytes_live, before.bytes_live);
+    CU_ASSERT(after.allocs >= before.allocs + 64 + 63);
+    CU_ASSERT_EQUAL(after.allocs - before.allocs, after.frees - before.frees);
+
+    /* the arena of a thread is freed when it exits with nothing live, */
+    thread = csoundCreateThread(alloc_free_blocks, blocks);
+    csoundJoinThread(thread);
+    csoundGetMemoryStats(csound, &before);
+    CU_ASSERT_EQUAL(before.arenas, after.arenas);
+    CU_ASSERT_EQUAL(before.allocs, before.frees);
+    /* and otherwise taken over by the next thread that needs one */
+    thread = csoundCreateThread(alloc_blocks, blocks);
+    csoundJoinThread(thread);
+    more[0] = csound;
+    thread = csoundCreateThread(alloc_free_blocks, more);
+    csoundJoinThread(thread);
+    csoundGetMemoryStats(csound, &after);
+    CU_ASSERT_EQUAL(after.arenas, before.arenas + 1);
+    thread = csoundCreateThread(free_blocks, blocks);
+    csoundJoinThread(thread);
+    csoundGetMemoryStats(csound, &after);
+    CU_ASSERT_EQUAL(after.bytes_live, before.bytes_live);
+    csoundDestroy(csound);
+}
 
 int main() {
     CU_pSuite pSuite = NULL;
@@ -167,7 +250,8 @@ int main() {
         (NULL == CU_add_test(pSuite, "Test cs_cons_append()", test_cs_cons_append)) ||
         (NULL == CU_add_test(pSuite, "Test cs_hash_table()", test_cs_hash_table)) ||
         (NULL == CU_add_test(pSuite, "Test cs_hash_table_merge()", test_cs_hash_table_merge)) ||
-        (NULL == CU_add_test(pSuite, "Test cs_hash_table_get_put_key()", test_cs_hash_table_get_put_key))) {
+        (NULL == CU_add_test(pSuite, "Test cs_hash_table_get_put_key()", test_cs_hash_table_get_put_key)) ||
+        (NULL == CU_add_test(pSuite, "Test memalloc", test_memalloc))) {
         
         CU_cleanup_registry();
         return CU_get_error();
@@ -144,6 +144,129 @@ void test_reuse(void)
     csoundDestroy(csound);
 }
 
+/* count the instances of an instrument, and those in its prealloc slab */
+static int count_instances(CSOUND *csound, int insno, int *pooled)
+{
+    INSDS   *ip = csound->engineState.instrtxtp[insno]->instance;
+    int     n = 0;
+    *pooled = 0;
+    for ( ; ip != NULL; ip = ip->nxtinstance, n++)
+      if (INSDS_PRIV_OF(ip)->pooled)
+        (*pooled)++;
+    return n;
+}
+
+void test_prealloc_pool(void)
+{
+    CSOUND  *csound;
+    int     result, pooled;
+    char  *orc =
+            "prealloc 1, 4 \n"
+            "instr 1 \n"
+            "adel delay oscili(0.1, p4), 0.01 \n"
+            "out adel \n"
+            "endin \n";
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    result = csoundCompileOrc(csound, orc);
+    CU_ASSERT(result == 0);
+    result = csoundReadScore(csound, "i1 0 0.1 220\n i1 0 0.1 330\n"
+                                     "i1 0 0.1 440\n i1 0.2 0.1 220\n"
+                                     "i1 0.2 0.1 330\n i1 0.2 0.1 440\n"
+                                     "i1 0.2 0.1 550\n i1 0.2 0.1 660\n");
+    CU_ASSERT(result == 0);
+    result = csoundStart(csound);
+    CU_ASSERT(result == 0);
+    CU_ASSERT_EQUAL(count_instances(csound, 1, &pooled), 4);
+    CU_ASSERT_EQUAL(pooled, 4);
+    /* three voices play in the slab without any new instance */
+    while (csoundGetScoreTime(csound) < 0.05)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(count_instances(csound, 1, &pooled), 4);
+    CU_ASSERT_EQUAL(pooled, 4);
+    /* the next five reuse the four pooled voices and add only one */
+    while (csoundGetScoreTime(csound) < 0.25)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(count_instances(csound, 1, &pooled), 5);
+    CU_ASSERT_EQUAL(pooled, 4);
+    csoundDestroy(csound);
+}
+
+/* count the opcodes of an instrument called name */
+static int count_opcodes(CSOUND *csound, int insno, const char *name)
+{
+    OPTXT   *op = csound->engineState.instrtxtp[insno]->nxtop;
+    int     n = 0;
+    for ( ; op != NULL; op = op->nxtop)
+      if (op->t.opcod != NULL && !strcmp(op->t.opcod, name))
+        n++;
+    return n;
+}
+
+void test_fused_expression(void)
+{
+    CSOUND  *csound;
+    int     result;
+    char  *orc =
+            "instr 1 \n"
+            "a1 oscili 0.5, 440 \n"
+            "a2 oscili 0.3, 220 \n"
+            "kg line 0, p3, 1 \n"
+            "aF = (a1*a2 + a1) * kg - a2 / (kg + 2) \n"
+            "aS = a2 * 0.5 \n"
+            "out aF \n"
+            "out aS \n"
+            "endin \n";
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    result = csoundCompileOrc(csound, orc);
+    CU_ASSERT(result == 0);
+    result = csoundStart(csound);
+    CU_ASSERT(result == 0);
+    /* the tree is one opcode; a single operator is left alone */
+    CU_ASSERT_EQUAL(count_opcodes(csound, 1, "##fuse"), 1);
+    csoundDestroy(csound);
+}
+
+/* picks up the counts of the orchestra optimiser summary */
+static void read_opt_stats(CSOUND *csound, int attr, const char *str)
+{
+    int *st = (int *) csoundGetHostData(csound);
+    (void) attr;
+    sscanf(str, "orchestra optimiser: %d common subexpression(s), "
+           "%d dead statement(s), %d", &st[0], &st[1], &st[2]);
+}
+
+void test_orc_opt(void)
+{
+    CSOUND  *csound;
+    int     result, st[3] = { 0, 0, 0 };
+    char  *orc =
+            "instr 1 \n"
+            "kg line 1, p3, 2 \n"
+            "kA = (kg * 3 + 1) * (kg * 3 + 1) \n"
+            "kUnused = kg * 7 \n"
+            "kP = p4 * 2 \n"
+            "printk2 kA + kP \n"
+            "endin \n";
+
+    csound = csoundCreate(st);
+    csoundSetMessageStringCallback(csound, read_opt_stats);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "--orc-opt=all");
+    result = csoundCompileOrc(csound, orc);
+    CU_ASSERT(result == 0);
+    /* kg * 3 + 1 once, kUnused gone, kP set at init */
+    CU_ASSERT(st[0] >= 2);
+    CU_ASSERT(st[1] >= 1);
+    CU_ASSERT_EQUAL(st[2], 1);
+    result = csoundStart(csound);
+    CU_ASSERT(result == 0);
+    csoundDestroy(csound);
+}
+
 void test_linenum(void)
 {
     CSOUND  *csound;
@@ -186,6 +309,9 @@ int main() {
             (NULL == CU_add_test(pSuite, "Test splitArgs", test_split_args)) ||
             (NULL == CU_add_test(pSuite, "Test Compilation", test_compile)) ||
             (NULL == CU_add_test(pSuite, "Test Reuse Instance", test_reuse)) ||
+            (NULL == CU_add_test(pSuite, "Test Prealloc Pool", test_prealloc_pool)) ||
+            (NULL == CU_add_test(pSuite, "Test Fused Expression", test_fused_expression)) ||
+            (NULL == CU_add_test(pSuite, "Test Orchestra Optimiser", test_orc_opt)) ||
         (NULL == CU_add_test(pSuite, "Test Line Numbers", test_linenum))) {
         CU_cleanup_registry();
         return CU_get_error();
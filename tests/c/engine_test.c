@@ -1,5 +1,6 @@
 #include "csound.h"
 #include <stdio.h>
+#include <string.h>
 #include <CUnit/Basic.h>
 
 #include "time.h"
@@ -54,6 +55,168 @@ void test_compile_async(void)
     csoundDestroy(csound);
 }
 
+void test_message_queue(void)
+{
+    CSOUND  *csound;
+    MYFLT pfields[4*16];
+    int i, n, queued = 0;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundCompileOrc(csound, "instr 1\n"
+                     "endin\n");
+    csoundStart(csound);
+    for (i = 0; i < 16; i++) {
+      pfields[4*i] = 1; pfields[4*i+1] = 0;
+      pfields[4*i+2] = 0.1; pfields[4*i+3] = i;
+    }
+    CU_ASSERT_EQUAL(csoundScoreEventBatchAsync(csound, 'i', pfields, 4, 16),
+                    16);
+    queued += 16;
+    /* fill the queue without performing: the try calls must refuse
+       rather than block once it is full */
+    while ((n = csoundTryScoreEventAsync(csound, 'i', pfields, 4)) >= 0)
+      queued++;
+    CU_ASSERT_EQUAL(n, CSOUND_ERROR);
+    CU_ASSERT(queued > 16);
+    CU_ASSERT_EQUAL(csoundTryInputMessageAsync(csound, "i 1 0 0.1"),
+                    CSOUND_ERROR);
+    CU_ASSERT_EQUAL(csoundScoreEventBatchAsync(csound, 'i', pfields, 4, 16),
+                    0);
+    /* one k-cycle drains it */
+    csoundPerformKsmps(csound);
+    CU_ASSERT(csoundTryInputMessageAsync(csound, "i 1 0 0.1") > 0);
+    csoundPerformKsmps(csound);
+    csoundDestroy(csound);
+}
+
+/* counts the "ftable N: shared" messages of an instance */
+static void count_shared(CSOUND *csound, int attr, const char *str)
+{
+    int *n = (int *) csoundGetHostData(csound);
+    (void) attr;
+    if (strstr(str, ": shared") != NULL)
+      (*n)++;
+}
+
+static CSOUND *create_cached(int *shared)
+{
+    CSOUND  *csound = csoundCreate(shared);
+    csoundSetMessageStringCallback(csound, count_shared);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "--ftable-cache");
+    csoundSetMessageLevel(csound, 7);
+    return csound;
+}
+
+void test_ftable_cache(void)
+{
+    CSOUND  *cs1, *cs2, *cs3;
+    MYFLT   *t1, *t2;
+    int     n1 = 0, n2 = 0, n3 = 0;
+    const char *orc = "gi1 ftgen 1, 0, 1024, 10, 1\n"
+                      "gi2 ftgen 2, 0, 1024, 10, 1, 0.25\n";
+    const char *worc = "gi1 ftgen 1, 0, 1024, 10, 1\n"
+                       "instr 1\n"
+                       "tablew 0.5, 256, 1\n"
+                       "endin\n";
+    cs1 = create_cached(&n1);
+    cs2 = create_cached(&n2);
+    CU_ASSERT_EQUAL(csoundCompileOrc(cs1, orc), 0);
+    CU_ASSERT_EQUAL(csoundCompileOrc(cs2, orc), 0);
+    csoundStart(cs1);
+    csoundStart(cs2);
+    /* same GEN and arguments: cs2 took both tables from the cache */
+    CU_ASSERT_EQUAL(n1, 0);
+    CU_ASSERT_EQUAL(n2, 2);
+    /* a recompile of the same statements keeps the tables */
+    CU_ASSERT_EQUAL(csoundCompileOrc(cs1, orc), 0);
+    CU_ASSERT_EQUAL(n1, 2);
+    /* an orchestra that writes to tables does not share them */
+    cs3 = create_cached(&n3);
+    CU_ASSERT_EQUAL(csoundCompileOrc(cs3, worc), 0);
+    csoundStart(cs3);
+    CU_ASSERT_EQUAL(n3, 0);
+    csoundInputMessage(cs3, "i 1 0 0");
+    csoundPerformKsmps(cs3);
+    CU_ASSERT_DOUBLE_EQUAL(csoundTableGet(cs3, 1, 256), 0.5, 1e-6);
+    CU_ASSERT_DOUBLE_EQUAL(csoundTableGet(cs1, 1, 256), 1.0, 1e-6);
+    CU_ASSERT_DOUBLE_EQUAL(csoundTableGet(cs2, 1, 256), 1.0, 1e-6);
+    csoundDestroy(cs3);
+    /* the host writes to a private copy */
+    csoundTableSet(cs1, 1, 256, 0.25);
+    CU_ASSERT_DOUBLE_EQUAL(csoundTableGet(cs1, 1, 256), 0.25, 1e-6);
+    CU_ASSERT_DOUBLE_EQUAL(csoundTableGet(cs2, 1, 256), 1.0, 1e-6);
+    /* and so may anyone given the table pointer */
+    CU_ASSERT_EQUAL(csoundGetTable(cs1, &t1, 2), 1024);
+    CU_ASSERT_EQUAL(csoundGetTable(cs2, &t2, 2), 1024);
+    CU_ASSERT_PTR_NOT_EQUAL(t1, t2);
+    /* still valid for the other instance once the first is gone */
+    csoundDestroy(cs1);
+    CU_ASSERT_DOUBLE_EQUAL(csoundTableGet(cs2, 1, 256), 1.0, 1e-6);
+    csoundDestroy(cs2);
+}
+
+void test_table_gen_async(void)
+{
+    CSOUND  *csound;
+    MYFLT   *t1, *t2;
+    MYFLT   pf[7] = { 0, 0, 65536, 10, 1, 0.5, 0.25 };
+    int     fno, n, k;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundCompileOrc(csound, "gi1 ftgen 1, 0, 65536, 10, 1, 0.5, 0.25\n"
+                             "instr 1\n"
+                             "endin\n");
+    csoundStart(csound);
+    fno = csoundTableGenAsync(csound, pf, 7, NULL);
+    CU_ASSERT(fno > 1);
+    /* not in the table list until published between k-cycles */
+    CU_ASSERT_EQUAL(csoundTableReady(csound, fno), 0);
+    for (k = 0; k < 10000 && (n = csoundTableReady(csound, fno)) == 0; k++)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(n, 1);
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &t1, 1), 65536);
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &t2, fno), 65536);
+    for (k = 0; k <= 65536; k += 257)
+      CU_ASSERT_DOUBLE_EQUAL(t1[k], t2[k], 1e-12);
+    CU_ASSERT_EQUAL(csoundTableReady(csound, fno + 1000), -1);
+    csoundDestroy(csound);
+}
+
+void test_profile(void)
+{
+    CSOUND  *csound;
+    const CS_PROFILE_ENTRY *e;
+    int     n, i, found = 0;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    CU_ASSERT_EQUAL(csoundGetProfile(csound, &e), -1);
+    csoundSetOption(csound, "--profile");
+    csoundCompileOrc(csound, "instr 1\n"
+                             "a1 oscili 0.5, 440\n"
+                             "out a1\n"
+                             "endin\n");
+    csoundReadScore(csound, "i 1 0 1\n");
+    csoundStart(csound);
+    for (i = 0; i < 10; i++)
+      csoundPerformKsmps(csound);
+    n = csoundGetProfile(csound, &e);
+    CU_ASSERT(n >= 3);
+    /* instrument total first, then its opcodes */
+    CU_ASSERT_EQUAL(e[0].insno, 1);
+    CU_ASSERT_PTR_NULL(e[0].opname);
+    for (i = 1; i < n; i++) {
+      CU_ASSERT_PTR_NOT_NULL(e[i].opname);
+      if (e[i].opname != NULL && !strncmp(e[i].opname, "oscili", 6)) {
+        CU_ASSERT_EQUAL(e[i].calls, 10);
+        found = 1;
+      }
+      CU_ASSERT(e[i].ticks <= e[0].ticks);
+    }
+    CU_ASSERT(found);
+    csoundDestroy(csound);
+}
+
 int main()
 {
     CU_pSuite pSuite = NULL;
@@ -73,6 +236,10 @@ int main()
     if ((NULL == CU_add_test(pSuite, "Test daemon mode", test_daemon))
         || (NULL == CU_add_test(pSuite, "Test evalcode", test_eval_code))
 	|| (NULL == CU_add_test(pSuite, "Test compileAsync", test_compile_async)) 
+	|| (NULL == CU_add_test(pSuite, "Test message queue", test_message_queue))
+	|| (NULL == CU_add_test(pSuite, "Test shared ftable cache", test_ftable_cache))
+	|| (NULL == CU_add_test(pSuite, "Test async table generation", test_table_gen_async))
+	|| (NULL == CU_add_test(pSuite, "Test opcode profiler", test_profile))
 	)
     {
         CU_cleanup_registry();
@@ -229,6 +229,75 @@ void test_audio_realtime_mode(void)
 }
 
 
+static long render_to_file(const char *name, const char *bufopt,
+                           CS_SFWRITE_STATS *stats)
+{
+    CSOUND  *csound;
+    FILE    *f;
+    long    size;
+    const char  *instrument =
+            "ksmps = 32\n"
+            "nchnls = 2\n"
+            "instr 1 \n"
+            "asig oscil 0dbfs/4, A4\n"
+            "outs asig, -asig\n"
+            "endin \n";
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "--logfile=null");
+    csoundSetOption(csound, "-b256");
+    csoundSetOption(csound, "-R");
+    if (bufopt != NULL)
+      csoundSetOption(csound, bufopt);
+    csoundSetOutput(csound, name, "wav", "short");
+    csoundCompileOrc(csound, instrument);
+    csoundReadScore(csound, "i 1 0 1\n e");
+    CU_ASSERT(csoundStart(csound) == 0);
+    csoundPerform(csound);
+    csoundCleanup(csound);
+    CU_ASSERT(csoundGetSoundfileWriteStats(csound, stats) == CSOUND_SUCCESS);
+    csoundDestroy(csound);
+    f = fopen(name, "rb");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(f);
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+void test_soundfile_writer_thread(void)
+{
+    CS_SFWRITE_STATS st_sync, st_async;
+    long    n1, n2;
+    FILE    *f1, *f2;
+    int     c1, c2, same = 1;
+
+    n1 = render_to_file("sfwriter_sync.wav", NULL, &st_sync);
+    n2 = render_to_file("sfwriter_async.wav", "--write-buffers=4", &st_async);
+    CU_ASSERT_EQUAL(st_sync.buffers, 0);
+    CU_ASSERT_EQUAL(st_async.buffers, 4);
+    CU_ASSERT(st_async.blocks_written > 0);
+    CU_ASSERT_EQUAL(st_async.blocks_written, st_sync.blocks_written);
+    CU_ASSERT(st_async.max_depth <= 4);
+    CU_ASSERT_EQUAL(st_async.depth, 0);
+    /* the writer thread must produce the same file */
+    CU_ASSERT_EQUAL(n1, n2);
+    f1 = fopen("sfwriter_sync.wav", "rb");
+    f2 = fopen("sfwriter_async.wav", "rb");
+    if (f1 != NULL && f2 != NULL) {
+      do {
+        c1 = fgetc(f1); c2 = fgetc(f2);
+        if (c1 != c2) same = 0;
+      } while (c1 != EOF && c2 != EOF);
+    }
+    else same = 0;
+    CU_ASSERT(same);
+    if (f1 != NULL) fclose(f1);
+    if (f2 != NULL) fclose(f2);
+    remove("sfwriter_sync.wav");
+    remove("sfwriter_async.wav");
+}
+
+
 
 
 void test_midi_modules(void)
@@ -307,6 +376,7 @@ int main()
             || (NULL == CU_add_test(pSuite, "MIDI Modules\n", test_midi_modules))
             || (NULL == CU_add_test(pSuite, "MIDI Hostbased\n", test_midi_hostbased))
             || (NULL == CU_add_test(pSuite, "Audio realtime mode\n", test_audio_realtime_mode))
+            || (NULL == CU_add_test(pSuite, "Soundfile writer thread\n", test_soundfile_writer_thread))
         )
     {
        CU_cleanup_registry();
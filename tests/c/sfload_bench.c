@@ -0,0 +1,75 @@
+/*
+ * Time taken by sfload on a SoundFont bank, and by the first note
+ * played from it, for several Csound instances in one process.  The
+ * bank is mapped rather than read, and presets are only parsed when a
+ * note first uses them, so the load time should barely depend on the
+ * size of the bank; pass a large GM bank to see it.
+ *
+ * usage: benchSfload file.sf2 [instances]
+ */
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char orc[] =
+    "sr = 44100\n"
+    "ksmps = 64\n"
+    "nchnls = 2\n"
+    "0dbfs = 1\n"
+    "giSF sfload \"%s\"\n"
+    "     sfpassign 0, giSF, 1\n"
+    "instr 1\n"
+    "  a1, a2 sfplay 100, 60, 1, 1, 0\n"
+    "  outs a1, a2\n"
+    "endin\n";
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    CSOUND **csound;
+    char *code;
+    int n = argc > 2 ? atoi(argv[2]) : 4;
+    int i, failed = 0;
+
+    if (argc < 2 || n < 1) {
+      fprintf(stderr, "usage: %s file.sf2 [instances]\n", argv[0]);
+      return 1;
+    }
+    csoundInitialize(CSOUNDINIT_NO_SIGNAL_HANDLER | CSOUNDINIT_NO_ATEXIT);
+    code = (char *) malloc(sizeof(orc) + strlen(argv[1]));
+    sprintf(code, orc, argv[1]);
+    csound = (CSOUND **) calloc(n, sizeof(CSOUND *));
+    printf("%10s %12s %14s\n", "instance", "load (ms)", "1st note (ms)");
+    for (i = 0; i < n; i++) {
+      double t0, t1, t2;
+      csound[i] = csoundCreate(NULL);
+      csoundSetOption(csound[i], "-n");
+      csoundSetOption(csound[i], "-m0");
+      t0 = now();
+      if (csoundCompileOrc(csound[i], code) != 0 || csoundStart(csound[i]) != 0) {
+        printf("%10d failed to load %s\n", i, argv[1]);
+        failed = 1;
+        break;
+      }
+      t1 = now();
+      csoundReadScore(csound[i], "i1 0 0.1\n");
+      csoundPerformKsmps(csound[i]);
+      t2 = now();
+      printf("%10d %12.3f %14.3f\n", i, (t1 - t0)*1e3, (t2 - t1)*1e3);
+    }
+    /* keep every instance alive until all have loaded the bank */
+    for (i = 0; i < n; i++)
+      if (csound[i] != NULL) csoundDestroy(csound[i]);
+    free(csound);
+    free(code);
+    return failed;
+}
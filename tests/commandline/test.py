@@ -138,6 +138,19 @@ def runTest():
         ["test_udo_string_array_join.csd", "test udo with S[] arg returning S"],
         ["test_array_function_call.csd", "test synthesizing an array arg from a function-call"],
         ["prints_number_no_crash.csd", "test prints does not crash when given a number arguments", 1],
+        ["test_prealloc_pool.csd", "preallocated voices are reused across sections"],
+        ["test_ftconv_nonuniform.csd", "ftconv non-uniform partitions match uniform"],
+        ["test_ftgenasync.csd", "ftgenasync builds the same table as ftgen"],
+        ["test_fused_expressions.csd", "fused a-rate expression matches the opcode chain"],
+        ["test_orc_opt.csd", "orchestra optimisations keep results unchanged"],
+        ["test_array_kernels.csd", "vectorised array opcodes match element loops"],
+        ["test_hrtf_shared.csd", "binaural opcodes sharing one HRTF store"],
+        ["test_diskin_stream.csd", "streamed diskin2 starts like a synchronous read"],
+        ["test_sfg_routes.csd", "signal flow graph inlets sum the playing outlets"],
+        ["test_mixer_busses.csd", "mixer sends reach their busses after the store grows"],
+        ["test_oscbank.csd", "additive resynthesis through the oscillator bank"],
+        ["test_pvsadsyn_offbin.csd", "pvsadsyn inverse FFT mode matches its oscillators off the bins"],
+        ["test_sliding_dft.csd", "sliding pvsanal and pvsynth keep a sine's level and pitch"],
     ]
 
     arrayTests = [["arrays/arrays_i_local.csd", "local i[]"],
@@ -148,6 +161,7 @@ def runTest():
         ["arrays/arrays_a_global.csd", "global a[]"],
         ["arrays/arrays_S_local.csd", "local S[]"],
         ["arrays/arrays_S_global.csd", "global S[]"],
+        ["arrays/arrays_rfft_np2.csd", "rfft on non-power-of-two sizes"],
     ]
 
 